@@ -11,7 +11,6 @@
 
 
 #include "GNSSSensorImpl.h"
-#include "IoT/GNSS/NMEA/SentenceDecoder.h"
 #include "Poco/Geo/LatLon.h"
 #include "Poco/Format.h"
 #include "Poco/NumberFormatter.h"
@@ -28,6 +27,7 @@ const std::string GNSSSensorImpl::SYMBOLIC_NAME("io.macchina.gnss.nmea");
 
 GNSSSensorImpl::GNSSSensorImpl(Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort):
 	_pSerialPort(pSerialPort),
+	_pReactor(0),
 	_lastValidPosition(0),
 	_lastPositionUpdate(0),
 	_positionAvailable(false),
@@ -49,7 +49,21 @@ GNSSSensorImpl::GNSSSensorImpl(Poco::SharedPtr<IoT::Serial::SerialPort> pSerialP
 	addProperty("positionChangedDelta", &GNSSSensorImpl::getPositionChangedDelta, &GNSSSensorImpl::setPositionChangedDelta);
 	addProperty("positionTimeout", &GNSSSensorImpl::getPositionTimeout, &GNSSSensorImpl::setPositionTimeout);
 
-	_thread.start(*this);
+	_nmeaDecoder.sentenceReceived += Poco::delegate(&_rmcProcessor, &IoT::GNSS::NMEA::RMCProcessor::processSentence);
+	_nmeaDecoder.sentenceReceived += Poco::delegate(&_ggaProcessor, &IoT::GNSS::NMEA::GGAProcessor::processSentence);
+
+	_rmcProcessor.rmcReceived += Poco::delegate(this, &GNSSSensorImpl::onRMCReceived);
+	_ggaProcessor.ggaReceived += Poco::delegate(this, &GNSSSensorImpl::onGGAReceived);
+
+	if (IoT::Serial::SerialReactor::isSupported())
+	{
+		_pReactor = &IoT::Serial::SerialReactor::defaultReactor();
+		_pReactor->addPort(_pSerialPort, *this, Poco::Timespan(1, 0));
+	}
+	else
+	{
+		_thread.start(*this);
+	}
 }
 
 	
@@ -68,16 +82,6 @@ GNSSSensorImpl::~GNSSSensorImpl()
 
 void GNSSSensorImpl::run()
 {
-	IoT::GNSS::NMEA::RMCProcessor rmcProcessor;
-	IoT::GNSS::NMEA::GGAProcessor ggaProcessor;
-
-	IoT::GNSS::NMEA::SentenceDecoder nmeaDecoder;
-	nmeaDecoder.sentenceReceived += Poco::delegate(&rmcProcessor, &IoT::GNSS::NMEA::RMCProcessor::processSentence);
-	nmeaDecoder.sentenceReceived += Poco::delegate(&ggaProcessor, &IoT::GNSS::NMEA::GGAProcessor::processSentence);
-	
-	rmcProcessor.rmcReceived += Poco::delegate(this, &GNSSSensorImpl::onRMCReceived);
-	ggaProcessor.ggaReceived += Poco::delegate(this, &GNSSSensorImpl::onGGAReceived);
-	
 	while (!done())
 	{
 		try
@@ -86,27 +90,9 @@ void GNSSSensorImpl::run()
 			{
 				std::string data;
 				_pSerialPort->read(data);
-				nmeaDecoder.processBuffer(data.data(), data.size());
-			}
-			bool fireLostPosition = false;
-			{
-				Poco::FastMutex::ScopedLock lock(_mutex);
-				if (_positionAvailable && _lastPositionUpdate.elapsed() > Poco::Timestamp::TimeVal(_timeout)*1000)
-				{
-					_positionAvailable = false;
-					fireLostPosition = true;
-				}
-			}
-			if (fireLostPosition)
-			{
-				try
-				{
-					positionLost(this);
-				}
-				catch (Poco::Exception&)
-				{
-				}
+				_nmeaDecoder.processBuffer(data.data(), data.size());
 			}
+			checkPositionTimeout();
 		}
 		catch (Poco::Exception& exc)
 		{
@@ -117,13 +103,65 @@ void GNSSSensorImpl::run()
 }
 
 
+void GNSSSensorImpl::onDataReceived(const char* data, std::size_t size)
+{
+	try
+	{
+		_nmeaDecoder.processBuffer(data, size);
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.log(exc);
+	}
+}
+
+
+void GNSSSensorImpl::onTimer()
+{
+	checkPositionTimeout();
+}
+
+
+void GNSSSensorImpl::onError(const Poco::Exception& exc)
+{
+	_logger.error("Serial port %s failed, no more position updates will be received: %s", _pSerialPort->device(), exc.displayText());
+}
+
+
+void GNSSSensorImpl::checkPositionTimeout()
+{
+	bool fireLostPosition = false;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (_positionAvailable && _lastPositionUpdate.elapsed() > Poco::Timestamp::TimeVal(_timeout)*1000)
+		{
+			_positionAvailable = false;
+			fireLostPosition = true;
+		}
+	}
+	if (fireLostPosition)
+	{
+		try
+		{
+			positionLost(this);
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+}
+
+
 void GNSSSensorImpl::stop()
 {
 	{
 		Poco::FastMutex::ScopedLock lock(_mutex);
 		_done = true;
 	}
-	_thread.join();
+	if (_pReactor)
+		_pReactor->removePort(_pSerialPort);
+	else
+		_thread.join();
 }
 
 
@@ -17,6 +17,8 @@
 #include "IoT/Devices/GNSSSensor.h"
 #include "IoT/Devices/DeviceImpl.h"
 #include "IoT/Serial/SerialPort.h"
+#include "IoT/Serial/SerialReactor.h"
+#include "IoT/GNSS/NMEA/SentenceDecoder.h"
 #include "IoT/GNSS/NMEA/RMCProcessor.h"
 #include "IoT/GNSS/NMEA/GGAProcessor.h"
 #include "Poco/Timestamp.h"
@@ -29,11 +31,16 @@ namespace IoT {
 namespace GNSS {
 
 
-class GNSSSensorImpl: public IoT::Devices::DeviceImpl<IoT::Devices::GNSSSensor, GNSSSensorImpl>, public Poco::Runnable
+class GNSSSensorImpl: public IoT::Devices::DeviceImpl<IoT::Devices::GNSSSensor, GNSSSensorImpl>, public Poco::Runnable, public IoT::Serial::SerialReactor::Handler
 {
 public:
 	GNSSSensorImpl(Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort);
 		/// Creates a GNSSSensorImpl.
+		///
+		/// If supported on the current platform, the serial port
+		/// is served by the default SerialReactor. Otherwise,
+		/// the GNSSSensorImpl starts its own thread for reading
+		/// from the serial port.
 		
 	~GNSSSensorImpl();
 		/// Destroys the GNSSSensorImpl.
@@ -62,14 +69,24 @@ protected:
 	void run();
 	void stop();
 	bool done();
+	void checkPositionTimeout();
 	void onRMCReceived(const IoT::GNSS::NMEA::RMCProcessor::RMC& rmc);
 	void onGGAReceived(const IoT::GNSS::NMEA::GGAProcessor::GGA& gga);
 
+	// SerialReactor::Handler
+	void onDataReceived(const char* data, std::size_t size);
+	void onTimer();
+	void onError(const Poco::Exception& exc);
+
 	static const std::string NAME;
 	static const std::string SYMBOLIC_NAME;
 
 private:
 	Poco::SharedPtr<IoT::Serial::SerialPort> _pSerialPort;
+	IoT::GNSS::NMEA::SentenceDecoder _nmeaDecoder;
+	IoT::GNSS::NMEA::RMCProcessor _rmcProcessor;
+	IoT::GNSS::NMEA::GGAProcessor _ggaProcessor;
+	IoT::Serial::SerialReactor* _pReactor;
 	Poco::Timestamp _lastValidPosition;
 	Poco::Timestamp _lastPositionUpdate;
 	bool _positionAvailable;
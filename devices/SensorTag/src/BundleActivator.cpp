@@ -23,6 +23,8 @@
 #include "IoT/Devices/SensorServerHelper.h"
 #include "IoT/Devices/AccelerometerServerHelper.h"
 #include "IoT/BtLE/BlueZGATTClient.h"
+#include "IoT/BtLE/BlueZGATTHelper.h"
+#include "IoT/BtLE/MultiplexedGATTClient.h"
 #include "IoT/BtLE/PeripheralImpl.h"
 #include "Poco/Delegate.h"
 #include "Poco/ClassLibrary.h"
@@ -143,14 +145,18 @@ public:
 	void createSensors(Peripheral::Ptr pPeripheral, const std::string& baseKey)
 	{
 		SensorTagSensor::Params params;
+		params.notifUUID = "00002902-0000-1000-8000-00805f9b34fb";
+		bool streaming = _pPrefs->configuration()->getBool(baseKey + ".streaming", false);
 
 		// humidity
 		params.serviceUUID = "f000aa20-0451-4000-b000-000000000000";
 		params.controlUUID = "f000aa22-0451-4000-b000-000000000000";
 		params.dataUUID    = "f000aa21-0451-4000-b000-000000000000";
+		params.periodUUID  = "f000aa23-0451-4000-b000-000000000000";
 		params.physicalQuantity = "humidity";
 		params.physicalUnit = "%RH";
 		params.pollInterval = _pPrefs->configuration()->getInt(baseKey + ".humidity.pollInterval", 10000);
+		params.streaming = _pPrefs->configuration()->getBool(baseKey + ".humidity.streaming", streaming);
 
 		try
 		{
@@ -165,9 +171,11 @@ public:
 		params.serviceUUID = "f000aa00-0451-4000-b000-000000000000";
 		params.controlUUID = "f000aa02-0451-4000-b000-000000000000";
 		params.dataUUID    = "f000aa01-0451-4000-b000-000000000000";
+		params.periodUUID  = "f000aa03-0451-4000-b000-000000000000";
 		params.physicalQuantity = "ambientTemperature";
 		params.physicalUnit = IoT::Devices::Sensor::PHYSICAL_UNIT_DEGREES_CELSIUS;
 		params.pollInterval = _pPrefs->configuration()->getInt(baseKey + ".ambientTemperature.pollInterval", 10000);
+		params.streaming = _pPrefs->configuration()->getBool(baseKey + ".ambientTemperature.streaming", streaming);
 		
 		try
 		{
@@ -182,9 +190,11 @@ public:
 		params.serviceUUID = "f000aa00-0451-4000-b000-000000000000";
 		params.controlUUID = "f000aa02-0451-4000-b000-000000000000";
 		params.dataUUID    = "f000aa01-0451-4000-b000-000000000000";
+		params.periodUUID  = "f000aa03-0451-4000-b000-000000000000";
 		params.physicalQuantity = "objectTemperature";
 		params.physicalUnit = IoT::Devices::Sensor::PHYSICAL_UNIT_DEGREES_CELSIUS;
 		params.pollInterval = _pPrefs->configuration()->getInt(baseKey + ".objectTemperature.pollInterval", 10000);
+		params.streaming = _pPrefs->configuration()->getBool(baseKey + ".objectTemperature.streaming", streaming);
 		
 		try
 		{
@@ -199,9 +209,11 @@ public:
 		params.serviceUUID = "f000aa70-0451-4000-b000-000000000000";
 		params.controlUUID = "f000aa72-0451-4000-b000-000000000000";
 		params.dataUUID    = "f000aa71-0451-4000-b000-000000000000";
+		params.periodUUID  = "f000aa73-0451-4000-b000-000000000000";
 		params.physicalQuantity = "illuminance";
 		params.physicalUnit = IoT::Devices::Sensor::PHYSICAL_UNIT_LUX;
 		params.pollInterval = _pPrefs->configuration()->getInt(baseKey + ".illuminance.pollInterval", 10000);
+		params.streaming = _pPrefs->configuration()->getBool(baseKey + ".illuminance.streaming", streaming);
 		
 		try
 		{
@@ -219,9 +231,11 @@ public:
 		params.serviceUUID = "f000aa40-0451-4000-b000-000000000000";
 		params.controlUUID = "f000aa42-0451-4000-b000-000000000000";
 		params.dataUUID    = "f000aa41-0451-4000-b000-000000000000";
+		params.periodUUID  = "f000aa44-0451-4000-b000-000000000000";
 		params.physicalQuantity = "airPressure";
 		params.physicalUnit = "hPa";
 		params.pollInterval = _pPrefs->configuration()->getInt(baseKey + ".airPressure.pollInterval", 10000);
+		params.streaming = _pPrefs->configuration()->getBool(baseKey + ".airPressure.streaming", streaming);
 		
 		try
 		{
@@ -268,7 +282,19 @@ public:
 		_pTimer = new Poco::Util::Timer;
 	
 		Poco::Util::AbstractConfiguration::Keys keys;
-		std::string helperPath = _pPrefs->configuration()->getString("btle.bluez.helper");
+		// The shared helper speaks a binary protocol and therefore
+		// has its own setting; btle.bluez.helper refers to the
+		// line-based helper used by BlueZGATTClient.
+		std::string helperPath;
+		std::string multiplexHelperPath = _pPrefs->configuration()->getString("btle.bluez.multiplexHelper", "");
+		if (!multiplexHelperPath.empty())
+		{
+			_pHelper = new BlueZGATTHelper(multiplexHelperPath);
+		}
+		else
+		{
+			helperPath = _pPrefs->configuration()->getString("btle.bluez.helper");
+		}
 		_pPrefs->configuration()->keys("sensortag.sensors", keys);
 		for (std::vector<std::string>::const_iterator it = keys.begin(); it != keys.end(); ++it)
 		{
@@ -279,7 +305,11 @@ public:
 		
 			try
 			{	
-				GATTClient::Ptr pGATTClient = new BlueZGATTClient(helperPath);
+				GATTClient::Ptr pGATTClient;
+				if (_pHelper)
+					pGATTClient = new MultiplexedGATTClient(_pHelper);
+				else
+					pGATTClient = new BlueZGATTClient(helperPath);
 				Peripheral::Ptr pPeripheral = new PeripheralImpl(address, pGATTClient);
 				pPeripheral->connected += Poco::delegate(this, &BundleActivator::onConnected);
 				pPeripheral->disconnected += Poco::delegate(this, &BundleActivator::onDisconnected);	
@@ -310,6 +340,7 @@ public:
 		}
 		_serviceRefs.clear();
 		_peripherals.clear();
+		_pHelper = 0;
 
 		_pPrefs = 0;
 		_pContext = 0;
@@ -412,6 +443,7 @@ private:
 	PreferencesService::Ptr _pPrefs;
 	Poco::SharedPtr<Poco::Util::Timer> _pTimer;
 	std::vector<PeripheralInfo> _peripherals;
+	BlueZGATTHelper::Ptr _pHelper;
 	std::vector<ServiceRef::Ptr> _serviceRefs;
 };
 
@@ -16,6 +16,7 @@
 #include "Poco/BinaryReader.h"
 #include "Poco/Delegate.h"
 #include "Poco/Logger.h"
+#include "Poco/Format.h"
 #include <cmath>
 
 
@@ -62,8 +63,10 @@ SensorTagSensor::SensorTagSensor(Peripheral::Ptr pPeripheral, const Params& para
 	_params(params),
 	_pPeripheral(pPeripheral),
 	_pTimer(pTimer),
+	_notifHandle(0),
 	_ready(false),
 	_enabled(false),
+	_streaming(false),
 	_value(0),
 	_valueChangedDelta(0.0),
 	_pEventPolicy(new IoT::Devices::NoModerationPolicy<double>(valueChanged)),
@@ -71,11 +74,13 @@ SensorTagSensor::SensorTagSensor(Peripheral::Ptr pPeripheral, const Params& para
 	_symbolicName(SYMBOLIC_NAME),
 	_name(NAME),
 	_physicalQuantity(params.physicalQuantity),
-	_physicalUnit(params.physicalUnit)
+	_physicalUnit(params.physicalUnit),
+	_logger(Poco::Logger::get("IoT.SensorTag"))
 {
 	addProperty("displayValue", &SensorTagSensor::getDisplayValue);
 	addProperty("enabled", &SensorTagSensor::getEnabled, &SensorTagSensor::setEnabled);
 	addProperty("connected", &SensorTagSensor::getConnected);
+	addProperty("streaming", &SensorTagSensor::getStreaming);
 	addProperty("valueChangedDelta", &SensorTagSensor::getValueChangedDelta, &SensorTagSensor::setValueChangedDelta);
 	addProperty("deviceIdentifier", &SensorTagSensor::getDeviceIdentifier);
 	addProperty("symbolicName", &SensorTagSensor::getSymbolicName);
@@ -88,9 +93,25 @@ SensorTagSensor::SensorTagSensor(Peripheral::Ptr pPeripheral, const Params& para
 	_pPeripheral->services();
 	_controlChar = _pPeripheral->characteristic(_params.serviceUUID, _params.controlUUID);
 	_dataChar = _pPeripheral->characteristic(_params.serviceUUID, _params.dataUUID);
+	if (_params.streaming)
+	{
+		try
+		{
+			if ((_dataChar.properties & GATTClient::GATT_PROP_NOTIFY) == 0)
+				throw Poco::NotFoundException("notify property", _params.dataUUID);
+			_periodChar = _pPeripheral->characteristic(_params.serviceUUID, _params.periodUUID);
+			_notifHandle = _pPeripheral->handleForDescriptor(_params.serviceUUID, _params.notifUUID);
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.warning(Poco::format("Notifications not available for %s sensor, falling back to polling: %s", _params.physicalQuantity, exc.displayText()));
+			_params.streaming = false;
+		}
+	}
 
 	_pPeripheral->connected += Poco::delegate(this, &SensorTagSensor::onConnected);
 	_pPeripheral->disconnected += Poco::delegate(this, &SensorTagSensor::onDisconnected);
+	_pPeripheral->notificationReceived += Poco::delegate(this, &SensorTagSensor::onNotificationReceived);
 }
 
 	
@@ -98,6 +119,7 @@ SensorTagSensor::~SensorTagSensor()
 {
 	_pPeripheral->connected -= Poco::delegate(this, &SensorTagSensor::onConnected);
 	_pPeripheral->disconnected -= Poco::delegate(this, &SensorTagSensor::onDisconnected);
+	_pPeripheral->notificationReceived -= Poco::delegate(this, &SensorTagSensor::onNotificationReceived);
 
 	if (_pPollTask) _pPollTask->cancel();
 	_pPeripheral = 0;
@@ -110,22 +132,34 @@ bool SensorTagSensor::isConnected() const
 }
 
 
-double SensorTagSensor::value() const
+bool SensorTagSensor::isStreaming() const
 {
-	Poco::Mutex::ScopedLock lock(_mutex);
+	Poco::FastMutex::ScopedLock lock(_valueMutex);
+
+	return _streaming;
+}
 
-	if (!_pPollTask && _pPeripheral->isConnected())
+
+double SensorTagSensor::value() const
+{
 	{
-		const_cast<SensorTagSensor*>(this)->poll();
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		if (!_pPollTask && !isStreaming() && _pPeripheral->isConnected())
+		{
+			const_cast<SensorTagSensor*>(this)->poll();
+		}
 	}
 
+	Poco::FastMutex::ScopedLock lock(_valueMutex);
+
 	return _value;
 }
 
 
 bool SensorTagSensor::ready() const
 {
-	Poco::Mutex::ScopedLock lock(_mutex);
+	Poco::FastMutex::ScopedLock lock(_valueMutex);
 
 	return _ready && _pPeripheral->isConnected();	
 }
@@ -151,6 +185,45 @@ void SensorTagSensor::stopPolling()
 }
 
 
+bool SensorTagSensor::startStreaming()
+{
+	if (!_params.streaming) return false;
+
+	long period = _params.pollInterval;
+	if (period < MIN_STREAMING_PERIOD) period = MIN_STREAMING_PERIOD;
+	else if (period > MAX_STREAMING_PERIOD) period = MAX_STREAMING_PERIOD;
+	try
+	{
+		_pPeripheral->writeUInt8(_periodChar.valueHandle, static_cast<Poco::UInt8>(period/10), true);
+		_pPeripheral->writeUInt16(_notifHandle, 1, true);
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.warning(Poco::format("Cannot enable notifications for %s sensor, falling back to polling: %s", _params.physicalQuantity, exc.displayText()));
+		return false;
+	}
+
+	Poco::FastMutex::ScopedLock lock(_valueMutex);
+	_streaming = true;
+	return true;
+}
+
+
+void SensorTagSensor::stopStreaming()
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_valueMutex);
+
+		if (!_streaming) return;
+		_streaming = false;
+	}
+	if (_pPeripheral->isConnected())
+	{
+		_pPeripheral->writeUInt16(_notifHandle, 0, true);
+	}
+}
+
+
 void SensorTagSensor::enable(bool enabled)
 {
 	Poco::Mutex::ScopedLock lock(_mutex);
@@ -159,10 +232,14 @@ void SensorTagSensor::enable(bool enabled)
 
 	if (enabled)
 	{
-		startPolling();
+		if (startStreaming())
+			stopPolling();
+		else
+			startPolling();
 	}
 	else
 	{
+		stopStreaming();
 		stopPolling();
 	}
 	_enabled = enabled;
@@ -183,6 +260,12 @@ void SensorTagSensor::setEnabled(const std::string&, const Poco::Any& value)
 }
 
 
+Poco::Any SensorTagSensor::getStreaming(const std::string&) const
+{
+	return isStreaming();
+}
+
+
 Poco::Any SensorTagSensor::getConnected(const std::string&) const
 {
 	return isConnected();
@@ -191,7 +274,7 @@ Poco::Any SensorTagSensor::getConnected(const std::string&) const
 
 Poco::Any SensorTagSensor::getValueChangedDelta(const std::string&) const
 {
-	Poco::Mutex::ScopedLock lock(_mutex);
+	Poco::FastMutex::ScopedLock lock(_valueMutex);
 
 	return _valueChangedDelta;
 }
@@ -199,7 +282,7 @@ Poco::Any SensorTagSensor::getValueChangedDelta(const std::string&) const
 
 void SensorTagSensor::setValueChangedDelta(const std::string&, const Poco::Any& value)
 {
-	Poco::Mutex::ScopedLock lock(_mutex);
+	Poco::FastMutex::ScopedLock lock(_valueMutex);
 
 	double delta = Poco::AnyCast<double>(value);
 	if (delta != _valueChangedDelta)
@@ -258,7 +341,7 @@ Poco::Any SensorTagSensor::getPhysicalUnit(const std::string&) const
 
 void SensorTagSensor::update(double value)
 {
-	Poco::Mutex::ScopedLock lock(_mutex);
+	Poco::FastMutex::ScopedLock lock(_valueMutex);
 
 	if (!_ready || _value != value)
 	{
@@ -269,6 +352,12 @@ void SensorTagSensor::update(double value)
 }
 
 
+void SensorTagSensor::poll()
+{
+	decode(_pPeripheral->readString(_dataChar.valueHandle));
+}
+
+
 void SensorTagSensor::init()
 {
 	enable(true);
@@ -287,6 +376,28 @@ void SensorTagSensor::onConnected()
 void SensorTagSensor::onDisconnected()
 {
 	stopPolling();
+
+	Poco::FastMutex::ScopedLock lock(_valueMutex);
+	_streaming = false;
+}
+
+
+void SensorTagSensor::onNotificationReceived(const GATTClient::Notification& nf)
+{
+	// Called by the GATT client's reader thread, so this
+	// must not wait for _mutex, which is held during
+	// GATT round trips.
+	if (nf.handle == _dataChar.valueHandle && isStreaming())
+	{
+		try
+		{
+			decode(nf.data);
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.log(exc);
+		}
+	}
 }
 
 
@@ -307,9 +418,8 @@ SensorTag1IRAmbientTemperatureSensor::~SensorTag1IRAmbientTemperatureSensor()
 }
 
 
-void SensorTag1IRAmbientTemperatureSensor::poll()
+void SensorTag1IRAmbientTemperatureSensor::decode(const std::string& data)
 {
-	std::string data = _pPeripheral->readString(_dataChar.valueHandle);
 	if (data.size() == 4)
 	{
 		Poco::MemoryInputStream istr(data.data(), data.size());
@@ -340,9 +450,8 @@ SensorTag1IRObjectTemperatureSensor::~SensorTag1IRObjectTemperatureSensor()
 }
 
 
-void SensorTag1IRObjectTemperatureSensor::poll()
+void SensorTag1IRObjectTemperatureSensor::decode(const std::string& data)
 {
-	std::string data = _pPeripheral->readString(_dataChar.valueHandle);
 	if (data.size() == 4)
 	{
 		Poco::MemoryInputStream istr(data.data(), data.size());
@@ -388,9 +497,8 @@ SensorTag2IRAmbientTemperatureSensor::~SensorTag2IRAmbientTemperatureSensor()
 }
 
 
-void SensorTag2IRAmbientTemperatureSensor::poll()
+void SensorTag2IRAmbientTemperatureSensor::decode(const std::string& data)
 {
-	std::string data = _pPeripheral->readString(_dataChar.valueHandle);
 	if (data.size() == 4)
 	{
 		Poco::MemoryInputStream istr(data.data(), data.size());
@@ -422,9 +530,8 @@ SensorTag2IRObjectTemperatureSensor::~SensorTag2IRObjectTemperatureSensor()
 }
 
 
-void SensorTag2IRObjectTemperatureSensor::poll()
+void SensorTag2IRObjectTemperatureSensor::decode(const std::string& data)
 {
-	std::string data = _pPeripheral->readString(_dataChar.valueHandle);
 	if (data.size() == 4)
 	{
 		Poco::MemoryInputStream istr(data.data(), data.size());
@@ -456,16 +563,18 @@ SensorTagHumiditySensor::~SensorTagHumiditySensor()
 }
 
 
-void SensorTagHumiditySensor::poll()
+void SensorTagHumiditySensor::decode(const std::string& data)
 {
-	std::string data = _pPeripheral->readString(_dataChar.valueHandle);
-	Poco::MemoryInputStream istr(data.data(), data.size());
-	Poco::BinaryReader reader(istr, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
-	Poco::UInt16 rawT;
-	Poco::UInt16 rawH;
-	reader >> rawT >> rawH;
-	double rh = -6.0 + 125.0 * ((rawH & 0xFFFC)/65536.0);
-	update(rh);
+	if (data.size() == 4)
+	{
+		Poco::MemoryInputStream istr(data.data(), data.size());
+		Poco::BinaryReader reader(istr, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+		Poco::UInt16 rawT;
+		Poco::UInt16 rawH;
+		reader >> rawT >> rawH;
+		double rh = -6.0 + 125.0 * ((rawH & 0xFFFC)/65536.0);
+		update(rh);
+	}
 }
 
 
@@ -486,13 +595,17 @@ SensorTag2LightSensor::~SensorTag2LightSensor()
 }
 
 
-void SensorTag2LightSensor::poll()
+void SensorTag2LightSensor::decode(const std::string& data)
 {
-	Poco::UInt16 raw = _pPeripheral->readUInt16(_dataChar.valueHandle);
-	Poco::UInt16 m = raw & 0x0FFF;
-	Poco::UInt16 e = (raw & 0xF000) >> 12;
+	if (data.size() == 2)
+	{
+		Poco::UInt16 raw = static_cast<unsigned char>(data[0]) 
+						 + (static_cast<unsigned char>(data[1]) << 8);
+		Poco::UInt16 m = raw & 0x0FFF;
+		Poco::UInt16 e = (raw & 0xF000) >> 12;
  
-	update(m*(0.01*std::pow(2.0, e)));
+		update(m*(0.01*std::pow(2.0, e)));
+	}
 }
 
 
@@ -521,9 +634,8 @@ SensorTag1AirPressureSensor::~SensorTag1AirPressureSensor()
 }
 
 
-void SensorTag1AirPressureSensor::poll()
+void SensorTag1AirPressureSensor::decode(const std::string& bytes)
 {
-	std::string bytes = _pPeripheral->readString(_dataChar.valueHandle);
 	if (bytes.size() == 6)
 	{
 		Poco::UInt32 raw = static_cast<unsigned char>(bytes[3]) 
@@ -552,9 +664,8 @@ SensorTag2AirPressureSensor::~SensorTag2AirPressureSensor()
 }
 
 
-void SensorTag2AirPressureSensor::poll()
+void SensorTag2AirPressureSensor::decode(const std::string& bytes)
 {
-	std::string bytes = _pPeripheral->readString(_dataChar.valueHandle);
 	if (bytes.size() == 6)
 	{
 		Poco::UInt32 raw = static_cast<unsigned char>(bytes[3]) 
@@ -21,6 +21,8 @@
 #include "Poco/Util/Timer.h"
 #include "Poco/Util/TimerTask.h"
 #include "Poco/SharedPtr.h"
+#include "Poco/Mutex.h"
+#include "Poco/Logger.h"
 
 
 namespace IoT {
@@ -38,9 +40,12 @@ public:
 		std::string serviceUUID;
 		std::string controlUUID;
 		std::string dataUUID;
+		std::string periodUUID;
+		std::string notifUUID;
 		std::string physicalQuantity;
 		std::string physicalUnit;
 		long pollInterval;
+		bool streaming;
 	};
 	
 	SensorTagSensor(Peripheral::Ptr pPeripheral, const Params& params, Poco::SharedPtr<Poco::Util::Timer> pTimer);
@@ -52,6 +57,10 @@ public:
 	bool isConnected() const;
 		/// Returns true if the sensor's peripheral is connected.
 
+	bool isStreaming() const;
+		/// Returns true if the sensor receives its values via
+		/// GATT notifications, rather than by polling.
+
 	// Sensor
 	double value() const;
 	bool ready() const;
@@ -63,12 +72,15 @@ protected:
 	void init();
 	void startPolling();
 	void stopPolling();
+	bool startStreaming();
+	void stopStreaming();
 	void enable(bool enabled);
 	Poco::Any getValueChangedDelta(const std::string&) const;
 	void setValueChangedDelta(const std::string&, const Poco::Any& value);
 	Poco::Any getConnected(const std::string&) const;
 	Poco::Any getEnabled(const std::string&) const;
 	void setEnabled(const std::string&, const Poco::Any& value);
+	Poco::Any getStreaming(const std::string&) const;
 	Poco::Any getDisplayValue(const std::string&) const;
 	Poco::Any getDeviceIdentifier(const std::string&) const;
 	Poco::Any getName(const std::string&) const;
@@ -76,9 +88,17 @@ protected:
 	Poco::Any getPhysicalQuantity(const std::string&) const;
 	Poco::Any getPhysicalUnit(const std::string&) const;
 	void update(double value);
-	virtual void poll() = 0;
+	void poll();
+	virtual void decode(const std::string& data) = 0;
 	void onConnected();
 	void onDisconnected();
+	void onNotificationReceived(const GATTClient::Notification& nf);
+
+	enum
+	{
+		MIN_STREAMING_PERIOD = 100,
+		MAX_STREAMING_PERIOD = 2550
+	};
 
 protected:
 	Params _params;
@@ -87,8 +107,11 @@ protected:
 	Poco::Util::TimerTask::Ptr _pPollTask;
 	Characteristic _controlChar;
 	Characteristic _dataChar;
+	Characteristic _periodChar;
+	Poco::UInt16 _notifHandle;
 	bool _ready;
 	bool _enabled;
+	bool _streaming;
 	double _value;
 	double _valueChangedDelta;
 	Poco::SharedPtr<IoT::Devices::EventModerationPolicy<double> > _pEventPolicy;
@@ -97,6 +120,8 @@ protected:
 	Poco::Any _name;
 	Poco::Any _physicalQuantity;
 	Poco::Any _physicalUnit;
+	mutable Poco::FastMutex _valueMutex;
+	Poco::Logger& _logger;
 	
 	friend class PollTask;
 };
@@ -112,7 +137,7 @@ public:
 		/// Destroys the SensorTag1IRAmbientTemperatureSensor.
 		
 protected:
-	void poll();
+	void decode(const std::string& data);
 };
 
 
@@ -126,7 +151,7 @@ public:
 		/// Destroys the SensorTag1IRObjectTemperatureSensor.
 		
 protected:
-	void poll();
+	void decode(const std::string& data);
 };
 
 
@@ -140,7 +165,7 @@ public:
 		/// Destroys the SensorTag2IRAmbientTemperatureSensor.
 		
 protected:
-	void poll();
+	void decode(const std::string& data);
 };
 
 
@@ -154,7 +179,7 @@ public:
 		/// Destroys the SensorTag2IRObjectTemperatureSensor.
 		
 protected:
-	void poll();
+	void decode(const std::string& data);
 };
 
 
@@ -168,7 +193,7 @@ public:
 		/// Destroys the SensorTagHumiditySensor.
 		
 protected:
-	void poll();
+	void decode(const std::string& data);
 };
 
 
@@ -182,7 +207,7 @@ public:
 		/// Destroys the SensorTag2LightSensor.
 		
 protected:
-	void poll();
+	void decode(const std::string& data);
 };
 
 
@@ -196,7 +221,7 @@ public:
 		/// Destroys the SensorTag1AirPressureSensor.
 		
 protected:
-	void poll();
+	void decode(const std::string& data);
 
 private:
 	Poco::UInt16 _calCoeff[8];
@@ -213,7 +238,7 @@ public:
 		/// Destroys the SensorTag2AirPressureSensor.
 		
 protected:
-	void poll();
+	void decode(const std::string& data);
 };
 
 
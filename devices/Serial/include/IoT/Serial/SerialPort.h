@@ -192,6 +192,8 @@ protected:
 	
 	static const std::string LOGGER_NAME;
 
+	friend class SerialReactor;
+
 private:
 	std::string _device;
 	int _baudRate;
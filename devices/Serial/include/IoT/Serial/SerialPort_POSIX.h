@@ -80,6 +80,7 @@ public:
 	int pollImpl(char* data, std::size_t size, const Poco::Timespan& timeout);
 	int readImpl(char* data, std::size_t size);
 	int writeImpl(const char* data, std::size_t size);
+	int handleImpl() const;
 
 private:
 	int _fd;
@@ -95,6 +96,12 @@ inline bool SerialPortImpl::isOpenImpl() const
 }
 
 
+inline int SerialPortImpl::handleImpl() const
+{
+	return _fd;
+}
+
+
 } } // namespace IoT::Serial
 
 
@@ -0,0 +1,248 @@
+//
+// SerialReactor.h
+//
+// $Id$
+//
+// Library: IoT/Serial
+// Package: Serial
+// Module:  SerialReactor
+//
+// Definition of the SerialReactor class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Serial_SerialReactor_INCLUDED
+#define IoT_Serial_SerialReactor_INCLUDED
+
+
+#include "IoT/Serial/Serial.h"
+#include "IoT/Serial/SerialPort.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include "Poco/Clock.h"
+#include "Poco/Timespan.h"
+#include "Poco/Buffer.h"
+#include "Poco/Logger.h"
+#include "Poco/Exception.h"
+#include <deque>
+#include <map>
+
+
+namespace IoT {
+namespace Serial {
+
+
+class IoTSerial_API SerialReactor: public Poco::Runnable
+	/// The SerialReactor serves any number of SerialPort objects
+	/// from a single thread, waiting for all of them in a single
+	/// epoll() call.
+	///
+	/// For every registered SerialPort, a Handler is notified when
+	/// data has been received. The data is read into a buffer that is
+	/// allocated once by the SerialReactor and shared by all ports.
+	/// Data can be sent with write(), which appends it to the port's
+	/// write queue. The queue is written as the port becomes writable,
+	/// and the Handler is notified as soon as all data has been transmitted.
+	/// Optionally, a Handler is notified periodically.
+	///
+	/// While a SerialPort is registered with a SerialReactor, its
+	/// file descriptor is in non-blocking mode, and all input and
+	/// output must go through the SerialReactor.
+	///
+	/// The SerialReactor is currently only supported on Linux.
+	/// On other platforms, the constructor throws a
+	/// Poco::NotImplementedException.
+{
+public:
+	typedef Poco::SharedPtr<SerialPort> SerialPortPtr;
+
+	class IoTSerial_API Handler
+		/// A Handler receives notifications for a SerialPort
+		/// registered with a SerialReactor.
+		///
+		/// All notifications are delivered by the SerialReactor's
+		/// thread. A Handler may call any method of the SerialReactor,
+		/// including removePort() for its own SerialPort.
+	{
+	public:
+		virtual void onDataReceived(const char* data, std::size_t size) = 0;
+			/// Called with data received from the port. The data is
+			/// only valid until the method returns.
+
+		virtual void onWriteComplete();
+			/// Called when all queued data has been transmitted.
+			///
+			/// The default implementation does nothing.
+
+		virtual void onTimer();
+			/// Called periodically, if a timer interval has been
+			/// specified when the port was registered.
+			///
+			/// The default implementation does nothing.
+
+		virtual void onError(const Poco::Exception& exc);
+			/// Called when reading from or writing to the port fails.
+			/// The port is removed from the SerialReactor before
+			/// the method is called.
+			///
+			/// The default implementation does nothing.
+
+	protected:
+		virtual ~Handler();
+	};
+
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 4096
+			/// Default size of the receive buffer.
+	};
+
+	explicit SerialReactor(std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates the SerialReactor and starts its thread.
+
+	~SerialReactor();
+		/// Stops the SerialReactor's thread and destroys the SerialReactor.
+		///
+		/// All ports must have been removed before.
+
+	void addPort(SerialPortPtr pPort, Handler& handler, const Poco::Timespan& timerInterval = 0);
+		/// Registers the given open SerialPort and its Handler.
+		///
+		/// If timerInterval is non-zero, the Handler's onTimer()
+		/// method is called at the given interval.
+		///
+		/// Data already buffered by the SerialPort is delivered to
+		/// the Handler as soon as possible.
+		///
+		/// Throws a Poco::ExistsException if the port is already registered.
+
+	void removePort(SerialPortPtr pPort);
+		/// Unregisters the given SerialPort. Data still in the write
+		/// queue is discarded.
+		///
+		/// When called from a thread other than the SerialReactor's
+		/// thread, waits until a notification currently delivered to
+		/// the port's Handler has completed. No notifications are
+		/// delivered to the Handler after the method returns.
+		///
+		/// Does nothing if the port is not registered.
+
+	bool hasPort(SerialPortPtr pPort) const;
+		/// Returns true if the given SerialPort is registered.
+
+	std::size_t write(SerialPortPtr pPort, const char* data, std::size_t size);
+		/// Appends the given data to the write queue of the given
+		/// SerialPort and returns immediately.
+		///
+		/// Returns the number of bytes in the write queue, including
+		/// the given data.
+		///
+		/// Throws a Poco::NotFoundException if the port is not registered.
+
+	std::size_t write(SerialPortPtr pPort, const std::string& data);
+		/// Appends the given data to the write queue of the given
+		/// SerialPort and returns immediately.
+		///
+		/// Returns the number of bytes in the write queue, including
+		/// the given data.
+		///
+		/// Throws a Poco::NotFoundException if the port is not registered.
+
+	std::size_t bufferSize() const;
+		/// Returns the size of the receive buffer.
+
+	static bool isSupported();
+		/// Returns true if the SerialReactor is supported on
+		/// the current platform.
+
+	static SerialReactor& defaultReactor();
+		/// Returns a reference to the default SerialReactor,
+		/// which can be shared by all serial device drivers
+		/// in a process.
+
+	// Runnable
+	void run();
+
+protected:
+	struct Registration: public Poco::RefCountedObject
+	{
+		Poco::UInt64 id;
+		SerialPortPtr pPort;
+		Handler* pHandler;
+		int fd;
+		int fdFlags;
+		bool removed;
+		bool writable;
+		std::deque<std::string> writeQueue;
+		std::size_t writeOffset;
+		std::size_t queued;
+		bool draining;
+		Poco::Clock drainCheck;
+		Poco::Timespan timerInterval;
+		Poco::Clock nextTimer;
+	};
+
+	typedef Poco::AutoPtr<Registration> RegistrationPtr;
+	typedef std::map<Poco::UInt64, RegistrationPtr> Registrations;
+
+	RegistrationPtr find(const SerialPortPtr& pPort) const;
+	void wakeUp();
+	void updateEvents(const Registration& reg);
+	int nextTimeout();
+	void handleReadable(RegistrationPtr pReg);
+	void handleWritable(RegistrationPtr pReg);
+	void handleDrain(RegistrationPtr pReg);
+	void handleTimer(RegistrationPtr pReg);
+	void handleError(RegistrationPtr pReg, const Poco::Exception& exc);
+	bool beginDispatch(RegistrationPtr pReg);
+	void endDispatch();
+	void unregister(Registration& reg);
+
+private:
+	SerialReactor(const SerialReactor&);
+	SerialReactor& operator = (const SerialReactor&);
+
+	int _epollFd;
+	int _eventFd;
+	Poco::Buffer<char> _buffer;
+	Registrations _registrations;
+	std::deque<Poco::UInt64> _pendingReads;
+	Poco::UInt64 _nextId;
+	Registration* _pDispatching;
+	bool _stopped;
+	Poco::Logger& _logger;
+	Poco::Thread _thread;
+	Poco::Condition _dispatched;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline std::size_t SerialReactor::bufferSize() const
+{
+	return _buffer.size();
+}
+
+
+inline std::size_t SerialReactor::write(SerialPortPtr pPort, const std::string& data)
+{
+	return write(pPort, data.data(), data.size());
+}
+
+
+} } // namespace IoT::Serial
+
+
+#endif // IoT_Serial_SerialReactor_INCLUDED
@@ -0,0 +1,686 @@
+//
+// SerialReactor.cpp
+//
+// $Id$
+//
+// Library: IoT/Serial
+// Package: Serial
+// Module:  SerialReactor
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Serial/SerialReactor.h"
+#include "Poco/SingletonHolder.h"
+#include <vector>
+#if POCO_OS == POCO_OS_LINUX
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#endif
+
+
+namespace IoT {
+namespace Serial {
+
+
+//
+// SerialReactor::Handler
+//
+
+
+SerialReactor::Handler::~Handler()
+{
+}
+
+
+void SerialReactor::Handler::onWriteComplete()
+{
+}
+
+
+void SerialReactor::Handler::onTimer()
+{
+}
+
+
+void SerialReactor::Handler::onError(const Poco::Exception&)
+{
+}
+
+
+//
+// SerialReactor
+//
+
+
+namespace
+{
+	static Poco::SingletonHolder<SerialReactor> sh;
+}
+
+
+SerialReactor& SerialReactor::defaultReactor()
+{
+	return *sh.get();
+}
+
+
+#if POCO_OS == POCO_OS_LINUX
+
+
+namespace
+{
+	const int MAX_EVENTS = 16;
+	const Poco::UInt64 WAKEUP_ID = 0;
+	const Poco::Clock::ClockDiff MIN_DRAIN_CHECK_INTERVAL = 1000;
+}
+
+
+SerialReactor::SerialReactor(std::size_t bufferSize):
+	_epollFd(-1),
+	_eventFd(-1),
+	_buffer(bufferSize),
+	_nextId(WAKEUP_ID + 1),
+	_pDispatching(0),
+	_stopped(false),
+	_logger(Poco::Logger::get("IoT.SerialReactor"))
+{
+	_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (_epollFd == -1) throw Poco::IOException("cannot create epoll instance", strerror(errno));
+
+	_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (_eventFd == -1)
+	{
+		int err = errno;
+		::close(_epollFd);
+		throw Poco::IOException("cannot create eventfd", strerror(err));
+	}
+
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u64 = WAKEUP_ID;
+	if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, _eventFd, &ev) == -1)
+	{
+		int err = errno;
+		::close(_eventFd);
+		::close(_epollFd);
+		throw Poco::IOException("cannot register eventfd", strerror(err));
+	}
+
+	_thread.setName("SerialReactor");
+	_thread.start(*this);
+}
+
+
+SerialReactor::~SerialReactor()
+{
+	try
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			_stopped = true;
+		}
+		wakeUp();
+		_thread.join();
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		poco_assert_dbg (_registrations.empty());
+		while (!_registrations.empty())
+		{
+			unregister(*_registrations.begin()->second);
+		}
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+	::close(_eventFd);
+	::close(_epollFd);
+}
+
+
+void SerialReactor::addPort(SerialPortPtr pPort, Handler& handler, const Poco::Timespan& timerInterval)
+{
+	if (!pPort->isOpenImpl()) throw Poco::IllegalStateException("Port is not open");
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (find(pPort)) throw Poco::ExistsException("Serial port already registered", pPort->device());
+
+	RegistrationPtr pReg = new Registration;
+	pReg->id            = _nextId++;
+	pReg->pPort         = pPort;
+	pReg->pHandler      = &handler;
+	pReg->fd            = pPort->handleImpl();
+	pReg->removed       = false;
+	pReg->writable      = false;
+	pReg->writeOffset   = 0;
+	pReg->queued        = 0;
+	pReg->draining      = false;
+	pReg->timerInterval = timerInterval;
+	pReg->nextTimer    += timerInterval.totalMicroseconds();
+
+	pReg->fdFlags = fcntl(pReg->fd, F_GETFL);
+	if (pReg->fdFlags == -1 || fcntl(pReg->fd, F_SETFL, pReg->fdFlags | O_NONBLOCK) == -1)
+		throw Poco::IOException("cannot set serial port to non-blocking mode", strerror(errno));
+
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u64 = pReg->id;
+	if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, pReg->fd, &ev) == -1)
+	{
+		int err = errno;
+		fcntl(pReg->fd, F_SETFL, pReg->fdFlags);
+		throw Poco::IOException("cannot register serial port", strerror(err));
+	}
+
+	_registrations[pReg->id] = pReg;
+	if (pPort->available() > 0)
+	{
+		_pendingReads.push_back(pReg->id);
+	}
+	wakeUp();
+}
+
+
+void SerialReactor::removePort(SerialPortPtr pPort)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	RegistrationPtr pReg = find(pPort);
+	if (!pReg) return;
+
+	unregister(*pReg);
+	if (Poco::Thread::current() != &_thread)
+	{
+		while (_pDispatching == pReg.get())
+		{
+			_dispatched.wait(_mutex);
+		}
+	}
+}
+
+
+bool SerialReactor::hasPort(SerialPortPtr pPort) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return !find(pPort).isNull();
+}
+
+
+std::size_t SerialReactor::write(SerialPortPtr pPort, const char* data, std::size_t size)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	RegistrationPtr pReg = find(pPort);
+	if (!pReg) throw Poco::NotFoundException("Serial port not registered", pPort->device());
+
+	if (size > 0)
+	{
+		pReg->writeQueue.push_back(std::string(data, size));
+		pReg->queued += size;
+		pReg->draining = false;
+		if (!pReg->writable)
+		{
+			pReg->writable = true;
+			updateEvents(*pReg);
+		}
+	}
+	return pReg->queued;
+}
+
+
+bool SerialReactor::isSupported()
+{
+	return true;
+}
+
+
+void SerialReactor::run()
+{
+	struct epoll_event events[MAX_EVENTS];
+	std::vector<RegistrationPtr> ready;
+	for (;;)
+	{
+		int timeout;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			if (_stopped) break;
+			timeout = nextTimeout();
+		}
+
+		int n = epoll_wait(_epollFd, events, MAX_EVENTS, timeout);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			_logger.critical(std::string("epoll_wait() failed: ") + strerror(errno));
+			break;
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			if (events[i].data.u64 == WAKEUP_ID)
+			{
+				Poco::UInt64 value;
+				while (::read(_eventFd, &value, sizeof(value)) > 0)
+				{
+				}
+				continue;
+			}
+
+			RegistrationPtr pReg;
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+
+				Registrations::iterator it = _registrations.find(events[i].data.u64);
+				if (it == _registrations.end()) continue;
+				pReg = it->second;
+			}
+			if (events[i].events & EPOLLOUT)
+			{
+				handleWritable(pReg);
+			}
+			if (events[i].events & EPOLLIN)
+			{
+				handleReadable(pReg);
+			}
+			else if (events[i].events & (EPOLLERR | EPOLLHUP))
+			{
+				handleError(pReg, Poco::IOException("Serial port hangup", pReg->pPort->device()));
+			}
+		}
+
+		ready.clear();
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			while (!_pendingReads.empty())
+			{
+				Registrations::iterator it = _registrations.find(_pendingReads.front());
+				if (it != _registrations.end()) ready.push_back(it->second);
+				_pendingReads.pop_front();
+			}
+		}
+		for (std::vector<RegistrationPtr>::iterator it = ready.begin(); it != ready.end(); ++it)
+		{
+			handleReadable(*it);
+		}
+
+		ready.clear();
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			for (Registrations::iterator it = _registrations.begin(); it != _registrations.end(); ++it)
+			{
+				const Registration& reg = *it->second;
+				if ((reg.draining && reg.drainCheck.isElapsed(0)) || (reg.timerInterval > 0 && reg.nextTimer.isElapsed(0)))
+				{
+					ready.push_back(it->second);
+				}
+			}
+		}
+		for (std::vector<RegistrationPtr>::iterator it = ready.begin(); it != ready.end(); ++it)
+		{
+			handleDrain(*it);
+			handleTimer(*it);
+		}
+	}
+}
+
+
+SerialReactor::RegistrationPtr SerialReactor::find(const SerialPortPtr& pPort) const
+{
+	for (Registrations::const_iterator it = _registrations.begin(); it != _registrations.end(); ++it)
+	{
+		if (it->second->pPort.get() == pPort.get()) return it->second;
+	}
+	return RegistrationPtr();
+}
+
+
+void SerialReactor::wakeUp()
+{
+	Poco::UInt64 value = 1;
+	if (::write(_eventFd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+	{
+		throw Poco::IOException("cannot signal SerialReactor", strerror(errno));
+	}
+}
+
+
+void SerialReactor::updateEvents(const Registration& reg)
+{
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = reg.writable ? EPOLLIN | EPOLLOUT : EPOLLIN;
+	ev.data.u64 = reg.id;
+	if (epoll_ctl(_epollFd, EPOLL_CTL_MOD, reg.fd, &ev) == -1)
+		throw Poco::IOException("cannot update serial port registration", strerror(errno));
+}
+
+
+int SerialReactor::nextTimeout()
+{
+	if (!_pendingReads.empty()) return 0;
+
+	Poco::Clock::ClockDiff timeout = -1;
+	for (Registrations::const_iterator it = _registrations.begin(); it != _registrations.end(); ++it)
+	{
+		const Registration& reg = *it->second;
+		if (reg.draining)
+		{
+			Poco::Clock::ClockDiff remaining = -reg.drainCheck.elapsed();
+			if (timeout < 0 || remaining < timeout) timeout = remaining;
+		}
+		if (reg.timerInterval > 0)
+		{
+			Poco::Clock::ClockDiff remaining = -reg.nextTimer.elapsed();
+			if (timeout < 0 || remaining < timeout) timeout = remaining;
+		}
+	}
+	if (timeout < 0) return -1;
+	return static_cast<int>((timeout + 999)/1000);
+}
+
+
+void SerialReactor::handleReadable(RegistrationPtr pReg)
+{
+	if (!beginDispatch(pReg)) return;
+
+	SerialPort& port = *pReg->pPort;
+	std::size_t n = 0;
+	if (port.available() > 0)
+	{
+		// data buffered by the SerialPort before it was registered
+		n = port.read(_buffer.begin(), _buffer.size());
+	}
+	else
+	{
+		int rc = port.readImpl(_buffer.begin(), _buffer.size());
+		if (rc < 0 && (errno == EAGAIN || errno == EINTR))
+		{
+			endDispatch();
+			return;
+		}
+		else if (rc < 0)
+		{
+			handleError(pReg, Poco::IOException("Serial port read error", strerror(errno)));
+			endDispatch();
+			return;
+		}
+		else if (rc == 0)
+		{
+			handleError(pReg, Poco::IOException("Serial port hangup", port.device()));
+			endDispatch();
+			return;
+		}
+		n = rc;
+	}
+
+	try
+	{
+		pReg->pHandler->onDataReceived(_buffer.begin(), n);
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.log(exc);
+	}
+
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (!pReg->removed && port.available() > 0)
+		{
+			_pendingReads.push_back(pReg->id);
+		}
+	}
+	endDispatch();
+}
+
+
+void SerialReactor::handleWritable(RegistrationPtr pReg)
+{
+	if (!beginDispatch(pReg)) return;
+
+	int err = 0;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		while (!pReg->writeQueue.empty())
+		{
+			const std::string& data = pReg->writeQueue.front();
+			int n = pReg->pPort->writeImpl(data.data() + pReg->writeOffset, data.size() - pReg->writeOffset);
+			if (n < 0)
+			{
+				if (errno == EINTR) continue;
+				if (errno != EAGAIN) err = errno;
+				break;
+			}
+			pReg->writeOffset += n;
+			pReg->queued -= n;
+			if (pReg->writeOffset == data.size())
+			{
+				pReg->writeQueue.pop_front();
+				pReg->writeOffset = 0;
+			}
+		}
+		if (err == 0 && pReg->writeQueue.empty() && !pReg->removed)
+		{
+			pReg->writable = false;
+			pReg->draining = true;
+			pReg->drainCheck.update();
+			updateEvents(*pReg);
+		}
+	}
+	if (err != 0)
+	{
+		handleError(pReg, Poco::IOException("Serial port write error", strerror(err)));
+	}
+	endDispatch();
+}
+
+
+void SerialReactor::handleDrain(RegistrationPtr pReg)
+{
+	if (!beginDispatch(pReg)) return;
+
+	bool complete = false;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (pReg->draining && pReg->drainCheck.isElapsed(0))
+		{
+			// Instead of blocking in tcdrain() until the output queue
+			// is empty, wait for the expected transmission time.
+			int outq = 0;
+			if (ioctl(pReg->fd, TIOCOUTQ, &outq) == 0 && outq > 0)
+			{
+				int baudRate = pReg->pPort->baudRate();
+				Poco::Clock::ClockDiff wait = baudRate > 0 ? static_cast<Poco::Clock::ClockDiff>(outq)*10*1000000/baudRate : 0;
+				pReg->drainCheck.update();
+				pReg->drainCheck += wait > MIN_DRAIN_CHECK_INTERVAL ? wait : MIN_DRAIN_CHECK_INTERVAL;
+			}
+			else
+			{
+				pReg->draining = false;
+				complete = true;
+			}
+		}
+	}
+	if (complete)
+	{
+		try
+		{
+			pReg->pPort->drainImpl();
+			pReg->pHandler->onWriteComplete();
+		}
+		catch (Poco::IOException& exc)
+		{
+			handleError(pReg, exc);
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.log(exc);
+		}
+	}
+	endDispatch();
+}
+
+
+void SerialReactor::handleTimer(RegistrationPtr pReg)
+{
+	if (!beginDispatch(pReg)) return;
+
+	bool due = false;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (pReg->timerInterval > 0 && pReg->nextTimer.isElapsed(0))
+		{
+			pReg->nextTimer += pReg->timerInterval.totalMicroseconds();
+			if (pReg->nextTimer.isElapsed(0))
+			{
+				// skip missed intervals
+				pReg->nextTimer.update();
+				pReg->nextTimer += pReg->timerInterval.totalMicroseconds();
+			}
+			due = !pReg->removed;
+		}
+	}
+	if (due)
+	{
+		try
+		{
+			pReg->pHandler->onTimer();
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.log(exc);
+		}
+	}
+	endDispatch();
+}
+
+
+void SerialReactor::handleError(RegistrationPtr pReg, const Poco::Exception& exc)
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (pReg->removed) return;
+		unregister(*pReg);
+	}
+	try
+	{
+		pReg->pHandler->onError(exc);
+	}
+	catch (Poco::Exception& handlerExc)
+	{
+		_logger.log(handlerExc);
+	}
+}
+
+
+bool SerialReactor::beginDispatch(RegistrationPtr pReg)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (pReg->removed) return false;
+	_pDispatching = pReg.get();
+	return true;
+}
+
+
+void SerialReactor::endDispatch()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_pDispatching = 0;
+	_dispatched.broadcast();
+}
+
+
+void SerialReactor::unregister(Registration& reg)
+{
+	reg.removed = true;
+	epoll_ctl(_epollFd, EPOLL_CTL_DEL, reg.fd, 0);
+	fcntl(reg.fd, F_SETFL, reg.fdFlags);
+	_registrations.erase(reg.id);
+}
+
+
+#else
+
+
+SerialReactor::SerialReactor(std::size_t bufferSize):
+	_epollFd(-1),
+	_eventFd(-1),
+	_buffer(bufferSize),
+	_nextId(1),
+	_pDispatching(0),
+	_stopped(true),
+	_logger(Poco::Logger::get("IoT.SerialReactor"))
+{
+	throw Poco::NotImplementedException("SerialReactor is not supported on this platform");
+}
+
+
+SerialReactor::~SerialReactor()
+{
+}
+
+
+void SerialReactor::addPort(SerialPortPtr, Handler&, const Poco::Timespan&)
+{
+	throw Poco::NotImplementedException("SerialReactor::addPort()");
+}
+
+
+void SerialReactor::removePort(SerialPortPtr)
+{
+}
+
+
+bool SerialReactor::hasPort(SerialPortPtr) const
+{
+	return false;
+}
+
+
+std::size_t SerialReactor::write(SerialPortPtr, const char*, std::size_t)
+{
+	throw Poco::NotImplementedException("SerialReactor::write()");
+}
+
+
+bool SerialReactor::isSupported()
+{
+	return false;
+}
+
+
+void SerialReactor::run()
+{
+}
+
+
+#endif // POCO_OS == POCO_OS_LINUX
+
+
+} } // namespace IoT::Serial
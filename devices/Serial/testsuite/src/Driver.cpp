@@ -0,0 +1,19 @@
+//
+// Driver.cpp
+//
+// $Id$
+//
+// Console-based test driver for IoT Serial.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "CppUnit/TestRunner.h"
+#include "SerialTestSuite.h"
+
+
+CppUnitMain(SerialTestSuite)
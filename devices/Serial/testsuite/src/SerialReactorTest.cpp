@@ -0,0 +1,449 @@
+//
+// SerialReactorTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "SerialReactorTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Serial/SerialReactor.h"
+#include "IoT/Serial/SerialPort.h"
+#include "Poco/Mutex.h"
+#include "Poco/Event.h"
+#include "Poco/Thread.h"
+#include "Poco/Clock.h"
+#include "Poco/Exception.h"
+#if defined(POCO_OS_FAMILY_UNIX)
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#endif
+
+
+using IoT::Serial::SerialReactor;
+using IoT::Serial::SerialPort;
+
+
+namespace
+{
+	class PseudoTerminal
+		/// A pseudo terminal, used in place of a real serial line.
+		/// The slave device is opened by a SerialPort, the master
+		/// side simulates the connected device.
+	{
+	public:
+		PseudoTerminal():
+			_fd(-1)
+		{
+#if defined(POCO_OS_FAMILY_UNIX)
+			_fd = posix_openpt(O_RDWR | O_NOCTTY);
+			if (_fd == -1) throw Poco::IOException("cannot open pseudo terminal");
+			if (grantpt(_fd) == -1 || unlockpt(_fd) == -1)
+			{
+				::close(_fd);
+				throw Poco::IOException("cannot unlock pseudo terminal");
+			}
+			struct termios term;
+			tcgetattr(_fd, &term);
+			cfmakeraw(&term);
+			tcsetattr(_fd, TCSANOW, &term);
+			_device = ptsname(_fd);
+#else
+			throw Poco::NotImplementedException("pseudo terminal");
+#endif
+		}
+
+		~PseudoTerminal()
+		{
+			close();
+		}
+
+		const std::string& device() const
+		{
+			return _device;
+		}
+
+		void write(const std::string& data)
+		{
+#if defined(POCO_OS_FAMILY_UNIX)
+			if (::write(_fd, data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+				throw Poco::IOException("cannot write to pseudo terminal");
+#endif
+		}
+
+		std::string read(std::size_t size, long timeout = 2000)
+		{
+			std::string result;
+#if defined(POCO_OS_FAMILY_UNIX)
+			int flags = fcntl(_fd, F_GETFL);
+			fcntl(_fd, F_SETFL, flags | O_NONBLOCK);
+			Poco::Clock start;
+			while (result.size() < size && !start.isElapsed(timeout*1000))
+			{
+				char buffer[256];
+				ssize_t n = ::read(_fd, buffer, sizeof(buffer));
+				if (n > 0)
+					result.append(buffer, n);
+				else
+					Poco::Thread::sleep(5);
+			}
+			fcntl(_fd, F_SETFL, flags);
+#endif
+			return result;
+		}
+
+		void close()
+		{
+#if defined(POCO_OS_FAMILY_UNIX)
+			if (_fd != -1)
+			{
+				::close(_fd);
+				_fd = -1;
+			}
+#endif
+		}
+
+	private:
+		int _fd;
+		std::string _device;
+	};
+
+	class TestHandler: public SerialReactor::Handler
+	{
+	public:
+		TestHandler():
+			_writesCompleted(0),
+			_timers(0),
+			_errors(0)
+		{
+		}
+
+		~TestHandler()
+		{
+		}
+
+		void onDataReceived(const char* data, std::size_t size)
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_received.append(data, size);
+			_dataEvent.set();
+		}
+
+		void onWriteComplete()
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_writesCompleted++;
+			_writeEvent.set();
+		}
+
+		void onTimer()
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_timers++;
+			_timerEvent.set();
+		}
+
+		void onError(const Poco::Exception&)
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_errors++;
+			_errorEvent.set();
+		}
+
+		bool waitForData(std::size_t size, long timeout = 2000)
+		{
+			Poco::Clock start;
+			while (received().size() < size)
+			{
+				if (start.isElapsed(timeout*1000)) return false;
+				_dataEvent.tryWait(100);
+			}
+			return true;
+		}
+
+		bool waitForWrite(long timeout = 2000)
+		{
+			return _writeEvent.tryWait(timeout);
+		}
+
+		bool waitForTimers(int count, long timeout = 2000)
+		{
+			Poco::Clock start;
+			while (timers() < count)
+			{
+				if (start.isElapsed(timeout*1000)) return false;
+				_timerEvent.tryWait(100);
+			}
+			return true;
+		}
+
+		bool waitForError(long timeout = 2000)
+		{
+			return _errorEvent.tryWait(timeout);
+		}
+
+		std::string received() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _received;
+		}
+
+		int writesCompleted() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _writesCompleted;
+		}
+
+		int timers() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _timers;
+		}
+
+		int errors() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _errors;
+		}
+
+	private:
+		std::string _received;
+		int _writesCompleted;
+		int _timers;
+		int _errors;
+		Poco::Event _dataEvent;
+		Poco::Event _writeEvent;
+		Poco::Event _timerEvent;
+		Poco::Event _errorEvent;
+		mutable Poco::FastMutex _mutex;
+	};
+}
+
+
+SerialReactorTest::SerialReactorTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+SerialReactorTest::~SerialReactorTest()
+{
+}
+
+
+void SerialReactorTest::testReceive()
+{
+	PseudoTerminal pty;
+	SerialReactor::SerialPortPtr pPort = new SerialPort(pty.device());
+	SerialReactor reactor;
+	TestHandler handler;
+	reactor.addPort(pPort, handler);
+	assert (reactor.hasPort(pPort));
+
+	pty.write("$GPGGA,092750.000*76\r\n");
+	assert (handler.waitForData(22));
+	assert (handler.received() == "$GPGGA,092750.000*76\r\n");
+
+	std::string large(3*reactor.bufferSize() + 17, 'x');
+	pty.write(large);
+	assert (handler.waitForData(22 + large.size()));
+	assert (handler.received().size() == 22 + large.size());
+
+	reactor.removePort(pPort);
+	assert (!reactor.hasPort(pPort));
+	assert (handler.errors() == 0);
+}
+
+
+void SerialReactorTest::testMultiplePorts()
+{
+	PseudoTerminal pty1;
+	PseudoTerminal pty2;
+	PseudoTerminal pty3;
+	SerialReactor::SerialPortPtr pPort1 = new SerialPort(pty1.device());
+	SerialReactor::SerialPortPtr pPort2 = new SerialPort(pty2.device());
+	SerialReactor::SerialPortPtr pPort3 = new SerialPort(pty3.device());
+	SerialReactor reactor;
+	TestHandler handler1;
+	TestHandler handler2;
+	TestHandler handler3;
+	reactor.addPort(pPort1, handler1);
+	reactor.addPort(pPort2, handler2);
+	reactor.addPort(pPort3, handler3);
+
+	try
+	{
+		reactor.addPort(pPort1, handler2);
+		fail("already registered - must throw");
+	}
+	catch (Poco::ExistsException&)
+	{
+	}
+
+	pty2.write("two");
+	pty1.write("one");
+	pty3.write("three");
+	assert (handler1.waitForData(3));
+	assert (handler2.waitForData(3));
+	assert (handler3.waitForData(5));
+	assert (handler1.received() == "one");
+	assert (handler2.received() == "two");
+	assert (handler3.received() == "three");
+
+	reactor.removePort(pPort2);
+	pty1.write("1");
+	pty3.write("3");
+	assert (handler1.waitForData(4));
+	assert (handler3.waitForData(6));
+	assert (handler1.received() == "one1");
+	assert (handler3.received() == "three3");
+
+	reactor.removePort(pPort1);
+	reactor.removePort(pPort3);
+}
+
+
+void SerialReactorTest::testBufferedData()
+{
+	PseudoTerminal pty;
+	SerialReactor::SerialPortPtr pPort = new SerialPort(pty.device());
+	pty.write("ABCDEF");
+	Poco::Thread::sleep(100);
+	assert (pPort->read() == 'A');
+	assert (pPort->available() > 0);
+
+	SerialReactor reactor;
+	TestHandler handler;
+	reactor.addPort(pPort, handler);
+	assert (handler.waitForData(5));
+	assert (handler.received() == "BCDEF");
+
+	reactor.removePort(pPort);
+}
+
+
+void SerialReactorTest::testWrite()
+{
+	PseudoTerminal pty;
+	SerialReactor::SerialPortPtr pPort = new SerialPort(pty.device(), 115200);
+	SerialReactor reactor;
+	TestHandler handler;
+	reactor.addPort(pPort, handler);
+
+	assert (reactor.write(pPort, std::string("Hello, ")) >= 7);
+	reactor.write(pPort, std::string("world!"));
+	assert (pty.read(13) == "Hello, world!");
+	assert (handler.waitForWrite());
+	assert (handler.writesCompleted() >= 1);
+
+	std::string large(64*1024, 'y');
+	reactor.write(pPort, large);
+	assert (pty.read(large.size(), 5000) == large);
+	assert (handler.waitForWrite());
+
+	reactor.removePort(pPort);
+
+	try
+	{
+		reactor.write(pPort, std::string("x"));
+		fail("not registered - must throw");
+	}
+	catch (Poco::NotFoundException&)
+	{
+	}
+}
+
+
+void SerialReactorTest::testTimer()
+{
+	PseudoTerminal pty;
+	SerialReactor::SerialPortPtr pPort = new SerialPort(pty.device());
+	SerialReactor reactor;
+	TestHandler handler;
+	reactor.addPort(pPort, handler, Poco::Timespan(50*Poco::Timespan::MILLISECONDS));
+	assert (handler.waitForTimers(3));
+
+	reactor.removePort(pPort);
+	int timers = handler.timers();
+	Poco::Thread::sleep(200);
+	assert (handler.timers() == timers);
+}
+
+
+void SerialReactorTest::testRemove()
+{
+	PseudoTerminal pty;
+	SerialReactor::SerialPortPtr pPort = new SerialPort(pty.device());
+	SerialReactor reactor;
+	TestHandler handler;
+	reactor.addPort(pPort, handler);
+	reactor.removePort(pPort);
+	reactor.removePort(pPort);
+
+	pty.write("data");
+	Poco::Thread::sleep(200);
+	assert (handler.received().empty());
+
+	// the port must be usable for blocking I/O again
+	assert (pPort->read() == 'd');
+	char rest[3];
+	assert (pPort->read(rest, sizeof(rest), Poco::Timespan(2, 0)) == 3);
+	assert (std::string(rest, 3) == "ata");
+
+	reactor.addPort(pPort, handler);
+	pty.write("more");
+	assert (handler.waitForData(4));
+	assert (handler.received() == "more");
+	reactor.removePort(pPort);
+}
+
+
+void SerialReactorTest::testHangup()
+{
+	PseudoTerminal pty;
+	SerialReactor::SerialPortPtr pPort = new SerialPort(pty.device());
+	SerialReactor reactor;
+	TestHandler handler;
+	reactor.addPort(pPort, handler);
+
+	pty.close();
+	assert (handler.waitForError());
+	assert (handler.errors() == 1);
+	assert (!reactor.hasPort(pPort));
+}
+
+
+void SerialReactorTest::setUp()
+{
+}
+
+
+void SerialReactorTest::tearDown()
+{
+}
+
+
+CppUnit::Test* SerialReactorTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SerialReactorTest");
+
+	if (SerialReactor::isSupported())
+	{
+		CppUnit_addTest(pSuite, SerialReactorTest, testReceive);
+		CppUnit_addTest(pSuite, SerialReactorTest, testMultiplePorts);
+		CppUnit_addTest(pSuite, SerialReactorTest, testBufferedData);
+		CppUnit_addTest(pSuite, SerialReactorTest, testWrite);
+		CppUnit_addTest(pSuite, SerialReactorTest, testTimer);
+		CppUnit_addTest(pSuite, SerialReactorTest, testRemove);
+		CppUnit_addTest(pSuite, SerialReactorTest, testHangup);
+	}
+
+	return pSuite;
+}
@@ -0,0 +1,44 @@
+//
+// SerialReactorTest.h
+//
+// $Id$
+//
+// Definition of the SerialReactorTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef SerialReactorTest_INCLUDED
+#define SerialReactorTest_INCLUDED
+
+
+#include "IoT/Serial/Serial.h"
+#include "CppUnit/TestCase.h"
+
+
+class SerialReactorTest: public CppUnit::TestCase
+{
+public:
+	SerialReactorTest(const std::string& name);
+	~SerialReactorTest();
+
+	void testReceive();
+	void testMultiplePorts();
+	void testBufferedData();
+	void testWrite();
+	void testTimer();
+	void testRemove();
+	void testHangup();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // SerialReactorTest_INCLUDED
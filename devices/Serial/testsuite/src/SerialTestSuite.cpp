@@ -0,0 +1,24 @@
+//
+// SerialTestSuite.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "SerialTestSuite.h"
+#include "SerialReactorTest.h"
+
+
+CppUnit::Test* SerialTestSuite::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SerialTestSuite");
+
+	pSuite->addTest(SerialReactorTest::suite());
+
+	return pSuite;
+}
@@ -0,0 +1,29 @@
+//
+// SerialTestSuite.h
+//
+// $Id$
+//
+// Definition of the SerialTestSuite class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef SerialTestSuite_INCLUDED
+#define SerialTestSuite_INCLUDED
+
+
+#include "CppUnit/TestSuite.h"
+
+
+class SerialTestSuite
+{
+public:
+	static CppUnit::Test* suite();
+};
+
+
+#endif // SerialTestSuite_INCLUDED
@@ -23,6 +23,7 @@
 #include "Poco/Data/SQLite/SQLite.h"
 #include "Poco/Data/SQLite/Binder.h"
 #include "Poco/Data/SQLite/Extractor.h"
+#include "Poco/Data/SQLite/StatementCache.h"
 #include "Poco/Data/StatementImpl.h"
 #include "Poco/Data/MetaColumn.h"
 #include "Poco/SharedPtr.h"
@@ -83,6 +84,11 @@ protected:
 		/// one at a time and returning a pointer to the next one.
 		/// The remainder of the statement is kept in a string
 		/// buffer pointed to by _pLeftover member.
+		///
+		/// If the session has a StatementCache and the statement
+		/// consists of a single SQL statement, a cached handle for
+		/// the statement's SQL text is used if available, and the
+		/// handle is returned to the cache when no longer needed.
 
 	void bindImpl();
 		/// Binds parameters
@@ -95,7 +101,8 @@ protected:
 
 private:
 	void clear();
-		/// Removes the _pStmt
+		/// Removes the _pStmt, returning it to the
+		/// statement cache if it is cacheable.
 
 	typedef Poco::SharedPtr<Binder>             BinderPtr;
 	typedef Poco::SharedPtr<Extractor>          ExtractorPtr;
@@ -108,6 +115,8 @@ private:
 
 	sqlite3*         _pDB;
 	sqlite3_stmt*    _pStmt;
+	StatementCache*  _pStatementCache;
+	std::string      _cacheKey;
 	bool             _stepCalled;
 	int              _nextResponse;
 	BinderPtr        _pBinder;
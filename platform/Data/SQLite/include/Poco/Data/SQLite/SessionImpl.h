@@ -23,6 +23,7 @@
 #include "Poco/Data/SQLite/SQLite.h"
 #include "Poco/Data/SQLite/Connector.h"
 #include "Poco/Data/SQLite/Binder.h"
+#include "Poco/Data/SQLite/StatementCache.h"
 #include "Poco/Data/AbstractSessionImpl.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/Mutex.h"
@@ -41,6 +42,25 @@ namespace SQLite {
 
 class SQLite_API SessionImpl: public Poco::Data::AbstractSessionImpl<SessionImpl>
 	/// Implements SessionImpl interface.
+	///
+	/// In addition to the common properties, the following
+	/// SQLite-specific properties are supported:
+	///   - statementCacheSize (std::size_t): maximum number of prepared
+	///     statements kept in the session's StatementCache (default 32;
+	///     0 disables the cache).
+	///   - journalMode (std::string): the journal mode ("DELETE", "TRUNCATE",
+	///     "PERSIST", "MEMORY", "WAL" or "OFF"). The getter returns the
+	///     mode in lower case, as reported by SQLite.
+	///   - synchronous (std::string): the synchronous mode ("OFF", "NORMAL",
+	///     "FULL" or "EXTRA").
+	///   - mmapSize (Poco::Int64): the maximum number of bytes of the
+	///     database file accessed using memory-mapped I/O.
+	///   - cacheSize (int): the suggested maximum number of database pages
+	///     kept in memory (negative values specify a size in KiB).
+	///
+	/// For databases written by many short transactions, setting journalMode
+	/// to "WAL" and synchronous to "NORMAL" significantly improves write
+	/// throughput.
 {
 public:
 	SessionImpl(const std::string& fileName,
@@ -117,10 +137,36 @@ public:
 	const std::string& connectorName() const;
 		/// Returns the name of the connector.
 
+	StatementCache& statementCache();
+		/// Returns the session's cache of prepared statements.
+
 protected:
 	void setConnectionTimeout(const std::string& prop, const Poco::Any& value);
 	Poco::Any getConnectionTimeout(const std::string& prop);
 
+	void setStatementCacheSize(const std::string& prop, const Poco::Any& value);
+	Poco::Any getStatementCacheSize(const std::string& prop);
+
+	void setJournalMode(const std::string& prop, const Poco::Any& value);
+	Poco::Any getJournalMode(const std::string& prop);
+
+	void setSynchronous(const std::string& prop, const Poco::Any& value);
+	Poco::Any getSynchronous(const std::string& prop);
+
+	void setMMapSize(const std::string& prop, const Poco::Any& value);
+	Poco::Any getMMapSize(const std::string& prop);
+
+	void setCacheSize(const std::string& prop, const Poco::Any& value);
+	Poco::Any getCacheSize(const std::string& prop);
+
+	std::string pragma(const std::string& name, const std::string& value = "");
+		/// Executes a PRAGMA statement (setting the pragma to the given
+		/// value, if not empty) and returns the first column of the
+		/// first result row, or an empty string if there is no result.
+
+	static Poco::Int64 intValue(const Poco::Any& value);
+		/// Converts an integer property value to Poco::Int64.
+
 private:
 	std::string _connector;
 	sqlite3*    _pDB;
@@ -128,6 +174,7 @@ private:
 	bool        _isTransaction;
 	int         _timeout;
 	Poco::Mutex _mutex;
+	StatementCache _statementCache;
 
 	static const std::string DEFERRED_BEGIN_TRANSACTION;
 	static const std::string COMMIT_TRANSACTION;
@@ -156,6 +203,12 @@ inline const std::string& SessionImpl::connectorName() const
 }
 
 
+inline StatementCache& SessionImpl::statementCache()
+{
+	return _statementCache;
+}
+
+
 inline std::size_t SessionImpl::getConnectionTimeout()
 {
 	return static_cast<std::size_t>(_timeout);
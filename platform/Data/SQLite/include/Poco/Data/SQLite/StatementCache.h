@@ -0,0 +1,108 @@
+//
+// StatementCache.h
+//
+// $Id$
+//
+// Library: SQLite
+// Package: SQLite
+// Module:  StatementCache
+//
+// Definition of the StatementCache class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef SQLite_StatementCache_INCLUDED
+#define SQLite_StatementCache_INCLUDED
+
+
+#include "Poco/Data/SQLite/SQLite.h"
+#include "Poco/Mutex.h"
+#include <list>
+#include <map>
+
+
+extern "C"
+{
+	typedef struct sqlite3_stmt sqlite3_stmt;
+}
+
+
+namespace Poco {
+namespace Data {
+namespace SQLite {
+
+
+class SQLite_API StatementCache
+	/// A least-recently-used cache of prepared SQLite statement
+	/// handles, keyed by SQL text.
+	///
+	/// A SQLiteStatementImpl takes a handle out of the cache when
+	/// compiling a statement and puts it back (reset, and with all
+	/// bindings cleared) when it no longer needs it, instead of
+	/// finalizing it. Therefore, a handle is never used by more
+	/// than one statement at a time.
+	///
+	/// Every SessionImpl has its own StatementCache.
+{
+public:
+	enum
+	{
+		DEFAULT_CAPACITY = 32
+	};
+
+	explicit StatementCache(std::size_t capacity = DEFAULT_CAPACITY);
+		/// Creates the StatementCache with the given capacity.
+
+	~StatementCache();
+		/// Destroys the StatementCache and finalizes all cached handles.
+
+	sqlite3_stmt* take(const std::string& sql);
+		/// Removes the handle for the given SQL text from the cache
+		/// and returns it, or returns null if no handle is cached.
+
+	void put(const std::string& sql, sqlite3_stmt* pStmt);
+		/// Resets the given handle and adds it to the cache.
+		///
+		/// If a handle for the same SQL text is already cached,
+		/// or the capacity is 0, the given handle is finalized.
+		/// If the cache is full, the least recently used handle
+		/// is finalized.
+
+	void clear();
+		/// Finalizes all cached handles.
+
+	void setCapacity(std::size_t capacity);
+		/// Sets the maximum number of cached handles.
+		/// Setting the capacity to 0 disables the cache.
+
+	std::size_t getCapacity() const;
+		/// Returns the maximum number of cached handles.
+
+	std::size_t size() const;
+		/// Returns the number of cached handles.
+
+private:
+	StatementCache(const StatementCache&);
+	StatementCache& operator = (const StatementCache&);
+
+	typedef std::list<std::pair<std::string, sqlite3_stmt*> > LRUList;
+	typedef std::map<std::string, LRUList::iterator> Index;
+
+	void evict(std::size_t size);
+
+	std::size_t _capacity;
+	LRUList _lru;
+	Index _index;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+} } } // namespace Poco::Data::SQLite
+
+
+#endif // SQLite_StatementCache_INCLUDED
@@ -17,6 +17,7 @@
 #include "Poco/Data/SQLite/SQLiteStatementImpl.h"
 #include "Poco/Data/SQLite/Utility.h"
 #include "Poco/Data/SQLite/SQLiteException.h"
+#include "Poco/Data/SQLite/SessionImpl.h"
 #include "Poco/String.h"
 #include <cstdlib>
 #include <cstring>
@@ -39,6 +40,7 @@ SQLiteStatementImpl::SQLiteStatementImpl(Poco::Data::SessionImpl& rSession, sqli
 	StatementImpl(rSession),
 	_pDB(pDB),
 	_pStmt(0),
+	_pStatementCache(0),
 	_stepCalled(false),
 	_nextResponse(0),
 	_affectedRowCount(POCO_SQLITE_INV_ROW_CNT),
@@ -47,6 +49,8 @@ SQLiteStatementImpl::SQLiteStatementImpl(Poco::Data::SessionImpl& rSession, sqli
 	_canCompile(true)
 {
 	_columns.resize(1);
+	SessionImpl* pSQLiteSession = dynamic_cast<SessionImpl*>(&rSession);
+	if (pSQLiteSession) _pStatementCache = &pSQLiteSession->statementCache();
 }
 	
 
@@ -78,41 +82,54 @@ void SQLiteStatementImpl::compileImpl()
 	if (0 == std::strlen(pSql))
 		throw InvalidSQLStatementException("Empty statements are illegal");
 
-	int rc = SQLITE_OK;
-	const char* pLeftover = 0;
-	bool queryFound = false;
+	bool cacheable = _pStatementCache && !_pLeftover;
+	if (cacheable)
+	{
+		// Release the current handle first, so that re-executing
+		// a statement gets back the handle it has just used.
+		clear();
+		pStmt = _pStatementCache->take(statement);
+	}
 
-	do
+	std::string leftOver;
+	if (!pStmt)
 	{
-		rc = sqlite3_prepare_v2(_pDB, pSql, -1, &pStmt, &pLeftover);
-		if (rc != SQLITE_OK)
-		{
-			if (pStmt) sqlite3_finalize(pStmt);
-			pStmt = 0;
-			std::string errMsg = sqlite3_errmsg(_pDB);
-			Utility::throwException(rc, errMsg);
-		}
-		else if (rc == SQLITE_OK && pStmt)
-		{
-			queryFound = true;
-		}
-		else if (rc == SQLITE_OK && !pStmt) // comment/whitespace ignore
+		int rc = SQLITE_OK;
+		const char* pLeftover = 0;
+		bool queryFound = false;
+
+		do
 		{
-			pSql = pLeftover;
-			if (std::strlen(pSql) == 0)
+			rc = sqlite3_prepare_v2(_pDB, pSql, -1, &pStmt, &pLeftover);
+			if (rc != SQLITE_OK)
+			{
+				if (pStmt) sqlite3_finalize(pStmt);
+				pStmt = 0;
+				std::string errMsg = sqlite3_errmsg(_pDB);
+				Utility::throwException(rc, errMsg);
+			}
+			else if (rc == SQLITE_OK && pStmt)
 			{
-				// empty statement or an conditional statement! like CREATE IF NOT EXISTS
-				// this is valid
 				queryFound = true;
 			}
-		}
-	} while (rc == SQLITE_OK && !pStmt && !queryFound);
+			else if (rc == SQLITE_OK && !pStmt) // comment/whitespace ignore
+			{
+				pSql = pLeftover;
+				if (std::strlen(pSql) == 0)
+				{
+					// empty statement or an conditional statement! like CREATE IF NOT EXISTS
+					// this is valid
+					queryFound = true;
+				}
+			}
+		} while (rc == SQLITE_OK && !pStmt && !queryFound);
 
-	//Finalization call in clear() invalidates the pointer, so the value is remembered here.
-	//For last statement in a batch (or a single statement), pLeftover == "", so the next call
-	// to compileImpl() shall return false immediately when there are no more statements left.
-	std::string leftOver(pLeftover);
-	trimInPlace(leftOver);
+		//Finalization call in clear() invalidates the pointer, so the value is remembered here.
+		//For last statement in a batch (or a single statement), pLeftover == "", so the next call
+		// to compileImpl() shall return false immediately when there are no more statements left.
+		leftOver = pLeftover;
+		trimInPlace(leftOver);
+	}
 	clear();
 	_pStmt = pStmt;
 	if (!leftOver.empty())
@@ -120,7 +137,11 @@ void SQLiteStatementImpl::compileImpl()
 		_pLeftover = new std::string(leftOver);
 		_canCompile = true;
 	}
-	else _canCompile = false;
+	else
+	{
+		_canCompile = false;
+		if (cacheable && _pStmt) _cacheKey = statement;
+	}
 
 	_pBinder = new Binder(_pStmt);
 	_pExtractor = new Extractor(_pStmt);
@@ -219,9 +240,13 @@ void SQLiteStatementImpl::clear()
 
 	if (_pStmt)
 	{
-		sqlite3_finalize(_pStmt);
-		_pStmt=0;
+		if (!_cacheKey.empty() && session().isConnected())
+			_pStatementCache->put(_cacheKey, _pStmt);
+		else
+			sqlite3_finalize(_pStmt);
+		_pStmt = 0;
 	}
+	_cacheKey.clear();
 	_pLeftover = 0;
 }
 
@@ -23,6 +23,8 @@
 #include "Poco/ActiveResult.h"
 #include "Poco/String.h"
 #include "Poco/Mutex.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
 #include "Poco/Data/DataException.h"
 #if defined(POCO_UNBUNDLED)
 #include <sqlite3.h>
@@ -61,6 +63,11 @@ SessionImpl::SessionImpl(const std::string& fileName, std::size_t loginTimeout):
 		&SessionImpl::autoCommit, 
 		&SessionImpl::isAutoCommit);
 	addProperty("connectionTimeout", &SessionImpl::setConnectionTimeout, &SessionImpl::getConnectionTimeout);
+	addProperty("statementCacheSize", &SessionImpl::setStatementCacheSize, &SessionImpl::getStatementCacheSize);
+	addProperty("journalMode", &SessionImpl::setJournalMode, &SessionImpl::getJournalMode);
+	addProperty("synchronous", &SessionImpl::setSynchronous, &SessionImpl::getSynchronous);
+	addProperty("mmapSize", &SessionImpl::setMMapSize, &SessionImpl::getMMapSize);
+	addProperty("cacheSize", &SessionImpl::setCacheSize, &SessionImpl::getCacheSize);
 }
 
 
@@ -205,6 +212,7 @@ void SessionImpl::open(const std::string& connect)
 
 void SessionImpl::close()
 {
+	_statementCache.clear();
 	if (_pDB)
 	{
 		sqlite3_close(_pDB);
@@ -242,6 +250,141 @@ Poco::Any SessionImpl::getConnectionTimeout(const std::string& prop)
 }
 
 
+void SessionImpl::setStatementCacheSize(const std::string& prop, const Poco::Any& value)
+{
+	_statementCache.setCapacity(static_cast<std::size_t>(intValue(value)));
+}
+
+
+Poco::Any SessionImpl::getStatementCacheSize(const std::string& prop)
+{
+	return Poco::Any(_statementCache.getCapacity());
+}
+
+
+void SessionImpl::setJournalMode(const std::string& prop, const Poco::Any& value)
+{
+	std::string mode = Poco::toUpper(Poco::RefAnyCast<std::string>(value));
+	if (mode != "DELETE" && mode != "TRUNCATE" && mode != "PERSIST" && mode != "MEMORY" && mode != "WAL" && mode != "OFF")
+		throw Poco::InvalidArgumentException("journalMode", mode);
+	pragma("journal_mode", mode);
+}
+
+
+Poco::Any SessionImpl::getJournalMode(const std::string& prop)
+{
+	return Poco::Any(pragma("journal_mode"));
+}
+
+
+void SessionImpl::setSynchronous(const std::string& prop, const Poco::Any& value)
+{
+	std::string mode = Poco::toUpper(Poco::RefAnyCast<std::string>(value));
+	if (mode != "OFF" && mode != "NORMAL" && mode != "FULL" && mode != "EXTRA")
+		throw Poco::InvalidArgumentException("synchronous", mode);
+	pragma("synchronous", mode);
+}
+
+
+Poco::Any SessionImpl::getSynchronous(const std::string& prop)
+{
+	static const std::string MODES[] = {"OFF", "NORMAL", "FULL", "EXTRA"};
+
+	int mode = Poco::NumberParser::parse(pragma("synchronous"));
+	if (mode < 0 || mode > 3) throw Poco::Data::DataException("Unknown synchronous mode");
+	return Poco::Any(MODES[mode]);
+}
+
+
+void SessionImpl::setMMapSize(const std::string& prop, const Poco::Any& value)
+{
+	pragma("mmap_size", Poco::NumberFormatter::format(intValue(value)));
+}
+
+
+Poco::Any SessionImpl::getMMapSize(const std::string& prop)
+{
+	std::string size = pragma("mmap_size");
+	// mmap_size returns no result if memory-mapped I/O is not supported
+	return Poco::Any(size.empty() ? Poco::Int64(0) : Poco::NumberParser::parse64(size));
+}
+
+
+void SessionImpl::setCacheSize(const std::string& prop, const Poco::Any& value)
+{
+	pragma("cache_size", Poco::NumberFormatter::format(intValue(value)));
+}
+
+
+Poco::Any SessionImpl::getCacheSize(const std::string& prop)
+{
+	return Poco::Any(Poco::NumberParser::parse(pragma("cache_size")));
+}
+
+
+namespace
+{
+	int pragmaCallback(void* pResult, int nCols, char** values, char**)
+	{
+		std::string* pStr = reinterpret_cast<std::string*>(pResult);
+		if (pStr->empty() && nCols > 0 && values[0])
+			pStr->assign(values[0]);
+		return 0;
+	}
+}
+
+
+std::string SessionImpl::pragma(const std::string& name, const std::string& value)
+{
+	Poco::Mutex::ScopedLock l(_mutex);
+
+	if (!_pDB) throw NotConnectedException(connectionString());
+
+	std::string sql("PRAGMA ");
+	sql += name;
+	if (!value.empty())
+	{
+		sql += " = ";
+		sql += value;
+	}
+	std::string result;
+	char* pErrMsg = 0;
+	int rc = sqlite3_exec(_pDB, sql.c_str(), pragmaCallback, &result, &pErrMsg);
+	if (rc != SQLITE_OK)
+	{
+		std::string errMsg;
+		if (pErrMsg)
+		{
+			errMsg = pErrMsg;
+			sqlite3_free(pErrMsg);
+		}
+		Utility::throwException(rc, errMsg);
+	}
+	return result;
+}
+
+
+Poco::Int64 SessionImpl::intValue(const Poco::Any& value)
+{
+	if (value.type() == typeid(int))
+		return Poco::AnyCast<int>(value);
+	else if (value.type() == typeid(unsigned))
+		return Poco::AnyCast<unsigned>(value);
+	else if (value.type() == typeid(long))
+		return Poco::AnyCast<long>(value);
+	else if (value.type() == typeid(unsigned long))
+		return static_cast<Poco::Int64>(Poco::AnyCast<unsigned long>(value));
+	else if (value.type() == typeid(Poco::Int64))
+		return Poco::AnyCast<Poco::Int64>(value);
+	else if (value.type() == typeid(Poco::UInt64))
+		return static_cast<Poco::Int64>(Poco::AnyCast<Poco::UInt64>(value));
+	else if (value.type() == typeid(std::string))
+		return Poco::NumberParser::parse64(Poco::RefAnyCast<std::string>(value));
+	else
+		throw Poco::InvalidArgumentException("Integer property value expected");
+}
+
+
 void SessionImpl::autoCommit(const std::string&, bool)
 {
 	// The problem here is to decide whether to call commit or rollback
@@ -0,0 +1,129 @@
+//
+// StatementCache.cpp
+//
+// $Id$
+//
+// Library: SQLite
+// Package: SQLite
+// Module:  StatementCache
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Data/SQLite/StatementCache.h"
+#if defined(POCO_UNBUNDLED)
+#include <sqlite3.h>
+#else
+#include "sqlite3.h"
+#endif
+
+
+namespace Poco {
+namespace Data {
+namespace SQLite {
+
+
+StatementCache::StatementCache(std::size_t capacity):
+	_capacity(capacity)
+{
+}
+
+
+StatementCache::~StatementCache()
+{
+	try
+	{
+		clear();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+sqlite3_stmt* StatementCache::take(const std::string& sql)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Index::iterator it = _index.find(sql);
+	if (it != _index.end())
+	{
+		sqlite3_stmt* pStmt = it->second->second;
+		_lru.erase(it->second);
+		_index.erase(it);
+		return pStmt;
+	}
+	return 0;
+}
+
+
+void StatementCache::put(const std::string& sql, sqlite3_stmt* pStmt)
+{
+	poco_check_ptr (pStmt);
+
+	sqlite3_reset(pStmt);
+	sqlite3_clear_bindings(pStmt);
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_capacity == 0 || _index.find(sql) != _index.end())
+	{
+		sqlite3_finalize(pStmt);
+		return;
+	}
+	evict(_capacity - 1);
+	_lru.push_front(LRUList::value_type(sql, pStmt));
+	_index[sql] = _lru.begin();
+}
+
+
+void StatementCache::clear()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	evict(0);
+}
+
+
+void StatementCache::setCapacity(std::size_t capacity)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_capacity = capacity;
+	evict(_capacity);
+}
+
+
+std::size_t StatementCache::getCapacity() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _capacity;
+}
+
+
+std::size_t StatementCache::size() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _lru.size();
+}
+
+
+void StatementCache::evict(std::size_t size)
+{
+	while (_lru.size() > size)
+	{
+		sqlite3_finalize(_lru.back().second);
+		_index.erase(_lru.back().first);
+		_lru.pop_back();
+	}
+}
+
+
+} } } // namespace Poco::Data::SQLite
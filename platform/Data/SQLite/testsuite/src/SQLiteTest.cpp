@@ -23,6 +23,7 @@
 #include "Poco/Data/SQLite/Connector.h"
 #include "Poco/Data/SQLite/Utility.h"
 #include "Poco/Data/SQLite/Notifier.h"
+#include "Poco/Data/SQLite/SessionImpl.h"
 #include "Poco/Data/SQLite/Connector.h"
 #include "Poco/Dynamic/Var.h"
 #include "Poco/Data/TypeHandler.h"
@@ -3359,6 +3360,116 @@ void SQLiteTest::testFTS3()
 }
 
 
+void SQLiteTest::testStatementCache()
+{
+	Session tmp(Poco::Data::SQLite::Connector::KEY, "dummy.db");
+	assert(tmp.isConnected());
+	Poco::Data::SQLite::SessionImpl* pImpl = dynamic_cast<Poco::Data::SQLite::SessionImpl*>(tmp.impl());
+	assert(pImpl != 0);
+	Poco::Data::SQLite::StatementCache& cache = pImpl->statementCache();
+
+	tmp << "DROP TABLE IF EXISTS Numbers", now;
+	tmp << "CREATE TABLE Numbers (n INTEGER, s VARCHAR(10))", now;
+	cache.clear();
+	assert(cache.size() == 0);
+
+	for (int i = 0; i < 100; i++)
+	{
+		std::string s(format("%d", i));
+		tmp << "INSERT INTO Numbers VALUES (?, ?)", use(i), use(s), now;
+		assert(cache.size() == 1);
+	}
+
+	int count = 0;
+	tmp << "SELECT COUNT(*) FROM Numbers", into(count), now;
+	assert(count == 100);
+	assert(cache.size() == 2);
+
+	// a cached handle must not retain bindings or results of previous executions
+	std::string s;
+	for (int i = 0; i < 100; i += 10)
+	{
+		tmp << "SELECT s FROM Numbers WHERE n = ?", use(i), into(s), now;
+		assert(s == format("%d", i));
+	}
+	assert(cache.size() == 3);
+
+	// a statement being executed repeatedly keeps its handle
+	int n = 0;
+	Statement stmt = (tmp << "SELECT n FROM Numbers WHERE n = ?", use(n), into(count));
+	for (n = 0; n < 10; n++)
+	{
+		stmt.execute();
+		assert(count == n);
+	}
+
+	// batches of statements are not cached
+	tmp << "DELETE FROM Numbers WHERE n < 50; DELETE FROM Numbers WHERE n >= 90;", now;
+	tmp << "SELECT COUNT(*) FROM Numbers", into(count), now;
+	assert(count == 40);
+	assert(cache.size() == 3);
+
+	// schema changes invalidate cached handles, which are re-prepared by SQLite
+	tmp << "ALTER TABLE Numbers ADD COLUMN d REAL", now;
+	tmp << "SELECT COUNT(*) FROM Numbers", into(count), now;
+	assert(count == 40);
+
+	tmp.setProperty("statementCacheSize", std::size_t(1));
+	assert(AnyCast<std::size_t>(tmp.getProperty("statementCacheSize")) == 1);
+	assert(cache.size() <= 1);
+
+	tmp.setProperty("statementCacheSize", std::size_t(0));
+	tmp << "SELECT COUNT(*) FROM Numbers", into(count), now;
+	assert(cache.size() == 0);
+
+	tmp.close();
+	assert(!tmp.isConnected());
+}
+
+
+void SQLiteTest::testPragmaProperties()
+{
+	Session tmp(Poco::Data::SQLite::Connector::KEY, "dummy.db");
+	assert(tmp.isConnected());
+
+	tmp.setProperty("journalMode", std::string("WAL"));
+	assert(AnyCast<std::string>(tmp.getProperty("journalMode")) == "wal");
+
+	tmp.setProperty("synchronous", std::string("normal"));
+	assert(AnyCast<std::string>(tmp.getProperty("synchronous")) == "NORMAL");
+
+	tmp.setProperty("cacheSize", -4096);
+	assert(AnyCast<int>(tmp.getProperty("cacheSize")) == -4096);
+
+	tmp.setProperty("mmapSize", Poco::Int64(0));
+	assert(AnyCast<Poco::Int64>(tmp.getProperty("mmapSize")) == 0);
+
+	try
+	{
+		tmp.setProperty("synchronous", std::string("SOMETIMES"));
+		fail("must fail");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	tmp << "DROP TABLE IF EXISTS Numbers", now;
+	tmp << "CREATE TABLE Numbers (n INTEGER)", now;
+	tmp.begin();
+	for (int i = 0; i < 100; i++)
+	{
+		tmp << "INSERT INTO Numbers VALUES (?)", use(i), now;
+	}
+	tmp.commit();
+	int count = 0;
+	tmp << "SELECT COUNT(*) FROM Numbers", into(count), now;
+	assert(count == 100);
+
+	tmp.setProperty("journalMode", std::string("DELETE"));
+	assert(AnyCast<std::string>(tmp.getProperty("journalMode")) == "delete");
+}
+
+
 void SQLiteTest::setUp()
 {
 }
@@ -3459,6 +3570,8 @@ CppUnit::Test* SQLiteTest::suite()
 	CppUnit_addTest(pSuite, SQLiteTest, testTransaction);
 	CppUnit_addTest(pSuite, SQLiteTest, testTransactor);
 	CppUnit_addTest(pSuite, SQLiteTest, testFTS3);
+	CppUnit_addTest(pSuite, SQLiteTest, testStatementCache);
+	CppUnit_addTest(pSuite, SQLiteTest, testPragmaProperties);
 
 	return pSuite;
 }
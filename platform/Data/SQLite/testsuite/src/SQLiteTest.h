@@ -135,6 +135,9 @@ public:
 
 	void testFTS3();
 
+	void testStatementCache();
+	void testPragmaProperties();
+
 	void setUp();
 	void tearDown();
 
@@ -0,0 +1,204 @@
+//
+// AsyncFileChannel.h
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Logging
+// Module:  AsyncFileChannel
+//
+// Definition of the AsyncFileChannel class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_AsyncFileChannel_INCLUDED
+#define Foundation_AsyncFileChannel_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Channel.h"
+#include "Poco/Message.h"
+#include "Poco/Formatter.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+class Foundation_API AsyncFileChannel: public Channel, public Runnable
+	/// A high-throughput channel that writes log messages to a file
+	/// using a separate writer thread.
+	///
+	/// Unlike AsyncChannel, which allocates a Notification for every
+	/// message and places it in an unbounded NotificationQueue,
+	/// AsyncFileChannel stores messages in a fixed-size ring buffer
+	/// that is allocated once when the channel is opened. The writer
+	/// thread removes messages from the ring buffer in batches,
+	/// formats them (if a Formatter has been set), and writes
+	/// each batch to the log file with a single writev() call
+	/// (on platforms supporting it).
+	///
+	/// Formatting is done by the writer thread, not the thread
+	/// logging the message. Therefore, a Formatter should be attached
+	/// to the channel directly (using setFormatter() or the "format"
+	/// property), rather than by chaining a FormattingChannel in front of it.
+	///
+	/// If the ring buffer is full, the behavior depends on the
+	/// overflow policy, which can be set with the "policy" property:
+	///
+	///   * drop:  The message is discarded and the dropped counter
+	///            is incremented (default).
+	///   * block: The logging thread is blocked until the writer
+	///            thread has made room in the ring buffer.
+	///
+	/// The following properties are supported:
+	///
+	///   * path:      The log file's path.
+	///   * format:    A pattern for a PatternFormatter used to format
+	///                messages on the writer thread. If not set,
+	///                only the message text is written.
+	///   * capacity:  The number of messages the ring buffer can hold
+	///                (default 4096). Can only be changed while the
+	///                channel is closed.
+	///   * batchSize: The maximum number of messages written with a
+	///                single system call (default 256).
+	///   * policy:    The overflow policy ("drop" or "block").
+	///   * flush:     If "true", the file is synced to disk after every batch.
+	///                Defaults to "false", as messages are not buffered
+	///                in user space anyway.
+	///   * priority:  The writer thread's priority (lowest, low, normal,
+	///                high, highest). Set-only.
+	///
+	/// No log file rotation is done by this channel. If rotation,
+	/// archiving and purging of log files is required, use FileChannel.
+{
+public:
+	enum OverflowPolicy
+	{
+		POLICY_DROP,  /// Discard messages if the ring buffer is full.
+		POLICY_BLOCK  /// Block the logging thread if the ring buffer is full.
+	};
+
+	AsyncFileChannel();
+		/// Creates the AsyncFileChannel.
+
+	AsyncFileChannel(const std::string& path);
+		/// Creates the AsyncFileChannel for a file with the given path.
+
+	void open();
+		/// Opens the log file, allocates the ring buffer and
+		/// starts the writer thread.
+
+	void close();
+		/// Writes all pending messages, stops the writer thread
+		/// and closes the log file.
+
+	void log(const Message& msg);
+		/// Places a copy of the message in the ring buffer.
+		///
+		/// If the ring buffer is full, the message is either
+		/// dropped or the calling thread is blocked, depending
+		/// on the overflow policy.
+
+	void setFormatter(Formatter* pFormatter);
+		/// Sets the Formatter used by the writer thread to
+		/// format messages. If null, only the message text
+		/// is written.
+
+	Formatter* getFormatter() const;
+		/// Returns the Formatter, which may be null.
+
+	void setProperty(const std::string& name, const std::string& value);
+		/// Sets the property with the given name. See the
+		/// class documentation for a list of supported properties.
+
+	std::string getProperty(const std::string& name) const;
+		/// Returns the value of the property with the given name.
+
+	UInt64 queued() const;
+		/// Returns the total number of messages that have been
+		/// placed in the ring buffer.
+
+	UInt64 dropped() const;
+		/// Returns the total number of messages that have been
+		/// dropped, either due to the ring buffer being full,
+		/// or because writing them to the log file failed.
+
+	UInt64 flushed() const;
+		/// Returns the total number of messages that have been
+		/// written to the log file.
+
+	std::size_t pending() const;
+		/// Returns the number of messages currently in the ring buffer.
+
+	const std::string& path() const;
+		/// Returns the log file's path.
+
+	static const std::string PROP_PATH;
+	static const std::string PROP_FORMAT;
+	static const std::string PROP_CAPACITY;
+	static const std::string PROP_BATCHSIZE;
+	static const std::string PROP_POLICY;
+	static const std::string PROP_FLUSH;
+	static const std::string PROP_PRIORITY;
+
+protected:
+	~AsyncFileChannel();
+	void run();
+	void openImpl();
+	void openFile();
+	void closeFile();
+	void writeBatch(std::size_t count);
+	void writeFailed(std::size_t count);
+	void writeBuffers(std::size_t count);
+	void syncFile();
+	void setPriority(const std::string& value);
+
+private:
+	std::string _path;
+	Formatter* _pFormatter;
+	std::size_t _capacity;
+	std::size_t _batchSize;
+	OverflowPolicy _policy;
+	bool _flush;
+
+	std::vector<Message> _ring;
+	std::size_t _head;
+	std::size_t _count;
+	bool _open;
+	bool _stop;
+
+	std::vector<Message> _batch;
+	std::vector<std::string> _texts;
+
+	UInt64 _queued;
+	UInt64 _dropped;
+	UInt64 _flushed;
+
+#if defined(POCO_OS_FAMILY_UNIX)
+	int _fd;
+#else
+	std::ostream* _pStream;
+#endif
+
+	Thread _thread;
+	mutable FastMutex _mutex;
+	Condition _notEmpty;
+	Condition _notFull;
+};
+
+
+} // namespace Poco
+
+
+#endif // Foundation_AsyncFileChannel_INCLUDED
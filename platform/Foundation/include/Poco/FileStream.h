@@ -50,6 +50,8 @@ class Foundation_API FileIOS: public virtual std::ios
 	/// UTF-8 encoded Unicode paths are correctly handled.
 {
 public:
+	typedef FileStreamBuf::NativeHandle NativeHandle;
+
 	FileIOS(std::ios::openmode defaultMode);
 		/// Creates the basic stream.
 		
@@ -73,6 +75,15 @@ public:
 	FileStreamBuf* rdbuf();
 		/// Returns a pointer to the underlying streambuf.
 
+	NativeHandle nativeHandle() const;
+		/// Returns the native file handle (a file descriptor on
+		/// POSIX platforms, a HANDLE on Windows) of the open file.
+		///
+		/// The handle can be used to pass the file to system calls
+		/// not supported by the stream, e.g. sendfile(). Note that
+		/// the stream is buffered, so the file position of the
+		/// handle may differ from the stream position.
+
 protected:
 	FileStreamBuf _buf;
 	std::ios::openmode _defaultMode;
@@ -0,0 +1,531 @@
+//
+// AsyncFileChannel.cpp
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Logging
+// Module:  AsyncFileChannel
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/AsyncFileChannel.h"
+#include "Poco/PatternFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/String.h"
+#include "Poco/Exception.h"
+#include "Poco/ErrorHandler.h"
+#if defined(POCO_OS_FAMILY_UNIX)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+#else
+#include "Poco/FileStream.h"
+#endif
+
+
+namespace Poco {
+
+
+const std::string AsyncFileChannel::PROP_PATH      = "path";
+const std::string AsyncFileChannel::PROP_FORMAT    = "format";
+const std::string AsyncFileChannel::PROP_CAPACITY  = "capacity";
+const std::string AsyncFileChannel::PROP_BATCHSIZE = "batchSize";
+const std::string AsyncFileChannel::PROP_POLICY    = "policy";
+const std::string AsyncFileChannel::PROP_FLUSH     = "flush";
+const std::string AsyncFileChannel::PROP_PRIORITY  = "priority";
+
+
+namespace
+{
+	const std::size_t DEFAULT_CAPACITY   = 4096;
+	const std::size_t DEFAULT_BATCH_SIZE = 256;
+#if defined(POCO_OS_FAMILY_UNIX)
+#if defined(IOV_MAX)
+	const std::size_t MAX_BATCH_SIZE = IOV_MAX/2;
+#else
+	const std::size_t MAX_BATCH_SIZE = 512;
+#endif
+#else
+	const std::size_t MAX_BATCH_SIZE = 4096;
+#endif
+}
+
+
+AsyncFileChannel::AsyncFileChannel():
+	_pFormatter(0),
+	_capacity(DEFAULT_CAPACITY),
+	_batchSize(DEFAULT_BATCH_SIZE),
+	_policy(POLICY_DROP),
+	_flush(false),
+	_head(0),
+	_count(0),
+	_open(false),
+	_stop(false),
+	_queued(0),
+	_dropped(0),
+	_flushed(0),
+#if defined(POCO_OS_FAMILY_UNIX)
+	_fd(-1),
+#else
+	_pStream(0),
+#endif
+	_thread("AsyncFileChannel")
+{
+}
+
+
+AsyncFileChannel::AsyncFileChannel(const std::string& path):
+	_path(path),
+	_pFormatter(0),
+	_capacity(DEFAULT_CAPACITY),
+	_batchSize(DEFAULT_BATCH_SIZE),
+	_policy(POLICY_DROP),
+	_flush(false),
+	_head(0),
+	_count(0),
+	_open(false),
+	_stop(false),
+	_queued(0),
+	_dropped(0),
+	_flushed(0),
+#if defined(POCO_OS_FAMILY_UNIX)
+	_fd(-1),
+#else
+	_pStream(0),
+#endif
+	_thread("AsyncFileChannel")
+{
+}
+
+
+AsyncFileChannel::~AsyncFileChannel()
+{
+	try
+	{
+		close();
+		if (_pFormatter) _pFormatter->release();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void AsyncFileChannel::open()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	openImpl();
+}
+
+
+void AsyncFileChannel::close()
+{
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		if (!_open || _stop) return;
+		_stop = true;
+		_notEmpty.signal();
+		_notFull.broadcast();
+	}
+	_thread.join();
+
+	FastMutex::ScopedLock lock(_mutex);
+	closeFile();
+	_open = false;
+	_stop = false;
+}
+
+
+void AsyncFileChannel::log(const Message& msg)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (!_open && !_stop) openImpl();
+
+	while (_count == _capacity && !_stop)
+	{
+		if (_policy == POLICY_DROP)
+		{
+			++_dropped;
+			return;
+		}
+		_notFull.wait(_mutex);
+	}
+	if (_stop || !_open)
+	{
+		++_dropped;
+		return;
+	}
+	_ring[(_head + _count) % _capacity] = msg;
+	++_queued;
+	if (++_count == 1) _notEmpty.signal();
+}
+
+
+void AsyncFileChannel::setFormatter(Formatter* pFormatter)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (_pFormatter) _pFormatter->release();
+	_pFormatter = pFormatter;
+	if (_pFormatter) _pFormatter->duplicate();
+}
+
+
+Formatter* AsyncFileChannel::getFormatter() const
+{
+	return _pFormatter;
+}
+
+
+void AsyncFileChannel::setProperty(const std::string& name, const std::string& value)
+{
+	if (name == PROP_PATH)
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		if (_open) throw IllegalStateException("Cannot change path of open AsyncFileChannel");
+		_path = value;
+	}
+	else if (name == PROP_FORMAT)
+	{
+		AutoPtr<Formatter> pFormatter = new PatternFormatter(value);
+		setFormatter(pFormatter);
+	}
+	else if (name == PROP_CAPACITY)
+	{
+		std::size_t capacity = NumberParser::parseUnsigned(value);
+		if (capacity == 0) throw InvalidArgumentException("AsyncFileChannel capacity must be greater than zero");
+		FastMutex::ScopedLock lock(_mutex);
+		if (_open) throw IllegalStateException("Cannot change capacity of open AsyncFileChannel");
+		_capacity = capacity;
+	}
+	else if (name == PROP_BATCHSIZE)
+	{
+		std::size_t batchSize = NumberParser::parseUnsigned(value);
+		if (batchSize == 0) throw InvalidArgumentException("AsyncFileChannel batch size must be greater than zero");
+		if (batchSize > MAX_BATCH_SIZE) batchSize = MAX_BATCH_SIZE;
+		FastMutex::ScopedLock lock(_mutex);
+		if (_open) throw IllegalStateException("Cannot change batch size of open AsyncFileChannel");
+		_batchSize = batchSize;
+	}
+	else if (name == PROP_POLICY)
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		if (icompare(value, "drop") == 0)
+			_policy = POLICY_DROP;
+		else if (icompare(value, "block") == 0)
+			_policy = POLICY_BLOCK;
+		else
+			throw InvalidArgumentException("AsyncFileChannel overflow policy", value);
+		_notFull.broadcast();
+	}
+	else if (name == PROP_FLUSH)
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		_flush = icompare(value, "true") == 0;
+	}
+	else if (name == PROP_PRIORITY)
+	{
+		setPriority(value);
+	}
+	else Channel::setProperty(name, value);
+}
+
+
+std::string AsyncFileChannel::getProperty(const std::string& name) const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (name == PROP_PATH)
+		return _path;
+	else if (name == PROP_CAPACITY)
+		return NumberFormatter::format(_capacity);
+	else if (name == PROP_BATCHSIZE)
+		return NumberFormatter::format(_batchSize);
+	else if (name == PROP_POLICY)
+		return _policy == POLICY_DROP ? "drop" : "block";
+	else if (name == PROP_FLUSH)
+		return _flush ? "true" : "false";
+	else
+		return Channel::getProperty(name);
+}
+
+
+UInt64 AsyncFileChannel::queued() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _queued;
+}
+
+
+UInt64 AsyncFileChannel::dropped() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _dropped;
+}
+
+
+UInt64 AsyncFileChannel::flushed() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _flushed;
+}
+
+
+std::size_t AsyncFileChannel::pending() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	return _count;
+}
+
+
+const std::string& AsyncFileChannel::path() const
+{
+	return _path;
+}
+
+
+void AsyncFileChannel::openImpl()
+{
+	if (!_open)
+	{
+		openFile();
+		_ring.clear();
+		_ring.resize(_capacity);
+		_batch.resize(_batchSize);
+		_texts.resize(_batchSize);
+		_head  = 0;
+		_count = 0;
+		_stop  = false;
+		_thread.start(*this);
+		_open = true;
+	}
+}
+
+
+void AsyncFileChannel::run()
+{
+	for (;;)
+	{
+		std::size_t n = 0;
+		{
+			FastMutex::ScopedLock lock(_mutex);
+
+			while (_count == 0 && !_stop) _notEmpty.wait(_mutex);
+			if (_count == 0) break;
+
+			n = _count < _batch.size() ? _count : _batch.size();
+			for (std::size_t i = 0; i < n; i++)
+			{
+				_ring[_head].swap(_batch[i]);
+				_head = (_head + 1) % _capacity;
+			}
+			_count -= n;
+			_notFull.broadcast();
+		}
+		try
+		{
+			writeBatch(n);
+		}
+		catch (Exception& exc)
+		{
+			writeFailed(n);
+			ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			writeFailed(n);
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			writeFailed(n);
+			ErrorHandler::handle();
+		}
+	}
+}
+
+
+void AsyncFileChannel::writeFailed(std::size_t count)
+{
+	FastMutex::ScopedLock lock(_mutex);
+	_dropped += count;
+}
+
+
+void AsyncFileChannel::writeBatch(std::size_t count)
+{
+	AutoPtr<Formatter> pFormatter;
+	bool flush;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		pFormatter.assign(_pFormatter, true);
+		flush = _flush;
+	}
+	for (std::size_t i = 0; i < count; i++)
+	{
+		std::string& text = _texts[i];
+		if (pFormatter)
+		{
+			text.clear();
+			pFormatter->format(_batch[i], text);
+		}
+		else text.assign(_batch[i].getText());
+	}
+	writeBuffers(count);
+	if (flush) syncFile();
+
+	FastMutex::ScopedLock lock(_mutex);
+	_flushed += count;
+}
+
+
+void AsyncFileChannel::setPriority(const std::string& value)
+{
+	Thread::Priority prio = Thread::PRIO_NORMAL;
+
+	if (value == "lowest")
+		prio = Thread::PRIO_LOWEST;
+	else if (value == "low")
+		prio = Thread::PRIO_LOW;
+	else if (value == "normal")
+		prio = Thread::PRIO_NORMAL;
+	else if (value == "high")
+		prio = Thread::PRIO_HIGH;
+	else if (value == "highest")
+		prio = Thread::PRIO_HIGHEST;
+	else
+		throw InvalidArgumentException("thread priority", value);
+
+	_thread.setPriority(prio);
+}
+
+
+#if defined(POCO_OS_FAMILY_UNIX)
+
+
+void AsyncFileChannel::openFile()
+{
+	if (_path.empty()) throw FileException("No path specified for AsyncFileChannel");
+	_fd = ::open(_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (_fd == -1) throw OpenFileException(_path);
+}
+
+
+void AsyncFileChannel::closeFile()
+{
+	if (_fd != -1)
+	{
+		::close(_fd);
+		_fd = -1;
+	}
+}
+
+
+void AsyncFileChannel::writeBuffers(std::size_t count)
+{
+	static char newLine = '\n';
+
+	std::vector<struct iovec> iov(2*count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		iov[2*i].iov_base = const_cast<char*>(_texts[i].data());
+		iov[2*i].iov_len  = _texts[i].size();
+		iov[2*i + 1].iov_base = &newLine;
+		iov[2*i + 1].iov_len  = 1;
+	}
+
+	struct iovec* pIov = &iov[0];
+	int iovCount = static_cast<int>(iov.size());
+	while (iovCount > 0)
+	{
+		ssize_t n = ::writev(_fd, pIov, iovCount);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			throw WriteFileException(_path);
+		}
+		// handle partial writes
+		while (iovCount > 0 && static_cast<std::size_t>(n) >= pIov->iov_len)
+		{
+			n -= pIov->iov_len;
+			++pIov;
+			--iovCount;
+		}
+		if (iovCount > 0)
+		{
+			pIov->iov_base = static_cast<char*>(pIov->iov_base) + n;
+			pIov->iov_len -= n;
+		}
+	}
+}
+
+
+void AsyncFileChannel::syncFile()
+{
+#if defined(POCO_OS_FAMILY_BSD)
+	::fsync(_fd);
+#else
+	::fdatasync(_fd);
+#endif
+}
+
+
+#else
+
+
+void AsyncFileChannel::openFile()
+{
+	if (_path.empty()) throw FileException("No path specified for AsyncFileChannel");
+	_pStream = new FileOutputStream(_path, std::ios::app);
+}
+
+
+void AsyncFileChannel::closeFile()
+{
+	delete _pStream;
+	_pStream = 0;
+}
+
+
+void AsyncFileChannel::writeBuffers(std::size_t count)
+{
+	std::string buffer;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		buffer.append(_texts[i]);
+		buffer += '\n';
+	}
+	_pStream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	if (!_pStream->good()) throw WriteFileException(_path);
+}
+
+
+void AsyncFileChannel::syncFile()
+{
+	_pStream->flush();
+}
+
+
+#endif // POCO_OS_FAMILY_UNIX
+
+
+} // namespace Poco
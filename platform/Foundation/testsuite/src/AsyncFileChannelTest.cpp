@@ -0,0 +1,286 @@
+//
+// AsyncFileChannelTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "AsyncFileChannelTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/AsyncFileChannel.h"
+#include "Poco/Message.h"
+#include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/Timestamp.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/ErrorHandler.h"
+
+
+using Poco::AsyncFileChannel;
+using Poco::Message;
+using Poco::File;
+using Poco::FileInputStream;
+using Poco::Timestamp;
+using Poco::DateTimeFormatter;
+using Poco::AutoPtr;
+using Poco::ErrorHandler;
+
+
+namespace
+{
+	class CountingErrorHandler: public ErrorHandler
+	{
+	public:
+		CountingErrorHandler():
+			_count(0)
+		{
+		}
+
+		void exception(const Poco::Exception&)
+		{
+			++_count;
+		}
+
+		void exception(const std::exception&)
+		{
+			++_count;
+		}
+
+		void exception()
+		{
+			++_count;
+		}
+
+		int count() const
+		{
+			return _count;
+		}
+
+	private:
+		int _count;
+	};
+}
+
+
+AsyncFileChannelTest::AsyncFileChannelTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+AsyncFileChannelTest::~AsyncFileChannelTest()
+{
+}
+
+
+void AsyncFileChannelTest::testWrite()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(AsyncFileChannel::PROP_CAPACITY, "16");
+		pChannel->setProperty(AsyncFileChannel::PROP_BATCHSIZE, "4");
+		pChannel->setProperty(AsyncFileChannel::PROP_POLICY, "block");
+		pChannel->open();
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 200; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+		assert (pChannel->queued() == 200);
+		assert (pChannel->dropped() == 0);
+		assert (pChannel->flushed() == 200);
+		assert (pChannel->pending() == 0);
+		assert (countLines(name) == 200);
+
+		FileInputStream istr(name);
+		std::string line;
+		std::getline(istr, line);
+		assert (line == "This is a log file entry");
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testFormat()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(AsyncFileChannel::PROP_FORMAT, "[%p] %s: %t");
+		Message msg("source", "Text", Message::PRIO_WARNING);
+		pChannel->log(msg);
+		pChannel->close();
+
+		FileInputStream istr(name);
+		std::string line;
+		std::getline(istr, line);
+		assert (line == "[Warning] source: Text");
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testBlock()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(AsyncFileChannel::PROP_CAPACITY, "1");
+		pChannel->setProperty(AsyncFileChannel::PROP_BATCHSIZE, "1");
+		pChannel->setProperty(AsyncFileChannel::PROP_POLICY, "block");
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 1000; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+		assert (pChannel->dropped() == 0);
+		assert (pChannel->flushed() == 1000);
+		assert (countLines(name) == 1000);
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testDrop()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel(name);
+		pChannel->setProperty(AsyncFileChannel::PROP_CAPACITY, "8");
+		pChannel->setProperty(AsyncFileChannel::PROP_POLICY, "drop");
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 10000; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+		assert (pChannel->queued() + pChannel->dropped() == 10000);
+		assert (pChannel->flushed() == pChannel->queued());
+		assert (countLines(name) == pChannel->flushed());
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void AsyncFileChannelTest::testWriteError()
+{
+#if defined(POCO_OS_FAMILY_UNIX)
+	// Writing to /dev/full always fails with ENOSPC.
+	if (!File("/dev/full").exists()) return;
+
+	CountingErrorHandler eh;
+	ErrorHandler* pOldEH = ErrorHandler::set(&eh);
+	try
+	{
+		AutoPtr<AsyncFileChannel> pChannel = new AsyncFileChannel("/dev/full");
+		pChannel->setProperty(AsyncFileChannel::PROP_CAPACITY, "16");
+		pChannel->setProperty(AsyncFileChannel::PROP_BATCHSIZE, "4");
+		pChannel->setProperty(AsyncFileChannel::PROP_POLICY, "block");
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 100; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+		assert (pChannel->queued() == 100);
+		assert (pChannel->flushed() == 0);
+		assert (pChannel->dropped() == 100);
+		assert (eh.count() > 0);
+	}
+	catch (...)
+	{
+		ErrorHandler::set(pOldEH);
+		throw;
+	}
+	ErrorHandler::set(pOldEH);
+#endif
+}
+
+
+void AsyncFileChannelTest::setUp()
+{
+}
+
+
+void AsyncFileChannelTest::tearDown()
+{
+}
+
+
+void AsyncFileChannelTest::remove(const std::string& name)
+{
+	try
+	{
+		File f(name);
+		f.remove();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+std::string AsyncFileChannelTest::filename() const
+{
+	std::string name = "asynclog_";
+	name.append(DateTimeFormatter::format(Timestamp(), "%Y%m%d%H%M%S"));
+	name.append(".log");
+	return name;
+}
+
+
+int AsyncFileChannelTest::countLines(const std::string& name)
+{
+	FileInputStream istr(name);
+	int lines = 0;
+	std::string line;
+	while (std::getline(istr, line)) ++lines;
+	return lines;
+}
+
+
+CppUnit::Test* AsyncFileChannelTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("AsyncFileChannelTest");
+
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testWrite);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testFormat);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testBlock);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testDrop);
+	CppUnit_addTest(pSuite, AsyncFileChannelTest, testWriteError);
+
+	return pSuite;
+}
@@ -0,0 +1,47 @@
+//
+// AsyncFileChannelTest.h
+//
+// $Id$
+//
+// Definition of the AsyncFileChannelTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef AsyncFileChannelTest_INCLUDED
+#define AsyncFileChannelTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "CppUnit/TestCase.h"
+
+
+class AsyncFileChannelTest: public CppUnit::TestCase
+{
+public:
+	AsyncFileChannelTest(const std::string& name);
+	~AsyncFileChannelTest();
+
+	void testWrite();
+	void testFormat();
+	void testBlock();
+	void testDrop();
+	void testWriteError();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	void remove(const std::string& name);
+	std::string filename() const;
+	int countLines(const std::string& name);
+};
+
+
+#endif // AsyncFileChannelTest_INCLUDED
@@ -0,0 +1,126 @@
+//
+// CursorWrapper.h
+//
+// $Id$
+//
+// Library: JSData
+// Package: Data
+// Module:  CursorWrapper
+//
+// Definition of the CursorWrapper class.
+//
+// Copyright (c) 2013-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef JS_Data_CursorWrapper_INCLUDED
+#define JS_Data_CursorWrapper_INCLUDED
+
+
+#include "Poco/JS/Data/Data.h"
+#include "Poco/JS/Core/Wrapper.h"
+#include "Poco/Data/Session.h"
+#include "Poco/Data/Statement.h"
+#include "Poco/Data/RecordSet.h"
+#include "Poco/Dynamic/Var.h"
+#include <vector>
+
+
+namespace Poco {
+namespace JS {
+namespace Data {
+
+
+class JSData_API CursorHolder
+	/// A forward-only cursor over the result of a query.
+	///
+	/// Rows are fetched from the database one page at a
+	/// time, so only the current page is kept in memory.
+{
+public:
+	CursorHolder(Poco::Data::Session& session, const std::string& sql, const std::vector<Poco::Dynamic::Var>& params, unsigned pageSize);
+		/// Creates the CursorHolder and prepares the query.
+		/// The query is executed when the first row is requested.
+
+	~CursorHolder();
+		/// Destroys the CursorHolder.
+
+	bool fetch();
+		/// Makes sure that the current page contains an unread row,
+		/// fetching the next page from the database if necessary.
+		///
+		/// Returns true if a row is available, or false if the
+		/// end of the result has been reached.
+
+	Poco::Data::RecordSet& recordSet()
+	{
+		poco_check_ptr (_pRecordSet);
+
+		return *_pRecordSet;
+	}
+
+	std::size_t row() const
+	{
+		return _row;
+	}
+
+	std::size_t remaining() const
+	{
+		return _pRecordSet ? _pRecordSet->rowCount() - _row : 0;
+	}
+
+	void advance()
+	{
+		++_row;
+	}
+
+	void close();
+		/// Releases the statement and the current page.
+
+	bool isOpen() const
+	{
+		return _pStatement != 0;
+	}
+
+private:
+	CursorHolder();
+	CursorHolder(const CursorHolder&);
+	CursorHolder& operator = (const CursorHolder&);
+
+	std::vector<Poco::Dynamic::Var> _params;
+	Poco::Data::Statement* _pStatement;
+	Poco::Data::RecordSet* _pRecordSet;
+	std::size_t _row;
+	bool _executed;
+};
+
+
+class JSData_API CursorWrapper: public JS::Core::Wrapper
+	/// JavaScript wrapper for CursorHolder.
+{
+public:
+	CursorWrapper();
+		/// Creates the CursorWrapper.
+
+	~CursorWrapper();
+		/// Destroys the CursorWrapper.
+
+	// Wrapper
+	v8::Handle<v8::ObjectTemplate> objectTemplate(v8::Isolate* pIsolate);
+
+protected:
+	static void next(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void nextPage(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void close(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+	static v8::Local<v8::Object> rowToObject(v8::Isolate* pIsolate, CursorHolder* pCursorHolder);
+};
+
+
+} } } // namespace Poco::JS::Data
+
+
+#endif // JS_Data_CursorWrapper_INCLUDED
@@ -91,6 +91,11 @@ public:
 
 	// Wrapper
 	v8::Handle<v8::ObjectTemplate> objectTemplate(v8::Isolate* pIsolate);
+
+	static v8::Local<v8::Value> convertDynamicAny(v8::Isolate* pIsolate, const Poco::DynamicAny& value, Poco::Data::MetaColumn::ColumnDataType typeHint);
+		/// Converts the given value to a JavaScript value, using typeHint
+		/// to determine the JavaScript type. Returns an empty handle
+		/// if the value cannot be converted.
 		
 protected:
 	static void construct(const v8::FunctionCallbackInfo<v8::Value>& args);
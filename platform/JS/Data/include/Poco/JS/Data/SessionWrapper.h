@@ -103,6 +103,7 @@ protected:
 	static void rollback(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void close(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void execute(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void prepare(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 
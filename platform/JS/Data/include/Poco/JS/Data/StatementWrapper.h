@@ -0,0 +1,154 @@
+//
+// StatementWrapper.h
+//
+// $Id$
+//
+// Library: JSData
+// Package: Data
+// Module:  StatementWrapper
+//
+// Definition of the StatementWrapper class.
+//
+// Copyright (c) 2013-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef JS_Data_StatementWrapper_INCLUDED
+#define JS_Data_StatementWrapper_INCLUDED
+
+
+#include "Poco/JS/Data/Data.h"
+#include "Poco/JS/Core/Wrapper.h"
+#include "Poco/Data/Session.h"
+#include "Poco/Data/Statement.h"
+#include "Poco/Dynamic/Var.h"
+#include <vector>
+
+
+namespace Poco {
+namespace JS {
+namespace Data {
+
+
+class JSData_API StatementHolder
+	/// Holds a prepared SQL statement that can be executed
+	/// repeatedly with different parameters.
+	///
+	/// Parameters are bound positionally as Poco::Dynamic::Var
+	/// values, so the type of a parameter may change from one
+	/// execution to the next.
+{
+public:
+	typedef std::vector<Poco::Dynamic::Var> Row;
+	typedef std::vector<Row> Rows;
+
+	StatementHolder(Poco::Data::Session& session, const std::string& sql, unsigned pageSize);
+		/// Creates the StatementHolder.
+
+	~StatementHolder();
+		/// Destroys the StatementHolder.
+
+	const std::string& sql() const
+	{
+		return _sql;
+	}
+
+	Poco::Data::Session& session()
+	{
+		return _session;
+	}
+
+	unsigned getPageSize() const
+	{
+		return _pageSize;
+	}
+
+	void setPageSize(unsigned pageSize)
+	{
+		_pageSize = pageSize;
+	}
+
+	std::size_t execute(const Row& params);
+		/// Executes the statement with the given parameters and returns
+		/// the number of affected rows.
+		///
+		/// The underlying Poco::Data::Statement is created on the first
+		/// call and reused by subsequent calls, as long as the number
+		/// of parameters does not change.
+
+	std::size_t executeBatch(const Rows& rows);
+		/// Executes the statement once for every row in rows, binding
+		/// each column of rows as a container. All rows must have the
+		/// same number of values.
+		///
+		/// If no transaction is active in the session, the batch is
+		/// executed within a transaction of its own, which is rolled back
+		/// if executing any row fails.
+		///
+		/// Returns the total number of affected rows.
+
+	void close();
+		/// Releases the underlying statement. The statement
+		/// must no longer be used afterwards.
+
+	bool isOpen() const
+	{
+		return !_closed;
+	}
+
+private:
+	StatementHolder();
+	StatementHolder(const StatementHolder&);
+	StatementHolder& operator = (const StatementHolder&);
+
+	Poco::Data::Session _session;
+	std::string _sql;
+	unsigned _pageSize;
+	Row _params;
+	Poco::Data::Statement* _pStatement;
+	bool _closed;
+};
+
+
+class JSData_API StatementWrapper: public JS::Core::Wrapper
+	/// JavaScript wrapper for StatementHolder.
+{
+public:
+	StatementWrapper();
+		/// Creates the StatementWrapper.
+
+	~StatementWrapper();
+		/// Destroys the StatementWrapper.
+
+	// Wrapper
+	v8::Handle<v8::ObjectTemplate> objectTemplate(v8::Isolate* pIsolate);
+
+	static Poco::Dynamic::Var convert(const v8::Local<v8::Value>& value);
+		/// Converts the given JavaScript value to a Poco::Dynamic::Var
+		/// suitable for binding. null and undefined are converted
+		/// to an empty Var, which is bound as NULL.
+		///
+		/// Throws a Poco::InvalidArgumentException if the value
+		/// cannot be converted.
+
+protected:
+	static void getSQL(v8::Local<v8::String> name, const v8::PropertyCallbackInfo<v8::Value>& info);
+	static void getPageSize(v8::Local<v8::String> name, const v8::PropertyCallbackInfo<v8::Value>& info);
+	static void setPageSize(v8::Local<v8::String> name, v8::Local<v8::Value> value, const v8::PropertyCallbackInfo<void>& info);
+
+	static void execute(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void executeBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void cursor(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void close(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+	static void convertArguments(const v8::FunctionCallbackInfo<v8::Value>& args, StatementHolder::Row& params);
+};
+
+
+} } } // namespace Poco::JS::Data
+
+
+#endif // JS_Data_StatementWrapper_INCLUDED
@@ -0,0 +1,219 @@
+//
+// CursorWrapper.cpp
+//
+// $Id$
+//
+// Library: JSData
+// Package: Data
+// Module:  CursorWrapper
+//
+// Copyright (c) 2013-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "Poco/JS/Data/CursorWrapper.h"
+#include "Poco/JS/Data/RecordSetWrapper.h"
+#include "Poco/JS/Core/PooledIsolate.h"
+#include "Poco/Data/DataException.h"
+#include "Poco/Version.h"
+
+
+#if POCO_VERSION > 0x01050000
+using namespace Poco::Data::Keywords;
+#else
+using namespace Poco::Data;
+#endif
+
+
+namespace Poco {
+namespace JS {
+namespace Data {
+
+
+CursorHolder::CursorHolder(Poco::Data::Session& session, const std::string& sql, const std::vector<Poco::Dynamic::Var>& params, unsigned pageSize):
+	_params(params),
+	_pStatement(0),
+	_pRecordSet(0),
+	_row(0),
+	_executed(false)
+{
+	_pStatement = new Poco::Data::Statement(session);
+	*_pStatement << sql;
+	for (std::vector<Poco::Dynamic::Var>::iterator it = _params.begin(); it != _params.end(); ++it)
+	{
+		*_pStatement , use(*it);
+	}
+	if (pageSize > 0)
+	{
+		*_pStatement , limit(pageSize);
+	}
+}
+
+
+CursorHolder::~CursorHolder()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+bool CursorHolder::fetch()
+{
+	if (!_pStatement) return false;
+
+	while (remaining() == 0)
+	{
+		if (_executed && _pStatement->done()) return false;
+
+		// Each execution fetches the next page into a fresh
+		// extraction, replacing the rows of the previous page.
+		_pStatement->execute();
+		_executed = true;
+		delete _pRecordSet;
+		_pRecordSet = 0;
+		_pRecordSet = new Poco::Data::RecordSet(*_pStatement);
+		_row = 0;
+	}
+	return true;
+}
+
+
+void CursorHolder::close()
+{
+	delete _pRecordSet;
+	_pRecordSet = 0;
+	delete _pStatement;
+	_pStatement = 0;
+}
+
+
+CursorWrapper::CursorWrapper()
+{
+}
+
+
+CursorWrapper::~CursorWrapper()
+{
+}
+
+
+v8::Handle<v8::ObjectTemplate> CursorWrapper::objectTemplate(v8::Isolate* pIsolate)
+{
+	v8::EscapableHandleScope handleScope(pIsolate);
+	Poco::JS::Core::PooledIsolate* pPooledIso = Poco::JS::Core::PooledIsolate::fromIsolate(pIsolate);
+	poco_check_ptr (pPooledIso);
+	v8::Persistent<v8::ObjectTemplate>& pooledObjectTemplate(pPooledIso->objectTemplate("Data.Cursor"));
+	if (pooledObjectTemplate.IsEmpty())
+	{
+		v8::Handle<v8::ObjectTemplate> objectTemplate = v8::ObjectTemplate::New();
+		objectTemplate->SetInternalFieldCount(1);
+
+		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "next"), v8::FunctionTemplate::New(pIsolate, next));
+		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "nextPage"), v8::FunctionTemplate::New(pIsolate, nextPage));
+		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "close"), v8::FunctionTemplate::New(pIsolate, close));
+
+		pooledObjectTemplate.Reset(pIsolate, objectTemplate);
+	}
+	v8::Local<v8::ObjectTemplate> cursorTemplate = v8::Local<v8::ObjectTemplate>::New(pIsolate, pooledObjectTemplate);
+	return handleScope.Escape(cursorTemplate);
+}
+
+
+void CursorWrapper::next(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	v8::HandleScope scope(args.GetIsolate());
+
+	CursorHolder* pCursorHolder = Wrapper::unwrapNative<CursorHolder>(args);
+	try
+	{
+		if (pCursorHolder->fetch())
+		{
+			args.GetReturnValue().Set(rowToObject(args.GetIsolate(), pCursorHolder));
+			pCursorHolder->advance();
+		}
+		else
+		{
+			args.GetReturnValue().SetNull();
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		returnException(args, exc);
+	}
+}
+
+
+void CursorWrapper::nextPage(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	v8::HandleScope scope(args.GetIsolate());
+
+	CursorHolder* pCursorHolder = Wrapper::unwrapNative<CursorHolder>(args);
+	try
+	{
+		v8::Local<v8::Array> rows;
+		if (pCursorHolder->fetch())
+		{
+			std::size_t n = pCursorHolder->remaining();
+			rows = v8::Array::New(args.GetIsolate(), static_cast<int>(n));
+			for (std::size_t i = 0; i < n; i++)
+			{
+				rows->Set(static_cast<Poco::UInt32>(i), rowToObject(args.GetIsolate(), pCursorHolder));
+				pCursorHolder->advance();
+			}
+		}
+		else
+		{
+			rows = v8::Array::New(args.GetIsolate(), 0);
+		}
+		args.GetReturnValue().Set(rows);
+	}
+	catch (Poco::Exception& exc)
+	{
+		returnException(args, exc);
+	}
+}
+
+
+void CursorWrapper::close(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	CursorHolder* pCursorHolder = Wrapper::unwrapNative<CursorHolder>(args);
+	pCursorHolder->close();
+}
+
+
+v8::Local<v8::Object> CursorWrapper::rowToObject(v8::Isolate* pIsolate, CursorHolder* pCursorHolder)
+{
+	v8::EscapableHandleScope handleScope(pIsolate);
+
+	Poco::Data::RecordSet& recordSet = pCursorHolder->recordSet();
+	std::size_t row = pCursorHolder->row();
+	v8::Local<v8::Object> object = v8::Object::New(pIsolate);
+	for (std::size_t col = 0; col < recordSet.columnCount(); col++)
+	{
+		const std::string& name = recordSet.columnName(col);
+		v8::Local<v8::String> jsName = v8::String::NewFromUtf8(pIsolate, name.c_str(), v8::String::kNormalString, static_cast<int>(name.length()));
+		if (recordSet.isNull(col, row))
+		{
+			object->Set(jsName, v8::Null(pIsolate));
+		}
+		else
+		{
+			v8::Local<v8::Value> value = RecordSetWrapper::convertDynamicAny(pIsolate, recordSet.value(col, row), recordSet.columnType(col));
+			if (value.IsEmpty()) throw Poco::Data::DataException("cannot convert value of column", name);
+			object->Set(jsName, value);
+		}
+	}
+	return handleScope.Escape(object);
+}
+
+
+} } } // namespace Poco::JS::Data
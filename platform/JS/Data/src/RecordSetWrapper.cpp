@@ -557,37 +557,56 @@ void RecordSetWrapper::returnDynamicAny(const v8::FunctionCallbackInfo<v8::Value
 {
 	v8::HandleScope scope(args.GetIsolate());
 
+	v8::Local<v8::Value> jsValue = convertDynamicAny(args.GetIsolate(), value, typeHint);
+	if (!jsValue.IsEmpty())
+	{
+		args.GetReturnValue().Set(jsValue);
+	}
+	else
+	{
+		returnException(args, std::string("cannot convert value"));
+	}
+}
+
+
+v8::Local<v8::Value> RecordSetWrapper::convertDynamicAny(v8::Isolate* pIsolate, const Poco::DynamicAny& value, Poco::Data::MetaColumn::ColumnDataType typeHint)
+{
+	v8::EscapableHandleScope handleScope(pIsolate);
+
+	v8::Local<v8::Value> result;
 	switch (typeHint)
 	{
 	case Poco::Data::MetaColumn::FDT_BOOL:
-		args.GetReturnValue().Set(value.convert<bool>());
+		result = v8::Boolean::New(pIsolate, value.convert<bool>());
 		break;
 	case Poco::Data::MetaColumn::FDT_INT8:
 	case Poco::Data::MetaColumn::FDT_INT16:
 	case Poco::Data::MetaColumn::FDT_INT32:
-		args.GetReturnValue().Set(value.convert<Poco::Int32>());
+		result = v8::Integer::New(pIsolate, value.convert<Poco::Int32>());
 		break;
 	case Poco::Data::MetaColumn::FDT_UINT8:
 	case Poco::Data::MetaColumn::FDT_UINT16:
 	case Poco::Data::MetaColumn::FDT_UINT32:
-		args.GetReturnValue().Set(value.convert<Poco::UInt32>());
+		result = v8::Integer::NewFromUnsigned(pIsolate, value.convert<Poco::UInt32>());
 		break;
 	case Poco::Data::MetaColumn::FDT_INT64:
 	case Poco::Data::MetaColumn::FDT_UINT64:
 	case Poco::Data::MetaColumn::FDT_FLOAT:
 	case Poco::Data::MetaColumn::FDT_DOUBLE:
-		args.GetReturnValue().Set(value.convert<double>());
+		result = v8::Number::New(pIsolate, value.convert<double>());
 		break;
 	case Poco::Data::MetaColumn::FDT_STRING:
-		returnString(args, value.convert<std::string>());
+		{
+			std::string str = value.convert<std::string>();
+			result = v8::String::NewFromUtf8(pIsolate, str.c_str(), v8::String::kNormalString, static_cast<int>(str.length()));
+		}
 		break;
 #if POCO_VERSION > 0x01050000
 	case Poco::Data::MetaColumn::FDT_TIMESTAMP:
 		{
 			Poco::DateTime dt = value.extract<Poco::DateTime>();
 			double millis = dt.timestamp().epochMicroseconds()/1000.0;
-			v8::Local<v8::Value> jsDate(v8::Date::New(args.GetIsolate(), millis));
-			args.GetReturnValue().Set(jsDate);
+			result = v8::Date::New(pIsolate, millis);
 		}
 		break;
 	case Poco::Data::MetaColumn::FDT_DATE:
@@ -595,8 +614,7 @@ void RecordSetWrapper::returnDynamicAny(const v8::FunctionCallbackInfo<v8::Value
 			Poco::Data::Date date = value.extract<Poco::Data::Date>();
 			Poco::DateTime dt(date.year(), date.month(), date.day());
 			double millis = dt.timestamp().epochMicroseconds()/1000.0;
-			v8::Local<v8::Value> jsDate(v8::Date::New(args.GetIsolate(), millis));
-			args.GetReturnValue().Set(jsDate);
+			result = v8::Date::New(pIsolate, millis);
 		}
 		break;
 	case Poco::Data::MetaColumn::FDT_TIME:
@@ -605,8 +623,7 @@ void RecordSetWrapper::returnDynamicAny(const v8::FunctionCallbackInfo<v8::Value
 			Poco::Data::Time time = value.extract<Poco::Data::Time>();
 			Poco::DateTime dt(now.year(), now.month(), now.day(), time.hour(), time.minute(), time.second());
 			double millis = dt.timestamp().epochMicroseconds()/1000.0;
-			v8::Local<v8::Value> jsDate(v8::Date::New(args.GetIsolate(), millis));
-			args.GetReturnValue().Set(jsDate);
+			result = v8::Date::New(pIsolate, millis);
 		}
 		break;
 #endif
@@ -617,9 +634,9 @@ void RecordSetWrapper::returnDynamicAny(const v8::FunctionCallbackInfo<v8::Value
 #endif
 	case Poco::Data::MetaColumn::FDT_UNKNOWN:
 	default:
-		returnException(args, std::string("cannot convert value"));
 		break;
 	}
+	return handleScope.Escape(result);
 }
 
 
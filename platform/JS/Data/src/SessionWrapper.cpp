@@ -16,6 +16,7 @@
 
 #include "Poco/JS/Data/SessionWrapper.h"
 #include "Poco/JS/Data/RecordSetWrapper.h"
+#include "Poco/JS/Data/StatementWrapper.h"
 #include "Poco/JS/Core/PooledIsolate.h"
 #include "Poco/Format.h"
 #include "Poco/Version.h"
@@ -84,6 +85,7 @@ v8::Handle<v8::ObjectTemplate> SessionWrapper::objectTemplate(v8::Isolate* pIsol
 		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "rollback"), v8::FunctionTemplate::New(pIsolate, rollback));
 		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "close"), v8::FunctionTemplate::New(pIsolate, close));
 		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "execute"), v8::FunctionTemplate::New(pIsolate, execute));
+		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "prepare"), v8::FunctionTemplate::New(pIsolate, prepare));
 
 		pooledObjectTemplate.Reset(pIsolate, objectTemplate);
 	}
@@ -297,4 +299,28 @@ void SessionWrapper::execute(const v8::FunctionCallbackInfo<v8::Value>& args)
 }
 
 
+void SessionWrapper::prepare(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	SessionHolder* pSessionHolder = Wrapper::unwrapNative<SessionHolder>(args);
+	if (args.Length() != 1)
+	{
+		returnException(args, std::string("bad arguments: statement required"));
+		return;
+	}
+	StatementHolder* pStatementHolder = 0;
+	try
+	{
+		pStatementHolder = new StatementHolder(pSessionHolder->session(), toString(args[0]), pSessionHolder->getPageSize());
+		StatementWrapper wrapper;
+		v8::Persistent<v8::Object>& statementObject(wrapper.wrapNativePersistent(args.GetIsolate(), pStatementHolder));
+		args.GetReturnValue().Set(statementObject);
+	}
+	catch (Poco::Exception& exc)
+	{
+		delete pStatementHolder;
+		returnException(args, exc);
+	}
+}
+
+
 } } } // namespace Poco::JS::Data
@@ -0,0 +1,339 @@
+//
+// StatementWrapper.cpp
+//
+// $Id$
+//
+// Library: JSData
+// Package: Data
+// Module:  StatementWrapper
+//
+// Copyright (c) 2013-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "Poco/JS/Data/StatementWrapper.h"
+#include "Poco/JS/Data/CursorWrapper.h"
+#include "Poco/JS/Core/PooledIsolate.h"
+#include "Poco/DateTime.h"
+#include "Poco/Format.h"
+#include "Poco/Version.h"
+
+
+#if POCO_VERSION > 0x01050000
+using namespace Poco::Data::Keywords;
+#else
+using namespace Poco::Data;
+#endif
+
+
+namespace Poco {
+namespace JS {
+namespace Data {
+
+
+StatementHolder::StatementHolder(Poco::Data::Session& session, const std::string& sql, unsigned pageSize):
+	_session(session),
+	_sql(sql),
+	_pageSize(pageSize),
+	_pStatement(0),
+	_closed(false)
+{
+}
+
+
+StatementHolder::~StatementHolder()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+std::size_t StatementHolder::execute(const Row& params)
+{
+	if (_closed) throw Poco::InvalidAccessException("statement has been closed");
+
+	if (!_pStatement || _params.size() != params.size())
+	{
+		delete _pStatement;
+		_pStatement = 0;
+		// The statement binds references to the elements of _params,
+		// so _params must not be reallocated once bound.
+		_params.clear();
+		_params.resize(params.size());
+		_pStatement = new Poco::Data::Statement(_session);
+		*_pStatement << _sql;
+		for (Row::iterator it = _params.begin(); it != _params.end(); ++it)
+		{
+			*_pStatement , use(*it);
+		}
+	}
+	std::copy(params.begin(), params.end(), _params.begin());
+	return _pStatement->execute();
+}
+
+
+std::size_t StatementHolder::executeBatch(const Rows& rows)
+{
+	if (_closed) throw Poco::InvalidAccessException("statement has been closed");
+	if (rows.empty()) return 0;
+
+	std::size_t columnCount = rows[0].size();
+	Rows columns(columnCount, Row(rows.size()));
+	for (std::size_t r = 0; r < rows.size(); r++)
+	{
+		if (rows[r].size() != columnCount)
+			throw Poco::InvalidArgumentException(Poco::format("row %z has %z values, expected %z", r, rows[r].size(), columnCount));
+		for (std::size_t c = 0; c < columnCount; c++)
+		{
+			columns[c][r] = rows[r][c];
+		}
+	}
+
+	Poco::Data::Statement statement(_session);
+	statement << _sql;
+	for (Rows::iterator it = columns.begin(); it != columns.end(); ++it)
+	{
+		statement , use(*it);
+	}
+
+	if (_session.isTransaction())
+	{
+		return statement.execute();
+	}
+	else
+	{
+		_session.begin();
+		try
+		{
+			std::size_t result = statement.execute();
+			_session.commit();
+			return result;
+		}
+		catch (...)
+		{
+			_session.rollback();
+			throw;
+		}
+	}
+}
+
+
+void StatementHolder::close()
+{
+	delete _pStatement;
+	_pStatement = 0;
+	_closed = true;
+}
+
+
+StatementWrapper::StatementWrapper()
+{
+}
+
+
+StatementWrapper::~StatementWrapper()
+{
+}
+
+
+v8::Handle<v8::ObjectTemplate> StatementWrapper::objectTemplate(v8::Isolate* pIsolate)
+{
+	v8::EscapableHandleScope handleScope(pIsolate);
+	Poco::JS::Core::PooledIsolate* pPooledIso = Poco::JS::Core::PooledIsolate::fromIsolate(pIsolate);
+	poco_check_ptr (pPooledIso);
+	v8::Persistent<v8::ObjectTemplate>& pooledObjectTemplate(pPooledIso->objectTemplate("Data.Statement"));
+	if (pooledObjectTemplate.IsEmpty())
+	{
+		v8::Handle<v8::ObjectTemplate> objectTemplate = v8::ObjectTemplate::New();
+		objectTemplate->SetInternalFieldCount(1);
+		objectTemplate->SetAccessor(v8::String::NewFromUtf8(pIsolate, "sql"), getSQL);
+		objectTemplate->SetAccessor(v8::String::NewFromUtf8(pIsolate, "pageSize"), getPageSize, setPageSize);
+
+		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "execute"), v8::FunctionTemplate::New(pIsolate, execute));
+		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "executeBatch"), v8::FunctionTemplate::New(pIsolate, executeBatch));
+		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "cursor"), v8::FunctionTemplate::New(pIsolate, cursor));
+		objectTemplate->Set(v8::String::NewFromUtf8(pIsolate, "close"), v8::FunctionTemplate::New(pIsolate, close));
+
+		pooledObjectTemplate.Reset(pIsolate, objectTemplate);
+	}
+	v8::Local<v8::ObjectTemplate> statementTemplate = v8::Local<v8::ObjectTemplate>::New(pIsolate, pooledObjectTemplate);
+	return handleScope.Escape(statementTemplate);
+}
+
+
+Poco::Dynamic::Var StatementWrapper::convert(const v8::Local<v8::Value>& value)
+{
+	if (value->IsNull() || value->IsUndefined())
+	{
+		return Poco::Dynamic::Var();
+	}
+	else if (value->IsString())
+	{
+		return toString(value);
+	}
+	else if (value->IsBoolean())
+	{
+		return value->BooleanValue();
+	}
+	else if (value->IsInt32())
+	{
+		return value->Int32Value();
+	}
+	else if (value->IsUint32())
+	{
+		return value->Uint32Value();
+	}
+	else if (value->IsNumber())
+	{
+		return value->NumberValue();
+	}
+	else if (value->IsDate())
+	{
+		v8::Local<v8::Date> jsDate = v8::Local<v8::Date>::Cast(value);
+		double millis = jsDate->ValueOf();
+		Poco::Timestamp ts(static_cast<Poco::Timestamp::TimeVal>(millis*1000));
+		return Poco::DateTime(ts);
+	}
+	else throw Poco::InvalidArgumentException("Cannot convert value to native type");
+}
+
+
+void StatementWrapper::convertArguments(const v8::FunctionCallbackInfo<v8::Value>& args, StatementHolder::Row& params)
+{
+	params.reserve(args.Length());
+	for (int i = 0; i < args.Length(); i++)
+	{
+		try
+		{
+			params.push_back(convert(args[i]));
+		}
+		catch (Poco::InvalidArgumentException&)
+		{
+			throw Poco::InvalidArgumentException(Poco::format("Cannot convert argument %d to native type", i));
+		}
+	}
+}
+
+
+void StatementWrapper::getSQL(v8::Local<v8::String> name, const v8::PropertyCallbackInfo<v8::Value>& info)
+{
+	StatementHolder* pStatementHolder = Wrapper::unwrapNative<StatementHolder>(info);
+	returnString(info, pStatementHolder->sql());
+}
+
+
+void StatementWrapper::getPageSize(v8::Local<v8::String> name, const v8::PropertyCallbackInfo<v8::Value>& info)
+{
+	StatementHolder* pStatementHolder = Wrapper::unwrapNative<StatementHolder>(info);
+	info.GetReturnValue().Set(pStatementHolder->getPageSize());
+}
+
+
+void StatementWrapper::setPageSize(v8::Local<v8::String> name, v8::Local<v8::Value> value, const v8::PropertyCallbackInfo<void>& info)
+{
+	StatementHolder* pStatementHolder = Wrapper::unwrapNative<StatementHolder>(info);
+	if (value->IsNumber())
+	{
+		pStatementHolder->setPageSize(value->Uint32Value());
+	}
+	else
+	{
+		returnException(info, std::string("invalid pageSize argument"));
+	}
+}
+
+
+void StatementWrapper::execute(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	StatementHolder* pStatementHolder = Wrapper::unwrapNative<StatementHolder>(args);
+	try
+	{
+		StatementHolder::Row params;
+		convertArguments(args, params);
+		std::size_t affected = pStatementHolder->execute(params);
+		args.GetReturnValue().Set(static_cast<double>(affected));
+	}
+	catch (Poco::Exception& exc)
+	{
+		returnException(args, exc);
+	}
+}
+
+
+void StatementWrapper::executeBatch(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	StatementHolder* pStatementHolder = Wrapper::unwrapNative<StatementHolder>(args);
+	if (args.Length() != 1 || !args[0]->IsArray())
+	{
+		returnException(args, std::string("bad arguments: array of rows required"));
+		return;
+	}
+	try
+	{
+		v8::Local<v8::Array> jsRows = v8::Local<v8::Array>::Cast(args[0]);
+		StatementHolder::Rows rows(jsRows->Length());
+		for (Poco::UInt32 r = 0; r < jsRows->Length(); r++)
+		{
+			v8::Local<v8::Value> jsRow = jsRows->Get(r);
+			if (!jsRow->IsArray())
+				throw Poco::InvalidArgumentException(Poco::format("row %u is not an array", r));
+			v8::Local<v8::Array> jsValues = v8::Local<v8::Array>::Cast(jsRow);
+			rows[r].reserve(jsValues->Length());
+			for (Poco::UInt32 c = 0; c < jsValues->Length(); c++)
+			{
+				rows[r].push_back(convert(jsValues->Get(c)));
+			}
+		}
+		std::size_t affected = pStatementHolder->executeBatch(rows);
+		args.GetReturnValue().Set(static_cast<double>(affected));
+	}
+	catch (Poco::Exception& exc)
+	{
+		returnException(args, exc);
+	}
+}
+
+
+void StatementWrapper::cursor(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	StatementHolder* pStatementHolder = Wrapper::unwrapNative<StatementHolder>(args);
+	if (!pStatementHolder->isOpen())
+	{
+		returnException(args, std::string("statement has been closed"));
+		return;
+	}
+	CursorHolder* pCursorHolder = 0;
+	try
+	{
+		StatementHolder::Row params;
+		convertArguments(args, params);
+		pCursorHolder = new CursorHolder(pStatementHolder->session(), pStatementHolder->sql(), params, pStatementHolder->getPageSize());
+		CursorWrapper wrapper;
+		v8::Persistent<v8::Object>& cursorObject(wrapper.wrapNativePersistent(args.GetIsolate(), pCursorHolder));
+		args.GetReturnValue().Set(cursorObject);
+	}
+	catch (Poco::Exception& exc)
+	{
+		delete pCursorHolder;
+		returnException(args, exc);
+	}
+}
+
+
+void StatementWrapper::close(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	StatementHolder* pStatementHolder = Wrapper::unwrapNative<StatementHolder>(args);
+	pStatementHolder->close();
+}
+
+
+} } } // namespace Poco::JS::Data
@@ -147,6 +147,12 @@ class JSCore_API HTTPRequestWrapper: public JS::Core::Wrapper
 	/// JavaScript wrapper for Poco::HTTPRequest.
 {
 public:
+	enum
+	{
+		DEFAULT_ASYNC_THREAD_COUNT = 4
+			/// Default number of threads sending asynchronous requests.
+	};
+
 	HTTPRequestWrapper();
 		/// Creates the HTTPRequestWrapper for the root logger.
 	
@@ -158,6 +164,21 @@ public:
 
 	// Wrapper
 	v8::Handle<v8::ObjectTemplate> objectTemplate(v8::Isolate* pIsolate);
+
+	static void setAsyncThreadCount(int count);
+		/// Sets the number of threads used for sending asynchronous
+		/// requests. The threads are shared by all executors.
+		///
+		/// Every thread sends one request at a time and blocks until
+		/// the response has been received. If all threads are busy,
+		/// e.g., waiting for slow servers, further requests are queued
+		/// until a thread becomes available. When reducing the number,
+		/// threads busy with a request stop after the request has
+		/// completed.
+
+	static int getAsyncThreadCount();
+		/// Returns the number of threads used for sending
+		/// asynchronous requests.
 		
 protected:
 	static void construct(const v8::FunctionCallbackInfo<v8::Value>& args);
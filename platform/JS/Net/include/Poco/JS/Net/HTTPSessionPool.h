@@ -0,0 +1,136 @@
+//
+// HTTPSessionPool.h
+//
+// $Id$
+//
+// Library: JSNet
+// Package: HTTP
+// Module:  HTTPSessionPool
+//
+// Definition of the HTTPSessionPool class.
+//
+// Copyright (c) 2013-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef JS_Net_HTTPSessionPool_INCLUDED
+#define JS_Net_HTTPSessionPool_INCLUDED
+
+
+#include "Poco/JS/Core/Core.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/URI.h"
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Mutex.h"
+#include <vector>
+#include <map>
+
+
+namespace Poco {
+namespace JS {
+namespace Net {
+
+
+class JSCore_API HTTPSessionPool
+	/// A pool of idle, persistent HTTP client sessions, keyed by origin
+	/// (scheme, host and port).
+	///
+	/// Sessions are created with the default Poco::Net::HTTPSessionFactory,
+	/// so the pool supports all protocols registered with the factory
+	/// (e.g., HTTPS). After a request has completed, the session can be
+	/// returned to the pool, so that the next request to the same origin
+	/// can reuse the established (and, for HTTPS, already negotiated)
+	/// connection.
+	///
+	/// The pool is shared by all JavaScript executors in the process.
+{
+public:
+	enum
+	{
+		DEFAULT_MAX_IDLE_SESSIONS = 8,
+			/// Default maximum number of idle sessions kept per origin.
+		DEFAULT_IDLE_TIMEOUT = 30
+			/// Default time in seconds an idle session is kept.
+	};
+
+	HTTPSessionPool();
+		/// Creates the HTTPSessionPool.
+
+	~HTTPSessionPool();
+		/// Destroys the HTTPSessionPool and closes all idle sessions.
+
+	Poco::SharedPtr<Poco::Net::HTTPClientSession> get(const Poco::URI& uri, bool& reused);
+		/// Returns a session for the origin of the given URI.
+		///
+		/// If an idle session for the origin is available, it is returned
+		/// and reused is set to true. Otherwise a new session is created
+		/// and reused is set to false.
+		///
+		/// Idle sessions whose connection has been closed by the server
+		/// are discarded. Note that the server may still close the
+		/// connection of a reused session before the request arrives.
+
+	void put(const Poco::URI& uri, Poco::SharedPtr<Poco::Net::HTTPClientSession> pSession);
+		/// Returns a session to the pool after a request has been
+		/// completed and the response body has been read completely.
+		///
+		/// The session is kept only if its connection is still open
+		/// and the maximum number of idle sessions for the origin
+		/// has not been reached. Otherwise, the session is discarded.
+
+	void setMaxIdleSessions(std::size_t maxIdle);
+		/// Sets the maximum number of idle sessions kept per origin.
+		/// Setting this to 0 disables pooling.
+
+	std::size_t getMaxIdleSessions() const;
+		/// Returns the maximum number of idle sessions kept per origin.
+
+	void setIdleTimeout(const Poco::Timespan& timeout);
+		/// Sets the time an idle session is kept in the pool.
+		/// This should be lower than the keep-alive timeout of the
+		/// servers the sessions connect to.
+
+	Poco::Timespan getIdleTimeout() const;
+		/// Returns the time an idle session is kept in the pool.
+
+	void clear();
+		/// Discards all idle sessions.
+
+	static HTTPSessionPool& defaultPool();
+		/// Returns the shared default HTTPSessionPool.
+
+protected:
+	static bool isAlive(Poco::Net::HTTPClientSession& session);
+		/// Returns true if the connection of the given idle
+		/// session is still open.
+
+	static std::string origin(const Poco::URI& uri);
+
+private:
+	HTTPSessionPool(const HTTPSessionPool&);
+	HTTPSessionPool& operator = (const HTTPSessionPool&);
+
+	struct IdleSession
+	{
+		Poco::SharedPtr<Poco::Net::HTTPClientSession> pSession;
+		Poco::Timestamp idleSince;
+	};
+	typedef std::vector<IdleSession> IdleSessions;
+	typedef std::map<std::string, IdleSessions> OriginMap;
+
+	OriginMap _idleSessions;
+	std::size_t _maxIdle;
+	Poco::Timespan _idleTimeout;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+} } } // namespace Poco::JS::Net
+
+
+#endif // JS_Net_HTTPSessionPool_INCLUDED
@@ -16,19 +16,25 @@
 
 #include "Poco/JS/Net/HTTPRequestWrapper.h"
 #include "Poco/JS/Net/HTTPResponseWrapper.h"
+#include "Poco/JS/Net/HTTPSessionPool.h"
 #include "Poco/JS/Core/PooledIsolate.h"
 #include "Poco/JS/Core/JSExecutor.h"
 #include "Poco/JS/Core/BufferWrapper.h"
 #include "Poco/Net/HTTPClientSession.h"
-#include "Poco/Net/HTTPSessionFactory.h"
+#include "Poco/Net/NetException.h"
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPBasicCredentials.h"
 #include "Poco/Util/TimerTask.h"
 #include "Poco/URI.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/StreamCopier.h"
-#include "Poco/ThreadPool.h"
+#include "Poco/NotificationQueue.h"
+#include "Poco/Notification.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
 #include "Poco/Exception.h"
+#include <vector>
 
 
 namespace Poco {
@@ -36,6 +42,77 @@ namespace JS {
 namespace Net {
 
 
+namespace
+{
+	bool hasRequestBody(const Poco::Net::HTTPRequest& request)
+	{
+		const std::string& method = request.getMethod();
+		return method == Poco::Net::HTTPRequest::HTTP_PUT || method == Poco::Net::HTTPRequest::HTTP_POST || method == Poco::Net::HTTPRequest::HTTP_PATCH;
+	}
+
+	bool isIdempotent(const Poco::Net::HTTPRequest& request)
+	{
+		const std::string& method = request.getMethod();
+		return method == Poco::Net::HTTPRequest::HTTP_GET 
+			|| method == Poco::Net::HTTPRequest::HTTP_HEAD 
+			|| method == Poco::Net::HTTPRequest::HTTP_PUT 
+			|| method == Poco::Net::HTTPRequest::HTTP_DELETE 
+			|| method == Poco::Net::HTTPRequest::HTTP_OPTIONS 
+			|| method == Poco::Net::HTTPRequest::HTTP_TRACE;
+	}
+
+	// Sends the request using a pooled session for the URI's origin
+	// and reads the complete response. Idle sessions closed by the
+	// server are not reused, but the server may still close a reused
+	// connection just before the request arrives. In this case, no
+	// response is received for the request, and an idempotent request
+	// is sent again with another session. Requests are never re-sent
+	// once a response has been received, or if they are not idempotent,
+	// as the server may already have processed them.
+	void sendRequest(const Poco::URI& uri, Poco::Net::HTTPRequest& request, const std::string& body, const Poco::Timespan& timeout, Poco::Net::HTTPResponse& response, std::string& responseBody)
+	{
+		HTTPSessionPool& pool = HTTPSessionPool::defaultPool();
+		std::string requestURI = request.getURI();
+		bool canRetry = isIdempotent(request);
+		bool reused = false;
+		Poco::SharedPtr<Poco::Net::HTTPClientSession> pSession = pool.get(uri, reused);
+		std::istream* pResponseStream = 0;
+		while (!pResponseStream)
+		{
+			try
+			{
+				pSession->setTimeout(timeout);
+				pSession->sendRequest(request).write(body.data(), body.size());
+				pResponseStream = &pSession->receiveResponse(response);
+			}
+			catch (Poco::Net::NoMessageException&)
+			{
+				if (!reused || !canRetry) throw;
+			}
+			catch (Poco::Net::ConnectionResetException&)
+			{
+				if (!reused || !canRetry) throw;
+			}
+			if (!pResponseStream)
+			{
+				request.setURI(requestURI);
+				response.clear();
+				pSession = pool.get(uri, reused);
+			}
+		}
+
+		std::streamsize contentLength = response.getContentLength();
+		responseBody.clear();
+		if (contentLength != Poco::Net::HTTPMessage::UNKNOWN_CONTENT_LENGTH)
+		{
+			responseBody.reserve(contentLength);
+		}
+		Poco::StreamCopier::copyToString(*pResponseStream, responseBody);
+		pool.put(uri, pSession);
+	}
+}
+
+
 RequestHolder::RequestHolder():
 	_timeout(30, 0)
 {
@@ -349,20 +426,11 @@ void HTTPRequestWrapper::sendBlocking(const v8::FunctionCallbackInfo<v8::Value>&
 		std::string uriPath = uri.getPathEtc();
 		if (uriPath.empty()) uriPath = "/";
 		pRequestHolder->request().setURI(uriPath);
-		Poco::SharedPtr<Poco::Net::HTTPClientSession> pCS = Poco::Net::HTTPSessionFactory::defaultFactory().createClientSession(uri);
-		if (pRequestHolder->request().getMethod() == Poco::Net::HTTPRequest::HTTP_PUT || pRequestHolder->request().getMethod() == Poco::Net::HTTPRequest::HTTP_POST || pRequestHolder->request().getMethod() == Poco::Net::HTTPRequest::HTTP_PATCH)
+		if (hasRequestBody(pRequestHolder->request()))
 		{
 			pRequestHolder->request().setContentLength(pRequestHolder->content().length());
 		}
-		pCS->setTimeout(pRequestHolder->getTimeout());
-		pCS->sendRequest(pRequestHolder->request()).write(pRequestHolder->content().data(), pRequestHolder->content().size());
-		std::istream& istr = pCS->receiveResponse(pResponseHolder->response());
-		std::streamsize contentLength = pResponseHolder->response().getContentLength();
-		if (contentLength != Poco::Net::HTTPMessage::UNKNOWN_CONTENT_LENGTH)
-		{
-			pResponseHolder->content().reserve(contentLength);
-		}
-		Poco::StreamCopier::copyToString(istr, pResponseHolder->content());
+		sendRequest(uri, pRequestHolder->request(), pRequestHolder->content(), pRequestHolder->getTimeout(), pResponseHolder->response(), pResponseHolder->content());
 		HTTPResponseWrapper wrapper;
 		v8::Persistent<v8::Object>& responseObject(wrapper.wrapNativePersistent(args.GetIsolate(), pResponseHolder));
 		args.GetReturnValue().Set(responseObject);
@@ -470,15 +538,18 @@ private:
 };
 
 
-class AsyncRequest: public Poco::Runnable
+class AsyncRequest: public Poco::Notification
 {
 public:
-	AsyncRequest(v8::Isolate* pIsolate, Poco::JS::Core::JSExecutor::Ptr pExecutor, Poco::SharedPtr<Poco::Net::HTTPClientSession> pSession, Poco::SharedPtr<Poco::Net::HTTPRequest> pRequest, const std::string& body, v8::Local<v8::Function>& function):
+	typedef Poco::AutoPtr<AsyncRequest> Ptr;
+
+	AsyncRequest(v8::Isolate* pIsolate, Poco::JS::Core::JSExecutor::Ptr pExecutor, const Poco::URI& uri, Poco::SharedPtr<Poco::Net::HTTPRequest> pRequest, const std::string& body, const Poco::Timespan& timeout, v8::Local<v8::Function>& function):
 		_pIsolate(pIsolate),
 		_pExecutor(pExecutor),
-		_pSession(pSession),
+		_uri(uri),
 		_pRequest(pRequest),
 		_body(body),
+		_timeout(timeout),
 		_function(pIsolate, function)
 	{
 	}
@@ -493,16 +564,9 @@ public:
 		Poco::JS::Core::TimedJSExecutor::Ptr pTimedJSExecutor = _pExecutor.cast<Poco::JS::Core::TimedJSExecutor>();
 		try
 		{
-			_pSession->sendRequest(*_pRequest).write(_body.data(), _body.size());
 			Poco::SharedPtr<Poco::Net::HTTPResponse> pResponse = new Poco::Net::HTTPResponse;
-			std::istream& istr = _pSession->receiveResponse(*pResponse);
 			std::string responseBody;
-			std::streamsize contentLength = pResponse->getContentLength();
-			if (contentLength != Poco::Net::HTTPMessage::UNKNOWN_CONTENT_LENGTH)
-			{
-				responseBody.reserve(contentLength);
-			}
-			Poco::StreamCopier::copyToString(istr, responseBody);
+			sendRequest(_uri, *_pRequest, _body, _timeout, *pResponse, responseBody);
 			if (pTimedJSExecutor)
 			{
 				pTimedJSExecutor->timer().schedule(new AsyncRequestCompletionTask(_pIsolate, _pExecutor, pResponse, responseBody, _function), Poco::Clock());
@@ -519,19 +583,154 @@ public:
 		{
 			poco_bugcheck();
 		}
-		delete this;
 	}
 	
 private:
 	v8::Isolate* _pIsolate;
 	Poco::JS::Core::JSExecutor::Ptr _pExecutor;
-	Poco::SharedPtr<Poco::Net::HTTPClientSession> _pSession;
+	Poco::URI _uri;
 	Poco::SharedPtr<Poco::Net::HTTPRequest> _pRequest;
 	std::string _body;
+	Poco::Timespan _timeout;
 	v8::Persistent<v8::Function> _function;
 };
 
 
+class AsyncRequestStopNotification: public Poco::Notification
+	/// Tells a single AsyncRequestProcessor thread to stop.
+{
+};
+
+
+class AsyncRequestProcessor: public Poco::Runnable
+	/// Sends queued asynchronous requests, using a small, configurable
+	/// number of threads. Requests are queued if all threads are
+	/// busy, instead of failing as with a thread pool.
+	/// Completion callbacks are run on the timer thread of the
+	/// executor that sent the request.
+	///
+	/// Each thread sends one request at a time, so slow servers
+	/// can delay requests queued behind them until a thread
+	/// becomes available.
+{
+public:
+	AsyncRequestProcessor():
+		_threadCount(0)
+	{
+		setThreadCount(HTTPRequestWrapper::DEFAULT_ASYNC_THREAD_COUNT);
+	}
+	
+	~AsyncRequestProcessor()
+	{
+		try
+		{
+			// Requests still waiting in the queue are discarded, as
+			// the executors they would complete on are going away, too.
+			_queue.clear();
+			setThreadCount(0);
+			for (std::vector<Poco::Thread*>::iterator it = _threads.begin(); it != _threads.end(); ++it)
+			{
+				(*it)->join();
+				delete *it;
+			}
+		}
+		catch (...)
+		{
+			poco_unexpected();
+		}
+	}
+	
+	void enqueue(AsyncRequest::Ptr pRequest)
+	{
+		_queue.enqueueNotification(pRequest);
+	}
+	
+	void setThreadCount(int count)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		// Threads stopped by a previous call are cleaned up here.
+		std::vector<Poco::Thread*>::iterator it = _threads.begin();
+		while (it != _threads.end())
+		{
+			if (!(*it)->isRunning())
+			{
+				(*it)->join();
+				delete *it;
+				it = _threads.erase(it);
+			}
+			else ++it;
+		}
+		while (_threadCount < count)
+		{
+			Poco::Thread* pThread = new Poco::Thread("JSHTTPRequest");
+			_threads.push_back(pThread);
+			pThread->start(*this);
+			_threadCount++;
+		}
+		// A thread busy with a request stops after the request
+		// has completed.
+		while (_threadCount > count)
+		{
+			_queue.enqueueUrgentNotification(new AsyncRequestStopNotification);
+			_threadCount--;
+		}
+	}
+	
+	int getThreadCount() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		return _threadCount;
+	}
+	
+	void run()
+	{
+		Poco::AutoPtr<Poco::Notification> pNf = _queue.waitDequeueNotification();
+		while (pNf && !pNf.cast<AsyncRequestStopNotification>())
+		{
+			AsyncRequest::Ptr pRequest = pNf.cast<AsyncRequest>();
+			if (pRequest) pRequest->run();
+			pNf = _queue.waitDequeueNotification();
+		}
+	}
+	
+	static AsyncRequestProcessor& instance();
+	
+private:
+	Poco::NotificationQueue _queue;
+	std::vector<Poco::Thread*> _threads;
+	int _threadCount;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+namespace
+{
+	static Poco::SingletonHolder<AsyncRequestProcessor> sh;
+}
+
+
+AsyncRequestProcessor& AsyncRequestProcessor::instance()
+{
+	return *sh.get();
+}
+
+
+void HTTPRequestWrapper::setAsyncThreadCount(int count)
+{
+	poco_assert (count > 0);
+
+	AsyncRequestProcessor::instance().setThreadCount(count);
+}
+
+
+int HTTPRequestWrapper::getAsyncThreadCount()
+{
+	return AsyncRequestProcessor::instance().getThreadCount();
+}
+
+
 void HTTPRequestWrapper::sendAsync(const v8::FunctionCallbackInfo<v8::Value>& args)
 {
 	v8::HandleScope handleScope(args.GetIsolate());
@@ -543,27 +742,16 @@ void HTTPRequestWrapper::sendAsync(const v8::FunctionCallbackInfo<v8::Value>& ar
 		Poco::URI uri(uriString);
 		std::string uriPath = uri.getPathEtc();
 		if (uriPath.empty()) uriPath = "/";
-		pRequestHolder->request().setURI(uriPath);
 		Poco::SharedPtr<Poco::Net::HTTPRequest> pRequest = new Poco::Net::HTTPRequest(pRequestHolder->request().getMethod(), uriPath, pRequestHolder->request().getVersion());
 		static_cast<Poco::Net::MessageHeader&>(*pRequest) = pRequestHolder->request();
-		Poco::SharedPtr<Poco::Net::HTTPClientSession> pCS = Poco::Net::HTTPSessionFactory::defaultFactory().createClientSession(uri);
-		if (pRequest->getMethod() == Poco::Net::HTTPRequest::HTTP_PUT || pRequest->getMethod() == Poco::Net::HTTPRequest::HTTP_POST)
+		if (hasRequestBody(*pRequest))
 		{
 			pRequest->setContentLength(pRequestHolder->content().length());
 		}
-		pCS->setTimeout(pRequestHolder->getTimeout());
 		
 		Poco::JS::Core::JSExecutor::Ptr pExecutor = Poco::JS::Core::JSExecutor::current();
-		AsyncRequest* pAsyncRequest = new AsyncRequest(args.GetIsolate(), pExecutor, pCS, pRequest, pRequestHolder->content(), function);
-		try
-		{
-			Poco::ThreadPool::defaultPool().start(*pAsyncRequest);
-		}
-		catch (...)
-		{
-			delete pAsyncRequest;
-			throw Poco::RuntimeException("No thread available for async HTTPRequest");
-		}
+		AsyncRequest::Ptr pAsyncRequest = new AsyncRequest(args.GetIsolate(), pExecutor, uri, pRequest, pRequestHolder->content(), pRequestHolder->getTimeout(), function);
+		AsyncRequestProcessor::instance().enqueue(pAsyncRequest);
 	}
 	catch (Poco::Exception& exc)
 	{
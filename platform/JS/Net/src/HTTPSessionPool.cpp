@@ -0,0 +1,192 @@
+//
+// HTTPSessionPool.cpp
+//
+// $Id$
+//
+// Library: JSNet
+// Package: HTTP
+// Module:  HTTPSessionPool
+//
+// Copyright (c) 2013-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "Poco/JS/Net/HTTPSessionPool.h"
+#include "Poco/Net/HTTPSessionFactory.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace JS {
+namespace Net {
+
+
+HTTPSessionPool::HTTPSessionPool():
+	_maxIdle(DEFAULT_MAX_IDLE_SESSIONS),
+	_idleTimeout(DEFAULT_IDLE_TIMEOUT, 0)
+{
+}
+
+
+HTTPSessionPool::~HTTPSessionPool()
+{
+	try
+	{
+		clear();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+Poco::SharedPtr<Poco::Net::HTTPClientSession> HTTPSessionPool::get(const Poco::URI& uri, bool& reused)
+{
+	std::string key = origin(uri);
+	IdleSessions expired;
+	Poco::Timespan idleTimeout;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		idleTimeout = _idleTimeout;
+		OriginMap::iterator it = _idleSessions.find(key);
+		if (it != _idleSessions.end())
+		{
+			IdleSessions& sessions = it->second;
+			while (!sessions.empty())
+			{
+				IdleSession idle = sessions.back();
+				sessions.pop_back();
+				if (idle.idleSince.isElapsed(_idleTimeout.totalMicroseconds()))
+				{
+					// The most recently used session has expired,
+					// so all others have expired as well.
+					expired.swap(sessions);
+					expired.push_back(idle);
+				}
+				else if (isAlive(*idle.pSession))
+				{
+					reused = true;
+					return idle.pSession;
+				}
+				else expired.push_back(idle);
+			}
+			_idleSessions.erase(it);
+		}
+	}
+	// expired sessions are closed outside of the lock
+
+	Poco::SharedPtr<Poco::Net::HTTPClientSession> pSession = Poco::Net::HTTPSessionFactory::defaultFactory().createClientSession(uri);
+	pSession->setKeepAlive(true);
+	pSession->setKeepAliveTimeout(idleTimeout);
+	reused = false;
+	return pSession;
+}
+
+
+void HTTPSessionPool::put(const Poco::URI& uri, Poco::SharedPtr<Poco::Net::HTTPClientSession> pSession)
+{
+	if (!pSession->connected() || !pSession->getKeepAlive()) return;
+
+	std::string key = origin(uri);
+	IdleSession idle;
+	idle.pSession = pSession;
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	IdleSessions& sessions = _idleSessions[key];
+	if (sessions.size() < _maxIdle)
+	{
+		sessions.push_back(idle);
+	}
+}
+
+
+void HTTPSessionPool::setMaxIdleSessions(std::size_t maxIdle)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_maxIdle = maxIdle;
+}
+
+
+std::size_t HTTPSessionPool::getMaxIdleSessions() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _maxIdle;
+}
+
+
+void HTTPSessionPool::setIdleTimeout(const Poco::Timespan& timeout)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_idleTimeout = timeout;
+}
+
+
+Poco::Timespan HTTPSessionPool::getIdleTimeout() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _idleTimeout;
+}
+
+
+void HTTPSessionPool::clear()
+{
+	OriginMap sessions;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		sessions.swap(_idleSessions);
+	}
+}
+
+
+bool HTTPSessionPool::isAlive(Poco::Net::HTTPClientSession& session)
+{
+	// No data is expected on an idle connection. If the socket
+	// is readable, the server has closed the connection.
+	try
+	{
+		return session.connected() && !session.socket().poll(Poco::Timespan(0), Poco::Net::Socket::SELECT_READ);
+	}
+	catch (Poco::Exception&)
+	{
+		return false;
+	}
+}
+
+
+std::string HTTPSessionPool::origin(const Poco::URI& uri)
+{
+	std::string result(uri.getScheme());
+	result += "://";
+	result += uri.getHost();
+	result += ':';
+	Poco::NumberFormatter::append(result, uri.getPort());
+	return result;
+}
+
+
+namespace
+{
+	static Poco::SingletonHolder<HTTPSessionPool> sh;
+}
+
+
+HTTPSessionPool& HTTPSessionPool::defaultPool()
+{
+	return *sh.get();
+}
+
+
+} } } // namespace Poco::JS::Net
@@ -0,0 +1,343 @@
+//
+// Document.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Document
+//
+// Definition of the Document class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_Document_INCLUDED
+#define JSON_Document_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/PullParser.h"
+#include "Poco/Dynamic/Var.h"
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class Writer;
+
+
+class JSON_API Document
+	/// Document is a compact, read-only in-memory representation
+	/// of a JSON document.
+	///
+	/// In contrast to the Object and Array based tree created by
+	/// Parser, a Document stores all values in a single flat vector,
+	/// in document order, with all strings held in a single
+	/// string buffer. Each container value knows the index
+	/// one past its last descendant, so a complete subtree can be
+	/// skipped in constant time. Object members keep their original
+	/// order, and looking up a member by name is done with a
+	/// linear search, which for the small objects typically found
+	/// in JSON documents is faster than a map lookup.
+	///
+	/// Parsing a document into a Document object that has been used
+	/// before reuses the already allocated memory.
+	///
+	/// Values are accessed through lightweight Value handles, which
+	/// are only valid as long as the Document is not modified
+	/// or destroyed.
+	///
+	/// Usage example:
+	///
+	///    Document doc;
+	///    doc.parse("{ \"name\" : \"Franky\", \"children\" : [ \"Jonas\", \"Ellen\" ] }");
+	///    std::string name = doc.root()["name"].getString();
+	///    for (Document::Value child = doc.root()["children"].firstChild(); child.valid(); child = child.nextSibling())
+	///    {
+	///        std::cout << child.getString() << std::endl;
+	///    }
+{
+public:
+	enum Type
+	{
+		TYPE_NULL,
+		TYPE_BOOLEAN,
+		TYPE_INTEGER,  /// An integer fitting into an Int64.
+		TYPE_UNSIGNED, /// An integer too big for an Int64, but fitting into an UInt64.
+		TYPE_REAL,
+		TYPE_STRING,
+		TYPE_ARRAY,
+		TYPE_OBJECT
+	};
+
+	class JSON_API Value
+		/// A handle to a value in a Document.
+	{
+	public:
+		Value();
+			/// Creates an invalid Value.
+
+		Type type() const;
+			/// Returns the type of the value.
+
+		bool valid() const;
+			/// Returns true if the Value refers to a value
+			/// in a Document.
+
+		bool isNull() const;
+			/// Returns true if the value is null.
+
+		bool isObject() const;
+			/// Returns true if the value is an object.
+
+		bool isArray() const;
+			/// Returns true if the value is an array.
+
+		bool isString() const;
+			/// Returns true if the value is a string.
+
+		bool isNumeric() const;
+			/// Returns true if the value is an integer or real number.
+
+		std::size_t size() const;
+			/// Returns the number of elements of an array, the number
+			/// of members of an object, or the length of a string.
+			/// Returns 0 for all other values.
+
+		Value firstChild() const;
+			/// Returns the first element of an array or the first member value
+			/// of an object. The returned Value is invalid if the
+			/// array or object is empty.
+
+		Value nextSibling() const;
+			/// Returns the next element of the array, or the next member
+			/// value of the object containing this value. The returned
+			/// Value is invalid if this value is the last one.
+
+		Value operator [] (std::size_t index) const;
+			/// Returns the array element or object member value with the
+			/// given index. Throws a RangeException if the index is out of range.
+			///
+			/// Note that the time required for finding the element
+			/// grows linearly with the index. Use firstChild() and nextSibling()
+			/// for iterating over all elements.
+
+		Value operator [] (const std::string& key) const;
+			/// Returns the value of the object member with the given name.
+			/// Throws a NotFoundException if there is no such member.
+
+		Value get(const std::string& key) const;
+			/// Returns the value of the object member with the given name,
+			/// or an invalid Value if there is no such member.
+
+		bool has(const std::string& key) const;
+			/// Returns true if the object has a member with the given name.
+
+		std::string key() const;
+			/// Returns the name of the object member this value
+			/// belongs to, or an empty string if the value
+			/// is not an object member.
+
+		std::string getString() const;
+			/// Returns the value of a string.
+
+		const char* data() const;
+			/// Returns a pointer to the (not zero-terminated) characters
+			/// of a string. The length is given by size().
+
+		Int64 getInt64() const;
+			/// Returns the value of an integer.
+
+		UInt64 getUInt64() const;
+			/// Returns the value of a non-negative integer.
+
+		double getDouble() const;
+			/// Returns the value of a number.
+
+		bool getBool() const;
+			/// Returns the value of a boolean.
+
+		Dynamic::Var toVar() const;
+			/// Converts the value into a Dynamic::Var, using
+			/// Object (preserving insertion order) and Array for
+			/// objects and arrays, in the same way as Parser does.
+
+		void write(Writer& writer) const;
+			/// Writes the value to the given Writer.
+
+	private:
+		Value(const Document* pDocument, std::size_t index, std::size_t limit);
+
+		void checkType(Type type) const;
+
+		const Document* _pDocument;
+		std::size_t _index;
+		std::size_t _limit;
+
+		friend class Document;
+	};
+
+	Document();
+		/// Creates an empty Document.
+
+	~Document();
+		/// Destroys the Document.
+
+	void parse(const std::string& json);
+		/// Parses the given JSON document.
+		///
+		/// Throws a JSONException if the document is not valid.
+
+	void parse(const char* json, std::size_t length);
+		/// Parses the given JSON document.
+		///
+		/// Throws a JSONException if the document is not valid.
+
+	PullParser& parser();
+		/// Returns the PullParser used for parsing, to
+		/// allow setting parser options.
+
+	Value root() const;
+		/// Returns the top-level value, which is invalid
+		/// if the Document is empty.
+
+	bool empty() const;
+		/// Returns true if the Document is empty.
+
+	void clear();
+		/// Removes all values from the Document, but
+		/// keeps the allocated memory.
+
+	void write(Writer& writer) const;
+		/// Writes the Document to the given Writer.
+
+private:
+	struct Node
+	{
+		Type type;
+		std::size_t end;
+			/// Index one past the last node of the subtree.
+		std::size_t size;
+			/// Number of children, or string length.
+		std::size_t keyOffset;
+		std::size_t keyLength;
+		union
+		{
+			Int64 intValue;
+			UInt64 uintValue;
+			double realValue;
+			bool boolValue;
+			std::size_t stringOffset;
+		};
+	};
+
+	Document(const Document&);
+	Document& operator = (const Document&);
+
+	std::size_t addNode(Type type);
+
+	std::vector<Node> _nodes;
+	std::string _strings;
+	std::vector<std::size_t> _open;
+	std::size_t _keyOffset;
+	std::size_t _keyLength;
+	PullParser _parser;
+
+	friend class Value;
+};
+
+
+//
+// inlines
+//
+inline Document::Type Document::Value::type() const
+{
+	return _pDocument->_nodes[_index].type;
+}
+
+
+inline bool Document::Value::valid() const
+{
+	return _pDocument && _index < _limit;
+}
+
+
+inline bool Document::Value::isNull() const
+{
+	return type() == TYPE_NULL;
+}
+
+
+inline bool Document::Value::isObject() const
+{
+	return type() == TYPE_OBJECT;
+}
+
+
+inline bool Document::Value::isArray() const
+{
+	return type() == TYPE_ARRAY;
+}
+
+
+inline bool Document::Value::isString() const
+{
+	return type() == TYPE_STRING;
+}
+
+
+inline bool Document::Value::isNumeric() const
+{
+	Type t = type();
+	return t == TYPE_INTEGER || t == TYPE_UNSIGNED || t == TYPE_REAL;
+}
+
+
+inline Document::Value Document::Value::nextSibling() const
+{
+	return Value(_pDocument, _pDocument->_nodes[_index].end, _limit);
+}
+
+
+inline bool Document::Value::has(const std::string& key) const
+{
+	return get(key).valid();
+}
+
+
+inline void Document::parse(const std::string& json)
+{
+	parse(json.data(), json.size());
+}
+
+
+inline PullParser& Document::parser()
+{
+	return _parser;
+}
+
+
+inline Document::Value Document::root() const
+{
+	return Value(this, 0, _nodes.size());
+}
+
+
+inline bool Document::empty() const
+{
+	return _nodes.empty();
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_Document_INCLUDED
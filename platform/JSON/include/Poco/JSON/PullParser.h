@@ -0,0 +1,307 @@
+//
+// PullParser.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  PullParser
+//
+// Definition of the PullParser class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_PullParser_INCLUDED
+#define JSON_PullParser_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "Poco/JSON/Handler.h"
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API PullParser
+	/// A RFC 4627 compatible pull parser for JSON documents
+	/// held in a contiguous buffer.
+	///
+	/// Unlike Parser, PullParser does not build a document tree.
+	/// Instead, the application repeatedly calls next() to obtain
+	/// the next token from the document, and can then obtain the
+	/// value of the token with getString(), getInt64(), etc.
+	///
+	/// PullParser works directly on the given buffer, which must
+	/// stay valid while the document is being parsed. Strings
+	/// without escape sequences are scanned several bytes at a time
+	/// (using SSE2 if available). The only memory allocated by the
+	/// parser is for the string buffer and the nesting stack, both of
+	/// which are retained by reset(), so a PullParser can be used
+	/// for parsing any number of documents without further allocations.
+	///
+	/// As required by RFC 4627, the top-level value of a document
+	/// must be an object or an array.
+	///
+	/// Usage example:
+	///
+	///    std::string json = "{ \"name\" : \"Franky\", \"children\" : [ \"Jonas\", \"Ellen\" ] }";
+	///    PullParser parser(json);
+	///    PullParser::Token token;
+	///    while ((token = parser.next()) != PullParser::TOKEN_END)
+	///    {
+	///        if (token == PullParser::TOKEN_KEY && parser.getString() == "name")
+	///        {
+	///            parser.next();
+	///            std::cout << parser.getString() << std::endl;
+	///        }
+	///    }
+	///
+	/// PullParser can also be used to drive a Handler, see parse().
+{
+public:
+	enum Token
+	{
+		TOKEN_NONE,         /// next() has not been called yet.
+		TOKEN_START_OBJECT, /// A '{' has been read.
+		TOKEN_END_OBJECT,   /// A '}' has been read.
+		TOKEN_START_ARRAY,  /// A '[' has been read.
+		TOKEN_END_ARRAY,    /// A ']' has been read.
+		TOKEN_KEY,          /// The key of an object member has been read. Use getString() to obtain it.
+		TOKEN_STRING,       /// A string value has been read. Use getString() to obtain it.
+		TOKEN_INTEGER,      /// An integer value fitting into an Int64 has been read.
+		TOKEN_UNSIGNED,     /// An integer value too big for an Int64, but fitting into an UInt64 has been read.
+		TOKEN_REAL,         /// A floating-point value has been read.
+		TOKEN_TRUE,         /// The value true has been read.
+		TOKEN_FALSE,        /// The value false has been read.
+		TOKEN_NULL,         /// The value null has been read.
+		TOKEN_END           /// The end of the document has been reached.
+	};
+
+	static const std::size_t UNLIMITED_DEPTH;
+
+	PullParser();
+		/// Creates a PullParser without a document.
+		/// Call reset() to specify the document to parse.
+
+	PullParser(const char* json, std::size_t length);
+		/// Creates a PullParser for the given document.
+
+	explicit PullParser(const std::string& json);
+		/// Creates a PullParser for the given document.
+		///
+		/// The string is not copied and must stay valid
+		/// while the document is being parsed.
+
+	~PullParser();
+		/// Destroys the PullParser.
+
+	void reset(const char* json, std::size_t length);
+		/// Resets the parser for parsing the given document.
+
+	void reset(const std::string& json);
+		/// Resets the parser for parsing the given document.
+		///
+		/// The string is not copied and must stay valid
+		/// while the document is being parsed.
+
+	void setAllowComments(bool comments);
+		/// Allow C and C++ style comments. By default, comments are not allowed.
+
+	bool getAllowComments() const;
+		/// Returns true if comments are allowed, false otherwise.
+
+	void setAllowNullByte(bool nullByte);
+		/// Allow null bytes (\u0000) in strings. By default, null bytes are allowed.
+
+	bool getAllowNullByte() const;
+		/// Returns true if null bytes are allowed, false otherwise.
+
+	void setDepth(std::size_t depth);
+		/// Sets the maximum allowed nesting depth of arrays and objects.
+		/// By default, the depth is unlimited.
+
+	std::size_t getDepth() const;
+		/// Returns the maximum allowed nesting depth.
+
+	Token next();
+		/// Reads the next token from the document and returns it.
+		///
+		/// Returns TOKEN_END when the end of the document
+		/// has been reached. Throws a JSONException if the
+		/// document is not valid JSON.
+
+	Token token() const;
+		/// Returns the current token.
+
+	void skip();
+		/// Skips the current value. If the current token is
+		/// TOKEN_START_OBJECT or TOKEN_START_ARRAY, reads all tokens
+		/// up to and including the matching TOKEN_END_OBJECT or
+		/// TOKEN_END_ARRAY. If the current token is TOKEN_KEY, also
+		/// skips the member value. Otherwise, does nothing.
+
+	const std::string& getString() const;
+		/// Returns the string if the current token is TOKEN_KEY or
+		/// TOKEN_STRING, with all escape sequences resolved.
+		///
+		/// The returned reference is only valid until next()
+		/// is called.
+
+	Int64 getInt64() const;
+		/// Returns the value of the current TOKEN_INTEGER.
+		/// Throws a JSONException if the current token is not
+		/// an integer fitting into an Int64.
+
+	UInt64 getUInt64() const;
+		/// Returns the value of the current TOKEN_INTEGER or TOKEN_UNSIGNED.
+		/// Throws a JSONException if the current token is not a
+		/// non-negative integer.
+
+	double getDouble() const;
+		/// Returns the value of the current TOKEN_REAL,
+		/// TOKEN_INTEGER or TOKEN_UNSIGNED as a double.
+
+	bool getBool() const;
+		/// Returns true if the current token is TOKEN_TRUE, or false
+		/// if it is TOKEN_FALSE. Throws a JSONException otherwise.
+
+	std::size_t depth() const;
+		/// Returns the current nesting depth of arrays and objects.
+
+	std::size_t offset() const;
+		/// Returns the offset in bytes of the current read position
+		/// from the beginning of the document.
+
+	void parse(Handler& handler);
+		/// Parses the rest of the document and reports
+		/// all values to the given handler, in the same way
+		/// as Parser does.
+
+private:
+	enum State
+	{
+		STATE_START,
+		STATE_VALUE,
+		STATE_FIRST_VALUE,
+		STATE_KEY,
+		STATE_FIRST_KEY,
+		STATE_NEXT,
+		STATE_DONE
+	};
+
+	PullParser(const PullParser&);
+	PullParser& operator = (const PullParser&);
+
+	Token nextValue(char c);
+	Token nextKey(char c);
+	Token endContainer(char c);
+	Token startContainer(char c);
+	Token afterValue(Token token);
+	void scanString();
+	void scanEscape();
+	void scanUTF8();
+	unsigned scanHex4();
+	void appendUTF8(unsigned ch);
+	Token scanNumber();
+	Token scanLiteral(const char* literal, std::size_t length, Token token);
+	bool skipWhitespace();
+	void skipComment();
+	void syntaxError(const char* what) const;
+
+	const char* _pBegin;
+	const char* _pEnd;
+	const char* _pCur;
+	Token _token;
+	State _state;
+	std::vector<char> _stack;
+	std::string _string;
+	UInt64 _integer;
+	double _real;
+	std::size_t _maxDepth;
+	bool _negative;
+	bool _allowComments;
+	bool _allowNullByte;
+};
+
+
+//
+// inlines
+//
+inline void PullParser::reset(const std::string& json)
+{
+	reset(json.data(), json.size());
+}
+
+
+inline void PullParser::setAllowComments(bool comments)
+{
+	_allowComments = comments;
+}
+
+
+inline bool PullParser::getAllowComments() const
+{
+	return _allowComments;
+}
+
+
+inline void PullParser::setAllowNullByte(bool nullByte)
+{
+	_allowNullByte = nullByte;
+}
+
+
+inline bool PullParser::getAllowNullByte() const
+{
+	return _allowNullByte;
+}
+
+
+inline void PullParser::setDepth(std::size_t depth)
+{
+	_maxDepth = depth;
+}
+
+
+inline std::size_t PullParser::getDepth() const
+{
+	return _maxDepth;
+}
+
+
+inline PullParser::Token PullParser::token() const
+{
+	return _token;
+}
+
+
+inline const std::string& PullParser::getString() const
+{
+	return _string;
+}
+
+
+inline std::size_t PullParser::depth() const
+{
+	return _stack.size();
+}
+
+
+inline std::size_t PullParser::offset() const
+{
+	return _pCur - _pBegin;
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_PullParser_INCLUDED
@@ -0,0 +1,177 @@
+//
+// Writer.h
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Writer
+//
+// Definition of the Writer class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef JSON_Writer_INCLUDED
+#define JSON_Writer_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include <string>
+#include <vector>
+
+
+namespace Poco {
+namespace JSON {
+
+
+class JSON_API Writer
+	/// Writer generates a condensed JSON document by
+	/// appending it to a std::string.
+	///
+	/// Unlike Stringifier, Writer does not need a document tree
+	/// and does not use iostreams. Separators between values
+	/// are inserted automatically, and strings are escaped in the
+	/// same way as by Stringifier. Non-finite floating-point
+	/// values are written as null.
+	///
+	/// The Writer checks that the sequence of calls results in
+	/// a well-formed document and throws a JSONException otherwise.
+	///
+	/// Usage example:
+	///
+	///    std::string json;
+	///    Writer writer(json);
+	///    writer.startObject();
+	///    writer.key("name");
+	///    writer.value("Franky");
+	///    writer.key("children");
+	///    writer.startArray();
+	///    writer.value("Jonas");
+	///    writer.value("Ellen");
+	///    writer.endArray();
+	///    writer.endObject();
+	///    // json is now {"name":"Franky","children":["Jonas","Ellen"]}
+{
+public:
+	explicit Writer(std::string& buffer);
+		/// Creates a Writer appending to the given string,
+		/// which must stay valid as long as the Writer is used.
+
+	~Writer();
+		/// Destroys the Writer.
+
+	void startObject();
+		/// Writes the start of an object.
+
+	void endObject();
+		/// Writes the end of an object.
+
+	void startArray();
+		/// Writes the start of an array.
+
+	void endArray();
+		/// Writes the end of an array.
+
+	void key(const std::string& key);
+		/// Writes the key of the next object member.
+
+	void key(const char* key, std::size_t length);
+		/// Writes the key of the next object member.
+
+	void value(const std::string& value);
+		/// Writes a string value.
+
+	void value(const char* value);
+		/// Writes a zero-terminated string value.
+
+	void value(const char* value, std::size_t length);
+		/// Writes a string value.
+
+	void value(int value);
+		/// Writes an integer value.
+
+	void value(unsigned value);
+		/// Writes an unsigned integer value.
+
+#if defined(POCO_HAVE_INT64)
+	void value(Int64 value);
+		/// Writes a 64-bit integer value.
+
+	void value(UInt64 value);
+		/// Writes an unsigned 64-bit integer value.
+#endif
+
+	void value(double value);
+		/// Writes a floating-point value.
+
+	void value(bool value);
+		/// Writes a boolean value.
+
+	void null();
+		/// Writes a null value.
+
+	bool done() const;
+		/// Returns true if a complete document has been written.
+
+	void reset();
+		/// Resets the Writer's state for writing another document.
+		/// The string buffer is not cleared.
+
+	std::string& buffer();
+		/// Returns the string the document is appended to.
+
+	static void formatString(const char* value, std::size_t length, std::string& buffer);
+		/// Appends the given string, quoted and escaped, to buffer.
+
+private:
+	Writer();
+	Writer(const Writer&);
+	Writer& operator = (const Writer&);
+
+	void beginValue();
+	void endValue();
+
+	std::string& _buffer;
+	std::vector<char> _stack;
+	bool _first;
+	bool _haveKey;
+	bool _done;
+};
+
+
+//
+// inlines
+//
+inline void Writer::key(const std::string& key)
+{
+	this->key(key.data(), key.size());
+}
+
+
+inline void Writer::value(const std::string& value)
+{
+	this->value(value.data(), value.size());
+}
+
+
+inline bool Writer::done() const
+{
+	return _done;
+}
+
+
+inline std::string& Writer::buffer()
+{
+	return _buffer;
+}
+
+
+} } // namespace Poco::JSON
+
+
+#endif // JSON_Writer_INCLUDED
@@ -4,6 +4,7 @@
 // $Id$
 //
 // This sample shows a benchmark of the JSON parser.
+// The JSON file to parse can be given as command line argument.
 //
 // Copyright (c) 2012, Applied Informatics Software Engineering GmbH.
 // and Contributors.
@@ -15,6 +16,9 @@
 #include "Poco/JSON/Parser.h"
 #include "Poco/JSON/ParseHandler.h"
 #include "Poco/JSON/JSONException.h"
+#include "Poco/JSON/PullParser.h"
+#include "Poco/JSON/Document.h"
+#include "Poco/JSON/Writer.h"
 #include "Poco/Environment.h"
 #include "Poco/Path.h"
 #include "Poco/File.h"
@@ -29,8 +33,16 @@ int main(int argc, char** argv)
 {
 	Poco::Stopwatch sw;
 
-	std::string dir = Poco::Environment::get("POCO_BASE") + "/JSON/samples/Benchmark/";
-	Poco::Path filePath(dir, "input.big.json");
+	Poco::Path filePath;
+	if (argc > 1)
+	{
+		filePath = argv[1];
+	}
+	else
+	{
+		std::string dir = Poco::Environment::get("POCO_BASE") + "/JSON/samples/Benchmark/";
+		filePath = Poco::Path(dir, "input.big.json");
+	}
 
 	std::ostringstream ostr;
 
@@ -110,6 +122,39 @@ int main(int argc, char** argv)
 		std::cout << "stringified in " << sw.elapsed() << " [us]" << std::endl;
 		std::cout << "-----------------------------------" << std::endl;
 		std::cout << std::endl;
+
+		std::cout << "POCO JSON PullParser/Document/Writer" << std::endl;
+		Poco::JSON::PullParser pullParser(jsonStr);
+		std::size_t tokens = 0;
+		sw.restart();
+		while (pullParser.next() != Poco::JSON::PullParser::TOKEN_END) ++tokens;
+		sw.stop();
+		std::cout << "-----------------------------------------" << std::endl;
+		std::cout << "[PullParser] " << tokens << " tokens read in " << sw.elapsed() << " [us]" << std::endl;
+		std::cout << "-----------------------------------------" << std::endl;
+
+		Poco::JSON::Document doc;
+		sw.restart();
+		doc.parse(jsonStr);
+		sw.stop();
+		std::cout << "-----------------------------------------" << std::endl;
+		std::cout << "[Document] parsed in " << sw.elapsed() << " [us]" << std::endl;
+
+		sw.restart();
+		doc.parse(jsonStr);
+		sw.stop();
+		std::cout << "[Document] parsed again (reusing memory) in " << sw.elapsed() << " [us]" << std::endl;
+		std::cout << "-----------------------------------------" << std::endl;
+
+		std::string json;
+		sw.restart();
+		Poco::JSON::Writer writer(json);
+		doc.write(writer);
+		sw.stop();
+		std::cout << "-----------------------------------------" << std::endl;
+		std::cout << "[Writer] " << json.size() << " bytes written in " << sw.elapsed() << " [us]" << std::endl;
+		std::cout << "-----------------------------------------" << std::endl;
+		std::cout << std::endl;
 	}
 	catch(Poco::JSON::JSONException jsone)
 	{
@@ -0,0 +1,423 @@
+//
+// Document.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Document
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/Document.h"
+#include "Poco/JSON/Writer.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/Exception.h"
+#include <limits>
+
+
+namespace Poco {
+namespace JSON {
+
+
+//
+// Document::Value
+//
+
+
+Document::Value::Value():
+	_pDocument(0),
+	_index(0),
+	_limit(0)
+{
+}
+
+
+Document::Value::Value(const Document* pDocument, std::size_t index, std::size_t limit):
+	_pDocument(pDocument),
+	_index(index),
+	_limit(limit)
+{
+}
+
+
+std::size_t Document::Value::size() const
+{
+	const Node& node = _pDocument->_nodes[_index];
+	switch (node.type)
+	{
+	case TYPE_ARRAY:
+	case TYPE_OBJECT:
+	case TYPE_STRING:
+		return node.size;
+	default:
+		return 0;
+	}
+}
+
+
+Document::Value Document::Value::firstChild() const
+{
+	const Node& node = _pDocument->_nodes[_index];
+	if (node.type != TYPE_ARRAY && node.type != TYPE_OBJECT) throw JSONException("Not an array or object");
+
+	return Value(_pDocument, _index + 1, node.end);
+}
+
+
+Document::Value Document::Value::operator [] (std::size_t index) const
+{
+	if (index >= size()) throw RangeException("Document index out of range");
+
+	Value child = firstChild();
+	while (index-- > 0) child = child.nextSibling();
+	return child;
+}
+
+
+Document::Value Document::Value::operator [] (const std::string& key) const
+{
+	Value child = get(key);
+	if (!child.valid()) throw NotFoundException(key);
+	return child;
+}
+
+
+Document::Value Document::Value::get(const std::string& key) const
+{
+	checkType(TYPE_OBJECT);
+
+	const std::vector<Node>& nodes = _pDocument->_nodes;
+	const char* strings = _pDocument->_strings.data();
+	std::size_t end = nodes[_index].end;
+	std::size_t index = _index + 1;
+	while (index < end)
+	{
+		const Node& node = nodes[index];
+		if (node.keyLength == key.size() && key.compare(0, key.size(), strings + node.keyOffset, node.keyLength) == 0)
+		{
+			return Value(_pDocument, index, end);
+		}
+		index = node.end;
+	}
+	return Value();
+}
+
+
+std::string Document::Value::key() const
+{
+	const Node& node = _pDocument->_nodes[_index];
+	return std::string(_pDocument->_strings, node.keyOffset, node.keyLength);
+}
+
+
+std::string Document::Value::getString() const
+{
+	checkType(TYPE_STRING);
+
+	const Node& node = _pDocument->_nodes[_index];
+	return std::string(_pDocument->_strings, node.stringOffset, node.size);
+}
+
+
+const char* Document::Value::data() const
+{
+	checkType(TYPE_STRING);
+
+	return _pDocument->_strings.data() + _pDocument->_nodes[_index].stringOffset;
+}
+
+
+Int64 Document::Value::getInt64() const
+{
+	const Node& node = _pDocument->_nodes[_index];
+	if (node.type != TYPE_INTEGER) throw JSONException("Not an integer value");
+
+	return node.intValue;
+}
+
+
+UInt64 Document::Value::getUInt64() const
+{
+	const Node& node = _pDocument->_nodes[_index];
+	if (node.type == TYPE_UNSIGNED || (node.type == TYPE_INTEGER && node.intValue >= 0))
+		return node.uintValue;
+	else
+		throw JSONException("Not an unsigned integer value");
+}
+
+
+double Document::Value::getDouble() const
+{
+	const Node& node = _pDocument->_nodes[_index];
+	switch (node.type)
+	{
+	case TYPE_REAL:
+		return node.realValue;
+	case TYPE_INTEGER:
+		return static_cast<double>(node.intValue);
+	case TYPE_UNSIGNED:
+		return static_cast<double>(node.uintValue);
+	default:
+		throw JSONException("Not a numeric value");
+	}
+}
+
+
+bool Document::Value::getBool() const
+{
+	checkType(TYPE_BOOLEAN);
+
+	return _pDocument->_nodes[_index].boolValue;
+}
+
+
+Dynamic::Var Document::Value::toVar() const
+{
+	const Node& node = _pDocument->_nodes[_index];
+	switch (node.type)
+	{
+	case TYPE_NULL:
+		return Dynamic::Var();
+	case TYPE_BOOLEAN:
+		return node.boolValue;
+	case TYPE_INTEGER:
+		if (node.intValue >= std::numeric_limits<int>::min() && node.intValue <= std::numeric_limits<int>::max())
+			return static_cast<int>(node.intValue);
+		else
+			return node.intValue;
+	case TYPE_UNSIGNED:
+		return node.uintValue;
+	case TYPE_REAL:
+		return node.realValue;
+	case TYPE_STRING:
+		return getString();
+	case TYPE_ARRAY:
+		{
+			Array::Ptr pArray = new Array;
+			for (Value child = firstChild(); child.valid(); child = child.nextSibling())
+			{
+				pArray->add(child.toVar());
+			}
+			return pArray;
+		}
+	case TYPE_OBJECT:
+		{
+			Object::Ptr pObject = new Object(true);
+			for (Value child = firstChild(); child.valid(); child = child.nextSibling())
+			{
+				pObject->set(child.key(), child.toVar());
+			}
+			return pObject;
+		}
+	}
+	return Dynamic::Var();
+}
+
+
+void Document::Value::write(Writer& writer) const
+{
+	const std::vector<Node>& nodes = _pDocument->_nodes;
+	const char* strings = _pDocument->_strings.data();
+
+	// Nodes are stored in document order, so the subtree can be written
+	// with a single pass, using a stack for closing containers.
+	std::vector<std::size_t> open;
+	std::size_t end = nodes[_index].end;
+	for (std::size_t index = _index; index < end; ++index)
+	{
+		while (!open.empty() && nodes[open.back()].end == index)
+		{
+			if (nodes[open.back()].type == TYPE_OBJECT) writer.endObject(); else writer.endArray();
+			open.pop_back();
+		}
+		const Node& node = nodes[index];
+		if (!open.empty() && nodes[open.back()].type == TYPE_OBJECT)
+		{
+			writer.key(strings + node.keyOffset, node.keyLength);
+		}
+		switch (node.type)
+		{
+		case TYPE_NULL:
+			writer.null();
+			break;
+		case TYPE_BOOLEAN:
+			writer.value(node.boolValue);
+			break;
+		case TYPE_INTEGER:
+			writer.value(node.intValue);
+			break;
+		case TYPE_UNSIGNED:
+			writer.value(node.uintValue);
+			break;
+		case TYPE_REAL:
+			writer.value(node.realValue);
+			break;
+		case TYPE_STRING:
+			writer.value(strings + node.stringOffset, node.size);
+			break;
+		case TYPE_ARRAY:
+			writer.startArray();
+			open.push_back(index);
+			break;
+		case TYPE_OBJECT:
+			writer.startObject();
+			open.push_back(index);
+			break;
+		}
+	}
+	while (!open.empty())
+	{
+		if (nodes[open.back()].type == TYPE_OBJECT) writer.endObject(); else writer.endArray();
+		open.pop_back();
+	}
+}
+
+
+void Document::Value::checkType(Type type) const
+{
+	if (_pDocument->_nodes[_index].type != type)
+	{
+		throw JSONException("Unexpected value type");
+	}
+}
+
+
+//
+// Document
+//
+
+
+Document::Document():
+	_keyOffset(0),
+	_keyLength(0)
+{
+}
+
+
+Document::~Document()
+{
+}
+
+
+void Document::parse(const char* json, std::size_t length)
+{
+	clear();
+	_parser.reset(json, length);
+	try
+	{
+		PullParser::Token token;
+		while ((token = _parser.next()) != PullParser::TOKEN_END)
+		{
+			switch (token)
+			{
+			case PullParser::TOKEN_START_OBJECT:
+				_open.push_back(addNode(TYPE_OBJECT));
+				break;
+			case PullParser::TOKEN_START_ARRAY:
+				_open.push_back(addNode(TYPE_ARRAY));
+				break;
+			case PullParser::TOKEN_END_OBJECT:
+			case PullParser::TOKEN_END_ARRAY:
+				_nodes[_open.back()].end = _nodes.size();
+				_open.pop_back();
+				break;
+			case PullParser::TOKEN_KEY:
+				_keyOffset = _strings.size();
+				_keyLength = _parser.getString().size();
+				_strings.append(_parser.getString());
+				break;
+			case PullParser::TOKEN_STRING:
+				{
+					std::size_t index = addNode(TYPE_STRING);
+					_nodes[index].stringOffset = _strings.size();
+					_nodes[index].size = _parser.getString().size();
+					_strings.append(_parser.getString());
+				}
+				break;
+			case PullParser::TOKEN_INTEGER:
+				_nodes[addNode(TYPE_INTEGER)].intValue = _parser.getInt64();
+				break;
+			case PullParser::TOKEN_UNSIGNED:
+				_nodes[addNode(TYPE_UNSIGNED)].uintValue = _parser.getUInt64();
+				break;
+			case PullParser::TOKEN_REAL:
+				_nodes[addNode(TYPE_REAL)].realValue = _parser.getDouble();
+				break;
+			case PullParser::TOKEN_TRUE:
+			case PullParser::TOKEN_FALSE:
+				_nodes[addNode(TYPE_BOOLEAN)].boolValue = _parser.getBool();
+				break;
+			case PullParser::TOKEN_NULL:
+				addNode(TYPE_NULL);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+}
+
+
+void Document::clear()
+{
+	_nodes.clear();
+	_strings.clear();
+	_open.clear();
+	_keyOffset = 0;
+	_keyLength = 0;
+}
+
+
+void Document::write(Writer& writer) const
+{
+	if (!empty()) root().write(writer);
+}
+
+
+std::size_t Document::addNode(Type type)
+{
+	Node node;
+	node.type = type;
+	node.size = 0;
+	node.uintValue = 0;
+	if (!_open.empty())
+	{
+		Node& parent = _nodes[_open.back()];
+		parent.size++;
+		if (parent.type == TYPE_OBJECT)
+		{
+			node.keyOffset = _keyOffset;
+			node.keyLength = _keyLength;
+		}
+		else
+		{
+			node.keyOffset = 0;
+			node.keyLength = 0;
+		}
+	}
+	else
+	{
+		node.keyOffset = 0;
+		node.keyLength = 0;
+	}
+	std::size_t index = _nodes.size();
+	node.end = index + 1;
+	_nodes.push_back(node);
+	return index;
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,705 @@
+//
+// PullParser.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  PullParser
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/PullParser.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/UTF8Encoding.h"
+#include "Poco/NumericString.h"
+#include "Poco/NumberFormatter.h"
+#include <limits>
+#include <cstring>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POCO_JSON_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	inline const char* scanPlainString(const char* p, const char* end)
+		/// Returns a pointer to the first character in [p, end) that
+		/// needs special treatment in a string: a quote, a backslash,
+		/// a control character or the first byte of a multi-byte
+		/// UTF-8 sequence. Returns end if there is no such character.
+	{
+#if defined(POCO_JSON_HAVE_SSE2)
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i space = _mm_set1_epi8(0x20);
+		while (end - p >= 16)
+		{
+			__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			// signed comparison, so bytes >= 0x80 count as less than 0x20
+			__m128i special = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+				_mm_cmplt_epi8(chunk, space));
+			if (_mm_movemask_epi8(special)) break;
+			p += 16;
+		}
+#else
+		static const Poco::UInt64 ONES = 0x0101010101010101ULL;
+		static const Poco::UInt64 HIGH = 0x8080808080808080ULL;
+		while (end - p >= 8)
+		{
+			Poco::UInt64 word;
+			std::memcpy(&word, p, 8);
+			Poco::UInt64 quote = word ^ (ONES*'"');
+			Poco::UInt64 backslash = word ^ (ONES*'\\');
+			Poco::UInt64 special = ((quote - ONES) & ~quote) | ((backslash - ONES) & ~backslash) | (word - ONES*0x20) | word;
+			if (special & HIGH) break;
+			p += 8;
+		}
+#endif
+		while (p < end)
+		{
+			unsigned char c = static_cast<unsigned char>(*p);
+			if (c == '"' || c == '\\' || c < 0x20 || c >= 0x80) break;
+			++p;
+		}
+		return p;
+	}
+
+	inline bool isDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+const std::size_t PullParser::UNLIMITED_DEPTH = std::numeric_limits<std::size_t>::max();
+
+
+PullParser::PullParser():
+	_pBegin(0),
+	_pEnd(0),
+	_pCur(0),
+	_token(TOKEN_NONE),
+	_state(STATE_START),
+	_integer(0),
+	_real(0),
+	_maxDepth(UNLIMITED_DEPTH),
+	_negative(false),
+	_allowComments(false),
+	_allowNullByte(true)
+{
+}
+
+
+PullParser::PullParser(const char* json, std::size_t length):
+	_pBegin(json),
+	_pEnd(json + length),
+	_pCur(json),
+	_token(TOKEN_NONE),
+	_state(STATE_START),
+	_integer(0),
+	_real(0),
+	_maxDepth(UNLIMITED_DEPTH),
+	_negative(false),
+	_allowComments(false),
+	_allowNullByte(true)
+{
+}
+
+
+PullParser::PullParser(const std::string& json):
+	_pBegin(json.data()),
+	_pEnd(json.data() + json.size()),
+	_pCur(json.data()),
+	_token(TOKEN_NONE),
+	_state(STATE_START),
+	_integer(0),
+	_real(0),
+	_maxDepth(UNLIMITED_DEPTH),
+	_negative(false),
+	_allowComments(false),
+	_allowNullByte(true)
+{
+}
+
+
+PullParser::~PullParser()
+{
+}
+
+
+void PullParser::reset(const char* json, std::size_t length)
+{
+	_pBegin = json;
+	_pEnd = json + length;
+	_pCur = json;
+	_token = TOKEN_NONE;
+	_state = STATE_START;
+	_stack.clear();
+	_string.clear();
+	_integer = 0;
+	_real = 0;
+	_negative = false;
+}
+
+
+PullParser::Token PullParser::next()
+{
+	if (!skipWhitespace())
+	{
+		if (_state == STATE_DONE) return _token = TOKEN_END;
+		syntaxError("unexpected end of document");
+	}
+
+	char c = *_pCur;
+	switch (_state)
+	{
+	case STATE_START:
+		if (c != '{' && c != '[') syntaxError("object or array expected");
+		return _token = startContainer(c);
+	case STATE_VALUE:
+		return _token = nextValue(c);
+	case STATE_FIRST_VALUE:
+		if (c == ']') return _token = endContainer(c);
+		return _token = nextValue(c);
+	case STATE_KEY:
+		return _token = nextKey(c);
+	case STATE_FIRST_KEY:
+		if (c == '}') return _token = endContainer(c);
+		return _token = nextKey(c);
+	case STATE_NEXT:
+		if (c == ',')
+		{
+			++_pCur;
+			_state = _stack.back() == '{' ? STATE_KEY : STATE_VALUE;
+			return next();
+		}
+		else if (c == '}' || c == ']')
+		{
+			return _token = endContainer(c);
+		}
+		syntaxError("',' or end of object or array expected");
+	case STATE_DONE:
+		syntaxError("unexpected data after end of document");
+	}
+	return _token = TOKEN_END;
+}
+
+
+void PullParser::skip()
+{
+	if (_token == TOKEN_KEY) next();
+	if (_token == TOKEN_START_OBJECT || _token == TOKEN_START_ARRAY)
+	{
+		std::size_t depth = _stack.size();
+		while (_stack.size() >= depth) next();
+	}
+}
+
+
+Int64 PullParser::getInt64() const
+{
+	if (_token != TOKEN_INTEGER) throw JSONException("Not an integer value");
+
+	if (_negative)
+		return static_cast<Int64>(0 - _integer);
+	else
+		return static_cast<Int64>(_integer);
+}
+
+
+UInt64 PullParser::getUInt64() const
+{
+	if ((_token != TOKEN_INTEGER && _token != TOKEN_UNSIGNED) || _negative) throw JSONException("Not an unsigned integer value");
+
+	return _integer;
+}
+
+
+double PullParser::getDouble() const
+{
+	switch (_token)
+	{
+	case TOKEN_REAL:
+		return _real;
+	case TOKEN_INTEGER:
+		return static_cast<double>(getInt64());
+	case TOKEN_UNSIGNED:
+		return static_cast<double>(_integer);
+	default:
+		throw JSONException("Not a numeric value");
+	}
+}
+
+
+bool PullParser::getBool() const
+{
+	if (_token == TOKEN_TRUE)
+		return true;
+	else if (_token == TOKEN_FALSE)
+		return false;
+	else
+		throw JSONException("Not a boolean value");
+}
+
+
+void PullParser::parse(Handler& handler)
+{
+	Token token;
+	while ((token = next()) != TOKEN_END)
+	{
+		switch (token)
+		{
+		case TOKEN_START_OBJECT:
+			handler.startObject();
+			break;
+		case TOKEN_END_OBJECT:
+			handler.endObject();
+			break;
+		case TOKEN_START_ARRAY:
+			handler.startArray();
+			break;
+		case TOKEN_END_ARRAY:
+			handler.endArray();
+			break;
+		case TOKEN_KEY:
+			handler.key(_string);
+			break;
+		case TOKEN_STRING:
+			handler.value(_string);
+			break;
+		case TOKEN_INTEGER:
+			{
+				Int64 value = getInt64();
+				if (value > std::numeric_limits<int>::max() || value < std::numeric_limits<int>::min())
+#if defined(POCO_HAVE_INT64)
+					handler.value(value);
+#else
+					handler.value(static_cast<double>(value));
+#endif
+				else
+					handler.value(static_cast<int>(value));
+			}
+			break;
+		case TOKEN_UNSIGNED:
+#if defined(POCO_HAVE_INT64)
+			handler.value(_integer);
+#else
+			handler.value(static_cast<double>(_integer));
+#endif
+			break;
+		case TOKEN_REAL:
+			handler.value(_real);
+			break;
+		case TOKEN_TRUE:
+			handler.value(true);
+			break;
+		case TOKEN_FALSE:
+			handler.value(false);
+			break;
+		case TOKEN_NULL:
+			handler.null();
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+
+PullParser::Token PullParser::nextValue(char c)
+{
+	switch (c)
+	{
+	case '{':
+	case '[':
+		return startContainer(c);
+	case '"':
+		++_pCur;
+		scanString();
+		return afterValue(TOKEN_STRING);
+	case '-':
+	case '0': case '1': case '2': case '3': case '4':
+	case '5': case '6': case '7': case '8': case '9':
+		return afterValue(scanNumber());
+	case 't':
+		return afterValue(scanLiteral("true", 4, TOKEN_TRUE));
+	case 'f':
+		return afterValue(scanLiteral("false", 5, TOKEN_FALSE));
+	case 'n':
+		return afterValue(scanLiteral("null", 4, TOKEN_NULL));
+	default:
+		syntaxError("value expected");
+	}
+	return TOKEN_NONE;
+}
+
+
+PullParser::Token PullParser::nextKey(char c)
+{
+	if (c != '"') syntaxError("string expected as object key");
+	++_pCur;
+	scanString();
+	if (!skipWhitespace() || *_pCur != ':') syntaxError("':' expected");
+	++_pCur;
+	_state = STATE_VALUE;
+	return TOKEN_KEY;
+}
+
+
+PullParser::Token PullParser::startContainer(char c)
+{
+	if (_stack.size() >= _maxDepth) syntaxError("maximum depth exceeded");
+	_stack.push_back(c);
+	++_pCur;
+	if (c == '{')
+	{
+		_state = STATE_FIRST_KEY;
+		return TOKEN_START_OBJECT;
+	}
+	else
+	{
+		_state = STATE_FIRST_VALUE;
+		return TOKEN_START_ARRAY;
+	}
+}
+
+
+PullParser::Token PullParser::endContainer(char c)
+{
+	char open = _stack.back();
+	if ((open == '{' && c != '}') || (open == '[' && c != ']')) syntaxError("mismatched end of object or array");
+	_stack.pop_back();
+	++_pCur;
+	_state = _stack.empty() ? STATE_DONE : STATE_NEXT;
+	return c == '}' ? TOKEN_END_OBJECT : TOKEN_END_ARRAY;
+}
+
+
+PullParser::Token PullParser::afterValue(Token token)
+{
+	_state = _stack.empty() ? STATE_DONE : STATE_NEXT;
+	return token;
+}
+
+
+void PullParser::scanString()
+{
+	_string.clear();
+	const char* p = _pCur;
+	for (;;)
+	{
+		const char* q = scanPlainString(p, _pEnd);
+		if (q != p) _string.append(p, q - p);
+		_pCur = q;
+		if (q == _pEnd) syntaxError("unterminated string");
+
+		unsigned char c = static_cast<unsigned char>(*q);
+		if (c == '"')
+		{
+			++_pCur;
+			return;
+		}
+		else if (c == '\\')
+		{
+			++_pCur;
+			scanEscape();
+		}
+		else if (c >= 0x80)
+		{
+			scanUTF8();
+		}
+		else syntaxError("control character in string");
+		p = _pCur;
+	}
+}
+
+
+void PullParser::scanEscape()
+{
+	if (_pCur == _pEnd) syntaxError("unterminated string");
+
+	char c = *_pCur++;
+	switch (c)
+	{
+	case '"':
+	case '\\':
+	case '/':
+		_string += c;
+		break;
+	case 'b':
+		_string += '\b';
+		break;
+	case 'f':
+		_string += '\f';
+		break;
+	case 'n':
+		_string += '\n';
+		break;
+	case 'r':
+		_string += '\r';
+		break;
+	case 't':
+		_string += '\t';
+		break;
+	case 'u':
+		{
+			unsigned ch = scanHex4();
+			if (ch >= 0xD800 && ch <= 0xDBFF)
+			{
+				if (_pEnd - _pCur < 2 || _pCur[0] != '\\' || _pCur[1] != 'u') syntaxError("missing low surrogate");
+				_pCur += 2;
+				unsigned low = scanHex4();
+				if (low < 0xDC00 || low > 0xDFFF) syntaxError("invalid low surrogate");
+				ch = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
+			}
+			else if (ch >= 0xDC00 && ch <= 0xDFFF)
+			{
+				syntaxError("unexpected low surrogate");
+			}
+			else if (ch == 0 && !_allowNullByte)
+			{
+				syntaxError("null byte not allowed");
+			}
+			appendUTF8(ch);
+		}
+		break;
+	default:
+		syntaxError("invalid escape sequence");
+	}
+}
+
+
+void PullParser::scanUTF8()
+{
+	unsigned char c = static_cast<unsigned char>(*_pCur);
+	int length;
+	if (c >= 0xC2 && c <= 0xDF)
+		length = 2;
+	else if (c >= 0xE0 && c <= 0xEF)
+		length = 3;
+	else if (c >= 0xF0 && c <= 0xF4)
+		length = 4;
+	else
+		length = 0;
+	if (length == 0 || _pEnd - _pCur < length || !Poco::UTF8Encoding::isLegal(reinterpret_cast<const unsigned char*>(_pCur), length))
+	{
+		syntaxError("invalid UTF-8 sequence");
+	}
+	_string.append(_pCur, length);
+	_pCur += length;
+}
+
+
+unsigned PullParser::scanHex4()
+{
+	if (_pEnd - _pCur < 4) syntaxError("invalid unicode escape sequence");
+
+	unsigned ch = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		char c = *_pCur++;
+		ch <<= 4;
+		if (c >= '0' && c <= '9')
+			ch += c - '0';
+		else if (c >= 'a' && c <= 'f')
+			ch += c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			ch += c - 'A' + 10;
+		else
+			syntaxError("invalid unicode escape sequence");
+	}
+	return ch;
+}
+
+
+void PullParser::appendUTF8(unsigned ch)
+{
+	if (ch < 0x80)
+	{
+		_string += static_cast<char>(ch);
+	}
+	else if (ch < 0x800)
+	{
+		_string += static_cast<char>(0xC0 | (ch >> 6));
+		_string += static_cast<char>(0x80 | (ch & 0x3F));
+	}
+	else if (ch < 0x10000)
+	{
+		_string += static_cast<char>(0xE0 | (ch >> 12));
+		_string += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+		_string += static_cast<char>(0x80 | (ch & 0x3F));
+	}
+	else
+	{
+		_string += static_cast<char>(0xF0 | (ch >> 18));
+		_string += static_cast<char>(0x80 | ((ch >> 12) & 0x3F));
+		_string += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+		_string += static_cast<char>(0x80 | (ch & 0x3F));
+	}
+}
+
+
+PullParser::Token PullParser::scanNumber()
+{
+	const char* pStart = _pCur;
+	const char* p = _pCur;
+	_negative = false;
+	if (*p == '-')
+	{
+		_negative = true;
+		++p;
+	}
+	if (p == _pEnd || !isDigit(*p)) syntaxError("invalid number");
+
+	UInt64 value = 0;
+	bool overflow = false;
+	if (*p == '0')
+	{
+		++p;
+		if (p != _pEnd && isDigit(*p)) syntaxError("invalid number (leading zero)");
+	}
+	else
+	{
+		while (p != _pEnd && isDigit(*p))
+		{
+			unsigned digit = *p++ - '0';
+			if (value > (std::numeric_limits<UInt64>::max() - digit)/10)
+				overflow = true;
+			else
+				value = value*10 + digit;
+		}
+	}
+
+	bool real = false;
+	if (p != _pEnd && *p == '.')
+	{
+		real = true;
+		++p;
+		if (p == _pEnd || !isDigit(*p)) syntaxError("invalid number (digit expected after decimal point)");
+		while (p != _pEnd && isDigit(*p)) ++p;
+	}
+	if (p != _pEnd && (*p == 'e' || *p == 'E'))
+	{
+		real = true;
+		++p;
+		if (p != _pEnd && (*p == '+' || *p == '-')) ++p;
+		if (p == _pEnd || !isDigit(*p)) syntaxError("invalid number (digit expected in exponent)");
+		while (p != _pEnd && isDigit(*p)) ++p;
+	}
+	_pCur = p;
+
+	if (real)
+	{
+		// strToDouble() requires a zero-terminated string
+		char buffer[64];
+		std::size_t length = p - pStart;
+		if (length < sizeof(buffer))
+		{
+			std::memcpy(buffer, pStart, length);
+			buffer[length] = 0;
+			_real = Poco::strToDouble(buffer);
+		}
+		else
+		{
+			_string.assign(pStart, length);
+			_real = Poco::strToDouble(_string.c_str());
+		}
+		if (_real > std::numeric_limits<double>::max() || _real < -std::numeric_limits<double>::max())
+		{
+			syntaxError("number out of range");
+		}
+		return TOKEN_REAL;
+	}
+	else
+	{
+		if (overflow) syntaxError("integer out of range");
+		_integer = value;
+		if (_negative)
+		{
+			if (value > static_cast<UInt64>(std::numeric_limits<Int64>::max()) + 1) syntaxError("integer out of range");
+			return TOKEN_INTEGER;
+		}
+		else if (value > static_cast<UInt64>(std::numeric_limits<Int64>::max()))
+		{
+			return TOKEN_UNSIGNED;
+		}
+		else return TOKEN_INTEGER;
+	}
+}
+
+
+PullParser::Token PullParser::scanLiteral(const char* literal, std::size_t length, Token token)
+{
+	if (static_cast<std::size_t>(_pEnd - _pCur) < length || std::memcmp(_pCur, literal, length) != 0)
+	{
+		syntaxError("invalid literal");
+	}
+	_pCur += length;
+	return token;
+}
+
+
+bool PullParser::skipWhitespace()
+{
+	while (_pCur != _pEnd)
+	{
+		char c = *_pCur;
+		if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+			++_pCur;
+		else if (c == '/' && _allowComments)
+			skipComment();
+		else
+			return true;
+	}
+	return false;
+}
+
+
+void PullParser::skipComment()
+{
+	++_pCur;
+	if (_pCur != _pEnd && *_pCur == '/')
+	{
+		while (_pCur != _pEnd && *_pCur != '\n') ++_pCur;
+	}
+	else if (_pCur != _pEnd && *_pCur == '*')
+	{
+		++_pCur;
+		for (;;)
+		{
+			if (_pEnd - _pCur < 2) syntaxError("unterminated comment");
+			if (_pCur[0] == '*' && _pCur[1] == '/')
+			{
+				_pCur += 2;
+				break;
+			}
+			++_pCur;
+		}
+	}
+	else syntaxError("invalid comment");
+}
+
+
+void PullParser::syntaxError(const char* what) const
+{
+	std::string message(what);
+	message += " at offset ";
+	Poco::NumberFormatter::append(message, static_cast<UInt64>(_pCur - _pBegin));
+	throw JSONException("JSON syntax error", message);
+}
+
+
+} } // namespace Poco::JSON
@@ -0,0 +1,273 @@
+//
+// Writer.cpp
+//
+// $Id$
+//
+// Library: JSON
+// Package: JSON
+// Module:  Writer
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/JSON/Writer.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/FPEnvironment.h"
+#include <cstring>
+
+
+namespace
+{
+	// Escape sequences for all characters that need escaping.
+	// An empty entry means the character is written as is.
+	// Control characters without a short escape sequence
+	// are written as \u00XX.
+	const char* const ESCAPES[128] =
+	{
+		0,     0,     0,     0,     0,     0,     0,     0,
+		"\\b", "\\t", "\\n", 0,     "\\f", "\\r", 0,     0,
+		0,     0,     0,     0,     0,     0,     0,     0,
+		0,     0,     0,     0,     0,     0,     0,     0,
+		"",    "",    "\\\"", "",   "",    "",    "",    "",
+		"",    "",    "",    "",    "",    "",    "",    "\\/",
+		"",    "",    "",    "",    "",    "",    "",    "",
+		"",    "",    "",    "",    "",    "",    "",    "",
+		"",    "",    "",    "",    "",    "",    "",    "",
+		"",    "",    "",    "",    "",    "",    "",    "",
+		"",    "",    "",    "",    "",    "",    "",    "",
+		"",    "",    "",    "",    "\\\\", "",   "",    "",
+		"",    "",    "",    "",    "",    "",    "",    "",
+		"",    "",    "",    "",    "",    "",    "",    "",
+		"",    "",    "",    "",    "",    "",    "",    "",
+		"",    "",    "",    "",    "",    "",    "",    ""
+	};
+
+	inline bool needsEscape(unsigned char c)
+	{
+		return c < 0x80 && (ESCAPES[c] == 0 || *ESCAPES[c] != 0);
+	}
+}
+
+
+namespace Poco {
+namespace JSON {
+
+
+Writer::Writer(std::string& buffer):
+	_buffer(buffer),
+	_first(true),
+	_haveKey(false),
+	_done(false)
+{
+}
+
+
+Writer::~Writer()
+{
+}
+
+
+void Writer::startObject()
+{
+	beginValue();
+	_buffer += '{';
+	_stack.push_back('{');
+	_first = true;
+}
+
+
+void Writer::endObject()
+{
+	if (_stack.empty() || _stack.back() != '{' || _haveKey) throw JSONException("Writer: endObject() not expected");
+
+	_buffer += '}';
+	_stack.pop_back();
+	endValue();
+}
+
+
+void Writer::startArray()
+{
+	beginValue();
+	_buffer += '[';
+	_stack.push_back('[');
+	_first = true;
+}
+
+
+void Writer::endArray()
+{
+	if (_stack.empty() || _stack.back() != '[') throw JSONException("Writer: endArray() not expected");
+
+	_buffer += ']';
+	_stack.pop_back();
+	endValue();
+}
+
+
+void Writer::key(const char* key, std::size_t length)
+{
+	if (_stack.empty() || _stack.back() != '{' || _haveKey) throw JSONException("Writer: key() not expected");
+
+	if (!_first) _buffer += ',';
+	formatString(key, length, _buffer);
+	_buffer += ':';
+	_haveKey = true;
+}
+
+
+void Writer::value(const char* value)
+{
+	this->value(value, std::strlen(value));
+}
+
+
+void Writer::value(const char* value, std::size_t length)
+{
+	beginValue();
+	formatString(value, length, _buffer);
+	endValue();
+}
+
+
+void Writer::value(int value)
+{
+	beginValue();
+	NumberFormatter::append(_buffer, value);
+	endValue();
+}
+
+
+void Writer::value(unsigned value)
+{
+	beginValue();
+	NumberFormatter::append(_buffer, value);
+	endValue();
+}
+
+
+#if defined(POCO_HAVE_INT64)
+
+
+void Writer::value(Int64 value)
+{
+	beginValue();
+	NumberFormatter::append(_buffer, value);
+	endValue();
+}
+
+
+void Writer::value(UInt64 value)
+{
+	beginValue();
+	NumberFormatter::append(_buffer, value);
+	endValue();
+}
+
+
+#endif
+
+
+void Writer::value(double value)
+{
+	beginValue();
+	if (FPEnvironment::isNaN(value) || FPEnvironment::isInfinite(value))
+		_buffer.append("null", 4);
+	else
+		NumberFormatter::append(_buffer, value);
+	endValue();
+}
+
+
+void Writer::value(bool value)
+{
+	beginValue();
+	if (value)
+		_buffer.append("true", 4);
+	else
+		_buffer.append("false", 5);
+	endValue();
+}
+
+
+void Writer::null()
+{
+	beginValue();
+	_buffer.append("null", 4);
+	endValue();
+}
+
+
+void Writer::reset()
+{
+	_stack.clear();
+	_first = true;
+	_haveKey = false;
+	_done = false;
+}
+
+
+void Writer::formatString(const char* value, std::size_t length, std::string& buffer)
+{
+	static const char HEX[] = "0123456789abcdef";
+
+	buffer += '"';
+	const char* p = value;
+	const char* end = value + length;
+	while (p < end)
+	{
+		const char* run = p;
+		while (p < end && !needsEscape(static_cast<unsigned char>(*p))) ++p;
+		if (p != run) buffer.append(run, p - run);
+		if (p == end) break;
+
+		unsigned char c = static_cast<unsigned char>(*p++);
+		const char* escape = ESCAPES[c];
+		if (escape)
+		{
+			buffer.append(escape);
+		}
+		else
+		{
+			char hex[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0x0F] };
+			buffer.append(hex, sizeof(hex));
+		}
+	}
+	buffer += '"';
+}
+
+
+void Writer::beginValue()
+{
+	if (_done) throw JSONException("Writer: document already complete");
+	if (_stack.empty())
+	{
+		// RFC 4627 requires an object or array at the top level,
+		// but we leave this to the application.
+		return;
+	}
+	if (_stack.back() == '{')
+	{
+		if (!_haveKey) throw JSONException("Writer: key() expected");
+		_haveKey = false;
+	}
+	else if (!_first)
+	{
+		_buffer += ',';
+	}
+}
+
+
+void Writer::endValue()
+{
+	_first = false;
+	if (_stack.empty()) _done = true;
+}
+
+
+} } // namespace Poco::JSON
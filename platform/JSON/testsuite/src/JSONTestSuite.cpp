@@ -12,6 +12,7 @@
 
 #include "JSONTestSuite.h"
 #include "JSONTest.h"
+#include "PullParserTest.h"
 
 
 CppUnit::Test* JSONTestSuite::suite()
@@ -19,6 +20,7 @@ CppUnit::Test* JSONTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("JSONTestSuite");
 
 	pSuite->addTest(JSONTest::suite());
+	pSuite->addTest(PullParserTest::suite());
 
 	return pSuite;
 }
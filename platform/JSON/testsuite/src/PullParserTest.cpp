@@ -0,0 +1,774 @@
+//
+// PullParserTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "PullParserTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/JSON/PullParser.h"
+#include "Poco/JSON/Document.h"
+#include "Poco/JSON/Writer.h"
+#include "Poco/JSON/Parser.h"
+#include "Poco/JSON/ParseHandler.h"
+#include "Poco/JSON/Stringifier.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/JSONException.h"
+#include "Poco/Path.h"
+#include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Environment.h"
+#include "Poco/Glob.h"
+#include <set>
+#include <sstream>
+#include <limits>
+
+
+using Poco::JSON::PullParser;
+using Poco::JSON::Document;
+using Poco::JSON::Writer;
+using Poco::JSON::Parser;
+using Poco::JSON::ParseHandler;
+using Poco::JSON::Stringifier;
+using Poco::JSON::Object;
+using Poco::JSON::Array;
+using Poco::JSON::JSONException;
+using Poco::Dynamic::Var;
+
+
+PullParserTest::PullParserTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+PullParserTest::~PullParserTest()
+{
+}
+
+
+void PullParserTest::testTokens()
+{
+	std::string json = "{ \"a\" : [ 1, -2, 3.5, true, false, null, \"str\" ], \"b\" : {}, \"c\" : [] }";
+	PullParser parser(json);
+	assert (parser.token() == PullParser::TOKEN_NONE);
+	assert (parser.next() == PullParser::TOKEN_START_OBJECT);
+	assert (parser.depth() == 1);
+	assert (parser.next() == PullParser::TOKEN_KEY);
+	assert (parser.getString() == "a");
+	assert (parser.next() == PullParser::TOKEN_START_ARRAY);
+	assert (parser.depth() == 2);
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.getInt64() == 1);
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.getInt64() == -2);
+	assert (parser.next() == PullParser::TOKEN_REAL);
+	assert (parser.getDouble() == 3.5);
+	assert (parser.next() == PullParser::TOKEN_TRUE);
+	assert (parser.getBool());
+	assert (parser.next() == PullParser::TOKEN_FALSE);
+	assert (!parser.getBool());
+	assert (parser.next() == PullParser::TOKEN_NULL);
+	assert (parser.next() == PullParser::TOKEN_STRING);
+	assert (parser.getString() == "str");
+	assert (parser.next() == PullParser::TOKEN_END_ARRAY);
+	assert (parser.next() == PullParser::TOKEN_KEY);
+	assert (parser.getString() == "b");
+	assert (parser.next() == PullParser::TOKEN_START_OBJECT);
+	assert (parser.next() == PullParser::TOKEN_END_OBJECT);
+	assert (parser.next() == PullParser::TOKEN_KEY);
+	assert (parser.getString() == "c");
+	assert (parser.next() == PullParser::TOKEN_START_ARRAY);
+	assert (parser.next() == PullParser::TOKEN_END_ARRAY);
+	assert (parser.next() == PullParser::TOKEN_END_OBJECT);
+	assert (parser.depth() == 0);
+	assert (parser.next() == PullParser::TOKEN_END);
+	assert (parser.next() == PullParser::TOKEN_END);
+	assert (parser.offset() == json.size());
+
+	std::string json2 = "[1]";
+	parser.reset(json2);
+	assert (parser.next() == PullParser::TOKEN_START_ARRAY);
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.next() == PullParser::TOKEN_END_ARRAY);
+	assert (parser.next() == PullParser::TOKEN_END);
+}
+
+
+void PullParserTest::testNumbers()
+{
+	std::string json = "[0, -0, 2147483648, 9223372036854775807, -9223372036854775808, 9223372036854775808, 18446744073709551615, 1e3, -1.25E-2, 0.5]";
+	PullParser parser(json);
+	assert (parser.next() == PullParser::TOKEN_START_ARRAY);
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.getInt64() == 0);
+	assert (parser.getUInt64() == 0);
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.getInt64() == 0);
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.getInt64() == 2147483648LL);
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.getInt64() == std::numeric_limits<Poco::Int64>::max());
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.getInt64() == std::numeric_limits<Poco::Int64>::min());
+	try
+	{
+		parser.getUInt64();
+		fail("negative value - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	assert (parser.next() == PullParser::TOKEN_UNSIGNED);
+	assert (parser.getUInt64() == 9223372036854775808ULL);
+	try
+	{
+		parser.getInt64();
+		fail("value too big - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	assert (parser.next() == PullParser::TOKEN_UNSIGNED);
+	assert (parser.getUInt64() == std::numeric_limits<Poco::UInt64>::max());
+	assert (parser.next() == PullParser::TOKEN_REAL);
+	assert (parser.getDouble() == 1000.0);
+	assert (parser.next() == PullParser::TOKEN_REAL);
+	assert (parser.getDouble() == -0.0125);
+	assert (parser.next() == PullParser::TOKEN_REAL);
+	assert (parser.getDouble() == 0.5);
+	assert (parser.next() == PullParser::TOKEN_END_ARRAY);
+
+	assert (!isValid("[18446744073709551616]"));
+	assert (!isValid("[-9223372036854775809]"));
+	assert (!isValid("[01]"));
+	assert (!isValid("[1.]"));
+	assert (!isValid("[.5]"));
+	assert (!isValid("[1e]"));
+	assert (!isValid("[-]"));
+	assert (!isValid("[+1]"));
+	assert (!isValid("[1e400]"));
+}
+
+
+void PullParserTest::testStrings()
+{
+	std::string json = "[\"\", \"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\", \"\\u0041\\u00e4\\u20ac\\ud834\\udd1e\", \"\xc3\xa4\xe2\x82\xac\xf0\x9d\x84\x9e\"]";
+	PullParser parser(json);
+	assert (parser.next() == PullParser::TOKEN_START_ARRAY);
+	assert (parser.next() == PullParser::TOKEN_STRING);
+	assert (parser.getString().empty());
+	assert (parser.next() == PullParser::TOKEN_STRING);
+	assert (parser.getString() == "a\"b\\c/d\b\f\n\r\t");
+	assert (parser.next() == PullParser::TOKEN_STRING);
+	assert (parser.getString() == "A\xc3\xa4\xe2\x82\xac\xf0\x9d\x84\x9e");
+	assert (parser.next() == PullParser::TOKEN_STRING);
+	assert (parser.getString() == "\xc3\xa4\xe2\x82\xac\xf0\x9d\x84\x9e");
+	assert (parser.next() == PullParser::TOKEN_END_ARRAY);
+
+	assert (!isValid("[\"abc]"));
+	assert (!isValid("[\"a\tb\"]"));
+	assert (!isValid("[\"\\x\"]"));
+	assert (!isValid("[\"\\u12\"]"));
+	assert (!isValid("[\"\\ud834\"]"));
+	assert (!isValid("[\"\\udd1e\"]"));
+	assert (!isValid("[\"\xc3\"]"));
+	assert (!isValid("[\"\xc0\xaf\"]"));
+	assert (!isValid("[\"\xed\xa0\x80\"]"));
+	assert (!isValid("[\"\xff\"]"));
+}
+
+
+void PullParserTest::testLongStrings()
+{
+	// Strings long enough to exercise the block-wise scanning,
+	// with special characters at all positions of a block.
+	for (int pos = 0; pos < 40; pos++)
+	{
+		std::string value(40, 'x');
+		value[pos] = '\n';
+		std::string json("[\"");
+		json += value.substr(0, pos);
+		json += "\\n";
+		json += value.substr(pos + 1);
+		json += "\"]";
+
+		PullParser parser(json);
+		assert (parser.next() == PullParser::TOKEN_START_ARRAY);
+		assert (parser.next() == PullParser::TOKEN_STRING);
+		assert (parser.getString() == value);
+
+		std::string utf8(value);
+		utf8.replace(pos, 1, "\xc3\xa4");
+		json = "[\"" + utf8 + "\"]";
+		parser.reset(json);
+		assert (parser.next() == PullParser::TOKEN_START_ARRAY);
+		assert (parser.next() == PullParser::TOKEN_STRING);
+		assert (parser.getString() == utf8);
+
+		std::string control(value);
+		control[pos] = '\x01';
+		assert (!isValid("[\"" + control + "\"]"));
+
+		std::string quoted(value);
+		quoted[pos] = '"';
+		assert (!isValid("[\"" + quoted + "\"]"));
+	}
+}
+
+
+void PullParserTest::testSkip()
+{
+	std::string json = "{ \"skip\" : { \"a\" : [1, 2, { \"b\" : [] }] }, \"keep\" : 42, \"skip2\" : \"x\" }";
+	PullParser parser(json);
+	assert (parser.next() == PullParser::TOKEN_START_OBJECT);
+	assert (parser.next() == PullParser::TOKEN_KEY);
+	assert (parser.getString() == "skip");
+	parser.skip();
+	assert (parser.token() == PullParser::TOKEN_END_OBJECT);
+	assert (parser.depth() == 1);
+	assert (parser.next() == PullParser::TOKEN_KEY);
+	assert (parser.getString() == "keep");
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.getInt64() == 42);
+	assert (parser.next() == PullParser::TOKEN_KEY);
+	parser.skip();
+	assert (parser.token() == PullParser::TOKEN_STRING);
+	assert (parser.next() == PullParser::TOKEN_END_OBJECT);
+	assert (parser.next() == PullParser::TOKEN_END);
+}
+
+
+void PullParserTest::testErrors()
+{
+	assert (isValid("{}"));
+	assert (isValid(" [ ] \r\n\t"));
+	assert (!isValid(""));
+	assert (!isValid("   "));
+	assert (!isValid("null"));
+	assert (!isValid("\"string\""));
+	assert (!isValid("{"));
+	assert (!isValid("[1,]"));
+	assert (!isValid("[,1]"));
+	assert (!isValid("[1 2]"));
+	assert (!isValid("{\"a\" 1}"));
+	assert (!isValid("{\"a\":1,}"));
+	assert (!isValid("{1:1}"));
+	assert (!isValid("{\"a\":1]"));
+	assert (!isValid("[1}"));
+	assert (!isValid("[]]"));
+	assert (!isValid("[] []"));
+	assert (!isValid("[tru]"));
+	assert (!isValid("[nul]"));
+	assert (!isValid("[truex]"));
+	assert (!isValid("[\"\\u0000\"]"));
+
+	PullParser parser;
+	std::string json("[\"\\u0000\"]");
+	parser.reset(json);
+	parser.setAllowNullByte(true);
+	assert (parser.next() == PullParser::TOKEN_START_ARRAY);
+	assert (parser.next() == PullParser::TOKEN_STRING);
+	assert (parser.getString() == std::string(1, '\0'));
+
+	json = "[1, x]";
+	parser.reset(json);
+	try
+	{
+		while (parser.next() != PullParser::TOKEN_END);
+		fail("invalid document - must throw");
+	}
+	catch (JSONException& exc)
+	{
+		assert (exc.message().find("offset 4") != std::string::npos);
+	}
+}
+
+
+void PullParserTest::testComments()
+{
+	std::string json = "// comment\n{ /* comment */ \"a\" /**/ : 1 // comment\n }";
+	assert (!isValid(json));
+
+	PullParser parser(json);
+	parser.setAllowComments(true);
+	assert (parser.next() == PullParser::TOKEN_START_OBJECT);
+	assert (parser.next() == PullParser::TOKEN_KEY);
+	assert (parser.next() == PullParser::TOKEN_INTEGER);
+	assert (parser.next() == PullParser::TOKEN_END_OBJECT);
+	assert (parser.next() == PullParser::TOKEN_END);
+
+	json = "[1 /* unterminated ]";
+	parser.reset(json);
+	try
+	{
+		while (parser.next() != PullParser::TOKEN_END);
+		fail("unterminated comment - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+}
+
+
+void PullParserTest::testDepth()
+{
+	std::string json = "[[[[]]]]";
+	PullParser parser(json);
+	parser.setDepth(4);
+	while (parser.next() != PullParser::TOKEN_END);
+
+	parser.reset(json);
+	parser.setDepth(3);
+	try
+	{
+		while (parser.next() != PullParser::TOKEN_END);
+		fail("maximum depth exceeded - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+}
+
+
+void PullParserTest::testHandler()
+{
+	std::string json = "{ \"name\" : \"Franky\", \"age\" : 33, \"height\" : 1.82, \"married\" : false, \"spouse\" : null, \"children\" : [ \"Jonas\", \"Ellen\" ], \"address\" : { \"city\" : \"Vienna\" } }";
+
+	Parser parser;
+	Var expected = parser.parse(json);
+	std::ostringstream expectedStream;
+	Stringifier::stringify(expected, expectedStream);
+
+	ParseHandler::Ptr pHandler = new ParseHandler;
+	PullParser pullParser(json);
+	pullParser.parse(*pHandler);
+	std::ostringstream resultStream;
+	Stringifier::stringify(pHandler->asVar(), resultStream);
+
+	assert (resultStream.str() == expectedStream.str());
+	assert (pHandler->asVar().extract<Object::Ptr>()->get("age").type() == typeid(int));
+}
+
+
+void PullParserTest::testValidJanssonFiles()
+{
+	Poco::Path pathPattern(getTestFilesPath("valid"));
+
+	std::set<std::string> paths;
+	Poco::Glob::glob(pathPattern, paths);
+
+	for (std::set<std::string>::iterator it = paths.begin(); it != paths.end(); ++it)
+	{
+		Poco::Path filePath(*it, "input");
+		if (filePath.isFile() && Poco::File(filePath).exists())
+		{
+			std::string json = readFile(filePath.toString());
+			Document doc;
+			try
+			{
+				doc.parse(json);
+			}
+			catch (Poco::Exception& exc)
+			{
+				fail(filePath.toString() + ": " + exc.displayText());
+			}
+
+			// The document must survive a round trip through the Writer.
+			std::string written;
+			Writer writer(written);
+			doc.write(writer);
+			assert (writer.done());
+			Document doc2;
+			doc2.parse(written);
+			std::string written2;
+			Writer writer2(written2);
+			doc2.write(writer2);
+			assert (written == written2);
+		}
+	}
+}
+
+
+void PullParserTest::testInvalidJanssonFiles()
+{
+	Poco::Path pathPattern(getTestFilesPath("invalid"));
+
+	std::set<std::string> paths;
+	Poco::Glob::glob(pathPattern, paths);
+
+	for (std::set<std::string>::iterator it = paths.begin(); it != paths.end(); ++it)
+	{
+		Poco::Path filePath(*it, "input");
+		if (filePath.isFile() && Poco::File(filePath).exists())
+		{
+			if (isValid(readFile(filePath.toString())))
+			{
+				fail(filePath.toString() + ": invalid document accepted");
+			}
+		}
+	}
+}
+
+
+void PullParserTest::testInvalidUnicodeJanssonFiles()
+{
+	Poco::Path pathPattern(getTestFilesPath("invalid-unicode"));
+
+	std::set<std::string> paths;
+	Poco::Glob::glob(pathPattern, paths);
+
+	for (std::set<std::string>::iterator it = paths.begin(); it != paths.end(); ++it)
+	{
+		Poco::Path filePath(*it, "input");
+		if (filePath.isFile() && Poco::File(filePath).exists())
+		{
+			if (isValid(readFile(filePath.toString())))
+			{
+				fail(filePath.toString() + ": invalid document accepted");
+			}
+		}
+	}
+}
+
+
+void PullParserTest::testDocument()
+{
+	Document doc;
+	assert (doc.empty());
+	assert (!doc.root().valid());
+
+	doc.parse("{ \"name\" : \"Franky\", \"age\" : 33, \"height\" : 1.82, \"married\" : false, \"spouse\" : null, \"children\" : [ \"Jonas\", \"Ellen\", [ 1, 2 ] ], \"address\" : { \"city\" : \"Vienna\" } }");
+	Document::Value root = doc.root();
+	assert (root.valid());
+	assert (root.isObject());
+	assert (root.size() == 7);
+	assert (root["name"].getString() == "Franky");
+	assert (root["name"].size() == 6);
+	assert (root["age"].getInt64() == 33);
+	assert (root["age"].getUInt64() == 33);
+	assert (root["age"].getDouble() == 33.0);
+	assert (root["height"].getDouble() == 1.82);
+	assert (!root["married"].getBool());
+	assert (root["spouse"].isNull());
+	assert (root.has("children"));
+	assert (!root.has("parents"));
+	assert (!root.get("parents").valid());
+
+	Document::Value children = root["children"];
+	assert (children.isArray());
+	assert (children.size() == 3);
+	assert (children[0].getString() == "Jonas");
+	assert (children[1].getString() == "Ellen");
+	assert (children[2].size() == 2);
+	assert (children[2][1].getInt64() == 2);
+	assert (children.key() == "children");
+
+	assert (root["address"]["city"].getString() == "Vienna");
+
+	try
+	{
+		root["parents"];
+		fail("no such member - must throw");
+	}
+	catch (Poco::NotFoundException&)
+	{
+	}
+
+	try
+	{
+		children[3];
+		fail("index out of range - must throw");
+	}
+	catch (Poco::RangeException&)
+	{
+	}
+
+	try
+	{
+		root["age"].getString();
+		fail("not a string - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+
+	doc.parse("[]");
+	assert (doc.root().isArray());
+	assert (doc.root().size() == 0);
+	assert (!doc.root().firstChild().valid());
+
+	try
+	{
+		doc.parse("[1, 2");
+		fail("invalid document - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	assert (doc.empty());
+}
+
+
+void PullParserTest::testDocumentOrder()
+{
+	Document doc;
+	doc.parse("{ \"z\" : 1, \"a\" : 2, \"m\" : { \"y\" : [], \"b\" : {} }, \"c\" : 3 }");
+
+	std::string keys;
+	for (Document::Value member = doc.root().firstChild(); member.valid(); member = member.nextSibling())
+	{
+		keys += member.key();
+	}
+	assert (keys == "zamc");
+	assert (doc.root()[2].key() == "m");
+	assert (doc.root()[3].getInt64() == 3);
+
+	std::string json;
+	Writer writer(json);
+	doc.write(writer);
+	assert (json == "{\"z\":1,\"a\":2,\"m\":{\"y\":[],\"b\":{}},\"c\":3}");
+}
+
+
+void PullParserTest::testDocumentToVar()
+{
+	Document doc;
+	doc.parse("{ \"z\" : 1, \"a\" : [ true, 9223372036854775808, 2.5, \"x\", null ] }");
+	Var result = doc.root().toVar();
+	assert (result.type() == typeid(Object::Ptr));
+
+	Object::Ptr pObject = result.extract<Object::Ptr>();
+	assert (pObject->get("z").type() == typeid(int));
+	assert (pObject->getValue<int>("z") == 1);
+	Array::Ptr pArray = pObject->getArray("a");
+	assert (pArray->size() == 5);
+	assert (pArray->get(0).extract<bool>());
+	assert (pArray->get(1).extract<Poco::UInt64>() == 9223372036854775808ULL);
+	assert (pArray->get(2).extract<double>() == 2.5);
+	assert (pArray->get(3).extract<std::string>() == "x");
+	assert (pArray->isNull(4));
+
+	std::ostringstream ostr;
+	Stringifier::condense(result, ostr);
+	assert (ostr.str() == "{\"z\":1,\"a\":[true,9223372036854775808,2.5,\"x\",null]}");
+}
+
+
+void PullParserTest::testWriter()
+{
+	std::string json;
+	Writer writer(json);
+	writer.startObject();
+	writer.key("name");
+	writer.value("Franky");
+	writer.key("age");
+	writer.value(33);
+	writer.key("big");
+	writer.value(std::numeric_limits<Poco::UInt64>::max());
+	writer.key("negative");
+	writer.value(std::numeric_limits<Poco::Int64>::min());
+	writer.key("height");
+	writer.value(1.5);
+	writer.key("nan");
+	writer.value(std::numeric_limits<double>::quiet_NaN());
+	writer.key("married");
+	writer.value(false);
+	writer.key("spouse");
+	writer.null();
+	writer.key("children");
+	writer.startArray();
+	writer.value(std::string("Jonas"));
+	writer.startArray();
+	writer.endArray();
+	writer.startObject();
+	writer.endObject();
+	writer.endArray();
+	writer.key("esc\"ape");
+	writer.value(std::string("\\/\b\f\n\r\t\x01\x1f\xc3\xa4", 11));
+	writer.endObject();
+	assert (writer.done());
+
+	assert (json == "{\"name\":\"Franky\",\"age\":33,\"big\":18446744073709551615,\"negative\":-9223372036854775808,"
+		"\"height\":1.5,\"nan\":null,\"married\":false,\"spouse\":null,\"children\":[\"Jonas\",[],{}],"
+		"\"esc\\\"ape\":\"\\\\\\/\\b\\f\\n\\r\\t\\u0001\\u001f\xc3\xa4\"}");
+
+	std::ostringstream ostr;
+	Stringifier::formatString("\\/\b\f\n\r\t\"", ostr);
+	std::string formatted;
+	Writer::formatString("\\/\b\f\n\r\t\"", 8, formatted);
+	assert (formatted == ostr.str());
+
+	writer.reset();
+	json.clear();
+	writer.startArray();
+	writer.endArray();
+	assert (json == "[]");
+}
+
+
+void PullParserTest::testWriterErrors()
+{
+	std::string json;
+	Writer writer(json);
+	writer.startObject();
+	try
+	{
+		writer.value(1);
+		fail("key expected - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	writer.key("a");
+	try
+	{
+		writer.key("b");
+		fail("value expected - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	try
+	{
+		writer.endObject();
+		fail("value expected - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	writer.value(1);
+	try
+	{
+		writer.endArray();
+		fail("mismatched end - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	writer.endObject();
+	try
+	{
+		writer.startArray();
+		fail("document complete - must throw");
+	}
+	catch (JSONException&)
+	{
+	}
+	assert (json == "{\"a\":1}");
+}
+
+
+void PullParserTest::testRoundTrip()
+{
+	std::string json = "{\"a\":[1,-2,3.25,true,false,null,\"\\\"x\\\"\"],\"b\":{\"c\":{}},\"d\":[]}";
+
+	// Copy all tokens from a PullParser to a Writer.
+	std::string result;
+	Writer writer(result);
+	PullParser parser(json);
+	PullParser::Token token;
+	while ((token = parser.next()) != PullParser::TOKEN_END)
+	{
+		switch (token)
+		{
+		case PullParser::TOKEN_START_OBJECT: writer.startObject(); break;
+		case PullParser::TOKEN_END_OBJECT: writer.endObject(); break;
+		case PullParser::TOKEN_START_ARRAY: writer.startArray(); break;
+		case PullParser::TOKEN_END_ARRAY: writer.endArray(); break;
+		case PullParser::TOKEN_KEY: writer.key(parser.getString()); break;
+		case PullParser::TOKEN_STRING: writer.value(parser.getString()); break;
+		case PullParser::TOKEN_INTEGER: writer.value(parser.getInt64()); break;
+		case PullParser::TOKEN_UNSIGNED: writer.value(parser.getUInt64()); break;
+		case PullParser::TOKEN_REAL: writer.value(parser.getDouble()); break;
+		case PullParser::TOKEN_TRUE: writer.value(true); break;
+		case PullParser::TOKEN_FALSE: writer.value(false); break;
+		case PullParser::TOKEN_NULL: writer.null(); break;
+		default: break;
+		}
+	}
+	assert (result == json);
+}
+
+
+void PullParserTest::setUp()
+{
+}
+
+
+void PullParserTest::tearDown()
+{
+}
+
+
+std::string PullParserTest::getTestFilesPath(const std::string& type)
+{
+	std::string dir("data/" + type + '/');
+	if (!Poco::File(dir).exists())
+	{
+		dir = Poco::Environment::get("POCO_BASE") + "/JSON/testsuite/data/" + type + '/';
+		if (!Poco::File(dir).exists())
+			throw Poco::NotFoundException("cannot locate directory containing JSON test files");
+	}
+	return dir + '*';
+}
+
+
+std::string PullParserTest::readFile(const std::string& path)
+{
+	Poco::FileInputStream istr(path);
+	std::string content;
+	Poco::StreamCopier::copyToString(istr, content);
+	return content;
+}
+
+
+bool PullParserTest::isValid(const std::string& json)
+{
+	PullParser parser(json);
+	parser.setAllowNullByte(false);
+	try
+	{
+		while (parser.next() != PullParser::TOKEN_END);
+		return true;
+	}
+	catch (JSONException&)
+	{
+		return false;
+	}
+}
+
+
+CppUnit::Test* PullParserTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PullParserTest");
+
+	CppUnit_addTest(pSuite, PullParserTest, testTokens);
+	CppUnit_addTest(pSuite, PullParserTest, testNumbers);
+	CppUnit_addTest(pSuite, PullParserTest, testStrings);
+	CppUnit_addTest(pSuite, PullParserTest, testLongStrings);
+	CppUnit_addTest(pSuite, PullParserTest, testSkip);
+	CppUnit_addTest(pSuite, PullParserTest, testErrors);
+	CppUnit_addTest(pSuite, PullParserTest, testComments);
+	CppUnit_addTest(pSuite, PullParserTest, testDepth);
+	CppUnit_addTest(pSuite, PullParserTest, testHandler);
+	CppUnit_addTest(pSuite, PullParserTest, testValidJanssonFiles);
+	CppUnit_addTest(pSuite, PullParserTest, testInvalidJanssonFiles);
+	CppUnit_addTest(pSuite, PullParserTest, testInvalidUnicodeJanssonFiles);
+	CppUnit_addTest(pSuite, PullParserTest, testDocument);
+	CppUnit_addTest(pSuite, PullParserTest, testDocumentOrder);
+	CppUnit_addTest(pSuite, PullParserTest, testDocumentToVar);
+	CppUnit_addTest(pSuite, PullParserTest, testWriter);
+	CppUnit_addTest(pSuite, PullParserTest, testWriterErrors);
+	CppUnit_addTest(pSuite, PullParserTest, testRoundTrip);
+
+	return pSuite;
+}
@@ -0,0 +1,60 @@
+//
+// PullParserTest.h
+//
+// $Id$
+//
+// Definition of the PullParserTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef PullParserTest_INCLUDED
+#define PullParserTest_INCLUDED
+
+
+#include "Poco/JSON/JSON.h"
+#include "CppUnit/TestCase.h"
+
+
+class PullParserTest: public CppUnit::TestCase
+{
+public:
+	PullParserTest(const std::string& name);
+	~PullParserTest();
+
+	void testTokens();
+	void testNumbers();
+	void testStrings();
+	void testLongStrings();
+	void testSkip();
+	void testErrors();
+	void testComments();
+	void testDepth();
+	void testHandler();
+	void testValidJanssonFiles();
+	void testInvalidJanssonFiles();
+	void testInvalidUnicodeJanssonFiles();
+	void testDocument();
+	void testDocumentOrder();
+	void testDocumentToVar();
+	void testWriter();
+	void testWriterErrors();
+	void testRoundTrip();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	static std::string getTestFilesPath(const std::string& type);
+	static std::string readFile(const std::string& path);
+	static bool isValid(const std::string& json);
+};
+
+
+#endif // PullParserTest_INCLUDED
@@ -156,7 +156,7 @@ protected:
 		/// Writes the authentication scheme and information for
 		/// this request to the given header.
 
-private:
+protected:
 	enum Limits
 	{
 		MAX_METHOD_LENGTH  = 32,
@@ -164,6 +164,7 @@ private:
 		MAX_VERSION_LENGTH = 8
 	};
 	
+private:
 	std::string _method;
 	std::string _uri;
 	
@@ -0,0 +1,128 @@
+//
+// HTTPRequestArena.h
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPRequestArena
+//
+// Definition of the HTTPRequestArena class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPRequestArena_INCLUDED
+#define Net_HTTPRequestArena_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include <vector>
+#include <cstddef>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HTTPRequestArena
+	/// A simple block allocator for data that only needs to
+	/// live as long as a single HTTP request, like the
+	/// raw request header lines.
+	///
+	/// Memory is allocated from fixed-size blocks by simply
+	/// advancing a pointer. Individual allocations cannot be
+	/// freed. Instead, all memory is released at once by calling
+	/// reset(), which keeps the first block for reuse by
+	/// the next request. Allocations larger than the block size
+	/// get a block of their own.
+	///
+	/// HTTPServerSession keeps a HTTPRequestArena for each
+	/// connection, so that for typical requests,
+	/// no memory needs to be allocated from the heap at all
+	/// for parsing the request header.
+	///
+	/// This class is not thread-safe.
+{
+public:
+	enum
+	{
+		DEFAULT_BLOCK_SIZE = 4096
+	};
+
+	explicit HTTPRequestArena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+		/// Creates the HTTPRequestArena, using the given block size.
+		/// The first block is allocated when it's needed.
+
+	~HTTPRequestArena();
+		/// Destroys the HTTPRequestArena and releases all memory.
+
+	char* allocate(std::size_t size);
+		/// Allocates size bytes from the arena. The returned memory
+		/// is not aligned and thus only suitable for character data.
+
+	char* copy(const char* data, std::size_t size);
+		/// Allocates size bytes from the arena and copies
+		/// the given data into it.
+
+	void reset();
+		/// Releases all memory allocated from the arena.
+		/// The first block is kept for reuse.
+
+	std::size_t used() const;
+		/// Returns the number of bytes allocated from
+		/// the arena since the last reset().
+
+	std::size_t blockSize() const;
+		/// Returns the block size.
+
+private:
+	HTTPRequestArena(const HTTPRequestArena&);
+	HTTPRequestArena& operator = (const HTTPRequestArena&);
+
+	char* allocateBlock(std::size_t size);
+
+	std::size_t _blockSize;
+	std::vector<char*> _blocks;
+	char* _pCurrent;
+	char* _pEnd;
+	std::size_t _used;
+};
+
+
+//
+// inlines
+//
+inline char* HTTPRequestArena::allocate(std::size_t size)
+{
+	_used += size;
+	if (static_cast<std::size_t>(_pEnd - _pCurrent) >= size)
+	{
+		char* p = _pCurrent;
+		_pCurrent += size;
+		return p;
+	}
+	else return allocateBlock(size);
+}
+
+
+inline std::size_t HTTPRequestArena::used() const
+{
+	return _used;
+}
+
+
+inline std::size_t HTTPRequestArena::blockSize() const
+{
+	return _blockSize;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPRequestArena_INCLUDED
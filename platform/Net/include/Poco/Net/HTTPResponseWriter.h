@@ -0,0 +1,201 @@
+//
+// HTTPResponseWriter.h
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPResponseWriter
+//
+// Definition of the HTTPResponseWriter class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPResponseWriter_INCLUDED
+#define Net_HTTPResponseWriter_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/BufferedStreamBuf.h"
+#include "Poco/NullStream.h"
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstddef>
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTPServerResponse;
+class HTTPResponseWriter;
+
+
+class Net_API HTTPResponseWriterBuf: public Poco::BufferedStreamBuf
+	/// The stream buffer used by HTTPResponseWriter.
+	/// Passes everything written to it to
+	/// HTTPResponseWriter::write().
+{
+public:
+	HTTPResponseWriterBuf(HTTPResponseWriter& writer);
+	~HTTPResponseWriterBuf();
+
+protected:
+	int writeToDevice(const char* buffer, std::streamsize length);
+
+private:
+	HTTPResponseWriter& _writer;
+};
+
+
+class Net_API HTTPResponseWriter
+	/// HTTPResponseWriter collects the body of a HTTP response
+	/// that consists of static content (e.g., the markup of a
+	/// server page) mixed with dynamically generated content.
+	///
+	/// Static content is passed to writeStatic() and is never
+	/// copied. Only a reference to it is kept, so static data
+	/// must stay valid until the writer has been closed.
+	/// Dynamic content written to stream() or passed to write()
+	/// is appended to an internal buffer. The response body
+	/// is kept as a list of segments, each referring either
+	/// to static data or to a range in the internal buffer.
+	///
+	/// As long as the total size of the response body does not
+	/// exceed the buffer size given to the constructor, nothing
+	/// is sent. When the writer is closed, the Content-Length
+	/// header is set and the response body is sent
+	/// with a single pass over the segment list.
+	/// If the response body grows larger than the buffer size,
+	/// the response is sent using chunked transfer encoding
+	/// (or, for HTTP/1.0 clients, without Content-Length
+	/// and with a persistent connection disabled), and
+	/// everything written afterwards is passed through
+	/// directly.
+	///
+	/// If the response has already been sent when the writer
+	/// is closed (e.g., due to a call to HTTPServerResponse::redirect()),
+	/// any buffered content is discarded.
+	///
+	/// HTTPResponseWriter is used by request handlers generated
+	/// by the PageCompiler.
+{
+public:
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 16384
+	};
+
+	static const std::size_t UNLIMITED_BUFFER_SIZE;
+		/// Buffer size for collecting the entire response body,
+		/// regardless of its size.
+
+	HTTPResponseWriter(HTTPServerResponse& response, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates the HTTPResponseWriter for the given response.
+		///
+		/// If bufferSize is 0, the response is sent as soon
+		/// as the first data is written to the writer.
+
+	explicit HTTPResponseWriter(std::ostream& ostr);
+		/// Creates a HTTPResponseWriter that passes everything
+		/// directly to the given stream, which must
+		/// stay valid until the writer has been closed.
+
+	~HTTPResponseWriter();
+		/// Destroys the HTTPResponseWriter.
+		///
+		/// The destructor does not send anything. Data that has
+		/// not been sent by calling close() is discarded.
+
+	void writeStatic(const char* data, std::size_t length);
+		/// Appends length bytes of static data to the response body.
+		///
+		/// The data is not copied and must stay valid until
+		/// the writer has been closed.
+
+	void write(const char* data, std::size_t length);
+		/// Appends a copy of the given data to the response body.
+
+	std::ostream& stream();
+		/// Returns an output stream for writing dynamic
+		/// content to the response body.
+
+	void close();
+		/// Sends any data not sent yet. If the response
+		/// has not been sent yet, also sets the Content-Length
+		/// header, unless the response is already set up
+		/// for chunked transfer encoding.
+		///
+		/// Nothing must be written to the writer after
+		/// it has been closed.
+
+	std::size_t size() const;
+		/// Returns the total number of bytes written to the writer.
+
+	bool buffering() const;
+		/// Returns true if the writer still collects the
+		/// response body, or false if it passes all data
+		/// directly to the response stream.
+
+protected:
+	struct Segment
+	{
+		const char* data;
+			/// Static data, or null if the segment refers
+			/// to the internal buffer.
+		std::size_t offset;
+		std::size_t length;
+	};
+
+	void startStreaming();
+	void writeSegments();
+
+private:
+	HTTPResponseWriter();
+	HTTPResponseWriter(const HTTPResponseWriter&);
+	HTTPResponseWriter& operator = (const HTTPResponseWriter&);
+
+	HTTPServerResponse* _pResponse;
+	std::ostream* _pOstr;
+	std::size_t _bufferSize;
+	std::size_t _size;
+	std::vector<Segment> _segments;
+	std::string _buffer;
+	bool _closed;
+	HTTPResponseWriterBuf _buf;
+	std::ostream _stream;
+	Poco::NullOutputStream _nullStream;
+};
+
+
+//
+// inlines
+//
+inline std::ostream& HTTPResponseWriter::stream()
+{
+	return _stream;
+}
+
+
+inline std::size_t HTTPResponseWriter::size() const
+{
+	return _size;
+}
+
+
+inline bool HTTPResponseWriter::buffering() const
+{
+	return _pOstr == 0;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPResponseWriter_INCLUDED
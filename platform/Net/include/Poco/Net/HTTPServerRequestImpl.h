@@ -26,6 +26,7 @@
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/AutoPtr.h"
 #include <istream>
+#include <vector>
 
 
 namespace Poco {
@@ -82,7 +83,38 @@ public:
 		/// Returns the underlying socket after detaching
 		/// it from the server session.
 
+	struct HeaderField
+		/// A request header field, as received from the client.
+	{
+		const char* name;
+		std::size_t nameLength;
+		const char* value;
+		std::size_t valueLength;
+	};
+
+	typedef std::vector<HeaderField> HeaderFields;
+
+	const HeaderFields& headerFields() const;
+		/// Returns all request header fields in the order they
+		/// have been received. Names and values refer to the
+		/// request arena of the server session and are valid until
+		/// the HTTPServerRequestImpl object is destroyed.
+		///
+		/// In contrast to the MessageHeader interface, header fields
+		/// obtained in this way do not reflect any changes made to
+		/// the request header.
+
+	bool findHeaderField(const std::string& name, const char*& value, std::size_t& length) const;
+		/// Looks up the (first) request header field with the given
+		/// name (case-insensitive) in the fields returned by headerFields().
+		/// If found, returns true and sets value and length accordingly.
+		/// Otherwise, returns false.
+
 protected:
+	void readHeader();
+		/// Reads and parses the request line and the header
+		/// directly from the session buffer.
+
 	static const std::string EXPECT;
 	
 private:
@@ -92,6 +124,7 @@ private:
 	Poco::AutoPtr<HTTPServerParams> _pParams;
 	SocketAddress                   _clientAddress;
 	SocketAddress                   _serverAddress;
+	HeaderFields                    _fields;
 };
 
 
@@ -130,6 +163,12 @@ inline HTTPServerResponse& HTTPServerRequestImpl::response() const
 }
 
 
+inline const HTTPServerRequestImpl::HeaderFields& HTTPServerRequestImpl::headerFields() const
+{
+	return _fields;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -78,6 +78,31 @@ public:
 		/// cannot be found, or an OpenFileException if
 		/// the file cannot be opened.
 		
+	virtual void sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length, const std::string& mediaType);
+		/// Sends the response header to the client, followed
+		/// by length bytes of the given file, starting at offset.
+		///
+		/// The Content-Length header of the response is set to
+		/// length and chunked transfer encoding is disabled.
+		/// Unlike sendFile(path, mediaType), the Last-Modified
+		/// header is not set.
+		///
+		/// The default implementation copies the file content
+		/// to the stream returned by send(). HTTPServerResponseImpl
+		/// overrides it to send the file content with the sendfile()
+		/// system call, without copying it to user space, if
+		/// supported by the platform and the connection is not
+		/// secure. See StreamSocket::sendFile() for details.
+		///
+		/// Throws an IOException if the file is shorter than
+		/// offset + length.
+		///
+		/// Must not be called after send(), sendBuffer() 
+		/// or redirect() has been called.
+		///
+		/// Throws an OpenFileException if the file
+		/// cannot be opened.
+
 	virtual void sendBuffer(const void* pBuffer, std::size_t length) = 0;
 		/// Sends the response header to the client, followed
 		/// by the contents of the given buffer.
@@ -76,6 +76,26 @@ public:
 		/// cannot be found, or an OpenFileException if
 		/// the file cannot be opened.
 		
+	void sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length, const std::string& mediaType);
+		/// Sends the response header to the client, followed
+		/// by length bytes of the given file, starting at offset.
+		///
+		/// The Content-Length header of the response is set to
+		/// length and chunked transfer encoding is disabled.
+		/// Unlike sendFile(path, mediaType), the Last-Modified
+		/// header is not set.
+		///
+		/// If supported by the platform and the connection is not
+		/// secure, the file content is sent with the sendfile()
+		/// system call, without copying it to user space.
+		/// See StreamSocket::sendFile() for details.
+		///
+		/// Must not be called after send(), sendBuffer() 
+		/// or redirect() has been called.
+		///
+		/// Throws an OpenFileException if the file
+		/// cannot be opened.
+
 	void sendBuffer(const void* pBuffer, std::size_t length);
 		/// Sends the response header to the client, followed
 		/// by the contents of the given buffer.
@@ -25,6 +25,7 @@
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Net/HTTPServerSession.h"
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestArena.h"
 #include "Poco/Timespan.h"
 
 
@@ -55,11 +56,27 @@ public:
 		
 	SocketAddress serverAddress();
 		/// Returns the server's address.
-		
+
+	bool readHeaderLine(const char*& line, std::size_t& length, std::size_t maxLength);
+		/// Reads the next line of the request header and copies
+		/// it, without the terminating CRLF or LF, into the
+		/// session's request arena. Returns false if the end of
+		/// the stream has been reached before any character
+		/// could be read.
+		///
+		/// Throws a MessageException if the line is longer than
+		/// maxLength characters.
+
+	HTTPRequestArena& arena();
+		/// Returns the arena holding the header
+		/// of the current request.
+
 private:
-	bool           _firstRequest;
-	Poco::Timespan _keepAliveTimeout;
-	int            _maxKeepAliveRequests;
+	bool             _firstRequest;
+	Poco::Timespan   _keepAliveTimeout;
+	int              _maxKeepAliveRequests;
+	HTTPRequestArena _arena;
+	std::string      _line;
 };
 
 
@@ -72,6 +89,12 @@ inline bool HTTPServerSession::canKeepAlive() const
 }
 
 
+inline HTTPRequestArena& HTTPServerSession::arena()
+{
+	return _arena;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -148,6 +148,15 @@ protected:
 	int buffered() const;
 		/// Returns the number of bytes in the buffer.
 
+	const char* bufferedData() const;
+		/// Returns a pointer to the data in the buffer that
+		/// has not been read yet. The number of bytes available
+		/// is given by buffered().
+
+	void consume(int length);
+		/// Removes the given number of bytes, which must not be
+		/// more than buffered(), from the buffer.
+
 	void refill();
 		/// Refills the internal buffer.
 		
@@ -226,6 +235,20 @@ inline int HTTPSession::buffered() const
 }
 
 
+inline const char* HTTPSession::bufferedData() const
+{
+	return _pCurrent;
+}
+
+
+inline void HTTPSession::consume(int length)
+{
+	poco_assert_dbg (length >= 0 && length <= buffered());
+
+	_pCurrent += length;
+}
+
+
 inline const Poco::Any& HTTPSession::sessionData() const
 {
 	return _data;
@@ -147,7 +147,7 @@ public:
 		/// appended to result, enclosed in double-quotes.
 		/// Otherwise, the value is appended to result as-is.
 		
-private:
+protected:
 	enum Limits
 		/// Limits for basic sanity checks when reading a header
 	{
@@ -156,6 +156,7 @@ private:
 		DFL_FIELD_LIMIT  = 100
 	};
 	
+private:
 	int _fieldLimit;
 };
 
@@ -28,6 +28,11 @@
 
 
 namespace Poco {
+
+
+class FileInputStream;
+
+
 namespace Net {
 
 
@@ -136,6 +141,30 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 	
+	virtual Poco::UInt64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends count bytes of the given file, starting at
+		/// the given offset, through the socket. Blocks until
+		/// all bytes have been sent, or the end of the file
+		/// has been reached.
+		///
+		/// On Linux, the file is sent with the sendfile() system
+		/// call, so its contents never need to be copied to user space.
+		/// On other platforms, and for secure sockets, the file
+		/// is read into a buffer and sent with sendBytes().
+		///
+		/// Returns the number of bytes sent, which will only
+		/// be less than count if the file is shorter than
+		/// offset + count. If the socket is non-blocking and
+		/// the send buffer is full, waits until the socket
+		/// becomes writable again.
+		///
+		/// Throws a TimeoutException if a send timeout has
+		/// been set and the socket does not become writable
+		/// within that interval.
+		///
+		/// The stream position of istr is undefined after
+		/// this method returns.
+
 	virtual int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
@@ -401,6 +430,10 @@ protected:
 	void reset(poco_socket_t fd = POCO_INVALID_SOCKET);
 		/// Allows subclasses to set the socket manually, iff no valid socket is set yet.
 
+	Poco::UInt64 sendFileBuffered(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Implements sendFile() by reading the file into a buffer
+		/// and sending the buffer with sendBytes().
+
 	static int lastError();
 		/// Returns the last error code.
 
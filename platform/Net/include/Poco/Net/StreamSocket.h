@@ -122,6 +122,27 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 
+	Poco::UInt64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends count bytes of the given file, starting at the
+		/// given offset, through the socket.
+		///
+		/// Where supported (currently Linux), the file is sent
+		/// with the sendfile() system call, without copying
+		/// its contents to user space. Otherwise, or if the socket
+		/// is secure, the file is read into a buffer and sent with
+		/// sendBytes().
+		///
+		/// Returns the number of bytes sent, which will only be less
+		/// than count if the file is shorter than offset + count.
+		/// If the socket is non-blocking and the send buffer is full,
+		/// waits until the socket becomes writable again.
+		///
+		/// Throws a TimeoutException if a send timeout has been set
+		/// and the socket does not become writable within that interval.
+		///
+		/// The stream position of istr is undefined after this
+		/// method returns.
+
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
@@ -42,6 +42,9 @@ public:
 		
 	virtual int receiveBytes(void* buffer, int length, int flags);
 		/// Receives a WebSocket protocol frame.
+
+	virtual Poco::UInt64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends the file in WebSocket protocol frames.
 		
 	virtual SocketImpl* acceptConnection(SocketAddress& clientAddr);
 	virtual void connect(const SocketAddress& address);
@@ -0,0 +1,97 @@
+//
+// HTTPRequestArena.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPRequestArena
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPRequestArena.h"
+#include "Poco/Bugcheck.h"
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTPRequestArena::HTTPRequestArena(std::size_t blockSize):
+	_blockSize(blockSize),
+	_pCurrent(0),
+	_pEnd(0),
+	_used(0)
+{
+	poco_assert (blockSize > 0);
+}
+
+
+HTTPRequestArena::~HTTPRequestArena()
+{
+	for (std::vector<char*>::iterator it = _blocks.begin(); it != _blocks.end(); ++it)
+	{
+		delete [] *it;
+	}
+}
+
+
+char* HTTPRequestArena::copy(const char* data, std::size_t size)
+{
+	char* p = allocate(size);
+	if (size > 0) std::memcpy(p, data, size);
+	return p;
+}
+
+
+void HTTPRequestArena::reset()
+{
+	if (_blocks.empty()) return;
+
+	for (std::vector<char*>::iterator it = _blocks.begin() + 1; it != _blocks.end(); ++it)
+	{
+		delete [] *it;
+	}
+	_blocks.resize(1);
+	_pCurrent = _blocks[0];
+	_pEnd = _pCurrent + _blockSize;
+	_used = 0;
+}
+
+
+char* HTTPRequestArena::allocateBlock(std::size_t size)
+{
+	if (size > _blockSize)
+	{
+		// Large allocations get a block of their own. The current
+		// block stays in use for subsequent small allocations. The
+		// first block must always have the regular block size,
+		// so allocate it in any case.
+		if (_blocks.empty())
+		{
+			_blocks.push_back(new char[_blockSize]);
+			_pCurrent = _blocks.back();
+			_pEnd = _pCurrent + _blockSize;
+		}
+		char* pBlock = new char[size];
+		_blocks.push_back(pBlock);
+		return pBlock;
+	}
+	else
+	{
+		char* pBlock = new char[_blockSize];
+		_blocks.push_back(pBlock);
+		_pCurrent = pBlock + size;
+		_pEnd = pBlock + _blockSize;
+		return pBlock;
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,207 @@
+//
+// HTTPResponseWriter.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPResponseWriter
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPResponseWriter.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Bugcheck.h"
+#include <limits>
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// HTTPResponseWriterBuf
+//
+
+
+HTTPResponseWriterBuf::HTTPResponseWriterBuf(HTTPResponseWriter& writer):
+	BufferedStreamBuf(512, std::ios::out),
+	_writer(writer)
+{
+}
+
+
+HTTPResponseWriterBuf::~HTTPResponseWriterBuf()
+{
+}
+
+
+int HTTPResponseWriterBuf::writeToDevice(const char* buffer, std::streamsize length)
+{
+	_writer.write(buffer, static_cast<std::size_t>(length));
+	return static_cast<int>(length);
+}
+
+
+//
+// HTTPResponseWriter
+//
+
+
+const std::size_t HTTPResponseWriter::UNLIMITED_BUFFER_SIZE = std::numeric_limits<std::size_t>::max();
+
+
+HTTPResponseWriter::HTTPResponseWriter(HTTPServerResponse& response, std::size_t bufferSize):
+	_pResponse(&response),
+	_pOstr(0),
+	_bufferSize(bufferSize),
+	_size(0),
+	_closed(false),
+	_buf(*this),
+	_stream(&_buf)
+{
+	if (_bufferSize != UNLIMITED_BUFFER_SIZE && _bufferSize > 0)
+	{
+		_buffer.reserve(_bufferSize);
+	}
+}
+
+
+HTTPResponseWriter::HTTPResponseWriter(std::ostream& ostr):
+	_pResponse(0),
+	_pOstr(&ostr),
+	_bufferSize(0),
+	_size(0),
+	_closed(false),
+	_buf(*this),
+	_stream(&_buf)
+{
+}
+
+
+HTTPResponseWriter::~HTTPResponseWriter()
+{
+}
+
+
+void HTTPResponseWriter::writeStatic(const char* data, std::size_t length)
+{
+	if (length == 0) return;
+
+	_buf.sync();
+	_size += length;
+	if (_pOstr)
+	{
+		_pOstr->write(data, static_cast<std::streamsize>(length));
+	}
+	else
+	{
+		Segment segment;
+		segment.data = data;
+		segment.offset = 0;
+		segment.length = length;
+		_segments.push_back(segment);
+		if (_size > _bufferSize) startStreaming();
+	}
+}
+
+
+void HTTPResponseWriter::write(const char* data, std::size_t length)
+{
+	if (length == 0) return;
+
+	_size += length;
+	if (_pOstr)
+	{
+		_pOstr->write(data, static_cast<std::streamsize>(length));
+	}
+	else
+	{
+		if (!_segments.empty() && _segments.back().data == 0)
+		{
+			_segments.back().length += length;
+		}
+		else
+		{
+			Segment segment;
+			segment.data = 0;
+			segment.offset = _buffer.size();
+			segment.length = length;
+			_segments.push_back(segment);
+		}
+		_buffer.append(data, length);
+		if (_size > _bufferSize) startStreaming();
+	}
+}
+
+
+void HTTPResponseWriter::close()
+{
+	if (_closed) return;
+
+	_buf.sync();
+	_closed = true;
+	if (_pOstr)
+	{
+		_pOstr->flush();
+	}
+	else if (!_pResponse->sent())
+	{
+		if (!_pResponse->getChunkedTransferEncoding())
+		{
+			_pResponse->setContentLength64(static_cast<Poco::Int64>(_size));
+		}
+		_pOstr = &_pResponse->send();
+		writeSegments();
+		_pOstr->flush();
+	}
+	_segments.clear();
+	_buffer.clear();
+}
+
+
+void HTTPResponseWriter::startStreaming()
+{
+	poco_check_ptr (_pResponse);
+
+	if (!_pResponse->sent())
+	{
+		if (!_pResponse->getChunkedTransferEncoding() && _pResponse->getContentLength64() == HTTPMessage::UNKNOWN_CONTENT_LENGTH)
+		{
+			if (_pResponse->getVersion() == HTTPMessage::HTTP_1_0)
+				_pResponse->setKeepAlive(false);
+			else
+				_pResponse->setChunkedTransferEncoding(true);
+		}
+		_pOstr = &_pResponse->send();
+		writeSegments();
+	}
+	else
+	{
+		// The response has been sent by someone else,
+		// so there's nowhere to write our data to.
+		_pOstr = &_nullStream;
+	}
+	_segments.clear();
+	std::string().swap(_buffer);
+}
+
+
+void HTTPResponseWriter::writeSegments()
+{
+	for (std::vector<Segment>::const_iterator it = _segments.begin(); it != _segments.end(); ++it)
+	{
+		if (it->data)
+			_pOstr->write(it->data, static_cast<std::streamsize>(it->length));
+		else
+			_pOstr->write(_buffer.data() + it->offset, static_cast<std::streamsize>(it->length));
+	}
+}
+
+
+} } // namespace Poco::Net
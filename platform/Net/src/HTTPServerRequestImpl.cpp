@@ -17,17 +17,38 @@
 #include "Poco/Net/HTTPServerRequestImpl.h"
 #include "Poco/Net/HTTPServerResponseImpl.h"
 #include "Poco/Net/HTTPServerSession.h"
-#include "Poco/Net/HTTPHeaderStream.h"
 #include "Poco/Net/HTTPStream.h"
 #include "Poco/Net/HTTPFixedLengthStream.h"
 #include "Poco/Net/HTTPChunkedStream.h"
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/NetException.h"
 #include "Poco/String.h"
+#include "Poco/Ascii.h"
+#include <cstring>
 
 
 using Poco::icompare;
 
 
+namespace
+{
+	bool equalsIgnoreCase(const std::string& name, const char* p, std::size_t length)
+	{
+		if (name.size() != length) return false;
+		for (std::size_t i = 0; i < length; i++)
+		{
+			if (Poco::Ascii::toLower(name[i]) != Poco::Ascii::toLower(p[i])) return false;
+		}
+		return true;
+	}
+
+	inline bool isBlank(char c)
+	{
+		return c == ' ' || c == '\t';
+	}
+}
+
+
 namespace Poco {
 namespace Net {
 
@@ -43,8 +64,7 @@ HTTPServerRequestImpl::HTTPServerRequestImpl(HTTPServerResponseImpl& response, H
 {
 	response.attachRequest(this);
 
-	HTTPHeaderInputStream hs(session);
-	read(hs);
+	readHeader();
 	
 	// Now that we know socket is still connected, obtain addresses
 	_clientAddress = session.clientAddress();
@@ -68,6 +88,7 @@ HTTPServerRequestImpl::HTTPServerRequestImpl(HTTPServerResponseImpl& response, H
 HTTPServerRequestImpl::~HTTPServerRequestImpl()
 {
 	delete _pStream;
+	_session.arena().reset();
 }
 
 
@@ -83,6 +104,125 @@ StreamSocket HTTPServerRequestImpl::detachSocket()
 }
 
 
+bool HTTPServerRequestImpl::findHeaderField(const std::string& name, const char*& value, std::size_t& length) const
+{
+	for (HeaderFields::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
+	{
+		if (equalsIgnoreCase(name, it->name, it->nameLength))
+		{
+			value = it->value;
+			length = it->valueLength;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void HTTPServerRequestImpl::readHeader()
+{
+	static const std::size_t MAX_REQUEST_LINE_LENGTH = MAX_METHOD_LENGTH + MAX_URI_LENGTH + MAX_VERSION_LENGTH + 32;
+	static const std::size_t MAX_FIELD_LINE_LENGTH = MAX_NAME_LENGTH + MAX_VALUE_LENGTH + 32;
+
+	HTTPRequestArena& arena = _session.arena();
+	arena.reset();
+	_fields.clear();
+
+	// The request line, ignoring any empty lines preceding it.
+	const char* line;
+	std::size_t length = 0;
+	bool first = true;
+	do
+	{
+		if (!_session.readHeaderLine(line, length, MAX_REQUEST_LINE_LENGTH))
+		{
+			if (first)
+				throw NoMessageException();
+			else
+				throw MessageException("No HTTP request header");
+		}
+		first = false;
+		while (length > 0 && Poco::Ascii::isSpace(line[length - 1])) --length;
+	}
+	while (length == 0);
+
+	const char* it = line;
+	const char* end = line + length;
+	while (it != end && Poco::Ascii::isSpace(*it)) ++it;
+	const char* method = it;
+	while (it != end && !Poco::Ascii::isSpace(*it)) ++it;
+	std::size_t methodLength = it - method;
+	if (it == end || methodLength > MAX_METHOD_LENGTH) throw MessageException("HTTP request method invalid or too long");
+	while (it != end && Poco::Ascii::isSpace(*it)) ++it;
+	const char* uri = it;
+	while (it != end && !Poco::Ascii::isSpace(*it)) ++it;
+	std::size_t uriLength = it - uri;
+	if (it == end || uriLength > MAX_URI_LENGTH) throw MessageException("HTTP request URI invalid or too long");
+	while (it != end && Poco::Ascii::isSpace(*it)) ++it;
+	const char* version = it;
+	while (it != end && !Poco::Ascii::isSpace(*it)) ++it;
+	std::size_t versionLength = it - version;
+	if (versionLength == 0 || versionLength > MAX_VERSION_LENGTH) throw MessageException("Invalid HTTP version string");
+
+	// The header fields, up to the empty line.
+	int fieldLimit = getFieldLimit();
+	while (_session.readHeaderLine(line, length, MAX_FIELD_LINE_LENGTH) && length > 0)
+	{
+		if (isBlank(*line))
+		{
+			// Folded field value. The continuation line is
+			// appended, including leading whitespace, to the value
+			// of the previous field.
+			if (!_fields.empty())
+			{
+				HeaderField& field = _fields.back();
+				if (field.valueLength + length > MAX_VALUE_LENGTH) throw MessageException("Folded field value too long/no CRLF found");
+				char* value = arena.allocate(field.valueLength + length);
+				std::memcpy(value, field.value, field.valueLength);
+				std::memcpy(value + field.valueLength, line, length);
+				field.value = value;
+				field.valueLength += length;
+			}
+			continue;
+		}
+		if (fieldLimit > 0 && _fields.size() == static_cast<std::size_t>(fieldLimit)) throw MessageException("Too many header fields");
+
+		const char* colon = static_cast<const char*>(std::memchr(line, ':', length));
+		if (!colon)
+		{
+			if (length < MAX_NAME_LENGTH) continue; // ignore invalid header lines
+			throw MessageException("Field name too long/no colon found");
+		}
+		if (static_cast<std::size_t>(colon - line) > MAX_NAME_LENGTH) throw MessageException("Field name too long/no colon found");
+
+		HeaderField field;
+		field.name = line;
+		field.nameLength = colon - line;
+		const char* value = colon + 1;
+		end = line + length;
+		while (value != end && Poco::Ascii::isSpace(*value)) ++value;
+		field.value = value;
+		field.valueLength = end - value;
+		if (field.valueLength > MAX_VALUE_LENGTH) throw MessageException("Field value too long/no CRLF found");
+		_fields.push_back(field);
+	}
+
+	setMethod(std::string(method, methodLength));
+	setURI(std::string(uri, uriLength));
+	setVersion(std::string(version, versionLength));
+
+	std::string name;
+	std::string value;
+	for (HeaderFields::iterator itField = _fields.begin(); itField != _fields.end(); ++itField)
+	{
+		while (itField->valueLength > 0 && Poco::Ascii::isSpace(itField->value[itField->valueLength - 1])) --itField->valueLength;
+		name.assign(itField->name, itField->nameLength);
+		value.assign(itField->value, itField->valueLength);
+		add(name, value);
+	}
+}
+
+
 bool HTTPServerRequestImpl::expectContinue() const
 {
 	const std::string& expect = get(EXPECT, EMPTY);
@@ -15,6 +15,9 @@
 
 
 #include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/FileStream.h"
+#include "Poco/Buffer.h"
+#include "Poco/Exception.h"
 
 
 namespace Poco {
@@ -31,4 +34,40 @@ HTTPServerResponse::~HTTPServerResponse()
 }
 
 
+void HTTPServerResponse::sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length, const std::string& mediaType)
+{
+	static const std::size_t BUFFER_SIZE = 8192;
+
+	Poco::FileInputStream istr(path);
+	if (!istr.good()) throw OpenFileException(path);
+
+#if defined(POCO_HAVE_INT64)
+	setContentLength64(length);
+#else
+	setContentLength(static_cast<int>(length));
+#endif
+	setContentType(mediaType);
+	setChunkedTransferEncoding(false);
+
+	std::ostream& ostr = send();
+	istr.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	Poco::Buffer<char> buffer(BUFFER_SIZE);
+	Poco::UInt64 sent = 0;
+	while (sent < length && istr.good())
+	{
+		std::streamsize n = static_cast<std::streamsize>(length - sent < BUFFER_SIZE ? length - sent : BUFFER_SIZE);
+		istr.read(buffer.begin(), n);
+		n = istr.gcount();
+		ostr.write(buffer.begin(), n);
+		sent += n;
+	}
+	if (sent != length)
+	{
+		// The file has been truncated since the Content-Length
+		// was determined, so the response cannot be completed.
+		throw IOException("Unexpected end of file", path);
+	}
+}
+
+
 } } // namespace Poco::Net
@@ -115,6 +115,14 @@ void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string
 	Timestamp dateTime    = f.getLastModified();
 	File::FileSize length = f.getSize();
 	set("Last-Modified", DateTimeFormatter::format(dateTime, DateTimeFormat::HTTP_FORMAT));
+	sendFile(path, 0, length, mediaType);
+}
+
+
+void HTTPServerResponseImpl::sendFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length, const std::string& mediaType)
+{
+	poco_assert (!_pStream);
+
 #if defined(POCO_HAVE_INT64)	
 	setContentLength64(length);
 #else
@@ -128,9 +136,15 @@ void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string
 	{
 		_pStream = new HTTPHeaderOutputStream(_session);
 		write(*_pStream);
+		_pStream->flush();
 		if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
 		{
-			StreamCopier::copyStream(istr, *_pStream);
+			if (_session.socket().sendFile(istr, offset, length) != length)
+			{
+				// The file has been truncated since the Content-Length
+				// was determined, so the response cannot be completed.
+				throw IOException("Unexpected end of file", path);
+			}
 		}
 	}
 	else throw OpenFileException(path);
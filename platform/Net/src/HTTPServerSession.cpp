@@ -15,6 +15,8 @@
 
 
 #include "Poco/Net/HTTPServerSession.h"
+#include "Poco/Net/NetException.h"
+#include <cstring>
 
 
 namespace Poco {
@@ -69,4 +71,50 @@ SocketAddress HTTPServerSession::serverAddress()
 }
 
 
+bool HTTPServerSession::readHeaderLine(const char*& line, std::size_t& length, std::size_t maxLength)
+{
+	_line.clear();
+	for (;;)
+	{
+		if (buffered() == 0)
+		{
+			refill();
+			if (buffered() == 0)
+			{
+				if (_line.empty()) return false;
+				break;
+			}
+		}
+		const char* pData = bufferedData();
+		int n = buffered();
+		const char* pEOL = static_cast<const char*>(std::memchr(pData, '\n', n));
+		std::size_t chunk = pEOL ? pEOL - pData : n;
+		if (_line.size() + chunk > maxLength + 1) throw MessageException("HTTP request header line too long");
+		if (pEOL && _line.empty())
+		{
+			// Common case: the complete line is in the buffer,
+			// so we can copy it directly into the arena.
+			length = chunk;
+			if (length > 0 && pData[length - 1] == '\r') --length;
+			if (length > maxLength) throw MessageException("HTTP request header line too long");
+			line = _arena.copy(pData, length);
+			consume(static_cast<int>(chunk + 1));
+			return true;
+		}
+		_line.append(pData, chunk);
+		if (pEOL)
+		{
+			consume(static_cast<int>(chunk + 1));
+			break;
+		}
+		else consume(static_cast<int>(chunk));
+	}
+	length = _line.size();
+	if (length > 0 && _line[length - 1] == '\r') --length;
+	if (length > maxLength) throw MessageException("HTTP request header line too long");
+	line = _arena.copy(_line.data(), length);
+	return true;
+}
+
+
 } } // namespace Poco::Net
@@ -19,6 +19,8 @@
 #include "Poco/Net/StreamSocketImpl.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Timestamp.h"
+#include "Poco/FileStream.h"
+#include "Poco/Buffer.h"
 #include <string.h> // FD_SET needs memset on some platforms, so we can't use <cstring>
 #if defined(POCO_HAVE_FD_EPOLL)
 #include <sys/epoll.h>
@@ -27,6 +29,11 @@
 #endif
 
 
+#if POCO_OS == POCO_OS_LINUX
+#include <sys/sendfile.h>
+#endif
+
+
 #if defined(sun) || defined(__sun) || defined(__sun__)
 #include <unistd.h>
 #include <stropts.h>
@@ -282,6 +289,92 @@ int SocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+Poco::UInt64 SocketImpl::sendFile(FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+#if POCO_OS == POCO_OS_LINUX
+	if (secure()) return sendFileBuffered(istr, offset, count);
+
+	// sendfile() transfers at most 0x7ffff000 bytes per call.
+	static const Poco::UInt64 MAX_CHUNK = 0x7ffff000;
+
+	off_t pos = static_cast<off_t>(offset);
+	Poco::UInt64 sent = 0;
+	while (sent < count)
+	{
+#if defined(POCO_BROKEN_TIMEOUTS)
+		if (_sndTimeout.totalMicroseconds() != 0)
+		{
+			if (!poll(_sndTimeout, SELECT_WRITE))
+				throw TimeoutException();
+		}
+#endif
+		std::size_t chunk = static_cast<std::size_t>(count - sent < MAX_CHUNK ? count - sent : MAX_CHUNK);
+		ssize_t rc;
+		do
+		{
+			if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			rc = ::sendfile(_sockfd, istr.nativeHandle(), &pos, chunk);
+		}
+		while (rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0)
+		{
+			int err = lastError();
+			if (err == POCO_EAGAIN && !_blocking)
+			{
+				// The send buffer of a non-blocking socket is full.
+				// Wait until the socket becomes writable again, so
+				// that a short count always means end of file.
+				Poco::Timespan timeout = getSendTimeout();
+				if (timeout.totalMicroseconds() != 0)
+				{
+					if (!poll(timeout, SELECT_WRITE))
+						throw TimeoutException();
+				}
+				else while (!poll(Poco::Timespan(1, 0), SELECT_WRITE));
+				continue;
+			}
+			else if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT)
+				throw TimeoutException(err);
+			else
+				error(err);
+		}
+		else if (rc == 0) break; // end of file
+		sent += rc;
+	}
+	return sent;
+#else
+	return sendFileBuffered(istr, offset, count);
+#endif
+}
+
+
+Poco::UInt64 SocketImpl::sendFileBuffered(FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	static const std::size_t BUFFER_SIZE = 8192;
+
+	istr.clear();
+	istr.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	Poco::Buffer<char> buffer(BUFFER_SIZE);
+	Poco::UInt64 sent = 0;
+	while (sent < count && istr.good())
+	{
+		std::streamsize n = static_cast<std::streamsize>(count - sent < BUFFER_SIZE ? count - sent : BUFFER_SIZE);
+		istr.read(buffer.begin(), n);
+		n = istr.gcount();
+		const char* p = buffer.begin();
+		while (n > 0)
+		{
+			int rc = sendBytes(p, static_cast<int>(n));
+			if (rc <= 0) return sent;
+			p += rc;
+			n -= rc;
+			sent += rc;
+		}
+	}
+	return sent;
+}
+
+
 int SocketImpl::receiveBytes(void* buffer, int length, int flags)
 {
 #if defined(POCO_BROKEN_TIMEOUTS)
@@ -127,6 +127,12 @@ int StreamSocket::sendBytes(FIFOBuffer& fifoBuf)
 }
 
 
+Poco::UInt64 StreamSocket::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return impl()->sendFile(istr, offset, count);
+}
+
+
 int StreamSocket::receiveBytes(void* buffer, int length, int flags)
 {
 	return impl()->receiveBytes(buffer, length, flags);
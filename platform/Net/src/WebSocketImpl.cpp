@@ -208,6 +208,12 @@ int WebSocketImpl::receiveNBytes(void* buffer, int bytes)
 }
 
 
+Poco::UInt64 WebSocketImpl::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return sendFileBuffered(istr, offset, count);
+}
+
+
 SocketImpl* WebSocketImpl::acceptConnection(SocketAddress& clientAddr)
 {
 	throw Poco::InvalidAccessException("Cannot acceptConnection() on a WebSocketImpl");
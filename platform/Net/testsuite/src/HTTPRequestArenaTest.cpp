@@ -0,0 +1,110 @@
+//
+// HTTPRequestArenaTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPRequestArenaTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPRequestArena.h"
+#include <cstring>
+
+
+using Poco::Net::HTTPRequestArena;
+
+
+HTTPRequestArenaTest::HTTPRequestArenaTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPRequestArenaTest::~HTTPRequestArenaTest()
+{
+}
+
+
+void HTTPRequestArenaTest::testAllocate()
+{
+	HTTPRequestArena arena(64);
+	assert (arena.used() == 0);
+	assert (arena.blockSize() == 64);
+
+	char* p1 = arena.copy("Host", 4);
+	char* p2 = arena.copy("localhost", 9);
+	assert (p2 == p1 + 4);
+	assert (std::memcmp(p1, "Hostlocalhost", 13) == 0);
+	assert (arena.used() == 13);
+
+	// does not fit into the first block anymore
+	char* p3 = arena.allocate(60);
+	assert (p3 != p2 + 9);
+	std::memset(p3, 'x', 60);
+	assert (std::memcmp(p1, "Hostlocalhost", 13) == 0);
+	assert (arena.used() == 73);
+}
+
+
+void HTTPRequestArenaTest::testLargeAllocation()
+{
+	HTTPRequestArena arena(64);
+	char* p1 = arena.copy("abc", 3);
+	char* pLarge = arena.allocate(1000);
+	std::memset(pLarge, 'x', 1000);
+
+	// small allocations continue in the current block
+	char* p2 = arena.copy("def", 3);
+	assert (p2 == p1 + 3);
+	assert (std::memcmp(p1, "abcdef", 6) == 0);
+
+	HTTPRequestArena arena2(64);
+	pLarge = arena2.allocate(1000);
+	std::memset(pLarge, 'x', 1000);
+	p1 = arena2.copy("abc", 3);
+	p2 = arena2.copy("def", 3);
+	assert (p2 == p1 + 3);
+}
+
+
+void HTTPRequestArenaTest::testReset()
+{
+	HTTPRequestArena arena(64);
+	char* p1 = arena.allocate(10);
+	arena.allocate(60);
+	arena.allocate(100);
+	arena.reset();
+	assert (arena.used() == 0);
+
+	// the first block is reused
+	char* p2 = arena.allocate(10);
+	assert (p2 == p1);
+	assert (arena.used() == 10);
+}
+
+
+void HTTPRequestArenaTest::setUp()
+{
+}
+
+
+void HTTPRequestArenaTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HTTPRequestArenaTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPRequestArenaTest");
+
+	CppUnit_addTest(pSuite, HTTPRequestArenaTest, testAllocate);
+	CppUnit_addTest(pSuite, HTTPRequestArenaTest, testLargeAllocation);
+	CppUnit_addTest(pSuite, HTTPRequestArenaTest, testReset);
+
+	return pSuite;
+}
@@ -0,0 +1,42 @@
+//
+// HTTPRequestArenaTest.h
+//
+// $Id$
+//
+// Definition of the HTTPRequestArenaTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HTTPRequestArenaTest_INCLUDED
+#define HTTPRequestArenaTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "CppUnit/TestCase.h"
+
+
+class HTTPRequestArenaTest: public CppUnit::TestCase
+{
+public:
+	HTTPRequestArenaTest(const std::string& name);
+	~HTTPRequestArenaTest();
+
+	void testAllocate();
+	void testLargeAllocation();
+	void testReset();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HTTPRequestArenaTest_INCLUDED
@@ -22,8 +22,14 @@
 #include "Poco/Net/HTTPServerRequest.h"
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/HTTPResponseWriter.h"
+#include "Poco/Net/HTTPServerRequestImpl.h"
 #include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketStream.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
 #include <sstream>
 
 
@@ -37,9 +43,15 @@ using Poco::Net::HTTPRequest;
 using Poco::Net::HTTPServerRequest;
 using Poco::Net::HTTPResponse;
 using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPResponseWriter;
 using Poco::Net::HTTPMessage;
+using Poco::Net::HTTPServerRequestImpl;
 using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketStream;
 using Poco::StreamCopier;
+using Poco::TemporaryFile;
+using Poco::FileOutputStream;
 
 
 namespace
@@ -106,9 +118,108 @@ namespace
 		}
 	};
 	
+	class WriterRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		WriterRequestHandler(int count, bool redirect = false):
+			_count(count),
+			_redirect(redirect)
+		{
+		}
+		
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			static const char begin[] = "<p>";
+			static const char end[] = "</p>\n";
+
+			response.setContentType("text/html");
+			HTTPResponseWriter writer(response, 1024);
+			for (int i = 0; i < _count; i++)
+			{
+				writer.writeStatic(begin, sizeof(begin) - 1);
+				writer.stream() << i;
+				writer.writeStatic(end, sizeof(end) - 1);
+			}
+			if (_redirect)
+			{
+				response.redirect("http://www.appinf.com/");
+				return;
+			}
+			writer.close();
+		}
+		
+		static std::string expected(int count)
+		{
+			std::ostringstream ostr;
+			for (int i = 0; i < count; i++)
+			{
+				ostr << "<p>" << i << "</p>\n";
+			}
+			return ostr.str();
+		}
+		
+	private:
+		int _count;
+		bool _redirect;
+	};
+	
+	class HeaderFieldsRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			HTTPServerRequestImpl& requestImpl = dynamic_cast<HTTPServerRequestImpl&>(request);
+			std::string body;
+			const HTTPServerRequestImpl::HeaderFields& fields = requestImpl.headerFields();
+			for (HTTPServerRequestImpl::HeaderFields::const_iterator it = fields.begin(); it != fields.end(); ++it)
+			{
+				body.append(it->name, it->nameLength);
+				body += '=';
+				body.append(it->value, it->valueLength);
+				body += '\n';
+			}
+			const char* value;
+			std::size_t length;
+			if (requestImpl.findHeaderField("x-test", value, length))
+			{
+				body += "found=";
+				body.append(value, length);
+			}
+			response.setContentLength(static_cast<int>(body.size()));
+			response.send() << body;
+		}
+	};
+
+	class FileRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		FileRequestHandler(const std::string& path, bool range):
+			_path(path),
+			_range(range)
+		{
+		}
+
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			if (_range)
+				response.sendFile(_path, 1000, 50000, "application/octet-stream");
+			else
+				response.sendFile(_path, "application/octet-stream");
+		}
+
+	private:
+		std::string _path;
+		bool _range;
+	};
+
 	class RequestHandlerFactory: public HTTPRequestHandlerFactory
 	{
 	public:
+		RequestHandlerFactory(const std::string& filePath = std::string()):
+			_filePath(filePath)
+		{
+		}
+
 		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
 		{
 			if (request.getURI() == "/echoBody")
@@ -121,9 +232,24 @@ namespace
 				return new AuthRequestHandler();
 			else if (request.getURI() == "/buffer")
 				return new BufferRequestHandler();
+			else if (request.getURI() == "/writer")
+				return new WriterRequestHandler(10);
+			else if (request.getURI() == "/writerLarge")
+				return new WriterRequestHandler(1000);
+			else if (request.getURI() == "/writerRedirect")
+				return new WriterRequestHandler(10, true);
+			else if (request.getURI() == "/headerFields")
+				return new HeaderFieldsRequestHandler;
+			else if (request.getURI() == "/file")
+				return new FileRequestHandler(_filePath, false);
+			else if (request.getURI() == "/fileRange")
+				return new FileRequestHandler(_filePath, true);
 			else
 				return 0;
 		}
+
+	private:
+		std::string _filePath;
 	};
 }
 
@@ -518,6 +644,241 @@ void HTTPServerTest::testBuffer()
 }
 
 
+void HTTPServerTest::testSendFile()
+{
+	TemporaryFile tempFile;
+	std::string data;
+	for (int i = 0; i < 100000; i++)
+	{
+		data += static_cast<char>('a' + i % 26);
+	}
+	FileOutputStream ostr(tempFile.path());
+	ostr << data;
+	ostr.close();
+
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory(tempFile.path()), svs, pParams);
+	srv.start();
+
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/file", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getStatus() == HTTPResponse::HTTP_OK);
+	assert (response.getContentLength() == 100000);
+	assert (response.has("Last-Modified"));
+	assert (!response.getChunkedTransferEncoding());
+	assert (rbody == data);
+
+	HTTPRequest request2("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request2);
+	HTTPResponse response2;
+	std::string rbody2;
+	StreamCopier::copyToString(cs.receiveResponse(response2), rbody2);
+	assert (response2.getStatus() == HTTPResponse::HTTP_OK);
+	assert (response2.getContentLength() == 50000);
+	assert (!response2.has("Last-Modified"));
+	assert (rbody2 == data.substr(1000, 50000));
+
+	HTTPRequest request3("HEAD", "/fileRange", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request3);
+	HTTPResponse response3;
+	std::string rbody3;
+	StreamCopier::copyToString(cs.receiveResponse(response3), rbody3);
+	assert (response3.getStatus() == HTTPResponse::HTTP_OK);
+	assert (response3.getContentLength() == 50000);
+	assert (rbody3.empty());
+
+	// the connection must still be usable after the HEAD request
+	HTTPRequest request4("GET", "/fileRange", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request4);
+	HTTPResponse response4;
+	std::string rbody4;
+	StreamCopier::copyToString(cs.receiveResponse(response4), rbody4);
+	assert (response4.getStatus() == HTTPResponse::HTTP_OK);
+	assert (rbody4 == data.substr(1000, 50000));
+}
+
+
+void HTTPServerTest::testResponseWriter()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/writer", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	std::string expected = WriterRequestHandler::expected(10);
+	assert (response.getStatus() == HTTPResponse::HTTP_OK);
+	assert (response.getContentLength() == expected.size());
+	assert (!response.getChunkedTransferEncoding());
+	assert (response.getKeepAlive());
+	assert (rbody == expected);
+
+	request.setMethod(HTTPRequest::HTTP_HEAD);
+	cs.sendRequest(request);
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getContentLength() == expected.size());
+	assert (rbody.empty());
+}
+
+
+void HTTPServerTest::testResponseWriterChunked()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/writerLarge", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	std::string expected = WriterRequestHandler::expected(1000);
+	assert (response.getStatus() == HTTPResponse::HTTP_OK);
+	assert (response.getContentLength() == HTTPMessage::UNKNOWN_CONTENT_LENGTH);
+	assert (response.getChunkedTransferEncoding());
+	assert (response.getKeepAlive());
+	assert (rbody == expected);
+
+	HTTPRequest request10("GET", "/writerLarge", HTTPMessage::HTTP_1_0);
+	cs.sendRequest(request10);
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getContentLength() == HTTPMessage::UNKNOWN_CONTENT_LENGTH);
+	assert (!response.getChunkedTransferEncoding());
+	assert (!response.getKeepAlive());
+	assert (rbody == expected);
+}
+
+
+void HTTPServerTest::testResponseWriterRedirect()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("localhost", svs.address().port());
+	HTTPRequest request("GET", "/writerRedirect");
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getStatus() == HTTPResponse::HTTP_FOUND);
+	assert (response.get("Location") == "http://www.appinf.com/");
+	assert (rbody.empty());
+}
+
+
+void HTTPServerTest::testRequestHeader()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	// A header larger than the session buffer, with an empty line
+	// before the request line, a folded field, a line without
+	// colon and a line with LF only.
+	std::string longValue(6000, 'x');
+	std::string request("\r\nGET /echoHeader HTTP/1.1\r\n"
+		"Host: localhost\r\n"
+		"X-Folded: one\r\n"
+		" two  \r\n"
+		"X-Empty:\r\n"
+		"NoColon\r\n"
+		"X-Long:  ");
+	request += longValue;
+	request += " \r\nX-LF: lf\n\r\n";
+
+	StreamSocket ss;
+	ss.connect(svs.address());
+	ss.sendBytes(request.data(), static_cast<int>(request.size()));
+	SocketStream sstr(ss);
+	HTTPResponse response;
+	response.read(sstr);
+	assert (response.getStatus() == HTTPResponse::HTTP_OK);
+	std::string body(static_cast<std::size_t>(response.getContentLength()), 0);
+	sstr.read(&body[0], static_cast<std::streamsize>(body.size()));
+	assert (body.find("GET /echoHeader HTTP/1.1\r\n") == 0);
+	assert (body.find("X-Folded: one two\r\n") != std::string::npos);
+	assert (body.find("X-Empty: \r\n") != std::string::npos);
+	assert (body.find("NoColon") == std::string::npos);
+	assert (body.find("X-Long: " + longValue + "\r\n") != std::string::npos);
+	assert (body.find("X-LF: lf\r\n") != std::string::npos);
+
+	// Two pipelined requests in a single packet.
+	request = "GET /headerFields HTTP/1.1\r\nHost: localhost\r\nX-Test: first\r\n\r\n"
+		"GET /headerFields HTTP/1.1\r\nHost: localhost\r\nX-TEST:second\r\n\r\n";
+	ss.sendBytes(request.data(), static_cast<int>(request.size()));
+	HTTPResponse response2;
+	response2.read(sstr);
+	body.assign(static_cast<std::size_t>(response2.getContentLength()), 0);
+	sstr.read(&body[0], static_cast<std::streamsize>(body.size()));
+	assert (body == "Host=localhost\nX-Test=first\nfound=first");
+	HTTPResponse response3;
+	response3.read(sstr);
+	body.assign(static_cast<std::size_t>(response3.getContentLength()), 0);
+	sstr.read(&body[0], static_cast<std::streamsize>(body.size()));
+	assert (body == "Host=localhost\nX-TEST=second\nfound=second");
+}
+
+
+void HTTPServerTest::testBadRequestHeader()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	std::string tooManyFields("GET /echoHeader HTTP/1.1\r\n");
+	for (int i = 0; i < 101; i++) tooManyFields += "X-Field: value\r\n";
+	tooManyFields += "\r\n";
+
+	std::string nameTooLong("GET /echoHeader HTTP/1.1\r\n");
+	nameTooLong += std::string(300, 'n');
+	nameTooLong += ": value\r\n\r\n";
+
+	std::string valueTooLong("GET /echoHeader HTTP/1.1\r\nX-Value: ");
+	valueTooLong += std::string(9000, 'v');
+	valueTooLong += "\r\n\r\n";
+
+	std::string noVersion("GET /echoHeader\r\n\r\n");
+
+	std::string requests[] = { tooManyFields, nameTooLong, valueTooLong, noVersion };
+	for (int i = 0; i < 4; i++)
+	{
+		StreamSocket ss;
+		ss.connect(svs.address());
+		ss.sendBytes(requests[i].data(), static_cast<int>(requests[i].size()));
+		SocketStream sstr(ss);
+		HTTPResponse response;
+		response.read(sstr);
+		assert (response.getStatus() == HTTPResponse::HTTP_BAD_REQUEST);
+	}
+}
+
+
 void HTTPServerTest::setUp()
 {
 }
@@ -546,6 +907,12 @@ CppUnit::Test* HTTPServerTest::suite()
 	CppUnit_addTest(pSuite, HTTPServerTest, testAuth);
 	CppUnit_addTest(pSuite, HTTPServerTest, testNotImpl);
 	CppUnit_addTest(pSuite, HTTPServerTest, testBuffer);
+	CppUnit_addTest(pSuite, HTTPServerTest, testSendFile);
+	CppUnit_addTest(pSuite, HTTPServerTest, testResponseWriter);
+	CppUnit_addTest(pSuite, HTTPServerTest, testResponseWriterChunked);
+	CppUnit_addTest(pSuite, HTTPServerTest, testResponseWriterRedirect);
+	CppUnit_addTest(pSuite, HTTPServerTest, testRequestHeader);
+	CppUnit_addTest(pSuite, HTTPServerTest, testBadRequestHeader);
 
 	return pSuite;
 }
@@ -40,6 +40,12 @@ public:
 	void testAuth();
 	void testNotImpl();
 	void testBuffer();
+	void testSendFile();
+	void testResponseWriter();
+	void testResponseWriterChunked();
+	void testResponseWriterRedirect();
+	void testRequestHeader();
+	void testBadRequestHeader();
 
 	void setUp();
 	void tearDown();
@@ -12,6 +12,7 @@
 
 #include "HTTPServerTestSuite.h"
 #include "HTTPServerTest.h"
+#include "HTTPRequestArenaTest.h"
 
 
 CppUnit::Test* HTTPServerTestSuite::suite()
@@ -19,6 +20,7 @@ CppUnit::Test* HTTPServerTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPServerTestSuite");
 
 	pSuite->addTest(HTTPServerTest::suite());
+	pSuite->addTest(HTTPRequestArenaTest::suite());
 
 	return pSuite;
 }
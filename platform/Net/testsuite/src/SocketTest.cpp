@@ -23,6 +23,10 @@
 #include "Poco/Buffer.h"
 #include "Poco/FIFOBuffer.h"
 #include "Poco/Delegate.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
 #include <iostream>
 
 
@@ -38,6 +42,54 @@ using Poco::InvalidArgumentException;
 using Poco::Buffer;
 using Poco::FIFOBuffer;
 using Poco::delegate;
+using Poco::TemporaryFile;
+using Poco::FileInputStream;
+using Poco::FileOutputStream;
+
+
+namespace
+{
+	class SinkServer: public Poco::Runnable
+		/// Accepts a single connection and counts all
+		/// bytes received until the peer closes it.
+		/// Starts receiving only after a short delay, so
+		/// that the send buffer of the peer fills up.
+	{
+	public:
+		SinkServer():
+			_socket(SocketAddress("localhost", 0)),
+			_received(0)
+		{
+		}
+		
+		Poco::UInt16 port() const
+		{
+			return _socket.address().port();
+		}
+		
+		Poco::UInt64 received() const
+		{
+			return _received;
+		}
+		
+		void run()
+		{
+			StreamSocket ss = _socket.acceptConnection();
+			Poco::Thread::sleep(200);
+			char buffer[8192];
+			int n = ss.receiveBytes(buffer, sizeof(buffer));
+			while (n > 0)
+			{
+				_received += n;
+				n = ss.receiveBytes(buffer, sizeof(buffer));
+			}
+		}
+		
+	private:
+		ServerSocket _socket;
+		Poco::UInt64 _received;
+	};
+}
 
 
 SocketTest::SocketTest(const std::string& name): CppUnit::TestCase(name)
@@ -65,6 +117,61 @@ void SocketTest::testEcho()
 }
 
 
+void SocketTest::testSendFile()
+{
+	TemporaryFile tempFile;
+	FileOutputStream ostr(tempFile.path());
+	ostr << "0123456789abcdefghijklmnopqrstuvwxyz";
+	ostr.close();
+
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("localhost", echoServer.port()));
+	FileInputStream istr(tempFile.path());
+	Poco::UInt64 n = ss.sendFile(istr, 10, 6);
+	assert (n == 6);
+	char buffer[256];
+	int rc = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (rc == 6);
+	assert (std::string(buffer, rc) == "abcdef");
+
+	// sending past the end of the file stops at the end of the file
+	n = ss.sendFile(istr, 30, 100);
+	assert (n == 6);
+	rc = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (rc == 6);
+	assert (std::string(buffer, rc) == "uvwxyz");
+	ss.close();
+}
+
+
+void SocketTest::testSendFileNonBlocking()
+{
+	const Poco::UInt64 size = 4*1024*1024;
+	TemporaryFile tempFile;
+	FileOutputStream ostr(tempFile.path());
+	std::string block(1024, 'x');
+	for (Poco::UInt64 i = 0; i < size/block.size(); i++) ostr << block;
+	ostr.close();
+
+	SinkServer sink;
+	Poco::Thread thread;
+	thread.start(sink);
+	StreamSocket ss;
+	ss.connect(SocketAddress("localhost", sink.port()));
+	ss.setSendBufferSize(8192);
+	ss.setBlocking(false);
+
+	// a full send buffer must not result in a short count
+	FileInputStream istr(tempFile.path());
+	Poco::UInt64 n = ss.sendFile(istr, 0, size);
+	ss.close();
+	thread.join();
+	assert (n == size);
+	assert (sink.received() == size);
+}
+
+
 void SocketTest::testPoll()
 {
 	EchoServer echoServer;
@@ -534,6 +641,8 @@ CppUnit::Test* SocketTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SocketTest");
 
 	CppUnit_addTest(pSuite, SocketTest, testEcho);
+	CppUnit_addTest(pSuite, SocketTest, testSendFile);
+	CppUnit_addTest(pSuite, SocketTest, testSendFileNonBlocking);
 	CppUnit_addTest(pSuite, SocketTest, testPoll);
 	CppUnit_addTest(pSuite, SocketTest, testAvailable);
 	CppUnit_addTest(pSuite, SocketTest, testFIFOBuffer);
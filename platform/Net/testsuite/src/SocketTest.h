@@ -27,6 +27,8 @@ public:
 	~SocketTest();
 
 	void testEcho();
+	void testSendFile();
+	void testSendFileNonBlocking();
 	void testPoll();
 	void testAvailable();
 	void testFIFOBuffer();
@@ -21,6 +21,8 @@
 #include "Poco/RemotingNG/RemoteObject.h"
 #include "Poco/JS/Bridge/Listener.h"
 #include "Poco/JS/Bridge/BridgeWrapper.h"
+#include "Poco/JS/Net/HTTPSessionPool.h"
+#include "Poco/JS/Net/HTTPRequestWrapper.h"
 #include "Poco/StringTokenizer.h"
 #include "Poco/Delegate.h"
 #include "Poco/ClassLibrary.h"
@@ -87,6 +89,11 @@ public:
 			v8::V8::SetFlagsFromString(it->data(), it->size());
 		}
 		
+		Poco::JS::Net::HTTPSessionPool& sessionPool = Poco::JS::Net::HTTPSessionPool::defaultPool();
+		sessionPool.setMaxIdleSessions(_pPrefs->configuration()->getInt("osp.js.http.maxIdleSessions", Poco::JS::Net::HTTPSessionPool::DEFAULT_MAX_IDLE_SESSIONS));
+		sessionPool.setIdleTimeout(Poco::Timespan(_pPrefs->configuration()->getInt("osp.js.http.idleTimeout", Poco::JS::Net::HTTPSessionPool::DEFAULT_IDLE_TIMEOUT), 0));
+		Poco::JS::Net::HTTPRequestWrapper::setAsyncThreadCount(_pPrefs->configuration()->getInt("osp.js.http.asyncThreads", Poco::JS::Net::HTTPRequestWrapper::DEFAULT_ASYNC_THREAD_COUNT));
+
 		std::string v8Version =  v8::V8::GetVersion();
 		_pContext->logger().information("Using V8 version: %s", v8Version);
 	}
@@ -99,6 +106,7 @@ public:
 	
 		Poco::RemotingNG::ORB::instance().unregisterListener(_jsBridgeListenerId, true);
 		Poco::JS::Bridge::BridgeWrapper::unregisterTransportFactory();
+		Poco::JS::Net::HTTPSessionPool::defaultPool().clear();
 
 		pContext->registry().serviceRegistered   -= Poco::delegate(this, &JSBundleActivator::handleServiceRegistered);
 		pContext->registry().serviceUnregistered -= Poco::delegate(this, &JSBundleActivator::handleServiceUnregistered);
@@ -150,7 +150,7 @@ public:
 		/// Returns the IP address of the client holding the session.
 		
 	// UniqueExpireCache support
-	const Poco::Timestamp& getExpiration() const;
+	Poco::Timestamp getExpiration() const;
 		/// Return the time when the session will expire.
 	
 	void access();
@@ -181,6 +181,8 @@ private:
 	Attributes           _attrs;
 	
 	mutable Poco::FastMutex _mutex;
+
+	friend class WebSessionManager;
 };
 
 
@@ -211,12 +213,6 @@ inline const Poco::Net::IPAddress& WebSession::clientAddress() const
 }
 
 
-inline const Poco::Timestamp& WebSession::getExpiration() const
-{
-	return _expiration;
-}
-
-
 inline WebSession::Attributes::const_iterator WebSession::find(const std::string& key) const
 {
 	return _attrs.find(key);
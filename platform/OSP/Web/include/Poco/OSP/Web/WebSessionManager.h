@@ -24,8 +24,11 @@
 #include "Poco/OSP/Web/WebSession.h"
 #include "Poco/OSP/Web/WebSessionService.h"
 #include "Poco/Net/HTTPServerRequest.h"
-#include "Poco/UniqueExpireCache.h"
+#include "Poco/Util/Timer.h"
+#include "Poco/AtomicCounter.h"
 #include "Poco/Mutex.h"
+#include <map>
+#include <vector>
 
 
 namespace Poco {
@@ -48,6 +51,23 @@ class OSPWeb_API WebSessionManager: public WebSessionService<Poco::Net::HTTPServ
 	/// will send the session cookie to all hosts with names in the appinf.com
 	/// domain. If a domain is not given, the session cookie will only be available
 	/// to the host that has originally set it.
+	///
+	/// Sessions are distributed over a fixed number of shards, based on
+	/// a hash of the session ID. Every shard has its own lock, so requests
+	/// for different sessions usually do not contend for the same lock.
+	///
+	/// Looking up a session only extends its expiration time. Expired
+	/// sessions are removed by a background timer, which maintains a
+	/// timer wheel with one slot per second. A session is entered into
+	/// the slot corresponding to its expiration time. When the timer
+	/// reaches a slot, all sessions in it that have actually expired are
+	/// removed, and sessions that have been accessed in the meantime
+	/// are moved to the slot matching their new expiration time.
+	///
+	/// Sessions can be saved to a file with saveSessions() and restored
+	/// with loadSessions(), e.g., to keep users logged in across a restart
+	/// of the application. Only session attributes of type std::string,
+	/// int, Poco::Int64, bool and double are saved.
 {
 public:
 	typedef Poco::AutoPtr<WebSessionManager> Ptr;
@@ -84,6 +104,41 @@ public:
 	CookiePersistence getCookiePersistence() const;
 		/// Returns the cookie persistence.
 
+	std::size_t count() const;
+		/// Returns the number of sessions.
+
+	std::size_t saveSessions(const std::string& path);
+		/// Writes all sessions that have not yet expired, together
+		/// with their supported attributes, to the file with the given path.
+		///
+		/// The sessions are first written to a temporary file, which
+		/// then replaces the file given by path.
+		///
+		/// As the file contains the session IDs, it is created with
+		/// permissions that only allow its owner to read and write it
+		/// (0600) on POSIX platforms. On Windows, the file inherits the
+		/// access control list of its directory.
+		///
+		/// Returns the number of saved sessions.
+
+	std::size_t loadSessions(const std::string& path, BundleContext::Ptr pContext);
+		/// Restores the sessions previously saved with saveSessions().
+		/// Sessions that have expired in the meantime are skipped.
+		/// Does nothing if the file does not exist.
+		///
+		/// Since the bundles that originally created the sessions may
+		/// not have been started yet, the restored sessions are associated
+		/// with the given BundleContext.
+		///
+		/// Returns the number of restored sessions. Throws a
+		/// Poco::DataFormatException if the file is not a valid
+		/// session file.
+
+	void scheduleSnapshots(const std::string& path, long interval);
+		/// Periodically saves all sessions to the file with the
+		/// given path, using saveSessions(). The interval is
+		/// given in milliseconds.
+
 	// WebSessionService
 	WebSession::Ptr find(const std::string& appName, const Poco::Net::HTTPServerRequest& request);
 	WebSession::Ptr get(const std::string& appName, const Poco::Net::HTTPServerRequest& request, int expireSeconds, BundleContext::Ptr pContext);
@@ -96,7 +151,32 @@ public:
 
 	static const std::string SERVICE_NAME;
 
+	enum
+	{
+		SHARD_COUNT = 16,
+			/// Number of shards the sessions are distributed over.
+		WHEEL_SIZE = 64,
+			/// Number of one-second slots in the timer wheel.
+		EXPIRE_INTERVAL = 1000
+			/// Interval in milliseconds at which the timer wheel is advanced.
+	};
+
 protected:
+	typedef std::map<std::string, WebSession::Ptr> SessionMap;
+	typedef std::vector<std::string> IdVec;
+
+	struct Shard
+	{
+		Poco::FastMutex mutex;
+		SessionMap sessions;
+	};
+
+	Shard& shard(const std::string& id);
+	bool add(WebSession::Ptr pSession);
+	void schedule(const std::string& id, const Poco::Timestamp& expiration);
+	void expire(const Poco::Timestamp& now);
+	void onExpire(Poco::Util::TimerTask& task);
+	void onSnapshot(Poco::Util::TimerTask& task);
 	std::string getId(const std::string& appName, const Poco::Net::HTTPServerRequest& request);
 	void addCookie(const std::string& appName, const Poco::Net::HTTPServerRequest& request, WebSession::Ptr ptrSes);
 	std::string createSessionId(const Poco::Net::HTTPServerRequest& request);
@@ -107,12 +187,19 @@ protected:
 private:
 	static const std::string COOKIE_NAME;
 
-	Poco::FastMutex _mutex;
-	Poco::UInt32 _serial;
-	Poco::UniqueExpireCache<std::string, WebSession> _cache;
+	static const std::string FILE_MAGIC;
+
+	Poco::AtomicCounter _serial;
+	mutable Shard _shards[SHARD_COUNT];
+	IdVec _wheel[WHEEL_SIZE];
+	Poco::Int64 _wheelTime;
+	Poco::FastMutex _wheelMutex;
+	std::string _snapshotPath;
+	Poco::FastMutex _snapshotMutex;
 	std::string _defaultDomain;
 	std::string _defaultPath;
 	CookiePersistence _cookiePersistence;
+	Poco::Util::Timer _timer;
 };
 
 
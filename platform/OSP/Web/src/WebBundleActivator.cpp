@@ -16,6 +16,7 @@
 #include "Poco/OSP/ServiceRegistry.h"
 #include "Poco/OSP/PreferencesService.h"
 #include "Poco/OSP/ExtensionPointService.h"
+#include "Poco/OSP/SystemEvents.h"
 #include "Poco/OSP/Web/MediaTypeMapper.h"
 #include "Poco/OSP/Web/WebServerDispatcher.h"
 #include "Poco/OSP/Web/WebSessionManager.h"
@@ -24,6 +25,8 @@
 #include "Poco/StringTokenizer.h"
 #include "Poco/Format.h"
 #include "Poco/AutoPtr.h"
+#include "Poco/Path.h"
+#include "Poco/Delegate.h"
 #include "Poco/ClassLibrary.h"
 #include <memory>
 #include <istream>
@@ -37,6 +40,7 @@ using Poco::OSP::ServiceRef;
 using Poco::OSP::PreferencesService;
 using Poco::OSP::Properties;
 using Poco::OSP::ExtensionPointService;
+using Poco::OSP::SystemEvents;
 using Poco::OSP::Web::MediaTypeMapper;
 using Poco::OSP::Web::WebServerDispatcher;
 using Poco::OSP::Web::WebSessionManager;
@@ -50,6 +54,18 @@ class WebBundleActivator: public BundleActivator
 	///
 	/// Registers the MediaTypeMapper service, the WebSessionManager service
 	/// and the WebServerDispatcher service and installs the WebServerExtensionPoint.
+	///
+	/// If osp.web.sessionManager.persistSessions is true, sessions are saved
+	/// to the bundle's persistent directory when the system shuts down,
+	/// and restored when the bundle is started again. Additionally, sessions
+	/// are saved every osp.web.sessionManager.snapshotInterval seconds,
+	/// if that property is set to a non-zero value.
+	///
+	/// Restored sessions are associated with the context of the Web bundle,
+	/// not with the context of the bundle that originally created them.
+	/// Therefore, stopping the bundle that created a session no longer
+	/// clears the session's attributes once the session has been restored;
+	/// they are only cleared when the Web bundle itself is stopped.
 {
 public:
 	WebBundleActivator()
@@ -76,6 +92,8 @@ public:
 		bool compressResponse(pContext->thisBundle()->properties().getBool("compressResponses", false));
 		std::string compressedMediaTypesString(pContext->thisBundle()->properties().getString("compressedMediaTypes", ""));
 		std::string sessionCookiePersistence(pContext->thisBundle()->properties().getString("cookiePersistence", "persistent"));
+		bool persistSessions(pContext->thisBundle()->properties().getBool("persistSessions", false));
+		int snapshotInterval(pContext->thisBundle()->properties().getInt("snapshotInterval", 0));
 		if (pPrefsSvcRef)
 		{
 			Poco::AutoPtr<PreferencesService> pPrefsSvc = pPrefsSvcRef->castedInstance<PreferencesService>();
@@ -84,6 +102,8 @@ public:
 			compressResponse = pPrefsSvc->configuration()->getBool("osp.web.compressResponses", compressResponse);
 			compressedMediaTypesString = pPrefsSvc->configuration()->getString("osp.web.compressedMediaTypes", compressedMediaTypesString);
 			sessionCookiePersistence = pPrefsSvc->configuration()->getString("osp.web.sessionManager.cookiePersistence", sessionCookiePersistence);
+			persistSessions = pPrefsSvc->configuration()->getBool("osp.web.sessionManager.persistSessions", persistSessions);
+			snapshotInterval = pPrefsSvc->configuration()->getInt("osp.web.sessionManager.snapshotInterval", snapshotInterval);
 		}
 
 		Poco::StringTokenizer tok(compressedMediaTypesString, ",", Poco::StringTokenizer::TOK_TRIM | Poco::StringTokenizer::TOK_IGNORE_EMPTY);
@@ -98,9 +118,28 @@ public:
 		else if (sessionCookiePersistence != "persistent")
 			pContext->logger().warning(Poco::format("Ignoring invalid value for osp.web.sessionManager.cookiePersistence: '%s'. Valid values are 'transient' or 'persistent'.", sessionCookiePersistence));
 		
-		AutoPtr<WebSessionManager> pWebSessionManager = new WebSessionManager;
-		pWebSessionManager->setCookiePersistence(cookiePersistence);
-		_pWebSessionManagerSvc = pContext->registry().registerService(WebSessionManager::SERVICE_NAME, pWebSessionManager, Properties());
+		_pWebSessionManager = new WebSessionManager;
+		_pWebSessionManager->setCookiePersistence(cookiePersistence);
+		if (persistSessions)
+		{
+			_sessionsPath = Poco::Path(pContext->persistentDirectory(), "sessions.dat").toString();
+			try
+			{
+				std::size_t n = _pWebSessionManager->loadSessions(_sessionsPath, pContext);
+				pContext->logger().information(Poco::format("Restored %z sessions.", n));
+			}
+			catch (Poco::Exception& exc)
+			{
+				pContext->logger().warning(Poco::format("Cannot restore sessions from %s: %s", _sessionsPath, exc.displayText()));
+			}
+			if (snapshotInterval > 0)
+			{
+				_pWebSessionManager->scheduleSnapshots(_sessionsPath, 1000L*snapshotInterval);
+			}
+			pContext->systemEvents().systemShuttingDown += Poco::delegate(this, &WebBundleActivator::onSystemShuttingDown);
+			_pContext = pContext;
+		}
+		_pWebSessionManagerSvc = pContext->registry().registerService(WebSessionManager::SERVICE_NAME, _pWebSessionManager, Properties());
 
 		ServiceRef::Ptr pXPSRef = pContext->registry().findByName("osp.core.xp");
 		if (pXPSRef)
@@ -120,17 +159,42 @@ public:
 		
 	void stop(BundleContext::Ptr pContext)
 	{
+		if (_pContext)
+		{
+			pContext->systemEvents().systemShuttingDown -= Poco::delegate(this, &WebBundleActivator::onSystemShuttingDown);
+			_pContext = 0;
+		}
 		pContext->registry().unregisterService(_pWebSessionManagerSvc);
 		pContext->registry().unregisterService(_pWebServerDispatcherSvc);
 		pContext->registry().unregisterService(_pMediaTypeMapperSvc);
 		_pWebSessionManagerSvc = 0;
+		_pWebSessionManager = 0;
 		_pWebServerDispatcherSvc = 0;
 		_pMediaTypeMapperSvc = 0;
 		_pWebServerExtensionPoint = 0;
 		_pWebFilterExtensionPoint = 0;
 	}
+
+protected:
+	void onSystemShuttingDown(const void* pSender, SystemEvents::EventKind& kind)
+	{
+		// Sessions must be saved before the bundles owning them are stopped,
+		// as stopping a bundle clears the attributes of its sessions.
+		try
+		{
+			std::size_t n = _pWebSessionManager->saveSessions(_sessionsPath);
+			_pContext->logger().information(Poco::format("Saved %z sessions.", n));
+		}
+		catch (Poco::Exception& exc)
+		{
+			_pContext->logger().error(Poco::format("Cannot save sessions to %s: %s", _sessionsPath, exc.displayText()));
+		}
+	}
 	
 private:
+	BundleContext::Ptr _pContext;
+	AutoPtr<WebSessionManager> _pWebSessionManager;
+	std::string _sessionsPath;
 	ServiceRef::Ptr _pMediaTypeMapperSvc;
 	ServiceRef::Ptr _pWebServerDispatcherSvc;
 	ServiceRef::Ptr _pWebSessionManagerSvc;
@@ -456,8 +456,24 @@ void WebServerDispatcher::sendResource(Poco::Net::HTTPServerRequest& request, co
 				}
 			}
 	
-			response.setChunkedTransferEncoding(true);
 			bool compressResponse(_compressResponses && request.hasToken("Accept-Encoding", "gzip") && shouldCompressMediaType(mediaType));
+			if (!compressResponse && !(_cacheResources && canCache))
+			{
+				// If the resource is available as a region of a plain file (a file
+				// in a bundle directory, or a stored entry in a bundle archive),
+				// send it directly from the file, avoiding any copying.
+				std::string file;
+				Poco::UInt64 offset;
+				Poco::UInt64 length;
+				if (pBundle->getResourceFile(resolvedPath, file, offset, length))
+				{
+					pResourceStream.reset();
+					response.sendFile(file, offset, length, mediaType);
+					return;
+				}
+			}
+
+			response.setChunkedTransferEncoding(true);
 			if (compressResponse) response.set("Content-Encoding", "gzip");
 
 			std::ostream& responseStream = response.send();
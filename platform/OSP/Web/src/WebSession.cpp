@@ -103,8 +103,18 @@ void WebSession::clear()
 }
 
 
+Poco::Timestamp WebSession::getExpiration() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _expiration;
+}
+
+
 void WebSession::access()
 {
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
 	_expiration.update();
 	_expiration += _timeout.totalMicroseconds();
 }
@@ -18,11 +18,24 @@
 #include "Poco/Net/HTTPServerRequest.h"
 #include "Poco/Net/HTTPServerResponse.h"
 #include "Poco/Net/NameValueCollection.h"
+#include "Poco/Util/TimerTaskAdapter.h"
 #include "Poco/StringTokenizer.h"
 #include "Poco/NumberParser.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/SHA1Engine.h"
 #include "Poco/RandomStream.h"
+#include "Poco/BinaryWriter.h"
+#include "Poco/BinaryReader.h"
+#include "Poco/FileStream.h"
+#include "Poco/File.h"
+#include "Poco/Hash.h"
+#include "Poco/Exception.h"
+#if defined(POCO_OS_FAMILY_UNIX)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 
 using Poco::Net::NameValueCollection;
@@ -35,19 +48,49 @@ namespace OSP {
 namespace Web {
 
 
+namespace
+{
+	void createPrivateFile(const std::string& path)
+		/// Creates a new, empty file that can only be read
+		/// and written by its owner. An existing file with
+		/// the same path is removed first.
+	{
+		Poco::File file(path);
+		if (file.exists()) file.remove();
+#if defined(POCO_OS_FAMILY_UNIX)
+		int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+		if (fd == -1) throw Poco::CreateFileException(path);
+		::close(fd);
+#else
+		file.createFile();
+#endif
+	}
+}
+
+
 const std::string WebSessionManager::COOKIE_NAME("osp.web.session");
 const std::string WebSessionManager::SERVICE_NAME("osp.web.session");
+const std::string WebSessionManager::FILE_MAGIC("OSPWebSessions/1");
 
 
 WebSessionManager::WebSessionManager():
-	_serial(0),
+	_wheelTime(Poco::Timestamp().epochTime()),
 	_cookiePersistence(COOKIE_PERSISTENT)
 {
+	_timer.schedule(new Poco::Util::TimerTaskAdapter<WebSessionManager>(*this, &WebSessionManager::onExpire), EXPIRE_INTERVAL, EXPIRE_INTERVAL);
 }
 
 
 WebSessionManager::~WebSessionManager()
 {
+	try
+	{
+		_timer.cancel(true);
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
 }
 
 
@@ -87,6 +130,176 @@ WebSessionManager::CookiePersistence WebSessionManager::getCookiePersistence() c
 }
 
 
+std::size_t WebSessionManager::count() const
+{
+	std::size_t n = 0;
+	for (int i = 0; i < SHARD_COUNT; i++)
+	{
+		FastMutex::ScopedLock lock(_shards[i].mutex);
+		n += _shards[i].sessions.size();
+	}
+	return n;
+}
+
+
+std::size_t WebSessionManager::saveSessions(const std::string& path)
+{
+	std::vector<WebSession::Ptr> sessions;
+	for (int i = 0; i < SHARD_COUNT; i++)
+	{
+		FastMutex::ScopedLock lock(_shards[i].mutex);
+		for (SessionMap::const_iterator it = _shards[i].sessions.begin(); it != _shards[i].sessions.end(); ++it)
+		{
+			sessions.push_back(it->second);
+		}
+	}
+
+	FastMutex::ScopedLock lock(_snapshotMutex);
+
+	std::string tempPath(path);
+	tempPath += ".tmp";
+	std::size_t n = 0;
+	createPrivateFile(tempPath);
+	{
+		Poco::FileOutputStream ostr(tempPath);
+		Poco::BinaryWriter writer(ostr, Poco::BinaryWriter::LITTLE_ENDIAN_BYTE_ORDER);
+		writer << FILE_MAGIC;
+		Poco::Timestamp now;
+		for (std::vector<WebSession::Ptr>::const_iterator it = sessions.begin(); it != sessions.end(); ++it)
+		{
+			const WebSession& session = **it;
+			FastMutex::ScopedLock sessionLock(session._mutex);
+			
+			if (session._expiration <= now) continue;
+			writer << true;
+			writer << session._id << session._clientAddress.toString() << static_cast<Poco::Int32>(session._timeout.totalSeconds());
+			writer << static_cast<Poco::Int64>(session._created.epochMicroseconds()) << static_cast<Poco::Int64>(session._expiration.epochMicroseconds());
+			for (WebSession::Attributes::const_iterator itAttr = session._attrs.begin(); itAttr != session._attrs.end(); ++itAttr)
+			{
+				const Poco::Any& value = itAttr->second;
+				if (value.type() == typeid(std::string))
+					writer << 's' << itAttr->first << Poco::RefAnyCast<std::string>(value);
+				else if (value.type() == typeid(int))
+					writer << 'i' << itAttr->first << static_cast<Poco::Int32>(Poco::RefAnyCast<int>(value));
+				else if (value.type() == typeid(Poco::Int64))
+					writer << 'l' << itAttr->first << Poco::RefAnyCast<Poco::Int64>(value);
+				else if (value.type() == typeid(bool))
+					writer << 'b' << itAttr->first << Poco::RefAnyCast<bool>(value);
+				else if (value.type() == typeid(double))
+					writer << 'd' << itAttr->first << Poco::RefAnyCast<double>(value);
+			}
+			writer << '\0';
+			n++;
+		}
+		writer << false;
+		writer.flush();
+		if (!writer.good()) throw Poco::WriteFileException(tempPath);
+		ostr.close();
+	}
+	Poco::File(tempPath).renameTo(path);
+	return n;
+}
+
+
+std::size_t WebSessionManager::loadSessions(const std::string& path, BundleContext::Ptr pContext)
+{
+	if (!Poco::File(path).exists()) return 0;
+
+	Poco::FileInputStream istr(path);
+	Poco::BinaryReader reader(istr, Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
+	std::string magic;
+	reader >> magic;
+	if (magic != FILE_MAGIC) throw Poco::DataFormatException("Not a session file", path);
+
+	Poco::Timestamp now;
+	std::size_t n = 0;
+	bool more = false;
+	reader >> more;
+	while (more && reader.good())
+	{
+		std::string id;
+		std::string clientAddress;
+		Poco::Int32 timeout;
+		Poco::Int64 created;
+		Poco::Int64 expiration;
+		reader >> id >> clientAddress >> timeout >> created >> expiration;
+		WebSession::Attributes attrs;
+		char type = 0;
+		reader >> type;
+		while (type != 0 && reader.good())
+		{
+			std::string name;
+			reader >> name;
+			switch (type)
+			{
+			case 's':
+				{
+					std::string value;
+					reader >> value;
+					attrs[name] = value;
+				}
+				break;
+			case 'i':
+				{
+					Poco::Int32 value;
+					reader >> value;
+					attrs[name] = static_cast<int>(value);
+				}
+				break;
+			case 'l':
+				{
+					Poco::Int64 value;
+					reader >> value;
+					attrs[name] = value;
+				}
+				break;
+			case 'b':
+				{
+					bool value;
+					reader >> value;
+					attrs[name] = value;
+				}
+				break;
+			case 'd':
+				{
+					double value;
+					reader >> value;
+					attrs[name] = value;
+				}
+				break;
+			default:
+				throw Poco::DataFormatException("Invalid attribute type in session file", path);
+			}
+			reader >> type;
+		}
+		if (!reader.good()) break;
+
+		if (Poco::Timestamp(expiration) > now)
+		{
+			WebSession::Ptr pSession(new WebSession(id, timeout, Poco::Net::IPAddress(clientAddress), pContext));
+			pSession->_created = Poco::Timestamp(created);
+			pSession->_expiration = Poco::Timestamp(expiration);
+			pSession->_attrs.swap(attrs);
+			if (add(pSession)) n++;
+		}
+		reader >> more;
+	}
+	if (!reader.good()) throw Poco::DataFormatException("Truncated session file", path);
+	return n;
+}
+
+
+void WebSessionManager::scheduleSnapshots(const std::string& path, long interval)
+{
+	{
+		FastMutex::ScopedLock lock(_snapshotMutex);
+
+		_snapshotPath = path;
+	}
+	_timer.schedule(new Poco::Util::TimerTaskAdapter<WebSessionManager>(*this, &WebSessionManager::onSnapshot), interval, interval);
+}
+
+
 const std::type_info& WebSessionManager::type() const
 {
 	return typeid(WebSessionManager);
@@ -102,24 +315,36 @@ bool WebSessionManager::isA(const std::type_info& otherType) const
 
 WebSession::Ptr WebSessionManager::find(const std::string& appName, const Poco::Net::HTTPServerRequest& request)
 {
-	FastMutex::ScopedLock lock(_mutex);
-	
-	WebSession::Ptr pSession(_cache.get(getId(appName, request)));
-	if (pSession)
+	std::string id(getId(appName, request));
+	if (id.empty()) return 0;
+
+	WebSession::Ptr pSession;
+	WebSession::Ptr pRemoved; // released after the shard has been unlocked
 	{
-		if (pSession->clientAddress() == request.clientAddress().host())
-		{
-			pSession->access();
-			_cache.add(pSession->id(), pSession);
-			addCookie(appName, request, pSession);
-		}
-		else 
+		Shard& sessionShard = shard(id);
+		FastMutex::ScopedLock lock(sessionShard.mutex);
+
+		SessionMap::iterator it = sessionShard.sessions.find(id);
+		if (it != sessionShard.sessions.end())
 		{
-			// possible attack: same session ID from different host - invalidate session
-			_cache.remove(pSession->id());
-			return 0;
+			if (it->second->clientAddress() == request.clientAddress().host() && it->second->getExpiration() > Poco::Timestamp())
+			{
+				pSession = it->second;
+				pSession->access();
+			}
+			else
+			{
+				// possible attack: same session ID from different host - invalidate session;
+				// or session has expired, but not yet been removed
+				pRemoved = it->second;
+				sessionShard.sessions.erase(it);
+			}
 		}
 	}
+	if (pSession)
+	{
+		addCookie(appName, request, pSession);
+	}
 	return pSession;
 }
 
@@ -135,19 +360,111 @@ WebSession::Ptr WebSessionManager::get(const std::string& appName, const Poco::N
 
 WebSession::Ptr WebSessionManager::create(const std::string& appName, const Poco::Net::HTTPServerRequest& request, int expireSeconds, BundleContext::Ptr pContext)
 {
-	FastMutex::ScopedLock lock(_mutex);
 	WebSession::Ptr pSession(new WebSession(createSessionId(request), expireSeconds, request.clientAddress().host(), pContext));
-	_cache.add(pSession->id(), pSession);
-	addCookie(appName, request, pSession);
 	pSession->setValue(WebSession::CSRF_TOKEN, createSessionId(request));
+	add(pSession);
+	addCookie(appName, request, pSession);
 	return pSession;
 }
 
 
 void WebSessionManager::remove(WebSession::Ptr pSession)
 {
-	FastMutex::ScopedLock lock(_mutex);
-	_cache.remove(pSession->id());
+	Shard& sessionShard = shard(pSession->id());
+	FastMutex::ScopedLock lock(sessionShard.mutex);
+
+	sessionShard.sessions.erase(pSession->id());
+}
+
+
+WebSessionManager::Shard& WebSessionManager::shard(const std::string& id)
+{
+	return _shards[Poco::hash(id) % SHARD_COUNT];
+}
+
+
+bool WebSessionManager::add(WebSession::Ptr pSession)
+{
+	{
+		Shard& sessionShard = shard(pSession->id());
+		FastMutex::ScopedLock lock(sessionShard.mutex);
+
+		if (!sessionShard.sessions.insert(SessionMap::value_type(pSession->id(), pSession)).second)
+			return false;
+	}
+	schedule(pSession->id(), pSession->getExpiration());
+	return true;
+}
+
+
+void WebSessionManager::schedule(const std::string& id, const Poco::Timestamp& expiration)
+{
+	Poco::Int64 slotTime = (expiration.epochMicroseconds() + Poco::Timestamp::resolution() - 1)/Poco::Timestamp::resolution();
+
+	FastMutex::ScopedLock lock(_wheelMutex);
+
+	if (slotTime <= _wheelTime) slotTime = _wheelTime + 1;
+	_wheel[slotTime % WHEEL_SIZE].push_back(id);
+}
+
+
+void WebSessionManager::expire(const Poco::Timestamp& now)
+{
+	Poco::Int64 nowTime = now.epochMicroseconds()/Poco::Timestamp::resolution();
+	IdVec due;
+	{
+		FastMutex::ScopedLock lock(_wheelMutex);
+
+		Poco::Int64 firstTime = _wheelTime + 1;
+		if (nowTime - firstTime >= WHEEL_SIZE) firstTime = nowTime - WHEEL_SIZE + 1;
+		for (Poco::Int64 t = firstTime; t <= nowTime; t++)
+		{
+			IdVec& slot = _wheel[t % WHEEL_SIZE];
+			due.insert(due.end(), slot.begin(), slot.end());
+			slot.clear();
+		}
+		if (nowTime > _wheelTime) _wheelTime = nowTime;
+	}
+
+	std::vector<WebSession::Ptr> expired; // released after the shards have been unlocked
+	for (IdVec::const_iterator it = due.begin(); it != due.end(); ++it)
+	{
+		Poco::Timestamp expiration;
+		{
+			Shard& sessionShard = shard(*it);
+			FastMutex::ScopedLock lock(sessionShard.mutex);
+
+			SessionMap::iterator itSession = sessionShard.sessions.find(*it);
+			if (itSession == sessionShard.sessions.end()) continue;
+			expiration = itSession->second->getExpiration();
+			if (expiration <= now)
+			{
+				expired.push_back(itSession->second);
+				sessionShard.sessions.erase(itSession);
+				continue;
+			}
+		}
+		// session has been accessed since it was scheduled
+		schedule(*it, expiration);
+	}
+}
+
+
+void WebSessionManager::onExpire(Poco::Util::TimerTask& task)
+{
+	expire(Poco::Timestamp());
+}
+
+
+void WebSessionManager::onSnapshot(Poco::Util::TimerTask& task)
+{
+	std::string path;
+	{
+		FastMutex::ScopedLock lock(_snapshotMutex);
+
+		path = _snapshotPath;
+	}
+	saveSessions(path);
 }
 
 
@@ -181,10 +498,10 @@ void WebSessionManager::addCookie(const std::string& appName, const Poco::Net::H
 
 std::string WebSessionManager::createSessionId(const Poco::Net::HTTPServerRequest& request)
 {
-	++_serial;
+	Poco::AtomicCounter::ValueType serial = ++_serial;
 	
 	Poco::SHA1Engine sha1;
-	sha1.update(&_serial, sizeof(_serial));
+	sha1.update(&serial, sizeof(serial));
 	Poco::Timestamp::TimeVal tv = Poco::Timestamp().epochMicroseconds();
 	sha1.update(&tv, sizeof(tv));
 	Poco::RandomInputStream ris;
@@ -0,0 +1,471 @@
+//
+// WebSessionManagerTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "WebSessionManagerTest.h"
+#include "Poco/OSP/Web/WebSessionManager.h"
+#include "Poco/OSP/Bundle.h"
+#include "Poco/OSP/BundleFactory.h"
+#include "Poco/OSP/BundleContextFactory.h"
+#include "Poco/OSP/BundleLoader.h"
+#include "Poco/OSP/BundleEvents.h"
+#include "Poco/OSP/CodeCache.h"
+#include "Poco/OSP/ServiceRegistry.h"
+#include "Poco/OSP/LanguageTag.h"
+#include "Poco/OSP/SystemEvents.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPCookie.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NameValueCollection.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/Thread.h"
+#include "Poco/Exception.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include <sstream>
+#include <fstream>
+#include <vector>
+#if defined(POCO_OS_FAMILY_UNIX)
+#include <sys/stat.h>
+#endif
+
+
+using namespace Poco::OSP::Web;
+using namespace Poco::OSP;
+
+
+namespace
+{
+	class TestServerResponse: public Poco::Net::HTTPServerResponse
+	{
+	public:
+		void sendContinue()
+		{
+		}
+
+		std::ostream& send()
+		{
+			return _ostr;
+		}
+
+		void sendFile(const std::string& path, const std::string& mediaType)
+		{
+		}
+
+		void sendBuffer(const void* pBuffer, std::size_t length)
+		{
+		}
+
+		void redirect(const std::string& uri, HTTPStatus status)
+		{
+		}
+
+		void requireAuthentication(const std::string& realm)
+		{
+		}
+
+		bool sent() const
+		{
+			return false;
+		}
+
+		std::string cookie(const std::string& name) const
+			/// Returns the value of the cookie with the given name
+			/// set in the response, or an empty string.
+		{
+			std::vector<Poco::Net::HTTPCookie> cookies;
+			getCookies(cookies);
+			for (std::vector<Poco::Net::HTTPCookie>::const_iterator it = cookies.begin(); it != cookies.end(); ++it)
+			{
+				if (it->getName() == name) return it->getValue();
+			}
+			return std::string();
+		}
+
+	private:
+		std::ostringstream _ostr;
+	};
+
+	class TestServerRequest: public Poco::Net::HTTPServerRequest
+	{
+	public:
+		TestServerRequest(const std::string& clientHost, const std::string& sessionCookie = ""):
+			_clientAddress(clientHost, 40000),
+			_serverAddress("127.0.0.1", 22080),
+			_pParams(new Poco::Net::HTTPServerParams)
+		{
+			if (!sessionCookie.empty())
+			{
+				Poco::Net::NameValueCollection cookies;
+				cookies.add(COOKIE_NAME, sessionCookie);
+				setCookies(cookies);
+			}
+		}
+
+		std::istream& stream()
+		{
+			return _istr;
+		}
+
+		bool expectContinue() const
+		{
+			return false;
+		}
+
+		const Poco::Net::SocketAddress& clientAddress() const
+		{
+			return _clientAddress;
+		}
+
+		const Poco::Net::SocketAddress& serverAddress() const
+		{
+			return _serverAddress;
+		}
+
+		const Poco::Net::HTTPServerParams& serverParams() const
+		{
+			return *_pParams;
+		}
+
+		Poco::Net::HTTPServerResponse& response() const
+		{
+			return _response;
+		}
+
+		std::string sessionCookie() const
+		{
+			return _response.cookie(COOKIE_NAME);
+		}
+
+		static const std::string APP_NAME;
+		static const std::string COOKIE_NAME;
+
+	private:
+		std::istringstream _istr;
+		Poco::Net::SocketAddress _clientAddress;
+		Poco::Net::SocketAddress _serverAddress;
+		Poco::Net::HTTPServerParams::Ptr _pParams;
+		mutable TestServerResponse _response;
+	};
+
+	const std::string TestServerRequest::APP_NAME("test");
+	const std::string TestServerRequest::COOKIE_NAME("osp.web.session.test");
+
+	class TestFramework
+		/// Provides the BundleContext required for creating sessions.
+	{
+	public:
+		TestFramework():
+			_codeCache("codeCache"),
+			_language("en", "US"),
+			_pBundleFactory(new BundleFactory(_language)),
+			_pBundleContextFactory(new BundleContextFactory(_registry, _systemEvents)),
+			_loader(_codeCache, _pBundleFactory, _pBundleContextFactory)
+		{
+			_pBundle = _loader.createBundle("testBundle.zip");
+			_pContext = _pBundleContextFactory->createBundleContext(_loader, _pBundle, _events);
+		}
+
+		BundleContext::Ptr context() const
+		{
+			return _pContext;
+		}
+
+	private:
+		CodeCache _codeCache;
+		ServiceRegistry _registry;
+		LanguageTag _language;
+		SystemEvents _systemEvents;
+		BundleFactory::Ptr _pBundleFactory;
+		BundleContextFactory::Ptr _pBundleContextFactory;
+		BundleLoader _loader;
+		BundleEvents _events;
+		Bundle::Ptr _pBundle;
+		BundleContext::Ptr _pContext;
+	};
+}
+
+
+WebSessionManagerTest::WebSessionManagerTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+WebSessionManagerTest::~WebSessionManagerTest()
+{
+}
+
+
+void WebSessionManagerTest::testCreateFind()
+{
+	TestFramework framework;
+	WebSessionManager::Ptr pManager = new WebSessionManager;
+	assert (pManager->count() == 0);
+
+	TestServerRequest request1("192.168.1.10");
+	assert (pManager->find(TestServerRequest::APP_NAME, request1).isNull());
+
+	WebSession::Ptr pSession = pManager->get(TestServerRequest::APP_NAME, request1, 60, framework.context());
+	assert (!pSession.isNull());
+	assert (pSession->timeout() == 60);
+	assert (!pSession->csrfToken().empty());
+	assert (request1.sessionCookie() == pSession->id());
+	assert (pManager->count() == 1);
+
+	TestServerRequest request2("192.168.1.10", pSession->id());
+	WebSession::Ptr pFound = pManager->find(TestServerRequest::APP_NAME, request2);
+	assert (pFound.get() == pSession.get());
+	assert (request2.sessionCookie() == pSession->id());
+
+	TestServerRequest request3("192.168.1.10", pSession->id());
+	pFound = pManager->get(TestServerRequest::APP_NAME, request3, 60, framework.context());
+	assert (pFound.get() == pSession.get());
+	assert (pManager->count() == 1);
+
+	TestServerRequest request4("192.168.1.10", "0123456789abcdef0123456789abcdef01234567");
+	assert (pManager->find(TestServerRequest::APP_NAME, request4).isNull());
+
+	std::vector<WebSession::Ptr> sessions;
+	for (int i = 0; i < 200; i++)
+	{
+		TestServerRequest request("192.168.1.11");
+		sessions.push_back(pManager->create(TestServerRequest::APP_NAME, request, 60, framework.context()));
+	}
+	assert (pManager->count() == 201);
+	for (std::vector<WebSession::Ptr>::const_iterator it = sessions.begin(); it != sessions.end(); ++it)
+	{
+		TestServerRequest request("192.168.1.11", (*it)->id());
+		assert (pManager->find(TestServerRequest::APP_NAME, request).get() == it->get());
+	}
+	pManager = 0;
+}
+
+
+void WebSessionManagerTest::testClientAddress()
+{
+	TestFramework framework;
+	WebSessionManager::Ptr pManager = new WebSessionManager;
+
+	TestServerRequest request1("192.168.1.10");
+	WebSession::Ptr pSession = pManager->create(TestServerRequest::APP_NAME, request1, 60, framework.context());
+
+	TestServerRequest request2("192.168.1.20", pSession->id());
+	assert (pManager->find(TestServerRequest::APP_NAME, request2).isNull());
+	assert (pManager->count() == 0);
+
+	TestServerRequest request3("192.168.1.10", pSession->id());
+	assert (pManager->find(TestServerRequest::APP_NAME, request3).isNull());
+	pManager = 0;
+}
+
+
+void WebSessionManagerTest::testRemove()
+{
+	TestFramework framework;
+	WebSessionManager::Ptr pManager = new WebSessionManager;
+
+	TestServerRequest request1("192.168.1.10");
+	WebSession::Ptr pSession = pManager->create(TestServerRequest::APP_NAME, request1, 60, framework.context());
+	assert (pManager->count() == 1);
+	pManager->remove(pSession);
+	assert (pManager->count() == 0);
+
+	TestServerRequest request2("192.168.1.10", pSession->id());
+	assert (pManager->find(TestServerRequest::APP_NAME, request2).isNull());
+	pManager = 0;
+}
+
+
+void WebSessionManagerTest::testExpire()
+{
+	TestFramework framework;
+	WebSessionManager::Ptr pManager = new WebSessionManager;
+
+	TestServerRequest request1("192.168.1.10");
+	WebSession::Ptr pIdle = pManager->create(TestServerRequest::APP_NAME, request1, 1, framework.context());
+	std::string idleId = pIdle->id();
+	pIdle = 0;
+	TestServerRequest request2("192.168.1.10");
+	std::string activeId = pManager->create(TestServerRequest::APP_NAME, request2, 1, framework.context())->id();
+	assert (pManager->count() == 2);
+
+	// the active session is kept alive by requests, the idle
+	// session is removed by the timer without being looked up
+	for (int i = 0; i < 10; i++)
+	{
+		Poco::Thread::sleep(300);
+		TestServerRequest request("192.168.1.10", activeId);
+		assert (!pManager->find(TestServerRequest::APP_NAME, request).isNull());
+	}
+	assert (pManager->count() == 1);
+
+	TestServerRequest request3("192.168.1.10", idleId);
+	assert (pManager->find(TestServerRequest::APP_NAME, request3).isNull());
+
+	Poco::Thread::sleep(2500);
+	assert (pManager->count() == 0);
+	pManager = 0;
+}
+
+
+void WebSessionManagerTest::testSaveLoad()
+{
+	TestFramework framework;
+	Poco::TemporaryFile file;
+	std::string id;
+	std::string csrfToken;
+	Poco::Timestamp created;
+	{
+		WebSessionManager::Ptr pManager = new WebSessionManager;
+		assert (pManager->saveSessions(file.path()) == 0);
+
+		TestServerRequest request1("192.168.1.10");
+		WebSession::Ptr pSession = pManager->create(TestServerRequest::APP_NAME, request1, 3600, framework.context());
+		pSession->set("username", std::string("admin"));
+		pSession->setValue("count", 42);
+		pSession->setValue("total", Poco::Int64(10000000000LL));
+		pSession->setValue("enabled", true);
+		pSession->setValue("ratio", 0.25);
+		pSession->setValue("list", std::vector<int>(3));
+		id = pSession->id();
+		csrfToken = pSession->csrfToken();
+		created = pSession->created();
+
+		TestServerRequest request2("10.0.0.1");
+		pManager->create(TestServerRequest::APP_NAME, request2, 3600, framework.context());
+		assert (pManager->saveSessions(file.path()) == 2);
+		assert (!Poco::File(file.path() + ".tmp").exists());
+#if defined(POCO_OS_FAMILY_UNIX)
+		struct stat st;
+		assert (stat(file.path().c_str(), &st) == 0);
+		assert ((st.st_mode & 0777) == 0600);
+#endif
+	}
+
+	WebSessionManager::Ptr pManager = new WebSessionManager;
+	assert (pManager->loadSessions(file.path(), framework.context()) == 2);
+	assert (pManager->count() == 2);
+	assert (pManager->loadSessions(file.path(), framework.context()) == 0);
+	assert (pManager->count() == 2);
+
+	TestServerRequest request("192.168.1.10", id);
+	WebSession::Ptr pSession = pManager->find(TestServerRequest::APP_NAME, request);
+	assert (!pSession.isNull());
+	assert (pSession->timeout() == 3600);
+	assert (pSession->created() == created);
+	assert (pSession->csrfToken() == csrfToken);
+	assert (pSession->getValue<std::string>("username") == "admin");
+	assert (pSession->getValue<int>("count") == 42);
+	assert (pSession->getValue<Poco::Int64>("total") == 10000000000LL);
+	assert (pSession->getValue<bool>("enabled"));
+	assert (pSession->getValue<double>("ratio") == 0.25);
+	assert (!pSession->has("list"));
+
+	assert (pManager->loadSessions(file.path() + ".missing", framework.context()) == 0);
+	pSession = 0;
+	pManager = 0;
+}
+
+
+void WebSessionManagerTest::testLoadInvalid()
+{
+	TestFramework framework;
+	WebSessionManager::Ptr pManager = new WebSessionManager;
+	Poco::TemporaryFile file;
+	{
+		Poco::FileOutputStream ostr(file.path());
+		ostr << "not a session file";
+	}
+	try
+	{
+		pManager->loadSessions(file.path(), framework.context());
+		fail("invalid file - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+
+	TestServerRequest request("192.168.1.10");
+	pManager->create(TestServerRequest::APP_NAME, request, 3600, framework.context());
+	pManager->saveSessions(file.path());
+	Poco::File(file.path()).setSize(Poco::File(file.path()).getSize() - 10);
+	WebSessionManager::Ptr pOther = new WebSessionManager;
+	try
+	{
+		pOther->loadSessions(file.path(), framework.context());
+		fail("truncated file - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+	pOther = 0;
+	pManager = 0;
+}
+
+
+void WebSessionManagerTest::setUp()
+{
+	// The same bundle as used by WebServerDispatcherTest.
+	static const unsigned char TEST_BUNDLE_ZIP[] = 
+	{
+		0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x36, 0x46, 0x85, 0x36, 0x2a, 0x71,
+		0x30, 0xee, 0x9d, 0x00, 0x00, 0x00, 0xec, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x4d, 0x45,
+		0x54, 0x41, 0x2d, 0x49, 0x4e, 0x46, 0x2f, 0x6d, 0x61, 0x6e, 0x69, 0x66, 0x65, 0x73, 0x74, 0x2e,
+		0x6d, 0x66, 0x6d, 0xcd, 0x3d, 0x0b, 0xc2, 0x30, 0x14, 0x85, 0xe1, 0x5d, 0xe8, 0x7f, 0xb8, 0xa3,
+		0x82, 0x2d, 0xad, 0x8b, 0x90, 0x4d, 0x45, 0xd4, 0xc1, 0x0f, 0x08, 0x74, 0x4f, 0xd3, 0xdb, 0x7a,
+		0x21, 0xb9, 0x09, 0x49, 0x44, 0xfa, 0xef, 0x05, 0x0b, 0xb5, 0x83, 0xeb, 0xe1, 0x39, 0xbc, 0x57,
+		0xc5, 0xd4, 0x61, 0x4c, 0x79, 0x8d, 0x21, 0x92, 0x63, 0x01, 0x55, 0x51, 0x66, 0x8b, 0xfd, 0x8b,
+		0x5b, 0x83, 0xf9, 0x4d, 0x59, 0x14, 0x70, 0x97, 0x0f, 0x90, 0xca, 0x7a, 0x83, 0x30, 0xee, 0x50,
+		0x4d, 0x42, 0x0e, 0xb6, 0x71, 0x86, 0xf4, 0x28, 0xb5, 0xb3, 0x85, 0xf2, 0x9e, 0xb8, 0x2b, 0x5c,
+		0xf4, 0x45, 0xf3, 0x35, 0x3f, 0x3c, 0x6f, 0xcc, 0x2a, 0x35, 0x72, 0xeb, 0x82, 0x80, 0x9d, 0xf7,
+		0x86, 0xb0, 0x85, 0x0b, 0x77, 0x2e, 0x58, 0x95, 0x48, 0xc7, 0xc9, 0x1c, 0x9c, 0x1f, 0x02, 0xf5,
+		0xcf, 0x24, 0x60, 0xa9, 0x57, 0xb0, 0x29, 0xcb, 0xed, 0xfa, 0xdf, 0x01, 0xa4, 0xeb, 0xd2, 0x5b,
+		0x05, 0x84, 0x23, 0xf7, 0xc4, 0x88, 0x81, 0xb8, 0x87, 0x93, 0x6d, 0xce, 0xd9, 0xe2, 0x03, 0x50,
+		0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf7, 0x45, 0x85, 0x36, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x4d, 0x45, 0x54,
+		0x41, 0x2d, 0x49, 0x4e, 0x46, 0x2f, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x00, 0x14, 0x00, 0x00, 0x00,
+		0x08, 0x00, 0x36, 0x46, 0x85, 0x36, 0x2a, 0x71, 0x30, 0xee, 0x9d, 0x00, 0x00, 0x00, 0xec, 0x00,
+		0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x21, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x4d, 0x45, 0x54, 0x41, 0x2d, 0x49, 0x4e, 0x46, 0x2f, 0x6d, 0x61, 0x6e,
+		0x69, 0x66, 0x65, 0x73, 0x74, 0x2e, 0x6d, 0x66, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x00, 0x0a, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xf7, 0x45, 0x85, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+		0x00, 0x00, 0xcf, 0x00, 0x00, 0x00, 0x4d, 0x45, 0x54, 0x41, 0x2d, 0x49, 0x4e, 0x46, 0x2f, 0x50,
+		0x4b, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x79, 0x00, 0x00, 0x00, 0xf6,
+		0x00, 0x00, 0x00, 0x00, 0x00
+	};
+
+	std::ofstream ostr("testBundle.zip", std::ios::binary);
+	ostr.write(reinterpret_cast<const char*>(&TEST_BUNDLE_ZIP[0]), sizeof(TEST_BUNDLE_ZIP));
+}
+
+
+void WebSessionManagerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* WebSessionManagerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("WebSessionManagerTest");
+
+	CppUnit_addTest(pSuite, WebSessionManagerTest, testCreateFind);
+	CppUnit_addTest(pSuite, WebSessionManagerTest, testClientAddress);
+	CppUnit_addTest(pSuite, WebSessionManagerTest, testRemove);
+	CppUnit_addTest(pSuite, WebSessionManagerTest, testExpire);
+	CppUnit_addTest(pSuite, WebSessionManagerTest, testSaveLoad);
+	CppUnit_addTest(pSuite, WebSessionManagerTest, testLoadInvalid);
+
+	return pSuite;
+}
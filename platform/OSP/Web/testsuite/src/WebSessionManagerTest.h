@@ -0,0 +1,43 @@
+//
+// WebSessionManagerTest.h
+//
+// $Id$
+//
+// Definition of the WebSessionManagerTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef WebSessionManagerTest_INCLUDED
+#define WebSessionManagerTest_INCLUDED
+
+
+#include "Poco/OSP/Web/Web.h"
+#include "CppUnit/TestCase.h"
+
+
+class WebSessionManagerTest: public CppUnit::TestCase
+{
+public:
+	WebSessionManagerTest(const std::string& name);
+	~WebSessionManagerTest();
+
+	void testCreateFind();
+	void testClientAddress();
+	void testRemove();
+	void testExpire();
+	void testSaveLoad();
+	void testLoadInvalid();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // WebSessionManagerTest_INCLUDED
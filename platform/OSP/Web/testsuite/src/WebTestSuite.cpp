@@ -13,6 +13,7 @@
 #include "WebTestSuite.h"
 #include "WebServerDispatcherTest.h"
 #include "MediaTypeMapperTest.h"
+#include "WebSessionManagerTest.h"
 
 
 CppUnit::Test* WebTestSuite::suite()
@@ -21,6 +22,7 @@ CppUnit::Test* WebTestSuite::suite()
 
 	pSuite->addTest(WebServerDispatcherTest::suite());
 	pSuite->addTest(MediaTypeMapperTest::suite());
+	pSuite->addTest(WebSessionManagerTest::suite());
 
 	return pSuite;
 }
@@ -194,6 +194,22 @@ public:
 		/// The caller gets ownership of the input stream and
 		/// must delete it when it's no longer needed.
 
+	bool getResourceFile(const std::string& name, std::string& file, Poco::UInt64& offset, Poco::UInt64& length) const;
+		/// Looks up the bundle's (non-localized) resource with
+		/// the given name, in the same way as getResource().
+		///
+		/// If the resource exists and its content is stored
+		/// uncompressed in a contiguous region of a file
+		/// (which is the case for bundle directories, and for
+		/// stored entries in bundle archive files), stores the path
+		/// of the file, and offset and length of the region,
+		/// and returns true.
+		///
+		/// Otherwise, returns false, and the resource (if it
+		/// exists) must be read with getResource().
+		///
+		/// See BundleStorage::getResourceFile() for more information.
+
 	std::istream* getLocalizedResource(const std::string& name) const;
 		/// Creates and returns an input stream for reading
 		/// the bundle's localized resource with the given
@@ -41,6 +41,7 @@ public:
 
 	// BundleStorage
 	std::istream* getResource(const std::string& path) const;
+	bool getResourceFile(const std::string& path, std::string& file, Poco::UInt64& offset, Poco::UInt64& length) const;
 	void list(const std::string& path, std::vector<std::string>& files) const;	
 	Poco::Timestamp lastModified(const std::string& path) const;	
 	std::string path() const;
@@ -56,6 +56,18 @@ public:
 		/// The caller receives ownership of, and is responsible for 
 		/// deleting the input stream when it's no longer needed.
 		
+	virtual bool getResourceFile(const std::string& path, std::string& file, Poco::UInt64& offset, Poco::UInt64& length) const;
+		/// If the content of the resource with the given path is
+		/// stored uncompressed in a contiguous region of a file in
+		/// the file system, stores the path of that file in file, the
+		/// offset and length of the region in offset and length,
+		/// and returns true. Otherwise, returns false.
+		///
+		/// This allows the resource to be sent to a socket directly
+		/// from the file, using StreamSocket::sendFile().
+		///
+		/// The default implementation returns false.
+
 	virtual void list(const std::string& path, std::vector<std::string>& files) const = 0;
 		/// List all files in the directory specified by path.
 		/// If path is empty, all files in the bundle root directory
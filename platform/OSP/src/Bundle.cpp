@@ -148,6 +148,32 @@ std::istream* Bundle::getResource(const std::string& name) const
 }
 
 
+bool Bundle::getResourceFile(const std::string& name, std::string& file, Poco::UInt64& offset, Poco::UInt64& length) const
+{
+	if (_pStorage->getResourceFile(name, file, offset, length)) return true;
+
+	Poco::FastMutex::ScopedLock lock(_extensionBundlesMutex);
+
+	if (_extensionBundles.empty()) return false;
+
+	// The resource may exist, but not be available as a file
+	// region (e.g., if it's compressed). In this case, getResource()
+	// would not search the extension bundles, so we must not either.
+	std::auto_ptr<std::istream> pStream(_pStorage->getResource(name));
+	if (pStream.get()) return false;
+
+	std::set<Bundle::Ptr>::const_iterator it = _extensionBundles.begin();
+	std::set<Bundle::Ptr>::const_iterator end = _extensionBundles.end();
+	for (; it != end; ++it)
+	{
+		if ((*it)->getResourceFile(name, file, offset, length)) return true;
+		pStream.reset((*it)->getResource(name));
+		if (pStream.get()) return false;
+	}
+	return false;
+}
+
+
 std::istream* Bundle::getLocalizedResource(const std::string& name) const
 {
 	return getLocalizedResource(name, _language);
@@ -53,6 +53,21 @@ std::istream* BundleDirectory::getResource(const std::string& path) const
 }
 
 
+bool BundleDirectory::getResourceFile(const std::string& path, std::string& file, Poco::UInt64& offset, Poco::UInt64& length) const
+{
+	Path p(buildPath(path));
+	File f(p);
+	if (f.exists() && f.isFile())
+	{
+		file   = f.path();
+		offset = 0;
+		length = f.getSize();
+		return true;
+	}
+	else return false;
+}
+
+
 void BundleDirectory::list(const std::string& path, std::vector<std::string>& files) const	
 {
 	files.clear();
@@ -87,6 +87,30 @@ std::istream* BundleFile::getResource(const std::string& path) const
 }
 
 
+bool BundleFile::getResourceFile(const std::string& path, std::string& file, Poco::UInt64& offset, Poco::UInt64& length) const
+{
+	poco_assert (_pArchive);
+
+	ZipArchive::FileHeaders::const_iterator it = _pArchive->findHeader(path);
+	if (it != _pArchive->headerEnd() && it->second.isFile())
+	{
+		// Only entries stored without compression and encryption
+		// can be served directly from the archive file.
+		const ZipLocalFileHeader& header = it->second;
+		if (header.getCompressionMethod() == Poco::Zip::ZipCommon::CM_STORE 
+			&& !header.isEncrypted() 
+			&& header.getCompressedSize() == header.getUncompressedSize())
+		{
+			file   = _path;
+			offset = header.getDataStartPos();
+			length = header.getUncompressedSize();
+			return true;
+		}
+	}
+	return false;
+}
+
+
 void BundleFile::list(const std::string& path, std::vector<std::string>& files) const	
 {
 	poco_assert (_pArchive);
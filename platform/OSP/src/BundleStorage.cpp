@@ -26,4 +26,10 @@ BundleStorage::~BundleStorage()
 }
 
 
+bool BundleStorage::getResourceFile(const std::string& path, std::string& file, Poco::UInt64& offset, Poco::UInt64& length) const
+{
+	return false;
+}
+
+
 } } // namespace Poco::OSP
@@ -97,6 +97,31 @@ void BundleDirectoryTest::testDirectory()
 }
 
 
+void BundleDirectoryTest::testResourceFile()
+{
+	BundleStorage::Ptr pBD(new BundleDirectory("testBundle"));
+	std::string file;
+	Poco::UInt64 offset;
+	Poco::UInt64 length;
+	assert (pBD->getResourceFile("bundle.properties", file, offset, length));
+	assert (Path(file).getFileName() == "bundle.properties");
+	assert (offset == 0);
+	assert (length == 10);
+
+	assert (!pBD->getResourceFile("META-INF", file, offset, length));
+	assert (!pBD->getResourceFile("nonexistent", file, offset, length));
+
+	try
+	{
+		pBD->getResourceFile("foo/../../bar", file, offset, length);
+		fail("invalid resource path - must throw");
+	}
+	catch (Poco::Exception&)
+	{
+	}
+}
+
+
 void BundleDirectoryTest::setUp()
 {
 	File baseDir("testBundle");
@@ -137,6 +162,7 @@ CppUnit::Test* BundleDirectoryTest::suite()
 
 	CppUnit_addTest(pSuite, BundleDirectoryTest, testResource);
 	CppUnit_addTest(pSuite, BundleDirectoryTest, testDirectory);
+	CppUnit_addTest(pSuite, BundleDirectoryTest, testResourceFile);
 
 	return pSuite;
 }
@@ -28,6 +28,7 @@ public:
 
 	void testResource();
 	void testDirectory();
+	void testResourceFile();
 
 	void setUp();
 	void tearDown();
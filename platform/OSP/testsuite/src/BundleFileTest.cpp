@@ -17,13 +17,20 @@
 #include "Poco/File.h"
 #include "Poco/Path.h"
 #include "Poco/Exception.h"
+#include "Poco/FileStream.h"
+#include "Poco/Buffer.h"
+#include "Poco/DateTime.h"
+#include "Poco/Zip/Compress.h"
 #include <fstream>
+#include <sstream>
 #include <memory>
 
 
 using Poco::OSP::BundleFile;
 using Poco::OSP::BundleStorage;
 using Poco::File;
+using Poco::Zip::Compress;
+using Poco::Zip::ZipCommon;
 
 
 BundleFileTest::BundleFileTest(const std::string& name): CppUnit::TestCase(name)
@@ -69,6 +76,59 @@ void BundleFileTest::testDirectory()
 }
 
 
+void BundleFileTest::testResourceFile()
+{
+	BundleStorage::Ptr pBF(new BundleFile("testBundle.zip"));
+	std::string file;
+	Poco::UInt64 offset;
+	Poco::UInt64 length;
+	assert (pBF->getResourceFile("bundle.properties", file, offset, length));
+	assert (file == "testBundle.zip");
+	assert (length == 10);
+	assert (readRegion(file, offset, length) == "foo: bar\n\n");
+
+	assert (pBF->getResourceFile("META-INF/manifest.mf", file, offset, length));
+	assert (length == 22);
+	assert (readRegion(file, offset, length) == "Manifest-Version: 1.0\n");
+
+	assert (!pBF->getResourceFile("META-INF/", file, offset, length));
+	assert (!pBF->getResourceFile("nonexistent", file, offset, length));
+}
+
+
+void BundleFileTest::testCompressedResourceFile()
+{
+	std::string data("Hello, world! Hello, world! Hello, world!");
+	{
+		std::ofstream ostr("testCompressed.zip", std::ios::binary);
+		Compress c(ostr, true);
+		std::istringstream istr1(data);
+		c.addFile(istr1, Poco::DateTime(), Poco::Path("deflated.txt", Poco::Path::PATH_UNIX), ZipCommon::CM_DEFLATE);
+		std::istringstream istr2(data);
+		c.addFile(istr2, Poco::DateTime(), Poco::Path("stored.txt", Poco::Path::PATH_UNIX), ZipCommon::CM_STORE);
+		c.close();
+	}
+
+	BundleStorage::Ptr pBF(new BundleFile("testCompressed.zip"));
+	std::string file;
+	Poco::UInt64 offset;
+	Poco::UInt64 length;
+	assert (!pBF->getResourceFile("deflated.txt", file, offset, length));
+	assert (pBF->getResourceFile("stored.txt", file, offset, length));
+	assert (readRegion(file, offset, length) == data);
+}
+
+
+std::string BundleFileTest::readRegion(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length)
+{
+	Poco::FileInputStream istr(path);
+	istr.seekg(static_cast<std::streamoff>(offset));
+	Poco::Buffer<char> buffer(static_cast<std::size_t>(length));
+	istr.read(buffer.begin(), static_cast<std::streamsize>(length));
+	return std::string(buffer.begin(), static_cast<std::size_t>(istr.gcount()));
+}
+
+
 void BundleFileTest::setUp()
 {
 	// The following is a ZIP file containing the same
@@ -113,6 +173,11 @@ void BundleFileTest::tearDown()
 	{
 		f.remove(true);
 	}
+	File f2("testCompressed.zip");
+	if (f2.exists())
+	{
+		f2.remove(true);
+	}
 }
 
 
@@ -122,6 +187,8 @@ CppUnit::Test* BundleFileTest::suite()
 
 	CppUnit_addTest(pSuite, BundleFileTest, testResource);
 	CppUnit_addTest(pSuite, BundleFileTest, testDirectory);
+	CppUnit_addTest(pSuite, BundleFileTest, testResourceFile);
+	CppUnit_addTest(pSuite, BundleFileTest, testCompressedResourceFile);
 
 	return pSuite;
 }
@@ -28,6 +28,8 @@ public:
 
 	void testResource();
 	void testDirectory();
+	void testResourceFile();
+	void testCompressedResourceFile();
 
 	void setUp();
 	void tearDown();
@@ -35,6 +37,7 @@ public:
 	static CppUnit::Test* suite();
 
 private:
+	static std::string readRegion(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length);
 };
 
 
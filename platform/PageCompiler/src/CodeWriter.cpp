@@ -61,11 +61,6 @@ void CodeWriter::writeImpl(std::ostream& ostr, const std::string& headerFileName
 	{
 		ostr << "#include \"Poco/DeflatingStream.h\"\n";
 	}
-	if (_page.getBool("page.buffered", false))
-	{
-		ostr << "#include \"Poco/StreamCopier.h\"\n";
-		ostr << "#include <sstream>\n";
-	}
 	ostr << "\n\n";
 
 	std::string decls(_page.implDecls().str());
@@ -75,6 +70,7 @@ void CodeWriter::writeImpl(std::ostream& ostr, const std::string& headerFileName
 	}
 
 	beginNamespace(ostr);
+	writeFragments(ostr);
 	
 	std::string path = _page.get("page.path", "");
 	if (!path.empty())
@@ -158,6 +154,11 @@ void CodeWriter::handlerClass(std::ostream& ostr, const std::string& base, const
 		ostr << "\n";
 	}
 	ostr << "\tvoid handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response);\n";
+	ostr << "\n";
+	ostr << "protected:\n";
+	ostr << "\tvoid handlePage(";
+	writePageParameters(ostr);
+	ostr << ");\n";
 	writeHandlerMembers(ostr);
 	
 	std::string path = _page.get("page.path", "");
@@ -192,6 +193,10 @@ void CodeWriter::factoryImpl(std::ostream& ostr, const std::string& arg)
 void CodeWriter::writeHeaderIncludes(std::ostream& ostr)
 {
 	ostr << "#include \"Poco/Net/HTTPRequestHandler.h\"\n";
+	if (!compressed())
+	{
+		ostr << "#include \"Poco/Net/HTTPResponseWriter.h\"\n";
+	}
 }
 
 
@@ -233,6 +238,7 @@ void CodeWriter::writeImplIncludes(std::ostream& ostr)
 	ostr << "#include \"Poco/Net/HTTPServerRequest.h\"\n";
 	ostr << "#include \"Poco/Net/HTTPServerResponse.h\"\n";
 	ostr << "#include \"Poco/Net/HTMLForm.h\"\n";
+	ostr << "#include \"Poco/Net/HTTPResponseWriter.h\"\n";
 }
 
 
@@ -260,6 +266,8 @@ void CodeWriter::writeConstructor(std::ostream& ostr)
 
 void CodeWriter::writeHandler(std::ostream& ostr)
 {
+	// The page body is generated into handlePage(), so that the
+	// response writer is closed even if the page returns early.
 	ostr << "void " << _class << "::handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)\n";
 	ostr << "{\n";
 	writeResponse(ostr);
@@ -268,6 +276,23 @@ void CodeWriter::writeHandler(std::ostream& ostr)
 	{
 		ostr << "\tif (!(" << _page.get("page.precondition") << ")) return;\n\n";
 	}
+	if (!compressed())
+	{
+		writeResponseWriter(ostr);
+	}
+	ostr << "\thandlePage(";
+	writePageArguments(ostr);
+	ostr << ");\n";
+	if (!compressed())
+	{
+		ostr << "\tresponseWriter.close();\n";
+	}
+	ostr << "}\n";
+	ostr << "\n\n";
+	ostr << "void " << _class << "::handlePage(";
+	writePageParameters(ostr);
+	ostr << ")\n";
+	ostr << "{\n";
 	writeForm(ostr);
 	ostr << _page.preHandler().str();
 	writeContent(ostr);
@@ -314,7 +339,7 @@ void CodeWriter::writeResponse(std::ostream& ostr)
 	std::string contentType(_page.get("page.contentType", "text/html"));
 	std::string contentLang(_page.get("page.contentLanguage", ""));
 	bool buffered(_page.getBool("page.buffered", false));
-	bool chunked(_page.getBool("page.chunked", !buffered));
+	bool chunked(_page.getBool("page.chunked", false));
 	bool compressed(_page.getBool("page.compressed", false));
 	if (buffered) compressed = false;
 	if (compressed) chunked = true;
@@ -341,35 +366,128 @@ void CodeWriter::writeResponse(std::ostream& ostr)
 
 void CodeWriter::writeContent(std::ostream& ostr)
 {
-	bool buffered(_page.getBool("page.buffered", false));
-	bool chunked(_page.getBool("page.chunked", !buffered));
-	bool compressed(_page.getBool("page.compressed", false));
 	int compressionLevel(_page.getInt("page.compressionLevel", 1));
-	if (buffered) compressed = false;
-	if (compressed) chunked = true;
 	
-	if (buffered)
-	{
-		ostr << "\tstd::stringstream responseStream;\n";
-		ostr << _page.handler().str();
-		if (!chunked)
-		{
-			ostr << "\tresponse.setContentLength(static_cast<int>(responseStream.tellp()));\n";
-		}
-		ostr << "\tPoco::StreamCopier::copyStream(responseStream, response.send());\n";		
-	}
-	else if (compressed)
+	std::string handler(_page.handler().str());
+	if (compressed())
 	{
 		ostr << "\tstd::ostream& _responseStream = response.send();\n"
 		     << "\tPoco::DeflatingOutputStream _gzipStream(_responseStream, Poco::DeflatingStreamBuf::STREAM_GZIP, " << compressionLevel << ");\n"
-		     << "\tstd::ostream& responseStream = _compressResponse ? _gzipStream : _responseStream;\n";
-		ostr << _page.handler().str();
+		     << "\tPoco::Net::HTTPResponseWriter responseWriter(_compressResponse ? _gzipStream : _responseStream);\n";
+	}
+	if (handler.find("responseStream") != std::string::npos)
+	{
+		ostr << "\tstd::ostream& responseStream = responseWriter.stream();\n";
+	}
+	ostr << handler;
+	if (compressed())
+	{
+		ostr << "\tresponseWriter.close();\n";
 		ostr << "\tif (_compressResponse) _gzipStream.close();\n";
 	}
-	else
+}
+
+
+void CodeWriter::writeResponseWriter(std::ostream& ostr)
+{
+	bool buffered(_page.getBool("page.buffered", false));
+
+	ostr << "\tPoco::Net::HTTPResponseWriter responseWriter(response";
+	if (buffered || (_page.has("page.chunked") && !_page.getBool("page.chunked")))
+	{
+		ostr << ", Poco::Net::HTTPResponseWriter::UNLIMITED_BUFFER_SIZE";
+	}
+	else if (_page.getBool("page.chunked", false))
+	{
+		ostr << ", 0";
+	}
+	else if (_page.has("page.bufferSize"))
 	{
-		ostr << "\tstd::ostream& responseStream = response.send();\n";
-		ostr << _page.handler().str();
+		ostr << ", " << _page.getInt("page.bufferSize");
 	}
+	ostr << ");\n";
+}
+
+
+void CodeWriter::writePageParameters(std::ostream& ostr)
+{
+	ostr << "Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response";
+	if (compressed())
+		ostr << ", bool _compressResponse";
+	else
+		ostr << ", Poco::Net::HTTPResponseWriter& responseWriter";
+}
+
+
+void CodeWriter::writePageArguments(std::ostream& ostr)
+{
+	ostr << "request, response";
+	if (compressed())
+		ostr << ", _compressResponse";
+	else
+		ostr << ", responseWriter";
 }
 
+
+bool CodeWriter::compressed() const
+{
+	return _page.getBool("page.compressed", false) && !_page.getBool("page.buffered", false);
+}
+
+
+void CodeWriter::writeFragments(std::ostream& ostr)
+{
+	const std::vector<std::string>& fragments = _page.fragments();
+	for (std::size_t i = 0; i < fragments.size(); i++)
+	{
+		ostr << "static const char cpspFragment" << i << "[] =\n";
+		ostr << "\t\"";
+		const std::string& fragment = fragments[i];
+		std::size_t pieceLength = 0;
+		std::size_t pos = 0;
+		while (pos < fragment.size())
+		{
+			bool endPiece = false;
+			std::size_t length = 1;
+			switch (fragment[pos])
+			{
+			case '\n':
+				ostr << "\\n";
+				endPiece = true;
+				break;
+			case '\t':
+				ostr << "\\t";
+				break;
+			case '"':
+				ostr << "\\\"";
+				break;
+			case '\\':
+				// Backslashes are passed through unescaped, so they
+				// can be used for escape sequences. The complete escape
+				// sequence is written before a piece may end, as
+				// splitting it would change its meaning.
+				length = Page::escapeLength(fragment, pos);
+				if (pos + length == fragment.size() && length == 1)
+					ostr << "\\\\";
+				else
+					ostr.write(fragment.data() + pos, length);
+				break;
+			default:
+				ostr << fragment[pos];
+				break;
+			}
+			pos += length;
+			pieceLength += length;
+			if ((endPiece || pieceLength >= MAX_LITERAL_LENGTH) && pos < fragment.size())
+			{
+				ostr << "\"\n\t\"";
+				pieceLength = 0;
+			}
+		}
+		ostr << "\";\n";
+	}
+	if (!fragments.empty())
+	{
+		ostr << "\n\n";
+	}
+}
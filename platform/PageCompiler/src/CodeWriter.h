@@ -46,6 +46,11 @@ public:
 		/// Returns the name of the handler class.
 
 protected:
+	enum
+	{
+		MAX_LITERAL_LENGTH = 4096
+	};
+
 	virtual void writeHeaderIncludes(std::ostream& ostr);
 	virtual void writeHandlerClass(std::ostream& ostr);
 	virtual void writeHandlerMembers(std::ostream& ostr);
@@ -58,7 +63,11 @@ protected:
 	virtual void writeForm(std::ostream& ostr);
 	virtual void writeResponse(std::ostream& ostr);
 	virtual void writeContent(std::ostream& ostr);
+	virtual void writeResponseWriter(std::ostream& ostr);
+	virtual void writePageParameters(std::ostream& ostr);
+	virtual void writePageArguments(std::ostream& ostr);
 	virtual void writeManifest(std::ostream& ostr);
+	virtual void writeFragments(std::ostream& ostr);
 	
 	void beginGuard(std::ostream& ostr, const std::string& headerFileName);
 	void endGuard(std::ostream& ostr, const std::string& headerFileName);
@@ -67,6 +76,7 @@ protected:
 	void handlerClass(std::ostream& ostr, const std::string& base, const std::string& ctorArg);
 	void factoryClass(std::ostream& ostr, const std::string& base);
 	void factoryImpl(std::ostream& ostr, const std::string& arg);
+	bool compressed() const;
 
 private:
 	CodeWriter();
@@ -31,6 +31,10 @@ void OSPCodeWriter::writeHeaderIncludes(std::ostream& ostr)
 	CodeWriter::writeHeaderIncludes(ostr);
 	ostr << "#include \"Poco/OSP/Web/WebRequestHandlerFactory.h\"\n";
 	ostr << "#include \"Poco/OSP/BundleContext.h\"\n";
+	if (hasSession())
+	{
+		ostr << "#include \"Poco/OSP/Web/WebSession.h\"\n";
+	}
 }
 
 
@@ -103,11 +107,10 @@ void OSPCodeWriter::writeConstructor(std::ostream& ostr)
 
 void OSPCodeWriter::writeSession(std::ostream& ostr)
 {
-	if (page().has("page.session"))
+	if (hasSession())
 	{
 		std::string session = page().get("page.session");
 		std::string sessionCode;
-		if (session.empty()) return;
 		if (session[0] == '@')
 			sessionCode = "context()->thisBundle()->properties().getString(\"" + session.substr(1) + "\")";
 		else
@@ -138,6 +141,32 @@ void OSPCodeWriter::writeSession(std::ostream& ostr)
 }
 
 
+void OSPCodeWriter::writePageParameters(std::ostream& ostr)
+{
+	CodeWriter::writePageParameters(ostr);
+	if (hasSession())
+	{
+		ostr << ", Poco::OSP::Web::WebSession::Ptr session";
+	}
+}
+
+
+void OSPCodeWriter::writePageArguments(std::ostream& ostr)
+{
+	CodeWriter::writePageArguments(ostr);
+	if (hasSession())
+	{
+		ostr << ", session";
+	}
+}
+
+
+bool OSPCodeWriter::hasSession() const
+{
+	return !page().get("page.session", "").empty();
+}
+
+
 void OSPCodeWriter::writeFactory(std::ostream& ostr)
 {
 	ostr << "\n\n";
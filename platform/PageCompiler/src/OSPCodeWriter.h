@@ -36,6 +36,9 @@ protected:
 	virtual void writeConstructor(std::ostream& ostr);
 	virtual void writeFactory(std::ostream& ostr);
 	virtual void writeSession(std::ostream& ostr);
+	virtual void writePageParameters(std::ostream& ostr);
+	virtual void writePageArguments(std::ostream& ostr);
+	bool hasSession() const;
 };
 
 
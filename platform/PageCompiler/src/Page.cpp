@@ -13,6 +13,9 @@
 #include "Page.h"
 #include "Poco/String.h"
 #include "Poco/NumberParser.h"
+#include "Poco/Ascii.h"
+#include "Poco/Bugcheck.h"
+#include <algorithm>
 
 
 Page::Page()
@@ -46,3 +49,37 @@ int Page::getInt(const std::string& property, int deflt) const
 	}
 	else return deflt;
 }
+
+
+std::size_t Page::addFragment(const std::string& markup)
+{
+	std::vector<std::string>::const_iterator it = std::find(_fragments.begin(), _fragments.end(), markup);
+	if (it != _fragments.end()) return it - _fragments.begin();
+
+	_fragments.push_back(markup);
+	return _fragments.size() - 1;
+}
+
+
+std::size_t Page::escapeLength(const std::string& markup, std::size_t pos)
+{
+	poco_assert_dbg (pos < markup.size() && markup[pos] == '\\');
+
+	std::size_t end = pos + 1;
+	if (end == markup.size() || markup[end] == '\n' || markup[end] == '\t') return 1;
+
+	char ch = markup[end++];
+	std::size_t maxEnd = markup.size();
+	if (ch >= '0' && ch <= '7')
+	{
+		maxEnd = std::min(maxEnd, pos + 4);
+		while (end < maxEnd && markup[end] >= '0' && markup[end] <= '7') ++end;
+	}
+	else if (ch == 'x' || ch == 'u' || ch == 'U')
+	{
+		if (ch == 'u') maxEnd = std::min(maxEnd, pos + 6);
+		else if (ch == 'U') maxEnd = std::min(maxEnd, pos + 10);
+		while (end < maxEnd && Poco::Ascii::isHexDigit(markup[end])) ++end;
+	}
+	return end - pos;
+}
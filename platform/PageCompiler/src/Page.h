@@ -16,6 +16,7 @@
 
 #include "Poco/Net/NameValueCollection.h"
 #include <sstream>
+#include <vector>
 
 
 class Page: public Poco::Net::NameValueCollection
@@ -66,6 +67,25 @@ public:
 		
 	int getInt(const std::string& property, int deflt = 0) const;
 		/// Returns the integer value of the given property.
+
+	std::size_t addFragment(const std::string& markup);
+		/// Adds a fragment of static markup to the page and
+		/// returns its index. If an identical fragment has been
+		/// added before, the index of the existing fragment
+		/// is returned.
+
+	const std::vector<std::string>& fragments() const;
+		/// Returns the static markup fragments of the page.
+
+	static std::size_t escapeLength(const std::string& markup, std::size_t pos);
+		/// Returns the length of the escape sequence starting
+		/// with the backslash at the given position in markup.
+		///
+		/// Backslashes in markup are passed through unescaped
+		/// into the generated string literals, so an escape
+		/// sequence must never be split across two literals.
+		/// A backslash followed by a newline or tab character,
+		/// or at the end of markup, has length 1.
 		
 private:
 	Page(const Page&);
@@ -75,6 +95,7 @@ private:
 	std::stringstream _implDecls;
 	std::stringstream _handler;
 	std::stringstream _preHandler;
+	std::vector<std::string> _fragments;
 };
 
 
@@ -129,4 +150,10 @@ inline const std::stringstream& Page::preHandler() const
 }
 
 
+inline const std::vector<std::string>& Page::fragments() const
+{
+	return _fragments;
+}
+
+
 #endif // Page_INCLUDED
@@ -19,8 +19,9 @@
 #include "Poco/Ascii.h"
 
 
-const std::string PageReader::MARKUP_BEGIN("\tresponseStream << \"");
-const std::string PageReader::MARKUP_END("\";\n");
+const std::string PageReader::FRAGMENT_BEGIN("\tresponseWriter.writeStatic(cpspFragment");
+const std::string PageReader::FRAGMENT_MIDDLE(", sizeof(cpspFragment");
+const std::string PageReader::FRAGMENT_END(") - 1);\n");
 const std::string PageReader::EXPR_BEGIN("\tresponseStream << (");
 const std::string PageReader::EXPR_END(");\n");
 
@@ -62,8 +63,6 @@ void PageReader::parse(std::istream& pageStream)
 {
 	ParsingState state = STATE_MARKUP;
 
-	_page.handler() << MARKUP_BEGIN;
-
 	Poco::CountingInputStream countingPageStream(pageStream);
 	std::string token;
 	nextToken(countingPageStream, token);
@@ -74,7 +73,7 @@ void PageReader::parse(std::istream& pageStream)
 		{
 			if (state == STATE_MARKUP)
 			{
-				_page.handler() << MARKUP_END;
+				flushMarkup();
 				generateLineDirective(_page.handler());
 				state = STATE_BLOCK;
 			}
@@ -84,7 +83,6 @@ void PageReader::parse(std::istream& pageStream)
 		{
 			if (state == STATE_MARKUP)
 			{
-				_page.handler() << MARKUP_END;
 				generateLineDirective(_page.preHandler());
 				state = STATE_PREHANDLER;
 			}
@@ -94,7 +92,6 @@ void PageReader::parse(std::istream& pageStream)
 		{
 			if (state == STATE_MARKUP)
 			{
-				_page.handler() << MARKUP_END;
 				generateLineDirective(_page.implDecls());
 				state = STATE_IMPLDECL;
 			}
@@ -104,7 +101,6 @@ void PageReader::parse(std::istream& pageStream)
 		{
 			if (state == STATE_MARKUP)
 			{
-				_page.handler() << MARKUP_END;
 				generateLineDirective(_page.headerDecls());
 				state = STATE_HDRDECL;
 			}
@@ -114,7 +110,6 @@ void PageReader::parse(std::istream& pageStream)
 		{
 			if (state == STATE_MARKUP)
 			{
-				_page.handler() << MARKUP_END;
 				state = STATE_COMMENT;
 			}
 			else _page.handler() << token;
@@ -123,7 +118,6 @@ void PageReader::parse(std::istream& pageStream)
 		{
 			if (state == STATE_MARKUP)
 			{
-				_page.handler() << MARKUP_END;
 				state = STATE_ATTR;
 				_attrs.clear();
 			}
@@ -133,7 +127,7 @@ void PageReader::parse(std::istream& pageStream)
 		{
 			if (state == STATE_MARKUP)
 			{
-				_page.handler() << MARKUP_END;
+				flushMarkup();
 				generateLineDirective(_page.handler());
 				_page.handler() << EXPR_BEGIN;
 				state = STATE_EXPR;
@@ -145,45 +139,28 @@ void PageReader::parse(std::istream& pageStream)
 			if (state == STATE_EXPR)
 			{
 				_page.handler() << EXPR_END;
-				_page.handler() << MARKUP_BEGIN;
 				state = STATE_MARKUP;
 			}
 			else if (state == STATE_ATTR)
 			{
 				parseAttributes();
 				_attrs.clear();
-				_page.handler() << MARKUP_BEGIN;
 				state = STATE_MARKUP;
 			}
 			else if (state != STATE_MARKUP)
 			{
-				_page.handler() << MARKUP_BEGIN;
 				state = STATE_MARKUP;
 			}
-			else _page.handler() << token;
+			else appendMarkup(token);
 		}
 		else
 		{
 			switch (state)
 			{
 			case STATE_MARKUP:
-				if (token == "\n")
-				{
-					_page.handler() << "\\n";
-					_page.handler() << MARKUP_END;
-					_page.handler() << MARKUP_BEGIN;
-				}
-				else if (token == "\t")
-				{
-					_page.handler() << "\\t";
-				}
-				else if (token == "\"")
-				{
-					_page.handler() << "\\\"";
-				}
-				else if (token != "\r")
+				if (token != "\r")
 				{
-					_page.handler() << token;
+					appendMarkup(token);
 				}
 				break;
 			case STATE_IMPLDECL:
@@ -213,12 +190,62 @@ void PageReader::parse(std::istream& pageStream)
 
 	if (state == STATE_MARKUP)
 	{
-		_page.handler() << MARKUP_END;
+		flushMarkup();
 	}
 	else throw Poco::SyntaxException("unclosed meta or code block", where());
 }
 
 
+void PageReader::appendMarkup(const std::string& token)
+{
+	_markup += token;
+	
+	// Keep fragments within the limits of string literals
+	// supported by compilers. Backslashes are passed through
+	// unescaped, so a fragment must not end within an escape
+	// sequence. An escape sequence reaching the end of the
+	// markup may still continue with the next token and is
+	// kept for the next fragment.
+	if (_markup.size() >= MAX_FRAGMENT_SIZE)
+	{
+		std::size_t split = _markup.size();
+		std::size_t pos = 0;
+		while (pos < _markup.size())
+		{
+			if (_markup[pos] == '\\')
+			{
+				std::size_t length = Page::escapeLength(_markup, pos);
+				if (pos + length == _markup.size())
+				{
+					split = pos;
+					break;
+				}
+				pos += length;
+			}
+			else ++pos;
+		}
+		if (split > 0)
+		{
+			std::string rest(_markup, split);
+			_markup.resize(split);
+			flushMarkup();
+			_markup = rest;
+		}
+	}
+}
+
+
+void PageReader::flushMarkup()
+{
+	if (!_markup.empty())
+	{
+		std::size_t index = _page.addFragment(_markup);
+		_page.handler() << FRAGMENT_BEGIN << index << FRAGMENT_MIDDLE << index << FRAGMENT_END;
+		_markup.clear();
+	}
+}
+
+
 void PageReader::parseAttributes()
 {
 	static const int eof = std::char_traits<char>::eof();
@@ -342,6 +369,7 @@ void PageReader::include(const std::string& path)
 	Poco::Path includePath(path);
 	currentPath.resolve(includePath);
 	
+	flushMarkup();
 	_page.handler() << "\t// begin include " << currentPath.toString() << "\n";
 	
 	Poco::FileInputStream includeStream(currentPath.toString());
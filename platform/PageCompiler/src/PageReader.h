@@ -59,11 +59,19 @@ protected:
 		STATE_ATTR
 	};
 
-	static const std::string MARKUP_BEGIN;
-	static const std::string MARKUP_END;
+	enum
+	{
+		MAX_FRAGMENT_SIZE = 16384
+	};
+
+	static const std::string FRAGMENT_BEGIN;
+	static const std::string FRAGMENT_MIDDLE;
+	static const std::string FRAGMENT_END;
 	static const std::string EXPR_BEGIN;
 	static const std::string EXPR_END;
 
+	void appendMarkup(const std::string& token);
+	void flushMarkup();
 	void include(const std::string& path);
 	void parseAttributes();
 	void nextToken(std::istream& istr, std::string& token);
@@ -82,6 +90,7 @@ private:
 	const PageReader* _pParent;
 	std::string _path;
 	std::string _attrs;
+	std::string _markup;
 	int _line;
 	bool _emitLineDirectives;
 };
@@ -374,6 +374,7 @@ private:
 	friend class LayeredConfiguration;
 	friend class ConfigurationView;
 	friend class ConfigurationMapper;
+	friend class ConfigurationSnapshot;
 };
 
 
@@ -0,0 +1,193 @@
+//
+// ConfigurationSnapshot.h
+//
+// $Id$
+//
+// Library: Util
+// Package: Configuration
+// Module:  ConfigurationSnapshot
+//
+// Definition of the ConfigurationSnapshot class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Util_ConfigurationSnapshot_INCLUDED
+#define Util_ConfigurationSnapshot_INCLUDED
+
+
+#include "Poco/Util/Util.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/HashMap.h"
+
+
+namespace Poco {
+namespace Util {
+
+
+class Util_API ConfigurationSnapshot: public Poco::RefCountedObject
+	/// An immutable copy of all properties of a configuration,
+	/// taken at a certain point in time.
+	///
+	/// All property references (${<property>}) in the values have
+	/// already been expanded when the snapshot was created, and
+	/// the values are stored in a hash map with the full property
+	/// names as keys. Since a snapshot is never modified after it
+	/// has been created, it can be read from multiple threads
+	/// without any synchronization.
+	///
+	/// Every snapshot carries the version number of the
+	/// configuration it has been created from. Components that
+	/// cache values converted from a snapshot can compare this
+	/// version with the current version of the configuration
+	/// to find out whether their cached values are still valid.
+	///
+	/// Snapshots are obtained from LayeredConfiguration::snapshot().
+{
+public:
+	typedef Poco::AutoPtr<ConfigurationSnapshot> Ptr;
+	typedef Poco::HashMap<std::string, std::string> ValueMap;
+
+	ConfigurationSnapshot(int version, ValueMap& values);
+		/// Creates the ConfigurationSnapshot with the given version.
+		///
+		/// The contents of values are moved into the snapshot
+		/// and values will be empty afterwards.
+
+	int version() const;
+		/// Returns the version of the configuration the snapshot
+		/// has been created from.
+
+	std::size_t size() const;
+		/// Returns the number of properties in the snapshot.
+
+	bool has(const std::string& key) const;
+		/// Returns true iff the property with the given key exists.
+
+	const std::string& getString(const std::string& key) const;
+		/// Returns the string value of the property with the given key.
+		/// Throws a NotFoundException if the key does not exist.
+
+	std::string getString(const std::string& key, const std::string& defaultValue) const;
+		/// If a property with the given key exists, returns the property's string value,
+		/// otherwise returns the given default value.
+
+	int getInt(const std::string& key) const;
+		/// Returns the int value of the property with the given key.
+		/// Throws a NotFoundException if the key does not exist.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to an int. Numbers starting with 0x are treated as hexadecimal.
+
+	int getInt(const std::string& key, int defaultValue) const;
+		/// If a property with the given key exists, returns the property's int value,
+		/// otherwise returns the given default value.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to an int. Numbers starting with 0x are treated as hexadecimal.
+
+	unsigned getUInt(const std::string& key) const;
+		/// Returns the unsigned int value of the property with the given key.
+		/// Throws a NotFoundException if the key does not exist.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to an unsigned int. Numbers starting with 0x are treated as hexadecimal.
+
+	unsigned getUInt(const std::string& key, unsigned defaultValue) const;
+		/// If a property with the given key exists, returns the property's unsigned int
+		/// value, otherwise returns the given default value.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to an unsigned int. Numbers starting with 0x are treated as hexadecimal.
+
+#if defined(POCO_HAVE_INT64)
+
+	Int64 getInt64(const std::string& key) const;
+		/// Returns the Int64 value of the property with the given key.
+		/// Throws a NotFoundException if the key does not exist.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to an Int64. Numbers starting with 0x are treated as hexadecimal.
+
+	Int64 getInt64(const std::string& key, Int64 defaultValue) const;
+		/// If a property with the given key exists, returns the property's Int64 value,
+		/// otherwise returns the given default value.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to an Int64. Numbers starting with 0x are treated as hexadecimal.
+
+#endif // defined(POCO_HAVE_INT64)
+
+	double getDouble(const std::string& key) const;
+		/// Returns the double value of the property with the given key.
+		/// Throws a NotFoundException if the key does not exist.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to a double.
+
+	double getDouble(const std::string& key, double defaultValue) const;
+		/// If a property with the given key exists, returns the property's double value,
+		/// otherwise returns the given default value.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to a double.
+
+	bool getBool(const std::string& key) const;
+		/// Returns the boolean value of the property with the given key.
+		/// Throws a NotFoundException if the key does not exist.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to a boolean. See AbstractConfiguration::getBool() for the
+		/// accepted values.
+
+	bool getBool(const std::string& key, bool defaultValue) const;
+		/// If a property with the given key exists, returns the property's boolean value,
+		/// otherwise returns the given default value.
+		/// Throws a SyntaxException if the property can not be converted
+		/// to a boolean.
+
+	const ValueMap& values() const;
+		/// Returns all properties in the snapshot.
+
+protected:
+	~ConfigurationSnapshot();
+
+private:
+	ConfigurationSnapshot();
+	ConfigurationSnapshot(const ConfigurationSnapshot&);
+	ConfigurationSnapshot& operator = (const ConfigurationSnapshot&);
+
+	const std::string* find(const std::string& key) const;
+
+	int _version;
+	ValueMap _values;
+};
+
+
+//
+// inlines
+//
+inline int ConfigurationSnapshot::version() const
+{
+	return _version;
+}
+
+
+inline std::size_t ConfigurationSnapshot::size() const
+{
+	return _values.size();
+}
+
+
+inline bool ConfigurationSnapshot::has(const std::string& key) const
+{
+	return _values.find(key) != _values.end();
+}
+
+
+inline const ConfigurationSnapshot::ValueMap& ConfigurationSnapshot::values() const
+{
+	return _values;
+}
+
+
+} } // namespace Poco::Util
+
+
+#endif // Util_ConfigurationSnapshot_INCLUDED
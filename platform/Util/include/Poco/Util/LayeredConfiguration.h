@@ -22,7 +22,10 @@
 
 #include "Poco/Util/Util.h"
 #include "Poco/Util/AbstractConfiguration.h"
+#include "Poco/Util/ConfigurationSnapshot.h"
 #include "Poco/AutoPtr.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
 #include <list>
 
 
@@ -47,8 +50,36 @@ class Util_API LayeredConfiguration: public AbstractConfiguration
 	/// with lower priority values coming before higher priority values.
 	///
 	/// If no priority is specified, a priority of 0 is assumed.
+	///
+	/// Reading a property through the AbstractConfiguration interface
+	/// locks the configuration, searches all layers and expands
+	/// property references every time. Code that reads properties
+	/// frequently can instead obtain an immutable snapshot of the
+	/// fully expanded configuration with snapshot(), and read from
+	/// it without any locking. The LayeredConfiguration maintains
+	/// a version number, which is incremented whenever a configuration
+	/// is added or removed, or a property in one of the configurations
+	/// is changed or removed. A new snapshot is created on demand
+	/// only if the version has changed since the last snapshot
+	/// has been created.
+	///
+	/// Changes are detected through the propertyChanged and propertyRemoved
+	/// events of the added configurations. If a configuration is modified
+	/// without firing events (e.g., by loading a file into it, or with
+	/// events disabled), invalidate() must be called to make the change
+	/// visible in snapshots.
 {
 public:
+	Poco::BasicEvent<const int> configurationChanged;
+		/// Fired after a configuration has been added or removed, or
+		/// a property in one of the configurations has been changed or removed.
+		///
+		/// The event argument is the new version of the configuration.
+		///
+		/// The event may be fired while the configuration is locked,
+		/// so delegates must not wait for other threads accessing
+		/// the configuration.
+
 	LayeredConfiguration();
 		/// Creates the LayeredConfiguration.
 		
@@ -112,7 +143,36 @@ public:
 		///
 		/// Does nothing if the given configuration is not part of the
 		/// LayeredConfiguration.
-		
+
+	ConfigurationSnapshot::Ptr snapshot() const;
+		/// Returns an immutable snapshot containing all properties
+		/// of the LayeredConfiguration, with all property references
+		/// expanded.
+		///
+		/// The snapshot is created when this method is first called
+		/// after the configuration has changed, otherwise the
+		/// previously created snapshot is returned. Values that
+		/// are computed on every access (e.g., the system.dateTime
+		/// property of SystemConfiguration) are taken at the time
+		/// the snapshot is created. Values containing circular
+		/// property references are stored unexpanded.
+
+	int version() const;
+		/// Returns the current version of the configuration.
+		///
+		/// This method does not lock the configuration and can be
+		/// used to cheaply check whether values cached from a
+		/// snapshot are still up to date.
+
+	void invalidate();
+		/// Increments the version and fires the configurationChanged
+		/// event, causing a new snapshot to be created by the next
+		/// call to snapshot().
+		///
+		/// Must be called if one of the configurations has been
+		/// changed in a way that does not fire the propertyChanged
+		/// or propertyRemoved events.
+
 protected:
 	typedef Poco::AutoPtr<AbstractConfiguration> ConfigPtr;
 	
@@ -131,6 +191,12 @@ protected:
 	int lowest() const;
 	int highest() const;
 	void insert(const ConfigItem& item);
+	void collect(const std::string& key, ConfigurationSnapshot::ValueMap& values) const;
+	void attach(AbstractConfiguration* pConfig);
+	void detach(AbstractConfiguration* pConfig);
+	void onPropertyChanged(const void* pSender, const KeyValue& kv);
+	void onPropertyRemoved(const void* pSender, const std::string& key);
+	void onConfigurationChanged(const void* pSender, const int& version);
 	
 	~LayeredConfiguration();
 
@@ -141,9 +207,21 @@ private:
 	typedef std::list<ConfigItem> ConfigList;
 	
 	ConfigList _configs;
+	Poco::AtomicCounter _version;
+	mutable ConfigurationSnapshot::Ptr _pSnapshot;
+	mutable Poco::FastMutex _snapshotMutex;
 };
 
 
+//
+// inlines
+//
+inline int LayeredConfiguration::version() const
+{
+	return _version.value();
+}
+
+
 } } // namespace Poco::Util
 
 
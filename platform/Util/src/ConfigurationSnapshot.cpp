@@ -0,0 +1,159 @@
+//
+// ConfigurationSnapshot.cpp
+//
+// $Id$
+//
+// Library: Util
+// Package: Configuration
+// Module:  ConfigurationSnapshot
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Util/ConfigurationSnapshot.h"
+#include "Poco/Util/AbstractConfiguration.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+
+
+using Poco::NumberParser;
+using Poco::NotFoundException;
+
+
+namespace Poco {
+namespace Util {
+
+
+ConfigurationSnapshot::ConfigurationSnapshot(int version, ValueMap& values):
+	_version(version)
+{
+	_values.swap(values);
+}
+
+
+ConfigurationSnapshot::~ConfigurationSnapshot()
+{
+}
+
+
+const std::string& ConfigurationSnapshot::getString(const std::string& key) const
+{
+	const std::string* pValue = find(key);
+	if (pValue)
+		return *pValue;
+	else
+		throw NotFoundException(key);
+}
+
+
+std::string ConfigurationSnapshot::getString(const std::string& key, const std::string& defaultValue) const
+{
+	const std::string* pValue = find(key);
+	if (pValue)
+		return *pValue;
+	else
+		return defaultValue;
+}
+
+
+int ConfigurationSnapshot::getInt(const std::string& key) const
+{
+	return AbstractConfiguration::parseInt(getString(key));
+}
+
+
+int ConfigurationSnapshot::getInt(const std::string& key, int defaultValue) const
+{
+	const std::string* pValue = find(key);
+	if (pValue)
+		return AbstractConfiguration::parseInt(*pValue);
+	else
+		return defaultValue;
+}
+
+
+unsigned ConfigurationSnapshot::getUInt(const std::string& key) const
+{
+	return AbstractConfiguration::parseUInt(getString(key));
+}
+
+
+unsigned ConfigurationSnapshot::getUInt(const std::string& key, unsigned defaultValue) const
+{
+	const std::string* pValue = find(key);
+	if (pValue)
+		return AbstractConfiguration::parseUInt(*pValue);
+	else
+		return defaultValue;
+}
+
+
+#if defined(POCO_HAVE_INT64)
+
+
+Int64 ConfigurationSnapshot::getInt64(const std::string& key) const
+{
+	return AbstractConfiguration::parseInt64(getString(key));
+}
+
+
+Int64 ConfigurationSnapshot::getInt64(const std::string& key, Int64 defaultValue) const
+{
+	const std::string* pValue = find(key);
+	if (pValue)
+		return AbstractConfiguration::parseInt64(*pValue);
+	else
+		return defaultValue;
+}
+
+
+#endif // defined(POCO_HAVE_INT64)
+
+
+double ConfigurationSnapshot::getDouble(const std::string& key) const
+{
+	return NumberParser::parseFloat(getString(key));
+}
+
+
+double ConfigurationSnapshot::getDouble(const std::string& key, double defaultValue) const
+{
+	const std::string* pValue = find(key);
+	if (pValue)
+		return NumberParser::parseFloat(*pValue);
+	else
+		return defaultValue;
+}
+
+
+bool ConfigurationSnapshot::getBool(const std::string& key) const
+{
+	return AbstractConfiguration::parseBool(getString(key));
+}
+
+
+bool ConfigurationSnapshot::getBool(const std::string& key, bool defaultValue) const
+{
+	const std::string* pValue = find(key);
+	if (pValue)
+		return AbstractConfiguration::parseBool(*pValue);
+	else
+		return defaultValue;
+}
+
+
+const std::string* ConfigurationSnapshot::find(const std::string& key) const
+{
+	ValueMap::ConstIterator it = _values.find(key);
+	if (it != _values.end())
+		return &it->second;
+	else
+		return 0;
+}
+
+
+} } // namespace Poco::Util
@@ -16,11 +16,13 @@
 
 #include "Poco/Util/LayeredConfiguration.h"
 #include "Poco/Exception.h"
+#include "Poco/Delegate.h"
 #include <set>
 
 
 using Poco::AutoPtr;
 using Poco::RuntimeException;
+using Poco::FastMutex;
 
 
 namespace Poco {
@@ -34,6 +36,10 @@ LayeredConfiguration::LayeredConfiguration()
 
 LayeredConfiguration::~LayeredConfiguration()
 {
+	for (ConfigList::iterator it = _configs.begin(); it != _configs.end(); ++it)
+	{
+		detach(it->pConfig);
+	}
 }
 
 
@@ -97,6 +103,8 @@ void LayeredConfiguration::add(AbstractConfiguration* pConfig, int priority, boo
 		++it;
 		
 	_configs.insert(it, item);
+	attach(pConfig);
+	invalidate();
 }
 
 
@@ -106,13 +114,53 @@ void LayeredConfiguration::removeConfiguration(AbstractConfiguration* pConfig)
 	{
 		if (it->pConfig == pConfig)
 		{
+			detach(pConfig);
 			_configs.erase(it);
+			invalidate();
 			break;
 		}
 	}
 }
 
 
+ConfigurationSnapshot::Ptr LayeredConfiguration::snapshot() const
+{
+	int version = _version.value();
+	{
+		FastMutex::ScopedLock lock(_snapshotMutex);
+
+		if (_pSnapshot && _pSnapshot->version() == version)
+			return _pSnapshot;
+	}
+
+	// The snapshot is built without holding _snapshotMutex, so that
+	// readers of an up-to-date snapshot are never blocked by a rebuild.
+	// If the configuration changes while the snapshot is being built,
+	// the version will differ and the next call will build a new one.
+	ConfigurationSnapshot::ValueMap values;
+	{
+		Mutex::ScopedLock lock(_mutex);
+
+		collect("", values);
+	}
+	ConfigurationSnapshot::Ptr pSnapshot = new ConfigurationSnapshot(version, values);
+
+	FastMutex::ScopedLock lock(_snapshotMutex);
+	if (!_pSnapshot || _pSnapshot->version() < version)
+	{
+		_pSnapshot = pSnapshot;
+	}
+	return pSnapshot;
+}
+
+
+void LayeredConfiguration::invalidate()
+{
+	int version = ++_version;
+	configurationChanged(this, version);
+}
+
+
 bool LayeredConfiguration::getRaw(const std::string& key, std::string& value) const
 {
 	for (ConfigList::const_iterator it = _configs.begin(); it != _configs.end(); ++it)
@@ -131,6 +179,7 @@ void LayeredConfiguration::setRaw(const std::string& key, const std::string& val
 		if (it->writeable)
 		{
 			it->pConfig->setRaw(key, value);
+			invalidate();
 			return;
 		}
 	}
@@ -170,6 +219,74 @@ void LayeredConfiguration::removeRaw(const std::string& key)
 }
 
 
+void LayeredConfiguration::collect(const std::string& key, ConfigurationSnapshot::ValueMap& values) const
+{
+	Keys range;
+	enumerate(key, range);
+	for (Keys::const_iterator it = range.begin(); it != range.end(); ++it)
+	{
+		std::string fullKey(key);
+		if (!fullKey.empty()) fullKey += '.';
+		fullKey += *it;
+		std::string value;
+		if (getRaw(fullKey, value))
+		{
+			try
+			{
+				values[fullKey] = internalExpand(value);
+			}
+			catch (CircularReferenceException&)
+			{
+				values[fullKey] = value;
+			}
+		}
+		collect(fullKey, values);
+	}
+}
+
+
+void LayeredConfiguration::attach(AbstractConfiguration* pConfig)
+{
+	pConfig->propertyChanged += Poco::delegate(this, &LayeredConfiguration::onPropertyChanged);
+	pConfig->propertyRemoved += Poco::delegate(this, &LayeredConfiguration::onPropertyRemoved);
+	LayeredConfiguration* pLayeredConfig = dynamic_cast<LayeredConfiguration*>(pConfig);
+	if (pLayeredConfig)
+	{
+		pLayeredConfig->configurationChanged += Poco::delegate(this, &LayeredConfiguration::onConfigurationChanged);
+	}
+}
+
+
+void LayeredConfiguration::detach(AbstractConfiguration* pConfig)
+{
+	pConfig->propertyChanged -= Poco::delegate(this, &LayeredConfiguration::onPropertyChanged);
+	pConfig->propertyRemoved -= Poco::delegate(this, &LayeredConfiguration::onPropertyRemoved);
+	LayeredConfiguration* pLayeredConfig = dynamic_cast<LayeredConfiguration*>(pConfig);
+	if (pLayeredConfig)
+	{
+		pLayeredConfig->configurationChanged -= Poco::delegate(this, &LayeredConfiguration::onConfigurationChanged);
+	}
+}
+
+
+void LayeredConfiguration::onPropertyChanged(const void* pSender, const KeyValue& kv)
+{
+	invalidate();
+}
+
+
+void LayeredConfiguration::onPropertyRemoved(const void* pSender, const std::string& key)
+{
+	invalidate();
+}
+
+
+void LayeredConfiguration::onConfigurationChanged(const void* pSender, const int& version)
+{
+	invalidate();
+}
+
+
 int LayeredConfiguration::lowest() const
 {
 	if (_configs.empty())
@@ -17,18 +17,21 @@
 #include "Poco/Util/MapConfiguration.h"
 #include "Poco/AutoPtr.h"
 #include "Poco/Exception.h"
+#include "Poco/Delegate.h"
 #include <algorithm>
 
 
 using Poco::Util::AbstractConfiguration;
 using Poco::Util::LayeredConfiguration;
 using Poco::Util::MapConfiguration;
+using Poco::Util::ConfigurationSnapshot;
 using Poco::AutoPtr;
 using Poco::NotFoundException;
 using Poco::RuntimeException;
 
 
-LayeredConfigurationTest::LayeredConfigurationTest(const std::string& name): AbstractConfigurationTest(name)
+LayeredConfigurationTest::LayeredConfigurationTest(const std::string& name): AbstractConfigurationTest(name),
+	_changedVersion(0)
 {
 }
 
@@ -197,6 +200,148 @@ void LayeredConfigurationTest::testRemove()
 }
 
 
+void LayeredConfigurationTest::testSnapshot()
+{
+	AutoPtr<LayeredConfiguration> pLC = new LayeredConfiguration;
+	ConfigurationSnapshot::Ptr pSnapshot = pLC->snapshot();
+	assert (pSnapshot->size() == 0);
+	assert (!pSnapshot->has("prop1"));
+
+	AutoPtr<MapConfiguration> pMC1 = new MapConfiguration;
+	AutoPtr<MapConfiguration> pMC2 = new MapConfiguration;
+	pMC1->setString("prop1", "value1");
+	pMC1->setString("prop2", "value2");
+	pMC1->setString("sect.int", "0x20");
+	pMC1->setString("sect.ref", "${prop1}/${sect.int}/${undefined}");
+	pMC1->setString("circ1", "${circ2}");
+	pMC1->setString("circ2", "${circ1}");
+	pMC2->setString("prop2", "value3");
+	pMC2->setString("sect.bool", "on");
+	pMC2->setString("sect.double", "1.5");
+	pMC2->setString("sect.sub", "value4");
+	pMC2->setString("sect.sub.int64", "-5000000000");
+	pLC->add(pMC1, 0);
+	pLC->add(pMC2, 1);
+
+	pSnapshot = pLC->snapshot();
+	assert (pSnapshot->version() == pLC->version());
+	assert (pSnapshot->size() == 10);
+	assert (pSnapshot->getString("prop1") == "value1");
+	assert (pSnapshot->getString("prop2") == "value2");
+	assert (pSnapshot->getString("sect.ref") == "value1/0x20/${undefined}");
+	assert (pSnapshot->getString("circ1") == "${circ2}");
+	assert (pSnapshot->getString("sect.sub") == "value4");
+	assert (pSnapshot->getString("missing", "default") == "default");
+	assert (pSnapshot->getInt("sect.int") == 32);
+	assert (pSnapshot->getUInt("sect.int") == 32);
+	assert (pSnapshot->getInt("missing", 7) == 7);
+	assert (pSnapshot->getInt64("sect.sub.int64") == -5000000000LL);
+	assert (pSnapshot->getDouble("sect.double") == 1.5);
+	assert (pSnapshot->getBool("sect.bool"));
+	assert (!pSnapshot->getBool("missing", false));
+	assert (!pSnapshot->has("sect"));
+
+	try
+	{
+		pSnapshot->getString("missing");
+		fail("missing property - must throw");
+	}
+	catch (NotFoundException&)
+	{
+	}
+
+	try
+	{
+		pSnapshot->getInt("prop1");
+		fail("not a number - must throw");
+	}
+	catch (Poco::SyntaxException&)
+	{
+	}
+
+	assert (pLC->snapshot() == pSnapshot);
+}
+
+
+void LayeredConfigurationTest::testSnapshotVersion()
+{
+	AutoPtr<LayeredConfiguration> pLC = new LayeredConfiguration;
+	AutoPtr<MapConfiguration> pMC1 = new MapConfiguration;
+	AutoPtr<MapConfiguration> pMC2 = new MapConfiguration;
+	pLC->configurationChanged += Poco::delegate(this, &LayeredConfigurationTest::onConfigurationChanged);
+
+	int version = pLC->version();
+	pLC->add(pMC1, 0);
+	assert (pLC->version() > version);
+	assert (_changedVersion == pLC->version());
+	pLC->addWriteable(pMC2, 1);
+
+	pMC1->setString("prop1", "value1");
+	ConfigurationSnapshot::Ptr pSnapshot = pLC->snapshot();
+	assert (pSnapshot->getString("prop1") == "value1");
+	assert (pLC->snapshot() == pSnapshot);
+
+	version = pLC->version();
+	pMC2->setString("prop1", "value2");
+	assert (pLC->version() > version);
+	assert (pLC->snapshot() != pSnapshot);
+	assert (pLC->snapshot()->getString("prop1") == "value1");
+	assert (pSnapshot->getString("prop1") == "value1");
+
+	pLC->setString("prop2", "value2");
+	assert (_changedVersion == pLC->version());
+	pSnapshot = pLC->snapshot();
+	assert (pSnapshot->getString("prop2") == "value2");
+	assert (pMC2->getString("prop2") == "value2");
+
+	pMC1->remove("prop1");
+	pSnapshot = pLC->snapshot();
+	assert (pSnapshot->getString("prop1") == "value2");
+
+	pLC->removeConfiguration(pMC2);
+	pSnapshot = pLC->snapshot();
+	assert (!pSnapshot->has("prop1"));
+	assert (!pSnapshot->has("prop2"));
+
+	version = pLC->version();
+	pMC2->setString("prop3", "value3");
+	assert (pLC->version() == version);
+
+	pMC1->enableEvents(false);
+	pMC1->setString("prop4", "value4");
+	assert (pLC->snapshot() == pSnapshot);
+	pLC->invalidate();
+	assert (pLC->snapshot()->getString("prop4") == "value4");
+
+	pLC->configurationChanged -= Poco::delegate(this, &LayeredConfigurationTest::onConfigurationChanged);
+}
+
+
+void LayeredConfigurationTest::testNestedSnapshot()
+{
+	AutoPtr<LayeredConfiguration> pOuter = new LayeredConfiguration;
+	AutoPtr<LayeredConfiguration> pInner = new LayeredConfiguration;
+	AutoPtr<MapConfiguration> pMC = new MapConfiguration;
+	pInner->add(pMC, 0);
+	pOuter->add(pInner, 0);
+
+	pMC->setString("prop1", "value1");
+	assert (pOuter->snapshot()->getString("prop1") == "value1");
+
+	pMC->enableEvents(false);
+	pMC->setString("prop1", "value2");
+	assert (pOuter->snapshot()->getString("prop1") == "value1");
+	pInner->invalidate();
+	assert (pOuter->snapshot()->getString("prop1") == "value2");
+}
+
+
+void LayeredConfigurationTest::onConfigurationChanged(const void* pSender, const int& version)
+{
+	_changedVersion = version;
+}
+
+
 AbstractConfiguration* LayeredConfigurationTest::allocConfiguration() const
 {
 	LayeredConfiguration* pLC = new LayeredConfiguration;
@@ -230,6 +375,9 @@ CppUnit::Test* LayeredConfigurationTest::suite()
 	CppUnit_addTest(pSuite, LayeredConfigurationTest, testTwoLayers);
 	CppUnit_addTest(pSuite, LayeredConfigurationTest, testThreeLayers);
 	CppUnit_addTest(pSuite, LayeredConfigurationTest, testRemove);
+	CppUnit_addTest(pSuite, LayeredConfigurationTest, testSnapshot);
+	CppUnit_addTest(pSuite, LayeredConfigurationTest, testSnapshotVersion);
+	CppUnit_addTest(pSuite, LayeredConfigurationTest, testNestedSnapshot);
 
 	return pSuite;
 }
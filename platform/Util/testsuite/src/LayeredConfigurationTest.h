@@ -31,14 +31,22 @@ public:
 	void testTwoLayers();
 	void testThreeLayers();
 	void testRemove();
+	void testSnapshot();
+	void testSnapshotVersion();
+	void testNestedSnapshot();
 
 	void setUp();
 	void tearDown();
 
 	static CppUnit::Test* suite();
 
+protected:
+	void onConfigurationChanged(const void* pSender, const int& version);
+
 private:
 	virtual Poco::Util::AbstractConfiguration* allocConfiguration() const;
+
+	int _changedVersion;
 };
 
 
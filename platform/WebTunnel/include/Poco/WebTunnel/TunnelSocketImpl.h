@@ -50,6 +50,7 @@ public:
 	// StreamSocketImpl
 	virtual int sendBytes(const void* buffer, int length, int flags);		
 	virtual int receiveBytes(void* buffer, int length, int flags);
+	virtual Poco::UInt64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
 	virtual Poco::Net::SocketImpl* acceptConnection(Poco::Net::SocketAddress& clientAddr);
 	virtual void connect(const Poco::Net::SocketAddress& address);
 	virtual void connect(const Poco::Net::SocketAddress& address, const Poco::Timespan& timeout);
@@ -137,6 +137,14 @@ void TunnelSocketImpl::enqueueClose(Poco::UInt16 statusCode)
 }
 
 
+Poco::UInt64 TunnelSocketImpl::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	// The file must go through the tunnel, so it cannot be sent
+	// directly to the underlying socket.
+	return sendFileBuffered(istr, offset, count);
+}
+
+
 Poco::Net::SocketImpl* TunnelSocketImpl::acceptConnection(Poco::Net::SocketAddress& clientAddr)
 {
 	throw Poco::InvalidAccessException("Cannot acceptConnection() on a TunnelSocketImpl");
@@ -0,0 +1,313 @@
+//
+// BlueZGATTHelper.h
+//
+// $Id$
+//
+// Library: IoT/BtLE
+// Package: BtLE
+// Module:  BlueZGATTHelper
+//
+// Definition of the BlueZGATTHelper class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_BtLE_BlueZGATTHelper_INCLUDED
+#define IoT_BtLE_BlueZGATTHelper_INCLUDED
+
+
+#include "IoT/BtLE/BtLE.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include "Poco/Event.h"
+#include "Poco/Process.h"
+#include "Poco/Pipe.h"
+#include "Poco/Logger.h"
+#include <map>
+
+
+namespace IoT {
+namespace BtLE {
+
+
+class IoTBtLE_API BlueZGATTHelper: public Poco::Runnable
+	/// BlueZGATTHelper manages a single external helper process
+	/// that serves the connections to any number of Bluetooth LE
+	/// peripherals, using a binary protocol over the helper's
+	/// standard input and output.
+	///
+	/// Every message starts with a header, followed by a
+	/// message-specific payload. All integers are in network
+	/// byte order. Strings are prefixed with their length as UInt16.
+	///
+	///   - UInt16 length of the message, excluding the length field
+	///   - UInt8  message type
+	///   - UInt16 connection ID, assigned by the host
+	///   - UInt32 request ID, assigned by the host (0 for events)
+	///
+	/// Requests (host to helper):
+	///   - CONNECT (string address)
+	///   - DISCONNECT
+	///   - SERVICES
+	///   - CHARACTERISTICS (UInt16 firstHandle, UInt16 lastHandle)
+	///   - DESCRIPTORS (UInt16 firstHandle, UInt16 lastHandle)
+	///   - READ (UInt16 handle)
+	///   - WRITE (UInt16 handle, UInt8 withResponse, value)
+	///   - QUIT (connection and request ID 0)
+	///
+	/// Every request is answered with a RESULT or ERROR message carrying
+	/// the request ID. Requests may be answered in any order, so any number
+	/// of requests can be outstanding at the same time. A WRITE without
+	/// response is answered as soon as the value has been queued.
+	/// RESULT payloads:
+	///   - SERVICES: list of (UInt16 firstHandle, UInt16 lastHandle, string uuid)
+	///   - CHARACTERISTICS: list of (UInt16 handle, UInt16 properties,
+	///     UInt16 valueHandle, string uuid)
+	///   - DESCRIPTORS: list of (UInt16 handle, string uuid)
+	///   - READ: value
+	///   - all others: empty
+	///
+	/// The ERROR payload is a string with the error code (connfail, comerr,
+	/// protoerr, notfound, badcmd, badparam, badstate).
+	///
+	/// Events (helper to host, request ID 0):
+	///   - STATE (UInt8 state, UInt8 securityLevel, UInt16 mtu, string address,
+	///     string error), sent whenever the state of a connection changes.
+	///     State values correspond to GATTClient::State, security levels
+	///     to GATTClient::SecurityLevel. If a connection attempt fails or
+	///     a connection is lost, error contains the reason.
+	///   - NOTIFICATION (UInt16 handle, value)
+	///   - INDICATION (UInt16 handle, value)
+	///
+	/// The helper process is started when the first request is sent,
+	/// and restarted if it has terminated.
+	///
+	/// The helper used by BlueZGATTClient speaks a different, line-based
+	/// protocol and cannot be used with BlueZGATTHelper. If the helper
+	/// sends anything other than a valid message header, it is stopped
+	/// and all outstanding requests fail with a Poco::IOException
+	/// stating that the helper does not implement the protocol.
+{
+public:
+	typedef Poco::SharedPtr<BlueZGATTHelper> Ptr;
+
+	enum MessageType
+	{
+		MSG_CONNECT         = 0x01,
+		MSG_DISCONNECT      = 0x02,
+		MSG_SERVICES        = 0x03,
+		MSG_CHARACTERISTICS = 0x04,
+		MSG_DESCRIPTORS     = 0x05,
+		MSG_READ            = 0x06,
+		MSG_WRITE           = 0x07,
+		MSG_QUIT            = 0x0F,
+		MSG_RESULT          = 0x81,
+		MSG_ERROR           = 0x82,
+		MSG_STATE           = 0x83,
+		MSG_NOTIFICATION    = 0x84,
+		MSG_INDICATION      = 0x85
+	};
+
+	enum
+	{
+		HEADER_SIZE = 9,
+		MAX_MESSAGE_SIZE = 0xFFFF
+	};
+
+	class IoTBtLE_API Listener
+		/// A Listener receives the events for a connection.
+		/// Events are delivered by the BlueZGATTHelper's
+		/// reader thread.
+	{
+	public:
+		virtual void onStateChanged(int state, int securityLevel, Poco::UInt16 mtu, const std::string& address, const std::string& error) = 0;
+			/// Called when a STATE event has been received.
+
+		virtual void onNotification(Poco::UInt16 handle, const std::string& value) = 0;
+			/// Called when a NOTIFICATION event has been received.
+
+		virtual void onIndication(Poco::UInt16 handle, const std::string& value) = 0;
+			/// Called when an INDICATION event has been received.
+
+		virtual void onHelperTerminated() = 0;
+			/// Called when the helper process has terminated.
+			/// All connections are lost.
+
+	protected:
+		virtual ~Listener();
+	};
+
+	class IoTBtLE_API Request: public Poco::RefCountedObject
+		/// A Request represents an outstanding request.
+	{
+	public:
+		typedef Poco::AutoPtr<Request> Ptr;
+
+		Request(Poco::UInt32 id);
+			/// Creates the Request.
+
+		Poco::UInt32 id() const;
+			/// Returns the request ID.
+
+		bool done() const;
+			/// Returns true if the result or error has been received.
+
+	protected:
+		~Request();
+
+		void complete(const std::string& result);
+		void fail(const std::string& error);
+
+	private:
+		Poco::UInt32 _id;
+		std::string _result;
+		std::string _error;
+		bool _failed;
+		Poco::Event _done;
+
+		friend class BlueZGATTHelper;
+	};
+
+	explicit BlueZGATTHelper(const std::string& helperPath);
+		/// Creates the BlueZGATTHelper using the given helper path.
+
+	~BlueZGATTHelper();
+		/// Stops the helper process and destroys the BlueZGATTHelper.
+
+	Poco::UInt16 addConnection(Listener& listener);
+		/// Registers a Listener for a new connection and
+		/// returns the connection ID.
+
+	void removeConnection(Poco::UInt16 connection);
+		/// Unregisters the Listener for the given connection.
+
+	Request::Ptr sendRequest(Poco::UInt16 connection, MessageType type, const std::string& payload = std::string());
+		/// Sends a request and returns immediately, without
+		/// waiting for the result. Use waitResult() to obtain
+		/// the result.
+		///
+		/// Starts the helper process if it is not running.
+
+	std::string waitResult(Request::Ptr pRequest, long timeout);
+		/// Waits for the result of the given request and
+		/// returns the result payload.
+		///
+		/// Throws a Poco::TimeoutException if no result has been
+		/// received within the given timeout (in milliseconds),
+		/// and a Poco::IOException if the helper has reported an
+		/// error or has terminated.
+
+	std::string execute(Poco::UInt16 connection, MessageType type, const std::string& payload, long timeout);
+		/// Sends a request and waits for its result.
+
+	void stop();
+		/// Stops the helper process. Outstanding requests fail.
+
+	bool running() const;
+		/// Returns true if the helper process is running.
+
+	std::size_t outstandingRequests() const;
+		/// Returns the number of requests waiting for a result.
+
+	const std::string& helperPath() const;
+		/// Returns the path of the helper executable.
+
+	static void appendUInt16(std::string& buffer, Poco::UInt16 value);
+		/// Appends a UInt16 value to the given message buffer.
+
+	static void appendString(std::string& buffer, const std::string& value);
+		/// Appends a string value to the given message buffer.
+
+	static Poco::UInt16 extractUInt16(const std::string& buffer, std::size_t& pos);
+		/// Extracts a UInt16 value from the given message buffer.
+		///
+		/// Throws a Poco::ProtocolException if the buffer is too short.
+
+	static std::string extractString(const std::string& buffer, std::size_t& pos);
+		/// Extracts a string value from the given message buffer.
+		///
+		/// Throws a Poco::ProtocolException if the buffer is too short.
+
+	// Runnable
+	void run();
+
+protected:
+	typedef std::map<Poco::UInt32, Request::Ptr> RequestMap;
+	typedef std::map<Poco::UInt16, Listener*> ListenerMap;
+
+	void startHelper();
+	void writeMessage(Poco::UInt8 type, Poco::UInt16 connection, Poco::UInt32 request, const std::string& payload);
+	bool readMessage(std::string& message);
+	void dispatchMessage(const std::string& message);
+	void terminated(const std::string& error);
+	void killHelper();
+	Listener* findListener(Poco::UInt16 connection) const;
+	static void throwError(const std::string& code);
+
+	struct HelperInfo: public Poco::RefCountedObject
+	{
+		typedef Poco::AutoPtr<HelperInfo> Ptr;
+
+		HelperInfo(const Poco::ProcessHandle& ph, const Poco::Pipe& inputPipe, const Poco::Pipe& outputPipe):
+			processHandle(ph),
+			inputPipe(inputPipe),
+			outputPipe(outputPipe)
+		{
+		}
+
+		Poco::ProcessHandle processHandle;
+		Poco::Pipe inputPipe;
+		Poco::Pipe outputPipe;
+	};
+
+	enum
+	{
+		QUIT_TIMEOUT = 10000
+	};
+
+private:
+	BlueZGATTHelper();
+	BlueZGATTHelper(const BlueZGATTHelper&);
+	BlueZGATTHelper& operator = (const BlueZGATTHelper&);
+
+	std::string _helperPath;
+	HelperInfo::Ptr _pHelperInfo;
+	Poco::Thread _readerThread;
+	RequestMap _requests;
+	ListenerMap _listeners;
+	Poco::UInt32 _nextRequest;
+	Poco::UInt16 _nextConnection;
+	Poco::Logger& _logger;
+	mutable Poco::FastMutex _mutex;
+	Poco::FastMutex _writeMutex;
+	Poco::Mutex _listenerMutex;
+};
+
+
+//
+// inlines
+//
+inline Poco::UInt32 BlueZGATTHelper::Request::id() const
+{
+	return _id;
+}
+
+
+inline const std::string& BlueZGATTHelper::helperPath() const
+{
+	return _helperPath;
+}
+
+
+} } // namespace IoT::BtLE
+
+
+#endif // IoT_BtLE_BlueZGATTHelper_INCLUDED
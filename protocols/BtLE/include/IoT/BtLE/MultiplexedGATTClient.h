@@ -0,0 +1,147 @@
+//
+// MultiplexedGATTClient.h
+//
+// $Id$
+//
+// Library: IoT/BtLE
+// Package: BtLE
+// Module:  MultiplexedGATTClient
+//
+// Definition of the MultiplexedGATTClient class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_BtLE_MultiplexedGATTClient_INCLUDED
+#define IoT_BtLE_MultiplexedGATTClient_INCLUDED
+
+
+#include "IoT/BtLE/GATTClient.h"
+#include "IoT/BtLE/BlueZGATTHelper.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+#include "Poco/Logger.h"
+#include <map>
+
+
+namespace IoT {
+namespace BtLE {
+
+
+class IoTBtLE_API MultiplexedGATTClient: public GATTClient, protected BlueZGATTHelper::Listener
+	/// An implementation of the GATTClient interface that shares a
+	/// single BlueZGATTHelper, and thus a single helper process, with
+	/// any number of other MultiplexedGATTClient instances.
+	///
+	/// Requests are not serialized. If multiple threads use the
+	/// same MultiplexedGATTClient, their requests are outstanding
+	/// at the same time. Additionally, readAll() sends multiple
+	/// read requests at once.
+	///
+	/// Notifications, indications and state changes are delivered by
+	/// the BlueZGATTHelper's reader thread. Delegates for the
+	/// notificationReceived and indicationReceived events must
+	/// therefore not call methods that wait for a response from
+	/// the peripheral.
+{
+public:
+	MultiplexedGATTClient(BlueZGATTHelper::Ptr pHelper);
+		/// Creates the MultiplexedGATTClient using the given BlueZGATTHelper.
+
+	~MultiplexedGATTClient();
+		/// Destroys the MultiplexedGATTClient.
+
+	std::vector<std::string> readAll(const std::vector<Poco::UInt16>& handles);
+		/// Reads the values of the characteristics with the given value
+		/// handles. All read requests are sent without waiting for the
+		/// responses to previous requests.
+		///
+		/// Returns the values in the order of the given handles.
+
+	BlueZGATTHelper::Ptr helper() const;
+		/// Returns the BlueZGATTHelper.
+
+	// GATTClient
+	void connect(const std::string& address, ConnectMode mode);
+	void disconnect();
+	State state() const;
+	std::string address() const;
+	std::vector<Service> services();
+	std::vector<Service> includedServices(const std::string& serviceUUID);
+	std::vector<Characteristic> characteristics(const std::string& serviceUUID);
+	std::vector<Descriptor> descriptors(const std::string& serviceUUID);
+	std::string read(Poco::UInt16 handle);
+	void write(Poco::UInt16 handle, const std::string& value, bool withResponse);
+	void setSecurityLevel(SecurityLevel level);
+	SecurityLevel getSecurityLevel() const;
+	void setMTU(Poco::UInt8 mtu);
+	Poco::UInt8 getMTU() const;
+	void setTimeout(long timeout);
+	long getTimeout() const;
+
+protected:
+	struct ServiceDesc: public Poco::RefCountedObject
+	{
+		typedef Poco::AutoPtr<ServiceDesc> Ptr;
+
+		Service service;
+		std::vector<Characteristic> characteristics;
+		std::vector<Descriptor> descriptors;
+	};
+	typedef std::map<std::string, ServiceDesc::Ptr> ServiceMap;
+
+	enum
+	{
+		DEFAULT_TIMEOUT = 30000,
+		DISCONNECT_TIMEOUT = 2000
+	};
+
+	void changeState(State newState);
+	void checkConnected() const;
+	ServiceDesc::Ptr findService(const std::string& serviceUUID);
+	static std::string rangePayload(const Service& service);
+
+	// BlueZGATTHelper::Listener
+	void onStateChanged(int state, int securityLevel, Poco::UInt16 mtu, const std::string& address, const std::string& error);
+	void onNotification(Poco::UInt16 handle, const std::string& value);
+	void onIndication(Poco::UInt16 handle, const std::string& value);
+	void onHelperTerminated();
+
+private:
+	MultiplexedGATTClient();
+	MultiplexedGATTClient(const MultiplexedGATTClient&);
+	MultiplexedGATTClient& operator = (const MultiplexedGATTClient&);
+
+	BlueZGATTHelper::Ptr _pHelper;
+	Poco::UInt16 _connection;
+	std::string _address;
+	State _state;
+	SecurityLevel _securityLevel;
+	Poco::UInt8 _mtu;
+	long _timeout;
+	ServiceMap _services;
+	Poco::Logger& _logger;
+	mutable Poco::FastMutex _mutex;
+	mutable Poco::FastMutex _stateMutex;
+	Poco::FastMutex _connectMutex;
+};
+
+
+//
+// inlines
+//
+inline BlueZGATTHelper::Ptr MultiplexedGATTClient::helper() const
+{
+	return _pHelper;
+}
+
+
+} } // namespace IoT::BtLE
+
+
+#endif // IoT_BtLE_MultiplexedGATTClient_INCLUDED
@@ -0,0 +1,567 @@
+//
+// BlueZGATTHelper.cpp
+//
+// $Id$
+//
+// Library: IoT/BtLE
+// Package: BtLE
+// Module:  BlueZGATTHelper
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/BtLE/BlueZGATTHelper.h"
+#include "Poco/File.h"
+#include "Poco/Format.h"
+#include "Poco/Exception.h"
+
+
+namespace IoT {
+namespace BtLE {
+
+
+//
+// BlueZGATTHelper::Listener
+//
+
+
+BlueZGATTHelper::Listener::~Listener()
+{
+}
+
+
+//
+// BlueZGATTHelper::Request
+//
+
+
+BlueZGATTHelper::Request::Request(Poco::UInt32 id):
+	_id(id),
+	_failed(false),
+	_done(false)
+{
+}
+
+
+BlueZGATTHelper::Request::~Request()
+{
+}
+
+
+bool BlueZGATTHelper::Request::done() const
+{
+	return const_cast<Poco::Event&>(_done).tryWait(0);
+}
+
+
+void BlueZGATTHelper::Request::complete(const std::string& result)
+{
+	_result = result;
+	_done.set();
+}
+
+
+void BlueZGATTHelper::Request::fail(const std::string& error)
+{
+	_error = error;
+	_failed = true;
+	_done.set();
+}
+
+
+//
+// BlueZGATTHelper
+//
+
+
+BlueZGATTHelper::BlueZGATTHelper(const std::string& helperPath):
+	_helperPath(helperPath),
+	_nextRequest(1),
+	_nextConnection(1),
+	_logger(Poco::Logger::get("IoT.BlueZGATTHelper"))
+{
+}
+
+
+BlueZGATTHelper::~BlueZGATTHelper()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+Poco::UInt16 BlueZGATTHelper::addConnection(Listener& listener)
+{
+	Poco::Mutex::ScopedLock lock(_listenerMutex);
+
+	while (_nextConnection == 0 || _listeners.find(_nextConnection) != _listeners.end())
+	{
+		_nextConnection++;
+	}
+	Poco::UInt16 connection = _nextConnection++;
+	_listeners[connection] = &listener;
+	return connection;
+}
+
+
+void BlueZGATTHelper::removeConnection(Poco::UInt16 connection)
+{
+	Poco::Mutex::ScopedLock lock(_listenerMutex);
+
+	_listeners.erase(connection);
+}
+
+
+BlueZGATTHelper::Request::Ptr BlueZGATTHelper::sendRequest(Poco::UInt16 connection, MessageType type, const std::string& payload)
+{
+	Request::Ptr pRequest;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		startHelper();
+		if (_nextRequest == 0) _nextRequest++;
+		pRequest = new Request(_nextRequest++);
+		_requests[pRequest->id()] = pRequest;
+	}
+	try
+	{
+		writeMessage(static_cast<Poco::UInt8>(type), connection, pRequest->id(), payload);
+	}
+	catch (...)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_requests.erase(pRequest->id());
+		throw;
+	}
+	return pRequest;
+}
+
+
+std::string BlueZGATTHelper::waitResult(Request::Ptr pRequest, long timeout)
+{
+	if (!pRequest->_done.tryWait(timeout))
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_requests.erase(pRequest->id());
+		throw Poco::TimeoutException("timeout waiting for helper response");
+	}
+	if (pRequest->_failed) throwError(pRequest->_error);
+	return pRequest->_result;
+}
+
+
+std::string BlueZGATTHelper::execute(Poco::UInt16 connection, MessageType type, const std::string& payload, long timeout)
+{
+	return waitResult(sendRequest(connection, type, payload), timeout);
+}
+
+
+void BlueZGATTHelper::stop()
+{
+	HelperInfo::Ptr pHelperInfo;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		pHelperInfo = _pHelperInfo;
+	}
+	if (pHelperInfo)
+	{
+		_logger.debug("Stopping helper...");
+		if (_readerThread.isRunning())
+		{
+			try
+			{
+				writeMessage(MSG_QUIT, 0, 0, std::string());
+			}
+			catch (Poco::Exception&)
+			{
+			}
+		}
+		pHelperInfo->inputPipe.close(Poco::Pipe::CLOSE_WRITE);
+		try
+		{
+			_readerThread.join(QUIT_TIMEOUT);
+		}
+		catch (Poco::TimeoutException&)
+		{
+			Poco::Process::kill(pHelperInfo->processHandle);
+			_readerThread.join();
+		}
+		try
+		{
+			pHelperInfo->processHandle.wait();
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_pHelperInfo = 0;
+		_logger.debug("Helper stopped.");
+	}
+}
+
+
+bool BlueZGATTHelper::running() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _pHelperInfo && _readerThread.isRunning();
+}
+
+
+std::size_t BlueZGATTHelper::outstandingRequests() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _requests.size();
+}
+
+
+void BlueZGATTHelper::startHelper()
+{
+	if (_pHelperInfo && _readerThread.isRunning()) return;
+
+	if (_pHelperInfo)
+	{
+		_readerThread.join();
+		try
+		{
+			_pHelperInfo->processHandle.wait();
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		_pHelperInfo = 0;
+	}
+
+	_logger.debug(Poco::format("Starting helper: %s...", _helperPath));
+	Poco::File helperExec(_helperPath);
+	if (!helperExec.exists())
+		throw Poco::FileNotFoundException("helper executable not found", _helperPath);
+	if (!helperExec.canExecute())
+		throw Poco::FileException("helper executable does not have execute permission", _helperPath);
+
+	Poco::Pipe inputPipe;
+	Poco::Pipe outputPipe;
+	Poco::Process::Args args;
+	Poco::ProcessHandle ph = Poco::Process::launch(_helperPath, args, &inputPipe, &outputPipe, 0);
+	_pHelperInfo = new HelperInfo(ph, inputPipe, outputPipe);
+	_readerThread.start(*this);
+	_logger.debug("Helper started.");
+}
+
+
+void BlueZGATTHelper::writeMessage(Poco::UInt8 type, Poco::UInt16 connection, Poco::UInt32 request, const std::string& payload)
+{
+	HelperInfo::Ptr pHelperInfo;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		pHelperInfo = _pHelperInfo;
+	}
+	if (!pHelperInfo) throw Poco::IllegalStateException("helper process not running");
+
+	std::size_t length = HEADER_SIZE - 2 + payload.size();
+	if (length > MAX_MESSAGE_SIZE) throw Poco::InvalidArgumentException("message too large");
+
+	std::string message;
+	message.reserve(length + 2);
+	appendUInt16(message, static_cast<Poco::UInt16>(length));
+	message += static_cast<char>(type);
+	appendUInt16(message, connection);
+	appendUInt16(message, static_cast<Poco::UInt16>(request >> 16));
+	appendUInt16(message, static_cast<Poco::UInt16>(request & 0xFFFF));
+	message += payload;
+
+	Poco::FastMutex::ScopedLock lock(_writeMutex);
+
+	const char* p = message.data();
+	int n = static_cast<int>(message.size());
+	while (n > 0)
+	{
+		int rc = pHelperInfo->inputPipe.writeBytes(p, n);
+		if (rc <= 0) throw Poco::WriteFileException("cannot write to helper process");
+		p += rc;
+		n -= rc;
+	}
+}
+
+
+bool BlueZGATTHelper::readMessage(std::string& message)
+{
+	HelperInfo::Ptr pHelperInfo;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		pHelperInfo = _pHelperInfo;
+	}
+
+	// Read the length and the message type first, so that a helper
+	// speaking a different protocol is detected before waiting for
+	// the rest of a bogus message.
+	char header[3];
+	std::size_t got = 0;
+	while (got < 3)
+	{
+		int rc = pHelperInfo->outputPipe.readBytes(header + got, static_cast<int>(3 - got));
+		if (rc <= 0) return false;
+		got += rc;
+	}
+	std::size_t length = static_cast<unsigned char>(header[0])*256 + static_cast<unsigned char>(header[1]);
+	Poco::UInt8 type = static_cast<Poco::UInt8>(header[2]);
+	if (length < HEADER_SIZE - 2 || type < MSG_RESULT || type > MSG_INDICATION)
+	{
+		throw Poco::ProtocolException("unexpected data received from helper");
+	}
+	message.resize(length);
+	message[0] = header[2];
+	got = 1;
+	while (got < length)
+	{
+		int rc = pHelperInfo->outputPipe.readBytes(&message[got], static_cast<int>(length - got));
+		if (rc <= 0) return false;
+		got += rc;
+	}
+	return true;
+}
+
+
+void BlueZGATTHelper::run()
+{
+	std::string error("terminated");
+	std::string message;
+	try
+	{
+		while (readMessage(message))
+		{
+			try
+			{
+				dispatchMessage(message);
+			}
+			catch (Poco::Exception& exc)
+			{
+				_logger.log(exc);
+			}
+		}
+	}
+	catch (Poco::ProtocolException& exc)
+	{
+		_logger.error(Poco::format("Helper %s does not implement the multiplexed GATT helper protocol (%s). Stopping helper.", _helperPath, exc.message()));
+		error = "badhelper";
+		killHelper();
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.log(exc);
+	}
+	terminated(error);
+}
+
+
+void BlueZGATTHelper::dispatchMessage(const std::string& message)
+{
+	if (message.size() < HEADER_SIZE - 2) throw Poco::ProtocolException("helper message too short");
+
+	std::size_t pos = 0;
+	Poco::UInt8 type = static_cast<Poco::UInt8>(message[pos++]);
+	Poco::UInt16 connection = extractUInt16(message, pos);
+	Poco::UInt32 request = extractUInt16(message, pos);
+	request = (request << 16) | extractUInt16(message, pos);
+
+	switch (type)
+	{
+	case MSG_RESULT:
+	case MSG_ERROR:
+		{
+			Request::Ptr pRequest;
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+
+				RequestMap::iterator it = _requests.find(request);
+				if (it == _requests.end())
+				{
+					_logger.debug(Poco::format("Discarding result for request %u.", request));
+					return;
+				}
+				pRequest = it->second;
+				_requests.erase(it);
+			}
+			if (type == MSG_RESULT)
+				pRequest->complete(message.substr(pos));
+			else
+				pRequest->fail(extractString(message, pos));
+		}
+		break;
+
+	case MSG_STATE:
+		{
+			if (pos + 4 > message.size()) throw Poco::ProtocolException("helper STATE message too short");
+			int state = static_cast<Poco::UInt8>(message[pos++]);
+			int securityLevel = static_cast<Poco::UInt8>(message[pos++]);
+			Poco::UInt16 mtu = extractUInt16(message, pos);
+			std::string address = extractString(message, pos);
+			std::string error = extractString(message, pos);
+
+			Poco::Mutex::ScopedLock lock(_listenerMutex);
+			Listener* pListener = findListener(connection);
+			if (pListener) pListener->onStateChanged(state, securityLevel, mtu, address, error);
+		}
+		break;
+
+	case MSG_NOTIFICATION:
+	case MSG_INDICATION:
+		{
+			Poco::UInt16 handle = extractUInt16(message, pos);
+			std::string value(message, pos);
+
+			Poco::Mutex::ScopedLock lock(_listenerMutex);
+			Listener* pListener = findListener(connection);
+			if (pListener)
+			{
+				if (type == MSG_NOTIFICATION)
+					pListener->onNotification(handle, value);
+				else
+					pListener->onIndication(handle, value);
+			}
+		}
+		break;
+
+	default:
+		_logger.warning(Poco::format("Ignoring unknown helper message type 0x%x.", static_cast<unsigned>(type)));
+		break;
+	}
+}
+
+
+void BlueZGATTHelper::terminated(const std::string& error)
+{
+	_logger.debug("Helper terminated.");
+
+	RequestMap requests;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		std::swap(requests, _requests);
+	}
+	for (RequestMap::iterator it = requests.begin(); it != requests.end(); ++it)
+	{
+		it->second->fail(error);
+	}
+
+	Poco::Mutex::ScopedLock lock(_listenerMutex);
+	ListenerMap listeners(_listeners);
+	for (ListenerMap::iterator it = listeners.begin(); it != listeners.end(); ++it)
+	{
+		try
+		{
+			it->second->onHelperTerminated();
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.log(exc);
+		}
+	}
+}
+
+
+void BlueZGATTHelper::killHelper()
+{
+	HelperInfo::Ptr pHelperInfo;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		pHelperInfo = _pHelperInfo;
+	}
+	if (pHelperInfo)
+	{
+		try
+		{
+			Poco::Process::kill(pHelperInfo->processHandle);
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+}
+
+
+BlueZGATTHelper::Listener* BlueZGATTHelper::findListener(Poco::UInt16 connection) const
+{
+	ListenerMap::const_iterator it = _listeners.find(connection);
+	if (it != _listeners.end())
+		return it->second;
+	else
+		return 0;
+}
+
+
+void BlueZGATTHelper::throwError(const std::string& code)
+{
+	if (code == "connfail")
+		throw Poco::IOException("cannot connect to peripheral");
+	else if (code == "comerr")
+		throw Poco::IOException("peripheral device error");
+	else if (code == "protoerr")
+		throw Poco::IOException("protocol error");
+	else if (code == "notfound")
+		throw Poco::IOException("not found");
+	else if (code == "badcmd")
+		throw Poco::IOException("bad command");
+	else if (code == "badparam")
+		throw Poco::IOException("bad parameter");
+	else if (code == "badstate")
+		throw Poco::IOException("bad state");
+	else if (code == "terminated")
+		throw Poco::IOException("helper process terminated");
+	else if (code == "badhelper")
+		throw Poco::IOException("helper does not implement the multiplexed GATT helper protocol");
+	else
+		throw Poco::IOException(code);
+}
+
+
+void BlueZGATTHelper::appendUInt16(std::string& buffer, Poco::UInt16 value)
+{
+	buffer += static_cast<char>(value >> 8);
+	buffer += static_cast<char>(value & 0xFF);
+}
+
+
+void BlueZGATTHelper::appendString(std::string& buffer, const std::string& value)
+{
+	if (value.size() > 0xFFFF) throw Poco::InvalidArgumentException("string too long");
+	appendUInt16(buffer, static_cast<Poco::UInt16>(value.size()));
+	buffer += value;
+}
+
+
+Poco::UInt16 BlueZGATTHelper::extractUInt16(const std::string& buffer, std::size_t& pos)
+{
+	if (pos + 2 > buffer.size()) throw Poco::ProtocolException("helper message too short");
+	Poco::UInt16 value = static_cast<Poco::UInt16>(static_cast<unsigned char>(buffer[pos])*256 + static_cast<unsigned char>(buffer[pos + 1]));
+	pos += 2;
+	return value;
+}
+
+
+std::string BlueZGATTHelper::extractString(const std::string& buffer, std::size_t& pos)
+{
+	std::size_t length = extractUInt16(buffer, pos);
+	if (pos + length > buffer.size()) throw Poco::ProtocolException("helper message too short");
+	std::string value(buffer, pos, length);
+	pos += length;
+	return value;
+}
+
+
+} } // namespace IoT::BtLE
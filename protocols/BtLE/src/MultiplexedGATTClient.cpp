@@ -0,0 +1,478 @@
+//
+// MultiplexedGATTClient.cpp
+//
+// $Id$
+//
+// Library: IoT/BtLE
+// Package: BtLE
+// Module:  MultiplexedGATTClient
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/BtLE/MultiplexedGATTClient.h"
+#include "Poco/Format.h"
+
+
+namespace IoT {
+namespace BtLE {
+
+
+MultiplexedGATTClient::MultiplexedGATTClient(BlueZGATTHelper::Ptr pHelper):
+	_pHelper(pHelper),
+	_connection(0),
+	_state(GATT_STATE_DISCONNECTED),
+	_securityLevel(GATT_SECURITY_LOW),
+	_mtu(0),
+	_timeout(DEFAULT_TIMEOUT),
+	_logger(Poco::Logger::get("IoT.MultiplexedGATTClient"))
+{
+	_connection = _pHelper->addConnection(*this);
+}
+
+
+MultiplexedGATTClient::~MultiplexedGATTClient()
+{
+	try
+	{
+		disconnect();
+	}
+	catch (...)
+	{
+	}
+	_pHelper->removeConnection(_connection);
+}
+
+
+void MultiplexedGATTClient::connect(const std::string& address, ConnectMode mode)
+{
+	Poco::FastMutex::ScopedLock lock(_connectMutex);
+
+	if (state() != GATT_STATE_DISCONNECTED)
+		throw Poco::IllegalStateException("can only connect if current state is disconnected");
+
+	_logger.debug("Connecting to peripheral " + address + "...");
+
+	changeState(GATT_STATE_CONNECTING);
+	try
+	{
+		std::string payload;
+		BlueZGATTHelper::appendString(payload, address);
+		BlueZGATTHelper::Request::Ptr pRequest = _pHelper->sendRequest(_connection, BlueZGATTHelper::MSG_CONNECT, payload);
+		if (mode == GATT_CONNECT_WAIT)
+		{
+			_pHelper->waitResult(pRequest, getTimeout());
+			if (state() != GATT_STATE_CONNECTED)
+			{
+				_logger.warning(Poco::format("Invalid state after connect: %d", static_cast<int>(state())));
+			}
+		}
+	}
+	catch (...)
+	{
+		changeState(GATT_STATE_DISCONNECTED);
+		throw;
+	}
+}
+
+
+void MultiplexedGATTClient::disconnect()
+{
+	Poco::FastMutex::ScopedLock lock(_connectMutex);
+
+	State currentState = state();
+	if (currentState == GATT_STATE_CONNECTED || currentState == GATT_STATE_CONNECTING)
+	{
+		_logger.debug("Disconnecting from peripheral " + address() + "...");
+
+		changeState(GATT_STATE_DISCONNECTING);
+		try
+		{
+			_pHelper->execute(_connection, BlueZGATTHelper::MSG_DISCONNECT, std::string(), DISCONNECT_TIMEOUT);
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.log(exc);
+		}
+		changeState(GATT_STATE_DISCONNECTED);
+
+		_logger.debug("Disconnected.");
+	}
+}
+
+
+GATTClient::State MultiplexedGATTClient::state() const
+{
+	Poco::FastMutex::ScopedLock lock(_stateMutex);
+
+	return _state;
+}
+
+
+std::string MultiplexedGATTClient::address() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _address;
+}
+
+
+std::vector<GATTClient::Service> MultiplexedGATTClient::services()
+{
+	checkConnected();
+
+	bool empty;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		empty = _services.empty();
+	}
+	if (empty)
+	{
+		std::string result = _pHelper->execute(_connection, BlueZGATTHelper::MSG_SERVICES, std::string(), getTimeout());
+		ServiceMap services;
+		std::size_t pos = 0;
+		while (pos < result.size())
+		{
+			ServiceDesc::Ptr pServiceDesc = new ServiceDesc;
+			pServiceDesc->service.firstHandle = BlueZGATTHelper::extractUInt16(result, pos);
+			pServiceDesc->service.lastHandle = BlueZGATTHelper::extractUInt16(result, pos);
+			pServiceDesc->service.uuid = BlueZGATTHelper::extractString(result, pos);
+			services[pServiceDesc->service.uuid] = pServiceDesc;
+		}
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (_services.empty()) std::swap(_services, services);
+	}
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	std::vector<GATTClient::Service> result;
+	for (ServiceMap::const_iterator it = _services.begin(); it != _services.end(); ++it)
+	{
+		result.push_back(it->second->service);
+	}
+	return result;
+}
+
+
+std::vector<GATTClient::Service> MultiplexedGATTClient::includedServices(const std::string& serviceUUID)
+{
+	throw Poco::NotImplementedException("MultiplexedGATTClient::includedServices");
+}
+
+
+std::vector<GATTClient::Characteristic> MultiplexedGATTClient::characteristics(const std::string& serviceUUID)
+{
+	checkConnected();
+
+	ServiceDesc::Ptr pServiceDesc = findService(serviceUUID);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (!pServiceDesc->characteristics.empty()) return pServiceDesc->characteristics;
+	}
+
+	std::string result = _pHelper->execute(_connection, BlueZGATTHelper::MSG_CHARACTERISTICS, rangePayload(pServiceDesc->service), getTimeout());
+	std::vector<Characteristic> characteristics;
+	std::size_t pos = 0;
+	while (pos < result.size())
+	{
+		Characteristic chara;
+		chara.handle = BlueZGATTHelper::extractUInt16(result, pos);
+		chara.properties = BlueZGATTHelper::extractUInt16(result, pos);
+		chara.valueHandle = BlueZGATTHelper::extractUInt16(result, pos);
+		chara.uuid = BlueZGATTHelper::extractString(result, pos);
+		characteristics.push_back(chara);
+	}
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	pServiceDesc->characteristics = characteristics;
+	return characteristics;
+}
+
+
+std::vector<GATTClient::Descriptor> MultiplexedGATTClient::descriptors(const std::string& serviceUUID)
+{
+	checkConnected();
+
+	ServiceDesc::Ptr pServiceDesc = findService(serviceUUID);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (!pServiceDesc->descriptors.empty()) return pServiceDesc->descriptors;
+	}
+
+	std::string result = _pHelper->execute(_connection, BlueZGATTHelper::MSG_DESCRIPTORS, rangePayload(pServiceDesc->service), getTimeout());
+	std::vector<Descriptor> descriptors;
+	std::size_t pos = 0;
+	while (pos < result.size())
+	{
+		Descriptor desc;
+		desc.handle = BlueZGATTHelper::extractUInt16(result, pos);
+		desc.uuid = BlueZGATTHelper::extractString(result, pos);
+		descriptors.push_back(desc);
+	}
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	pServiceDesc->descriptors = descriptors;
+	return descriptors;
+}
+
+
+std::string MultiplexedGATTClient::read(Poco::UInt16 handle)
+{
+	checkConnected();
+
+	std::string payload;
+	BlueZGATTHelper::appendUInt16(payload, handle);
+	return _pHelper->execute(_connection, BlueZGATTHelper::MSG_READ, payload, getTimeout());
+}
+
+
+std::vector<std::string> MultiplexedGATTClient::readAll(const std::vector<Poco::UInt16>& handles)
+{
+	checkConnected();
+
+	std::vector<BlueZGATTHelper::Request::Ptr> requests;
+	requests.reserve(handles.size());
+	for (std::vector<Poco::UInt16>::const_iterator it = handles.begin(); it != handles.end(); ++it)
+	{
+		std::string payload;
+		BlueZGATTHelper::appendUInt16(payload, *it);
+		requests.push_back(_pHelper->sendRequest(_connection, BlueZGATTHelper::MSG_READ, payload));
+	}
+
+	long timeout = getTimeout();
+	std::vector<std::string> values;
+	values.reserve(requests.size());
+	for (std::vector<BlueZGATTHelper::Request::Ptr>::iterator it = requests.begin(); it != requests.end(); ++it)
+	{
+		values.push_back(_pHelper->waitResult(*it, timeout));
+	}
+	return values;
+}
+
+
+void MultiplexedGATTClient::write(Poco::UInt16 handle, const std::string& value, bool withResponse)
+{
+	checkConnected();
+
+	if (value.empty())
+		throw Poco::InvalidArgumentException("cannot write empty value");
+
+	std::string payload;
+	BlueZGATTHelper::appendUInt16(payload, handle);
+	payload += static_cast<char>(withResponse ? 1 : 0);
+	payload += value;
+	BlueZGATTHelper::Request::Ptr pRequest = _pHelper->sendRequest(_connection, BlueZGATTHelper::MSG_WRITE, payload);
+	if (withResponse)
+	{
+		_pHelper->waitResult(pRequest, getTimeout());
+	}
+}
+
+
+void MultiplexedGATTClient::setSecurityLevel(SecurityLevel level)
+{
+	throw Poco::NotImplementedException("MultiplexedGATTClient::setSecurityLevel");
+}
+
+
+GATTClient::SecurityLevel MultiplexedGATTClient::getSecurityLevel() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _securityLevel;
+}
+
+
+void MultiplexedGATTClient::setMTU(Poco::UInt8 mtu)
+{
+	throw Poco::NotImplementedException("MultiplexedGATTClient::setMTU");
+}
+
+
+Poco::UInt8 MultiplexedGATTClient::getMTU() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _mtu;
+}
+
+
+void MultiplexedGATTClient::setTimeout(long timeout)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_timeout = timeout;
+}
+
+
+long MultiplexedGATTClient::getTimeout() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _timeout;
+}
+
+
+void MultiplexedGATTClient::changeState(State state)
+{
+	bool stateChanged = false;
+	{
+		Poco::FastMutex::ScopedLock lock(_stateMutex);
+
+		stateChanged = (state != _state);
+		_state = state;
+	}
+
+	if (stateChanged)
+	{
+		switch (state)
+		{
+		case GATT_STATE_CONNECTED:
+			connected.notifyAsync(this);
+			break;
+		case GATT_STATE_DISCONNECTED:
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_address.clear();
+				_services.clear();
+			}
+			disconnected.notifyAsync(this);
+			break;
+		case GATT_STATE_CONNECTING:
+		case GATT_STATE_DISCONNECTING:
+			break;
+		}
+	}
+}
+
+
+void MultiplexedGATTClient::checkConnected() const
+{
+	if (state() != GATT_STATE_CONNECTED)
+		throw Poco::IllegalStateException("not connected");
+}
+
+
+MultiplexedGATTClient::ServiceDesc::Ptr MultiplexedGATTClient::findService(const std::string& serviceUUID)
+{
+	services();
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	ServiceMap::iterator it = _services.find(serviceUUID);
+	if (it == _services.end())
+		throw Poco::NotFoundException("Service", serviceUUID);
+	return it->second;
+}
+
+
+std::string MultiplexedGATTClient::rangePayload(const Service& service)
+{
+	std::string payload;
+	BlueZGATTHelper::appendUInt16(payload, service.firstHandle);
+	BlueZGATTHelper::appendUInt16(payload, service.lastHandle);
+	return payload;
+}
+
+
+void MultiplexedGATTClient::onStateChanged(int state, int securityLevel, Poco::UInt16 mtu, const std::string& address, const std::string& error)
+{
+	switch (state)
+	{
+	case GATT_STATE_CONNECTING:
+		changeState(GATT_STATE_CONNECTING);
+		break;
+
+	case GATT_STATE_CONNECTED:
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			_mtu = static_cast<Poco::UInt8>(mtu);
+			if (securityLevel >= GATT_SECURITY_LOW && securityLevel <= GATT_SECURITY_HIGH)
+				_securityLevel = static_cast<SecurityLevel>(securityLevel);
+			else
+				_logger.warning(Poco::format("received invalid security level: %d", securityLevel));
+			_address = address;
+		}
+		changeState(GATT_STATE_CONNECTED);
+		_logger.information("Connected to " + address);
+		break;
+
+	case GATT_STATE_DISCONNECTING:
+		break;
+
+	case GATT_STATE_DISCONNECTED:
+		if (!error.empty())
+		{
+			try
+			{
+				this->error(error);
+			}
+			catch (...)
+			{
+			}
+		}
+		if (this->state() != GATT_STATE_DISCONNECTING)
+		{
+			changeState(GATT_STATE_DISCONNECTED);
+		}
+		break;
+
+	default:
+		_logger.warning(Poco::format("received invalid state: %d", state));
+		break;
+	}
+}
+
+
+void MultiplexedGATTClient::onNotification(Poco::UInt16 handle, const std::string& value)
+{
+	Notification nf;
+	nf.handle = handle;
+	nf.data = value;
+	try
+	{
+		notificationReceived(this, nf);
+	}
+	catch (...)
+	{
+	}
+}
+
+
+void MultiplexedGATTClient::onIndication(Poco::UInt16 handle, const std::string& value)
+{
+	Indication ind;
+	ind.handle = handle;
+	ind.data = value;
+	try
+	{
+		indicationReceived(this, ind);
+	}
+	catch (...)
+	{
+	}
+}
+
+
+void MultiplexedGATTClient::onHelperTerminated()
+{
+	if (state() != GATT_STATE_DISCONNECTED)
+	{
+		try
+		{
+			error(std::string("terminated"));
+		}
+		catch (...)
+		{
+		}
+		changeState(GATT_STATE_DISCONNECTED);
+	}
+}
+
+
+} } // namespace IoT::BtLE
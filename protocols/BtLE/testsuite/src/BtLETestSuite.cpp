@@ -0,0 +1,24 @@
+//
+// BtLETestSuite.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "BtLETestSuite.h"
+#include "MultiplexedGATTClientTest.h"
+
+
+CppUnit::Test* BtLETestSuite::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("BtLETestSuite");
+
+	pSuite->addTest(MultiplexedGATTClientTest::suite());
+
+	return pSuite;
+}
@@ -0,0 +1,29 @@
+//
+// BtLETestSuite.h
+//
+// $Id$
+//
+// Definition of the BtLETestSuite class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef BtLETestSuite_INCLUDED
+#define BtLETestSuite_INCLUDED
+
+
+#include "CppUnit/TestSuite.h"
+
+
+class BtLETestSuite
+{
+public:
+	static CppUnit::Test* suite();
+};
+
+
+#endif // BtLETestSuite_INCLUDED
@@ -0,0 +1,301 @@
+//
+// GATTHelperStub.cpp
+//
+// $Id$
+//
+// A stand-in for the BlueZ GATT helper, speaking the binary protocol
+// of BlueZGATTHelper over standard input and output, without
+// accessing any Bluetooth hardware.
+//
+//   - Connecting to an address starting with "00:00" fails.
+//   - Every service has characteristics at firstHandle + 1 and + 4,
+//     and a client characteristic configuration descriptor at + 3.
+//   - Reading handle 0x0200 is answered only after the next request.
+//   - Reading handle 0xDEAD terminates the helper.
+//   - Writing 01 00 to a handle sends three notifications for the
+//     preceding handle.
+//   - If the environment variable GATTHELPERSTUB_TEXT is not empty, the stub
+//     answers every request with a line of text, like the helper used
+//     by BlueZGATTClient.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "Poco/Types.h"
+#include "Poco/NumberFormatter.h"
+#include <map>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+
+namespace
+{
+	enum
+	{
+		MSG_CONNECT         = 0x01,
+		MSG_DISCONNECT      = 0x02,
+		MSG_SERVICES        = 0x03,
+		MSG_CHARACTERISTICS = 0x04,
+		MSG_DESCRIPTORS     = 0x05,
+		MSG_READ            = 0x06,
+		MSG_WRITE           = 0x07,
+		MSG_QUIT            = 0x0F,
+		MSG_RESULT          = 0x81,
+		MSG_ERROR           = 0x82,
+		MSG_STATE           = 0x83,
+		MSG_NOTIFICATION    = 0x84
+	};
+
+	enum
+	{
+		STATE_DISCONNECTED = 0,
+		STATE_CONNECTED    = 2
+	};
+
+	struct Connection
+	{
+		Connection(): connected(false)
+		{
+		}
+
+		bool connected;
+		std::string address;
+		std::map<Poco::UInt16, std::string> values;
+	};
+
+	typedef std::map<Poco::UInt16, Connection> ConnectionMap;
+
+	void appendUInt16(std::string& buffer, Poco::UInt16 value)
+	{
+		buffer += static_cast<char>(value >> 8);
+		buffer += static_cast<char>(value & 0xFF);
+	}
+
+	void appendString(std::string& buffer, const std::string& value)
+	{
+		appendUInt16(buffer, static_cast<Poco::UInt16>(value.size()));
+		buffer += value;
+	}
+
+	Poco::UInt16 extractUInt16(const std::string& buffer, std::size_t& pos)
+	{
+		if (pos + 2 > buffer.size()) return 0;
+		Poco::UInt16 value = static_cast<Poco::UInt16>(static_cast<unsigned char>(buffer[pos])*256 + static_cast<unsigned char>(buffer[pos + 1]));
+		pos += 2;
+		return value;
+	}
+
+	std::string extractString(const std::string& buffer, std::size_t& pos)
+	{
+		std::size_t length = extractUInt16(buffer, pos);
+		if (pos + length > buffer.size()) length = buffer.size() - pos;
+		std::string value(buffer, pos, length);
+		pos += length;
+		return value;
+	}
+
+	void send(int type, Poco::UInt16 connection, Poco::UInt32 request, const std::string& payload)
+	{
+		std::string message;
+		appendUInt16(message, static_cast<Poco::UInt16>(7 + payload.size()));
+		message += static_cast<char>(type);
+		appendUInt16(message, connection);
+		appendUInt16(message, static_cast<Poco::UInt16>(request >> 16));
+		appendUInt16(message, static_cast<Poco::UInt16>(request & 0xFFFF));
+		message += payload;
+		std::fwrite(message.data(), 1, message.size(), stdout);
+		std::fflush(stdout);
+	}
+
+	void sendState(Poco::UInt16 connection, int state, const std::string& address, const std::string& error)
+	{
+		std::string payload;
+		payload += static_cast<char>(state);
+		payload += static_cast<char>(0);
+		appendUInt16(payload, 23);
+		appendString(payload, address);
+		appendString(payload, error);
+		send(MSG_STATE, connection, 0, payload);
+	}
+
+	void sendError(Poco::UInt16 connection, Poco::UInt32 request, const std::string& code)
+	{
+		std::string payload;
+		appendString(payload, code);
+		send(MSG_ERROR, connection, request, payload);
+	}
+
+	bool receive(std::string& message)
+	{
+		unsigned char header[2];
+		if (std::fread(header, 1, 2, stdin) != 2) return false;
+		std::size_t length = header[0]*256 + header[1];
+		message.resize(length);
+		if (length > 0 && std::fread(&message[0], 1, length, stdin) != length) return false;
+		return true;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	ConnectionMap connections;
+	Poco::UInt16 deferredConnection = 0;
+	Poco::UInt32 deferredRequest = 0;
+
+	std::string message;
+	const char* text = std::getenv("GATTHELPERSTUB_TEXT");
+	if (text && *text)
+	{
+		while (receive(message))
+		{
+			std::fputs("$mode=error;code=badcmd;\n", stdout);
+			std::fflush(stdout);
+		}
+		return 0;
+	}
+
+	while (receive(message))
+	{
+		if (message.size() < 7) return 1;
+		std::size_t pos = 0;
+		int type = static_cast<unsigned char>(message[pos++]);
+		Poco::UInt16 connection = extractUInt16(message, pos);
+		Poco::UInt32 request = extractUInt16(message, pos);
+		request = (request << 16) | extractUInt16(message, pos);
+
+		if (type == MSG_QUIT) return 0;
+
+		Connection& conn = connections[connection];
+		std::string result;
+		switch (type)
+		{
+		case MSG_CONNECT:
+			{
+				std::string address = extractString(message, pos);
+				if (conn.connected)
+				{
+					sendError(connection, request, "badstate");
+					continue;
+				}
+				if (address.compare(0, 5, "00:00") == 0)
+				{
+					sendState(connection, STATE_DISCONNECTED, address, "connfail");
+					sendError(connection, request, "connfail");
+					continue;
+				}
+				conn.connected = true;
+				conn.address = address;
+				sendState(connection, STATE_CONNECTED, address, "");
+			}
+			break;
+
+		case MSG_DISCONNECT:
+			if (conn.connected)
+			{
+				conn.connected = false;
+				sendState(connection, STATE_DISCONNECTED, conn.address, "");
+			}
+			break;
+
+		case MSG_SERVICES:
+			appendUInt16(result, 0x0020);
+			appendUInt16(result, 0x002F);
+			appendString(result, "f000aa00-0451-4000-b000-000000000000");
+			appendUInt16(result, 0x0030);
+			appendUInt16(result, 0x003F);
+			appendString(result, "f000aa10-0451-4000-b000-000000000000");
+			break;
+
+		case MSG_CHARACTERISTICS:
+			{
+				Poco::UInt16 first = extractUInt16(message, pos);
+				appendUInt16(result, first + 1);
+				appendUInt16(result, 0x12);
+				appendUInt16(result, first + 2);
+				appendString(result, "f000aa01-0451-4000-b000-000000000000");
+				appendUInt16(result, first + 4);
+				appendUInt16(result, 0x0A);
+				appendUInt16(result, first + 5);
+				appendString(result, "f000aa02-0451-4000-b000-000000000000");
+			}
+			break;
+
+		case MSG_DESCRIPTORS:
+			{
+				Poco::UInt16 first = extractUInt16(message, pos);
+				appendUInt16(result, first + 3);
+				appendString(result, "00002902-0000-1000-8000-00805f9b34fb");
+			}
+			break;
+
+		case MSG_READ:
+			{
+				Poco::UInt16 handle = extractUInt16(message, pos);
+				if (!conn.connected)
+				{
+					sendError(connection, request, "badstate");
+					continue;
+				}
+				if (handle == 0xDEAD)
+				{
+					std::exit(1);
+				}
+				if (handle == 0x0200)
+				{
+					deferredConnection = connection;
+					deferredRequest = request;
+					continue;
+				}
+				std::map<Poco::UInt16, std::string>::const_iterator it = conn.values.find(handle);
+				if (it != conn.values.end())
+					result = it->second;
+				else
+					result = conn.address + "/" + Poco::NumberFormatter::formatHex(handle, 4);
+			}
+			break;
+
+		case MSG_WRITE:
+			{
+				Poco::UInt16 handle = extractUInt16(message, pos);
+				pos++; // withResponse; writes are always answered
+				std::string value(message, pos < message.size() ? pos : message.size());
+				if (!conn.connected)
+				{
+					sendError(connection, request, "badstate");
+					continue;
+				}
+				conn.values[handle] = value;
+				if (value == std::string("\x01\x00", 2))
+				{
+					for (int i = 0; i < 3; i++)
+					{
+						std::string payload;
+						appendUInt16(payload, handle - 1);
+						payload += static_cast<char>(i);
+						send(MSG_NOTIFICATION, connection, 0, payload);
+					}
+				}
+			}
+			break;
+
+		default:
+			sendError(connection, request, "badcmd");
+			continue;
+		}
+
+		send(MSG_RESULT, connection, request, result);
+
+		if (deferredRequest != 0 && deferredRequest != request)
+		{
+			send(MSG_RESULT, deferredConnection, deferredRequest, "slow");
+			deferredRequest = 0;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,439 @@
+//
+// MultiplexedGATTClientTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "MultiplexedGATTClientTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/BtLE/MultiplexedGATTClient.h"
+#include "IoT/BtLE/BlueZGATTHelper.h"
+#include "Poco/ActiveMethod.h"
+#include "Poco/Delegate.h"
+#include "Poco/Exception.h"
+#include "Poco/Thread.h"
+#include "Poco/Environment.h"
+
+
+using IoT::BtLE::GATTClient;
+using IoT::BtLE::MultiplexedGATTClient;
+using IoT::BtLE::BlueZGATTHelper;
+
+
+namespace
+{
+	class AsyncReader
+	{
+	public:
+		AsyncReader(MultiplexedGATTClient& client):
+			read(this, &AsyncReader::readImpl),
+			_client(client)
+		{
+		}
+
+		Poco::ActiveMethod<std::string, Poco::UInt16, AsyncReader> read;
+
+	protected:
+		std::string readImpl(const Poco::UInt16& handle)
+		{
+			return _client.read(handle);
+		}
+
+	private:
+		MultiplexedGATTClient& _client;
+	};
+
+	const std::string ADDRESS1("68:C9:0B:06:23:09");
+	const std::string ADDRESS2("68:C9:0B:06:23:0A");
+	const std::string BAD_ADDRESS("00:00:00:00:00:01");
+	const std::string SERVICE_UUID("f000aa00-0451-4000-b000-000000000000");
+}
+
+
+MultiplexedGATTClientTest::MultiplexedGATTClientTest(const std::string& name):
+	CppUnit::TestCase(name),
+	_connected(false),
+	_disconnected(false)
+{
+}
+
+
+MultiplexedGATTClientTest::~MultiplexedGATTClientTest()
+{
+}
+
+
+void MultiplexedGATTClientTest::testConnect()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client(pHelper);
+	client.connected += Poco::delegate(this, &MultiplexedGATTClientTest::onConnected);
+	client.disconnected += Poco::delegate(this, &MultiplexedGATTClientTest::onDisconnected);
+
+	assert (client.state() == GATTClient::GATT_STATE_DISCONNECTED);
+	assert (!pHelper->running());
+
+	client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+	assert (pHelper->running());
+	assert (client.state() == GATTClient::GATT_STATE_CONNECTED);
+	assert (client.address() == ADDRESS1);
+	assert (client.getMTU() == 23);
+	assert (client.getSecurityLevel() == GATTClient::GATT_SECURITY_LOW);
+	assert (_connected.tryWait(5000));
+
+	try
+	{
+		client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+		fail("already connected - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+
+	client.disconnect();
+	assert (client.state() == GATTClient::GATT_STATE_DISCONNECTED);
+	assert (client.address().empty());
+	assert (_disconnected.tryWait(5000));
+	assert (pHelper->outstandingRequests() == 0);
+
+	client.connected -= Poco::delegate(this, &MultiplexedGATTClientTest::onConnected);
+	client.disconnected -= Poco::delegate(this, &MultiplexedGATTClientTest::onDisconnected);
+}
+
+
+void MultiplexedGATTClientTest::testConnectFailure()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client(pHelper);
+	client.error += Poco::delegate(this, &MultiplexedGATTClientTest::onError);
+
+	try
+	{
+		client.connect(BAD_ADDRESS, GATTClient::GATT_CONNECT_WAIT);
+		fail("connection failure - must throw");
+	}
+	catch (Poco::IOException&)
+	{
+	}
+	assert (client.state() == GATTClient::GATT_STATE_DISCONNECTED);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		assert (_error == "connfail");
+	}
+
+	client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+	assert (client.state() == GATTClient::GATT_STATE_CONNECTED);
+
+	client.error -= Poco::delegate(this, &MultiplexedGATTClientTest::onError);
+}
+
+
+void MultiplexedGATTClientTest::testDiscovery()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client(pHelper);
+
+	try
+	{
+		client.services();
+		fail("not connected - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+
+	client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+
+	std::vector<GATTClient::Service> services = client.services();
+	assert (services.size() == 2);
+	assert (services[0].uuid == SERVICE_UUID);
+	assert (services[0].firstHandle == 0x0020);
+	assert (services[0].lastHandle == 0x002F);
+	assert (services[1].firstHandle == 0x0030);
+
+	std::vector<GATTClient::Characteristic> chars = client.characteristics(SERVICE_UUID);
+	assert (chars.size() == 2);
+	assert (chars[0].handle == 0x0021);
+	assert (chars[0].valueHandle == 0x0022);
+	assert (chars[0].properties == (GATTClient::GATT_PROP_READ | GATTClient::GATT_PROP_NOTIFY));
+	assert (chars[1].handle == 0x0024);
+	assert (chars[1].valueHandle == 0x0025);
+
+	std::vector<GATTClient::Descriptor> descs = client.descriptors(SERVICE_UUID);
+	assert (descs.size() == 1);
+	assert (descs[0].handle == 0x0023);
+	assert (descs[0].uuid == "00002902-0000-1000-8000-00805f9b34fb");
+
+	try
+	{
+		client.characteristics("00000000-0000-0000-0000-000000000000");
+		fail("unknown service - must throw");
+	}
+	catch (Poco::NotFoundException&)
+	{
+	}
+}
+
+
+void MultiplexedGATTClientTest::testReadWrite()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client(pHelper);
+	client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+
+	assert (client.read(0x0022) == ADDRESS1 + "/0022");
+
+	client.write(0x0025, "\x12\x34", true);
+	assert (client.read(0x0025) == "\x12\x34");
+
+	client.write(0x0025, "\x56", false);
+	assert (client.read(0x0025) == "\x56");
+
+	try
+	{
+		client.write(0x0025, "", true);
+		fail("empty value - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+	assert (pHelper->outstandingRequests() == 0);
+}
+
+
+void MultiplexedGATTClientTest::testPipelinedReads()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client(pHelper);
+	client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+
+	AsyncReader reader(client);
+	Poco::ActiveResult<std::string> slow = reader.read(0x0200);
+	while (pHelper->outstandingRequests() == 0) Poco::Thread::sleep(10);
+
+	// The helper holds back the response to the first read until it
+	// has answered the second one.
+	assert (!slow.available());
+	assert (client.read(0x0022) == ADDRESS1 + "/0022");
+	slow.wait(5000);
+	assert (slow.data() == "slow");
+	assert (pHelper->outstandingRequests() == 0);
+}
+
+
+void MultiplexedGATTClientTest::testReadAll()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client(pHelper);
+	client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+
+	std::vector<Poco::UInt16> handles;
+	handles.push_back(0x0200);
+	handles.push_back(0x0022);
+	handles.push_back(0x0025);
+	std::vector<std::string> values = client.readAll(handles);
+	assert (values.size() == 3);
+	assert (values[0] == "slow");
+	assert (values[1] == ADDRESS1 + "/0022");
+	assert (values[2] == ADDRESS1 + "/0025");
+	assert (pHelper->outstandingRequests() == 0);
+}
+
+
+void MultiplexedGATTClientTest::testNotifications()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client(pHelper);
+	client.notificationReceived += Poco::delegate(this, &MultiplexedGATTClientTest::onNotification);
+	client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+
+	client.write(0x0023, std::string("\x01\x00", 2), true);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		assert (_notifications.size() == 3);
+		for (int i = 0; i < 3; i++)
+		{
+			assert (_notifications[i].handle == 0x0022);
+			assert (_notifications[i].data == std::string(1, static_cast<char>(i)));
+		}
+	}
+
+	client.notificationReceived -= Poco::delegate(this, &MultiplexedGATTClientTest::onNotification);
+}
+
+
+void MultiplexedGATTClientTest::testSharedHelper()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client1(pHelper);
+	MultiplexedGATTClient client2(pHelper);
+	client2.notificationReceived += Poco::delegate(this, &MultiplexedGATTClientTest::onNotification);
+
+	client1.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+	client2.connect(ADDRESS2, GATTClient::GATT_CONNECT_WAIT);
+	assert (client1.address() == ADDRESS1);
+	assert (client2.address() == ADDRESS2);
+
+	AsyncReader reader(client1);
+	Poco::ActiveResult<std::string> slow = reader.read(0x0200);
+	while (pHelper->outstandingRequests() == 0) Poco::Thread::sleep(10);
+
+	assert (client2.read(0x0022) == ADDRESS2 + "/0022");
+	slow.wait(5000);
+	assert (slow.data() == "slow");
+
+	client1.write(0x0023, std::string("\x01\x00", 2), true);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		assert (_notifications.empty());
+	}
+	client2.write(0x0023, std::string("\x01\x00", 2), true);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		assert (_notifications.size() == 3);
+	}
+
+	client1.disconnect();
+	assert (client1.state() == GATTClient::GATT_STATE_DISCONNECTED);
+	assert (client2.state() == GATTClient::GATT_STATE_CONNECTED);
+	assert (client2.read(0x0025) == ADDRESS2 + "/0025");
+
+	client2.notificationReceived -= Poco::delegate(this, &MultiplexedGATTClientTest::onNotification);
+}
+
+
+void MultiplexedGATTClientTest::testHelperTerminated()
+{
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client1(pHelper);
+	MultiplexedGATTClient client2(pHelper);
+	client1.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+	client2.connect(ADDRESS2, GATTClient::GATT_CONNECT_WAIT);
+
+	try
+	{
+		client1.read(0xDEAD);
+		fail("helper terminated - must throw");
+	}
+	catch (Poco::IOException&)
+	{
+	}
+
+	int n = 0;
+	while ((pHelper->running() || client2.state() != GATTClient::GATT_STATE_DISCONNECTED) && n++ < 100)
+	{
+		Poco::Thread::sleep(50);
+	}
+	assert (!pHelper->running());
+	assert (client1.state() == GATTClient::GATT_STATE_DISCONNECTED);
+	assert (client2.state() == GATTClient::GATT_STATE_DISCONNECTED);
+	assert (pHelper->outstandingRequests() == 0);
+
+	client2.connect(ADDRESS2, GATTClient::GATT_CONNECT_WAIT);
+	assert (pHelper->running());
+	assert (client2.read(0x0022) == ADDRESS2 + "/0022");
+}
+
+
+void MultiplexedGATTClientTest::testWrongHelper()
+{
+	Poco::Environment::set("GATTHELPERSTUB_TEXT", "1");
+	BlueZGATTHelper::Ptr pHelper = new BlueZGATTHelper(helperPath());
+	MultiplexedGATTClient client(pHelper);
+	try
+	{
+		client.connect(ADDRESS1, GATTClient::GATT_CONNECT_WAIT);
+		fail("helper speaks text protocol - must throw");
+	}
+	catch (Poco::IOException& exc)
+	{
+		assert (exc.message().find("multiplexed") != std::string::npos);
+	}
+
+	int n = 0;
+	while (pHelper->running() && n++ < 100)
+	{
+		Poco::Thread::sleep(50);
+	}
+	assert (!pHelper->running());
+	assert (pHelper->outstandingRequests() == 0);
+}
+
+
+void MultiplexedGATTClientTest::setUp()
+{
+	_connected.reset();
+	_disconnected.reset();
+	_error.clear();
+	_notifications.clear();
+}
+
+
+void MultiplexedGATTClientTest::tearDown()
+{
+	Poco::Environment::set("GATTHELPERSTUB_TEXT", "");
+}
+
+
+void MultiplexedGATTClientTest::onConnected()
+{
+	_connected.set();
+}
+
+
+void MultiplexedGATTClientTest::onDisconnected()
+{
+	_disconnected.set();
+}
+
+
+void MultiplexedGATTClientTest::onError(const std::string& error)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_error = error;
+}
+
+
+void MultiplexedGATTClientTest::onNotification(const GATTClient::Notification& nf)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_notifications.push_back(nf);
+}
+
+
+std::string MultiplexedGATTClientTest::helperPath()
+{
+	std::string path("./GATTHelperStub");
+#if defined(_DEBUG)
+	path += "d";
+#endif
+	return path;
+}
+
+
+CppUnit::Test* MultiplexedGATTClientTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("MultiplexedGATTClientTest");
+
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testConnect);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testConnectFailure);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testDiscovery);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testReadWrite);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testPipelinedReads);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testReadAll);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testNotifications);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testSharedHelper);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testHelperTerminated);
+	CppUnit_addTest(pSuite, MultiplexedGATTClientTest, testWrongHelper);
+
+	return pSuite;
+}
@@ -0,0 +1,66 @@
+//
+// MultiplexedGATTClientTest.h
+//
+// $Id$
+//
+// Definition of the MultiplexedGATTClientTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef MultiplexedGATTClientTest_INCLUDED
+#define MultiplexedGATTClientTest_INCLUDED
+
+
+#include "IoT/BtLE/BtLE.h"
+#include "IoT/BtLE/GATTClient.h"
+#include "CppUnit/TestCase.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include <vector>
+
+
+class MultiplexedGATTClientTest: public CppUnit::TestCase
+{
+public:
+	MultiplexedGATTClientTest(const std::string& name);
+	~MultiplexedGATTClientTest();
+
+	void testConnect();
+	void testConnectFailure();
+	void testDiscovery();
+	void testReadWrite();
+	void testPipelinedReads();
+	void testReadAll();
+	void testNotifications();
+	void testSharedHelper();
+	void testHelperTerminated();
+	void testWrongHelper();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+protected:
+	void onConnected();
+	void onDisconnected();
+	void onError(const std::string& error);
+	void onNotification(const IoT::BtLE::GATTClient::Notification& nf);
+
+	static std::string helperPath();
+
+private:
+	Poco::Event _connected;
+	Poco::Event _disconnected;
+	std::string _error;
+	std::vector<IoT::BtLE::GATTClient::Notification> _notifications;
+	Poco::FastMutex _mutex;
+};
+
+
+#endif // MultiplexedGATTClientTest_INCLUDED
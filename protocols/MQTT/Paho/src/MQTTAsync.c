@@ -927,9 +927,10 @@ void MQTTAsync_writeComplete(int socket)
 }
 			
 
-void MQTTAsync_processCommand()
+int MQTTAsync_processCommand()
 {
 	int rc = 0;
+	int processed = 0;
 	MQTTAsync_queuedCommand* command = NULL;
 	ListElement* cur_command = NULL;
 	List* ignored_clients = NULL;
@@ -979,6 +980,7 @@ void MQTTAsync_processCommand()
 	
 	if (!command)
 		goto exit; /* nothing to do */
+	processed = 1;
 	
 	if (command->command.type == CONNECT)
 	{
@@ -1166,7 +1168,8 @@ void MQTTAsync_processCommand()
 
 exit:
 	MQTTAsync_unlock_mutex(mqttasync_mutex);
-	FUNC_EXIT;
+	FUNC_EXIT_RC(processed);
+	return processed;
 }
 
 
@@ -1265,13 +1268,12 @@ thread_return_type WINAPI MQTTAsync_sendThread(void* n)
 		
 		while (commands->count > 0)
 		{
-			int before = commands->count;
-			MQTTAsync_processCommand();
-			if (before == commands->count)
+			/* comparing the command count before and after is not enough, as
+			   commands may be added concurrently */
+			if (!MQTTAsync_processCommand())
 				break;  /* no commands were processed, so go into a wait */
 		}
 #if !defined(WIN32) && !defined(WIN64)
-		rc =  Thread_wait_cond(send_cond, 1);
 		if ((rc = Thread_wait_cond(send_cond, 1)) != 0 && rc != ETIMEDOUT)
 			Log(LOG_ERROR, -1, "Error %d waiting for condition variable", rc);
 #else
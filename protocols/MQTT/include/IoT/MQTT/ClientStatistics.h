@@ -0,0 +1,149 @@
+//
+// ClientStatistics.h
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  ClientStatistics
+//
+// Definition of the ClientStatistics class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_MQTT_ClientStatistics_INCLUDED
+#define IoT_MQTT_ClientStatistics_INCLUDED
+
+
+#include "IoT/MQTT/MQTTClient.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/RWLock.h"
+#include "Poco/Mutex.h"
+#include "Poco/Clock.h"
+#include <map>
+
+
+namespace IoT {
+namespace MQTT {
+
+
+class IoTMQTT_API ClientStatistics
+	/// ClientStatistics collects the message counters and delivery
+	/// latencies reported by MQTTClient::statistics().
+	///
+	/// All counters are updated with atomic operations, so recording
+	/// a message does not serialize the publishing and callback threads.
+	/// Per-topic counters are only created for the first maxTopics topics;
+	/// messages for any further topics are counted under the topic "#".
+	///
+	/// The delivery latency of a QoS 1 or 2 message is the time between
+	/// messagePublished() and messageDelivered() for its token. Send times
+	/// are kept in a fixed-size table indexed by token, so recording them
+	/// requires no allocation.
+{
+public:
+	enum
+	{
+		DEFAULT_MAX_TOPICS = 256
+	};
+
+	explicit ClientStatistics(int maxTopics = DEFAULT_MAX_TOPICS);
+		/// Creates the ClientStatistics.
+
+	~ClientStatistics();
+		/// Destroys the ClientStatistics.
+
+	void messagePublished(const std::string& topic, int qos, std::size_t size, int token);
+		/// Records a message published with the given QoS and token.
+
+	void messageDelivered(int token);
+		/// Records the acknowledgement of the message with the given token.
+
+	void messageReceived(const std::string& topic, std::size_t size);
+		/// Records a received message.
+
+	void connectionLost();
+		/// Records the loss of the connection to the server.
+
+	void reconnected();
+		/// Records a successful automatic reconnect.
+
+	void reset();
+		/// Resets all message counters and latency histograms.
+		/// The connection counters are kept.
+
+	void collect(Statistics& stats) const;
+		/// Stores the current counters and histograms in stats.
+		/// The inflight and queued gauges are not touched.
+
+protected:
+	class Int64
+		/// A 64-bit integer with atomic operations.
+	{
+	public:
+		Int64();
+		Poco::Int64 add(Poco::Int64 n);
+		Poco::Int64 value() const;
+		Poco::Int64 exchange(Poco::Int64 n);
+		bool compareAndSet(Poco::Int64 expected, Poco::Int64 n);
+
+	private:
+		volatile Poco::Int64 _value;
+#if !defined(POCO_HAVE_GCC_ATOMICS) && !defined(POCO_OS_FAMILY_WINDOWS)
+		mutable Poco::FastMutex _mutex;
+#endif
+	};
+
+	enum
+	{
+		PENDING_SLOTS = 4096,
+		BUCKETS = 17
+	};
+
+	struct Histogram
+	{
+		Poco::AtomicCounter buckets[BUCKETS];
+		Poco::AtomicCounter count;
+		Int64 sum;
+	};
+
+	typedef std::map<std::string, Poco::SharedPtr<Poco::AtomicCounter> > TopicCounters;
+
+	void countTopic(TopicCounters& counters, const std::string& topic);
+	void collectTopics(const TopicCounters& counters, std::vector<TopicCount>& counts) const;
+	virtual Poco::Int64 elapsed() const;
+		/// Returns the time in microseconds since the
+		/// ClientStatistics object has been created.
+
+	static const Poco::Int64 BUCKET_LIMITS[BUCKETS - 1];
+
+private:
+	ClientStatistics(const ClientStatistics&);
+	ClientStatistics& operator = (const ClientStatistics&);
+
+	std::size_t _maxTopics;
+	TopicCounters _received;
+	TopicCounters _published;
+	mutable Poco::RWLock _topicsLock;
+	Int64 _messagesReceived;
+	Int64 _messagesPublished;
+	Int64 _bytesReceived;
+	Int64 _bytesPublished;
+	Poco::AtomicCounter _connectionsLost;
+	Poco::AtomicCounter _reconnects;
+	Int64 _pending[PENDING_SLOTS];
+	Histogram _latency[2];
+	Poco::Clock _start;
+};
+
+
+} } // namespace IoT::MQTT
+
+
+#endif // IoT_MQTT_ClientStatistics_INCLUDED
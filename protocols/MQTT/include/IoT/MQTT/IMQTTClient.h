@@ -108,7 +108,8 @@ public:
 		/// Returns the configured server URI.
 
 	virtual IoT::MQTT::Statistics statistics() const = 0;
-		/// Returns statistics about published and received topics and message counts.
+		/// Returns statistics about published and received topics and message counts,
+		/// traffic totals and delivery latencies.
 
 	virtual void subscribe(const std::string& topic, int qos) = 0;
 		/// This function attempts to subscribe the client to a single topic, 
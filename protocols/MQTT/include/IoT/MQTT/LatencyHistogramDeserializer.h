@@ -0,0 +1,64 @@
+//
+// LatencyHistogramDeserializer.h
+//
+// Package: Generated
+// Module:  TypeDeserializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeDeserializer_IoT_MQTT_LatencyHistogram_INCLUDED
+#define TypeDeserializer_IoT_MQTT_LatencyHistogram_INCLUDED
+
+
+#include "IoT/MQTT/MQTTClient.h"
+#include "Poco/RemotingNG/TypeDeserializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeDeserializer<IoT::MQTT::LatencyHistogram>
+{
+public:
+	static bool deserialize(const std::string& name, bool isMandatory, Deserializer& deser, IoT::MQTT::LatencyHistogram& value)
+	{
+		bool ret = deser.deserializeStructBegin(name, isMandatory);
+		if (ret)
+		{
+			deserializeImpl(deser, value);
+			deser.deserializeStructEnd(name);
+		}
+		return ret;
+	}
+
+	static void deserializeImpl(Deserializer& deser, IoT::MQTT::LatencyHistogram& value)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"bucketCounts","bucketLimits","count","mean","qos"};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeDeserializer<std::vector < int > >::deserialize(REMOTING__NAMES[0], true, deser, value.bucketCounts);
+		TypeDeserializer<std::vector < double > >::deserialize(REMOTING__NAMES[1], true, deser, value.bucketLimits);
+		TypeDeserializer<int >::deserialize(REMOTING__NAMES[2], true, deser, value.count);
+		TypeDeserializer<double >::deserialize(REMOTING__NAMES[3], true, deser, value.mean);
+		TypeDeserializer<int >::deserialize(REMOTING__NAMES[4], true, deser, value.qos);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeDeserializer_IoT_MQTT_LatencyHistogram_INCLUDED
+
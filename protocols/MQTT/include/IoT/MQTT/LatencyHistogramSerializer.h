@@ -0,0 +1,60 @@
+//
+// LatencyHistogramSerializer.h
+//
+// Package: Generated
+// Module:  TypeSerializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2015, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeSerializer_IoT_MQTT_LatencyHistogram_INCLUDED
+#define TypeSerializer_IoT_MQTT_LatencyHistogram_INCLUDED
+
+
+#include "IoT/MQTT/MQTTClient.h"
+#include "Poco/RemotingNG/TypeSerializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeSerializer<IoT::MQTT::LatencyHistogram>
+{
+public:
+	static void serialize(const std::string& name, const IoT::MQTT::LatencyHistogram& value, Serializer& ser)
+	{
+		ser.serializeStructBegin(name);
+		serializeImpl(value, ser);
+		ser.serializeStructEnd(name);
+	}
+
+	static void serializeImpl(const IoT::MQTT::LatencyHistogram& value, Serializer& ser)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"bucketCounts","bucketLimits","count","mean","qos",""};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeSerializer<std::vector < int > >::serialize(REMOTING__NAMES[0], value.bucketCounts, ser);
+		TypeSerializer<std::vector < double > >::serialize(REMOTING__NAMES[1], value.bucketLimits, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[2], value.count, ser);
+		TypeSerializer<double >::serialize(REMOTING__NAMES[3], value.mean, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[4], value.qos, ser);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeSerializer_IoT_MQTT_LatencyHistogram_INCLUDED
+
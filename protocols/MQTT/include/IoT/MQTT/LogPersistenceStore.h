@@ -0,0 +1,161 @@
+//
+// LogPersistenceStore.h
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  LogPersistenceStore
+//
+// Definition of the LogPersistenceStore class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_MQTT_LogPersistenceStore_INCLUDED
+#define IoT_MQTT_LogPersistenceStore_INCLUDED
+
+
+#include "IoT/MQTT/PersistenceStore.h"
+#include "Poco/Activity.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include <map>
+#include <cstdio>
+
+
+namespace IoT {
+namespace MQTT {
+
+
+class IoTMQTT_API LogPersistenceStore: public PersistenceStore
+	/// A PersistenceStore that appends all changes to a log of
+	/// segment files, which is kept in a directory per client
+	/// below the given base path.
+	///
+	/// Each put() or remove() appends a checksummed record to the
+	/// current segment. An in-memory index maps every key to the
+	/// location of its most recent record, so get() requires a single
+	/// read. When the current segment is full, a new one is started.
+	/// The oldest segment is deleted as soon as it no longer contains
+	/// live records. If only a small part of the oldest segment is still
+	/// live, the live records are copied to the current segment first.
+	///
+	/// Records are written to storage in groups: a background thread
+	/// flushes and synchronizes the current segment at the given sync
+	/// interval, so a crash loses at most the changes made within the
+	/// last interval. With a sync interval of 0, every change is
+	/// synchronized before put() or remove() returns.
+	///
+	/// When the store is opened, the index is rebuilt by replaying all
+	/// segments. A partially written record at the end of the log is
+	/// discarded.
+{
+public:
+	enum
+	{
+		DEFAULT_SEGMENT_SIZE  = 4*1024*1024,
+		DEFAULT_SYNC_INTERVAL = 100
+	};
+
+	LogPersistenceStore(const std::string& path, Poco::UInt32 segmentSize = DEFAULT_SEGMENT_SIZE, long syncInterval = DEFAULT_SYNC_INTERVAL);
+		/// Creates the LogPersistenceStore, using the given base directory,
+		/// segment size (in bytes) and sync interval (in milliseconds).
+
+	~LogPersistenceStore();
+		/// Destroys the LogPersistenceStore.
+
+	void sync();
+		/// Writes all buffered records to the current segment
+		/// and synchronizes it to storage.
+
+	// PersistenceStore
+	void open(const std::string& clientId, const std::string& serverURI);
+	void close();
+	void put(const std::string& key, const std::string& data);
+	bool get(const std::string& key, std::string& data);
+	void remove(const std::string& key);
+	void keys(std::vector<std::string>& keys);
+	void clear();
+	bool containsKey(const std::string& key);
+
+protected:
+	enum RecordType
+	{
+		RECORD_PUT    = 1,
+		RECORD_REMOVE = 2
+	};
+
+	enum
+	{
+		RECORD_MAGIC       = 0xA5,
+		RECORD_HEADER_SIZE = 12
+	};
+
+	struct Location
+	{
+		Poco::UInt32 segment;
+		Poco::UInt32 offset;
+		Poco::UInt32 size;
+	};
+
+	struct Segment
+	{
+		Segment():
+			size(0),
+			liveRecords(0),
+			liveBytes(0)
+		{
+		}
+
+		Poco::UInt32 size;
+		Poco::UInt32 liveRecords;
+		Poco::UInt32 liveBytes;
+	};
+
+	typedef std::map<std::string, Location> Index;
+	typedef std::map<Poco::UInt32, Segment> Segments;
+
+	void runActivity();
+	void recover();
+	void replay(Poco::UInt32 id);
+	void append(RecordType type, const std::string& key, const std::string& data);
+	bool write(const std::string& record, Location& location);
+	void readRecord(const Location& location, std::string& key, std::string& data);
+	void closeReader();
+	void release(const Location& location);
+	void collect();
+	void startSegment(Poco::UInt32 id);
+	void closeSegment();
+	void syncImpl();
+	std::string segmentPath(Poco::UInt32 id) const;
+
+	static void encodeRecord(RecordType type, const std::string& key, const std::string& data, std::string& record);
+	static bool decodeRecord(const char* pRecord, std::size_t available, RecordType& type, std::string& key, std::string& data, Poco::UInt32& size);
+
+private:
+	std::string _basePath;
+	std::string _path;
+	Poco::UInt32 _segmentSize;
+	long _syncInterval;
+	Index _index;
+	Segments _segments;
+	Poco::UInt32 _current;
+	std::FILE* _pFile;
+	Poco::UInt32 _readSegment;
+	std::FILE* _pReadFile;
+	bool _dirty;
+	Poco::Event _syncEvent;
+	Poco::Activity<LogPersistenceStore> _activity;
+	Poco::FastMutex _mutex;
+};
+
+
+} } // namespace IoT::MQTT
+
+
+#endif // IoT_MQTT_LogPersistenceStore_INCLUDED
@@ -166,11 +166,102 @@ struct TopicCount
 };
 
 
+//@ serialize
+struct LatencyHistogram
+	/// The distribution of the time between publishing a
+	/// message and its acknowledgement by the server, for
+	/// messages published with a given QoS level.
+{
+	LatencyHistogram():
+		qos(0),
+		count(0),
+		mean(0)
+	{
+	}
+
+	int qos;
+		/// The QoS level (1 or 2).
+
+	int count;
+		/// The number of acknowledged messages.
+
+	double mean;
+		/// The mean latency in milliseconds.
+
+	std::vector<double> bucketLimits;
+		/// The upper limits of the histogram buckets, in milliseconds.
+
+	std::vector<int> bucketCounts;
+		/// The number of messages in each bucket. The last element
+		/// counts the messages exceeding the last bucket limit, so
+		/// there is one more element than in bucketLimits.
+};
+
+
 //@ serialize
 struct Statistics
 {
+	Statistics():
+		messagesReceived(0),
+		messagesPublished(0),
+		bytesReceived(0),
+		bytesPublished(0),
+		inflight(0),
+		queued(0),
+		connectionsLost(0),
+		reconnects(0)
+	{
+	}
+
 	std::vector<TopicCount> receivedMessages;
+		/// The number of messages received, per topic.
+		///
+		/// The number of topics is limited. Messages for topics
+		/// exceeding the limit are counted under the topic "#".
+
 	std::vector<TopicCount> publishedMessages;
+		/// The number of messages published, per topic.
+		///
+		/// The number of topics is limited. Messages for topics
+		/// exceeding the limit are counted under the topic "#".
+
+	//@ mandatory=false
+	Poco::Int64 messagesReceived;
+		/// The total number of messages received.
+
+	//@ mandatory=false
+	Poco::Int64 messagesPublished;
+		/// The total number of messages published.
+
+	//@ mandatory=false
+	Poco::Int64 bytesReceived;
+		/// The total payload size of all messages received.
+
+	//@ mandatory=false
+	Poco::Int64 bytesPublished;
+		/// The total payload size of all messages published.
+
+	//@ mandatory=false
+	int inflight;
+		/// The number of QoS 1 and 2 messages published, but
+		/// not yet acknowledged by the server.
+
+	//@ mandatory=false
+	int queued;
+		/// The number of received messages waiting to be
+		/// processed by asynchronous message handlers.
+
+	//@ mandatory=false
+	int connectionsLost;
+		/// The number of times the connection to the server has been lost.
+
+	//@ mandatory=false
+	int reconnects;
+		/// The number of successful automatic reconnects.
+
+	//@ mandatory=false
+	std::vector<LatencyHistogram> deliveryLatency;
+		/// The delivery latency histograms for QoS 1 and 2.
 };
 
 
@@ -236,7 +327,8 @@ public:
 		/// topics with their QoS level.
 		
 	virtual Statistics statistics() const = 0;
-		/// Returns statistics about published and received topics and message counts.
+		/// Returns statistics about published and received topics and message counts,
+		/// traffic totals and delivery latencies.
 
 	virtual int publish(const std::string& topic, const std::string& payload, int qos) = 0;
 		/// Publishes the given message on the given topic, using the given QoS.
@@ -0,0 +1,260 @@
+//
+// MessageRouter.h
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  MessageRouter
+//
+// Definition of the MessageRouter class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_MQTT_MessageRouter_INCLUDED
+#define IoT_MQTT_MessageRouter_INCLUDED
+
+
+#include "IoT/MQTT/MQTT.h"
+#include "IoT/MQTT/MQTTClient.h"
+#include "Poco/OSP/Service.h"
+#include "Poco/AbstractDelegate.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/NotificationQueue.h"
+#include "Poco/Thread.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/RWLock.h"
+#include "Poco/Mutex.h"
+#include "Poco/Logger.h"
+#include <vector>
+#include <map>
+
+
+namespace IoT {
+namespace MQTT {
+
+
+class IoTMQTT_API MessageRouter: public Poco::OSP::Service
+	/// The MessageRouter dispatches the messages received by a
+	/// MQTTClient to the handlers registered for matching topic filters.
+	///
+	/// Topic filters may contain the single-level wildcard "+" and the
+	/// multi-level wildcard "#". Filters are kept in a topic tree, so
+	/// routing a message only visits the routes whose filter matches
+	/// the message's topic, regardless of how many routes have been added.
+	/// As required by the MQTT specification, a wildcard in the first level
+	/// does not match topics starting with "$".
+	///
+	/// Handlers have the same signature as delegates for the
+	/// MQTTClient::messageArrived event. All handlers receive the
+	/// same MessageArrivedEvent object; the message is not copied.
+	///
+	/// Handlers of routes added with DISPATCH_SYNC are called in the
+	/// client's callback thread. If such a handler throws, the client
+	/// will attempt to deliver the message again, unless the message
+	/// has also been queued for a route added with DISPATCH_ASYNC.
+	/// In that case, the message is not delivered again, as the
+	/// asynchronous handlers would otherwise receive it twice.
+	/// Note that a message delivered again is also passed again to
+	/// the synchronous handlers that did not throw. Handlers of routes
+	/// added with DISPATCH_ASYNC are called by one of the router's worker
+	/// threads, so slow handlers do not hold up the client. All messages
+	/// for a route are handled by the same worker thread, in the order in
+	/// which they have been received. If the queue of a worker thread is
+	/// full, further messages for its routes are dropped.
+	///
+	/// The MQTT client bundle creates a MessageRouter for every
+	/// configured client and registers it with the service registry
+	/// under the name "io.macchina.mqtt.router#<n>", where <n>
+	/// is the index of the client (see the service name of the client).
+	/// The service properties are the same as for the client, except for
+	/// "io.macchina.protocol", which is set to "io.macchina.mqtt.router".
+{
+public:
+	typedef Poco::AutoPtr<MessageRouter> Ptr;
+	typedef Poco::AbstractDelegate<const MessageArrivedEvent> Delegate;
+	typedef Poco::SharedPtr<MessageArrivedEvent> EventPtr;
+
+	enum DispatchMode
+	{
+		DISPATCH_SYNC,  /// Call the handler in the client's callback thread.
+		DISPATCH_ASYNC  /// Call the handler in a worker thread.
+	};
+
+	enum
+	{
+		DEFAULT_WORKERS        = 2,
+		DEFAULT_QUEUE_CAPACITY = 1024
+	};
+
+	MessageRouter(int workers = DEFAULT_WORKERS, int queueCapacity = DEFAULT_QUEUE_CAPACITY);
+		/// Creates the MessageRouter.
+		///
+		/// The given number of worker threads is started when
+		/// the first route using DISPATCH_ASYNC is added. Every
+		/// worker thread queues up to queueCapacity messages.
+
+	~MessageRouter();
+		/// Destroys the MessageRouter.
+
+	int addRoute(const std::string& topicFilter, const Delegate& delegate, DispatchMode mode = DISPATCH_SYNC);
+		/// Adds a route that passes all messages with a topic matching
+		/// the given topic filter to the given delegate, which is usually
+		/// created with Poco::delegate().
+		///
+		/// Returns an ID for the route, which must be passed to removeRoute().
+		/// Throws a Poco::InvalidArgumentException if the topic filter
+		/// is not valid.
+
+	void removeRoute(int id);
+		/// Removes the route with the given ID.
+		///
+		/// After removeRoute() returns, the route's handler will no
+		/// longer be called, even if messages for it are still queued.
+
+	bool empty() const;
+		/// Returns true if no routes have been added.
+
+	bool route(const void* pSender, const EventPtr& pEvent);
+		/// Passes the given message to the handlers of all matching routes.
+		///
+		/// Returns false if a handler called in the calling thread
+		/// has thrown an exception and the message has not been
+		/// queued for any asynchronous route, otherwise true.
+
+	void stop();
+		/// Stops all worker threads. Queued messages are discarded.
+
+	int droppedMessages() const;
+		/// Returns the number of messages that have been dropped
+		/// because the queue of a worker thread was full.
+
+	int queued() const;
+		/// Returns the number of messages waiting to be
+		/// passed to handlers by the worker threads.
+
+	static bool isValidFilter(const std::string& topicFilter);
+		/// Returns true if the given topic filter is valid.
+
+	static bool matches(const std::string& topicFilter, const std::string& topic);
+		/// Returns true if the given topic matches the given topic filter.
+
+	// Service
+	const std::type_info& type() const;
+	bool isA(const std::type_info& otherType) const;
+
+protected:
+	class Route: public Poco::RefCountedObject
+	{
+	public:
+		typedef Poco::AutoPtr<Route> Ptr;
+
+		Route(int id, const std::string& filter, const Delegate& delegate, DispatchMode mode);
+
+		int id() const;
+		const std::string& filter() const;
+		DispatchMode mode() const;
+		void notify(const void* pSender, const MessageArrivedEvent& event);
+		void disable();
+
+	protected:
+		~Route();
+
+	private:
+		int _id;
+		std::string _filter;
+		Poco::SharedPtr<Delegate> _pDelegate;
+		DispatchMode _mode;
+	};
+
+	struct Node
+	{
+		~Node();
+
+		typedef std::map<std::string, Node*> Children;
+
+		Children children;
+		std::vector<Route::Ptr> routes;
+	};
+
+	class RouteNotification;
+
+	class Worker: public Poco::Runnable
+	{
+	public:
+		Worker();
+		~Worker();
+
+		void start();
+		void stop();
+		void enqueue(Route::Ptr pRoute, const void* pSender, const EventPtr& pEvent);
+		int queued() const;
+
+		// Runnable
+		void run();
+
+	private:
+		Poco::NotificationQueue _queue;
+		Poco::Thread _thread;
+	};
+
+	typedef std::map<int, Route::Ptr> RouteMap;
+	typedef std::vector<Poco::SharedPtr<Worker> > Workers;
+
+	void collect(const Node& node, const std::vector<std::string>& levels, std::size_t level, std::vector<Route::Ptr>& routes) const;
+	static void split(const std::string& topic, std::vector<std::string>& levels);
+
+private:
+	MessageRouter(const MessageRouter&);
+	MessageRouter& operator = (const MessageRouter&);
+
+	int _workerCount;
+	int _queueCapacity;
+	int _nextId;
+	Node _root;
+	RouteMap _routes;
+	Workers _workers;
+	Poco::AtomicCounter _dropped;
+	Poco::Logger& _logger;
+	mutable Poco::RWLock _lock;
+};
+
+
+//
+// inlines
+//
+inline int MessageRouter::droppedMessages() const
+{
+	return _dropped.value();
+}
+
+
+inline int MessageRouter::Route::id() const
+{
+	return _id;
+}
+
+
+inline const std::string& MessageRouter::Route::filter() const
+{
+	return _filter;
+}
+
+
+inline MessageRouter::DispatchMode MessageRouter::Route::mode() const
+{
+	return _mode;
+}
+
+
+} } // namespace IoT::MQTT
+
+
+#endif // IoT_MQTT_MessageRouter_INCLUDED
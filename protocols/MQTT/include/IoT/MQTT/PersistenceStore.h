@@ -0,0 +1,130 @@
+//
+// PersistenceStore.h
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  PersistenceStore
+//
+// Definition of the PersistenceStore class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_MQTT_PersistenceStore_INCLUDED
+#define IoT_MQTT_PersistenceStore_INCLUDED
+
+
+#include "IoT/MQTT/MQTT.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Logger.h"
+#include <vector>
+
+
+extern "C" {
+#include "MQTTClientPersistence.h"
+}
+
+
+namespace IoT {
+namespace MQTT {
+
+
+class IoTMQTT_API PersistenceStore
+	/// The base class for persistent stores for in-flight QoS 1 and 2
+	/// messages, which can be used with both the synchronous and the
+	/// asynchronous paho client (MQTTCLIENT_PERSISTENCE_USER).
+	///
+	/// Subclasses implement the store operations and signal errors
+	/// by throwing exceptions. Exceptions are logged and reported
+	/// to paho as MQTTCLIENT_PERSISTENCE_ERROR.
+{
+public:
+	typedef Poco::SharedPtr<PersistenceStore> Ptr;
+
+	PersistenceStore();
+		/// Creates the PersistenceStore.
+
+	virtual ~PersistenceStore();
+		/// Destroys the PersistenceStore.
+
+	MQTTClient_persistence* persistence();
+		/// Returns the paho persistence interface for this store,
+		/// to be passed to MQTTClient_create() or MQTTAsync_create()
+		/// together with MQTTCLIENT_PERSISTENCE_USER.
+
+	virtual void open(const std::string& clientId, const std::string& serverURI) = 0;
+		/// Opens the store for the given client.
+
+	virtual void close() = 0;
+		/// Closes the store.
+
+	virtual void put(const std::string& key, const std::string& data) = 0;
+		/// Stores the given data under the given key, replacing
+		/// any data previously stored under the key.
+
+	virtual bool get(const std::string& key, std::string& data) = 0;
+		/// Retrieves the data stored under the given key.
+		/// Returns false if no data is stored under the key.
+
+	virtual void remove(const std::string& key) = 0;
+		/// Removes the data stored under the given key.
+
+	virtual void keys(std::vector<std::string>& keys) = 0;
+		/// Returns the keys of all stored data.
+
+	virtual void clear() = 0;
+		/// Removes all stored data.
+
+	virtual bool containsKey(const std::string& key) = 0;
+		/// Returns true if data is stored under the given key.
+
+protected:
+	static std::string storeName(const std::string& clientId, const std::string& serverURI);
+		/// Returns a name for the store of the given client that
+		/// can be used as file or directory name.
+
+	static int onOpen(void** handle, const char* clientID, const char* serverURI, void* context);
+	static int onClose(void* handle);
+	static int onPut(void* handle, char* key, int bufcount, char* buffers[], int buflens[]);
+	static int onGet(void* handle, char* key, char** buffer, int* buflen);
+	static int onRemove(void* handle, char* key);
+	static int onKeys(void* handle, char*** keys, int* nkeys);
+	static int onClear(void* handle);
+	static int onContainsKey(void* handle, char* key);
+
+	Poco::Logger& logger();
+
+private:
+	PersistenceStore(const PersistenceStore&);
+	PersistenceStore& operator = (const PersistenceStore&);
+
+	MQTTClient_persistence _persistence;
+	Poco::Logger& _logger;
+};
+
+
+//
+// inlines
+//
+inline MQTTClient_persistence* PersistenceStore::persistence()
+{
+	return &_persistence;
+}
+
+
+inline Poco::Logger& PersistenceStore::logger()
+{
+	return _logger;
+}
+
+
+} } // namespace IoT::MQTT
+
+
+#endif // IoT_MQTT_PersistenceStore_INCLUDED
@@ -0,0 +1,75 @@
+//
+// SQLitePersistenceStore.h
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  SQLitePersistenceStore
+//
+// Definition of the SQLitePersistenceStore class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_MQTT_SQLitePersistenceStore_INCLUDED
+#define IoT_MQTT_SQLitePersistenceStore_INCLUDED
+
+
+#include "IoT/MQTT/PersistenceStore.h"
+#include "Poco/Data/Session.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Mutex.h"
+
+
+namespace IoT {
+namespace MQTT {
+
+
+class IoTMQTT_API SQLitePersistenceStore: public PersistenceStore
+	/// A PersistenceStore that keeps messages in a table of
+	/// a SQLite database. Multiple clients can share the same
+	/// database file.
+	///
+	/// The database is opened in write-ahead logging mode with
+	/// synchronous set to NORMAL, so inserting or removing a message
+	/// appends to the write-ahead log without synchronizing the
+	/// database file. The SQLite connector must have been registered.
+{
+public:
+	SQLitePersistenceStore(const std::string& path);
+		/// Creates the SQLitePersistenceStore, using the
+		/// given database file.
+
+	~SQLitePersistenceStore();
+		/// Destroys the SQLitePersistenceStore.
+
+	// PersistenceStore
+	void open(const std::string& clientId, const std::string& serverURI);
+	void close();
+	void put(const std::string& key, const std::string& data);
+	bool get(const std::string& key, std::string& data);
+	void remove(const std::string& key);
+	void keys(std::vector<std::string>& keys);
+	void clear();
+	bool containsKey(const std::string& key);
+
+protected:
+	Poco::Data::Session& session();
+
+private:
+	std::string _path;
+	std::string _client;
+	Poco::SharedPtr<Poco::Data::Session> _pSession;
+	Poco::FastMutex _mutex;
+};
+
+
+} } // namespace IoT::MQTT
+
+
+#endif // IoT_MQTT_SQLitePersistenceStore_INCLUDED
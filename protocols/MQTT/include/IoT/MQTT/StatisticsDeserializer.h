@@ -19,6 +19,8 @@
 
 
 #include "IoT/MQTT/MQTTClient.h"
+#include "IoT/MQTT/LatencyHistogramDeserializer.h"
+#include "IoT/MQTT/LatencyHistogramSerializer.h"
 #include "IoT/MQTT/TopicCountDeserializer.h"
 #include "IoT/MQTT/TopicCountSerializer.h"
 #include "Poco/RemotingNG/TypeDeserializer.h"
@@ -46,10 +48,19 @@ public:
 	static void deserializeImpl(Deserializer& deser, IoT::MQTT::Statistics& value)
 	{
 		remoting__staticInitBegin(REMOTING__NAMES);
-		static const std::string REMOTING__NAMES[] = {"publishedMessages","receivedMessages"};
+		static const std::string REMOTING__NAMES[] = {"bytesPublished","bytesReceived","connectionsLost","deliveryLatency","inflight","messagesPublished","messagesReceived","publishedMessages","queued","receivedMessages","reconnects"};
 		remoting__staticInitEnd(REMOTING__NAMES);
-		TypeDeserializer<std::vector < IoT::MQTT::TopicCount > >::deserialize(REMOTING__NAMES[0], true, deser, value.publishedMessages);
-		TypeDeserializer<std::vector < IoT::MQTT::TopicCount > >::deserialize(REMOTING__NAMES[1], true, deser, value.receivedMessages);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[0], false, deser, value.bytesPublished);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[1], false, deser, value.bytesReceived);
+		TypeDeserializer<int >::deserialize(REMOTING__NAMES[2], false, deser, value.connectionsLost);
+		TypeDeserializer<std::vector < IoT::MQTT::LatencyHistogram > >::deserialize(REMOTING__NAMES[3], false, deser, value.deliveryLatency);
+		TypeDeserializer<int >::deserialize(REMOTING__NAMES[4], false, deser, value.inflight);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[5], false, deser, value.messagesPublished);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[6], false, deser, value.messagesReceived);
+		TypeDeserializer<std::vector < IoT::MQTT::TopicCount > >::deserialize(REMOTING__NAMES[7], true, deser, value.publishedMessages);
+		TypeDeserializer<int >::deserialize(REMOTING__NAMES[8], false, deser, value.queued);
+		TypeDeserializer<std::vector < IoT::MQTT::TopicCount > >::deserialize(REMOTING__NAMES[9], true, deser, value.receivedMessages);
+		TypeDeserializer<int >::deserialize(REMOTING__NAMES[10], false, deser, value.reconnects);
 	}
 
 };
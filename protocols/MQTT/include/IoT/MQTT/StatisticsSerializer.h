@@ -19,6 +19,8 @@
 
 
 #include "IoT/MQTT/MQTTClient.h"
+#include "IoT/MQTT/LatencyHistogramDeserializer.h"
+#include "IoT/MQTT/LatencyHistogramSerializer.h"
 #include "IoT/MQTT/TopicCountDeserializer.h"
 #include "IoT/MQTT/TopicCountSerializer.h"
 #include "Poco/RemotingNG/TypeSerializer.h"
@@ -42,10 +44,19 @@ public:
 	static void serializeImpl(const IoT::MQTT::Statistics& value, Serializer& ser)
 	{
 		remoting__staticInitBegin(REMOTING__NAMES);
-		static const std::string REMOTING__NAMES[] = {"publishedMessages","receivedMessages",""};
+		static const std::string REMOTING__NAMES[] = {"bytesPublished","bytesReceived","connectionsLost","deliveryLatency","inflight","messagesPublished","messagesReceived","publishedMessages","queued","receivedMessages","reconnects",""};
 		remoting__staticInitEnd(REMOTING__NAMES);
-		TypeSerializer<std::vector < IoT::MQTT::TopicCount > >::serialize(REMOTING__NAMES[0], value.publishedMessages, ser);
-		TypeSerializer<std::vector < IoT::MQTT::TopicCount > >::serialize(REMOTING__NAMES[1], value.receivedMessages, ser);
+		TypeSerializer<Poco::Int64 >::serialize(REMOTING__NAMES[0], value.bytesPublished, ser);
+		TypeSerializer<Poco::Int64 >::serialize(REMOTING__NAMES[1], value.bytesReceived, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[2], value.connectionsLost, ser);
+		TypeSerializer<std::vector < IoT::MQTT::LatencyHistogram > >::serialize(REMOTING__NAMES[3], value.deliveryLatency, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[4], value.inflight, ser);
+		TypeSerializer<Poco::Int64 >::serialize(REMOTING__NAMES[5], value.messagesPublished, ser);
+		TypeSerializer<Poco::Int64 >::serialize(REMOTING__NAMES[6], value.messagesReceived, ser);
+		TypeSerializer<std::vector < IoT::MQTT::TopicCount > >::serialize(REMOTING__NAMES[7], value.publishedMessages, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[8], value.queued, ser);
+		TypeSerializer<std::vector < IoT::MQTT::TopicCount > >::serialize(REMOTING__NAMES[9], value.receivedMessages, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[10], value.reconnects, ser);
 	}
 
 };
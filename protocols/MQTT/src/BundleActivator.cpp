@@ -11,6 +11,7 @@
 
 
 #include "MQTTClientImpl.h"
+#include "MQTTAsyncClientImpl.h"
 #include "IoT/MQTT/MQTTClientServerHelper.h"
 #include "Poco/OSP/BundleActivator.h"
 #include "Poco/OSP/BundleContext.h"
@@ -54,7 +55,18 @@ public:
 		std::string serverURI = getStringConfig(baseConfig + ".serverURI", "");
 		std::string clientId = getStringConfig(baseConfig + ".clientId", "");
 		std::string persistencePath = getStringConfig(baseConfig + ".persistence.path", "");
-		MQTTClientImpl::Persistence persistence = persistencePath.empty() ? MQTTClientImpl::MQTT_PERSISTENCE_NONE : MQTTClientImpl::MQTT_PERSISTENCE_FILE;
+		std::string persistenceType = getStringConfig(baseConfig + ".persistence.type", persistencePath.empty() ? "none" : "file");
+		MQTTClientImpl::Persistence persistence;
+		if (persistenceType == "none")
+			persistence = MQTTClientImpl::MQTT_PERSISTENCE_NONE;
+		else if (persistenceType == "file")
+			persistence = MQTTClientImpl::MQTT_PERSISTENCE_FILE;
+		else if (persistenceType == "log")
+			persistence = MQTTClientImpl::MQTT_PERSISTENCE_LOG;
+		else if (persistenceType == "database")
+			persistence = MQTTClientImpl::MQTT_PERSISTENCE_DATABASE;
+		else
+			throw Poco::InvalidArgumentException("persistence.type", persistenceType);
 
 		if (!serverURI.empty())
 		{
@@ -64,6 +76,7 @@ public:
 			options.connectTimeout = getIntConfig(baseConfig + ".connectTimeout", 20);
 			options.cleanSession = getBoolConfig(baseConfig + ".cleanSession", true);
 			options.reliable = getBoolConfig(baseConfig + ".reliable", false);
+			options.maxInflight = getIntConfig(baseConfig + ".maxInflight", MQTTAsyncClientImpl::DEFAULT_MAX_INFLIGHT);
 			options.username = getStringConfig(baseConfig + ".username", "");
 			options.password = getStringConfig(baseConfig + ".password", "");
 			options.willQoS = getIntConfig(baseConfig + ".will.qos", 0);
@@ -82,7 +95,20 @@ public:
 			options.sslEnabledCipherSuites = getStringConfig(baseConfig + ".ssl.enabledCipherSuites", "");
 			options.sslEnableServerCertAuth = getBoolConfig(baseConfig + ".ssl.enableServerCertAuth", false);
 		
-			MQTTClientImpl::Ptr pMQTTClient = new MQTTClientImpl(serverURI, clientId, persistence, persistencePath, options);
+			MQTTClient::Ptr pMQTTClient;
+			MessageRouter::Ptr pRouter;
+			if (getBoolConfig(baseConfig + ".async", false))
+			{
+				MQTTAsyncClientImpl::Ptr pImpl = new MQTTAsyncClientImpl(serverURI, clientId, persistence, persistencePath, options);
+				pRouter = pImpl->router();
+				pMQTTClient = pImpl;
+			}
+			else
+			{
+				MQTTClientImpl::Ptr pImpl = new MQTTClientImpl(serverURI, clientId, persistence, persistencePath, options);
+				pRouter = pImpl->router();
+				pMQTTClient = pImpl;
+			}
 			std::string oid(Poco::format("io.macchina.mqtt.client#%z", _clients.size()));
 			ServerHelper::RemoteObjectPtr pMQTTClientRemoteObject = ServerHelper::createRemoteObject(pMQTTClient, oid);
 			Poco::OSP::Properties props;
@@ -91,9 +117,14 @@ public:
 			props.set("io.macchina.mqtt.serverURI", serverURI);	
 			props.set("io.macchina.mqtt.id", id);
 			Poco::OSP::ServiceRef::Ptr pServiceRef = _pContext->registry().registerService(oid, pMQTTClientRemoteObject, props);
-			
-			_clients.push_back(pMQTTClient);
 			_serviceRefs.push_back(pServiceRef);
+
+			props.set("io.macchina.protocol", "io.macchina.mqtt.router");
+			std::string routerName(Poco::format("io.macchina.mqtt.router#%z", _clients.size()));
+			pServiceRef = _pContext->registry().registerService(routerName, pRouter, props);
+			_serviceRefs.push_back(pServiceRef);
+
+			_clients.push_back(pMQTTClient);
 		}
 	}
 	
@@ -119,7 +150,7 @@ public:
 			pContext->registry().unregisterService(*it);
 		}
 		_serviceRefs.clear();
-		for (std::vector<MQTTClientImpl::Ptr>::iterator it = _clients.begin(); it != _clients.end(); ++it)
+		for (std::vector<MQTTClient::Ptr>::iterator it = _clients.begin(); it != _clients.end(); ++it)
 		{
 			try
 			{
@@ -167,7 +198,7 @@ protected:
 private:
 	BundleContext::Ptr _pContext;
 	PreferencesService::Ptr _pPrefs;
-	std::vector<MQTTClientImpl::Ptr> _clients;
+	std::vector<MQTTClient::Ptr> _clients;
 	std::vector<Poco::OSP::ServiceRef::Ptr> _serviceRefs;
 };
 
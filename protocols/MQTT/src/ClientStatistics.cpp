@@ -0,0 +1,339 @@
+//
+// ClientStatistics.cpp
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  ClientStatistics
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/MQTT/ClientStatistics.h"
+#if defined(POCO_OS_FAMILY_WINDOWS) && !defined(POCO_HAVE_GCC_ATOMICS)
+#include "Poco/UnWindows.h"
+#endif
+
+
+namespace IoT {
+namespace MQTT {
+
+
+namespace
+{
+	const std::string OVERFLOW_TOPIC("#");
+
+	// A pending slot holds the 16-bit token, the QoS and the
+	// send time (microseconds since the statistics were created).
+	const int TOKEN_SHIFT = 48;
+	const int QOS_SHIFT = 46;
+	const Poco::UInt64 TIME_MASK = (Poco::UInt64(1) << QOS_SHIFT) - 1;
+}
+
+
+//
+// ClientStatistics::Int64
+//
+
+
+ClientStatistics::Int64::Int64():
+	_value(0)
+{
+}
+
+
+#if defined(POCO_HAVE_GCC_ATOMICS)
+
+
+Poco::Int64 ClientStatistics::Int64::add(Poco::Int64 n)
+{
+	return __sync_add_and_fetch(&_value, n);
+}
+
+
+Poco::Int64 ClientStatistics::Int64::value() const
+{
+	return __sync_add_and_fetch(const_cast<volatile Poco::Int64*>(&_value), 0);
+}
+
+
+Poco::Int64 ClientStatistics::Int64::exchange(Poco::Int64 n)
+{
+	Poco::Int64 old = value();
+	while (!compareAndSet(old, n)) old = value();
+	return old;
+}
+
+
+bool ClientStatistics::Int64::compareAndSet(Poco::Int64 expected, Poco::Int64 n)
+{
+	return __sync_bool_compare_and_swap(&_value, expected, n);
+}
+
+
+#elif defined(POCO_OS_FAMILY_WINDOWS)
+
+
+Poco::Int64 ClientStatistics::Int64::add(Poco::Int64 n)
+{
+	return InterlockedExchangeAdd64(&_value, n) + n;
+}
+
+
+Poco::Int64 ClientStatistics::Int64::value() const
+{
+	return InterlockedCompareExchange64(const_cast<volatile Poco::Int64*>(&_value), 0, 0);
+}
+
+
+Poco::Int64 ClientStatistics::Int64::exchange(Poco::Int64 n)
+{
+	return InterlockedExchange64(&_value, n);
+}
+
+
+bool ClientStatistics::Int64::compareAndSet(Poco::Int64 expected, Poco::Int64 n)
+{
+	return InterlockedCompareExchange64(&_value, n, expected) == expected;
+}
+
+
+#else
+
+
+Poco::Int64 ClientStatistics::Int64::add(Poco::Int64 n)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _value += n;
+}
+
+
+Poco::Int64 ClientStatistics::Int64::value() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _value;
+}
+
+
+Poco::Int64 ClientStatistics::Int64::exchange(Poco::Int64 n)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	Poco::Int64 old = _value;
+	_value = n;
+	return old;
+}
+
+
+bool ClientStatistics::Int64::compareAndSet(Poco::Int64 expected, Poco::Int64 n)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	if (_value != expected) return false;
+	_value = n;
+	return true;
+}
+
+
+#endif
+
+
+//
+// ClientStatistics
+//
+
+
+// Upper bucket limits in microseconds.
+const Poco::Int64 ClientStatistics::BUCKET_LIMITS[BUCKETS - 1] =
+{
+	100, 250, 500,
+	1000, 2500, 5000,
+	10000, 25000, 50000,
+	100000, 250000, 500000,
+	1000000, 2500000, 5000000,
+	10000000
+};
+
+
+ClientStatistics::ClientStatistics(int maxTopics):
+	_maxTopics(maxTopics > 0 ? maxTopics : 1)
+{
+}
+
+
+ClientStatistics::~ClientStatistics()
+{
+}
+
+
+void ClientStatistics::messagePublished(const std::string& topic, int qos, std::size_t size, int token)
+{
+	_messagesPublished.add(1);
+	_bytesPublished.add(static_cast<Poco::Int64>(size));
+	countTopic(_published, topic);
+
+	if (qos > 0 && token != 0)
+	{
+		Poco::UInt64 slot = (Poco::UInt64(token & 0xFFFF) << TOKEN_SHIFT) | (Poco::UInt64(qos & 3) << QOS_SHIFT) | (Poco::UInt64(elapsed()) & TIME_MASK);
+		_pending[token & (PENDING_SLOTS - 1)].exchange(static_cast<Poco::Int64>(slot));
+	}
+}
+
+
+void ClientStatistics::messageDelivered(int token)
+{
+	Int64& pending = _pending[token & (PENDING_SLOTS - 1)];
+	Poco::Int64 value = pending.value();
+	Poco::UInt64 slot = static_cast<Poco::UInt64>(value);
+
+	// The acknowledgement may arrive before messagePublished() has
+	// recorded the token, or the slot may have been reused; the
+	// sample is skipped in both cases.
+	if (slot == 0 || (slot >> TOKEN_SHIFT) != Poco::UInt64(token & 0xFFFF)) return;
+	if (!pending.compareAndSet(value, 0)) return;
+
+	int qos = static_cast<int>((slot >> QOS_SHIFT) & 3);
+	if (qos < 1 || qos > 2) return;
+	Poco::Int64 latency = (Poco::UInt64(elapsed()) - (slot & TIME_MASK)) & TIME_MASK;
+
+	Histogram& histogram = _latency[qos - 1];
+	int bucket = 0;
+	while (bucket < BUCKETS - 1 && latency > BUCKET_LIMITS[bucket]) bucket++;
+	++histogram.buckets[bucket];
+	++histogram.count;
+	histogram.sum.add(latency);
+}
+
+
+void ClientStatistics::messageReceived(const std::string& topic, std::size_t size)
+{
+	_messagesReceived.add(1);
+	_bytesReceived.add(static_cast<Poco::Int64>(size));
+	countTopic(_received, topic);
+}
+
+
+void ClientStatistics::connectionLost()
+{
+	++_connectionsLost;
+}
+
+
+void ClientStatistics::reconnected()
+{
+	++_reconnects;
+}
+
+
+void ClientStatistics::reset()
+{
+	{
+		Poco::ScopedWriteRWLock lock(_topicsLock);
+
+		_received.clear();
+		_published.clear();
+	}
+	_messagesReceived.exchange(0);
+	_messagesPublished.exchange(0);
+	_bytesReceived.exchange(0);
+	_bytesPublished.exchange(0);
+	for (int i = 0; i < 2; i++)
+	{
+		for (int k = 0; k < BUCKETS; k++)
+		{
+			_latency[i].buckets[k] = 0;
+		}
+		_latency[i].count = 0;
+		_latency[i].sum.exchange(0);
+	}
+}
+
+
+void ClientStatistics::collect(Statistics& stats) const
+{
+	{
+		Poco::ScopedReadRWLock lock(_topicsLock);
+
+		collectTopics(_received, stats.receivedMessages);
+		collectTopics(_published, stats.publishedMessages);
+	}
+	stats.messagesReceived = _messagesReceived.value();
+	stats.messagesPublished = _messagesPublished.value();
+	stats.bytesReceived = _bytesReceived.value();
+	stats.bytesPublished = _bytesPublished.value();
+	stats.connectionsLost = _connectionsLost.value();
+	stats.reconnects = _reconnects.value();
+
+	stats.deliveryLatency.resize(2);
+	for (int i = 0; i < 2; i++)
+	{
+		const Histogram& histogram = _latency[i];
+		LatencyHistogram& result = stats.deliveryLatency[i];
+		result.qos = i + 1;
+		result.bucketLimits.resize(BUCKETS - 1);
+		result.bucketCounts.resize(BUCKETS);
+		int count = 0;
+		for (int k = 0; k < BUCKETS; k++)
+		{
+			if (k < BUCKETS - 1) result.bucketLimits[k] = BUCKET_LIMITS[k]/1000.0;
+			result.bucketCounts[k] = histogram.buckets[k].value();
+			count += result.bucketCounts[k];
+		}
+		// count and sum are not updated together with the buckets,
+		// so the total is taken from the buckets.
+		result.count = count;
+		Poco::Int64 sampled = histogram.count.value();
+		result.mean = sampled > 0 ? histogram.sum.value()/(1000.0*sampled) : 0;
+	}
+}
+
+
+void ClientStatistics::countTopic(TopicCounters& counters, const std::string& topic)
+{
+	{
+		Poco::ScopedReadRWLock lock(_topicsLock);
+
+		TopicCounters::iterator it = counters.find(topic);
+		if (it == counters.end() && counters.size() >= _maxTopics)
+			it = counters.find(OVERFLOW_TOPIC);
+		if (it != counters.end())
+		{
+			++*it->second;
+			return;
+		}
+	}
+
+	Poco::ScopedWriteRWLock lock(_topicsLock);
+
+	TopicCounters::iterator it = counters.find(topic);
+	if (it == counters.end())
+	{
+		const std::string& key = counters.size() < _maxTopics ? topic : OVERFLOW_TOPIC;
+		Poco::SharedPtr<Poco::AtomicCounter>& pCounter = counters[key];
+		if (!pCounter) pCounter = new Poco::AtomicCounter;
+		++*pCounter;
+	}
+	else ++*it->second;
+}
+
+
+void ClientStatistics::collectTopics(const TopicCounters& counters, std::vector<TopicCount>& counts) const
+{
+	counts.reserve(counters.size());
+	for (TopicCounters::const_iterator it = counters.begin(); it != counters.end(); ++it)
+	{
+		counts.push_back(TopicCount(it->first, it->second->value()));
+	}
+}
+
+
+Poco::Int64 ClientStatistics::elapsed() const
+{
+	return _start.elapsed();
+}
+
+
+} } // namespace IoT::MQTT
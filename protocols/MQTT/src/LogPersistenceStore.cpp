@@ -0,0 +1,575 @@
+//
+// LogPersistenceStore.cpp
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  LogPersistenceStore
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/MQTT/LogPersistenceStore.h"
+#include "Poco/Checksum.h"
+#include "Poco/File.h"
+#include "Poco/Path.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include "Poco/Format.h"
+#include <vector>
+#if defined(POCO_OS_FAMILY_WINDOWS)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+
+namespace IoT {
+namespace MQTT {
+
+
+namespace
+{
+	const std::string SEGMENT_EXT(".log");
+
+	inline void putUInt16(char* p, Poco::UInt16 value)
+	{
+		p[0] = static_cast<char>(value & 0xFF);
+		p[1] = static_cast<char>((value >> 8) & 0xFF);
+	}
+
+	inline void putUInt32(char* p, Poco::UInt32 value)
+	{
+		p[0] = static_cast<char>(value & 0xFF);
+		p[1] = static_cast<char>((value >> 8) & 0xFF);
+		p[2] = static_cast<char>((value >> 16) & 0xFF);
+		p[3] = static_cast<char>((value >> 24) & 0xFF);
+	}
+
+	inline Poco::UInt16 getUInt16(const char* p)
+	{
+		const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+		return static_cast<Poco::UInt16>(u[0] | (u[1] << 8));
+	}
+
+	inline Poco::UInt32 getUInt32(const char* p)
+	{
+		const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+		return static_cast<Poco::UInt32>(u[0]) | (static_cast<Poco::UInt32>(u[1]) << 8) | (static_cast<Poco::UInt32>(u[2]) << 16) | (static_cast<Poco::UInt32>(u[3]) << 24);
+	}
+}
+
+
+LogPersistenceStore::LogPersistenceStore(const std::string& path, Poco::UInt32 segmentSize, long syncInterval):
+	_basePath(path),
+	_segmentSize(segmentSize),
+	_syncInterval(syncInterval),
+	_current(0),
+	_pFile(0),
+	_readSegment(0),
+	_pReadFile(0),
+	_dirty(false),
+	_activity(this, &LogPersistenceStore::runActivity)
+{
+}
+
+
+LogPersistenceStore::~LogPersistenceStore()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void LogPersistenceStore::sync()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	syncImpl();
+}
+
+
+void LogPersistenceStore::open(const std::string& clientId, const std::string& serverURI)
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (_pFile) return;
+
+		Poco::Path path(_basePath);
+		path.makeDirectory();
+		path.pushDirectory(storeName(clientId, serverURI));
+		_path = path.toString();
+		Poco::File(_path).createDirectories();
+		recover();
+	}
+	if (_syncInterval > 0)
+	{
+		_activity.start();
+	}
+}
+
+
+void LogPersistenceStore::close()
+{
+	_activity.stop();
+	_syncEvent.set();
+	_activity.wait();
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_pFile)
+	{
+		syncImpl();
+		closeSegment();
+	}
+	closeReader();
+	_index.clear();
+	_segments.clear();
+}
+
+
+void LogPersistenceStore::put(const std::string& key, const std::string& data)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	append(RECORD_PUT, key, data);
+}
+
+
+bool LogPersistenceStore::get(const std::string& key, std::string& data)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Index::const_iterator it = _index.find(key);
+	if (it != _index.end())
+	{
+		std::string recordKey;
+		readRecord(it->second, recordKey, data);
+		return true;
+	}
+	return false;
+}
+
+
+void LogPersistenceStore::remove(const std::string& key)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_index.find(key) != _index.end())
+	{
+		append(RECORD_REMOVE, key, std::string());
+	}
+}
+
+
+void LogPersistenceStore::keys(std::vector<std::string>& keys)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	keys.clear();
+	keys.reserve(_index.size());
+	for (Index::const_iterator it = _index.begin(); it != _index.end(); ++it)
+	{
+		keys.push_back(it->first);
+	}
+}
+
+
+void LogPersistenceStore::clear()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (!_pFile) return;
+
+	closeSegment();
+	closeReader();
+	for (Segments::const_iterator it = _segments.begin(); it != _segments.end(); ++it)
+	{
+		Poco::File(segmentPath(it->first)).remove();
+	}
+	_segments.clear();
+	_index.clear();
+	startSegment(1);
+}
+
+
+bool LogPersistenceStore::containsKey(const std::string& key)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _index.find(key) != _index.end();
+}
+
+
+void LogPersistenceStore::runActivity()
+{
+	while (!_activity.isStopped())
+	{
+		_syncEvent.tryWait(_syncInterval);
+		try
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			if (_dirty) syncImpl();
+		}
+		catch (Poco::Exception& exc)
+		{
+			logger().error("Failed to synchronize persistence log: " + exc.displayText());
+		}
+	}
+}
+
+
+void LogPersistenceStore::recover()
+{
+	std::vector<std::string> files;
+	Poco::File(_path).list(files);
+	for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
+	{
+		Poco::Path p(*it);
+		unsigned id;
+		if (p.getExtension() == "log" && Poco::NumberParser::tryParseUnsigned(p.getBaseName(), id) && id > 0)
+		{
+			_segments[id];
+		}
+	}
+
+	for (Segments::const_iterator it = _segments.begin(); it != _segments.end(); ++it)
+	{
+		replay(it->first);
+	}
+
+	if (_segments.empty())
+	{
+		startSegment(1);
+	}
+	else
+	{
+		startSegment(_segments.rbegin()->first);
+		collect();
+	}
+
+	if (!_index.empty())
+	{
+		logger().information(Poco::format("Recovered %z persisted messages from %z segment(s) in %s.", _index.size(), _segments.size(), _path));
+	}
+}
+
+
+void LogPersistenceStore::replay(Poco::UInt32 id)
+{
+	std::string path = segmentPath(id);
+	Poco::File file(path);
+	std::vector<char> buffer(static_cast<std::size_t>(file.getSize()));
+	if (!buffer.empty())
+	{
+		std::FILE* pFile = std::fopen(path.c_str(), "rb");
+		if (!pFile) throw Poco::OpenFileException(path);
+		std::size_t n = std::fread(&buffer[0], 1, buffer.size(), pFile);
+		std::fclose(pFile);
+		if (n != buffer.size()) throw Poco::ReadFileException(path);
+	}
+
+	Segment& segment = _segments[id];
+	std::size_t offset = 0;
+	RecordType type;
+	std::string key;
+	std::string data;
+	Poco::UInt32 size;
+	while (offset < buffer.size() && decodeRecord(&buffer[offset], buffer.size() - offset, type, key, data, size))
+	{
+		Index::iterator it = _index.find(key);
+		if (it != _index.end())
+		{
+			release(it->second);
+		}
+		if (type == RECORD_PUT)
+		{
+			Location& location = _index[key];
+			location.segment = id;
+			location.offset  = static_cast<Poco::UInt32>(offset);
+			location.size    = size;
+			segment.liveRecords++;
+			segment.liveBytes += size;
+		}
+		else if (it != _index.end())
+		{
+			_index.erase(it);
+		}
+		offset += size;
+	}
+	segment.size = static_cast<Poco::UInt32>(offset);
+
+	if (offset < buffer.size())
+	{
+		logger().warning(Poco::format("Discarding %z bytes of incomplete or corrupt records at the end of %s.", buffer.size() - offset, path));
+		file.setSize(offset);
+	}
+}
+
+
+void LogPersistenceStore::append(RecordType type, const std::string& key, const std::string& data)
+{
+	if (!_pFile) throw Poco::IllegalStateException("persistence store not open");
+
+	std::string record;
+	encodeRecord(type, key, data, record);
+	Location location;
+	bool rolled = write(record, location);
+
+	Index::iterator it = _index.find(key);
+	if (it != _index.end())
+	{
+		release(it->second);
+	}
+	if (type == RECORD_PUT)
+	{
+		_index[key] = location;
+		Segment& segment = _segments[location.segment];
+		segment.liveRecords++;
+		segment.liveBytes += location.size;
+	}
+	else if (it != _index.end())
+	{
+		_index.erase(it);
+	}
+
+	if (_syncInterval == 0)
+		syncImpl();
+	else
+		_dirty = true;
+
+	if (rolled || type == RECORD_REMOVE)
+	{
+		collect();
+	}
+}
+
+
+bool LogPersistenceStore::write(const std::string& record, Location& location)
+{
+	bool rolled = false;
+	Segment* pSegment = &_segments[_current];
+	if (pSegment->size > 0 && pSegment->size + record.size() > _segmentSize)
+	{
+		syncImpl();
+		closeSegment();
+		startSegment(_current + 1);
+		pSegment = &_segments[_current];
+		rolled = true;
+	}
+
+	if (std::fwrite(record.data(), 1, record.size(), _pFile) != record.size())
+	{
+		throw Poco::WriteFileException(segmentPath(_current));
+	}
+
+	location.segment = _current;
+	location.offset  = pSegment->size;
+	location.size    = static_cast<Poco::UInt32>(record.size());
+	pSegment->size += location.size;
+	return rolled;
+}
+
+
+void LogPersistenceStore::readRecord(const Location& location, std::string& key, std::string& data)
+{
+	if (location.segment == _current)
+	{
+		std::fflush(_pFile);
+	}
+	if (!_pReadFile || _readSegment != location.segment)
+	{
+		closeReader();
+		std::string path = segmentPath(location.segment);
+		_pReadFile = std::fopen(path.c_str(), "rb");
+		if (!_pReadFile) throw Poco::OpenFileException(path);
+		_readSegment = location.segment;
+	}
+
+	std::vector<char> buffer(location.size);
+	if (std::fseek(_pReadFile, location.offset, SEEK_SET) != 0 || std::fread(&buffer[0], 1, buffer.size(), _pReadFile) != buffer.size())
+	{
+		throw Poco::ReadFileException(segmentPath(location.segment));
+	}
+
+	RecordType type;
+	Poco::UInt32 size;
+	if (!decodeRecord(&buffer[0], buffer.size(), type, key, data, size) || type != RECORD_PUT)
+	{
+		throw Poco::DataFormatException("corrupt record in persistence log", segmentPath(location.segment));
+	}
+}
+
+
+void LogPersistenceStore::closeReader()
+{
+	if (_pReadFile)
+	{
+		std::fclose(_pReadFile);
+		_pReadFile = 0;
+	}
+}
+
+
+void LogPersistenceStore::release(const Location& location)
+{
+	Segments::iterator it = _segments.find(location.segment);
+	if (it != _segments.end())
+	{
+		it->second.liveRecords--;
+		it->second.liveBytes -= location.size;
+	}
+}
+
+
+void LogPersistenceStore::collect()
+{
+	// Segments are only ever deleted from the front of the log. A segment
+	// may contain remove records for keys put in an earlier segment;
+	// deleting it while the earlier segment still exists would bring
+	// these keys back on recovery.
+	while (_segments.size() > 1)
+	{
+		Poco::UInt32 id = _segments.begin()->first;
+		const Segment& oldest = _segments.begin()->second;
+		if (id == _current) break;
+		if (oldest.liveRecords > 0)
+		{
+			if (oldest.liveBytes > oldest.size/4) break;
+
+			std::vector<std::string> liveKeys;
+			liveKeys.reserve(oldest.liveRecords);
+			for (Index::const_iterator it = _index.begin(); it != _index.end(); ++it)
+			{
+				if (it->second.segment == id) liveKeys.push_back(it->first);
+			}
+			std::string key;
+			std::string data;
+			std::string record;
+			for (std::vector<std::string>::const_iterator it = liveKeys.begin(); it != liveKeys.end(); ++it)
+			{
+				Location& location = _index[*it];
+				readRecord(location, key, data);
+				encodeRecord(RECORD_PUT, key, data, record);
+				release(location);
+				write(record, location);
+				Segment& segment = _segments[location.segment];
+				segment.liveRecords++;
+				segment.liveBytes += location.size;
+			}
+			syncImpl();
+		}
+		if (_readSegment == id) closeReader();
+		_segments.erase(id);
+		Poco::File(segmentPath(id)).remove();
+	}
+}
+
+
+void LogPersistenceStore::startSegment(Poco::UInt32 id)
+{
+	std::string path = segmentPath(id);
+	_pFile = std::fopen(path.c_str(), "ab");
+	if (!_pFile) throw Poco::OpenFileException(path);
+	std::setvbuf(_pFile, 0, _IOFBF, 64*1024);
+	_current = id;
+	_segments[id];
+}
+
+
+void LogPersistenceStore::closeSegment()
+{
+	if (_pFile)
+	{
+		std::fclose(_pFile);
+		_pFile = 0;
+	}
+}
+
+
+void LogPersistenceStore::syncImpl()
+{
+	if (_pFile)
+	{
+		if (std::fflush(_pFile) != 0) throw Poco::WriteFileException(segmentPath(_current));
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		_commit(_fileno(_pFile));
+#else
+		fsync(fileno(_pFile));
+#endif
+	}
+	_dirty = false;
+}
+
+
+std::string LogPersistenceStore::segmentPath(Poco::UInt32 id) const
+{
+	std::string path(_path);
+	Poco::NumberFormatter::append0(path, id, 8);
+	path += SEGMENT_EXT;
+	return path;
+}
+
+
+void LogPersistenceStore::encodeRecord(RecordType type, const std::string& key, const std::string& data, std::string& record)
+{
+	if (key.size() > 0xFFFF) throw Poco::InvalidArgumentException("key too long", key);
+
+	char header[RECORD_HEADER_SIZE];
+	header[0] = static_cast<char>(RECORD_MAGIC);
+	header[1] = static_cast<char>(type);
+	putUInt16(header + 2, static_cast<Poco::UInt16>(key.size()));
+	putUInt32(header + 4, static_cast<Poco::UInt32>(data.size()));
+
+	Poco::Checksum crc(Poco::Checksum::TYPE_CRC32);
+	crc.update(header, 8);
+	crc.update(key);
+	crc.update(data);
+	putUInt32(header + 8, crc.checksum());
+
+	record.clear();
+	record.reserve(RECORD_HEADER_SIZE + key.size() + data.size());
+	record.append(header, RECORD_HEADER_SIZE);
+	record.append(key);
+	record.append(data);
+}
+
+
+bool LogPersistenceStore::decodeRecord(const char* pRecord, std::size_t available, RecordType& type, std::string& key, std::string& data, Poco::UInt32& size)
+{
+	if (available < RECORD_HEADER_SIZE) return false;
+	if (static_cast<unsigned char>(pRecord[0]) != RECORD_MAGIC) return false;
+	if (pRecord[1] != RECORD_PUT && pRecord[1] != RECORD_REMOVE) return false;
+
+	Poco::UInt16 keyLength = getUInt16(pRecord + 2);
+	Poco::UInt32 dataLength = getUInt32(pRecord + 4);
+	if (dataLength > available || RECORD_HEADER_SIZE + keyLength + dataLength > available) return false;
+
+	Poco::Checksum crc(Poco::Checksum::TYPE_CRC32);
+	crc.update(pRecord, 8);
+	crc.update(pRecord + RECORD_HEADER_SIZE, keyLength + dataLength);
+	if (crc.checksum() != getUInt32(pRecord + 8)) return false;
+
+	type = static_cast<RecordType>(pRecord[1]);
+	key.assign(pRecord + RECORD_HEADER_SIZE, keyLength);
+	data.assign(pRecord + RECORD_HEADER_SIZE + keyLength, dataLength);
+	size = RECORD_HEADER_SIZE + keyLength + dataLength;
+	return true;
+}
+
+
+} } // namespace IoT::MQTT
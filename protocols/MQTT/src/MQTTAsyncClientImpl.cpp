@@ -0,0 +1,767 @@
+//
+// MQTTAsyncClientImpl.cpp
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  MQTTAsyncClientImpl
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "MQTTAsyncClientImpl.h"
+#include "IoT/MQTT/LogPersistenceStore.h"
+#include "IoT/MQTT/SQLitePersistenceStore.h"
+#include "Poco/Util/TimerTask.h"
+#include "Poco/Exception.h"
+#include "Poco/Format.h"
+
+
+extern "C" void MQTTAsync_init();
+
+
+namespace IoT {
+namespace MQTT {
+
+
+class PahoAsyncInitializer
+{
+public:
+	static void initialize()
+	{
+		if (!_initialized)
+		{
+			MQTTAsync_init();
+			_initialized = true;
+		}
+	}
+
+private:
+	static bool _initialized;
+};
+
+
+bool PahoAsyncInitializer::_initialized(false);
+
+
+class AsyncReconnectTask: public Poco::Util::TimerTask
+{
+public:
+	AsyncReconnectTask(MQTTAsyncClientImpl& client):
+		_client(client)
+	{
+	}
+
+	void run()
+	{
+		_client.reconnect();
+	}
+
+private:
+	MQTTAsyncClientImpl& _client;
+};
+
+
+//
+// MQTTAsyncClientImpl::Completion
+//
+
+
+MQTTAsyncClientImpl::Completion::Completion():
+	_completed(false),
+	_code(MQTTASYNC_SUCCESS)
+{
+	MQTTAsync_responseOptions options = MQTTAsync_responseOptions_initializer;
+	_options = options;
+	_options.onSuccess = onSuccess;
+	_options.onFailure = onFailure;
+	_options.context = this;
+}
+
+
+MQTTAsyncClientImpl::Completion::~Completion()
+{
+}
+
+
+MQTTAsync_responseOptions* MQTTAsyncClientImpl::Completion::options()
+{
+	duplicate(); // released by the callback
+	return &_options;
+}
+
+
+void MQTTAsyncClientImpl::Completion::cancel()
+{
+	release();
+}
+
+
+void MQTTAsyncClientImpl::Completion::wait(long milliseconds)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	while (!_completed)
+	{
+		if (!_condition.tryWait(_mutex, milliseconds))
+			throw Poco::TimeoutException("MQTT request did not complete in time");
+	}
+	if (_code != MQTTASYNC_SUCCESS)
+		throw Poco::IOException(_message.empty() ? errorMessage(_code) : _message, _code);
+}
+
+
+void MQTTAsyncClientImpl::Completion::complete(int code, const char* message)
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_code = code;
+		if (message) _message = message;
+		_completed = true;
+		_condition.broadcast();
+	}
+	release();
+}
+
+
+void MQTTAsyncClientImpl::Completion::onSuccess(void* context, MQTTAsync_successData* response)
+{
+	reinterpret_cast<Completion*>(context)->complete(MQTTASYNC_SUCCESS, 0);
+}
+
+
+void MQTTAsyncClientImpl::Completion::onFailure(void* context, MQTTAsync_failureData* response)
+{
+	int code = MQTTASYNC_FAILURE;
+	const char* message = 0;
+	if (response)
+	{
+		// paho reports a connect failure with code 0 if the connection could not be established
+		if (response->code != MQTTASYNC_SUCCESS) code = response->code;
+		message = response->message;
+	}
+	reinterpret_cast<Completion*>(context)->complete(code, message);
+}
+
+
+//
+// MQTTAsyncClientImpl
+//
+
+
+MQTTAsyncClientImpl::MQTTAsyncClientImpl(const std::string& serverURI, const std::string& clientId, Persistence persistence, const std::string& persistencePath, const ConnectOptions& connectOptions):
+	_clientId(clientId),
+	_serverURI(serverURI),
+	_options(connectOptions),
+	_reconnectDelay(INITIAL_RECONNECT_DELAY),
+	_pRouter(new MessageRouter),
+	_logger(Poco::Logger::get("IoT.MQTTClient")),
+	_maxInflight(connectOptions.maxInflight > 0 ? connectOptions.maxInflight : DEFAULT_MAX_INFLIGHT),
+	_inflight(0)
+{
+	PahoAsyncInitializer::initialize();
+
+	int rc;
+	switch (persistence)
+	{
+	case MQTTClientImpl::MQTT_PERSISTENCE_NONE:
+		rc = MQTTAsync_create(&_mqttClient, serverURI.c_str(), clientId.c_str(), MQTTCLIENT_PERSISTENCE_NONE, 0);
+		break;
+	case MQTTClientImpl::MQTT_PERSISTENCE_FILE:
+		_logger.debug("Persistence: " + persistencePath);
+		rc = MQTTAsync_create(&_mqttClient, serverURI.c_str(), clientId.c_str(), MQTTCLIENT_PERSISTENCE_DEFAULT, const_cast<char*>(persistencePath.c_str()));
+		break;
+	case MQTTClientImpl::MQTT_PERSISTENCE_DATABASE:
+		_logger.debug("Persistence (SQLite): " + persistencePath);
+		_pPersistenceStore = new SQLitePersistenceStore(persistencePath);
+		rc = MQTTAsync_create(&_mqttClient, serverURI.c_str(), clientId.c_str(), MQTTCLIENT_PERSISTENCE_USER, _pPersistenceStore->persistence());
+		break;
+	case MQTTClientImpl::MQTT_PERSISTENCE_LOG:
+		_logger.debug("Persistence (log): " + persistencePath);
+		_pPersistenceStore = new LogPersistenceStore(persistencePath);
+		rc = MQTTAsync_create(&_mqttClient, serverURI.c_str(), clientId.c_str(), MQTTCLIENT_PERSISTENCE_USER, _pPersistenceStore->persistence());
+		break;
+	default:
+		throw Poco::InvalidArgumentException("persistence");
+	}
+	if (rc != MQTTASYNC_SUCCESS)
+		throw Poco::SystemException("Cannot create MQTT client", errorMessage(rc), rc);
+
+	MQTTAsync_setCallbacks(_mqttClient, this, onConnectionLost, onMessageArrived, onMessageDelivered);
+}
+
+
+MQTTAsyncClientImpl::~MQTTAsyncClientImpl()
+{
+	try
+	{
+		disconnect(200);
+	}
+	catch (...)
+	{
+	}
+	_pRouter->stop();
+	_timer.cancel(true);
+	MQTTAsync_destroy(&_mqttClient);
+}
+
+
+MessageRouter::Ptr MQTTAsyncClientImpl::router() const
+{
+	return _pRouter;
+}
+
+
+const std::string& MQTTAsyncClientImpl::id() const
+{
+	return _clientId;
+}
+
+
+const std::string& MQTTAsyncClientImpl::serverURI() const
+{
+	return _serverURI;
+}
+
+
+bool MQTTAsyncClientImpl::connected() const
+{
+	return MQTTAsync_isConnected(_mqttClient) != 0;
+}
+
+
+int MQTTAsyncClientImpl::inflight() const
+{
+	Poco::FastMutex::ScopedLock lock(_inflightMutex);
+
+	return _inflight;
+}
+
+
+std::vector<TopicQoS> MQTTAsyncClientImpl::subscribedTopics() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	std::vector<TopicQoS> result;
+	for (std::map<std::string, int>::const_iterator it = _subscribedTopics.begin(); it != _subscribedTopics.end(); ++it)
+	{
+		result.push_back(TopicQoS(it->first, it->second));
+	}
+
+	return result;
+}
+
+
+Statistics MQTTAsyncClientImpl::statistics() const
+{
+	Statistics stats;
+	_statistics.collect(stats);
+	stats.inflight = inflight();
+	stats.queued = _pRouter->queued();
+
+	return stats;
+}
+
+
+void MQTTAsyncClientImpl::connect()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	if (!MQTTAsync_isConnected(_mqttClient))
+	{
+		_statistics.reset();
+		_logger.information(Poco::format("Connecting to MQTT server \"%s\"...", _serverURI));
+		connectImpl(_options);
+		_options.cleanSession = false; // Clean session only on first successful connect, not for reconnects
+	}
+}
+
+
+void MQTTAsyncClientImpl::reconnect()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	if (!MQTTAsync_isConnected(_mqttClient))
+	{
+		try
+		{
+			_logger.information(Poco::format("Reconnecting to MQTT server \"%s\"...", _serverURI));
+			connectImpl(_options);
+			_statistics.reconnected();
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.error(Poco::format("Failed to reconnect to \"%s\": %s", _serverURI, exc.displayText()));
+			if (_reconnectDelay < MAXIMUM_RECONNECT_DELAY)
+				_reconnectDelay *= 2;
+
+			Poco::Clock clock;
+			clock += 1000*_reconnectDelay;
+			_timer.schedule(new AsyncReconnectTask(*this), clock);
+		}
+	}
+}
+
+
+void MQTTAsyncClientImpl::connectImpl(const ConnectOptions& options)
+{
+	MQTTAsync_willOptions willOptions = MQTTAsync_willOptions_initializer;
+	MQTTAsync_SSLOptions sslOptions = MQTTAsync_SSLOptions_initializer;
+	MQTTAsync_connectOptions connectOptions = MQTTAsync_connectOptions_initializer;
+	connectOptions.keepAliveInterval = options.keepAliveInterval;
+	connectOptions.cleansession      = options.cleanSession;
+	connectOptions.maxInflight       = _maxInflight;
+	connectOptions.username          = options.username.empty() ? 0 : options.username.c_str();
+	connectOptions.password          = options.password.empty() ? 0 : options.password.c_str();
+	connectOptions.connectTimeout    = options.connectTimeout;
+	connectOptions.retryInterval     = options.retryInterval;
+	connectOptions.MQTTVersion       = options.mqttVersion;
+	if (options.willTopic.empty())
+		connectOptions.will          = 0;
+	else
+		connectOptions.will          = &willOptions;
+	connectOptions.ssl               = &sslOptions;
+
+	std::vector<char*> serverURIs;
+	for (std::vector<std::string>::const_iterator it = options.serverURIs.begin(); it != options.serverURIs.end(); ++it)
+	{
+		serverURIs.push_back(const_cast<char*>(it->c_str()));
+	}
+
+	connectOptions.serverURIcount = static_cast<int>(serverURIs.size());
+	if (serverURIs.size())
+	{
+		connectOptions.serverURIs = &serverURIs[0];
+	}
+	else
+	{
+		connectOptions.serverURIs = 0;
+	}
+
+	willOptions.topicName = options.willTopic.c_str();
+	willOptions.message   = options.willMessage.c_str();
+	willOptions.retained  = options.willRetained;
+	willOptions.qos       = options.willQoS;
+
+	sslOptions.trustStore           = options.sslTrustStore.c_str();
+	sslOptions.keyStore             = options.sslKeyStore.c_str();
+	sslOptions.privateKey           = options.sslPrivateKey.c_str();
+	sslOptions.privateKeyPassword   = options.sslPrivateKeyPassword.c_str();
+	sslOptions.enabledCipherSuites  = options.sslEnabledCipherSuites.c_str();
+	sslOptions.enableServerCertAuth = options.sslEnableServerCertAuth;
+
+	Completion::Ptr pCompletion = new Completion;
+	MQTTAsync_responseOptions* pResponseOptions = pCompletion->options();
+	connectOptions.onSuccess = pResponseOptions->onSuccess;
+	connectOptions.onFailure = pResponseOptions->onFailure;
+	connectOptions.context   = pResponseOptions->context;
+
+	int rc = MQTTAsync_connect(_mqttClient, &connectOptions);
+	if (rc != MQTTASYNC_SUCCESS)
+	{
+		pCompletion->cancel();
+		throw Poco::IOException(Poco::format("Cannot connect to MQTT server \"%s\"", _serverURI), errorMessage(rc), rc);
+	}
+	try
+	{
+		// paho tries each server URI in turn
+		pCompletion->wait(requestTimeout()*(serverURIs.size() + 1));
+	}
+	catch (Poco::Exception& exc)
+	{
+		throw Poco::IOException(Poco::format("Cannot connect to MQTT server \"%s\"", _serverURI), exc.message(), exc.code());
+	}
+
+	if (options.cleanSession)
+	{
+		// messages in flight from a previous session have been discarded
+		Poco::FastMutex::ScopedLock lock(_inflightMutex);
+		_inflight = 0;
+		_inflightCondition.broadcast();
+	}
+
+	_logger.information(Poco::format("Connected to MQTT server \"%s\".", _serverURI));
+	_reconnectDelay = INITIAL_RECONNECT_DELAY;
+
+	try
+	{
+		resubscribe();
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.warning(Poco::format("Failed to resubscribe to previously subscribed topics: %s", exc.displayText()));
+	}
+}
+
+
+void MQTTAsyncClientImpl::disconnect(int timeout)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	if (MQTTAsync_isConnected(_mqttClient))
+	{
+		Completion::Ptr pCompletion = new Completion;
+		MQTTAsync_responseOptions* pResponseOptions = pCompletion->options();
+		MQTTAsync_disconnectOptions disconnectOptions = MQTTAsync_disconnectOptions_initializer;
+		disconnectOptions.timeout   = timeout;
+		disconnectOptions.onSuccess = pResponseOptions->onSuccess;
+		disconnectOptions.onFailure = pResponseOptions->onFailure;
+		disconnectOptions.context   = pResponseOptions->context;
+
+		int rc = MQTTAsync_disconnect(_mqttClient, &disconnectOptions);
+		if (rc != MQTTASYNC_SUCCESS)
+		{
+			pCompletion->cancel();
+			throw Poco::IOException("Failed to disconnect from MQTT server", errorMessage(rc), rc);
+		}
+		try
+		{
+			pCompletion->wait(timeout + requestTimeout());
+		}
+		catch (Poco::Exception& exc)
+		{
+			throw Poco::IOException("Failed to disconnect from MQTT server", exc.message(), exc.code());
+		}
+		_logger.debug(Poco::format("Disconnected from server \"%s\".", _serverURI));
+		_subscribedTopics.clear();
+	}
+}
+
+
+int MQTTAsyncClientImpl::publish(const std::string& topic, const std::string& payload, int qos)
+{
+	return publishImpl(topic, payload, qos, false);
+}
+
+
+int MQTTAsyncClientImpl::publishMessage(const std::string& topic, const Message& message)
+{
+	return publishImpl(topic, message.payload, message.qos, message.retained);
+}
+
+
+int MQTTAsyncClientImpl::publishImpl(const std::string& topic, const std::string& payload, int qos, bool retained)
+{
+	if (!MQTTAsync_isConnected(_mqttClient)) connect();
+
+	if (qos > 0) acquireInflight();
+
+	MQTTAsync_responseOptions responseOptions = MQTTAsync_responseOptions_initializer;
+	int rc = MQTTAsync_send(_mqttClient, topic.c_str(), static_cast<int>(payload.size()), const_cast<char*>(payload.data()), qos, retained, &responseOptions);
+	if (rc != MQTTASYNC_SUCCESS)
+	{
+		if (qos > 0) releaseInflight();
+		throw Poco::IOException(Poco::format("Failed to publish message on topic \"%s\"", topic), errorMessage(rc), rc);
+	}
+
+	_statistics.messagePublished(topic, qos, payload.size(), responseOptions.token);
+
+	return responseOptions.token;
+}
+
+
+void MQTTAsyncClientImpl::acquireInflight()
+{
+	Poco::FastMutex::ScopedLock lock(_inflightMutex);
+
+	while (_inflight >= _maxInflight)
+	{
+		if (!_inflightCondition.tryWait(_inflightMutex, requestTimeout()))
+			throw Poco::IOException("Failed to publish message", errorMessage(MQTTASYNC_MAX_MESSAGES_INFLIGHT), MQTTASYNC_MAX_MESSAGES_INFLIGHT);
+	}
+	_inflight++;
+}
+
+
+void MQTTAsyncClientImpl::releaseInflight()
+{
+	Poco::FastMutex::ScopedLock lock(_inflightMutex);
+
+	if (_inflight > 0) _inflight--;
+	_inflightCondition.signal();
+}
+
+
+long MQTTAsyncClientImpl::requestTimeout() const
+{
+	return _options.connectTimeout > 0 ? 1000*_options.connectTimeout : 1000;
+}
+
+
+void MQTTAsyncClientImpl::subscribe(const std::string& topic, int qos)
+{
+	connect();
+
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	Completion::Ptr pCompletion = new Completion;
+	int rc = MQTTAsync_subscribe(_mqttClient, topic.c_str(), qos, pCompletion->options());
+	if (rc != MQTTASYNC_SUCCESS)
+	{
+		pCompletion->cancel();
+		throw Poco::IOException(Poco::format("Failed to subscribe to topic \"%s\"", topic), errorMessage(rc), rc);
+	}
+	try
+	{
+		pCompletion->wait(requestTimeout());
+	}
+	catch (Poco::Exception& exc)
+	{
+		throw Poco::IOException(Poco::format("Failed to subscribe to topic \"%s\"", topic), exc.message(), exc.code());
+	}
+
+	_subscribedTopics[topic] = qos;
+}
+
+
+void MQTTAsyncClientImpl::unsubscribe(const std::string& topic)
+{
+	connect();
+
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	Completion::Ptr pCompletion = new Completion;
+	int rc = MQTTAsync_unsubscribe(_mqttClient, topic.c_str(), pCompletion->options());
+	if (rc != MQTTASYNC_SUCCESS)
+	{
+		pCompletion->cancel();
+		throw Poco::IOException(Poco::format("Failed to unsubscribe from topic \"%s\"", topic), errorMessage(rc), rc);
+	}
+	try
+	{
+		pCompletion->wait(requestTimeout());
+	}
+	catch (Poco::Exception& exc)
+	{
+		throw Poco::IOException(Poco::format("Failed to unsubscribe from topic \"%s\"", topic), exc.message(), exc.code());
+	}
+
+	_subscribedTopics.erase(topic);
+}
+
+
+void MQTTAsyncClientImpl::subscribeMany(const std::vector<TopicQoS>& topicsAndQoS)
+{
+	if (topicsAndQoS.empty()) return;
+
+	connect();
+
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	std::vector<char*> ctopics;
+	std::vector<int> qoss;
+	for (std::vector<TopicQoS>::const_iterator it = topicsAndQoS.begin(); it != topicsAndQoS.end(); ++it)
+	{
+		ctopics.push_back(const_cast<char*>(it->topic.c_str()));
+		qoss.push_back(it->qos);
+	}
+	Completion::Ptr pCompletion = new Completion;
+	int rc = MQTTAsync_subscribeMany(_mqttClient, static_cast<int>(ctopics.size()), &ctopics[0], &qoss[0], pCompletion->options());
+	if (rc != MQTTASYNC_SUCCESS)
+	{
+		pCompletion->cancel();
+		throw Poco::IOException("Failed to subscribe to multiple topics", errorMessage(rc), rc);
+	}
+	try
+	{
+		pCompletion->wait(requestTimeout());
+	}
+	catch (Poco::Exception& exc)
+	{
+		throw Poco::IOException("Failed to subscribe to multiple topics", exc.message(), exc.code());
+	}
+
+	for (std::vector<TopicQoS>::const_iterator it = topicsAndQoS.begin(); it != topicsAndQoS.end(); ++it)
+	{
+		_subscribedTopics[it->topic] = it->qos;
+	}
+}
+
+
+void MQTTAsyncClientImpl::unsubscribeMany(const std::vector<std::string>& topics)
+{
+	if (topics.empty()) return;
+
+	connect();
+
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	std::vector<char*> ctopics;
+	for (std::vector<std::string>::const_iterator it = topics.begin(); it != topics.end(); ++it)
+	{
+		ctopics.push_back(const_cast<char*>(it->c_str()));
+	}
+	Completion::Ptr pCompletion = new Completion;
+	int rc = MQTTAsync_unsubscribeMany(_mqttClient, static_cast<int>(ctopics.size()), &ctopics[0], pCompletion->options());
+	if (rc != MQTTASYNC_SUCCESS)
+	{
+		pCompletion->cancel();
+		throw Poco::IOException("Failed to unsubscribe from multiple topics", errorMessage(rc), rc);
+	}
+	try
+	{
+		pCompletion->wait(requestTimeout());
+	}
+	catch (Poco::Exception& exc)
+	{
+		throw Poco::IOException("Failed to unsubscribe from multiple topics", exc.message(), exc.code());
+	}
+
+	for (std::vector<std::string>::const_iterator it = topics.begin(); it != topics.end(); ++it)
+	{
+		_subscribedTopics.erase(*it);
+	}
+}
+
+
+void MQTTAsyncClientImpl::resubscribe()
+{
+	if (_subscribedTopics.empty()) return;
+
+	std::vector<char*> ctopics;
+	std::vector<int> qoss;
+	for (std::map<std::string, int>::const_iterator it = _subscribedTopics.begin(); it != _subscribedTopics.end(); ++it)
+	{
+		ctopics.push_back(const_cast<char*>(it->first.c_str()));
+		qoss.push_back(it->second);
+	}
+	Completion::Ptr pCompletion = new Completion;
+	int rc = MQTTAsync_subscribeMany(_mqttClient, static_cast<int>(ctopics.size()), &ctopics[0], &qoss[0], pCompletion->options());
+	if (rc != MQTTASYNC_SUCCESS)
+	{
+		pCompletion->cancel();
+		throw Poco::IOException("Failed to resubscribe to topics", errorMessage(rc), rc);
+	}
+	pCompletion->wait(requestTimeout());
+}
+
+
+std::string MQTTAsyncClientImpl::errorMessage(int code)
+{
+	switch (code)
+	{
+	case MQTTASYNC_SUCCESS:
+		return "success";
+	case MQTTASYNC_FAILURE:
+		return "unspecified error";
+	case MQTTASYNC_PERSISTENCE_ERROR:
+		return "persistence error";
+	case MQTTASYNC_DISCONNECTED:
+		return "client disconnected";
+	case MQTTASYNC_MAX_MESSAGES_INFLIGHT:
+		return "maximum number of in-flight messages exceeded";
+	case MQTTASYNC_BAD_UTF8_STRING:
+		return "invalid UTF-8 string";
+	case MQTTASYNC_NULL_PARAMETER:
+		return "NULL parameter";
+	case MQTTASYNC_TOPICNAME_TRUNCATED:
+		return "topic name truncated";
+	case MQTTASYNC_BAD_STRUCTURE:
+		return "bad structure";
+	case MQTTASYNC_BAD_QOS:
+		return "invalid QoS value";
+	case MQTTASYNC_NO_MORE_MSGIDS:
+		return "no more message identifiers available";
+	case 1:
+		return "connection refused - unacceptable protocol version";
+	case 2:
+		return "connection refused - identifier rejected";
+	case 3:
+		return "connection refused - server unavailable";
+	case 4:
+		return "connection refused - bad username or password";
+	case 5:
+		return "connection refused - not authorized";
+	default:
+		return Poco::format("unknown error code %d", code);
+	}
+}
+
+
+void MQTTAsyncClientImpl::onConnectionLost(void* context, char* cause)
+{
+	MQTTAsyncClientImpl* pThis = reinterpret_cast<MQTTAsyncClientImpl*>(context);
+	ConnectionLostEvent event;
+	if (cause) event.cause = cause;
+	pThis->_statistics.connectionLost();
+	try
+	{
+		pThis->_logger.warning("Connection to MQTT server lost.");
+		pThis->connectionLost(pThis, event);
+	}
+	catch (Poco::Exception& exc)
+	{
+		pThis->_logger.error("connectionLost event delegate leaked exception: " + exc.displayText());
+	}
+
+	pThis->_timer.schedule(new AsyncReconnectTask(*pThis), Poco::Clock());
+}
+
+
+void MQTTAsyncClientImpl::onMessageDelivered(void* context, MQTTAsync_token token)
+{
+	MQTTAsyncClientImpl* pThis = reinterpret_cast<MQTTAsyncClientImpl*>(context);
+	pThis->releaseInflight();
+	pThis->_statistics.messageDelivered(token);
+
+	MessageDeliveredEvent event;
+	event.token = token;
+	try
+	{
+		pThis->messageDelivered(pThis, event);
+	}
+	catch (Poco::Exception& exc)
+	{
+		pThis->_logger.error("messageDelivered event delegate leaked exception: " + exc.displayText());
+	}
+}
+
+
+int MQTTAsyncClientImpl::onMessageArrived(void* context, char* topicName, int topicLen, MQTTAsync_message* message)
+{
+	MQTTAsyncClientImpl* pThis = reinterpret_cast<MQTTAsyncClientImpl*>(context);
+	MessageRouter::EventPtr pEvent = new MessageArrivedEvent;
+	MessageArrivedEvent& event = *pEvent;
+	if (topicName)
+	{
+		if (topicLen == 0)
+			event.topic.assign(topicName);
+		else
+			event.topic.assign(topicName, static_cast<std::string::size_type>(topicLen));
+	}
+	if (message->payload && message->payloadlen) event.message.payload.assign(static_cast<char*>(message->payload), static_cast<std::string::size_type>(message->payloadlen));
+	event.message.qos = message->qos;
+	event.message.retained = message->retained;
+	event.dup = message->dup;
+	event.handled = true;
+
+	pThis->_statistics.messageReceived(event.topic, event.message.payload.size());
+
+	try
+	{
+		event.handled = pThis->_pRouter->route(pThis, pEvent);
+		pThis->messageArrived(pThis, event);
+	}
+	catch (Poco::Exception& exc)
+	{
+		pThis->_logger.error("messageArrived event delegate leaked exception: " + exc.displayText());
+		event.handled = false;
+	}
+
+	if (event.handled)
+	{
+		MQTTAsync_freeMessage(&message);
+		MQTTAsync_free(topicName);
+	}
+
+	return event.handled;
+}
+
+
+} } // namespace IoT::MQTT
@@ -0,0 +1,189 @@
+//
+// MQTTAsyncClientImpl.h
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  MQTTAsyncClientImpl
+//
+// Definition of the MQTTAsyncClientImpl class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_MQTT_MQTTAsyncClientImpl_INCLUDED
+#define IoT_MQTT_MQTTAsyncClientImpl_INCLUDED
+
+
+#include "MQTTClientImpl.h"
+#include "Poco/Util/Timer.h"
+#include "Poco/Logger.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include <map>
+
+
+extern "C" {
+#include "MQTTAsync.h"
+}
+
+
+namespace IoT {
+namespace MQTT {
+
+
+class IoTMQTT_API MQTTAsyncClientImpl: public IoT::MQTT::MQTTClient
+	/// An implementation of MQTTClient based on the asynchronous
+	/// paho API.
+	///
+	/// In contrast to MQTTClientImpl, publish() and publishMessage()
+	/// do not wait for the message to be written to the network.
+	/// Messages are queued and sent by paho's send thread, which
+	/// writes queued messages back-to-back, without waiting for
+	/// acknowledgements from the server. Multiple threads can publish
+	/// concurrently.
+	///
+	/// The number of QoS 1 and 2 messages in flight is limited by
+	/// ConnectOptions::maxInflight. If the window is full, publish()
+	/// blocks until the server has acknowledged a message, or the
+	/// connect timeout expires. The messageDelivered event is fired
+	/// for every acknowledged message.
+{
+public:
+	typedef Poco::SharedPtr<MQTTAsyncClientImpl> Ptr;
+	typedef MQTTClientImpl::ConnectOptions ConnectOptions;
+	typedef MQTTClientImpl::Persistence Persistence;
+
+	enum
+	{
+		DEFAULT_MAX_INFLIGHT = 64
+	};
+
+	MQTTAsyncClientImpl(const std::string& serverURI, const std::string& clientId, Persistence persistence, const std::string& persistencePath, const ConnectOptions& connectOptions);
+		/// Creates the MQTTAsyncClientImpl with the given server URI, client ID, persistence,
+		/// persistence path and connect options.
+		///
+		/// For File-based and log-structured persistence, the path should specify a directory.
+		/// For SQLite-based persistence, the path should specify a SQLite database file.
+
+	~MQTTAsyncClientImpl();
+		/// Destroys the MQTTAsyncClientImpl.
+
+	int inflight() const;
+		/// Returns the number of QoS 1 and 2 messages that have been
+		/// published, but not yet acknowledged by the server.
+
+	MessageRouter::Ptr router() const;
+		/// Returns the MessageRouter that dispatches received
+		/// messages to handlers for matching topic filters.
+
+	// MQTTClient
+	const std::string& id() const;
+	const std::string& serverURI() const;
+	bool connected() const;
+	void connect();
+	void disconnect(int timeout);
+	std::vector<TopicQoS> subscribedTopics() const;
+	Statistics statistics() const;
+	int publish(const std::string& topic, const std::string& payload, int qos);
+	int publishMessage(const std::string& topic, const Message& message);
+	void subscribe(const std::string& topic, int qos);
+	void unsubscribe(const std::string& topic);
+	void subscribeMany(const std::vector<TopicQoS>& topicsAndQoS);
+	void unsubscribeMany(const std::vector<std::string>& topics);
+
+protected:
+	enum
+	{
+		INITIAL_RECONNECT_DELAY = 1000,
+		MAXIMUM_RECONNECT_DELAY = 32000
+	};
+
+	class Completion: public Poco::RefCountedObject
+		/// Used to wait for the completion of an asynchronous request.
+		///
+		/// The paho callbacks hold a reference to the Completion,
+		/// so a request may still complete after wait() has timed out.
+	{
+	public:
+		typedef Poco::AutoPtr<Completion> Ptr;
+
+		Completion();
+
+		MQTTAsync_responseOptions* options();
+			/// Returns response options for a request that
+			/// signal this Completion.
+
+		void cancel();
+			/// Must be called if the request could not be
+			/// started, as the callbacks will not be invoked.
+
+		void wait(long milliseconds);
+			/// Waits for the completion of the request and throws
+			/// a Poco::IOException if the request failed.
+			/// Throws a Poco::TimeoutException if the request does
+			/// not complete within the given time.
+
+		static void onSuccess(void* context, MQTTAsync_successData* response);
+		static void onFailure(void* context, MQTTAsync_failureData* response);
+
+	protected:
+		~Completion();
+
+		void complete(int code, const char* message);
+
+	private:
+		MQTTAsync_responseOptions _options;
+		bool _completed;
+		int _code;
+		std::string _message;
+		Poco::FastMutex _mutex;
+		Poco::Condition _condition;
+	};
+
+	void reconnect();
+	void connectImpl(const ConnectOptions& options);
+	void resubscribe();
+	int publishImpl(const std::string& topic, const std::string& payload, int qos, bool retained);
+	void acquireInflight();
+	void releaseInflight();
+	long requestTimeout() const;
+
+	static std::string errorMessage(int code);
+	static void onConnectionLost(void* context, char* cause);
+	static void onMessageDelivered(void* context, MQTTAsync_token token);
+	static int onMessageArrived(void* context, char* topicName, int topicLen, MQTTAsync_message* message);
+
+private:
+	std::string _clientId;
+	std::string _serverURI;
+	ConnectOptions _options;
+	long _reconnectDelay;
+	std::map<std::string, int> _subscribedTopics;
+	ClientStatistics _statistics;
+	PersistenceStore::Ptr _pPersistenceStore;
+	MessageRouter::Ptr _pRouter;
+	::MQTTAsync _mqttClient;
+	Poco::Util::Timer _timer;
+	Poco::Logger& _logger;
+	int _maxInflight;
+	int _inflight;
+	mutable Poco::FastMutex _inflightMutex;
+	Poco::Condition _inflightCondition;
+	mutable Poco::Mutex _mutex;
+
+	friend class AsyncReconnectTask;
+};
+
+
+} } // namespace IoT::MQTT
+
+
+#endif // IoT_MQTT_MQTTAsyncClientImpl_INCLUDED
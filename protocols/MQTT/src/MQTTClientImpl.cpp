@@ -15,6 +15,8 @@
 
 
 #include "MQTTClientImpl.h"
+#include "IoT/MQTT/LogPersistenceStore.h"
+#include "IoT/MQTT/SQLitePersistenceStore.h"
 #include "Poco/Util/TimerTask.h"
 #include "Poco/Exception.h"
 #include "Poco/Format.h"
@@ -70,6 +72,7 @@ MQTTClientImpl::MQTTClientImpl(const std::string& serverURI, const std::string&
 	_serverURI(serverURI),
 	_options(connectOptions),
 	_reconnectDelay(INITIAL_RECONNECT_DELAY),
+	_pRouter(new MessageRouter),
 	_logger(Poco::Logger::get("IoT.MQTTClient"))
 {
 	PahoInitializer::initialize();
@@ -85,7 +88,15 @@ MQTTClientImpl::MQTTClientImpl(const std::string& serverURI, const std::string&
 		rc = MQTTClient_create(&_mqttClient, serverURI.c_str(), clientId.c_str(), MQTTCLIENT_PERSISTENCE_DEFAULT, const_cast<char*>(persistencePath.c_str()));
 		break;
 	case MQTT_PERSISTENCE_DATABASE:
-		throw Poco::NotImplementedException("Database-based persistence is not yet implemented");
+		_logger.debug("Persistence (SQLite): " + persistencePath);
+		_pPersistenceStore = new SQLitePersistenceStore(persistencePath);
+		rc = MQTTClient_create(&_mqttClient, serverURI.c_str(), clientId.c_str(), MQTTCLIENT_PERSISTENCE_USER, _pPersistenceStore->persistence());
+		break;
+	case MQTT_PERSISTENCE_LOG:
+		_logger.debug("Persistence (log): " + persistencePath);
+		_pPersistenceStore = new LogPersistenceStore(persistencePath);
+		rc = MQTTClient_create(&_mqttClient, serverURI.c_str(), clientId.c_str(), MQTTCLIENT_PERSISTENCE_USER, _pPersistenceStore->persistence());
+		break;
 	default:
 		throw Poco::InvalidArgumentException("persistence");
 	}
@@ -105,10 +116,17 @@ MQTTClientImpl::~MQTTClientImpl()
 	catch (...)
 	{
 	}
+	_pRouter->stop();
 	MQTTClient_destroy(&_mqttClient);
 }
 
 
+MessageRouter::Ptr MQTTClientImpl::router() const
+{
+	return _pRouter;
+}
+
+
 const std::string& MQTTClientImpl::id() const
 {
 	return _clientId;
@@ -145,20 +163,17 @@ std::vector<TopicQoS> MQTTClientImpl::subscribedTopics() const
 
 Statistics MQTTClientImpl::statistics() const
 {
-	Poco::Mutex::ScopedLock lock(_mutex);
-
 	Statistics stats;
-	
-	for (std::map<std::string, int>::const_iterator it  = _receivedMessages.begin(); it != _receivedMessages.end(); ++it)
-	{
-		stats.receivedMessages.push_back(TopicCount(it->first, it->second));
-	}
+	_statistics.collect(stats);
 
-	for (std::map<std::string, int>::const_iterator it  = _publishedMessages.begin(); it != _publishedMessages.end(); ++it)
+	MQTTClient_deliveryToken* pTokens = 0;
+	if (MQTTClient_getPendingDeliveryTokens(_mqttClient, &pTokens) == MQTTCLIENT_SUCCESS && pTokens)
 	{
-		stats.publishedMessages.push_back(TopicCount(it->first, it->second));
+		while (pTokens[stats.inflight] != -1) stats.inflight++;
+		MQTTClient_free(pTokens);
 	}
-	
+	stats.queued = _pRouter->queued();
+
 	return stats;
 }
 
@@ -169,8 +184,7 @@ void MQTTClientImpl::connect()
 
 	if (!MQTTClient_isConnected(_mqttClient))
 	{
-		_receivedMessages.clear();
-		_publishedMessages.clear();
+		_statistics.reset();
 		_logger.information(Poco::format("Connecting to MQTT server \"%s\"...", _serverURI));
 		connectImpl(_options);
 		_options.cleanSession = false; // Clean session only on first successful connect, not for reconnects
@@ -188,6 +202,7 @@ void MQTTClientImpl::reconnect()
 		{
 			_logger.information(Poco::format("Reconnecting to MQTT server \"%s\"...", _serverURI));
 			connectImpl(_options);
+			_statistics.reconnected();
 		}
 		catch (Poco::Exception& exc)
 		{
@@ -294,7 +309,7 @@ int MQTTClientImpl::publish(const std::string& topic, const std::string& payload
 	if (rc != MQTTCLIENT_SUCCESS)
 		throw Poco::IOException(Poco::format("Failed to publish message on topic \"%s\"", topic), errorMessage(rc), rc);
 		
-	_publishedMessages[topic]++;
+	_statistics.messagePublished(topic, qos, payload.size(), token);
 
 	return token;
 }
@@ -311,7 +326,7 @@ int MQTTClientImpl::publishMessage(const std::string& topic, const Message& mess
 	if (rc != MQTTCLIENT_SUCCESS)
 		throw Poco::IOException(Poco::format("Failed to publish message on topic \"%s\"", topic), errorMessage(rc), rc);
 
-	_publishedMessages[topic]++;
+	_statistics.messagePublished(topic, message.qos, message.payload.size(), token);
 
 	return token;
 }
@@ -457,6 +472,7 @@ void MQTTClientImpl::onConnectionLost(void* context, char* cause)
 	MQTTClientImpl* pThis = reinterpret_cast<MQTTClientImpl*>(context);
 	ConnectionLostEvent event;
 	if (cause) event.cause = cause;
+	pThis->_statistics.connectionLost();
 	try
 	{
 		pThis->_logger.warning("Connection to MQTT server lost.");
@@ -474,6 +490,8 @@ void MQTTClientImpl::onConnectionLost(void* context, char* cause)
 void MQTTClientImpl::onMessageDelivered(void* context, int token)
 {
 	MQTTClientImpl* pThis = reinterpret_cast<MQTTClientImpl*>(context);
+	pThis->_statistics.messageDelivered(token);
+
 	MessageDeliveredEvent event;
 	event.token = token;
 	try
@@ -490,7 +508,8 @@ void MQTTClientImpl::onMessageDelivered(void* context, int token)
 int MQTTClientImpl::onMessageArrived(void* context, char* topicName, int topicLen, MQTTClient_message* message)
 {
 	MQTTClientImpl* pThis = reinterpret_cast<MQTTClientImpl*>(context);
-	MessageArrivedEvent event;
+	MessageRouter::EventPtr pEvent = new MessageArrivedEvent;
+	MessageArrivedEvent& event = *pEvent;
 	if (topicName)
 	{
 		if (topicLen == 0)
@@ -504,13 +523,11 @@ int MQTTClientImpl::onMessageArrived(void* context, char* topicName, int topicLe
 	event.dup = message->dup;
 	event.handled = true;
 	
-	{
-		Poco::Mutex::ScopedLock lock(pThis->_mutex);
-		pThis->_receivedMessages[event.topic]++;
-	}
+	pThis->_statistics.messageReceived(event.topic, event.message.payload.size());
 	
 	try
 	{
+		event.handled = pThis->_pRouter->route(pThis, pEvent);
 		pThis->messageArrived(pThis, event);
 	}
 	catch (Poco::Exception& exc)
@@ -21,6 +21,9 @@
 
 
 #include "IoT/MQTT/MQTTClient.h"
+#include "IoT/MQTT/MessageRouter.h"
+#include "IoT/MQTT/PersistenceStore.h"
+#include "IoT/MQTT/ClientStatistics.h"
 #include "Poco/Util/Timer.h"
 #include "Poco/Logger.h"
 #include "Poco/Mutex.h"
@@ -59,6 +62,11 @@ public:
 		bool reliable;
 			/// If set to true, only one message at a time can be "in flight".
 
+		int maxInflight;
+			/// Maximum number of QoS 1 and 2 messages "in flight" (published,
+			/// but not yet acknowledged by the server).
+			/// Only used by MQTTAsyncClientImpl.
+
 		std::string username;
 			/// Username for MQTT v3.1.
 
@@ -118,19 +126,24 @@ public:
 	enum Persistence
 	{
 		MQTT_PERSISTENCE_NONE = 0,     /// In-memory persistence.
-		MQTT_PERSISTENCE_FILE = 1,     /// File-based persistence.
-		MQTT_PERSISTENCE_DATABASE = 2  /// Database-based persistence.
+		MQTT_PERSISTENCE_FILE = 1,     /// File-based persistence (one file per message).
+		MQTT_PERSISTENCE_DATABASE = 2, /// SQLite-based persistence (see SQLitePersistenceStore).
+		MQTT_PERSISTENCE_LOG = 3       /// Log-structured persistence (see LogPersistenceStore).
 	};
 	
 	MQTTClientImpl(const std::string& serverURI, const std::string& clientId, Persistence persistence, const std::string& persistencePath, const ConnectOptions& connectOptions);
 		/// Creates the MQTTClientImpl with the given server URI, client ID, persistence, persistence path
 		/// and connect options.
 		///
-		/// For File-based persistence, the path should specify a directory.
+		/// For File-based and log-structured persistence, the path should specify a directory.
 		/// For SQLite-based persistence, the path should specify a SQLite database file.
 
 	~MQTTClientImpl();
 		/// Destroys the MQTTClientImpl.
+
+	MessageRouter::Ptr router() const;
+		/// Returns the MessageRouter that dispatches received
+		/// messages to handlers for matching topic filters.
 		
 		/// Connects to the MQTT server, if not yet connected.
 		///
@@ -173,8 +186,9 @@ private:
 	ConnectOptions _options;
 	long _reconnectDelay;
 	std::map<std::string, int> _subscribedTopics;
-	std::map<std::string, int> _receivedMessages;
-	std::map<std::string, int> _publishedMessages;
+	ClientStatistics _statistics;
+	PersistenceStore::Ptr _pPersistenceStore;
+	MessageRouter::Ptr _pRouter;
 	::MQTTClient _mqttClient;
 	Poco::Util::Timer _timer;
 	Poco::Logger& _logger;
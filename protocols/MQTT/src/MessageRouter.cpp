@@ -0,0 +1,511 @@
+//
+// MessageRouter.cpp
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  MessageRouter
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/MQTT/MessageRouter.h"
+#include "Poco/Notification.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+
+
+namespace IoT {
+namespace MQTT {
+
+
+namespace
+{
+	const std::string SINGLE_LEVEL_WILDCARD("+");
+	const std::string MULTI_LEVEL_WILDCARD("#");
+}
+
+
+class MessageRouter::RouteNotification: public Poco::Notification
+{
+public:
+	RouteNotification(Route::Ptr pRoute, const void* pSender, const EventPtr& pEvent):
+		_pRoute(pRoute),
+		_pSender(pSender),
+		_pEvent(pEvent)
+	{
+	}
+
+	void dispatch()
+	{
+		_pRoute->notify(_pSender, *_pEvent);
+	}
+
+	const std::string& filter() const
+	{
+		return _pRoute->filter();
+	}
+
+private:
+	Route::Ptr _pRoute;
+	const void* _pSender;
+	EventPtr _pEvent;
+};
+
+
+//
+// MessageRouter::Route
+//
+
+
+MessageRouter::Route::Route(int id, const std::string& filter, const Delegate& delegate, DispatchMode mode):
+	_id(id),
+	_filter(filter),
+	_pDelegate(delegate.clone()),
+	_mode(mode)
+{
+}
+
+
+MessageRouter::Route::~Route()
+{
+}
+
+
+void MessageRouter::Route::notify(const void* pSender, const MessageArrivedEvent& event)
+{
+	_pDelegate->notify(pSender, event);
+}
+
+
+void MessageRouter::Route::disable()
+{
+	_pDelegate->disable();
+}
+
+
+//
+// MessageRouter::Node
+//
+
+
+MessageRouter::Node::~Node()
+{
+	for (Children::iterator it = children.begin(); it != children.end(); ++it)
+	{
+		delete it->second;
+	}
+}
+
+
+//
+// MessageRouter::Worker
+//
+
+
+MessageRouter::Worker::Worker()
+{
+}
+
+
+MessageRouter::Worker::~Worker()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void MessageRouter::Worker::start()
+{
+	_thread.setName("MQTT MessageRouter");
+	_thread.start(*this);
+}
+
+
+void MessageRouter::Worker::stop()
+{
+	if (_thread.isRunning())
+	{
+		_queue.clear();
+		_queue.wakeUpAll();
+		_thread.join();
+	}
+}
+
+
+void MessageRouter::Worker::enqueue(Route::Ptr pRoute, const void* pSender, const EventPtr& pEvent)
+{
+	_queue.enqueueNotification(new RouteNotification(pRoute, pSender, pEvent));
+}
+
+
+int MessageRouter::Worker::queued() const
+{
+	return _queue.size();
+}
+
+
+void MessageRouter::Worker::run()
+{
+	Poco::AutoPtr<Poco::Notification> pNf(_queue.waitDequeueNotification());
+	while (pNf)
+	{
+		RouteNotification* pRouteNf = dynamic_cast<RouteNotification*>(pNf.get());
+		if (pRouteNf)
+		{
+			try
+			{
+				pRouteNf->dispatch();
+			}
+			catch (Poco::Exception& exc)
+			{
+				Poco::Logger::get("IoT.MQTTClient").error("Message handler for \"" + pRouteNf->filter() + "\" leaked exception: " + exc.displayText());
+			}
+			catch (std::exception& exc)
+			{
+				Poco::Logger::get("IoT.MQTTClient").error("Message handler for \"" + pRouteNf->filter() + "\" leaked exception: " + std::string(exc.what()));
+			}
+			catch (...)
+			{
+				Poco::Logger::get("IoT.MQTTClient").error("Message handler for \"" + pRouteNf->filter() + "\" leaked unknown exception.");
+			}
+		}
+		pNf = _queue.waitDequeueNotification();
+	}
+}
+
+
+//
+// MessageRouter
+//
+
+
+MessageRouter::MessageRouter(int workers, int queueCapacity):
+	_workerCount(workers > 0 ? workers : 1),
+	_queueCapacity(queueCapacity),
+	_nextId(1),
+	_logger(Poco::Logger::get("IoT.MQTTClient"))
+{
+}
+
+
+MessageRouter::~MessageRouter()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+int MessageRouter::addRoute(const std::string& topicFilter, const Delegate& delegate, DispatchMode mode)
+{
+	if (!isValidFilter(topicFilter)) throw Poco::InvalidArgumentException("Invalid topic filter", topicFilter);
+
+	std::vector<std::string> levels;
+	split(topicFilter, levels);
+
+	Poco::ScopedWriteRWLock lock(_lock);
+
+	if (mode == DISPATCH_ASYNC && _workers.empty())
+	{
+		for (int i = 0; i < _workerCount; i++)
+		{
+			Poco::SharedPtr<Worker> pWorker = new Worker;
+			pWorker->start();
+			_workers.push_back(pWorker);
+		}
+	}
+
+	Route::Ptr pRoute = new Route(_nextId++, topicFilter, delegate, mode);
+	Node* pNode = &_root;
+	for (std::vector<std::string>::const_iterator it = levels.begin(); it != levels.end(); ++it)
+	{
+		Node*& pChild = pNode->children[*it];
+		if (!pChild) pChild = new Node;
+		pNode = pChild;
+	}
+	pNode->routes.push_back(pRoute);
+	_routes[pRoute->id()] = pRoute;
+	return pRoute->id();
+}
+
+
+void MessageRouter::removeRoute(int id)
+{
+	Route::Ptr pRoute;
+	{
+		Poco::ScopedWriteRWLock lock(_lock);
+
+		RouteMap::iterator itRoute = _routes.find(id);
+		if (itRoute == _routes.end()) return;
+		pRoute = itRoute->second;
+		_routes.erase(itRoute);
+
+		std::vector<std::string> levels;
+		split(pRoute->filter(), levels);
+		std::vector<Node*> path;
+		path.reserve(levels.size() + 1);
+		path.push_back(&_root);
+		for (std::vector<std::string>::const_iterator it = levels.begin(); it != levels.end(); ++it)
+		{
+			path.push_back(path.back()->children[*it]);
+		}
+		std::vector<Route::Ptr>& routes = path.back()->routes;
+		routes.erase(std::remove(routes.begin(), routes.end(), pRoute), routes.end());
+
+		// prune nodes that no longer lead to any route
+		for (std::size_t i = levels.size(); i > 0; i--)
+		{
+			Node* pNode = path[i];
+			if (!pNode->routes.empty() || !pNode->children.empty()) break;
+			path[i - 1]->children.erase(levels[i - 1]);
+			delete pNode;
+		}
+	}
+	// Waits for a handler currently executing in another thread.
+	pRoute->disable();
+}
+
+
+bool MessageRouter::empty() const
+{
+	Poco::ScopedReadRWLock lock(_lock);
+
+	return _routes.empty();
+}
+
+
+bool MessageRouter::route(const void* pSender, const EventPtr& pEvent)
+{
+	std::vector<Route::Ptr> routes;
+	bool enqueued = false;
+	{
+		Poco::ScopedReadRWLock lock(_lock);
+
+		if (_routes.empty()) return true;
+
+		std::vector<std::string> levels;
+		split(pEvent->topic, levels);
+		collect(_root, levels, 0, routes);
+
+		std::vector<Route::Ptr>::iterator it = routes.begin();
+		while (it != routes.end())
+		{
+			if ((*it)->mode() == DISPATCH_ASYNC)
+			{
+				if (!_workers.empty())
+				{
+					Worker& worker = *_workers[(*it)->id() % _workers.size()];
+					if (worker.queued() < _queueCapacity)
+					{
+						worker.enqueue(*it, pSender, pEvent);
+						enqueued = true;
+					}
+					else if (++_dropped == 1)
+					{
+						_logger.warning("Message handler for \"" + (*it)->filter() + "\" cannot keep up; dropping messages.");
+					}
+				}
+				it = routes.erase(it);
+			}
+			else ++it;
+		}
+	}
+
+	// Handlers are called without holding the lock, so
+	// they can add or remove routes.
+	bool handled = true;
+	for (std::vector<Route::Ptr>::iterator it = routes.begin(); it != routes.end(); ++it)
+	{
+		try
+		{
+			(*it)->notify(pSender, *pEvent);
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.error("Message handler for \"" + (*it)->filter() + "\" leaked exception: " + exc.displayText());
+			handled = false;
+		}
+		catch (std::exception& exc)
+		{
+			_logger.error("Message handler for \"" + (*it)->filter() + "\" leaked exception: " + std::string(exc.what()));
+			handled = false;
+		}
+		catch (...)
+		{
+			_logger.error("Message handler for \"" + (*it)->filter() + "\" leaked unknown exception.");
+			handled = false;
+		}
+	}
+	// A failure is not reported if the message has already been
+	// queued for an asynchronous route, as the message would then
+	// be delivered to the asynchronous handlers a second time.
+	return handled || enqueued;
+}
+
+
+void MessageRouter::stop()
+{
+	Workers workers;
+	std::vector<Route::Ptr> routes;
+	{
+		Poco::ScopedWriteRWLock lock(_lock);
+
+		for (RouteMap::iterator it = _routes.begin(); it != _routes.end(); ++it)
+		{
+			if (it->second->mode() == DISPATCH_ASYNC) routes.push_back(it->second);
+		}
+		std::swap(workers, _workers);
+	}
+	for (std::vector<Route::Ptr>::iterator it = routes.begin(); it != routes.end(); ++it)
+	{
+		(*it)->disable();
+	}
+	for (Workers::iterator it = workers.begin(); it != workers.end(); ++it)
+	{
+		(*it)->stop();
+	}
+}
+
+
+int MessageRouter::queued() const
+{
+	Poco::ScopedReadRWLock lock(_lock);
+
+	int result = 0;
+	for (Workers::const_iterator it = _workers.begin(); it != _workers.end(); ++it)
+	{
+		result += (*it)->queued();
+	}
+	return result;
+}
+
+
+bool MessageRouter::isValidFilter(const std::string& topicFilter)
+{
+	if (topicFilter.empty()) return false;
+
+	std::string::size_type pos = 0;
+	while (pos <= topicFilter.size())
+	{
+		std::string::size_type end = topicFilter.find('/', pos);
+		if (end == std::string::npos) end = topicFilter.size();
+		std::string::size_type length = end - pos;
+		std::string::size_type wildcard = topicFilter.find_first_of("+#", pos);
+		if (wildcard < end)
+		{
+			if (length != 1) return false;
+			if (topicFilter[pos] == '#' && end != topicFilter.size()) return false;
+		}
+		pos = end + 1;
+	}
+	return true;
+}
+
+
+bool MessageRouter::matches(const std::string& topicFilter, const std::string& topic)
+{
+	std::vector<std::string> filterLevels;
+	std::vector<std::string> topicLevels;
+	split(topicFilter, filterLevels);
+	split(topic, topicLevels);
+
+	std::size_t i = 0;
+	for (; i < filterLevels.size(); i++)
+	{
+		if (filterLevels[i] == MULTI_LEVEL_WILDCARD)
+		{
+			return i > 0 || topic.empty() || topic[0] != '$';
+		}
+		if (i == topicLevels.size()) return false;
+		if (filterLevels[i] == SINGLE_LEVEL_WILDCARD)
+		{
+			if (i == 0 && !topic.empty() && topic[0] == '$') return false;
+		}
+		else if (filterLevels[i] != topicLevels[i])
+		{
+			return false;
+		}
+	}
+	return i == topicLevels.size();
+}
+
+
+const std::type_info& MessageRouter::type() const
+{
+	return typeid(MessageRouter);
+}
+
+
+bool MessageRouter::isA(const std::type_info& otherType) const
+{
+	std::string name(typeid(MessageRouter).name());
+	return name == otherType.name() || Poco::OSP::Service::isA(otherType);
+}
+
+
+void MessageRouter::collect(const Node& node, const std::vector<std::string>& levels, std::size_t level, std::vector<Route::Ptr>& routes) const
+{
+	Node::Children::const_iterator it = node.children.find(MULTI_LEVEL_WILDCARD);
+	bool wildcards = level > 0 || levels[0].empty() || levels[0][0] != '$';
+	if (it != node.children.end() && wildcards)
+	{
+		// "a/#" also matches "a"
+		routes.insert(routes.end(), it->second->routes.begin(), it->second->routes.end());
+	}
+	if (level == levels.size())
+	{
+		routes.insert(routes.end(), node.routes.begin(), node.routes.end());
+		return;
+	}
+
+	it = node.children.find(levels[level]);
+	if (it != node.children.end())
+	{
+		collect(*it->second, levels, level + 1, routes);
+	}
+	if (wildcards)
+	{
+		it = node.children.find(SINGLE_LEVEL_WILDCARD);
+		if (it != node.children.end())
+		{
+			collect(*it->second, levels, level + 1, routes);
+		}
+	}
+}
+
+
+void MessageRouter::split(const std::string& topic, std::vector<std::string>& levels)
+{
+	std::string::size_type pos = 0;
+	while (true)
+	{
+		std::string::size_type end = topic.find('/', pos);
+		if (end == std::string::npos)
+		{
+			levels.push_back(topic.substr(pos));
+			break;
+		}
+		levels.push_back(topic.substr(pos, end - pos));
+		pos = end + 1;
+	}
+}
+
+
+} } // namespace IoT::MQTT
@@ -0,0 +1,219 @@
+//
+// PersistenceStore.cpp
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  PersistenceStore
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/MQTT/PersistenceStore.h"
+#include "Poco/Exception.h"
+#include "Poco/Format.h"
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+
+namespace IoT {
+namespace MQTT {
+
+
+PersistenceStore::PersistenceStore():
+	_logger(Poco::Logger::get("IoT.MQTTClient.Persistence"))
+{
+	_persistence.context      = this;
+	_persistence.popen        = onOpen;
+	_persistence.pclose       = onClose;
+	_persistence.pput         = onPut;
+	_persistence.pget         = onGet;
+	_persistence.premove      = onRemove;
+	_persistence.pkeys        = onKeys;
+	_persistence.pclear       = onClear;
+	_persistence.pcontainskey = onContainsKey;
+}
+
+
+PersistenceStore::~PersistenceStore()
+{
+}
+
+
+std::string PersistenceStore::storeName(const std::string& clientId, const std::string& serverURI)
+{
+	std::string name(clientId);
+	name += '-';
+	name += serverURI;
+	for (std::string::iterator it = name.begin(); it != name.end(); ++it)
+	{
+		if (!std::isalnum(static_cast<unsigned char>(*it)) && *it != '-' && *it != '.' && *it != '_')
+			*it = '_';
+	}
+	return name;
+}
+
+
+int PersistenceStore::onOpen(void** handle, const char* clientID, const char* serverURI, void* context)
+{
+	PersistenceStore* pStore = reinterpret_cast<PersistenceStore*>(context);
+	try
+	{
+		pStore->open(clientID, serverURI);
+		*handle = pStore;
+		return 0;
+	}
+	catch (Poco::Exception& exc)
+	{
+		pStore->_logger.error("Failed to open persistence store: " + exc.displayText());
+		return MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+}
+
+
+int PersistenceStore::onClose(void* handle)
+{
+	PersistenceStore* pStore = reinterpret_cast<PersistenceStore*>(handle);
+	try
+	{
+		pStore->close();
+		return 0;
+	}
+	catch (Poco::Exception& exc)
+	{
+		pStore->_logger.error("Failed to close persistence store: " + exc.displayText());
+		return MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+}
+
+
+int PersistenceStore::onPut(void* handle, char* key, int bufcount, char* buffers[], int buflens[])
+{
+	PersistenceStore* pStore = reinterpret_cast<PersistenceStore*>(handle);
+	try
+	{
+		std::string data;
+		std::size_t size = 0;
+		for (int i = 0; i < bufcount; i++) size += buflens[i];
+		data.reserve(size);
+		for (int i = 0; i < bufcount; i++)
+		{
+			data.append(buffers[i], buflens[i]);
+		}
+		pStore->put(key, data);
+		return 0;
+	}
+	catch (Poco::Exception& exc)
+	{
+		pStore->_logger.error(Poco::format("Failed to persist \"%s\": %s", std::string(key), exc.displayText()));
+		return MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+}
+
+
+int PersistenceStore::onGet(void* handle, char* key, char** buffer, int* buflen)
+{
+	PersistenceStore* pStore = reinterpret_cast<PersistenceStore*>(handle);
+	try
+	{
+		std::string data;
+		if (!pStore->get(key, data)) return MQTTCLIENT_PERSISTENCE_ERROR;
+
+		// paho releases the buffer with free()
+		*buffer = static_cast<char*>(std::malloc(data.size() + 1));
+		if (!*buffer) throw Poco::OutOfMemoryException();
+		std::memcpy(*buffer, data.data(), data.size());
+		*buflen = static_cast<int>(data.size());
+		return 0;
+	}
+	catch (Poco::Exception& exc)
+	{
+		pStore->_logger.error(Poco::format("Failed to retrieve \"%s\": %s", std::string(key), exc.displayText()));
+		return MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+}
+
+
+int PersistenceStore::onRemove(void* handle, char* key)
+{
+	PersistenceStore* pStore = reinterpret_cast<PersistenceStore*>(handle);
+	try
+	{
+		pStore->remove(key);
+		return 0;
+	}
+	catch (Poco::Exception& exc)
+	{
+		pStore->_logger.error(Poco::format("Failed to remove \"%s\": %s", std::string(key), exc.displayText()));
+		return MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+}
+
+
+int PersistenceStore::onKeys(void* handle, char*** keys, int* nkeys)
+{
+	PersistenceStore* pStore = reinterpret_cast<PersistenceStore*>(handle);
+	try
+	{
+		std::vector<std::string> storeKeys;
+		pStore->keys(storeKeys);
+		*keys = 0;
+		*nkeys = static_cast<int>(storeKeys.size());
+		if (storeKeys.empty()) return 0;
+
+		// paho releases the array and the keys with free()
+		*keys = static_cast<char**>(std::malloc(storeKeys.size()*sizeof(char*)));
+		if (!*keys) throw Poco::OutOfMemoryException();
+		for (std::size_t i = 0; i < storeKeys.size(); i++)
+		{
+			(*keys)[i] = static_cast<char*>(std::malloc(storeKeys[i].size() + 1));
+			if ((*keys)[i]) std::strcpy((*keys)[i], storeKeys[i].c_str());
+		}
+		return 0;
+	}
+	catch (Poco::Exception& exc)
+	{
+		pStore->_logger.error("Failed to retrieve persisted keys: " + exc.displayText());
+		return MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+}
+
+
+int PersistenceStore::onClear(void* handle)
+{
+	PersistenceStore* pStore = reinterpret_cast<PersistenceStore*>(handle);
+	try
+	{
+		pStore->clear();
+		return 0;
+	}
+	catch (Poco::Exception& exc)
+	{
+		pStore->_logger.error("Failed to clear persistence store: " + exc.displayText());
+		return MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+}
+
+
+int PersistenceStore::onContainsKey(void* handle, char* key)
+{
+	PersistenceStore* pStore = reinterpret_cast<PersistenceStore*>(handle);
+	try
+	{
+		return pStore->containsKey(key) ? 0 : MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+	catch (Poco::Exception& exc)
+	{
+		pStore->_logger.error(Poco::format("Failed to look up \"%s\": %s", std::string(key), exc.displayText()));
+		return MQTTCLIENT_PERSISTENCE_ERROR;
+	}
+}
+
+
+} } // namespace IoT::MQTT
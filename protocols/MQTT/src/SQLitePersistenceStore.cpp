@@ -0,0 +1,179 @@
+//
+// SQLitePersistenceStore.cpp
+//
+// $Id$
+//
+// Library: IoT/MQTT
+// Package: MQTTClient
+// Module:  SQLitePersistenceStore
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/MQTT/SQLitePersistenceStore.h"
+#include "Poco/Data/Statement.h"
+#include "Poco/Data/LOB.h"
+#include "Poco/Exception.h"
+
+
+using namespace Poco::Data::Keywords;
+
+
+namespace IoT {
+namespace MQTT {
+
+
+SQLitePersistenceStore::SQLitePersistenceStore(const std::string& path):
+	_path(path)
+{
+}
+
+
+SQLitePersistenceStore::~SQLitePersistenceStore()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void SQLitePersistenceStore::open(const std::string& clientId, const std::string& serverURI)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_pSession) return;
+
+	Poco::SharedPtr<Poco::Data::Session> pSession = new Poco::Data::Session("SQLite", _path);
+	try
+	{
+		pSession->setProperty("journalMode", std::string("WAL"));
+		pSession->setProperty("synchronous", std::string("NORMAL"));
+	}
+	catch (Poco::Exception& exc)
+	{
+		logger().warning("Cannot enable write-ahead logging for MQTT persistence database: " + exc.displayText());
+	}
+
+	(*pSession) <<
+		"CREATE TABLE IF NOT EXISTS mqtt_persistence ("
+		"    client VARCHAR(256),"
+		"    msgkey VARCHAR(64),"
+		"    data BLOB,"
+		"    PRIMARY KEY (client, msgkey)"
+		")", now;
+
+	_client = storeName(clientId, serverURI);
+	_pSession = pSession;
+}
+
+
+void SQLitePersistenceStore::close()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_pSession)
+	{
+		_pSession->close();
+		_pSession = 0;
+	}
+}
+
+
+void SQLitePersistenceStore::put(const std::string& key, const std::string& data)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Poco::Data::BLOB blob(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+	session() << "INSERT OR REPLACE INTO mqtt_persistence VALUES (?, ?, ?)",
+		useRef(_client),
+		useRef(key),
+		use(blob),
+		now;
+}
+
+
+bool SQLitePersistenceStore::get(const std::string& key, std::string& data)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Poco::Data::BLOB blob;
+	Poco::Data::Statement select = (session() << "SELECT data FROM mqtt_persistence WHERE client = ? AND msgkey = ?",
+		useRef(_client),
+		useRef(key),
+		into(blob));
+	if (select.execute() == 0) return false;
+
+	data.clear();
+	if (blob.size() > 0)
+	{
+		data.assign(reinterpret_cast<const char*>(blob.rawContent()), blob.size());
+	}
+	return true;
+}
+
+
+void SQLitePersistenceStore::remove(const std::string& key)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	session() << "DELETE FROM mqtt_persistence WHERE client = ? AND msgkey = ?",
+		useRef(_client),
+		useRef(key),
+		now;
+}
+
+
+void SQLitePersistenceStore::keys(std::vector<std::string>& keys)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	keys.clear();
+	session() << "SELECT msgkey FROM mqtt_persistence WHERE client = ?",
+		useRef(_client),
+		into(keys),
+		now;
+}
+
+
+void SQLitePersistenceStore::clear()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	session() << "DELETE FROM mqtt_persistence WHERE client = ?",
+		useRef(_client),
+		now;
+}
+
+
+bool SQLitePersistenceStore::containsKey(const std::string& key)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	int count = 0;
+	session() << "SELECT COUNT(*) FROM mqtt_persistence WHERE client = ? AND msgkey = ?",
+		useRef(_client),
+		useRef(key),
+		into(count),
+		now;
+	return count > 0;
+}
+
+
+Poco::Data::Session& SQLitePersistenceStore::session()
+{
+	if (!_pSession) throw Poco::IllegalStateException("persistence store not open");
+
+	return *_pSession;
+}
+
+
+} } // namespace IoT::MQTT
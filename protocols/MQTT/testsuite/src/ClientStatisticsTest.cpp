@@ -0,0 +1,315 @@
+//
+// ClientStatisticsTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "ClientStatisticsTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+
+
+using IoT::MQTT::ClientStatistics;
+using IoT::MQTT::Statistics;
+using IoT::MQTT::TopicCount;
+using IoT::MQTT::LatencyHistogram;
+
+
+namespace
+{
+	class TestStatistics: public ClientStatistics
+		/// ClientStatistics with a manually advanced clock.
+	{
+	public:
+		TestStatistics(int maxTopics = DEFAULT_MAX_TOPICS):
+			ClientStatistics(maxTopics),
+			_now(0)
+		{
+		}
+
+		void setTime(Poco::Int64 now)
+		{
+			_now = now;
+		}
+
+		static int bucketCount()
+		{
+			return BUCKETS;
+		}
+
+		static Poco::Int64 bucketLimit(int bucket)
+		{
+			return BUCKET_LIMITS[bucket];
+		}
+
+		static int pendingSlots()
+		{
+			return PENDING_SLOTS;
+		}
+
+	protected:
+		Poco::Int64 elapsed() const
+		{
+			return _now;
+		}
+
+	private:
+		Poco::Int64 _now;
+	};
+}
+
+
+ClientStatisticsTest::ClientStatisticsTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+ClientStatisticsTest::~ClientStatisticsTest()
+{
+}
+
+
+void ClientStatisticsTest::testCounters()
+{
+	TestStatistics stats;
+	stats.messagePublished("a", 0, 10, 0);
+	stats.messagePublished("a", 1, 20, 1);
+	stats.messagePublished("b", 2, 30, 2);
+	stats.messageReceived("c", 5);
+	stats.messageReceived("c", 7);
+	stats.connectionLost();
+	stats.reconnected();
+
+	Statistics result;
+	stats.collect(result);
+	assert (result.messagesPublished == 3);
+	assert (result.bytesPublished == 60);
+	assert (result.messagesReceived == 2);
+	assert (result.bytesReceived == 12);
+	assert (result.connectionsLost == 1);
+	assert (result.reconnects == 1);
+	assert (result.publishedMessages.size() == 2);
+	assert (topicCount(result.publishedMessages, "a") == 2);
+	assert (topicCount(result.publishedMessages, "b") == 1);
+	assert (result.receivedMessages.size() == 1);
+	assert (topicCount(result.receivedMessages, "c") == 2);
+}
+
+
+void ClientStatisticsTest::testTopicLimit()
+{
+	TestStatistics stats(2);
+	stats.messageReceived("a", 1);
+	stats.messageReceived("b", 1);
+	stats.messageReceived("c", 1);
+	stats.messageReceived("d", 1);
+	stats.messageReceived("a", 1);
+
+	Statistics result;
+	stats.collect(result);
+	assert (result.messagesReceived == 5);
+	assert (result.receivedMessages.size() == 3);
+	assert (topicCount(result.receivedMessages, "a") == 2);
+	assert (topicCount(result.receivedMessages, "b") == 1);
+	assert (topicCount(result.receivedMessages, "#") == 2);
+	assert (topicCount(result.receivedMessages, "c") == -1);
+	assert (topicCount(result.receivedMessages, "d") == -1);
+
+	// published and received topics are limited separately
+	stats.messagePublished("x", 0, 1, 0);
+	stats.messagePublished("y", 0, 1, 0);
+	stats.messagePublished("z", 0, 1, 0);
+	result = Statistics();
+	stats.collect(result);
+	assert (result.publishedMessages.size() == 3);
+	assert (topicCount(result.publishedMessages, "x") == 1);
+	assert (topicCount(result.publishedMessages, "y") == 1);
+	assert (topicCount(result.publishedMessages, "#") == 1);
+	assert (result.receivedMessages.size() == 3);
+}
+
+
+void ClientStatisticsTest::testBucketLimits()
+{
+	TestStatistics stats;
+	LatencyHistogram histogram = latency(stats, 1);
+	assert (histogram.bucketLimits.size() == TestStatistics::bucketCount() - 1);
+	assert (histogram.bucketCounts.size() == TestStatistics::bucketCount());
+	for (int i = 0; i < TestStatistics::bucketCount() - 1; i++)
+	{
+		assertEqualDelta (TestStatistics::bucketLimit(i)/1000.0, histogram.bucketLimits[i], 0.000001);
+		if (i > 0) assert (TestStatistics::bucketLimit(i - 1) < TestStatistics::bucketLimit(i));
+	}
+
+	// A latency equal to a bucket limit belongs to that bucket,
+	// one microsecond more to the next one.
+	int token = 1;
+	for (int i = 0; i < TestStatistics::bucketCount() - 1; i++)
+	{
+		stats.setTime(0);
+		stats.messagePublished("t", 1, 1, token);
+		stats.setTime(TestStatistics::bucketLimit(i));
+		stats.messageDelivered(token++);
+
+		stats.setTime(0);
+		stats.messagePublished("t", 1, 1, token);
+		stats.setTime(TestStatistics::bucketLimit(i) + 1);
+		stats.messageDelivered(token++);
+	}
+	stats.setTime(0);
+	stats.messagePublished("t", 1, 1, token);
+	stats.setTime(0);
+	stats.messageDelivered(token++);
+
+	histogram = latency(stats, 1);
+	assert (histogram.count == 2*(TestStatistics::bucketCount() - 1) + 1);
+	for (int i = 0; i < TestStatistics::bucketCount() - 1; i++)
+	{
+		assert (histogram.bucketCounts[i] == 2);
+	}
+	assert (histogram.bucketCounts[TestStatistics::bucketCount() - 1] == 1);
+	assert (histogram.mean > 0);
+}
+
+
+void ClientStatisticsTest::testQoSHistograms()
+{
+	TestStatistics stats;
+	stats.setTime(1000);
+	stats.messagePublished("t", 0, 1, 1);
+	stats.messagePublished("t", 1, 1, 2);
+	stats.messagePublished("t", 2, 1, 3);
+	stats.setTime(3000);
+	stats.messageDelivered(1);
+	stats.messageDelivered(2);
+	stats.setTime(5000);
+	stats.messageDelivered(3);
+
+	LatencyHistogram qos1 = latency(stats, 1);
+	LatencyHistogram qos2 = latency(stats, 2);
+	assert (qos1.qos == 1);
+	assert (qos1.count == 1);
+	assertEqualDelta (2.0, qos1.mean, 0.000001);
+	assert (qos2.qos == 2);
+	assert (qos2.count == 1);
+	assertEqualDelta (4.0, qos2.mean, 0.000001);
+}
+
+
+void ClientStatisticsTest::testStaleSlot()
+{
+	TestStatistics stats;
+	const int token = 7;
+	const int reused = token + TestStatistics::pendingSlots();
+
+	// The slot of token is taken over by a later message with
+	// another token mapping to the same slot.
+	stats.messagePublished("t", 1, 1, token);
+	stats.messagePublished("t", 1, 1, reused);
+	stats.messageDelivered(token);
+	assert (latency(stats, 1).count == 0);
+
+	stats.messageDelivered(reused);
+	assert (latency(stats, 1).count == 1);
+
+	// A second acknowledgement finds the slot empty.
+	stats.messageDelivered(reused);
+	assert (latency(stats, 1).count == 1);
+
+	// Acknowledgement for a token that has never been recorded.
+	stats.messageDelivered(token + 1);
+	assert (latency(stats, 1).count == 1);
+}
+
+
+void ClientStatisticsTest::testEarlyAck()
+{
+	TestStatistics stats;
+
+	// The acknowledgement arrives before messagePublished()
+	// has recorded the token.
+	stats.messageDelivered(5);
+	stats.messagePublished("t", 1, 1, 5);
+	assert (latency(stats, 1).count == 0);
+
+	// A later message using the same slot replaces the
+	// orphaned entry and is measured normally.
+	stats.messagePublished("t", 1, 1, 5 + TestStatistics::pendingSlots());
+	stats.messageDelivered(5 + TestStatistics::pendingSlots());
+	assert (latency(stats, 1).count == 1);
+}
+
+
+void ClientStatisticsTest::testReset()
+{
+	TestStatistics stats;
+	stats.messagePublished("a", 1, 10, 1);
+	stats.messageDelivered(1);
+	stats.messageReceived("b", 10);
+	stats.connectionLost();
+	stats.reset();
+
+	Statistics result;
+	stats.collect(result);
+	assert (result.messagesPublished == 0);
+	assert (result.bytesPublished == 0);
+	assert (result.messagesReceived == 0);
+	assert (result.bytesReceived == 0);
+	assert (result.publishedMessages.empty());
+	assert (result.receivedMessages.empty());
+	assert (result.deliveryLatency.size() == 2);
+	assert (result.deliveryLatency[0].count == 0);
+	assert (result.deliveryLatency[0].mean == 0);
+	assert (result.connectionsLost == 1);
+}
+
+
+void ClientStatisticsTest::setUp()
+{
+}
+
+
+void ClientStatisticsTest::tearDown()
+{
+}
+
+
+int ClientStatisticsTest::topicCount(const std::vector<TopicCount>& counts, const std::string& topic)
+{
+	for (std::vector<TopicCount>::const_iterator it = counts.begin(); it != counts.end(); ++it)
+	{
+		if (it->topic == topic) return it->messageCount;
+	}
+	return -1;
+}
+
+
+LatencyHistogram ClientStatisticsTest::latency(const ClientStatistics& stats, int qos)
+{
+	Statistics result;
+	stats.collect(result);
+	return result.deliveryLatency[qos - 1];
+}
+
+
+CppUnit::Test* ClientStatisticsTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ClientStatisticsTest");
+
+	CppUnit_addTest(pSuite, ClientStatisticsTest, testCounters);
+	CppUnit_addTest(pSuite, ClientStatisticsTest, testTopicLimit);
+	CppUnit_addTest(pSuite, ClientStatisticsTest, testBucketLimits);
+	CppUnit_addTest(pSuite, ClientStatisticsTest, testQoSHistograms);
+	CppUnit_addTest(pSuite, ClientStatisticsTest, testStaleSlot);
+	CppUnit_addTest(pSuite, ClientStatisticsTest, testEarlyAck);
+	CppUnit_addTest(pSuite, ClientStatisticsTest, testReset);
+
+	return pSuite;
+}
@@ -0,0 +1,48 @@
+//
+// ClientStatisticsTest.h
+//
+// $Id$
+//
+// Definition of the ClientStatisticsTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef ClientStatisticsTest_INCLUDED
+#define ClientStatisticsTest_INCLUDED
+
+
+#include "IoT/MQTT/ClientStatistics.h"
+#include "CppUnit/TestCase.h"
+
+
+class ClientStatisticsTest: public CppUnit::TestCase
+{
+public:
+	ClientStatisticsTest(const std::string& name);
+	~ClientStatisticsTest();
+
+	void testCounters();
+	void testTopicLimit();
+	void testBucketLimits();
+	void testQoSHistograms();
+	void testStaleSlot();
+	void testEarlyAck();
+	void testReset();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+protected:
+	static int topicCount(const std::vector<IoT::MQTT::TopicCount>& counts, const std::string& topic);
+	static IoT::MQTT::LatencyHistogram latency(const IoT::MQTT::ClientStatistics& stats, int qos);
+};
+
+
+#endif // ClientStatisticsTest_INCLUDED
@@ -0,0 +1,445 @@
+//
+// LogPersistenceStoreTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "LogPersistenceStoreTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/MQTT/LogPersistenceStore.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/File.h"
+#include "Poco/Path.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <map>
+
+
+using IoT::MQTT::LogPersistenceStore;
+
+
+namespace
+{
+	const std::string CLIENT_ID("client");
+	const std::string SERVER_URI("tcp://localhost:1883");
+
+	// With a data size of 20 bytes and a key size of 2 bytes, each put
+	// record takes 34 bytes and each remove record 14 bytes, so a segment
+	// of 256 bytes holds 7 put records.
+	const Poco::UInt32 SEGMENT_SIZE = 256;
+
+	std::string key(int i)
+	{
+		return "k" + Poco::NumberFormatter::format(i);
+	}
+
+	std::string payload(char c)
+	{
+		return std::string(20, c);
+	}
+}
+
+
+LogPersistenceStoreTest::LogPersistenceStoreTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+LogPersistenceStoreTest::~LogPersistenceStoreTest()
+{
+}
+
+
+void LogPersistenceStoreTest::testPutGetRemove()
+{
+	LogPersistenceStore store(_path, LogPersistenceStore::DEFAULT_SEGMENT_SIZE, 0);
+	store.open(CLIENT_ID, SERVER_URI);
+	assert (Poco::File(storePath()).isDirectory());
+
+	store.put("s-1", "first");
+	store.put("s-2", std::string("sec\0ond", 7));
+	store.put("s-3", "");
+
+	std::string data;
+	assert (store.get("s-1", data));
+	assert (data == "first");
+	assert (store.get("s-2", data));
+	assert (data == std::string("sec\0ond", 7));
+	assert (store.get("s-3", data));
+	assert (data.empty());
+	assert (!store.get("s-4", data));
+
+	store.put("s-1", "replaced");
+	assert (store.get("s-1", data));
+	assert (data == "replaced");
+
+	std::vector<std::string> keys;
+	store.keys(keys);
+	assert (keys.size() == 3);
+	assert (keys[0] == "s-1");
+	assert (keys[1] == "s-2");
+	assert (keys[2] == "s-3");
+
+	assert (store.containsKey("s-2"));
+	store.remove("s-2");
+	assert (!store.containsKey("s-2"));
+	assert (!store.get("s-2", data));
+	store.remove("s-2");
+	store.remove("s-4");
+
+	store.keys(keys);
+	assert (keys.size() == 2);
+	assert (keys[0] == "s-1");
+	assert (keys[1] == "s-3");
+
+	store.close();
+	assert (!store.containsKey("s-1"));
+}
+
+
+void LogPersistenceStoreTest::testNotOpen()
+{
+	LogPersistenceStore store(_path);
+	try
+	{
+		store.put("s-1", "data");
+		fail("store not open - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+}
+
+
+void LogPersistenceStoreTest::testReopen()
+{
+	std::map<std::string, std::string> expected;
+	{
+		// uses the background sync; close() must write everything
+		LogPersistenceStore store(_path, SEGMENT_SIZE);
+		store.open(CLIENT_ID, SERVER_URI);
+		for (int i = 0; i < 40; i++)
+		{
+			std::string data = payload(static_cast<char>('a' + i % 26));
+			store.put(key(i % 15), data);
+			expected[key(i % 15)] = data;
+			if (i % 7 == 0)
+			{
+				store.remove(key((i + 3) % 15));
+				expected.erase(key((i + 3) % 15));
+			}
+		}
+	}
+
+	LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+	store.open(CLIENT_ID, SERVER_URI);
+	std::vector<std::string> keys;
+	store.keys(keys);
+	assert (keys.size() == expected.size());
+	for (std::map<std::string, std::string>::const_iterator it = expected.begin(); it != expected.end(); ++it)
+	{
+		std::string data;
+		assert (store.get(it->first, data));
+		assert (data == it->second);
+	}
+}
+
+
+void LogPersistenceStoreTest::testTruncatedTail()
+{
+	{
+		LogPersistenceStore store(_path, LogPersistenceStore::DEFAULT_SEGMENT_SIZE, 0);
+		store.open(CLIENT_ID, SERVER_URI);
+		store.put("k1", "one");
+		store.put("k2", "two");
+	}
+
+	// simulate a crash while writing the last record
+	Poco::File segment(segmentPath(1));
+	assert (segment.getSize() == 2*17);
+	segment.setSize(2*17 - 3);
+
+	{
+		LogPersistenceStore store(_path, LogPersistenceStore::DEFAULT_SEGMENT_SIZE, 0);
+		store.open(CLIENT_ID, SERVER_URI);
+		assert (store.containsKey("k1"));
+		assert (!store.containsKey("k2"));
+		assert (segment.getSize() == 17);
+
+		// new records must follow the last complete record
+		store.put("k3", "three");
+	}
+
+	LogPersistenceStore store(_path, LogPersistenceStore::DEFAULT_SEGMENT_SIZE, 0);
+	store.open(CLIENT_ID, SERVER_URI);
+	std::vector<std::string> keys;
+	store.keys(keys);
+	assert (keys.size() == 2);
+	std::string data;
+	assert (store.get("k1", data));
+	assert (data == "one");
+	assert (store.get("k3", data));
+	assert (data == "three");
+}
+
+
+void LogPersistenceStoreTest::testCorruptTail()
+{
+	{
+		LogPersistenceStore store(_path, LogPersistenceStore::DEFAULT_SEGMENT_SIZE, 0);
+		store.open(CLIENT_ID, SERVER_URI);
+		store.put("k1", "one");
+		store.put("k2", "two");
+	}
+
+	std::string content;
+	{
+		Poco::FileInputStream istr(segmentPath(1));
+		Poco::StreamCopier::copyToString(istr, content);
+	}
+	content[content.size() - 1] = 'X';
+	content.append("garbage");
+	{
+		Poco::FileOutputStream ostr(segmentPath(1));
+		ostr << content;
+	}
+
+	LogPersistenceStore store(_path, LogPersistenceStore::DEFAULT_SEGMENT_SIZE, 0);
+	store.open(CLIENT_ID, SERVER_URI);
+	assert (store.containsKey("k1"));
+	assert (!store.containsKey("k2"));
+	assert (Poco::File(segmentPath(1)).getSize() == 17);
+}
+
+
+void LogPersistenceStoreTest::testRollSegments()
+{
+	{
+		LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+		store.open(CLIENT_ID, SERVER_URI);
+		for (int i = 0; i < 10; i++)
+		{
+			store.put(key(i), payload(static_cast<char>('a' + i)));
+		}
+
+		std::vector<std::string> names;
+		segments(names);
+		assert (names.size() == 2);
+		assert (names[0] == "00000001.log");
+		assert (names[1] == "00000002.log");
+		assert (Poco::File(segmentPath(1)).getSize() == 7*34);
+
+		// a record larger than a segment gets a segment of its own
+		store.put("big", std::string(1000, 'x'));
+		store.put(key(10), payload('k'));
+		segments(names);
+		assert (names.size() == 4);
+		assert (Poco::File(segmentPath(3)).getSize() == 12 + 3 + 1000);
+	}
+
+	LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+	store.open(CLIENT_ID, SERVER_URI);
+	std::string data;
+	for (int i = 0; i < 11; i++)
+	{
+		assert (store.get(key(i), data));
+		assert (data == payload(static_cast<char>('a' + i)));
+	}
+	assert (store.get("big", data));
+	assert (data == std::string(1000, 'x'));
+}
+
+
+void LogPersistenceStoreTest::testCompaction()
+{
+	{
+		LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+		store.open(CLIENT_ID, SERVER_URI);
+		for (int i = 0; i < 7; i++)
+		{
+			store.put(key(i), payload('a'));
+		}
+		for (int i = 0; i < 7; i++)
+		{
+			store.put(key(i), payload('b'));
+		}
+
+		// Segment 1 no longer contains live records and is
+		// deleted as soon as the log is rolled over.
+		std::vector<std::string> names;
+		segments(names);
+		assert (names.size() == 2);
+		store.put(key(7), payload('c'));
+		segments(names);
+		assert (names.size() == 2);
+		assert (names[0] == "00000002.log");
+		assert (names[1] == "00000003.log");
+
+		// Segment 2 is kept while more than a quarter of it is live.
+		for (int i = 0; i < 5; i++)
+		{
+			store.remove(key(i));
+		}
+		segments(names);
+		assert (names.size() == 2);
+
+		// The last live record of segment 2 is copied to
+		// the current segment, and segment 2 is deleted.
+		store.remove(key(5));
+		segments(names);
+		assert (names.size() == 1);
+		assert (names[0] == "00000003.log");
+		assert (Poco::File(segmentPath(3)).getSize() == 34 + 6*14 + 34);
+
+		std::string data;
+		assert (store.get(key(6), data));
+		assert (data == payload('b'));
+	}
+
+	LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+	store.open(CLIENT_ID, SERVER_URI);
+	std::vector<std::string> keys;
+	store.keys(keys);
+	assert (keys.size() == 2);
+	std::string data;
+	assert (store.get(key(6), data));
+	assert (data == payload('b'));
+	assert (store.get(key(7), data));
+	assert (data == payload('c'));
+}
+
+
+void LogPersistenceStoreTest::testRemoveAcrossSegments()
+{
+	{
+		LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+		store.open(CLIENT_ID, SERVER_URI);
+		for (int i = 0; i < 8; i++)
+		{
+			store.put(key(i), payload('a'));
+		}
+		// the remove record for k0 is written to segment 2,
+		// the put record remains in segment 1
+		store.remove(key(0));
+		std::vector<std::string> names;
+		segments(names);
+		assert (names.size() == 2);
+	}
+
+	{
+		LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+		store.open(CLIENT_ID, SERVER_URI);
+		assert (!store.containsKey(key(0)));
+		std::vector<std::string> keys;
+		store.keys(keys);
+		assert (keys.size() == 7);
+
+		store.put(key(0), payload('b'));
+		store.remove(key(1));
+	}
+
+	LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+	store.open(CLIENT_ID, SERVER_URI);
+	std::string data;
+	assert (store.get(key(0), data));
+	assert (data == payload('b'));
+	assert (!store.containsKey(key(1)));
+	assert (store.containsKey(key(7)));
+}
+
+
+void LogPersistenceStoreTest::testClear()
+{
+	LogPersistenceStore store(_path, SEGMENT_SIZE, 0);
+	store.open(CLIENT_ID, SERVER_URI);
+	for (int i = 0; i < 10; i++)
+	{
+		store.put(key(i), payload('a'));
+	}
+	store.clear();
+
+	std::vector<std::string> keys;
+	store.keys(keys);
+	assert (keys.empty());
+	std::vector<std::string> names;
+	segments(names);
+	assert (names.size() == 1);
+	assert (Poco::File(segmentPath(1)).getSize() == 0);
+
+	store.put(key(1), payload('b'));
+	store.close();
+	store.open(CLIENT_ID, SERVER_URI);
+	store.keys(keys);
+	assert (keys.size() == 1);
+	assert (keys[0] == key(1));
+}
+
+
+std::string LogPersistenceStoreTest::storePath() const
+{
+	Poco::Path path(_path);
+	path.makeDirectory();
+	path.pushDirectory("client-tcp___localhost_1883");
+	return path.toString();
+}
+
+
+std::string LogPersistenceStoreTest::segmentPath(int id) const
+{
+	return storePath() + Poco::NumberFormatter::format0(id, 8) + ".log";
+}
+
+
+void LogPersistenceStoreTest::segments(std::vector<std::string>& names) const
+{
+	names.clear();
+	Poco::File(storePath()).list(names);
+	std::sort(names.begin(), names.end());
+}
+
+
+void LogPersistenceStoreTest::setUp()
+{
+	_path = Poco::TemporaryFile::tempName();
+}
+
+
+void LogPersistenceStoreTest::tearDown()
+{
+	try
+	{
+		Poco::File(_path).remove(true);
+	}
+	catch (...)
+	{
+	}
+}
+
+
+CppUnit::Test* LogPersistenceStoreTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("LogPersistenceStoreTest");
+
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testPutGetRemove);
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testNotOpen);
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testReopen);
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testTruncatedTail);
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testCorruptTail);
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testRollSegments);
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testCompaction);
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testRemoveAcrossSegments);
+	CppUnit_addTest(pSuite, LogPersistenceStoreTest, testClear);
+
+	return pSuite;
+}
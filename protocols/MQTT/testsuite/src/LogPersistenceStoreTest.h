@@ -0,0 +1,55 @@
+//
+// LogPersistenceStoreTest.h
+//
+// $Id$
+//
+// Definition of the LogPersistenceStoreTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef LogPersistenceStoreTest_INCLUDED
+#define LogPersistenceStoreTest_INCLUDED
+
+
+#include "IoT/MQTT/MQTT.h"
+#include "CppUnit/TestCase.h"
+#include <vector>
+
+
+class LogPersistenceStoreTest: public CppUnit::TestCase
+{
+public:
+	LogPersistenceStoreTest(const std::string& name);
+	~LogPersistenceStoreTest();
+
+	void testPutGetRemove();
+	void testNotOpen();
+	void testReopen();
+	void testTruncatedTail();
+	void testCorruptTail();
+	void testRollSegments();
+	void testCompaction();
+	void testRemoveAcrossSegments();
+	void testClear();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+protected:
+	std::string storePath() const;
+	std::string segmentPath(int id) const;
+	void segments(std::vector<std::string>& names) const;
+
+private:
+	std::string _path;
+};
+
+
+#endif // LogPersistenceStoreTest_INCLUDED
@@ -0,0 +1,30 @@
+//
+// MQTTTestSuite.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "MQTTTestSuite.h"
+#include "LogPersistenceStoreTest.h"
+#include "SQLitePersistenceStoreTest.h"
+#include "MessageRouterTest.h"
+#include "ClientStatisticsTest.h"
+
+
+CppUnit::Test* MQTTTestSuite::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("MQTTTestSuite");
+
+	pSuite->addTest(LogPersistenceStoreTest::suite());
+	pSuite->addTest(SQLitePersistenceStoreTest::suite());
+	pSuite->addTest(MessageRouterTest::suite());
+	pSuite->addTest(ClientStatisticsTest::suite());
+
+	return pSuite;
+}
@@ -0,0 +1,29 @@
+//
+// MQTTTestSuite.h
+//
+// $Id$
+//
+// Definition of the MQTTTestSuite class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef MQTTTestSuite_INCLUDED
+#define MQTTTestSuite_INCLUDED
+
+
+#include "CppUnit/TestSuite.h"
+
+
+class MQTTTestSuite
+{
+public:
+	static CppUnit::Test* suite();
+};
+
+
+#endif // MQTTTestSuite_INCLUDED
@@ -0,0 +1,385 @@
+//
+// MessageRouterTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "MessageRouterTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "Poco/Delegate.h"
+#include "Poco/Thread.h"
+#include "Poco/Exception.h"
+#include <stdexcept>
+
+
+using IoT::MQTT::MessageRouter;
+using IoT::MQTT::MessageArrivedEvent;
+
+
+MessageRouterTest::MessageRouterTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+MessageRouterTest::~MessageRouterTest()
+{
+}
+
+
+void MessageRouterTest::testValidFilter()
+{
+	assert (MessageRouter::isValidFilter("a"));
+	assert (MessageRouter::isValidFilter("a/b/c"));
+	assert (MessageRouter::isValidFilter("/"));
+	assert (MessageRouter::isValidFilter("/a/"));
+	assert (MessageRouter::isValidFilter("+"));
+	assert (MessageRouter::isValidFilter("#"));
+	assert (MessageRouter::isValidFilter("+/+"));
+	assert (MessageRouter::isValidFilter("a/+/c"));
+	assert (MessageRouter::isValidFilter("a/#"));
+	assert (MessageRouter::isValidFilter("+/#"));
+	assert (MessageRouter::isValidFilter("$SYS/#"));
+
+	assert (!MessageRouter::isValidFilter(""));
+	assert (!MessageRouter::isValidFilter("a#"));
+	assert (!MessageRouter::isValidFilter("a/b#"));
+	assert (!MessageRouter::isValidFilter("a+/b"));
+	assert (!MessageRouter::isValidFilter("a/+b"));
+	assert (!MessageRouter::isValidFilter("#/a"));
+	assert (!MessageRouter::isValidFilter("a/#/b"));
+	assert (!MessageRouter::isValidFilter("##"));
+}
+
+
+void MessageRouterTest::testMatches()
+{
+	assert (MessageRouter::matches("a/b", "a/b"));
+	assert (!MessageRouter::matches("a/b", "a/c"));
+	assert (!MessageRouter::matches("a/b", "a/b/c"));
+	assert (!MessageRouter::matches("a/b/c", "a/b"));
+	assert (MessageRouter::matches("a/+", "a/b"));
+	assert (MessageRouter::matches("a/+", "a/"));
+	assert (!MessageRouter::matches("a/+", "a"));
+	assert (!MessageRouter::matches("a/+", "a/b/c"));
+	assert (MessageRouter::matches("+/+", "/a"));
+	assert (MessageRouter::matches("a/#", "a"));
+	assert (MessageRouter::matches("a/#", "a/b/c"));
+	assert (!MessageRouter::matches("a/#", "ab"));
+	assert (MessageRouter::matches("#", "a/b"));
+	assert (!MessageRouter::matches("#", "$SYS/a"));
+	assert (!MessageRouter::matches("+/a", "$SYS/a"));
+	assert (MessageRouter::matches("$SYS/#", "$SYS/a"));
+	assert (MessageRouter::matches("a/+/#", "a/$b/c"));
+}
+
+
+void MessageRouterTest::testRoute()
+{
+	assert (routed("a/b", "a/b"));
+	assert (!routed("a/b", "a/c"));
+	assert (!routed("a/b", "a/b/c"));
+	assert (!routed("a/b/c", "a/b"));
+	assert (routed("a/+", "a/b"));
+	assert (routed("a/+", "a/"));
+	assert (!routed("a/+", "a"));
+	assert (!routed("a/+", "a/b/c"));
+	assert (routed("+/b/+", "a/b/c"));
+	assert (routed("+/+", "/a"));
+	assert (routed("#", "a/b/c"));
+	assert (routed("a/+/#", "a/b/c/d"));
+
+	// every matching route is called once
+	_topics.clear();
+	MessageRouter router;
+	router.addRoute("a/b", Poco::delegate(this, &MessageRouterTest::onMessage));
+	router.addRoute("a/+", Poco::delegate(this, &MessageRouterTest::onMessage));
+	router.addRoute("a/#", Poco::delegate(this, &MessageRouterTest::onMessage));
+	router.addRoute("+/c", Poco::delegate(this, &MessageRouterTest::onMessage));
+	route(router, "a/b");
+	assert (_topics.size() == 3);
+	_topics.clear();
+	route(router, "x/c");
+	assert (_topics.size() == 1);
+	assert (_topics[0] == "x/c");
+	_topics.clear();
+	route(router, "x/y");
+	assert (_topics.empty());
+
+	try
+	{
+		router.addRoute("a/#/b", Poco::delegate(this, &MessageRouterTest::onMessage));
+		fail("invalid filter - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void MessageRouterTest::testDollarTopics()
+{
+	assert (!routed("#", "$SYS/broker/load"));
+	assert (!routed("+/broker/load", "$SYS/broker/load"));
+	assert (!routed("+/#", "$SYS/broker/load"));
+	assert (routed("$SYS/#", "$SYS/broker/load"));
+	assert (routed("$SYS/+/load", "$SYS/broker/load"));
+	assert (routed("$SYS/broker/load", "$SYS/broker/load"));
+
+	// only the first level is special
+	assert (routed("a/+", "a/$b"));
+	assert (routed("a/#", "a/$b"));
+}
+
+
+void MessageRouterTest::testMultiLevelParent()
+{
+	assert (routed("a/#", "a"));
+	assert (routed("a/#", "a/"));
+	assert (routed("a/#", "a/b"));
+	assert (routed("a/#", "a/b/c"));
+	assert (!routed("a/#", "ab"));
+	assert (!routed("a/#", "b"));
+	assert (routed("a/b/#", "a/b"));
+	assert (!routed("a/b/#", "a"));
+	assert (routed("+/#", "a"));
+}
+
+
+void MessageRouterTest::testRemoveRoute()
+{
+	MessageRouter router;
+	assert (router.empty());
+	int id1 = router.addRoute("a/b/c", Poco::delegate(this, &MessageRouterTest::onMessage));
+	int id2 = router.addRoute("a/b", Poco::delegate(this, &MessageRouterTest::onMessage));
+	assert (id1 != id2);
+	assert (!router.empty());
+
+	route(router, "a/b/c");
+	assert (_topics.size() == 1);
+
+	router.removeRoute(id1);
+	route(router, "a/b/c");
+	assert (_topics.size() == 1);
+	route(router, "a/b");
+	assert (_topics.size() == 2);
+
+	router.removeRoute(id2);
+	router.removeRoute(id2);
+	assert (router.empty());
+	route(router, "a/b");
+	assert (_topics.size() == 2);
+
+	// pruned nodes are recreated
+	router.addRoute("a/b/c", Poco::delegate(this, &MessageRouterTest::onMessage));
+	route(router, "a/b/c");
+	assert (_topics.size() == 3);
+}
+
+
+void MessageRouterTest::testHandlerException()
+{
+	MessageRouter router;
+	router.addRoute("a", Poco::delegate(this, &MessageRouterTest::onThrow));
+	router.addRoute("#", Poco::delegate(this, &MessageRouterTest::onMessage));
+
+	MessageRouter::EventPtr pEvent = new MessageArrivedEvent;
+	pEvent->topic = "a";
+	assert (!router.route(this, pEvent));
+	assert (_topics.size() == 1);
+
+	pEvent->topic = "b";
+	assert (router.route(this, pEvent));
+	assert (_topics.size() == 2);
+
+	router.addRoute("c", Poco::delegate(this, &MessageRouterTest::onThrowStd));
+	router.addRoute("d", Poco::delegate(this, &MessageRouterTest::onThrowUnknown));
+	pEvent->topic = "c";
+	assert (!router.route(this, pEvent));
+	assert (_topics.size() == 3);
+	pEvent->topic = "d";
+	assert (!router.route(this, pEvent));
+	assert (_topics.size() == 4);
+}
+
+
+void MessageRouterTest::testHandlerExceptionAsync()
+{
+	MessageRouter router;
+	router.addRoute("a", Poco::delegate(this, &MessageRouterTest::onThrow));
+	router.addRoute("a", Poco::delegate(this, &MessageRouterTest::onBlock), MessageRouter::DISPATCH_ASYNC);
+	router.addRoute("b", Poco::delegate(this, &MessageRouterTest::onThrowStd), MessageRouter::DISPATCH_ASYNC);
+	router.addRoute("b", Poco::delegate(this, &MessageRouterTest::onThrowUnknown), MessageRouter::DISPATCH_ASYNC);
+	router.addRoute("b", Poco::delegate(this, &MessageRouterTest::onBlock), MessageRouter::DISPATCH_ASYNC);
+	_release.set();
+
+	// The message has been queued for the asynchronous route, so the
+	// failure of the synchronous handler must not cause redelivery.
+	MessageRouter::EventPtr pEvent = new MessageArrivedEvent;
+	pEvent->topic = "a";
+	assert (router.route(this, pEvent));
+
+	// Asynchronous handlers throwing any kind of exception
+	// must not stop the worker threads.
+	pEvent = new MessageArrivedEvent;
+	pEvent->topic = "b";
+	assert (router.route(this, pEvent));
+
+	int n = 0;
+	while (_asyncCount.value() < 2 && n++ < 100)
+	{
+		Poco::Thread::sleep(20);
+	}
+	assert (_asyncCount.value() == 2);
+}
+
+
+void MessageRouterTest::testAsync()
+{
+	MessageRouter router;
+	router.addRoute("a/#", Poco::delegate(this, &MessageRouterTest::onBlock), MessageRouter::DISPATCH_ASYNC);
+	_release.set();
+	for (int i = 0; i < 10; i++)
+	{
+		route(router, "a/b");
+	}
+	int n = 0;
+	while (_asyncCount.value() < 10 && n++ < 100)
+	{
+		Poco::Thread::sleep(20);
+	}
+	assert (_asyncCount.value() == 10);
+	assert (router.droppedMessages() == 0);
+	assert (router.queued() == 0);
+}
+
+
+void MessageRouterTest::testAsyncOverflow()
+{
+	MessageRouter router(1, 2);
+	router.addRoute("a", Poco::delegate(this, &MessageRouterTest::onBlock), MessageRouter::DISPATCH_ASYNC);
+	router.addRoute("a", Poco::delegate(this, &MessageRouterTest::onMessage));
+
+	// the worker thread takes the first message and blocks in the handler
+	route(router, "a");
+	_started.wait();
+	assert (router.queued() == 0);
+
+	// two more messages fit into the queue, the rest is dropped
+	for (int i = 0; i < 5; i++)
+	{
+		route(router, "a");
+	}
+	assert (router.queued() == 2);
+	assert (router.droppedMessages() == 3);
+
+	// synchronous routes are not affected
+	assert (_topics.size() == 6);
+
+	_release.set();
+	int n = 0;
+	while (_asyncCount.value() < 3 && n++ < 100)
+	{
+		Poco::Thread::sleep(20);
+	}
+	Poco::Thread::sleep(50);
+	assert (_asyncCount.value() == 3);
+	assert (router.queued() == 0);
+	assert (router.droppedMessages() == 3);
+
+	router.stop();
+}
+
+
+bool MessageRouterTest::routed(const std::string& filter, const std::string& topic)
+{
+	_topics.clear();
+	MessageRouter router;
+	router.addRoute(filter, Poco::delegate(this, &MessageRouterTest::onMessage));
+	route(router, topic);
+	return !_topics.empty();
+}
+
+
+void MessageRouterTest::route(MessageRouter& router, const std::string& topic)
+{
+	MessageRouter::EventPtr pEvent = new MessageArrivedEvent;
+	pEvent->topic = topic;
+	pEvent->dup = false;
+	pEvent->handled = true;
+	router.route(this, pEvent);
+}
+
+
+void MessageRouterTest::onMessage(const void* pSender, const MessageArrivedEvent& event)
+{
+	_topics.push_back(event.topic);
+}
+
+
+void MessageRouterTest::onThrow(const void* pSender, const MessageArrivedEvent& event)
+{
+	throw Poco::IllegalStateException("handler failed");
+}
+
+
+void MessageRouterTest::onThrowStd(const void* pSender, const MessageArrivedEvent& event)
+{
+	throw std::runtime_error("handler failed");
+}
+
+
+void MessageRouterTest::onThrowUnknown(const void* pSender, const MessageArrivedEvent& event)
+{
+	throw 42;
+}
+
+
+void MessageRouterTest::onBlock(const void* pSender, const MessageArrivedEvent& event)
+{
+	_started.set();
+	_release.wait();
+	_release.set();
+	++_asyncCount;
+}
+
+
+void MessageRouterTest::setUp()
+{
+	_topics.clear();
+	_asyncCount = 0;
+	_started.reset();
+	_release.reset();
+}
+
+
+void MessageRouterTest::tearDown()
+{
+	_release.set();
+}
+
+
+CppUnit::Test* MessageRouterTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("MessageRouterTest");
+
+	CppUnit_addTest(pSuite, MessageRouterTest, testValidFilter);
+	CppUnit_addTest(pSuite, MessageRouterTest, testMatches);
+	CppUnit_addTest(pSuite, MessageRouterTest, testRoute);
+	CppUnit_addTest(pSuite, MessageRouterTest, testDollarTopics);
+	CppUnit_addTest(pSuite, MessageRouterTest, testMultiLevelParent);
+	CppUnit_addTest(pSuite, MessageRouterTest, testRemoveRoute);
+	CppUnit_addTest(pSuite, MessageRouterTest, testHandlerException);
+	CppUnit_addTest(pSuite, MessageRouterTest, testHandlerExceptionAsync);
+	CppUnit_addTest(pSuite, MessageRouterTest, testAsync);
+	CppUnit_addTest(pSuite, MessageRouterTest, testAsyncOverflow);
+
+	return pSuite;
+}
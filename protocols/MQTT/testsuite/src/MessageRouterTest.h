@@ -0,0 +1,66 @@
+//
+// MessageRouterTest.h
+//
+// $Id$
+//
+// Definition of the MessageRouterTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef MessageRouterTest_INCLUDED
+#define MessageRouterTest_INCLUDED
+
+
+#include "IoT/MQTT/MessageRouter.h"
+#include "CppUnit/TestCase.h"
+#include "Poco/Event.h"
+#include "Poco/AtomicCounter.h"
+#include <vector>
+
+
+class MessageRouterTest: public CppUnit::TestCase
+{
+public:
+	MessageRouterTest(const std::string& name);
+	~MessageRouterTest();
+
+	void testValidFilter();
+	void testMatches();
+	void testRoute();
+	void testDollarTopics();
+	void testMultiLevelParent();
+	void testRemoveRoute();
+	void testHandlerException();
+	void testHandlerExceptionAsync();
+	void testAsync();
+	void testAsyncOverflow();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+protected:
+	bool routed(const std::string& filter, const std::string& topic);
+	void route(IoT::MQTT::MessageRouter& router, const std::string& topic);
+
+	void onMessage(const void* pSender, const IoT::MQTT::MessageArrivedEvent& event);
+	void onThrow(const void* pSender, const IoT::MQTT::MessageArrivedEvent& event);
+	void onThrowStd(const void* pSender, const IoT::MQTT::MessageArrivedEvent& event);
+	void onThrowUnknown(const void* pSender, const IoT::MQTT::MessageArrivedEvent& event);
+	void onBlock(const void* pSender, const IoT::MQTT::MessageArrivedEvent& event);
+
+private:
+	std::vector<std::string> _topics;
+	Poco::AtomicCounter _asyncCount;
+	Poco::Event _started;
+	Poco::Event _release;
+};
+
+
+#endif // MessageRouterTest_INCLUDED
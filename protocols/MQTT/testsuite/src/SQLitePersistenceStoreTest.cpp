@@ -0,0 +1,177 @@
+//
+// SQLitePersistenceStoreTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "SQLitePersistenceStoreTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/MQTT/SQLitePersistenceStore.h"
+#include "Poco/Data/SQLite/Connector.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/File.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+
+
+using IoT::MQTT::SQLitePersistenceStore;
+
+
+namespace
+{
+	const std::string SERVER_URI("tcp://localhost:1883");
+}
+
+
+SQLitePersistenceStoreTest::SQLitePersistenceStoreTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+SQLitePersistenceStoreTest::~SQLitePersistenceStoreTest()
+{
+}
+
+
+void SQLitePersistenceStoreTest::testPutGetRemove()
+{
+	SQLitePersistenceStore store(_path);
+	store.open("client", SERVER_URI);
+
+	store.put("s-1", "first");
+	store.put("s-2", std::string("sec\0ond", 7));
+	store.put("s-3", "");
+
+	std::string data;
+	assert (store.get("s-1", data));
+	assert (data == "first");
+	assert (store.get("s-2", data));
+	assert (data == std::string("sec\0ond", 7));
+	assert (store.get("s-3", data));
+	assert (data.empty());
+	assert (!store.get("s-4", data));
+
+	store.put("s-1", "replaced");
+	assert (store.get("s-1", data));
+	assert (data == "replaced");
+
+	std::vector<std::string> keys;
+	store.keys(keys);
+	std::sort(keys.begin(), keys.end());
+	assert (keys.size() == 3);
+	assert (keys[0] == "s-1");
+	assert (keys[1] == "s-2");
+	assert (keys[2] == "s-3");
+
+	assert (store.containsKey("s-2"));
+	store.remove("s-2");
+	assert (!store.containsKey("s-2"));
+	assert (!store.get("s-2", data));
+	store.remove("s-4");
+
+	store.clear();
+	store.keys(keys);
+	assert (keys.empty());
+}
+
+
+void SQLitePersistenceStoreTest::testNotOpen()
+{
+	SQLitePersistenceStore store(_path);
+	try
+	{
+		store.put("s-1", "data");
+		fail("store not open - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+}
+
+
+void SQLitePersistenceStoreTest::testReopen()
+{
+	{
+		SQLitePersistenceStore store(_path);
+		store.open("client", SERVER_URI);
+		store.put("s-1", "first");
+		store.put("s-2", "second");
+		store.remove("s-1");
+	}
+
+	SQLitePersistenceStore store(_path);
+	store.open("client", SERVER_URI);
+	std::vector<std::string> keys;
+	store.keys(keys);
+	assert (keys.size() == 1);
+	std::string data;
+	assert (store.get("s-2", data));
+	assert (data == "second");
+}
+
+
+void SQLitePersistenceStoreTest::testSharedDatabase()
+{
+	SQLitePersistenceStore store1(_path);
+	store1.open("client1", SERVER_URI);
+	SQLitePersistenceStore store2(_path);
+	store2.open("client2", SERVER_URI);
+
+	store1.put("s-1", "one");
+	store2.put("s-1", "two");
+	store2.put("s-2", "two");
+
+	std::string data;
+	assert (store1.get("s-1", data));
+	assert (data == "one");
+	assert (store2.get("s-1", data));
+	assert (data == "two");
+	assert (!store1.containsKey("s-2"));
+
+	store2.clear();
+	assert (!store2.containsKey("s-1"));
+	assert (store1.containsKey("s-1"));
+}
+
+
+void SQLitePersistenceStoreTest::setUp()
+{
+	Poco::Data::SQLite::Connector::registerConnector();
+	_path = Poco::TemporaryFile::tempName();
+}
+
+
+void SQLitePersistenceStoreTest::tearDown()
+{
+	Poco::Data::SQLite::Connector::unregisterConnector();
+	try
+	{
+		Poco::File(_path).remove();
+		Poco::File(_path + "-wal").remove();
+		Poco::File(_path + "-shm").remove();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+CppUnit::Test* SQLitePersistenceStoreTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SQLitePersistenceStoreTest");
+
+	CppUnit_addTest(pSuite, SQLitePersistenceStoreTest, testPutGetRemove);
+	CppUnit_addTest(pSuite, SQLitePersistenceStoreTest, testNotOpen);
+	CppUnit_addTest(pSuite, SQLitePersistenceStoreTest, testReopen);
+	CppUnit_addTest(pSuite, SQLitePersistenceStoreTest, testSharedDatabase);
+
+	return pSuite;
+}
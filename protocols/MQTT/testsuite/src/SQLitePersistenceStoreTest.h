@@ -0,0 +1,44 @@
+//
+// SQLitePersistenceStoreTest.h
+//
+// $Id$
+//
+// Definition of the SQLitePersistenceStoreTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef SQLitePersistenceStoreTest_INCLUDED
+#define SQLitePersistenceStoreTest_INCLUDED
+
+
+#include "IoT/MQTT/MQTT.h"
+#include "CppUnit/TestCase.h"
+
+
+class SQLitePersistenceStoreTest: public CppUnit::TestCase
+{
+public:
+	SQLitePersistenceStoreTest(const std::string& name);
+	~SQLitePersistenceStoreTest();
+
+	void testPutGetRemove();
+	void testNotOpen();
+	void testReopen();
+	void testSharedDatabase();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	std::string _path;
+};
+
+
+#endif // SQLitePersistenceStoreTest_INCLUDED
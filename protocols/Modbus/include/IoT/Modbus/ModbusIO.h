@@ -0,0 +1,86 @@
+//
+// ModbusIO.h
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: Polling
+// Module:  ModbusIO
+//
+// Definition of the ModbusIO class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Modbus_ModbusIO_INCLUDED
+#define IoT_Modbus_ModbusIO_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "IoT/Modbus/PollingPlan.h"
+#include "IoT/Modbus/ModbusMaster.h"
+#include "IoT/Devices/IO.h"
+#include "IoT/Devices/DeviceImpl.h"
+#include "Poco/SharedPtr.h"
+
+
+namespace IoT {
+namespace Modbus {
+
+
+class IoTModbus_API ModbusIO: public IoT::Devices::DeviceImpl<IoT::Devices::IO, ModbusIO>
+	/// An IO publishing the state of a coil or discrete input
+	/// polled by a ModbusPoller.
+	///
+	/// The stateChanged event is fired only if the polled state
+	/// differs from the previous one.
+	///
+	/// Coils are outputs and can be set with set(), which sends
+	/// a Write Single Coil request. Discrete inputs are read-only.
+{
+public:
+	ModbusIO(const PointDefinition& point, Poco::SharedPtr<ModbusMaster> pMaster);
+		/// Creates a ModbusIO for the given point.
+
+	~ModbusIO();
+		/// Destroys the ModbusIO.
+
+	void update(bool state);
+		/// Updates the state, and fires the stateChanged event
+		/// if the state has changed. Called by the ModbusPoller.
+
+	// IO
+	bool state() const;
+	void set(bool state);
+
+	static const std::string NAME;
+	static const std::string SYMBOLIC_NAME;
+
+protected:
+	Poco::Any getDisplayState(const std::string&) const;
+	Poco::Any getDirection(const std::string&) const;
+	Poco::Any getDeviceIdentifier(const std::string&) const;
+	Poco::Any getName(const std::string&) const;
+	Poco::Any getSymbolicName(const std::string&) const;
+
+private:
+	Poco::SharedPtr<ModbusMaster> _pMaster;
+	Poco::UInt8 _slaveAddress;
+	Poco::UInt16 _address;
+	bool _output;
+	bool _state;
+	bool _valid;
+	Poco::Any _deviceIdentifier;
+	Poco::Any _symbolicName;
+	Poco::Any _name;
+};
+
+
+} } // namespace IoT::Modbus
+
+
+#endif // IoT_Modbus_ModbusIO_INCLUDED
@@ -32,8 +32,13 @@ namespace Modbus {
 
 template <class Port>
 class IoTModbus_API ModbusMasterImpl: public ModbusMaster, public Poco::Runnable
-	/// An implementation of the ModbusMaster interface for the Modbus RTU
-	/// protocol over a serial line.
+	/// An implementation of the ModbusMaster interface, using
+	/// a RTUPort (Modbus RTU over a serial line) or a TCPPort
+	/// (Modbus TCP).
+	///
+	/// The synchronous request methods pass the request to the port's
+	/// sendReceive() method. Whether multiple synchronous requests
+	/// can be outstanding at the same time is up to the port.
 {
 public:
 	ModbusMasterImpl(Poco::SharedPtr<Port> pPort, Poco::Timespan timeout = Poco::Timespan(2, 0)):
@@ -153,132 +158,72 @@ public:
 
 	std::vector<bool> readCoils(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfCoils)
 	{
-		Poco::FastMutex::ScopedLock lock(_mutex);
-
 		disableEvents();
 		ReadCoilsRequest request;
 		request.slaveOrUnitAddress = slaveAddress;
 		request.startingAddress = startingAddress;
 		request.nOfCoils = nOfCoils;
-		_pPort->sendFrame(request);
-		if (_pPort->poll(_timeout))
-		{
-			Poco::UInt8 fc = _pPort->receiveFrame(_timeout);
-			if ((fc & 0x80) == MODBUS_EXCEPTION_MASK)
-			{
-				ModbusExceptionMessage message;
-				_pPort->decodeFrame(message);
-				throw ModbusException(message.functionCode, message.exceptionCode);
-			}
-			else if ((fc & 0x7F) == request.functionCode)
-			{
-				ReadCoilsResponse response;
-				_pPort->decodeFrame(response);
-				return response.coilStatus;
-			}
-			else throw Poco::ProtocolException("incomplete or invalid frame received");
-		}
-		else throw Poco::TimeoutException();
+		ReadCoilsResponse response;
+		_pPort->sendReceive(request, response, _timeout);
+		return response.coilStatus;
 	}
 
 	std::vector<bool> readDiscreteInputs(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfInputs)
 	{
-		Poco::FastMutex::ScopedLock lock(_mutex);
-
 		disableEvents();
 		ReadDiscreteInputsRequest request;
 		request.slaveOrUnitAddress = slaveAddress;
 		request.startingAddress = startingAddress;
 		request.nOfInputs = nOfInputs;
-		_pPort->sendFrame(request);
-		if (_pPort->poll(_timeout))
-		{
-			Poco::UInt8 fc = _pPort->receiveFrame(_timeout);
-			if ((fc & 0x80) == MODBUS_EXCEPTION_MASK)
-			{
-				ModbusExceptionMessage message;
-				_pPort->decodeFrame(message);
-				throw ModbusException(message.functionCode, message.exceptionCode);
-			}
-			else if ((fc & 0x7F) == request.functionCode)
-			{
-				ReadDiscreteInputsResponse response;
-				_pPort->decodeFrame(response);
-				return response.inputStatus;
-			}
-			else throw Poco::ProtocolException("incomplete or invalid frame received");
-		}
-		else throw Poco::TimeoutException();
+		ReadDiscreteInputsResponse response;
+		_pPort->sendReceive(request, response, _timeout);
+		return response.inputStatus;
 	}
 
 	std::vector<Poco::UInt16> readHoldingRegisters(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfRegisters)
 	{
-		Poco::FastMutex::ScopedLock lock(_mutex);
-
 		disableEvents();
 		ReadHoldingRegistersRequest request;
 		request.slaveOrUnitAddress = slaveAddress;
 		request.startingAddress = startingAddress;
 		request.nOfRegisters = nOfRegisters;
-		_pPort->sendFrame(request);
-		if (_pPort->poll(_timeout))
-		{
-			Poco::UInt8 fc = _pPort->receiveFrame(_timeout);
-			if ((fc & 0x80) == MODBUS_EXCEPTION_MASK)
-			{
-				ModbusExceptionMessage message;
-				_pPort->decodeFrame(message);
-				throw ModbusException(message.functionCode, message.exceptionCode);
-			}
-			else if ((fc & 0x7F) == request.functionCode)
-			{
-				ReadHoldingRegistersResponse response;
-				_pPort->decodeFrame(response);
-				return response.registerValues;
-			}
-			else throw Poco::ProtocolException("incomplete or invalid frame received");
-		}
-		else throw Poco::TimeoutException();
+		ReadHoldingRegistersResponse response;
+		_pPort->sendReceive(request, response, _timeout);
+		return response.registerValues;
 	}
 
 	std::vector<Poco::UInt16> readInputRegisters(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfRegisters)
 	{
-		Poco::FastMutex::ScopedLock lock(_mutex);
-
 		disableEvents();
 		ReadInputRegistersRequest request;
 		request.slaveOrUnitAddress = slaveAddress;
 		request.startingAddress = startingAddress;
 		request.nOfRegisters = nOfRegisters;
-		_pPort->sendFrame(request);
-		if (_pPort->poll(_timeout))
-		{
-			Poco::UInt8 fc = _pPort->receiveFrame(_timeout);
-			if ((fc & 0x80) == MODBUS_EXCEPTION_MASK)
-			{
-				ModbusExceptionMessage message;
-				_pPort->decodeFrame(message);
-				throw ModbusException(message.functionCode, message.exceptionCode);
-			}
-			else if ((fc & 0x7F) == request.functionCode)
-			{
-				ReadInputRegistersResponse response;
-				_pPort->decodeFrame(response);
-				return response.registerValues;
-			}
-			else throw Poco::ProtocolException("incomplete or invalid frame received");
-		}
-		else throw Poco::TimeoutException();
+		ReadInputRegistersResponse response;
+		_pPort->sendReceive(request, response, _timeout);
+		return response.registerValues;
 	}
 
 	void writeSingleCoil(Poco::UInt8 slaveAddress, Poco::UInt16 outputAddress, bool value)
 	{
-		// TODO
+		disableEvents();
+		WriteSingleCoilRequest request;
+		request.slaveOrUnitAddress = slaveAddress;
+		request.outputAddress = outputAddress;
+		request.value = value;
+		WriteSingleCoilResponse response;
+		_pPort->sendReceive(request, response, _timeout);
 	}
 
 	void writeSingleRegister(Poco::UInt8 slaveAddress, Poco::UInt16 outputAddress, Poco::UInt16 value)
 	{
-		// TODO
+		disableEvents();
+		WriteSingleRegisterRequest request;
+		request.slaveOrUnitAddress = slaveAddress;
+		request.outputAddress = outputAddress;
+		request.value = value;
+		WriteSingleRegisterResponse response;
+		_pPort->sendReceive(request, response, _timeout);
 	}
 
 	Poco::UInt8 readExceptionStatus(Poco::UInt8 slaveAddress)
@@ -0,0 +1,155 @@
+//
+// ModbusPoller.h
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: Polling
+// Module:  ModbusPoller
+//
+// Definition of the ModbusPoller class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Modbus_ModbusPoller_INCLUDED
+#define IoT_Modbus_ModbusPoller_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "IoT/Modbus/ModbusMaster.h"
+#include "IoT/Modbus/PollingPlan.h"
+#include "IoT/Modbus/ModbusSensor.h"
+#include "IoT/Modbus/ModbusIO.h"
+#include "Poco/Util/Timer.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/AtomicCounter.h"
+#include <vector>
+
+
+namespace IoT {
+namespace Modbus {
+
+
+class IoTModbus_API ModbusPoller
+	/// The ModbusPoller periodically executes the requests
+	/// of a PollingPlan using a ModbusMaster, decodes the
+	/// received register values and publishes them through
+	/// a ModbusSensor (registers) or ModbusIO (coils and
+	/// discrete inputs) object for each point.
+	///
+	/// Requests are scheduled per slave and polling period.
+	/// All requests for a slave having the same period are
+	/// sent in one cycle. If a slave does not respond, the
+	/// remaining requests of its cycle are skipped, so that an
+	/// unreachable slave does not delay the other slaves by more
+	/// than a single timeout per cycle. The points of failed
+	/// requests are marked as not ready.
+	///
+	/// If the ModbusMaster is a ModbusScheduler, polling requests
+	/// have low priority, with the polling period as deadline.
+{
+public:
+	ModbusPoller(Poco::SharedPtr<ModbusMaster> pMaster, const PollingPlan& plan);
+		/// Creates the ModbusPoller, and the ModbusSensor and
+		/// ModbusIO objects for all points in the plan.
+		///
+		/// Polling must be started with start().
+
+	~ModbusPoller();
+		/// Stops polling and destroys the ModbusPoller.
+
+	void start();
+		/// Starts polling.
+
+	void stop();
+		/// Stops polling. Waits until a currently running
+		/// polling cycle has completed.
+
+	void poll();
+		/// Executes all requests once, in the calling thread.
+
+	const PollingPlan& plan() const;
+		/// Returns the PollingPlan.
+
+	Poco::SharedPtr<ModbusSensor> sensor(std::size_t index) const;
+		/// Returns the ModbusSensor for the point with the given index,
+		/// or a null pointer if the point is a coil or discrete input.
+
+	Poco::SharedPtr<ModbusIO> io(std::size_t index) const;
+		/// Returns the ModbusIO for the point with the given index,
+		/// or a null pointer if the point is a register.
+
+	int requests() const;
+		/// Returns the number of requests sent.
+
+	int failedRequests() const;
+		/// Returns the number of requests that failed or were
+		/// skipped because the slave did not respond.
+
+protected:
+	class PollTask;
+
+	void pollCycle(const std::vector<std::size_t>& requests);
+	void pollRequest(const PollRequest& request);
+	void invalidate(const PollRequest& request);
+	static double decode(const PointDefinition& point, const std::vector<Poco::UInt16>& registers, std::size_t index);
+
+private:
+	ModbusPoller();
+	ModbusPoller(const ModbusPoller&);
+	ModbusPoller& operator = (const ModbusPoller&);
+
+	Poco::SharedPtr<ModbusMaster> _pMaster;
+	PollingPlan _plan;
+	std::vector<Poco::SharedPtr<ModbusSensor> > _sensors;
+	std::vector<Poco::SharedPtr<ModbusIO> > _ios;
+	std::vector<std::vector<std::size_t> > _cycles;
+	Poco::AtomicCounter _requests;
+	Poco::AtomicCounter _failedRequests;
+	Poco::Util::Timer _eventTimer;
+	Poco::Util::Timer _pollTimer;
+};
+
+
+//
+// inlines
+//
+inline const PollingPlan& ModbusPoller::plan() const
+{
+	return _plan;
+}
+
+
+inline Poco::SharedPtr<ModbusSensor> ModbusPoller::sensor(std::size_t index) const
+{
+	return _sensors.at(index);
+}
+
+
+inline Poco::SharedPtr<ModbusIO> ModbusPoller::io(std::size_t index) const
+{
+	return _ios.at(index);
+}
+
+
+inline int ModbusPoller::requests() const
+{
+	return _requests.value();
+}
+
+
+inline int ModbusPoller::failedRequests() const
+{
+	return _failedRequests.value();
+}
+
+
+} } // namespace IoT::Modbus
+
+
+#endif // IoT_Modbus_ModbusPoller_INCLUDED
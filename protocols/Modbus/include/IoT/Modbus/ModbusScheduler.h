@@ -0,0 +1,282 @@
+//
+// ModbusScheduler.h
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: ModbusMaster
+// Module:  ModbusScheduler
+//
+// Definition of the ModbusScheduler class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Modbus_ModbusScheduler_INCLUDED
+#define IoT_Modbus_ModbusScheduler_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "IoT/Modbus/ModbusMaster.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include "Poco/Timespan.h"
+#include "Poco/Clock.h"
+#include <vector>
+#include <map>
+
+
+namespace IoT {
+namespace Modbus {
+
+
+class IoTModbus_API ModbusScheduler: public ModbusMaster, public Poco::Runnable
+	/// The ModbusScheduler is placed in front of a ModbusMaster that
+	/// is shared by multiple clients. It queues the synchronous requests
+	/// of all clients and executes them on the underlying ModbusMaster,
+	/// using a fixed number of worker threads.
+	///
+	/// Requests are executed in order of their priority, and in
+	/// order of their submission within a priority class. By default,
+	/// write requests have high priority, read requests have normal
+	/// priority, and read requests for more than bulkThreshold registers
+	/// or bits have low priority. A thread can override the priority and
+	/// deadline of its requests with a ScopedPriority object.
+	///
+	/// A request that has not been started before its deadline is
+	/// removed from the queue, and a Poco::TimeoutException is thrown.
+	/// Once a request has been started, the caller waits for its
+	/// completion, which is bounded by the timeout of the underlying
+	/// ModbusMaster.
+	///
+	/// A read request that is identical to a request that is already
+	/// queued or being executed (same function code, slave address,
+	/// starting address and quantity) does not result in a separate
+	/// transaction. Instead, the caller receives the result of the
+	/// existing transaction.
+	///
+	/// Asynchronous requests are passed directly to the underlying
+	/// ModbusMaster, bypassing the queue.
+{
+public:
+	enum Priority
+	{
+		PRIO_LOW    = 0, /// bulk reads, e.g. polling
+		PRIO_NORMAL = 1, /// reads
+		PRIO_HIGH   = 2  /// writes
+	};
+
+	enum
+	{
+		PRIO_COUNT = 3,
+		DEFAULT_BULK_THRESHOLD = 32
+	};
+
+	struct PriorityStatistics
+		/// Statistics for a single priority class.
+	{
+		PriorityStatistics();
+
+		Poco::UInt64 requests;
+			/// Number of requests submitted.
+
+		Poco::UInt64 transactions;
+			/// Number of transactions executed.
+
+		Poco::UInt64 coalesced;
+			/// Number of read requests served by the transaction
+			/// of an identical request.
+
+		Poco::UInt64 expired;
+			/// Number of requests whose deadline expired before
+			/// their transaction was started.
+
+		Poco::UInt64 totalWaitTime;
+			/// Sum of the times, in microseconds, transactions have
+			/// been waiting in the queue before being started.
+
+		Poco::UInt64 maxWaitTime;
+			/// Longest time, in microseconds, a transaction has
+			/// been waiting in the queue before being started.
+	};
+
+	struct Statistics
+	{
+		Statistics();
+
+		std::size_t queueDepth;
+			/// Number of transactions currently waiting in the queue.
+
+		std::size_t maxQueueDepth;
+			/// Highest number of transactions waiting in the queue
+			/// at the same time.
+
+		PriorityStatistics priorities[PRIO_COUNT];
+			/// Statistics for each priority class, indexed by Priority.
+	};
+
+	class IoTModbus_API ScopedPriority
+		/// Sets the priority and deadline for all requests
+		/// made by the current thread during the lifetime
+		/// of the ScopedPriority object.
+	{
+	public:
+		ScopedPriority(Priority priority, const Poco::Timespan& deadline = 0);
+			/// Sets the priority and deadline for requests of the
+			/// current thread. A deadline of 0 means that the
+			/// scheduler's default deadline for the priority is used.
+
+		~ScopedPriority();
+			/// Restores the previous priority and deadline.
+
+	private:
+		ScopedPriority();
+		ScopedPriority(const ScopedPriority&);
+		ScopedPriority& operator = (const ScopedPriority&);
+
+		bool _set;
+		Priority _priority;
+		Poco::Timespan _deadline;
+	};
+
+	ModbusScheduler(Poco::SharedPtr<ModbusMaster> pMaster, int workers = 1, Poco::UInt16 bulkThreshold = DEFAULT_BULK_THRESHOLD);
+		/// Creates the ModbusScheduler for the given ModbusMaster.
+		///
+		/// The number of workers determines how many transactions can
+		/// be outstanding on the underlying ModbusMaster at the same time.
+		/// This should be 1 for Modbus RTU, and can be up to the number of
+		/// pipelined requests supported by the TCPPort for Modbus TCP.
+
+	~ModbusScheduler();
+		/// Stops the workers and destroys the ModbusScheduler.
+		/// Requests still waiting in the queue fail with a
+		/// Poco::IllegalStateException.
+
+	void setDeadline(Priority priority, const Poco::Timespan& deadline);
+		/// Sets the default deadline for requests of the given priority,
+		/// i.e., the maximum time a request can be waiting in the queue.
+		/// A deadline of 0 (default) means that requests wait indefinitely.
+
+	Poco::Timespan getDeadline(Priority priority) const;
+		/// Returns the default deadline for requests of the given priority.
+
+	Poco::UInt16 bulkThreshold() const;
+		/// Returns the number of registers or bits above which
+		/// a read request is considered a bulk request.
+
+	Statistics statistics() const;
+		/// Returns the current statistics.
+
+	void resetStatistics();
+		/// Resets all statistics, except the current queue depth.
+
+	// ModbusMaster
+	void sendRequest(const GenericMessage& message);
+	void sendReadCoilsRequest(const ReadCoilsRequest& request);
+	void sendReadDiscreteInputsRequest(const ReadDiscreteInputsRequest& request);
+	void sendReadHoldingRegistersRequest(const ReadHoldingRegistersRequest& request);
+	void sendReadInputRegistersRequest(const ReadInputRegistersRequest& request);
+	void sendWriteSingleCoilRequest(const WriteSingleCoilRequest& request);
+	void sendWriteSingleRegisterRequest(const WriteSingleRegisterRequest& request);
+	void sendReadExceptionStatusRequest(const ReadExceptionStatusRequest& request);
+	void sendWriteMultipleCoilsRequest(const WriteMultipleCoilsRequest& request);
+	void sendWriteMultipleRegistersRequest(const WriteMultipleRegistersRequest& request);
+	void sendMaskWriteRegisterRequest(const MaskWriteRegisterRequest& request);
+	void sendReadWriteMultipleRegistersRequest(const ReadWriteMultipleRegistersRequest& request);
+	void sendReadFIFOQueueRequest(const ReadFIFOQueueRequest& request);
+	std::vector<bool> readCoils(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfCoils);
+	std::vector<bool> readDiscreteInputs(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfInputs);
+	std::vector<Poco::UInt16> readHoldingRegisters(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfRegisters);
+	std::vector<Poco::UInt16> readInputRegisters(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfRegisters);
+	void writeSingleCoil(Poco::UInt8 slaveAddress, Poco::UInt16 outputAddress, bool value);
+	void writeSingleRegister(Poco::UInt8 slaveAddress, Poco::UInt16 outputAddress, Poco::UInt16 value);
+	Poco::UInt8 readExceptionStatus(Poco::UInt8 slaveAddress);
+
+	// Runnable
+	void run();
+
+protected:
+	struct Transaction: public Poco::RefCountedObject
+	{
+		enum State
+		{
+			TX_QUEUED,
+			TX_RUNNING,
+			TX_DONE
+		};
+
+		Poco::UInt8 functionCode;
+		Poco::UInt8 slaveAddress;
+		Poco::UInt16 address;
+		Poco::UInt16 quantityOrValue;
+		Priority priority;
+		Poco::UInt64 sequence;
+		Poco::Clock enqueued;
+		bool hasDeadline;
+		Poco::Clock deadline;
+		int waiters;
+		State state;
+		std::vector<bool> bits;
+		std::vector<Poco::UInt16> registers;
+		Poco::UInt8 exceptionStatus;
+		Poco::SharedPtr<Poco::Exception> pException;
+	};
+
+	typedef Poco::AutoPtr<Transaction> TransactionPtr;
+	typedef std::pair<int, Poco::UInt64> QueueKey;
+	typedef std::map<QueueKey, TransactionPtr> Queue;
+	typedef std::map<Poco::UInt64, TransactionPtr> ReadMap;
+
+	TransactionPtr execute(Poco::UInt8 functionCode, Poco::UInt8 slaveAddress, Poco::UInt16 address, Poco::UInt16 quantityOrValue);
+		/// Submits a request and waits until its transaction is done.
+
+	TransactionPtr enqueue(Poco::UInt8 functionCode, Poco::UInt8 slaveAddress, Poco::UInt16 address, Poco::UInt16 quantityOrValue, Priority priority, bool hasDeadline, const Poco::Clock& deadline);
+	void dequeue(const TransactionPtr& pTransaction);
+	void perform(Transaction& transaction);
+	void complete(TransactionPtr pTransaction);
+	Priority defaultPriority(Poco::UInt8 functionCode, Poco::UInt16 quantity) const;
+
+	static QueueKey queueKey(const Transaction& transaction);
+	static Poco::UInt64 readKey(const Transaction& transaction);
+	static bool isRead(Poco::UInt8 functionCode);
+
+private:
+	ModbusScheduler();
+
+	Poco::SharedPtr<ModbusMaster> _pMaster;
+	Poco::UInt16 _bulkThreshold;
+	Poco::Timespan _deadlines[PRIO_COUNT];
+	std::vector<Poco::SharedPtr<Poco::Thread> > _workers;
+	Queue _queue;
+	ReadMap _reads;
+	Poco::UInt64 _sequence;
+	Statistics _statistics;
+	bool _stopped;
+	Poco::Condition _queued;
+	Poco::Condition _done;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline Poco::UInt16 ModbusScheduler::bulkThreshold() const
+{
+	return _bulkThreshold;
+}
+
+
+} } // namespace IoT::Modbus
+
+
+#endif // IoT_Modbus_ModbusScheduler_INCLUDED
@@ -0,0 +1,100 @@
+//
+// ModbusSensor.h
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: Polling
+// Module:  ModbusSensor
+//
+// Definition of the ModbusSensor class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Modbus_ModbusSensor_INCLUDED
+#define IoT_Modbus_ModbusSensor_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "IoT/Modbus/PollingPlan.h"
+#include "IoT/Devices/Sensor.h"
+#include "IoT/Devices/DeviceImpl.h"
+#include "IoT/Devices/EventModerationPolicy.h"
+#include "Poco/Util/Timer.h"
+
+
+namespace IoT {
+namespace Modbus {
+
+
+class IoTModbus_API ModbusSensor: public IoT::Devices::DeviceImpl<IoT::Devices::Sensor, ModbusSensor>
+	/// A Sensor publishing the scaled value of one or two
+	/// registers polled by a ModbusPoller.
+	///
+	/// The valueChanged event is fired only if the polled value
+	/// differs from the previous one, subject to the valueChangedPeriod
+	/// and valueChangedDelta properties.
+	///
+	/// The sensor is ready after the first successful poll, and
+	/// becomes not ready again if the register cannot be read.
+{
+public:
+	ModbusSensor(const PointDefinition& point, Poco::Util::Timer& timer);
+		/// Creates a ModbusSensor for the given point.
+		///
+		/// The timer is used by the event moderation policy.
+
+	~ModbusSensor();
+		/// Destroys the ModbusSensor.
+
+	void update(double value);
+		/// Updates the value, and fires the valueChanged event
+		/// if the value has changed. Called by the ModbusPoller.
+
+	void invalidate();
+		/// Marks the value as not valid. Called by the ModbusPoller
+		/// if the register cannot be read.
+
+	// Sensor
+	double value() const;
+	bool ready() const;
+
+	static const std::string NAME;
+	static const std::string SYMBOLIC_NAME;
+
+protected:
+	Poco::Any getValueChangedPeriod(const std::string&) const;
+	void setValueChangedPeriod(const std::string&, const Poco::Any& value);
+	Poco::Any getValueChangedDelta(const std::string&) const;
+	void setValueChangedDelta(const std::string&, const Poco::Any& value);
+	Poco::Any getDisplayValue(const std::string&) const;
+	Poco::Any getDeviceIdentifier(const std::string&) const;
+	Poco::Any getName(const std::string&) const;
+	Poco::Any getSymbolicName(const std::string&) const;
+	Poco::Any getPhysicalQuantity(const std::string&) const;
+	Poco::Any getPhysicalUnit(const std::string&) const;
+
+private:
+	double _value;
+	bool _ready;
+	int _valueChangedPeriod;
+	double _valueChangedDelta;
+	Poco::SharedPtr<IoT::Devices::EventModerationPolicy<double> > _pEventPolicy;
+	Poco::Any _deviceIdentifier;
+	Poco::Any _symbolicName;
+	Poco::Any _name;
+	Poco::Any _physicalQuantity;
+	Poco::Any _physicalUnit;
+	Poco::Util::Timer& _timer;
+};
+
+
+} } // namespace IoT::Modbus
+
+
+#endif // IoT_Modbus_ModbusSensor_INCLUDED
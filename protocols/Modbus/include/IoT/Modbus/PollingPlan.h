@@ -0,0 +1,185 @@
+//
+// PollingPlan.h
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: Polling
+// Module:  PollingPlan
+//
+// Definition of the PollingPlan class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Modbus_PollingPlan_INCLUDED
+#define IoT_Modbus_PollingPlan_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include <vector>
+#include <string>
+
+
+namespace IoT {
+namespace Modbus {
+
+
+struct IoTModbus_API PointDefinition
+	/// The definition of a single data point (a coil, a discrete
+	/// input, or a value stored in one or two registers) in a
+	/// register map.
+{
+	enum DataType
+	{
+		TYPE_BOOL,    /// single coil or discrete input
+		TYPE_INT16,   /// signed 16-bit integer, one register
+		TYPE_UINT16,  /// unsigned 16-bit integer, one register
+		TYPE_INT32,   /// signed 32-bit integer, two registers
+		TYPE_UINT32,  /// unsigned 32-bit integer, two registers
+		TYPE_FLOAT32  /// IEEE 754 single precision, two registers
+	};
+
+	PointDefinition();
+		/// Creates a PointDefinition for an unsigned 16-bit holding register
+		/// at address 0, polled once per second.
+
+	std::string id;
+		/// The identifier of the point, used as device identifier
+		/// of the published device.
+
+	Poco::UInt8 slaveAddress;
+		/// The address of the slave (Modbus RTU) or the unit
+		/// identifier (Modbus TCP).
+
+	Poco::UInt8 functionCode;
+		/// The read function: MODBUS_READ_COILS, MODBUS_READ_DISCRETE_INPUTS,
+		/// MODBUS_READ_HOLDING_REGISTERS or MODBUS_READ_INPUT_REGISTERS.
+
+	Poco::UInt16 address;
+		/// The address of the (first) coil, input or register.
+
+	DataType type;
+		/// The data type. Must be TYPE_BOOL for coils and discrete
+		/// inputs, and any other type for registers.
+
+	bool swapWords;
+		/// For 32-bit values, true if the low-order word is stored
+		/// in the first register.
+
+	double scale;
+		/// The raw value is multiplied by scale...
+
+	double offset;
+		/// ...and offset is added to obtain the published value.
+
+	long period;
+		/// The polling period in milliseconds.
+
+	std::string physicalQuantity;
+		/// The physical quantity (for register values).
+
+	std::string physicalUnit;
+		/// The physical unit (for register values).
+
+	Poco::UInt16 width() const;
+		/// Returns the number of coils, inputs or registers
+		/// occupied by the point.
+
+	static DataType parseType(const std::string& type);
+		/// Parses a data type name ("bool", "int16", "uint16", "int32",
+		/// "uint32" or "float32").
+		///
+		/// Throws a Poco::InvalidArgumentException if the name is not valid.
+};
+
+
+struct IoTModbus_API PollRequest
+	/// A single read request in a PollingPlan, covering one or more points.
+{
+	Poco::UInt8 slaveAddress;
+	Poco::UInt8 functionCode;
+	Poco::UInt16 startingAddress;
+	Poco::UInt16 quantity;
+	long period;
+	std::vector<std::size_t> points;
+		/// Indexes of the points served by this request.
+};
+
+
+class IoTModbus_API PollingPlan
+	/// A PollingPlan turns a register map (a list of PointDefinition
+	/// objects) into the smallest number of read requests needed
+	/// to poll all points.
+	///
+	/// Points having the same slave address, function code and polling
+	/// period are sorted by address. Adjacent and overlapping points
+	/// are read with a single request, up to the maximum number of
+	/// registers (or bits) that fits into a Modbus PDU. Points separated
+	/// by a gap are only read with the same request if the gap is not
+	/// larger than maxGap, as many devices respond with an exception
+	/// if unmapped registers are read.
+{
+public:
+	enum
+	{
+		MAX_READ_REGISTERS = 125,
+		MAX_READ_BITS      = 2000
+	};
+
+	PollingPlan(const std::vector<PointDefinition>& points, Poco::UInt16 maxGap = 0, Poco::UInt16 maxRegisters = MAX_READ_REGISTERS, Poco::UInt16 maxBits = MAX_READ_BITS);
+		/// Creates the PollingPlan for the given points.
+		///
+		/// maxGap is the maximum number of unused registers or bits that
+		/// are read to combine two points into one request. maxRegisters
+		/// and maxBits limit the size of a single request, for devices
+		/// not supporting the maximum PDU size.
+		///
+		/// Throws a Poco::InvalidArgumentException if a point definition
+		/// is not valid.
+
+	~PollingPlan();
+		/// Destroys the PollingPlan.
+
+	const std::vector<PointDefinition>& points() const;
+		/// Returns the point definitions.
+
+	const std::vector<PollRequest>& requests() const;
+		/// Returns the requests, ordered by slave address, polling
+		/// period, function code and starting address.
+
+protected:
+	static void validate(const PointDefinition& point);
+	void plan(Poco::UInt16 maxGap, Poco::UInt16 maxRegisters, Poco::UInt16 maxBits);
+
+private:
+	PollingPlan();
+
+	std::vector<PointDefinition> _points;
+	std::vector<PollRequest> _requests;
+};
+
+
+//
+// inlines
+//
+inline const std::vector<PointDefinition>& PollingPlan::points() const
+{
+	return _points;
+}
+
+
+inline const std::vector<PollRequest>& PollingPlan::requests() const
+{
+	return _requests;
+}
+
+
+} } // namespace IoT::Modbus
+
+
+#endif // IoT_Modbus_PollingPlan_INCLUDED
@@ -0,0 +1,115 @@
+//
+// RTUFramer.h
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: ModbusMaster
+// Module:  RTUFramer
+//
+// Definition of the RTUFramer class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Modbus_RTUFramer_INCLUDED
+#define IoT_Modbus_RTUFramer_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include <cstddef>
+
+
+namespace IoT {
+namespace Modbus {
+
+
+class IoTModbus_API RTUFramer
+	/// The RTUFramer detects the end of a Modbus RTU response
+	/// frame while it is being received.
+	///
+	/// The length of the frame is derived from the function code
+	/// and, for responses of variable length, the byte count
+	/// field, as soon as these have been received. The CRC is
+	/// updated with every chunk of data passed to update(), so
+	/// every received byte is processed only once.
+	///
+	/// For function codes with unknown response format,
+	/// the frame is considered complete as soon as the CRC of
+	/// the data received so far matches.
+{
+public:
+	enum Status
+	{
+		FRAME_INCOMPLETE, /// more data is needed
+		FRAME_COMPLETE,   /// a complete frame with valid CRC has been received
+		FRAME_INVALID     /// invalid length or CRC
+	};
+
+	enum
+	{
+		RTU_MAX_ADU_SIZE = 256,
+		LENGTH_UNKNOWN   = 0xFFFF
+	};
+
+	RTUFramer();
+		/// Creates the RTUFramer.
+
+	~RTUFramer();
+		/// Destroys the RTUFramer.
+
+	void reset();
+		/// Resets the RTUFramer for the next frame.
+
+	Status update(const char* frame, std::size_t size);
+		/// Updates the framer with the data received so far.
+		///
+		/// The frame buffer must contain all data received since
+		/// the last reset(), and size must not be less than in
+		/// the previous call. Only the data not seen by previous
+		/// calls is processed.
+
+	std::size_t needed() const;
+		/// Returns the number of bytes that must be received
+		/// at least to complete the frame, or to determine its length.
+
+	std::size_t length() const;
+		/// Returns the length of a complete frame, including CRC.
+
+	static std::size_t responseLength(const char* frame, std::size_t size);
+		/// Returns the length of the response frame including CRC,
+		/// based on the slave address, function code and byte count.
+		///
+		/// Returns 0 if more data is needed to determine the length,
+		/// or LENGTH_UNKNOWN if the function code is not known.
+
+	static Poco::UInt16 crc16(Poco::UInt16 crc, const char* data, std::size_t size);
+		/// Updates the given Modbus CRC (initial value 0xFFFF)
+		/// with the given data.
+
+private:
+	std::size_t _size;
+	std::size_t _length;
+	std::size_t _crcSize;
+	Poco::UInt16 _crc;
+	Status _status;
+};
+
+
+//
+// inlines
+//
+inline std::size_t RTUFramer::length() const
+{
+	return _length;
+}
+
+
+} } // namespace IoT::Modbus
+
+
+#endif // IoT_Modbus_RTUFramer_INCLUDED
@@ -21,14 +21,18 @@
 
 
 #include "IoT/Modbus/Modbus.h"
+#include "IoT/Modbus/ModbusException.h"
 #include "IoT/Modbus/PDUWriter.h"
 #include "IoT/Modbus/PDUReader.h"
+#include "IoT/Modbus/RTUFramer.h"
 #include "IoT/Serial/SerialPort.h"
 #include "Poco/Timespan.h"
+#include "Poco/Clock.h"
 #include "Poco/Buffer.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/BinaryWriter.h"
 #include "Poco/MemoryStream.h"
+#include "Poco/Mutex.h"
 
 
 namespace IoT {
@@ -51,6 +55,11 @@ public:
 		/// Creates a RTUPort using the given SerialPort.
 		///
 		/// The recommended value for interCharTimeout is 750us.
+		/// The interCharTimeout corresponds to the t1.5 character
+		/// timeout of the Modbus RTU specification. A silent
+		/// interval of this length within a frame ends the frame.
+		/// The t3.5 inter-frame delay, which is enforced before
+		/// sending a frame, is derived from it.
 		///
 		/// The SerialPort must be open and properly configured
 		/// for RS-485 communication with the Modbus slaves.
@@ -67,20 +76,25 @@ public:
 		PDUWriter pduWriter(binaryWriter);
 		pduWriter.write(message);
 		poco_assert (ostr.good());
-		Poco::UInt16 crc = 0xffff;
-		for (int i = 0; i < ostr.charsWritten(); i++)
-		{
-			crc = updateCRC16(crc, _sendBuffer[i]);
-		}
+		Poco::UInt16 crc = RTUFramer::crc16(0xffff, _sendBuffer.begin(), static_cast<std::size_t>(ostr.charsWritten()));
 		// CRC is sent in little endian (low-order byte, high-order byte)
 		binaryWriter << static_cast<Poco::UInt8>(crc & 0xff);
 		binaryWriter << static_cast<Poco::UInt8>((crc >> 8) & 0xff);
 		poco_assert (ostr.good());
+		discardInput();
+		waitFrameDelay();
 		_pSerialPort->write(_sendBuffer.begin(), ostr.charsWritten());
+		_lastFrame.update();
 	}
 	
 	Poco::UInt8 receiveFrame(const Poco::Timespan& timeout);
-		/// Receives the next frame from the wire. Returns the frame's function code.
+		/// Receives the next frame from the wire. Returns the frame's function code,
+		/// or 0 if an incomplete or invalid frame has been received.
+		///
+		/// Only as many bytes as are needed to complete the frame
+		/// are read from the port. The frame length is determined
+		/// from the function code and byte count as soon as these
+		/// have been received.
 
 	template <class Message>
 	void decodeFrame(Message& message)
@@ -88,7 +102,7 @@ public:
 		///
 		/// The raw frame must have been read from the wire with receiveFrame().
 	{
-		Poco::MemoryInputStream istr(_receiveBuffer.begin(), _receiveBuffer.size());
+		Poco::MemoryInputStream istr(_receiveBuffer.begin(), _framer.length() - 2);
 		Poco::BinaryReader binaryReader(istr, _byteOrder == RTU_BIG_ENDIAN ? Poco::BinaryReader::BIG_ENDIAN_BYTE_ORDER : Poco::BinaryReader::LITTLE_ENDIAN_BYTE_ORDER);
 		PDUReader pduReader(binaryReader);
 		pduReader.read(message);
@@ -101,9 +115,51 @@ public:
 		/// the internal buffer, or if data arrives during the
 		/// specified time interval, otherwise false.
 
+	template <class Request, class Response>
+	void sendReceive(const Request& request, Response& response, const Poco::Timespan& timeout)
+		/// Sends the request and waits for the response.
+		///
+		/// Requests from multiple threads are serialized, as only
+		/// one request can be outstanding on a serial line.
+		///
+		/// Throws a Poco::TimeoutException if no response is received
+		/// within the given timeout. Throws a ModbusException if the device
+		/// responds with an exception message, and a Poco::ProtocolException
+		/// if an incomplete or invalid frame is received.
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		sendFrame(request);
+		if (poll(timeout))
+		{
+			Poco::UInt8 fc = receiveFrame(timeout);
+			if ((fc & 0x80) == MODBUS_EXCEPTION_MASK)
+			{
+				ModbusExceptionMessage message;
+				decodeFrame(message);
+				throw ModbusException(message.functionCode, message.exceptionCode);
+			}
+			else if ((fc & 0x7F) == request.functionCode)
+			{
+				decodeFrame(response);
+			}
+			else throw Poco::ProtocolException("incomplete or invalid frame received");
+		}
+		else throw Poco::TimeoutException();
+	}
+
 protected:
-	Poco::UInt16 updateCRC16(Poco::UInt16 crc, Poco::UInt8 byte);
-	bool checkFrame(std::size_t size);
+	void waitFrameDelay();
+		/// Waits until at least the t3.5 inter-frame delay has
+		/// passed since the last frame has been sent or received.
+
+	void discardFrame();
+		/// Discards the rest of an invalid frame, until the
+		/// line has been silent for the inter-character timeout.
+
+	void discardInput();
+		/// Discards any data that has been received outside of
+		/// a frame, e.g. the rest of a late or incomplete response.
 
 private:
 	enum
@@ -117,9 +173,13 @@ private:
 	
 	Poco::SharedPtr<IoT::Serial::SerialPort> _pSerialPort;
 	Poco::Timespan _interCharTimeout;
+	Poco::Timespan _frameDelay;
 	ByteOrder _byteOrder;
 	Poco::Buffer<char> _sendBuffer;
 	Poco::Buffer<char> _receiveBuffer;
+	RTUFramer _framer;
+	Poco::Clock _lastFrame;
+	Poco::FastMutex _mutex;
 };
 
 
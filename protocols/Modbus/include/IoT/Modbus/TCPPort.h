@@ -0,0 +1,346 @@
+//
+// TCPPort.h
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: ModbusMaster
+// Module:  TCPPort
+//
+// Definition of the TCPPort class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Modbus_TCPPort_INCLUDED
+#define IoT_Modbus_TCPPort_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "IoT/Modbus/ModbusException.h"
+#include "IoT/Modbus/PDUWriter.h"
+#include "IoT/Modbus/PDUReader.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include "Poco/Timespan.h"
+#include "Poco/Clock.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/BinaryWriter.h"
+#include "Poco/BinaryReader.h"
+#include "Poco/MemoryStream.h"
+#include <map>
+#include <deque>
+
+
+namespace IoT {
+namespace Modbus {
+
+
+class IoTModbus_API TCPPort: public Poco::Runnable
+	/// This class implements the Modbus TCP protocol.
+	///
+	/// Every request is sent with a MBAP header containing a
+	/// transaction identifier. A receiver thread reads the responses
+	/// from the connection and passes each one to the request with
+	/// the matching transaction identifier. Therefore, multiple
+	/// threads can use sendReceive() at the same time, and up to
+	/// maxPending requests are outstanding on the connection
+	/// without waiting for the previous response. Responses may
+	/// arrive in any order.
+	///
+	/// The timeout for a request can be set per unit identifier
+	/// with setUnitTimeout(), for gateways serving slow and fast devices.
+	///
+	/// Requests sent with sendFrame() count against maxPending
+	/// until their response has been received, or until their
+	/// timeout (see setFrameTimeout()) has expired. A late response
+	/// to an expired request is discarded.
+	///
+	/// The connection is established with the first request. If it
+	/// is lost, all outstanding requests fail with a Poco::IOException
+	/// and the next request establishes a new connection.
+{
+public:
+	enum
+	{
+		MODBUS_TCP_PORT       = 502,
+		DEFAULT_MAX_PENDING   = 16,
+		DEFAULT_FRAME_TIMEOUT = 2
+	};
+
+	TCPPort(const Poco::Net::SocketAddress& address, Poco::Timespan connectTimeout = Poco::Timespan(5, 0), int maxPending = DEFAULT_MAX_PENDING);
+		/// Creates a TCPPort for the Modbus TCP server (slave or gateway)
+		/// at the given address.
+		///
+		/// At most maxPending requests are sent before a response
+		/// is received. Devices that do not support pipelining must
+		/// use a maxPending of 1.
+
+	~TCPPort();
+		/// Destroys the TCPPort and closes the connection.
+
+	const Poco::Net::SocketAddress& address() const;
+		/// Returns the address of the server.
+
+	void connect();
+		/// Connects to the server, unless a connection already exists.
+
+	void disconnect();
+		/// Closes the connection to the server.
+		///
+		/// Outstanding requests fail with a Poco::IOException.
+
+	bool connected() const;
+		/// Returns true if the port is connected to the server.
+
+	void setUnitTimeout(Poco::UInt8 unitId, const Poco::Timespan& timeout);
+		/// Sets the timeout for requests to the given unit,
+		/// overriding the timeout given to sendReceive().
+
+	Poco::Timespan getUnitTimeout(Poco::UInt8 unitId, const Poco::Timespan& defaultTimeout) const;
+		/// Returns the timeout for requests to the given unit, or
+		/// defaultTimeout if no timeout has been set for the unit.
+
+	void setFrameTimeout(const Poco::Timespan& timeout);
+		/// Sets the timeout for requests sent with sendFrame(),
+		/// unless a timeout has been set for the request's unit
+		/// with setUnitTimeout(). Defaults to DEFAULT_FRAME_TIMEOUT
+		/// seconds.
+		///
+		/// If no response has been received within the timeout,
+		/// the request no longer counts against maxPending.
+
+	Poco::Timespan getFrameTimeout() const;
+		/// Returns the timeout for requests sent with sendFrame().
+
+	template <class Message>
+	Poco::UInt16 sendFrame(const Message& message)
+		/// Sends a Modbus TCP frame over the wire and returns its
+		/// transaction identifier.
+		///
+		/// The response can be obtained with poll(), receiveFrame()
+		/// and decodeFrame().
+		///
+		/// Does not wait if maxPending requests are outstanding,
+		/// but throws a Poco::TimeoutException.
+	{
+		char frame[MODBUS_TCP_MAX_ADU_SIZE];
+		std::size_t size = encodeFrame(message, frame);
+		Transaction::Ptr pTransaction = new Transaction(true);
+		pTransaction->setTimeout(getUnitTimeout(message.slaveOrUnitAddress, getFrameTimeout()));
+		startTransaction(pTransaction, frame, size, Poco::Timespan(0));
+		return pTransaction->id();
+	}
+
+	Poco::UInt8 receiveFrame(const Poco::Timespan& timeout);
+		/// Receives the next response to a request sent with sendFrame().
+		/// Returns the frame's function code, or 0 if no response
+		/// has been received within the given timeout.
+
+	template <class Message>
+	void decodeFrame(Message& message)
+		/// Decodes the frame obtained with receiveFrame().
+	{
+		decode(_frame, message);
+	}
+
+	bool poll(const Poco::Timespan& timeout);
+		/// Waits for a response to a request sent with sendFrame().
+		///
+		/// Returns true if a response is available or arrives
+		/// during the specified time interval, otherwise false.
+
+	template <class Request, class Response>
+	void sendReceive(const Request& request, Response& response, const Poco::Timespan& timeout)
+		/// Sends the request and waits for the response.
+		///
+		/// Can be called from multiple threads at the same time.
+		///
+		/// Throws a Poco::TimeoutException if no response is received
+		/// within the timeout for the request's unit. Throws a ModbusException
+		/// if the device responds with an exception message, and a
+		/// Poco::ProtocolException if an unexpected response is received.
+	{
+		char frame[MODBUS_TCP_MAX_ADU_SIZE];
+		std::size_t size = encodeFrame(request, frame);
+		Poco::Timespan unitTimeout = getUnitTimeout(request.slaveOrUnitAddress, timeout);
+		Transaction::Ptr pTransaction = new Transaction(false);
+		startTransaction(pTransaction, frame, size, unitTimeout);
+		Poco::UInt8 fc = waitTransaction(pTransaction, unitTimeout);
+		if ((fc & 0x80) == MODBUS_EXCEPTION_MASK)
+		{
+			ModbusExceptionMessage message;
+			decode(pTransaction->frame(), message);
+			throw ModbusException(message.functionCode, message.exceptionCode);
+		}
+		else if (fc == request.functionCode)
+		{
+			decode(pTransaction->frame(), response);
+		}
+		else throw Poco::ProtocolException("incomplete or invalid frame received");
+	}
+
+	// Runnable
+	void run();
+
+protected:
+	enum
+	{
+		MBAP_HEADER_SIZE        = 6,
+		MODBUS_TCP_MAX_ADU_SIZE = 260,
+		MAX_RECEIVED_FRAMES     = 64
+	};
+
+	class Transaction: public Poco::RefCountedObject
+	{
+	public:
+		typedef Poco::AutoPtr<Transaction> Ptr;
+
+		explicit Transaction(bool async);
+
+		Poco::UInt16 id() const;
+		void setId(Poco::UInt16 id);
+		bool async() const;
+		void setTimeout(const Poco::Timespan& timeout);
+		const Poco::Clock& expiry() const;
+		bool wait(const Poco::Timespan& timeout);
+		void complete(const char* pFrame, std::size_t size);
+		void fail(const std::string& error);
+		const std::string& frame() const;
+		const std::string& error() const;
+
+	protected:
+		~Transaction();
+
+	private:
+		Poco::UInt16 _id;
+		bool _async;
+		Poco::Clock _expiry;
+		std::string _frame;
+		std::string _error;
+		Poco::Event _done;
+	};
+
+	typedef std::map<Poco::UInt16, Transaction::Ptr> TransactionMap;
+
+	template <class Message>
+	static std::size_t encodeFrame(const Message& message, char* frame)
+		/// Writes the unit identifier and PDU of the message after the
+		/// space reserved for the MBAP header, which is completed by
+		/// startTransaction(). Returns the size of the frame.
+	{
+		Poco::MemoryOutputStream ostr(frame + MBAP_HEADER_SIZE, MODBUS_TCP_MAX_ADU_SIZE - MBAP_HEADER_SIZE);
+		Poco::BinaryWriter binaryWriter(ostr, Poco::BinaryWriter::BIG_ENDIAN_BYTE_ORDER);
+		PDUWriter pduWriter(binaryWriter);
+		pduWriter.write(message);
+		if (!ostr.good()) throw Poco::ProtocolException("Modbus request too large");
+		return MBAP_HEADER_SIZE + ostr.charsWritten();
+	}
+
+	template <class Message>
+	static void decode(const std::string& frame, Message& message)
+	{
+		Poco::MemoryInputStream istr(frame.data(), frame.size());
+		Poco::BinaryReader binaryReader(istr, Poco::BinaryReader::BIG_ENDIAN_BYTE_ORDER);
+		PDUReader pduReader(binaryReader);
+		pduReader.read(message);
+	}
+
+	void startTransaction(Transaction::Ptr pTransaction, char* frame, std::size_t size, const Poco::Timespan& timeout);
+	Poco::UInt8 waitTransaction(Transaction::Ptr pTransaction, const Poco::Timespan& timeout);
+	void cancelTransaction(Transaction::Ptr pTransaction);
+	void completeTransaction(Poco::UInt16 id, const char* pFrame, std::size_t size);
+	void failTransactions(const std::string& error);
+	Poco::Clock::ClockDiff expireTransactions();
+		/// Removes all asynchronous transactions whose timeout has
+		/// expired. Returns the time until the next asynchronous
+		/// transaction expires, or 0 if there is none.
+		/// Must be called with _mutex locked.
+	Poco::UInt16 nextTransactionId();
+
+	static bool receiveBytes(Poco::Net::StreamSocket& socket, char* buffer, std::size_t size);
+
+private:
+	TCPPort();
+	TCPPort(const TCPPort&);
+	TCPPort& operator = (const TCPPort&);
+
+	Poco::Net::SocketAddress _address;
+	Poco::Timespan _connectTimeout;
+	std::size_t _maxPending;
+	Poco::Timespan _frameTimeout;
+	Poco::Net::StreamSocket _socket;
+	bool _connected;
+	Poco::UInt16 _lastId;
+	TransactionMap _pending;
+	std::map<Poco::UInt8, Poco::Timespan> _unitTimeouts;
+	std::deque<std::string> _received;
+	std::string _frame;
+	Poco::Thread _thread;
+	mutable Poco::FastMutex _mutex;
+	Poco::Condition _pendingCondition;
+	Poco::Condition _receivedCondition;
+	Poco::FastMutex _sendMutex;
+	Poco::FastMutex _connectMutex;
+};
+
+
+//
+// inlines
+//
+inline const Poco::Net::SocketAddress& TCPPort::address() const
+{
+	return _address;
+}
+
+
+inline Poco::UInt16 TCPPort::Transaction::id() const
+{
+	return _id;
+}
+
+
+inline void TCPPort::Transaction::setId(Poco::UInt16 id)
+{
+	_id = id;
+}
+
+
+inline bool TCPPort::Transaction::async() const
+{
+	return _async;
+}
+
+
+inline const Poco::Clock& TCPPort::Transaction::expiry() const
+{
+	return _expiry;
+}
+
+
+inline const std::string& TCPPort::Transaction::frame() const
+{
+	return _frame;
+}
+
+
+inline const std::string& TCPPort::Transaction::error() const
+{
+	return _error;
+}
+
+
+} } // namespace IoT::Modbus
+
+
+#endif // IoT_Modbus_TCPPort_INCLUDED
@@ -0,0 +1,345 @@
+//
+// RTUBenchmark.cpp
+//
+// $Id$
+//
+// This sample compares the incremental Modbus RTU frame detection
+// of RTUPort with detecting the end of a frame by recomputing the
+// CRC over the entire frame after every chunk and waiting for the
+// line to become silent.
+//
+// The round trip benchmark runs a slave on a pseudo terminal,
+// optionally pacing its responses to simulate a given baud rate.
+//
+// Usage: RTUBenchmark [<iterations> [<baudRate>]]
+//
+// The inter-character timeout and inter-frame delay are 750us and 1750us,
+// as specified for baud rates above 19200. A baud rate of 0 disables pacing.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Modbus/RTUFramer.h"
+#include "IoT/Modbus/RTUPort.h"
+#include "IoT/Modbus/ModbusMasterImpl.h"
+#include "IoT/Serial/SerialPort.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Clock.h"
+#include "Poco/Exception.h"
+#include <iostream>
+#include <algorithm>
+#include <sys/select.h>
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+
+using IoT::Modbus::RTUFramer;
+using IoT::Modbus::RTUPort;
+
+
+namespace
+{
+	const Poco::UInt16 REGISTER_COUNT = 125;
+	const Poco::Timespan INTER_CHAR_TIMEOUT(0, 750);
+	const Poco::Timespan FRAME_DELAY(0, 1750);
+
+	Poco::UInt16 bytewiseCRC16(const char* data, std::size_t size)
+		/// Computes the CRC one byte at a time, as RTUPort did
+		/// before RTUFramer was introduced.
+	{
+		static Poco::UInt16 table[256];
+		static bool initialized = false;
+		if (!initialized)
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				Poco::UInt16 crc = static_cast<Poco::UInt16>(i);
+				for (int k = 0; k < 8; k++)
+				{
+					crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+				}
+				table[i] = crc;
+			}
+			initialized = true;
+		}
+		Poco::UInt16 crc = 0xFFFF;
+		for (std::size_t i = 0; i < size; i++)
+		{
+			crc = (crc >> 8) ^ table[(crc ^ static_cast<Poco::UInt8>(data[i])) & 0xFF];
+		}
+		return crc;
+	}
+
+	bool checkFrame(const char* frame, std::size_t size)
+		/// Checks the CRC of the entire frame received so far.
+	{
+		if (size < 4) return false;
+		Poco::UInt16 crc = bytewiseCRC16(frame, size - 2);
+		return crc == (static_cast<Poco::UInt8>(frame[size - 2]) | (static_cast<Poco::UInt8>(frame[size - 1]) << 8));
+	}
+
+	std::string appendCRC(const std::string& data)
+	{
+		std::string frame(data);
+		Poco::UInt16 crc = RTUFramer::crc16(0xFFFF, data.data(), data.size());
+		frame += static_cast<char>(crc & 0xFF);
+		frame += static_cast<char>(crc >> 8);
+		return frame;
+	}
+
+	std::string readHoldingRegistersRequest()
+	{
+		std::string request("\x01\x03\x00\x00", 4);
+		request += static_cast<char>(REGISTER_COUNT >> 8);
+		request += static_cast<char>(REGISTER_COUNT & 0xFF);
+		return appendCRC(request);
+	}
+
+	std::string readHoldingRegistersResponse()
+	{
+		std::string response("\x01\x03", 2);
+		response += static_cast<char>(2*REGISTER_COUNT);
+		for (Poco::UInt16 i = 0; i < REGISTER_COUNT; i++)
+		{
+			response += static_cast<char>(i >> 8);
+			response += static_cast<char>(i & 0xFF);
+		}
+		return appendCRC(response);
+	}
+
+	class Slave: public Poco::Runnable
+		/// A minimal Modbus RTU slave on a pseudo terminal, answering
+		/// every 8 byte request with the same response.
+	{
+	public:
+		Slave(int baudRate):
+			_baudRate(baudRate),
+			_response(readHoldingRegistersResponse()),
+			_stopped(false)
+		{
+			_fd = posix_openpt(O_RDWR | O_NOCTTY);
+			if (_fd == -1 || grantpt(_fd) != 0 || unlockpt(_fd) != 0) throw Poco::IOException("cannot open pseudo terminal");
+			_device = ptsname(_fd);
+			struct termios term;
+			if (tcgetattr(_fd, &term) == 0)
+			{
+				cfmakeraw(&term);
+				tcsetattr(_fd, TCSANOW, &term);
+			}
+			_thread.start(*this);
+		}
+
+		~Slave()
+		{
+			_stopped = true;
+			_thread.join();
+			close(_fd);
+		}
+
+		const std::string& device() const
+		{
+			return _device;
+		}
+
+		void run()
+		{
+			char request[8];
+			std::size_t n = 0;
+			while (!_stopped)
+			{
+				fd_set fdRead;
+				FD_ZERO(&fdRead);
+				FD_SET(_fd, &fdRead);
+				struct timeval tv;
+				tv.tv_sec  = 0;
+				tv.tv_usec = 100000;
+				if (select(_fd + 1, &fdRead, 0, 0, &tv) <= 0) continue;
+				ssize_t rd = read(_fd, request + n, sizeof(request) - n);
+				if (rd <= 0)
+				{
+					Poco::Thread::sleep(10);
+					continue;
+				}
+				n += rd;
+				if (n == sizeof(request))
+				{
+					n = 0;
+					respond();
+				}
+			}
+		}
+
+	protected:
+		void respond()
+		{
+			// With a baud rate given, the response is written in chunks,
+			// each one after its transmission time at 10 bits per character.
+			// The chunks are small enough (about 350us) to keep the gaps
+			// well below the inter-character timeout.
+			std::size_t chunkSize = _baudRate > 0 ? std::max<std::size_t>(1, _baudRate*35/1000000) : _response.size();
+			Poco::Clock::ClockDiff chunkTime = _baudRate > 0 ? static_cast<Poco::Clock::ClockDiff>(chunkSize)*10*1000000/_baudRate : 0;
+			Poco::Clock next;
+			for (std::size_t i = 0; i < _response.size(); i += chunkSize)
+			{
+				next += chunkTime;
+				while (!next.isElapsed(0))
+				{
+				}
+				std::size_t size = std::min(chunkSize, _response.size() - i);
+				if (write(_fd, _response.data() + i, size) != static_cast<ssize_t>(size)) return;
+			}
+		}
+
+	private:
+		int _baudRate;
+		std::string _response;
+		int _fd;
+		std::string _device;
+		volatile bool _stopped;
+		Poco::Thread _thread;
+	};
+
+	void benchmarkFraming(int iterations)
+	{
+		std::string response = readHoldingRegistersResponse();
+		std::size_t chunkSizes[] = {1, 16, response.size()};
+
+		std::cout << "Framing of a " << response.size() << " byte response, " << iterations << " iterations" << std::endl;
+		std::cout << "-------------------------------------------------" << std::endl;
+		for (int c = 0; c < 3; c++)
+		{
+			std::size_t chunkSize = chunkSizes[c];
+			Poco::Stopwatch sw;
+
+			// CRC recomputed over the entire frame after every chunk
+			sw.start();
+			int complete = 0;
+			for (int i = 0; i < iterations; i++)
+			{
+				std::size_t n = 0;
+				bool frameComplete = false;
+				while (!frameComplete && n < response.size())
+				{
+					n += std::min(chunkSize, response.size() - n);
+					frameComplete = checkFrame(response.data(), n);
+				}
+				if (frameComplete) complete++;
+			}
+			sw.stop();
+			Poco::Timestamp::TimeDiff fullTime = sw.elapsed();
+
+			// incremental CRC and predicted frame length
+			sw.restart();
+			RTUFramer framer;
+			for (int i = 0; i < iterations; i++)
+			{
+				framer.reset();
+				std::size_t n = 0;
+				RTUFramer::Status status = RTUFramer::FRAME_INCOMPLETE;
+				while (status == RTUFramer::FRAME_INCOMPLETE)
+				{
+					n += std::min(chunkSize, framer.needed());
+					status = framer.update(response.data(), n);
+				}
+				if (status == RTUFramer::FRAME_COMPLETE) complete++;
+			}
+			sw.stop();
+			Poco::Timestamp::TimeDiff incrementalTime = sw.elapsed();
+
+			if (complete != 2*iterations) throw Poco::ProtocolException("framing failed");
+
+			std::cout << "chunk size " << chunkSize << ":" << std::endl;
+			std::cout << "  full recompute: " << fullTime << " [us], " << double(fullTime)/iterations << " [us/frame]" << std::endl;
+			std::cout << "  incremental:    " << incrementalTime << " [us], " << double(incrementalTime)/iterations << " [us/frame]" << std::endl;
+		}
+		std::cout << std::endl;
+	}
+
+	void benchmarkRoundTrip(int iterations, int baudRate)
+	{
+		Slave slave(baudRate);
+		Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort = new IoT::Serial::SerialPort(slave.device(), 115200, "8N1");
+
+		std::cout << "Round trips with " << REGISTER_COUNT << " registers, " << iterations << " iterations, ";
+		if (baudRate > 0)
+			std::cout << "paced at " << baudRate << " baud" << std::endl;
+		else
+			std::cout << "unpaced" << std::endl;
+		std::cout << "-------------------------------------------------" << std::endl;
+
+		// read until the line has been silent for the inter-character timeout
+		std::string request = readHoldingRegistersRequest();
+		char buffer[256];
+		Poco::Clock lastFrame;
+		Poco::Stopwatch sw;
+		sw.start();
+		for (int i = 0; i < iterations; i++)
+		{
+			Poco::Clock::ClockDiff remaining = FRAME_DELAY.totalMicroseconds() - lastFrame.elapsed();
+			if (remaining > 0) pSerialPort->poll(remaining);
+			pSerialPort->write(request.data(), request.size());
+			if (!pSerialPort->poll(Poco::Timespan(2, 0))) throw Poco::TimeoutException();
+			std::size_t n = 0;
+			bool frameComplete = false;
+			do
+			{
+				std::size_t rd = pSerialPort->read(buffer + n, sizeof(buffer) - n, INTER_CHAR_TIMEOUT);
+				if (rd == 0) break;
+				n += rd;
+				frameComplete = checkFrame(buffer, n);
+			}
+			while (!frameComplete && n < sizeof(buffer));
+			if (!frameComplete) throw Poco::ProtocolException("invalid frame");
+			lastFrame.update();
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff silenceTime = sw.elapsed();
+
+		// RTUPort with predicted frame length
+		IoT::Modbus::ModbusMasterImpl<RTUPort> master(new RTUPort(pSerialPort, INTER_CHAR_TIMEOUT));
+		sw.restart();
+		for (int i = 0; i < iterations; i++)
+		{
+			master.readHoldingRegisters(1, 0, REGISTER_COUNT);
+		}
+		sw.stop();
+		Poco::Timestamp::TimeDiff predictedTime = sw.elapsed();
+
+		std::cout << "  wait for silence: " << silenceTime << " [us], " << double(silenceTime)/iterations << " [us/request]" << std::endl;
+		std::cout << "  RTUPort:          " << predictedTime << " [us], " << double(predictedTime)/iterations << " [us/request]" << std::endl;
+		std::cout << std::endl;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	int iterations = 1000;
+	int baudRate = 115200;
+	if (argc > 1) iterations = Poco::NumberParser::parse(argv[1]);
+	if (argc > 2) baudRate = Poco::NumberParser::parse(argv[2]);
+
+	std::cout << "Modbus RTU Benchmark" << std::endl;
+	std::cout << "====================" << std::endl << std::endl;
+
+	try
+	{
+		benchmarkFraming(100*iterations);
+		benchmarkRoundTrip(iterations, baudRate);
+	}
+	catch (Poco::Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -19,12 +19,18 @@
 #include "Poco/OSP/PreferencesService.h"
 #include "Poco/RemotingNG/ORB.h"
 #include "IoT/Modbus/RTUPort.h"
+#include "IoT/Modbus/TCPPort.h"
 #include "IoT/Modbus/ModbusMasterImpl.h"
+#include "IoT/Modbus/ModbusScheduler.h"
 #include "IoT/Modbus/ModbusMasterServerHelper.h"
+#include "IoT/Modbus/ModbusPoller.h"
+#include "IoT/Devices/SensorServerHelper.h"
+#include "IoT/Devices/IOServerHelper.h"
 #include "IoT/Serial/SerialPort.h"
 #include "Poco/ClassLibrary.h"
 #include "Poco/Format.h"
 #include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
 #include <vector>
 
 
@@ -51,11 +57,25 @@ public:
 	{
 	}
 	
-	void createModbusRTUMaster(const std::string& uid, Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort, Poco::Timespan interCharTimeout)
+	Poco::SharedPtr<ModbusMaster> createScheduler(const std::string& baseKey, Poco::SharedPtr<ModbusMaster> pModbusMaster, int defaultWorkers)
+	{
+		if (!_pPrefs->configuration()->getBool(baseKey + ".scheduler.enable", true)) return pModbusMaster;
+
+		int workers = _pPrefs->configuration()->getInt(baseKey + ".scheduler.workers", defaultWorkers);
+		if (workers < 1) workers = 1;
+		Poco::UInt16 bulkThreshold = static_cast<Poco::UInt16>(_pPrefs->configuration()->getInt(baseKey + ".scheduler.bulkThreshold", ModbusScheduler::DEFAULT_BULK_THRESHOLD));
+		Poco::SharedPtr<ModbusScheduler> pScheduler = new ModbusScheduler(pModbusMaster, workers, bulkThreshold);
+		pScheduler->setDeadline(ModbusScheduler::PRIO_LOW,    Poco::Timespan::MILLISECONDS*_pPrefs->configuration()->getInt(baseKey + ".scheduler.deadline.low", 0));
+		pScheduler->setDeadline(ModbusScheduler::PRIO_NORMAL, Poco::Timespan::MILLISECONDS*_pPrefs->configuration()->getInt(baseKey + ".scheduler.deadline.normal", 0));
+		pScheduler->setDeadline(ModbusScheduler::PRIO_HIGH,   Poco::Timespan::MILLISECONDS*_pPrefs->configuration()->getInt(baseKey + ".scheduler.deadline.high", 0));
+		return pScheduler;
+	}
+
+	Poco::SharedPtr<ModbusMaster> createModbusRTUMaster(const std::string& uid, const std::string& baseKey, Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort, Poco::Timespan interCharTimeout)
 	{
 		typedef Poco::RemotingNG::ServerHelper<IoT::Modbus::ModbusMaster> ServerHelper;
 		
-		Poco::SharedPtr<ModbusMaster> pModbusMaster = new ModbusMasterImpl<RTUPort>(new RTUPort(pSerialPort, interCharTimeout));
+		Poco::SharedPtr<ModbusMaster> pModbusMaster = createScheduler(baseKey, new ModbusMasterImpl<RTUPort>(new RTUPort(pSerialPort, interCharTimeout)), 1);
 		std::string symbolicName = "io.macchina.modbus";
 		Poco::RemotingNG::Identifiable::ObjectId oid = symbolicName;
 		oid += '#';
@@ -68,8 +88,119 @@ public:
 		
 		ServiceRef::Ptr pServiceRef = _pContext->registry().registerService(oid, pModbusMasterRemoteObject, props);
 		_serviceRefs.push_back(pServiceRef);
+		return pModbusMaster;
 	}
 	
+	Poco::SharedPtr<ModbusMaster> createModbusTCPMaster(const std::string& uid, const std::string& baseKey, Poco::SharedPtr<TCPPort> pTCPPort, Poco::Timespan timeout, int maxPending)
+	{
+		typedef Poco::RemotingNG::ServerHelper<IoT::Modbus::ModbusMaster> ServerHelper;
+
+		Poco::SharedPtr<ModbusMaster> pModbusMaster = createScheduler(baseKey, new ModbusMasterImpl<TCPPort>(pTCPPort, timeout), maxPending);
+		std::string symbolicName = "io.macchina.modbus";
+		Poco::RemotingNG::Identifiable::ObjectId oid = symbolicName;
+		oid += ".tcp#";
+		oid += uid;
+		ServerHelper::RemoteObjectPtr pModbusMasterRemoteObject = ServerHelper::createRemoteObject(pModbusMaster, oid);
+
+		Properties props;
+		props.set("io.macchina.protocol", symbolicName);
+		props.set("io.macchina.modbus.hostAddress", pTCPPort->address().toString());
+
+		ServiceRef::Ptr pServiceRef = _pContext->registry().registerService(oid, pModbusMasterRemoteObject, props);
+		_serviceRefs.push_back(pServiceRef);
+		return pModbusMaster;
+	}
+
+	static Poco::UInt8 parseFunction(const std::string& function)
+	{
+		if (function == "coils")
+			return MODBUS_READ_COILS;
+		else if (function == "discreteInputs")
+			return MODBUS_READ_DISCRETE_INPUTS;
+		else if (function == "holdingRegisters")
+			return MODBUS_READ_HOLDING_REGISTERS;
+		else if (function == "inputRegisters")
+			return MODBUS_READ_INPUT_REGISTERS;
+		else
+			throw Poco::InvalidArgumentException("function", function);
+	}
+
+	void createPoller(const std::string& baseKey, Poco::SharedPtr<ModbusMaster> pModbusMaster)
+	{
+		typedef Poco::RemotingNG::ServerHelper<IoT::Devices::Sensor> SensorServerHelper;
+		typedef Poco::RemotingNG::ServerHelper<IoT::Devices::IO> IOServerHelper;
+
+		Poco::Util::AbstractConfiguration::Keys pointKeys;
+		_pPrefs->configuration()->keys(baseKey + ".points", pointKeys);
+		if (pointKeys.empty()) return;
+
+		long defaultPeriod = _pPrefs->configuration()->getInt(baseKey + ".polling.period", 1000);
+		std::vector<PointDefinition> points;
+		for (std::vector<std::string>::const_iterator it = pointKeys.begin(); it != pointKeys.end(); ++it)
+		{
+			std::string pointKey = baseKey + ".points." + *it;
+
+			PointDefinition point;
+			point.functionCode = parseFunction(_pPrefs->configuration()->getString(pointKey + ".function", "holdingRegisters"));
+			bool bits = point.functionCode == MODBUS_READ_COILS || point.functionCode == MODBUS_READ_DISCRETE_INPUTS;
+			point.type = PointDefinition::parseType(_pPrefs->configuration()->getString(pointKey + ".type", bits ? "bool" : "uint16"));
+			point.id = _pPrefs->configuration()->getString(pointKey + ".id", (bits ? ModbusIO::SYMBOLIC_NAME : ModbusSensor::SYMBOLIC_NAME) + "#" + *it);
+			point.slaveAddress     = static_cast<Poco::UInt8>(_pPrefs->configuration()->getInt(pointKey + ".slave", 1));
+			point.address          = static_cast<Poco::UInt16>(_pPrefs->configuration()->getInt(pointKey + ".address"));
+			point.swapWords        = _pPrefs->configuration()->getBool(pointKey + ".swapWords", false);
+			point.scale            = _pPrefs->configuration()->getDouble(pointKey + ".scale", 1.0);
+			point.offset           = _pPrefs->configuration()->getDouble(pointKey + ".offset", 0.0);
+			point.period           = _pPrefs->configuration()->getInt(pointKey + ".period", defaultPeriod);
+			point.physicalQuantity = _pPrefs->configuration()->getString(pointKey + ".physicalQuantity", "");
+			point.physicalUnit     = _pPrefs->configuration()->getString(pointKey + ".physicalUnit", "");
+			points.push_back(point);
+		}
+
+		PollingPlan plan(points,
+			static_cast<Poco::UInt16>(_pPrefs->configuration()->getInt(baseKey + ".polling.maxGap", 0)),
+			static_cast<Poco::UInt16>(_pPrefs->configuration()->getInt(baseKey + ".polling.maxRegisters", PollingPlan::MAX_READ_REGISTERS)),
+			static_cast<Poco::UInt16>(_pPrefs->configuration()->getInt(baseKey + ".polling.maxBits", PollingPlan::MAX_READ_BITS)));
+		_pContext->logger().information(Poco::format("Polling %z Modbus points with %z requests.", points.size(), plan.requests().size()));
+
+		Poco::SharedPtr<ModbusPoller> pPoller = new ModbusPoller(pModbusMaster, plan);
+		for (std::size_t i = 0; i < points.size(); i++)
+		{
+			const PointDefinition& point = points[i];
+			std::string pointKey = baseKey + ".points." + pointKeys[i];
+
+			Properties props;
+			Poco::RemotingNG::Identifiable::ObjectId oid = point.id;
+			ServiceRef::Ptr pServiceRef;
+			if (point.type == PointDefinition::TYPE_BOOL)
+			{
+				IOServerHelper::RemoteObjectPtr pIORemoteObject = IOServerHelper::createRemoteObject(pPoller->io(i), oid);
+
+				props.set("io.macchina.device", ModbusIO::SYMBOLIC_NAME);
+				pServiceRef = _pContext->registry().registerService(oid, pIORemoteObject, props);
+			}
+			else
+			{
+				Poco::SharedPtr<ModbusSensor> pSensor = pPoller->sensor(i);
+				if (_pPrefs->configuration()->has(pointKey + ".valueChangedDelta"))
+					pSensor->setPropertyDouble("valueChangedDelta", _pPrefs->configuration()->getDouble(pointKey + ".valueChangedDelta"));
+				if (_pPrefs->configuration()->has(pointKey + ".valueChangedPeriod"))
+					pSensor->setPropertyInt("valueChangedPeriod", _pPrefs->configuration()->getInt(pointKey + ".valueChangedPeriod"));
+
+				SensorServerHelper::RemoteObjectPtr pSensorRemoteObject = SensorServerHelper::createRemoteObject(pSensor, oid);
+
+				props.set("io.macchina.device", ModbusSensor::SYMBOLIC_NAME);
+				if (!point.physicalQuantity.empty())
+				{
+					props.set("io.macchina.physicalQuantity", point.physicalQuantity);
+				}
+				pServiceRef = _pContext->registry().registerService(oid, pSensorRemoteObject, props);
+			}
+			_serviceRefs.push_back(pServiceRef);
+		}
+		pPoller->start();
+		_pollers.push_back(pPoller);
+	}
+
 	void start(BundleContext::Ptr pContext)
 	{
 		_pContext = pContext;
@@ -112,7 +243,8 @@ public:
 					pSerialPort->configureRS485(rs485Params);
 				}
 								
-				createModbusRTUMaster(Poco::NumberFormatter::format(index), pSerialPort, interCharTimeout);
+				Poco::SharedPtr<ModbusMaster> pModbusMaster = createModbusRTUMaster(Poco::NumberFormatter::format(index), baseKey, pSerialPort, interCharTimeout);
+				createPoller(baseKey, pModbusMaster);
 			}
 			catch (Poco::Exception& exc)
 			{
@@ -120,15 +252,60 @@ public:
 			}
 			index++;
 		}
+
+		keys.clear();
+		_pPrefs->configuration()->keys("modbus.tcp", keys);
+		index = 0;
+		for (std::vector<std::string>::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		{
+			std::string baseKey = "modbus.tcp.";
+			baseKey += *it;
+
+			std::string hostAddress = _pPrefs->configuration()->getString(baseKey + ".hostAddress", "");
+			Poco::UInt16 port = static_cast<Poco::UInt16>(_pPrefs->configuration()->getInt(baseKey + ".port", TCPPort::MODBUS_TCP_PORT));
+			Poco::Timespan connectTimeout = Poco::Timespan::MILLISECONDS*_pPrefs->configuration()->getInt(baseKey + ".connectTimeout", 5000);
+			Poco::Timespan timeout = Poco::Timespan::MILLISECONDS*_pPrefs->configuration()->getInt(baseKey + ".timeout", 2000);
+			int maxPending = _pPrefs->configuration()->getInt(baseKey + ".maxPendingRequests", TCPPort::DEFAULT_MAX_PENDING);
+
+			try
+			{
+				pContext->logger().information(Poco::format("Creating Modbus TCP port for '%s'.", hostAddress));
+
+				Poco::SharedPtr<TCPPort> pTCPPort = new TCPPort(Poco::Net::SocketAddress(hostAddress, port), connectTimeout, maxPending);
+				pTCPPort->setFrameTimeout(timeout);
+
+				Poco::Util::AbstractConfiguration::Keys unitKeys;
+				_pPrefs->configuration()->keys(baseKey + ".unitTimeouts", unitKeys);
+				for (std::vector<std::string>::const_iterator itUnit = unitKeys.begin(); itUnit != unitKeys.end(); ++itUnit)
+				{
+					unsigned unitId = Poco::NumberParser::parseUnsigned(*itUnit);
+					if (unitId > 255) throw Poco::InvalidArgumentException("unit identifier", *itUnit);
+					pTCPPort->setUnitTimeout(static_cast<Poco::UInt8>(unitId), Poco::Timespan::MILLISECONDS*_pPrefs->configuration()->getInt(baseKey + ".unitTimeouts." + *itUnit));
+				}
+
+				Poco::SharedPtr<ModbusMaster> pModbusMaster = createModbusTCPMaster(Poco::NumberFormatter::format(index), baseKey, pTCPPort, timeout, maxPending);
+				createPoller(baseKey, pModbusMaster);
+			}
+			catch (Poco::Exception& exc)
+			{
+				pContext->logger().error(Poco::format("Cannot create Modbus TCP port for '%s': %s", hostAddress, exc.displayText()));
+			}
+			index++;
+		}
 	}
 		
 	void stop(BundleContext::Ptr pContext)
 	{
+		for (std::vector<Poco::SharedPtr<ModbusPoller> >::iterator it = _pollers.begin(); it != _pollers.end(); ++it)
+		{
+			(*it)->stop();
+		}
 		for (std::vector<ServiceRef::Ptr>::iterator it = _serviceRefs.begin(); it != _serviceRefs.end(); ++it)
 		{
 			_pContext->registry().unregisterService(*it);
 		}
 		_serviceRefs.clear();
+		_pollers.clear();
 		_pPrefs = 0;
 		_pContext = 0;
 	}
@@ -137,6 +314,7 @@ private:
 	BundleContext::Ptr _pContext;
 	PreferencesService::Ptr _pPrefs;
 	std::vector<ServiceRef::Ptr> _serviceRefs;
+	std::vector<Poco::SharedPtr<ModbusPoller> > _pollers;
 };
 
 
@@ -0,0 +1,114 @@
+//
+// ModbusIO.cpp
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: Polling
+// Module:  ModbusIO
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Modbus/ModbusIO.h"
+#include "IoT/Devices/DeviceException.h"
+
+
+namespace IoT {
+namespace Modbus {
+
+
+const std::string ModbusIO::NAME("Modbus IO");
+const std::string ModbusIO::SYMBOLIC_NAME("io.macchina.modbus.io");
+
+
+ModbusIO::ModbusIO(const PointDefinition& point, Poco::SharedPtr<ModbusMaster> pMaster):
+	_pMaster(pMaster),
+	_slaveAddress(point.slaveAddress),
+	_address(point.address),
+	_output(point.functionCode == MODBUS_READ_COILS),
+	_state(false),
+	_valid(false),
+	_deviceIdentifier(point.id),
+	_symbolicName(SYMBOLIC_NAME),
+	_name(NAME)
+{
+	addProperty("displayState", &ModbusIO::getDisplayState);
+	addProperty("direction", &ModbusIO::getDirection);
+	addProperty("deviceIdentifier", &ModbusIO::getDeviceIdentifier);
+	addProperty("symbolicName", &ModbusIO::getSymbolicName);
+	addProperty("name", &ModbusIO::getName);
+}
+
+
+ModbusIO::~ModbusIO()
+{
+}
+
+
+void ModbusIO::update(bool state)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	bool wasValid = _valid;
+	_valid = true;
+	if (_state != state || !wasValid)
+	{
+		_state = state;
+		stateChanged(this, state);
+	}
+}
+
+
+bool ModbusIO::state() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _state;
+}
+
+
+void ModbusIO::set(bool state)
+{
+	if (!_output) throw IoT::Devices::NotWritableException("Discrete inputs are read-only", Poco::AnyCast<std::string>(_deviceIdentifier));
+
+	_pMaster->writeSingleCoil(_slaveAddress, _address, state);
+	update(state);
+}
+
+
+Poco::Any ModbusIO::getDisplayState(const std::string&) const
+{
+	return std::string(state() ? "1" : "0");
+}
+
+
+Poco::Any ModbusIO::getDirection(const std::string&) const
+{
+	return std::string(_output ? "out" : "in");
+}
+
+
+Poco::Any ModbusIO::getDeviceIdentifier(const std::string&) const
+{
+	return _deviceIdentifier;
+}
+
+
+Poco::Any ModbusIO::getName(const std::string&) const
+{
+	return _name;
+}
+
+
+Poco::Any ModbusIO::getSymbolicName(const std::string&) const
+{
+	return _symbolicName;
+}
+
+
+} } // namespace IoT::Modbus
@@ -0,0 +1,236 @@
+//
+// ModbusPoller.cpp
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: Polling
+// Module:  ModbusPoller
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Modbus/ModbusPoller.h"
+#include "IoT/Modbus/ModbusException.h"
+#include "IoT/Modbus/ModbusScheduler.h"
+#include "Poco/Util/TimerTask.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <cstring>
+
+
+namespace IoT {
+namespace Modbus {
+
+
+class ModbusPoller::PollTask: public Poco::Util::TimerTask
+{
+public:
+	PollTask(ModbusPoller& poller, const std::vector<std::size_t>& requests):
+		_poller(poller),
+		_requests(requests)
+	{
+	}
+
+	void run()
+	{
+		_poller.pollCycle(_requests);
+	}
+
+private:
+	ModbusPoller& _poller;
+	const std::vector<std::size_t>& _requests;
+};
+
+
+ModbusPoller::ModbusPoller(Poco::SharedPtr<ModbusMaster> pMaster, const PollingPlan& plan):
+	_pMaster(pMaster),
+	_plan(plan)
+{
+	const std::vector<PointDefinition>& points = _plan.points();
+	_sensors.resize(points.size());
+	_ios.resize(points.size());
+	for (std::size_t i = 0; i < points.size(); i++)
+	{
+		if (points[i].type == PointDefinition::TYPE_BOOL)
+			_ios[i] = new ModbusIO(points[i], _pMaster);
+		else
+			_sensors[i] = new ModbusSensor(points[i], _eventTimer);
+	}
+
+	// Requests are ordered by slave address and polling period,
+	// so all requests of a cycle are consecutive.
+	const std::vector<PollRequest>& requests = _plan.requests();
+	for (std::size_t i = 0; i < requests.size(); i++)
+	{
+		if (i == 0 || requests[i].slaveAddress != requests[i - 1].slaveAddress || requests[i].period != requests[i - 1].period)
+		{
+			_cycles.push_back(std::vector<std::size_t>());
+		}
+		_cycles.back().push_back(i);
+	}
+}
+
+
+ModbusPoller::~ModbusPoller()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void ModbusPoller::start()
+{
+	const std::vector<PollRequest>& requests = _plan.requests();
+	for (std::vector<std::vector<std::size_t> >::const_iterator it = _cycles.begin(); it != _cycles.end(); ++it)
+	{
+		long period = requests[it->front()].period;
+		_pollTimer.scheduleAtFixedRate(new PollTask(*this, *it), 0, period);
+	}
+}
+
+
+void ModbusPoller::stop()
+{
+	_pollTimer.cancel(true);
+}
+
+
+void ModbusPoller::poll()
+{
+	for (std::vector<std::vector<std::size_t> >::const_iterator it = _cycles.begin(); it != _cycles.end(); ++it)
+	{
+		pollCycle(*it);
+	}
+}
+
+
+void ModbusPoller::pollCycle(const std::vector<std::size_t>& requests)
+{
+	// If the master is shared through a ModbusScheduler, polling has low
+	// priority, and requests not started within the polling period are dropped.
+	long period = _plan.requests()[requests.front()].period;
+	ModbusScheduler::ScopedPriority priority(ModbusScheduler::PRIO_LOW, Poco::Timespan::MILLISECONDS*period);
+
+	bool responding = true;
+	for (std::vector<std::size_t>::const_iterator it = requests.begin(); it != requests.end(); ++it)
+	{
+		const PollRequest& request = _plan.requests()[*it];
+		if (responding)
+		{
+			++_requests;
+			try
+			{
+				pollRequest(request);
+				continue;
+			}
+			catch (ModbusException&)
+			{
+				// the slave responded; only this request is affected
+			}
+			catch (Poco::Exception&)
+			{
+				responding = false;
+			}
+		}
+		++_failedRequests;
+		invalidate(request);
+	}
+}
+
+
+void ModbusPoller::pollRequest(const PollRequest& request)
+{
+	const std::vector<PointDefinition>& points = _plan.points();
+	switch (request.functionCode)
+	{
+	case MODBUS_READ_COILS:
+	case MODBUS_READ_DISCRETE_INPUTS:
+		{
+			std::vector<bool> bits;
+			if (request.functionCode == MODBUS_READ_COILS)
+				bits = _pMaster->readCoils(request.slaveAddress, request.startingAddress, request.quantity);
+			else
+				bits = _pMaster->readDiscreteInputs(request.slaveAddress, request.startingAddress, request.quantity);
+			if (bits.size() < request.quantity) throw Poco::ProtocolException("Modbus response contains fewer bits than requested");
+
+			for (std::vector<std::size_t>::const_iterator it = request.points.begin(); it != request.points.end(); ++it)
+			{
+				_ios[*it]->update(bits[points[*it].address - request.startingAddress]);
+			}
+		}
+		break;
+
+	case MODBUS_READ_HOLDING_REGISTERS:
+	case MODBUS_READ_INPUT_REGISTERS:
+		{
+			std::vector<Poco::UInt16> registers;
+			if (request.functionCode == MODBUS_READ_HOLDING_REGISTERS)
+				registers = _pMaster->readHoldingRegisters(request.slaveAddress, request.startingAddress, request.quantity);
+			else
+				registers = _pMaster->readInputRegisters(request.slaveAddress, request.startingAddress, request.quantity);
+			if (registers.size() < request.quantity) throw Poco::ProtocolException("Modbus response contains fewer registers than requested");
+
+			for (std::vector<std::size_t>::const_iterator it = request.points.begin(); it != request.points.end(); ++it)
+			{
+				const PointDefinition& point = points[*it];
+				_sensors[*it]->update(decode(point, registers, point.address - request.startingAddress));
+			}
+		}
+		break;
+	}
+}
+
+
+void ModbusPoller::invalidate(const PollRequest& request)
+{
+	for (std::vector<std::size_t>::const_iterator it = request.points.begin(); it != request.points.end(); ++it)
+	{
+		if (_sensors[*it]) _sensors[*it]->invalidate();
+	}
+}
+
+
+double ModbusPoller::decode(const PointDefinition& point, const std::vector<Poco::UInt16>& registers, std::size_t index)
+{
+	double raw;
+	if (point.width() == 1)
+	{
+		if (point.type == PointDefinition::TYPE_INT16)
+			raw = static_cast<Poco::Int16>(registers[index]);
+		else
+			raw = registers[index];
+	}
+	else
+	{
+		Poco::UInt32 high = registers[index];
+		Poco::UInt32 low  = registers[index + 1];
+		if (point.swapWords) std::swap(high, low);
+		Poco::UInt32 value = (high << 16) | low;
+		if (point.type == PointDefinition::TYPE_INT32)
+		{
+			raw = static_cast<Poco::Int32>(value);
+		}
+		else if (point.type == PointDefinition::TYPE_FLOAT32)
+		{
+			float f;
+			std::memcpy(&f, &value, sizeof(f));
+			raw = f;
+		}
+		else raw = value;
+	}
+	return raw*point.scale + point.offset;
+}
+
+
+} } // namespace IoT::Modbus
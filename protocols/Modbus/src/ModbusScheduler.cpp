@@ -0,0 +1,547 @@
+//
+// ModbusScheduler.cpp
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: ModbusMaster
+// Module:  ModbusScheduler
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Modbus/ModbusScheduler.h"
+#include "Poco/ThreadLocal.h"
+#include "Poco/ScopedUnlock.h"
+#include "Poco/Exception.h"
+
+
+namespace IoT {
+namespace Modbus {
+
+
+namespace
+{
+	struct PriorityContext
+	{
+		PriorityContext():
+			set(false),
+			priority(ModbusScheduler::PRIO_NORMAL)
+		{
+		}
+
+		bool set;
+		ModbusScheduler::Priority priority;
+		Poco::Timespan deadline;
+	};
+
+	Poco::ThreadLocal<PriorityContext> priorityContext;
+}
+
+
+//
+// ModbusScheduler::PriorityStatistics
+//
+
+
+ModbusScheduler::PriorityStatistics::PriorityStatistics():
+	requests(0),
+	transactions(0),
+	coalesced(0),
+	expired(0),
+	totalWaitTime(0),
+	maxWaitTime(0)
+{
+}
+
+
+//
+// ModbusScheduler::Statistics
+//
+
+
+ModbusScheduler::Statistics::Statistics():
+	queueDepth(0),
+	maxQueueDepth(0)
+{
+}
+
+
+//
+// ModbusScheduler::ScopedPriority
+//
+
+
+ModbusScheduler::ScopedPriority::ScopedPriority(Priority priority, const Poco::Timespan& deadline):
+	_set(priorityContext->set),
+	_priority(priorityContext->priority),
+	_deadline(priorityContext->deadline)
+{
+	priorityContext->set = true;
+	priorityContext->priority = priority;
+	priorityContext->deadline = deadline;
+}
+
+
+ModbusScheduler::ScopedPriority::~ScopedPriority()
+{
+	priorityContext->set = _set;
+	priorityContext->priority = _priority;
+	priorityContext->deadline = _deadline;
+}
+
+
+//
+// ModbusScheduler
+//
+
+
+ModbusScheduler::ModbusScheduler(Poco::SharedPtr<ModbusMaster> pMaster, int workers, Poco::UInt16 bulkThreshold):
+	_pMaster(pMaster),
+	_bulkThreshold(bulkThreshold),
+	_sequence(0),
+	_stopped(false)
+{
+	poco_check_ptr (pMaster);
+	poco_assert (workers > 0);
+
+	for (int i = 0; i < workers; i++)
+	{
+		Poco::SharedPtr<Poco::Thread> pThread = new Poco::Thread("ModbusScheduler");
+		pThread->start(*this);
+		_workers.push_back(pThread);
+	}
+}
+
+
+ModbusScheduler::~ModbusScheduler()
+{
+	try
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+
+			_stopped = true;
+			for (Queue::iterator it = _queue.begin(); it != _queue.end(); ++it)
+			{
+				it->second->pException = new Poco::IllegalStateException("Modbus scheduler has been stopped");
+				it->second->state = Transaction::TX_DONE;
+			}
+			_queue.clear();
+			_reads.clear();
+			_statistics.queueDepth = 0;
+			_queued.broadcast();
+			_done.broadcast();
+		}
+		for (std::vector<Poco::SharedPtr<Poco::Thread> >::iterator it = _workers.begin(); it != _workers.end(); ++it)
+		{
+			(*it)->join();
+		}
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void ModbusScheduler::setDeadline(Priority priority, const Poco::Timespan& deadline)
+{
+	poco_assert (priority >= PRIO_LOW && priority <= PRIO_HIGH);
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_deadlines[priority] = deadline;
+}
+
+
+Poco::Timespan ModbusScheduler::getDeadline(Priority priority) const
+{
+	poco_assert (priority >= PRIO_LOW && priority <= PRIO_HIGH);
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _deadlines[priority];
+}
+
+
+ModbusScheduler::Statistics ModbusScheduler::statistics() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _statistics;
+}
+
+
+void ModbusScheduler::resetStatistics()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	std::size_t queueDepth = _statistics.queueDepth;
+	_statistics = Statistics();
+	_statistics.queueDepth = queueDepth;
+	_statistics.maxQueueDepth = queueDepth;
+}
+
+
+void ModbusScheduler::sendRequest(const GenericMessage& message)
+{
+	_pMaster->sendRequest(message);
+}
+
+
+void ModbusScheduler::sendReadCoilsRequest(const ReadCoilsRequest& request)
+{
+	_pMaster->sendReadCoilsRequest(request);
+}
+
+
+void ModbusScheduler::sendReadDiscreteInputsRequest(const ReadDiscreteInputsRequest& request)
+{
+	_pMaster->sendReadDiscreteInputsRequest(request);
+}
+
+
+void ModbusScheduler::sendReadHoldingRegistersRequest(const ReadHoldingRegistersRequest& request)
+{
+	_pMaster->sendReadHoldingRegistersRequest(request);
+}
+
+
+void ModbusScheduler::sendReadInputRegistersRequest(const ReadInputRegistersRequest& request)
+{
+	_pMaster->sendReadInputRegistersRequest(request);
+}
+
+
+void ModbusScheduler::sendWriteSingleCoilRequest(const WriteSingleCoilRequest& request)
+{
+	_pMaster->sendWriteSingleCoilRequest(request);
+}
+
+
+void ModbusScheduler::sendWriteSingleRegisterRequest(const WriteSingleRegisterRequest& request)
+{
+	_pMaster->sendWriteSingleRegisterRequest(request);
+}
+
+
+void ModbusScheduler::sendReadExceptionStatusRequest(const ReadExceptionStatusRequest& request)
+{
+	_pMaster->sendReadExceptionStatusRequest(request);
+}
+
+
+void ModbusScheduler::sendWriteMultipleCoilsRequest(const WriteMultipleCoilsRequest& request)
+{
+	_pMaster->sendWriteMultipleCoilsRequest(request);
+}
+
+
+void ModbusScheduler::sendWriteMultipleRegistersRequest(const WriteMultipleRegistersRequest& request)
+{
+	_pMaster->sendWriteMultipleRegistersRequest(request);
+}
+
+
+void ModbusScheduler::sendMaskWriteRegisterRequest(const MaskWriteRegisterRequest& request)
+{
+	_pMaster->sendMaskWriteRegisterRequest(request);
+}
+
+
+void ModbusScheduler::sendReadWriteMultipleRegistersRequest(const ReadWriteMultipleRegistersRequest& request)
+{
+	_pMaster->sendReadWriteMultipleRegistersRequest(request);
+}
+
+
+void ModbusScheduler::sendReadFIFOQueueRequest(const ReadFIFOQueueRequest& request)
+{
+	_pMaster->sendReadFIFOQueueRequest(request);
+}
+
+
+std::vector<bool> ModbusScheduler::readCoils(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfCoils)
+{
+	return execute(MODBUS_READ_COILS, slaveAddress, startingAddress, nOfCoils)->bits;
+}
+
+
+std::vector<bool> ModbusScheduler::readDiscreteInputs(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfInputs)
+{
+	return execute(MODBUS_READ_DISCRETE_INPUTS, slaveAddress, startingAddress, nOfInputs)->bits;
+}
+
+
+std::vector<Poco::UInt16> ModbusScheduler::readHoldingRegisters(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfRegisters)
+{
+	return execute(MODBUS_READ_HOLDING_REGISTERS, slaveAddress, startingAddress, nOfRegisters)->registers;
+}
+
+
+std::vector<Poco::UInt16> ModbusScheduler::readInputRegisters(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfRegisters)
+{
+	return execute(MODBUS_READ_INPUT_REGISTERS, slaveAddress, startingAddress, nOfRegisters)->registers;
+}
+
+
+void ModbusScheduler::writeSingleCoil(Poco::UInt8 slaveAddress, Poco::UInt16 outputAddress, bool value)
+{
+	execute(MODBUS_WRITE_SINGLE_COIL, slaveAddress, outputAddress, value ? 1 : 0);
+}
+
+
+void ModbusScheduler::writeSingleRegister(Poco::UInt8 slaveAddress, Poco::UInt16 outputAddress, Poco::UInt16 value)
+{
+	execute(MODBUS_WRITE_SINGLE_REGISTER, slaveAddress, outputAddress, value);
+}
+
+
+Poco::UInt8 ModbusScheduler::readExceptionStatus(Poco::UInt8 slaveAddress)
+{
+	return execute(MODBUS_READ_EXCEPTION_STATUS, slaveAddress, 0, 0)->exceptionStatus;
+}
+
+
+void ModbusScheduler::run()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	while (!_stopped)
+	{
+		if (_queue.empty())
+		{
+			_queued.wait(_mutex);
+			continue;
+		}
+
+		TransactionPtr pTransaction = _queue.begin()->second;
+		_queue.erase(_queue.begin());
+		_statistics.queueDepth = _queue.size();
+
+		PriorityStatistics& stats = _statistics.priorities[pTransaction->priority];
+		if (pTransaction->hasDeadline && pTransaction->deadline.isElapsed(0))
+		{
+			stats.expired += pTransaction->waiters;
+			pTransaction->pException = new Poco::TimeoutException("Modbus request deadline expired");
+			complete(pTransaction);
+			continue;
+		}
+
+		pTransaction->state = Transaction::TX_RUNNING;
+		Poco::UInt64 waitTime = static_cast<Poco::UInt64>(pTransaction->enqueued.elapsed());
+		stats.transactions++;
+		stats.totalWaitTime += waitTime;
+		if (waitTime > stats.maxWaitTime) stats.maxWaitTime = waitTime;
+		{
+			Poco::ScopedUnlock<Poco::FastMutex> unlock(_mutex);
+			perform(*pTransaction);
+		}
+		complete(pTransaction);
+	}
+}
+
+
+ModbusScheduler::TransactionPtr ModbusScheduler::execute(Poco::UInt8 functionCode, Poco::UInt8 slaveAddress, Poco::UInt16 address, Poco::UInt16 quantityOrValue)
+{
+	const PriorityContext& context = *priorityContext;
+	Priority priority = context.set ? context.priority : defaultPriority(functionCode, quantityOrValue);
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_stopped) throw Poco::IllegalStateException("Modbus scheduler has been stopped");
+
+	Poco::Timespan deadlineSpan = (context.set && context.deadline > 0) ? context.deadline : _deadlines[priority];
+	bool hasDeadline = deadlineSpan > 0;
+	Poco::Clock deadline;
+	deadline += deadlineSpan.totalMicroseconds();
+
+	TransactionPtr pTransaction = enqueue(functionCode, slaveAddress, address, quantityOrValue, priority, hasDeadline, deadline);
+	while (pTransaction->state != Transaction::TX_DONE)
+	{
+		if (hasDeadline && pTransaction->state == Transaction::TX_QUEUED)
+		{
+			Poco::Clock::ClockDiff remaining = -deadline.elapsed();
+			long milliseconds = remaining > 0 ? static_cast<long>((remaining + 999)/1000) : 0;
+			if ((milliseconds == 0 || !_done.tryWait(_mutex, milliseconds)) && pTransaction->state == Transaction::TX_QUEUED)
+			{
+				_statistics.priorities[priority].expired++;
+				if (--pTransaction->waiters == 0) dequeue(pTransaction);
+				throw Poco::TimeoutException("Modbus request deadline expired");
+			}
+		}
+		else _done.wait(_mutex);
+	}
+	pTransaction->waiters--;
+	if (pTransaction->pException) pTransaction->pException->rethrow();
+	return pTransaction;
+}
+
+
+ModbusScheduler::TransactionPtr ModbusScheduler::enqueue(Poco::UInt8 functionCode, Poco::UInt8 slaveAddress, Poco::UInt16 address, Poco::UInt16 quantityOrValue, Priority priority, bool hasDeadline, const Poco::Clock& deadline)
+{
+	_statistics.priorities[priority].requests++;
+
+	TransactionPtr pTransaction = new Transaction;
+	pTransaction->functionCode = functionCode;
+	pTransaction->slaveAddress = slaveAddress;
+	pTransaction->address = address;
+	pTransaction->quantityOrValue = quantityOrValue;
+	pTransaction->priority = priority;
+	pTransaction->sequence = _sequence++;
+	pTransaction->hasDeadline = hasDeadline;
+	pTransaction->deadline = deadline;
+	pTransaction->waiters = 1;
+	pTransaction->state = Transaction::TX_QUEUED;
+	pTransaction->exceptionStatus = 0;
+
+	if (isRead(functionCode))
+	{
+		ReadMap::iterator it = _reads.find(readKey(*pTransaction));
+		if (it != _reads.end())
+		{
+			TransactionPtr pExisting = it->second;
+			pExisting->waiters++;
+			_statistics.priorities[priority].coalesced++;
+			if (pExisting->state == Transaction::TX_QUEUED)
+			{
+				if (priority > pExisting->priority)
+				{
+					_queue.erase(queueKey(*pExisting));
+					pExisting->priority = priority;
+					_queue[queueKey(*pExisting)] = pExisting;
+				}
+				// the transaction is kept in the queue as long as one of its waiters is waiting
+				if (!hasDeadline)
+					pExisting->hasDeadline = false;
+				else if (pExisting->hasDeadline && pExisting->deadline < deadline)
+					pExisting->deadline = deadline;
+			}
+			return pExisting;
+		}
+		_reads[readKey(*pTransaction)] = pTransaction;
+	}
+
+	_queue[queueKey(*pTransaction)] = pTransaction;
+	_statistics.queueDepth = _queue.size();
+	if (_statistics.queueDepth > _statistics.maxQueueDepth) _statistics.maxQueueDepth = _statistics.queueDepth;
+	_queued.signal();
+	return pTransaction;
+}
+
+
+void ModbusScheduler::dequeue(const TransactionPtr& pTransaction)
+{
+	_queue.erase(queueKey(*pTransaction));
+	_statistics.queueDepth = _queue.size();
+	if (isRead(pTransaction->functionCode))
+	{
+		ReadMap::iterator it = _reads.find(readKey(*pTransaction));
+		if (it != _reads.end() && it->second == pTransaction) _reads.erase(it);
+	}
+}
+
+
+void ModbusScheduler::perform(Transaction& transaction)
+{
+	try
+	{
+		switch (transaction.functionCode)
+		{
+		case MODBUS_READ_COILS:
+			transaction.bits = _pMaster->readCoils(transaction.slaveAddress, transaction.address, transaction.quantityOrValue);
+			break;
+		case MODBUS_READ_DISCRETE_INPUTS:
+			transaction.bits = _pMaster->readDiscreteInputs(transaction.slaveAddress, transaction.address, transaction.quantityOrValue);
+			break;
+		case MODBUS_READ_HOLDING_REGISTERS:
+			transaction.registers = _pMaster->readHoldingRegisters(transaction.slaveAddress, transaction.address, transaction.quantityOrValue);
+			break;
+		case MODBUS_READ_INPUT_REGISTERS:
+			transaction.registers = _pMaster->readInputRegisters(transaction.slaveAddress, transaction.address, transaction.quantityOrValue);
+			break;
+		case MODBUS_WRITE_SINGLE_COIL:
+			_pMaster->writeSingleCoil(transaction.slaveAddress, transaction.address, transaction.quantityOrValue != 0);
+			break;
+		case MODBUS_WRITE_SINGLE_REGISTER:
+			_pMaster->writeSingleRegister(transaction.slaveAddress, transaction.address, transaction.quantityOrValue);
+			break;
+		case MODBUS_READ_EXCEPTION_STATUS:
+			transaction.exceptionStatus = _pMaster->readExceptionStatus(transaction.slaveAddress);
+			break;
+		default:
+			poco_bugcheck();
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		transaction.pException = exc.clone();
+	}
+	catch (std::exception& exc)
+	{
+		transaction.pException = new Poco::SystemException(exc.what());
+	}
+}
+
+
+void ModbusScheduler::complete(TransactionPtr pTransaction)
+{
+	pTransaction->state = Transaction::TX_DONE;
+	if (isRead(pTransaction->functionCode))
+	{
+		ReadMap::iterator it = _reads.find(readKey(*pTransaction));
+		if (it != _reads.end() && it->second == pTransaction) _reads.erase(it);
+	}
+	_done.broadcast();
+}
+
+
+ModbusScheduler::Priority ModbusScheduler::defaultPriority(Poco::UInt8 functionCode, Poco::UInt16 quantity) const
+{
+	switch (functionCode)
+	{
+	case MODBUS_WRITE_SINGLE_COIL:
+	case MODBUS_WRITE_SINGLE_REGISTER:
+		return PRIO_HIGH;
+	case MODBUS_READ_COILS:
+	case MODBUS_READ_DISCRETE_INPUTS:
+	case MODBUS_READ_HOLDING_REGISTERS:
+	case MODBUS_READ_INPUT_REGISTERS:
+		return quantity > _bulkThreshold ? PRIO_LOW : PRIO_NORMAL;
+	default:
+		return PRIO_NORMAL;
+	}
+}
+
+
+ModbusScheduler::QueueKey ModbusScheduler::queueKey(const Transaction& transaction)
+{
+	// higher priorities first, then in order of submission
+	return QueueKey(PRIO_HIGH - transaction.priority, transaction.sequence);
+}
+
+
+Poco::UInt64 ModbusScheduler::readKey(const Transaction& transaction)
+{
+	return (static_cast<Poco::UInt64>(transaction.functionCode) << 48)
+		| (static_cast<Poco::UInt64>(transaction.slaveAddress) << 32)
+		| (static_cast<Poco::UInt64>(transaction.address) << 16)
+		| transaction.quantityOrValue;
+}
+
+
+bool ModbusScheduler::isRead(Poco::UInt8 functionCode)
+{
+	return functionCode == MODBUS_READ_COILS
+		|| functionCode == MODBUS_READ_DISCRETE_INPUTS
+		|| functionCode == MODBUS_READ_HOLDING_REGISTERS
+		|| functionCode == MODBUS_READ_INPUT_REGISTERS;
+}
+
+
+} } // namespace IoT::Modbus
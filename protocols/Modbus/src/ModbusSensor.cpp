@@ -0,0 +1,188 @@
+//
+// ModbusSensor.cpp
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: Polling
+// Module:  ModbusSensor
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Modbus/ModbusSensor.h"
+#include "Poco/NumberFormatter.h"
+
+
+namespace IoT {
+namespace Modbus {
+
+
+const std::string ModbusSensor::NAME("Modbus Sensor");
+const std::string ModbusSensor::SYMBOLIC_NAME("io.macchina.modbus.sensor");
+
+
+ModbusSensor::ModbusSensor(const PointDefinition& point, Poco::Util::Timer& timer):
+	_value(0.0),
+	_ready(false),
+	_valueChangedPeriod(0),
+	_valueChangedDelta(0.0),
+	_pEventPolicy(new IoT::Devices::NoModerationPolicy<double>(valueChanged)),
+	_deviceIdentifier(point.id),
+	_symbolicName(SYMBOLIC_NAME),
+	_name(NAME),
+	_physicalQuantity(point.physicalQuantity),
+	_physicalUnit(point.physicalUnit),
+	_timer(timer)
+{
+	addProperty("displayValue", &ModbusSensor::getDisplayValue);
+	addProperty("valueChangedPeriod", &ModbusSensor::getValueChangedPeriod, &ModbusSensor::setValueChangedPeriod);
+	addProperty("valueChangedDelta", &ModbusSensor::getValueChangedDelta, &ModbusSensor::setValueChangedDelta);
+	addProperty("deviceIdentifier", &ModbusSensor::getDeviceIdentifier);
+	addProperty("symbolicName", &ModbusSensor::getSymbolicName);
+	addProperty("name", &ModbusSensor::getName);
+	addProperty("physicalQuantity", &ModbusSensor::getPhysicalQuantity);
+	addProperty("physicalUnit", &ModbusSensor::getPhysicalUnit);
+}
+
+
+ModbusSensor::~ModbusSensor()
+{
+}
+
+
+void ModbusSensor::update(double value)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	bool wasReady = _ready;
+	_ready = true;
+	if (_value != value || !wasReady)
+	{
+		_value = value;
+		_pEventPolicy->valueChanged(value);
+	}
+}
+
+
+void ModbusSensor::invalidate()
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	_ready = false;
+}
+
+
+double ModbusSensor::value() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _value;
+}
+
+
+bool ModbusSensor::ready() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _ready;
+}
+
+
+Poco::Any ModbusSensor::getValueChangedPeriod(const std::string&) const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _valueChangedPeriod;
+}
+
+
+void ModbusSensor::setValueChangedPeriod(const std::string&, const Poco::Any& value)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	int period = Poco::AnyCast<int>(value);
+	if (period != _valueChangedPeriod)
+	{
+		if (period == 0)
+		{
+			_pEventPolicy = new IoT::Devices::NoModerationPolicy<double>(valueChanged);
+		}
+		else
+		{
+			_pEventPolicy = new IoT::Devices::MaximumRateModerationPolicy<double>(valueChanged, _value, period, _timer);
+		}
+		_valueChangedPeriod = period;
+	}
+}
+
+
+Poco::Any ModbusSensor::getValueChangedDelta(const std::string&) const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _valueChangedDelta;
+}
+
+
+void ModbusSensor::setValueChangedDelta(const std::string&, const Poco::Any& value)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	double delta = Poco::AnyCast<double>(value);
+	if (delta != _valueChangedDelta)
+	{
+		if (delta == 0)
+		{
+			_pEventPolicy = new IoT::Devices::NoModerationPolicy<double>(valueChanged);
+		}
+		else
+		{
+			_pEventPolicy = new IoT::Devices::MinimumDeltaModerationPolicy<double>(valueChanged, _value, delta);
+		}
+		_valueChangedDelta = delta;
+	}
+}
+
+
+Poco::Any ModbusSensor::getDisplayValue(const std::string&) const
+{
+	return Poco::NumberFormatter::format(value());
+}
+
+
+Poco::Any ModbusSensor::getDeviceIdentifier(const std::string&) const
+{
+	return _deviceIdentifier;
+}
+
+
+Poco::Any ModbusSensor::getName(const std::string&) const
+{
+	return _name;
+}
+
+
+Poco::Any ModbusSensor::getSymbolicName(const std::string&) const
+{
+	return _symbolicName;
+}
+
+
+Poco::Any ModbusSensor::getPhysicalQuantity(const std::string&) const
+{
+	return _physicalQuantity;
+}
+
+
+Poco::Any ModbusSensor::getPhysicalUnit(const std::string&) const
+{
+	return _physicalUnit;
+}
+
+
+} } // namespace IoT::Modbus
@@ -67,7 +67,6 @@ void PDUReader::read(ReadCoilsResponse& response)
 			response.coilStatus.push_back(bit);
 			bits >>= 1;
 		}
-		_reader >> bits;
 	}
 }
 
@@ -88,7 +87,6 @@ void PDUReader::read(ReadDiscreteInputsResponse& response)
 			response.inputStatus.push_back(bit);
 			bits >>= 1;
 		}
-		_reader >> bits;
 	}
 }
 
@@ -128,14 +126,16 @@ void PDUReader::read(ReadInputRegistersResponse& response)
 void PDUReader::read(WriteSingleCoilResponse& response)
 {
 	readCommon(response);
-	// TODO
+	Poco::UInt16 outputValue;
+	_reader >> response.outputAddress >> outputValue;
+	response.value = outputValue == 0xFF00;
 }
 
 
 void PDUReader::read(WriteSingleRegisterResponse& response)
 {
 	readCommon(response);
-	// TODO
+	_reader >> response.outputAddress >> response.value;
 }
 
 
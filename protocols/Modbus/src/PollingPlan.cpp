@@ -0,0 +1,220 @@
+//
+// PollingPlan.cpp
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: Polling
+// Module:  PollingPlan
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Modbus/PollingPlan.h"
+#include "IoT/Modbus/ModbusMaster.h"
+#include "Poco/String.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <map>
+
+
+namespace IoT {
+namespace Modbus {
+
+
+namespace
+{
+	struct GroupKey
+	{
+		Poco::UInt8 slaveAddress;
+		long period;
+		Poco::UInt8 functionCode;
+
+		bool operator < (const GroupKey& other) const
+		{
+			if (slaveAddress != other.slaveAddress) return slaveAddress < other.slaveAddress;
+			if (period != other.period) return period < other.period;
+			return functionCode < other.functionCode;
+		}
+	};
+
+	class AddressLess
+	{
+	public:
+		AddressLess(const std::vector<PointDefinition>& points):
+			_points(points)
+		{
+		}
+
+		bool operator () (std::size_t a, std::size_t b) const
+		{
+			if (_points[a].address != _points[b].address)
+				return _points[a].address < _points[b].address;
+			else
+				return a < b;
+		}
+
+	private:
+		const std::vector<PointDefinition>& _points;
+	};
+}
+
+
+//
+// PointDefinition
+//
+
+
+PointDefinition::PointDefinition():
+	slaveAddress(0),
+	functionCode(MODBUS_READ_HOLDING_REGISTERS),
+	address(0),
+	type(TYPE_UINT16),
+	swapWords(false),
+	scale(1.0),
+	offset(0.0),
+	period(1000)
+{
+}
+
+
+Poco::UInt16 PointDefinition::width() const
+{
+	switch (type)
+	{
+	case TYPE_INT32:
+	case TYPE_UINT32:
+	case TYPE_FLOAT32:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+
+PointDefinition::DataType PointDefinition::parseType(const std::string& type)
+{
+	if (Poco::icompare(type, "bool") == 0)
+		return TYPE_BOOL;
+	else if (Poco::icompare(type, "int16") == 0)
+		return TYPE_INT16;
+	else if (Poco::icompare(type, "uint16") == 0)
+		return TYPE_UINT16;
+	else if (Poco::icompare(type, "int32") == 0)
+		return TYPE_INT32;
+	else if (Poco::icompare(type, "uint32") == 0)
+		return TYPE_UINT32;
+	else if (Poco::icompare(type, "float32") == 0)
+		return TYPE_FLOAT32;
+	else
+		throw Poco::InvalidArgumentException("data type", type);
+}
+
+
+//
+// PollingPlan
+//
+
+
+PollingPlan::PollingPlan(const std::vector<PointDefinition>& points, Poco::UInt16 maxGap, Poco::UInt16 maxRegisters, Poco::UInt16 maxBits):
+	_points(points)
+{
+	if (maxRegisters < 2 || maxRegisters > MAX_READ_REGISTERS) throw Poco::InvalidArgumentException("maxRegisters");
+	if (maxBits < 1 || maxBits > MAX_READ_BITS) throw Poco::InvalidArgumentException("maxBits");
+
+	for (std::vector<PointDefinition>::const_iterator it = _points.begin(); it != _points.end(); ++it)
+	{
+		validate(*it);
+	}
+	plan(maxGap, maxRegisters, maxBits);
+}
+
+
+PollingPlan::~PollingPlan()
+{
+}
+
+
+void PollingPlan::validate(const PointDefinition& point)
+{
+	switch (point.functionCode)
+	{
+	case MODBUS_READ_COILS:
+	case MODBUS_READ_DISCRETE_INPUTS:
+		if (point.type != PointDefinition::TYPE_BOOL)
+			throw Poco::InvalidArgumentException("Coils and discrete inputs must have type bool", point.id);
+		break;
+	case MODBUS_READ_HOLDING_REGISTERS:
+	case MODBUS_READ_INPUT_REGISTERS:
+		if (point.type == PointDefinition::TYPE_BOOL)
+			throw Poco::InvalidArgumentException("Registers cannot have type bool", point.id);
+		break;
+	default:
+		throw Poco::InvalidArgumentException("Unsupported function code for polling", point.id);
+	}
+	if (point.period <= 0)
+		throw Poco::InvalidArgumentException("Polling period must be positive", point.id);
+	if (static_cast<unsigned>(point.address) + point.width() > 0x10000)
+		throw Poco::InvalidArgumentException("Address out of range", point.id);
+}
+
+
+void PollingPlan::plan(Poco::UInt16 maxGap, Poco::UInt16 maxRegisters, Poco::UInt16 maxBits)
+{
+	typedef std::map<GroupKey, std::vector<std::size_t> > GroupMap;
+
+	GroupMap groups;
+	for (std::size_t i = 0; i < _points.size(); i++)
+	{
+		GroupKey key;
+		key.slaveAddress = _points[i].slaveAddress;
+		key.period       = _points[i].period;
+		key.functionCode = _points[i].functionCode;
+		groups[key].push_back(i);
+	}
+
+	for (GroupMap::iterator it = groups.begin(); it != groups.end(); ++it)
+	{
+		std::vector<std::size_t>& indexes = it->second;
+		std::sort(indexes.begin(), indexes.end(), AddressLess(_points));
+
+		bool bits = it->first.functionCode == MODBUS_READ_COILS || it->first.functionCode == MODBUS_READ_DISCRETE_INPUTS;
+		unsigned maxQuantity = bits ? maxBits : maxRegisters;
+
+		// Points are sorted by address, so extending the current request
+		// as far as possible before starting a new one yields the smallest
+		// number of requests.
+		PollRequest* pRequest = 0;
+		unsigned end = 0;
+		for (std::vector<std::size_t>::const_iterator itIndex = indexes.begin(); itIndex != indexes.end(); ++itIndex)
+		{
+			const PointDefinition& point = _points[*itIndex];
+			unsigned pointEnd = static_cast<unsigned>(point.address) + point.width();
+			if (pRequest
+				&& point.address <= end + maxGap
+				&& std::max(end, pointEnd) - pRequest->startingAddress <= maxQuantity)
+			{
+				end = std::max(end, pointEnd);
+			}
+			else
+			{
+				_requests.push_back(PollRequest());
+				pRequest = &_requests.back();
+				pRequest->slaveAddress    = point.slaveAddress;
+				pRequest->functionCode    = point.functionCode;
+				pRequest->startingAddress = point.address;
+				pRequest->period          = point.period;
+				end = pointEnd;
+			}
+			pRequest->quantity = static_cast<Poco::UInt16>(end - pRequest->startingAddress);
+			pRequest->points.push_back(*itIndex);
+		}
+	}
+}
+
+
+} } // namespace IoT::Modbus
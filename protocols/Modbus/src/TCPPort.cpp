@@ -0,0 +1,415 @@
+//
+// TCPPort.cpp
+//
+// $Id$
+//
+// Library: IoT/Modbus
+// Package: ModbusMaster
+// Module:  TCPPort
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Modbus/TCPPort.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Format.h"
+
+
+namespace IoT {
+namespace Modbus {
+
+
+//
+// TCPPort::Transaction
+//
+
+
+TCPPort::Transaction::Transaction(bool async):
+	_id(0),
+	_async(async)
+{
+}
+
+
+TCPPort::Transaction::~Transaction()
+{
+}
+
+
+void TCPPort::Transaction::setTimeout(const Poco::Timespan& timeout)
+{
+	_expiry.update();
+	_expiry += timeout.totalMicroseconds();
+}
+
+
+bool TCPPort::Transaction::wait(const Poco::Timespan& timeout)
+{
+	return _done.tryWait(static_cast<long>(timeout.totalMilliseconds()));
+}
+
+
+void TCPPort::Transaction::complete(const char* pFrame, std::size_t size)
+{
+	_frame.assign(pFrame, size);
+	_done.set();
+}
+
+
+void TCPPort::Transaction::fail(const std::string& error)
+{
+	_error = error;
+	_done.set();
+}
+
+
+//
+// TCPPort
+//
+
+
+TCPPort::TCPPort(const Poco::Net::SocketAddress& address, Poco::Timespan connectTimeout, int maxPending):
+	_address(address),
+	_connectTimeout(connectTimeout),
+	_maxPending(maxPending > 0 ? maxPending : 1),
+	_frameTimeout(DEFAULT_FRAME_TIMEOUT, 0),
+	_connected(false),
+	_lastId(0)
+{
+}
+
+
+TCPPort::~TCPPort()
+{
+	try
+	{
+		disconnect();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void TCPPort::connect()
+{
+	Poco::FastMutex::ScopedLock connectLock(_connectMutex);
+
+	if (connected()) return;
+
+	// The receiver thread of a lost connection may still be
+	// failing the outstanding requests.
+	if (_thread.isRunning()) _thread.join();
+	_socket.close();
+
+	Poco::Net::StreamSocket socket;
+	socket.connect(_address, _connectTimeout);
+	socket.setNoDelay(true);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_socket = socket;
+		_connected = true;
+	}
+	_thread.setName(Poco::format("Modbus TCP %s", _address.toString()));
+	_thread.start(*this);
+}
+
+
+void TCPPort::disconnect()
+{
+	Poco::FastMutex::ScopedLock connectLock(_connectMutex);
+
+	if (_thread.isRunning())
+	{
+		try
+		{
+			_socket.shutdown();
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		_thread.join();
+	}
+	_socket.close();
+}
+
+
+bool TCPPort::connected() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _connected;
+}
+
+
+void TCPPort::setUnitTimeout(Poco::UInt8 unitId, const Poco::Timespan& timeout)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_unitTimeouts[unitId] = timeout;
+}
+
+
+Poco::Timespan TCPPort::getUnitTimeout(Poco::UInt8 unitId, const Poco::Timespan& defaultTimeout) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	std::map<Poco::UInt8, Poco::Timespan>::const_iterator it = _unitTimeouts.find(unitId);
+	if (it != _unitTimeouts.end())
+		return it->second;
+	else
+		return defaultTimeout;
+}
+
+
+void TCPPort::setFrameTimeout(const Poco::Timespan& timeout)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_frameTimeout = timeout;
+}
+
+
+Poco::Timespan TCPPort::getFrameTimeout() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _frameTimeout;
+}
+
+
+Poco::UInt8 TCPPort::receiveFrame(const Poco::Timespan& timeout)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	expireTransactions();
+	if (_received.empty() && !_receivedCondition.tryWait(_mutex, static_cast<long>(timeout.totalMilliseconds())))
+		return 0;
+	if (_received.empty()) return 0;
+
+	_frame.swap(_received.front());
+	_received.pop_front();
+	return static_cast<Poco::UInt8>(_frame[1]);
+}
+
+
+bool TCPPort::poll(const Poco::Timespan& timeout)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	expireTransactions();
+	if (_received.empty()) _receivedCondition.tryWait(_mutex, static_cast<long>(timeout.totalMilliseconds()));
+	return !_received.empty();
+}
+
+
+void TCPPort::startTransaction(Transaction::Ptr pTransaction, char* frame, std::size_t size, const Poco::Timespan& timeout)
+{
+	connect();
+
+	Poco::UInt16 id;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		Poco::Clock deadline;
+		deadline += timeout.totalMicroseconds();
+		Poco::Clock::ClockDiff nextExpiry = expireTransactions();
+		while (_pending.size() >= _maxPending)
+		{
+			Poco::Clock::ClockDiff remaining = deadline - Poco::Clock();
+			if (remaining <= 0)
+				throw Poco::TimeoutException("Too many outstanding Modbus requests");
+
+			// Also wake up when the next asynchronous request expires,
+			// as no response will free its slot.
+			if (nextExpiry > 0 && nextExpiry < remaining) remaining = nextExpiry;
+			_pendingCondition.tryWait(_mutex, static_cast<long>((remaining + 999)/1000));
+			nextExpiry = expireTransactions();
+		}
+		id = nextTransactionId();
+		pTransaction->setId(id);
+		_pending[id] = pTransaction;
+	}
+
+	std::size_t length = size - MBAP_HEADER_SIZE;
+	frame[0] = static_cast<char>(id >> 8);
+	frame[1] = static_cast<char>(id & 0xFF);
+	frame[2] = 0; // protocol identifier
+	frame[3] = 0;
+	frame[4] = static_cast<char>(length >> 8);
+	frame[5] = static_cast<char>(length & 0xFF);
+
+	try
+	{
+		Poco::FastMutex::ScopedLock lock(_sendMutex);
+
+		std::size_t sent = 0;
+		while (sent < size)
+		{
+			int n = _socket.sendBytes(frame + sent, static_cast<int>(size - sent));
+			if (n <= 0) throw Poco::Net::ConnectionResetException(_address.toString());
+			sent += n;
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		cancelTransaction(pTransaction);
+		throw Poco::IOException("Failed to send Modbus request", exc.displayText());
+	}
+}
+
+
+Poco::UInt8 TCPPort::waitTransaction(Transaction::Ptr pTransaction, const Poco::Timespan& timeout)
+{
+	if (!pTransaction->wait(timeout))
+	{
+		cancelTransaction(pTransaction);
+		throw Poco::TimeoutException();
+	}
+	if (!pTransaction->error().empty())
+		throw Poco::IOException(pTransaction->error());
+
+	return static_cast<Poco::UInt8>(pTransaction->frame()[1]);
+}
+
+
+void TCPPort::cancelTransaction(Transaction::Ptr pTransaction)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	TransactionMap::iterator it = _pending.find(pTransaction->id());
+	if (it != _pending.end() && it->second == pTransaction)
+	{
+		_pending.erase(it);
+		_pendingCondition.signal();
+	}
+}
+
+
+void TCPPort::completeTransaction(Poco::UInt16 id, const char* pFrame, std::size_t size)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	TransactionMap::iterator it = _pending.find(id);
+	if (it == _pending.end()) return; // late response to a cancelled request
+
+	Transaction::Ptr pTransaction = it->second;
+	_pending.erase(it);
+	_pendingCondition.signal();
+
+	if (pTransaction->async())
+	{
+		if (_received.size() >= MAX_RECEIVED_FRAMES) _received.pop_front();
+		_received.push_back(std::string(pFrame, size));
+		_receivedCondition.broadcast();
+	}
+	else pTransaction->complete(pFrame, size);
+}
+
+
+void TCPPort::failTransactions(const std::string& error)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_connected = false;
+	for (TransactionMap::iterator it = _pending.begin(); it != _pending.end(); ++it)
+	{
+		it->second->fail(error);
+	}
+	_pending.clear();
+	_pendingCondition.broadcast();
+}
+
+
+Poco::Clock::ClockDiff TCPPort::expireTransactions()
+{
+	Poco::Clock now;
+	Poco::Clock::ClockDiff next = 0;
+	TransactionMap::iterator it = _pending.begin();
+	while (it != _pending.end())
+	{
+		if (it->second->async())
+		{
+			Poco::Clock::ClockDiff left = it->second->expiry() - now;
+			if (left <= 0)
+			{
+				_pending.erase(it++);
+				_pendingCondition.broadcast();
+				continue;
+			}
+			if (next == 0 || left < next) next = left;
+		}
+		++it;
+	}
+	return next;
+}
+
+
+Poco::UInt16 TCPPort::nextTransactionId()
+{
+	do
+	{
+		++_lastId;
+	}
+	while (_pending.find(_lastId) != _pending.end());
+	return _lastId;
+}
+
+
+void TCPPort::run()
+{
+	char frame[MODBUS_TCP_MAX_ADU_SIZE];
+	std::string error("Connection to Modbus server closed");
+	try
+	{
+		// MBAP header followed by unit identifier
+		while (receiveBytes(_socket, frame, MBAP_HEADER_SIZE + 1))
+		{
+			Poco::UInt16 id = (static_cast<Poco::UInt8>(frame[0]) << 8) | static_cast<Poco::UInt8>(frame[1]);
+			Poco::UInt16 protocol = (static_cast<Poco::UInt8>(frame[2]) << 8) | static_cast<Poco::UInt8>(frame[3]);
+			std::size_t length = (static_cast<Poco::UInt8>(frame[4]) << 8) | static_cast<Poco::UInt8>(frame[5]);
+			if (protocol != 0 || length < 2 || length > MODBUS_TCP_MAX_ADU_SIZE - MBAP_HEADER_SIZE)
+			{
+				// framing is lost; the connection must be reset
+				error = "Invalid Modbus TCP frame received";
+				break;
+			}
+			if (!receiveBytes(_socket, frame + MBAP_HEADER_SIZE + 1, length - 1)) break;
+			completeTransaction(id, frame + MBAP_HEADER_SIZE, length);
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		error = exc.displayText();
+	}
+	try
+	{
+		_socket.shutdown();
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	failTransactions(error);
+}
+
+
+bool TCPPort::receiveBytes(Poco::Net::StreamSocket& socket, char* buffer, std::size_t size)
+{
+	std::size_t received = 0;
+	while (received < size)
+	{
+		int n = socket.receiveBytes(buffer + received, static_cast<int>(size - received));
+		if (n <= 0) return false;
+		received += n;
+	}
+	return true;
+}
+
+
+} } // namespace IoT::Modbus
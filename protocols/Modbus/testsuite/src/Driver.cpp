@@ -0,0 +1,19 @@
+//
+// Driver.cpp
+//
+// $Id$
+//
+// Console-based test driver for IoT Modbus.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "CppUnit/TestRunner.h"
+#include "ModbusTestSuite.h"
+
+
+CppUnitMain(ModbusTestSuite)
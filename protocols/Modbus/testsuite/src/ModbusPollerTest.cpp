@@ -0,0 +1,334 @@
+//
+// ModbusPollerTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "ModbusPollerTest.h"
+#include "TCPSlaveSimulator.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Modbus/ModbusPoller.h"
+#include "IoT/Modbus/ModbusMasterImpl.h"
+#include "IoT/Modbus/TCPPort.h"
+#include "IoT/Devices/DeviceException.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Delegate.h"
+#include "Poco/Thread.h"
+#include <cmath>
+
+
+using namespace IoT::Modbus;
+
+
+namespace
+{
+	typedef ModbusMasterImpl<TCPPort> TCPMaster;
+
+	class EventCounter
+	{
+	public:
+		EventCounter():
+			_count(0),
+			_value(0)
+		{
+		}
+
+		void onValueChanged(const void*, const double& value)
+		{
+			_count++;
+			_value = value;
+		}
+
+		int count() const
+		{
+			return _count;
+		}
+
+		double value() const
+		{
+			return _value;
+		}
+
+	private:
+		int _count;
+		double _value;
+	};
+
+	Poco::SharedPtr<TCPMaster> createMaster(const TCPSlaveSimulator& slave)
+	{
+		Poco::SharedPtr<TCPPort> pPort = new TCPPort(Poco::Net::SocketAddress("127.0.0.1", slave.port()));
+		return new TCPMaster(pPort);
+	}
+
+	PointDefinition point(Poco::UInt16 address, PointDefinition::DataType type = PointDefinition::TYPE_UINT16, Poco::UInt8 slaveAddress = 1, Poco::UInt8 functionCode = MODBUS_READ_HOLDING_REGISTERS)
+	{
+		PointDefinition pt;
+		pt.slaveAddress = slaveAddress;
+		pt.functionCode = functionCode;
+		pt.address = address;
+		pt.type = type;
+		return pt;
+	}
+}
+
+
+ModbusPollerTest::ModbusPollerTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+ModbusPollerTest::~ModbusPollerTest()
+{
+}
+
+
+void ModbusPollerTest::testDecode()
+{
+	TCPSlaveSimulator slave;
+	slave.setHoldingRegister(1, 0xFFFE);
+	slave.setHoldingRegister(2, 0x0001);
+	slave.setHoldingRegister(3, 0x0002);
+	slave.setHoldingRegister(4, 0x0001);
+	slave.setHoldingRegister(5, 0x0002);
+	slave.setHoldingRegister(6, 0xFFFF);
+	slave.setHoldingRegister(7, 0xFFFF);
+	slave.setHoldingRegister(8, 0x4049);
+	slave.setHoldingRegister(9, 0x0FDB);
+
+	std::vector<PointDefinition> points;
+	points.push_back(point(0));
+	points.push_back(point(1, PointDefinition::TYPE_INT16));
+	points.push_back(point(2, PointDefinition::TYPE_UINT32));
+	points.push_back(point(4, PointDefinition::TYPE_UINT32));
+	points[3].swapWords = true;
+	points.push_back(point(6, PointDefinition::TYPE_INT32));
+	points.push_back(point(8, PointDefinition::TYPE_FLOAT32));
+	points.push_back(point(10));
+	points[6].scale = 0.5;
+	points[6].offset = -1;
+	points.push_back(point(20, PointDefinition::TYPE_UINT16, 1, MODBUS_READ_INPUT_REGISTERS));
+
+	ModbusPoller poller(createMaster(slave), PollingPlan(points));
+	assert (!poller.sensor(0)->ready());
+	poller.poll();
+
+	assert (slave.requests() == 2);
+	assert (poller.requests() == 2);
+	assert (poller.failedRequests() == 0);
+
+	assert (poller.sensor(0)->ready());
+	assert (poller.sensor(0)->value() == 0);
+	assert (poller.sensor(1)->value() == -2);
+	assert (poller.sensor(2)->value() == 0x00010002);
+	assert (poller.sensor(3)->value() == 0x00020001);
+	assert (poller.sensor(4)->value() == -1);
+	assert (std::fabs(poller.sensor(5)->value() - 3.14159265) < 1e-6);
+	assert (poller.sensor(6)->value() == 4);
+	assert (poller.sensor(7)->value() == 1020);
+	assert (!poller.io(0));
+}
+
+
+void ModbusPollerTest::testBits()
+{
+	TCPSlaveSimulator slave;
+
+	std::vector<PointDefinition> points;
+	for (Poco::UInt16 i = 0; i < 20; i++)
+	{
+		points.push_back(point(i, PointDefinition::TYPE_BOOL, 1, MODBUS_READ_COILS));
+		points.push_back(point(i, PointDefinition::TYPE_BOOL, 1, MODBUS_READ_DISCRETE_INPUTS));
+	}
+
+	ModbusPoller poller(createMaster(slave), PollingPlan(points));
+	poller.poll();
+	assert (slave.requests() == 2);
+
+	for (Poco::UInt16 i = 0; i < 20; i++)
+	{
+		assert (poller.io(2*i)->state() == (i % 2 == 1));
+		assert (poller.io(2*i + 1)->state() == (i % 3 == 0));
+		assert (!poller.sensor(2*i));
+	}
+}
+
+
+void ModbusPollerTest::testChangeEvents()
+{
+	TCPSlaveSimulator slave;
+
+	std::vector<PointDefinition> points;
+	points.push_back(point(0));
+	points.push_back(point(1));
+
+	ModbusPoller poller(createMaster(slave), PollingPlan(points));
+	EventCounter counter0;
+	EventCounter counter1;
+	poller.sensor(0)->valueChanged += Poco::delegate(&counter0, &EventCounter::onValueChanged);
+	poller.sensor(1)->valueChanged += Poco::delegate(&counter1, &EventCounter::onValueChanged);
+
+	poller.poll();
+	assert (counter0.count() == 1);
+	assert (counter1.count() == 1);
+	assert (counter1.value() == 1);
+
+	poller.poll();
+	assert (counter0.count() == 1);
+	assert (counter1.count() == 1);
+
+	slave.setHoldingRegister(1, 42);
+	poller.poll();
+	assert (counter0.count() == 1);
+	assert (counter1.count() == 2);
+	assert (counter1.value() == 42);
+
+	poller.sensor(1)->setPropertyDouble("valueChangedDelta", 10.0);
+	slave.setHoldingRegister(1, 45);
+	poller.poll();
+	assert (counter1.count() == 2);
+	slave.setHoldingRegister(1, 55);
+	poller.poll();
+	assert (counter1.count() == 3);
+
+	poller.sensor(0)->valueChanged -= Poco::delegate(&counter0, &EventCounter::onValueChanged);
+	poller.sensor(1)->valueChanged -= Poco::delegate(&counter1, &EventCounter::onValueChanged);
+}
+
+
+void ModbusPollerTest::testExceptionResponse()
+{
+	TCPSlaveSimulator slave;
+
+	std::vector<PointDefinition> points;
+	points.push_back(point(998, PointDefinition::TYPE_UINT32));
+	points.push_back(point(999, PointDefinition::TYPE_UINT32));
+	points.push_back(point(0, PointDefinition::TYPE_UINT16, 1, MODBUS_READ_INPUT_REGISTERS));
+
+	ModbusPoller poller(createMaster(slave), PollingPlan(points));
+	poller.poll();
+
+	// the exception only affects the request for the unmapped registers
+	assert (poller.requests() == 2);
+	assert (poller.failedRequests() == 1);
+	assert (!poller.sensor(0)->ready());
+	assert (!poller.sensor(1)->ready());
+	assert (poller.sensor(2)->ready());
+	assert (poller.sensor(2)->value() == 1000);
+}
+
+
+void ModbusPollerTest::testSlaveTimeout()
+{
+	TCPSlaveSimulator slave;
+	slave.setDelay(2, -1);
+	Poco::SharedPtr<TCPPort> pPort = new TCPPort(Poco::Net::SocketAddress("127.0.0.1", slave.port()));
+	pPort->setUnitTimeout(2, Poco::Timespan(0, 200000));
+
+	std::vector<PointDefinition> points;
+	points.push_back(point(0, PointDefinition::TYPE_UINT16, 2, MODBUS_READ_HOLDING_REGISTERS));
+	points.push_back(point(0, PointDefinition::TYPE_UINT16, 2, MODBUS_READ_INPUT_REGISTERS));
+	points.push_back(point(0, PointDefinition::TYPE_BOOL, 2, MODBUS_READ_COILS));
+	points.push_back(point(5, PointDefinition::TYPE_UINT16, 1, MODBUS_READ_HOLDING_REGISTERS));
+
+	ModbusPoller poller(new TCPMaster(pPort), PollingPlan(points));
+	poller.poll();
+
+	// after the first timeout, the remaining requests for slave 2 are skipped
+	assert (slave.requests() == 2);
+	assert (poller.requests() == 2);
+	assert (poller.failedRequests() == 3);
+	assert (!poller.sensor(0)->ready());
+	assert (!poller.sensor(1)->ready());
+	assert (poller.sensor(3)->ready());
+	assert (poller.sensor(3)->value() == 5);
+}
+
+
+void ModbusPollerTest::testSchedule()
+{
+	TCPSlaveSimulator slave;
+
+	std::vector<PointDefinition> points;
+	points.push_back(point(0));
+	points.back().period = 100;
+	points.push_back(point(0, PointDefinition::TYPE_UINT16, 2));
+	points.back().period = 1000;
+
+	ModbusPoller poller(createMaster(slave), PollingPlan(points));
+	poller.start();
+	Poco::Thread::sleep(450);
+	poller.stop();
+
+	int requests = slave.requests();
+	assert (requests >= 5 && requests <= 7);
+	assert (poller.sensor(0)->ready());
+	assert (poller.sensor(1)->ready());
+
+	Poco::Thread::sleep(200);
+	assert (slave.requests() == requests);
+}
+
+
+void ModbusPollerTest::testSetCoil()
+{
+	TCPSlaveSimulator slave;
+
+	std::vector<PointDefinition> points;
+	points.push_back(point(4, PointDefinition::TYPE_BOOL, 1, MODBUS_READ_COILS));
+	points.push_back(point(4, PointDefinition::TYPE_BOOL, 1, MODBUS_READ_DISCRETE_INPUTS));
+
+	ModbusPoller poller(createMaster(slave), PollingPlan(points));
+	poller.poll();
+	assert (!poller.io(0)->state());
+	assert (poller.io(0)->getPropertyString("direction") == "out");
+
+	poller.io(0)->set(true);
+	assert (slave.coil(4));
+	assert (poller.io(0)->state());
+	poller.poll();
+	assert (poller.io(0)->state());
+
+	assert (poller.io(1)->getPropertyString("direction") == "in");
+	try
+	{
+		poller.io(1)->set(true);
+		fail("discrete input - must throw");
+	}
+	catch (IoT::Devices::NotWritableException&)
+	{
+	}
+}
+
+
+void ModbusPollerTest::setUp()
+{
+}
+
+
+void ModbusPollerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ModbusPollerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ModbusPollerTest");
+
+	CppUnit_addTest(pSuite, ModbusPollerTest, testDecode);
+	CppUnit_addTest(pSuite, ModbusPollerTest, testBits);
+	CppUnit_addTest(pSuite, ModbusPollerTest, testChangeEvents);
+	CppUnit_addTest(pSuite, ModbusPollerTest, testExceptionResponse);
+	CppUnit_addTest(pSuite, ModbusPollerTest, testSlaveTimeout);
+	CppUnit_addTest(pSuite, ModbusPollerTest, testSchedule);
+	CppUnit_addTest(pSuite, ModbusPollerTest, testSetCoil);
+
+	return pSuite;
+}
@@ -0,0 +1,44 @@
+//
+// ModbusPollerTest.h
+//
+// $Id$
+//
+// Definition of the ModbusPollerTest class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef ModbusPollerTest_INCLUDED
+#define ModbusPollerTest_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "CppUnit/TestCase.h"
+
+
+class ModbusPollerTest: public CppUnit::TestCase
+{
+public:
+	ModbusPollerTest(const std::string& name);
+	~ModbusPollerTest();
+
+	void testDecode();
+	void testBits();
+	void testChangeEvents();
+	void testExceptionResponse();
+	void testSlaveTimeout();
+	void testSchedule();
+	void testSetCoil();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // ModbusPollerTest_INCLUDED
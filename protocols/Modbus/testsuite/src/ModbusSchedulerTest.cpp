@@ -0,0 +1,585 @@
+//
+// ModbusSchedulerTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "ModbusSchedulerTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Modbus/ModbusScheduler.h"
+#include "IoT/Modbus/ModbusException.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include "Poco/Clock.h"
+#include "Poco/Format.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Exception.h"
+
+
+using namespace IoT::Modbus;
+
+
+namespace
+{
+	class StubMaster: public ModbusMaster
+		/// A ModbusMaster that records all synchronous requests
+		/// and blocks them until opened.
+	{
+	public:
+		StubMaster():
+			_gate(false),
+			_calls(0),
+			_active(0),
+			_maxActive(0)
+		{
+			_gate.set();
+		}
+
+		void close()
+		{
+			_gate.reset();
+		}
+
+		void open()
+		{
+			_gate.set();
+		}
+
+		int calls() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _calls;
+		}
+
+		int maxActive() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _maxActive;
+		}
+
+		std::vector<std::string> log() const
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			return _log;
+		}
+
+		void sendRequest(const GenericMessage&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendReadCoilsRequest(const ReadCoilsRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendReadDiscreteInputsRequest(const ReadDiscreteInputsRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendReadHoldingRegistersRequest(const ReadHoldingRegistersRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendReadInputRegistersRequest(const ReadInputRegistersRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendWriteSingleCoilRequest(const WriteSingleCoilRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendWriteSingleRegisterRequest(const WriteSingleRegisterRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendReadExceptionStatusRequest(const ReadExceptionStatusRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendWriteMultipleCoilsRequest(const WriteMultipleCoilsRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendWriteMultipleRegistersRequest(const WriteMultipleRegistersRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendMaskWriteRegisterRequest(const MaskWriteRegisterRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendReadWriteMultipleRegistersRequest(const ReadWriteMultipleRegistersRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		void sendReadFIFOQueueRequest(const ReadFIFOQueueRequest&)
+		{
+			throw Poco::NotImplementedException();
+		}
+
+		std::vector<bool> readCoils(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfCoils)
+		{
+			transaction(Poco::format("coils %hu %hu", startingAddress, nOfCoils), MODBUS_READ_COILS, startingAddress);
+			std::vector<bool> result;
+			for (Poco::UInt16 i = 0; i < nOfCoils; i++) result.push_back(((startingAddress + i) & 1) != 0);
+			return result;
+		}
+
+		std::vector<bool> readDiscreteInputs(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfInputs)
+		{
+			transaction(Poco::format("inputs %hu %hu", startingAddress, nOfInputs), MODBUS_READ_DISCRETE_INPUTS, startingAddress);
+			return std::vector<bool>(nOfInputs, false);
+		}
+
+		std::vector<Poco::UInt16> readHoldingRegisters(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfRegisters)
+		{
+			transaction(Poco::format("read %hu %hu", startingAddress, nOfRegisters), MODBUS_READ_HOLDING_REGISTERS, startingAddress);
+			std::vector<Poco::UInt16> result;
+			for (Poco::UInt16 i = 0; i < nOfRegisters; i++) result.push_back(startingAddress + i);
+			return result;
+		}
+
+		std::vector<Poco::UInt16> readInputRegisters(Poco::UInt8 slaveAddress, Poco::UInt16 startingAddress, Poco::UInt16 nOfRegisters)
+		{
+			transaction(Poco::format("input %hu %hu", startingAddress, nOfRegisters), MODBUS_READ_INPUT_REGISTERS, startingAddress);
+			return std::vector<Poco::UInt16>(nOfRegisters, 0);
+		}
+
+		void writeSingleCoil(Poco::UInt8 slaveAddress, Poco::UInt16 outputAddress, bool value)
+		{
+			transaction(Poco::format("coil %hu %b", outputAddress, value), MODBUS_WRITE_SINGLE_COIL, outputAddress);
+		}
+
+		void writeSingleRegister(Poco::UInt8 slaveAddress, Poco::UInt16 outputAddress, Poco::UInt16 value)
+		{
+			transaction(Poco::format("write %hu %hu", outputAddress, value), MODBUS_WRITE_SINGLE_REGISTER, outputAddress);
+		}
+
+		Poco::UInt8 readExceptionStatus(Poco::UInt8 slaveAddress)
+		{
+			transaction("status", MODBUS_READ_EXCEPTION_STATUS, 0);
+			return 0x55;
+		}
+
+	protected:
+		void transaction(const std::string& request, Poco::UInt8 functionCode, Poco::UInt16 address)
+		{
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_log.push_back(request);
+				_calls++;
+				_active++;
+				if (_active > _maxActive) _maxActive = _active;
+			}
+			_gate.wait();
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_active--;
+			}
+			if (address >= 1000) throw ModbusException(functionCode, MODBUS_EXC_ILLEGAL_DATA_ADDRESS);
+		}
+
+	private:
+		Poco::Event _gate;
+		std::vector<std::string> _log;
+		int _calls;
+		int _active;
+		int _maxActive;
+		mutable Poco::FastMutex _mutex;
+	};
+
+	class Client: public Poco::Runnable
+		/// Submits a single request to the scheduler in a separate thread.
+	{
+	public:
+		Client(ModbusScheduler& scheduler, Poco::UInt8 functionCode, Poco::UInt16 address, Poco::UInt16 quantityOrValue):
+			_scheduler(scheduler),
+			_functionCode(functionCode),
+			_address(address),
+			_quantityOrValue(quantityOrValue)
+		{
+			_thread.start(*this);
+		}
+
+		~Client()
+		{
+			join();
+		}
+
+		void join()
+		{
+			if (_thread.isRunning()) _thread.join();
+		}
+
+		void run()
+		{
+			try
+			{
+				if (_functionCode == MODBUS_WRITE_SINGLE_REGISTER)
+					_scheduler.writeSingleRegister(1, _address, _quantityOrValue);
+				else
+					_registers = _scheduler.readHoldingRegisters(1, _address, _quantityOrValue);
+			}
+			catch (Poco::Exception& exc)
+			{
+				_pException = exc.clone();
+			}
+		}
+
+		const std::vector<Poco::UInt16>& registers() const
+		{
+			return _registers;
+		}
+
+		const Poco::Exception* exception() const
+		{
+			return _pException.get();
+		}
+
+	private:
+		ModbusScheduler& _scheduler;
+		Poco::UInt8 _functionCode;
+		Poco::UInt16 _address;
+		Poco::UInt16 _quantityOrValue;
+		std::vector<Poco::UInt16> _registers;
+		Poco::SharedPtr<Poco::Exception> _pException;
+		Poco::Thread _thread;
+	};
+
+	bool waitFor(const ModbusScheduler& scheduler, std::size_t queueDepth)
+		/// Waits until the given number of transactions is queued.
+	{
+		Poco::Clock start;
+		while (scheduler.statistics().queueDepth != queueDepth)
+		{
+			if (start.isElapsed(5000000)) return false;
+			Poco::Thread::sleep(5);
+		}
+		return true;
+	}
+
+	bool waitFor(const StubMaster& master, int calls)
+		/// Waits until the master has seen the given number of requests.
+	{
+		Poco::Clock start;
+		while (master.calls() != calls)
+		{
+			if (start.isElapsed(5000000)) return false;
+			Poco::Thread::sleep(5);
+		}
+		return true;
+	}
+
+	bool waitForRequests(const ModbusScheduler& scheduler, ModbusScheduler::Priority priority, Poco::UInt64 requests)
+		/// Waits until the given number of requests of the given priority has been submitted.
+	{
+		Poco::Clock start;
+		while (scheduler.statistics().priorities[priority].requests != requests)
+		{
+			if (start.isElapsed(5000000)) return false;
+			Poco::Thread::sleep(5);
+		}
+		return true;
+	}
+}
+
+
+ModbusSchedulerTest::ModbusSchedulerTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+ModbusSchedulerTest::~ModbusSchedulerTest()
+{
+}
+
+
+void ModbusSchedulerTest::testPriority()
+{
+	Poco::SharedPtr<StubMaster> pMaster = new StubMaster;
+	ModbusScheduler scheduler(pMaster);
+
+	pMaster->close();
+	Client first(scheduler, MODBUS_READ_HOLDING_REGISTERS, 0, 1);
+	assert (waitFor(*pMaster, 1));
+
+	Client bulk(scheduler, MODBUS_READ_HOLDING_REGISTERS, 100, 100);
+	assert (waitFor(scheduler, 1));
+	Client read(scheduler, MODBUS_READ_HOLDING_REGISTERS, 200, 2);
+	assert (waitFor(scheduler, 2));
+	Client write(scheduler, MODBUS_WRITE_SINGLE_REGISTER, 300, 42);
+	assert (waitFor(scheduler, 3));
+	pMaster->open();
+
+	first.join();
+	bulk.join();
+	read.join();
+	write.join();
+
+	std::vector<std::string> log = pMaster->log();
+	assert (log.size() == 4);
+	assert (log[0] == "read 0 1");
+	assert (log[1] == "write 300 42");
+	assert (log[2] == "read 200 2");
+	assert (log[3] == "read 100 100");
+
+	assert (bulk.registers().size() == 100);
+	assert (bulk.registers()[99] == 199);
+	assert (read.registers().size() == 2);
+	assert (!write.exception());
+
+	ModbusScheduler::Statistics stats = scheduler.statistics();
+	assert (stats.priorities[ModbusScheduler::PRIO_LOW].requests == 1);
+	assert (stats.priorities[ModbusScheduler::PRIO_NORMAL].requests == 2);
+	assert (stats.priorities[ModbusScheduler::PRIO_HIGH].requests == 1);
+}
+
+
+void ModbusSchedulerTest::testCoalescing()
+{
+	Poco::SharedPtr<StubMaster> pMaster = new StubMaster;
+	ModbusScheduler scheduler(pMaster);
+
+	pMaster->close();
+	Client first(scheduler, MODBUS_READ_HOLDING_REGISTERS, 10, 5);
+	assert (waitFor(*pMaster, 1));
+
+	// joins the running transaction
+	Client second(scheduler, MODBUS_READ_HOLDING_REGISTERS, 10, 5);
+	assert (waitForRequests(scheduler, ModbusScheduler::PRIO_NORMAL, 2));
+
+	// queued, then joined by the fourth request
+	Client third(scheduler, MODBUS_READ_HOLDING_REGISTERS, 20, 5);
+	assert (waitFor(scheduler, 1));
+	Client fourth(scheduler, MODBUS_READ_HOLDING_REGISTERS, 20, 5);
+	assert (waitForRequests(scheduler, ModbusScheduler::PRIO_NORMAL, 4));
+	assert (scheduler.statistics().queueDepth == 1);
+	pMaster->open();
+
+	first.join();
+	second.join();
+	third.join();
+	fourth.join();
+
+	assert (pMaster->calls() == 2);
+	assert (first.registers() == second.registers());
+	assert (first.registers()[0] == 10);
+	assert (third.registers() == fourth.registers());
+	assert (third.registers()[4] == 24);
+
+	ModbusScheduler::Statistics stats = scheduler.statistics();
+	assert (stats.priorities[ModbusScheduler::PRIO_NORMAL].requests == 4);
+	assert (stats.priorities[ModbusScheduler::PRIO_NORMAL].transactions == 2);
+	assert (stats.priorities[ModbusScheduler::PRIO_NORMAL].coalesced == 2);
+
+	// completed transactions are not reused
+	assert (scheduler.readHoldingRegisters(1, 10, 5)[0] == 10);
+	assert (pMaster->calls() == 3);
+}
+
+
+void ModbusSchedulerTest::testDeadline()
+{
+	Poco::SharedPtr<StubMaster> pMaster = new StubMaster;
+	ModbusScheduler scheduler(pMaster);
+
+	pMaster->close();
+	Client first(scheduler, MODBUS_READ_HOLDING_REGISTERS, 0, 1);
+	assert (waitFor(*pMaster, 1));
+
+	{
+		ModbusScheduler::ScopedPriority priority(ModbusScheduler::PRIO_LOW, Poco::Timespan(0, 100000));
+		Poco::Clock start;
+		try
+		{
+			scheduler.readHoldingRegisters(1, 50, 2);
+			fail("deadline expired - must throw");
+		}
+		catch (Poco::TimeoutException&)
+		{
+		}
+		assert (start.elapsed() >= 100000);
+	}
+	assert (scheduler.statistics().queueDepth == 0);
+
+	scheduler.setDeadline(ModbusScheduler::PRIO_HIGH, Poco::Timespan(0, 50000));
+	assert (scheduler.getDeadline(ModbusScheduler::PRIO_HIGH) == Poco::Timespan(0, 50000));
+	try
+	{
+		scheduler.writeSingleRegister(1, 60, 1);
+		fail("deadline expired - must throw");
+	}
+	catch (Poco::TimeoutException&)
+	{
+	}
+
+	pMaster->open();
+	first.join();
+
+	// the expired requests never reached the master
+	std::vector<std::string> log = pMaster->log();
+	assert (log.size() == 1);
+	assert (log[0] == "read 0 1");
+
+	ModbusScheduler::Statistics stats = scheduler.statistics();
+	assert (stats.priorities[ModbusScheduler::PRIO_LOW].expired == 1);
+	assert (stats.priorities[ModbusScheduler::PRIO_HIGH].expired == 1);
+	assert (stats.priorities[ModbusScheduler::PRIO_NORMAL].expired == 0);
+
+	// a started request is not subject to the deadline
+	pMaster->close();
+	Client slow(scheduler, MODBUS_WRITE_SINGLE_REGISTER, 70, 1);
+	assert (waitFor(*pMaster, 2));
+	Poco::Thread::sleep(100);
+	pMaster->open();
+	slow.join();
+	assert (!slow.exception());
+}
+
+
+void ModbusSchedulerTest::testException()
+{
+	Poco::SharedPtr<StubMaster> pMaster = new StubMaster;
+	ModbusScheduler scheduler(pMaster);
+
+	pMaster->close();
+	Client first(scheduler, MODBUS_READ_HOLDING_REGISTERS, 1000, 2);
+	assert (waitFor(*pMaster, 1));
+	Client second(scheduler, MODBUS_READ_HOLDING_REGISTERS, 1000, 2);
+	assert (waitForRequests(scheduler, ModbusScheduler::PRIO_NORMAL, 2));
+	pMaster->open();
+
+	first.join();
+	second.join();
+	assert (pMaster->calls() == 1);
+
+	const ModbusException* pExc = dynamic_cast<const ModbusException*>(first.exception());
+	assert (pExc);
+	assert (pExc->exceptionCode() == MODBUS_EXC_ILLEGAL_DATA_ADDRESS);
+	pExc = dynamic_cast<const ModbusException*>(second.exception());
+	assert (pExc);
+	assert (pExc->functionCode() == MODBUS_READ_HOLDING_REGISTERS);
+
+	try
+	{
+		scheduler.writeSingleRegister(1, 1000, 0);
+		fail("illegal address - must throw");
+	}
+	catch (ModbusException& exc)
+	{
+		assert (exc.functionCode() == MODBUS_WRITE_SINGLE_REGISTER);
+	}
+
+	assert (scheduler.readHoldingRegisters(1, 0, 3).size() == 3);
+	assert (scheduler.readExceptionStatus(1) == 0x55);
+}
+
+
+void ModbusSchedulerTest::testWorkers()
+{
+	Poco::SharedPtr<StubMaster> pMaster = new StubMaster;
+	ModbusScheduler scheduler(pMaster, 2);
+
+	pMaster->close();
+	Client first(scheduler, MODBUS_READ_HOLDING_REGISTERS, 0, 1);
+	Client second(scheduler, MODBUS_READ_HOLDING_REGISTERS, 10, 1);
+	assert (waitFor(*pMaster, 2));
+	Client third(scheduler, MODBUS_READ_HOLDING_REGISTERS, 20, 1);
+	assert (waitFor(scheduler, 1));
+	pMaster->open();
+
+	first.join();
+	second.join();
+	third.join();
+
+	assert (pMaster->calls() == 3);
+	assert (pMaster->maxActive() == 2);
+	assert (third.registers()[0] == 20);
+}
+
+
+void ModbusSchedulerTest::testStatistics()
+{
+	Poco::SharedPtr<StubMaster> pMaster = new StubMaster;
+	ModbusScheduler scheduler(pMaster, 1, 10);
+	assert (scheduler.bulkThreshold() == 10);
+
+	pMaster->close();
+	Client first(scheduler, MODBUS_READ_HOLDING_REGISTERS, 0, 10);
+	assert (waitFor(*pMaster, 1));
+	Client bulk(scheduler, MODBUS_READ_HOLDING_REGISTERS, 0, 11);
+	Client write(scheduler, MODBUS_WRITE_SINGLE_REGISTER, 0, 1);
+	assert (waitFor(scheduler, 2));
+	Poco::Thread::sleep(50);
+	pMaster->open();
+
+	first.join();
+	bulk.join();
+	write.join();
+
+	ModbusScheduler::Statistics stats = scheduler.statistics();
+	assert (stats.queueDepth == 0);
+	assert (stats.maxQueueDepth == 2);
+	assert (stats.priorities[ModbusScheduler::PRIO_NORMAL].transactions == 1);
+	assert (stats.priorities[ModbusScheduler::PRIO_LOW].transactions == 1);
+	assert (stats.priorities[ModbusScheduler::PRIO_HIGH].transactions == 1);
+	assert (stats.priorities[ModbusScheduler::PRIO_LOW].maxWaitTime >= 50000);
+	assert (stats.priorities[ModbusScheduler::PRIO_LOW].totalWaitTime >= stats.priorities[ModbusScheduler::PRIO_LOW].maxWaitTime);
+	assert (stats.priorities[ModbusScheduler::PRIO_HIGH].maxWaitTime >= 50000);
+
+	scheduler.resetStatistics();
+	stats = scheduler.statistics();
+	assert (stats.maxQueueDepth == 0);
+	for (int i = 0; i < ModbusScheduler::PRIO_COUNT; i++)
+	{
+		assert (stats.priorities[i].requests == 0);
+		assert (stats.priorities[i].transactions == 0);
+		assert (stats.priorities[i].totalWaitTime == 0);
+	}
+}
+
+
+void ModbusSchedulerTest::setUp()
+{
+}
+
+
+void ModbusSchedulerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ModbusSchedulerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ModbusSchedulerTest");
+
+	CppUnit_addTest(pSuite, ModbusSchedulerTest, testPriority);
+	CppUnit_addTest(pSuite, ModbusSchedulerTest, testCoalescing);
+	CppUnit_addTest(pSuite, ModbusSchedulerTest, testDeadline);
+	CppUnit_addTest(pSuite, ModbusSchedulerTest, testException);
+	CppUnit_addTest(pSuite, ModbusSchedulerTest, testWorkers);
+	CppUnit_addTest(pSuite, ModbusSchedulerTest, testStatistics);
+
+	return pSuite;
+}
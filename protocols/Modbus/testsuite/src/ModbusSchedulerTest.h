@@ -0,0 +1,43 @@
+//
+// ModbusSchedulerTest.h
+//
+// $Id$
+//
+// Definition of the ModbusSchedulerTest class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef ModbusSchedulerTest_INCLUDED
+#define ModbusSchedulerTest_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "CppUnit/TestCase.h"
+
+
+class ModbusSchedulerTest: public CppUnit::TestCase
+{
+public:
+	ModbusSchedulerTest(const std::string& name);
+	~ModbusSchedulerTest();
+
+	void testPriority();
+	void testCoalescing();
+	void testDeadline();
+	void testException();
+	void testWorkers();
+	void testStatistics();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // ModbusSchedulerTest_INCLUDED
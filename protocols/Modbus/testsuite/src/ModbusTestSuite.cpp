@@ -0,0 +1,34 @@
+//
+// ModbusTestSuite.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "ModbusTestSuite.h"
+#include "TCPPortTest.h"
+#include "RTUFramerTest.h"
+#include "RTUPortTest.h"
+#include "PollingPlanTest.h"
+#include "ModbusPollerTest.h"
+#include "ModbusSchedulerTest.h"
+
+
+CppUnit::Test* ModbusTestSuite::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ModbusTestSuite");
+
+	pSuite->addTest(TCPPortTest::suite());
+	pSuite->addTest(RTUFramerTest::suite());
+	pSuite->addTest(RTUPortTest::suite());
+	pSuite->addTest(PollingPlanTest::suite());
+	pSuite->addTest(ModbusPollerTest::suite());
+	pSuite->addTest(ModbusSchedulerTest::suite());
+
+	return pSuite;
+}
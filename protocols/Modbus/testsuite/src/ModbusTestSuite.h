@@ -0,0 +1,29 @@
+//
+// ModbusTestSuite.h
+//
+// $Id$
+//
+// Definition of the ModbusTestSuite class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef ModbusTestSuite_INCLUDED
+#define ModbusTestSuite_INCLUDED
+
+
+#include "CppUnit/TestSuite.h"
+
+
+class ModbusTestSuite
+{
+public:
+	static CppUnit::Test* suite();
+};
+
+
+#endif // ModbusTestSuite_INCLUDED
@@ -0,0 +1,298 @@
+//
+// PollingPlanTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "PollingPlanTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Modbus/PollingPlan.h"
+#include "IoT/Modbus/ModbusMaster.h"
+#include "Poco/Exception.h"
+
+
+using namespace IoT::Modbus;
+
+
+namespace
+{
+	PointDefinition point(Poco::UInt16 address, PointDefinition::DataType type = PointDefinition::TYPE_UINT16, Poco::UInt8 slaveAddress = 1, Poco::UInt8 functionCode = MODBUS_READ_HOLDING_REGISTERS, long period = 1000)
+	{
+		PointDefinition pt;
+		pt.slaveAddress = slaveAddress;
+		pt.functionCode = functionCode;
+		pt.address = address;
+		pt.type = type;
+		pt.period = period;
+		return pt;
+	}
+}
+
+
+PollingPlanTest::PollingPlanTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+PollingPlanTest::~PollingPlanTest()
+{
+}
+
+
+void PollingPlanTest::testAdjacent()
+{
+	std::vector<PointDefinition> points;
+	points.push_back(point(2));
+	points.push_back(point(0));
+	points.push_back(point(3, PointDefinition::TYPE_FLOAT32));
+	points.push_back(point(1, PointDefinition::TYPE_INT16));
+
+	PollingPlan plan(points);
+	assert (plan.requests().size() == 1);
+	const PollRequest& request = plan.requests()[0];
+	assert (request.slaveAddress == 1);
+	assert (request.functionCode == MODBUS_READ_HOLDING_REGISTERS);
+	assert (request.startingAddress == 0);
+	assert (request.quantity == 5);
+	assert (request.points.size() == 4);
+	assert (request.points[0] == 1);
+	assert (request.points[1] == 3);
+	assert (request.points[2] == 0);
+	assert (request.points[3] == 2);
+}
+
+
+void PollingPlanTest::testOverlapping()
+{
+	std::vector<PointDefinition> points;
+	points.push_back(point(10, PointDefinition::TYPE_UINT32));
+	points.push_back(point(11));
+	points.push_back(point(10));
+
+	PollingPlan plan(points);
+	assert (plan.requests().size() == 1);
+	assert (plan.requests()[0].startingAddress == 10);
+	assert (plan.requests()[0].quantity == 2);
+	assert (plan.requests()[0].points.size() == 3);
+}
+
+
+void PollingPlanTest::testGap()
+{
+	std::vector<PointDefinition> points;
+	points.push_back(point(0, PointDefinition::TYPE_UINT32));
+	points.push_back(point(6));
+
+	PollingPlan plan1(points);
+	assert (plan1.requests().size() == 2);
+	assert (plan1.requests()[0].startingAddress == 0);
+	assert (plan1.requests()[0].quantity == 2);
+	assert (plan1.requests()[1].startingAddress == 6);
+	assert (plan1.requests()[1].quantity == 1);
+
+	PollingPlan plan2(points, 3);
+	assert (plan2.requests().size() == 2);
+
+	PollingPlan plan3(points, 4);
+	assert (plan3.requests().size() == 1);
+	assert (plan3.requests()[0].startingAddress == 0);
+	assert (plan3.requests()[0].quantity == 7);
+}
+
+
+void PollingPlanTest::testMaxRegisters()
+{
+	std::vector<PointDefinition> points;
+	for (Poco::UInt16 i = 0; i < 300; i++)
+	{
+		points.push_back(point(i));
+	}
+	PollingPlan plan1(points);
+	assert (plan1.requests().size() == 3);
+	assert (plan1.requests()[0].quantity == 125);
+	assert (plan1.requests()[1].startingAddress == 125);
+	assert (plan1.requests()[1].quantity == 125);
+	assert (plan1.requests()[2].startingAddress == 250);
+	assert (plan1.requests()[2].quantity == 50);
+
+	PollingPlan plan2(points, 0, 100);
+	assert (plan2.requests().size() == 3);
+	assert (plan2.requests()[2].quantity == 100);
+
+	// a 32-bit value is never split across requests
+	points.clear();
+	for (Poco::UInt16 i = 0; i < 124; i++)
+	{
+		points.push_back(point(i));
+	}
+	points.push_back(point(124, PointDefinition::TYPE_INT32));
+	PollingPlan plan3(points);
+	assert (plan3.requests().size() == 2);
+	assert (plan3.requests()[0].quantity == 124);
+	assert (plan3.requests()[1].startingAddress == 124);
+	assert (plan3.requests()[1].quantity == 2);
+}
+
+
+void PollingPlanTest::testBits()
+{
+	std::vector<PointDefinition> points;
+	for (Poco::UInt16 i = 0; i < 2500; i++)
+	{
+		points.push_back(point(i, PointDefinition::TYPE_BOOL, 1, MODBUS_READ_COILS));
+	}
+	PollingPlan plan(points);
+	assert (plan.requests().size() == 2);
+	assert (plan.requests()[0].functionCode == MODBUS_READ_COILS);
+	assert (plan.requests()[0].quantity == 2000);
+	assert (plan.requests()[1].startingAddress == 2000);
+	assert (plan.requests()[1].quantity == 500);
+}
+
+
+void PollingPlanTest::testGrouping()
+{
+	std::vector<PointDefinition> points;
+	points.push_back(point(0, PointDefinition::TYPE_UINT16, 2));
+	points.push_back(point(1, PointDefinition::TYPE_UINT16, 1, MODBUS_READ_INPUT_REGISTERS));
+	points.push_back(point(1, PointDefinition::TYPE_UINT16, 1, MODBUS_READ_HOLDING_REGISTERS, 100));
+	points.push_back(point(0, PointDefinition::TYPE_UINT16, 1));
+	points.push_back(point(0, PointDefinition::TYPE_BOOL, 1, MODBUS_READ_DISCRETE_INPUTS));
+
+	PollingPlan plan(points);
+	const std::vector<PollRequest>& requests = plan.requests();
+	assert (requests.size() == 5);
+
+	assert (requests[0].slaveAddress == 1);
+	assert (requests[0].period == 100);
+	assert (requests[0].points[0] == 2);
+
+	assert (requests[1].slaveAddress == 1);
+	assert (requests[1].period == 1000);
+	assert (requests[1].functionCode == MODBUS_READ_DISCRETE_INPUTS);
+
+	assert (requests[2].functionCode == MODBUS_READ_HOLDING_REGISTERS);
+	assert (requests[2].points[0] == 3);
+
+	assert (requests[3].functionCode == MODBUS_READ_INPUT_REGISTERS);
+
+	assert (requests[4].slaveAddress == 2);
+}
+
+
+void PollingPlanTest::testInvalidPoints()
+{
+	std::vector<PointDefinition> points;
+	points.push_back(point(0, PointDefinition::TYPE_UINT16, 1, MODBUS_READ_COILS));
+	try
+	{
+		PollingPlan plan(points);
+		fail("coil with register type - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	points[0] = point(0, PointDefinition::TYPE_BOOL, 1, MODBUS_READ_HOLDING_REGISTERS);
+	try
+	{
+		PollingPlan plan(points);
+		fail("register with bool type - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	points[0] = point(0, PointDefinition::TYPE_UINT16, 1, MODBUS_WRITE_SINGLE_REGISTER);
+	try
+	{
+		PollingPlan plan(points);
+		fail("not a read function - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	points[0] = point(0xFFFF, PointDefinition::TYPE_UINT32);
+	try
+	{
+		PollingPlan plan(points);
+		fail("address out of range - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+
+	assert (PointDefinition::parseType("float32") == PointDefinition::TYPE_FLOAT32);
+	try
+	{
+		PointDefinition::parseType("float64");
+		fail("invalid type - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void PollingPlanTest::testLargeRegisterMap()
+{
+	// 1200 points on 15 slaves: 40 16-bit values and 40 32-bit values each
+	std::vector<PointDefinition> points;
+	for (Poco::UInt8 slave = 1; slave <= 15; slave++)
+	{
+		for (Poco::UInt16 i = 0; i < 40; i++)
+		{
+			points.push_back(point(100 + i, PointDefinition::TYPE_INT16, slave));
+		}
+		for (Poco::UInt16 i = 0; i < 40; i++)
+		{
+			points.push_back(point(140 + 2*i, PointDefinition::TYPE_FLOAT32, slave));
+		}
+	}
+	PollingPlan plan(points);
+	assert (plan.points().size() == 1200);
+	assert (plan.requests().size() == 15);
+	for (std::size_t i = 0; i < plan.requests().size(); i++)
+	{
+		assert (plan.requests()[i].slaveAddress == i + 1);
+		assert (plan.requests()[i].startingAddress == 100);
+		assert (plan.requests()[i].quantity == 120);
+		assert (plan.requests()[i].points.size() == 80);
+	}
+}
+
+
+void PollingPlanTest::setUp()
+{
+}
+
+
+void PollingPlanTest::tearDown()
+{
+}
+
+
+CppUnit::Test* PollingPlanTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PollingPlanTest");
+
+	CppUnit_addTest(pSuite, PollingPlanTest, testAdjacent);
+	CppUnit_addTest(pSuite, PollingPlanTest, testOverlapping);
+	CppUnit_addTest(pSuite, PollingPlanTest, testGap);
+	CppUnit_addTest(pSuite, PollingPlanTest, testMaxRegisters);
+	CppUnit_addTest(pSuite, PollingPlanTest, testBits);
+	CppUnit_addTest(pSuite, PollingPlanTest, testGrouping);
+	CppUnit_addTest(pSuite, PollingPlanTest, testInvalidPoints);
+	CppUnit_addTest(pSuite, PollingPlanTest, testLargeRegisterMap);
+
+	return pSuite;
+}
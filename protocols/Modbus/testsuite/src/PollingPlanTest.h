@@ -0,0 +1,45 @@
+//
+// PollingPlanTest.h
+//
+// $Id$
+//
+// Definition of the PollingPlanTest class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef PollingPlanTest_INCLUDED
+#define PollingPlanTest_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "CppUnit/TestCase.h"
+
+
+class PollingPlanTest: public CppUnit::TestCase
+{
+public:
+	PollingPlanTest(const std::string& name);
+	~PollingPlanTest();
+
+	void testAdjacent();
+	void testOverlapping();
+	void testGap();
+	void testMaxRegisters();
+	void testBits();
+	void testGrouping();
+	void testInvalidPoints();
+	void testLargeRegisterMap();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // PollingPlanTest_INCLUDED
@@ -0,0 +1,211 @@
+//
+// RTUFramerTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "RTUFramerTest.h"
+#include "RTUSlaveSimulator.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Modbus/RTUFramer.h"
+#include "IoT/Modbus/ModbusMaster.h"
+#include <algorithm>
+
+
+using namespace IoT::Modbus;
+
+
+namespace
+{
+	std::string frame(const std::string& data)
+	{
+		std::string result(data);
+		Poco::UInt16 crc = RTUSlaveSimulator::crc16(data);
+		result += static_cast<char>(crc & 0xFF);
+		result += static_cast<char>(crc >> 8);
+		return result;
+	}
+
+	std::string readRegistersResponse(Poco::UInt8 functionCode, Poco::UInt16 count)
+	{
+		std::string data;
+		data += '\x01';
+		data += static_cast<char>(functionCode);
+		data += static_cast<char>(2*count);
+		for (Poco::UInt16 i = 0; i < count; i++)
+		{
+			data += static_cast<char>(i >> 8);
+			data += static_cast<char>(i & 0xFF);
+		}
+		return frame(data);
+	}
+}
+
+
+RTUFramerTest::RTUFramerTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+RTUFramerTest::~RTUFramerTest()
+{
+}
+
+
+void RTUFramerTest::testResponseLength()
+{
+	assert (RTUFramer::responseLength("", 0) == 0);
+	assert (RTUFramer::responseLength("\x01", 1) == 0);
+	assert (RTUFramer::responseLength("\x01\x03", 2) == 0);
+	assert (RTUFramer::responseLength("\x01\x03\x04", 3) == 9);
+	assert (RTUFramer::responseLength("\x01\x01\x01", 3) == 6);
+	assert (RTUFramer::responseLength("\x01\x17\xFA", 3) == 255);
+	assert (RTUFramer::responseLength("\x01\x83", 2) == 5);
+	assert (RTUFramer::responseLength("\x01\x05", 2) == 8);
+	assert (RTUFramer::responseLength("\x01\x06", 2) == 8);
+	assert (RTUFramer::responseLength("\x01\x0F", 2) == 8);
+	assert (RTUFramer::responseLength("\x01\x10", 2) == 8);
+	assert (RTUFramer::responseLength("\x01\x07", 2) == 5);
+	assert (RTUFramer::responseLength("\x01\x16", 2) == 10);
+	assert (RTUFramer::responseLength("\x01\x18\x00", 3) == 0);
+	assert (RTUFramer::responseLength("\x01\x18\x00\x06", 4) == 12);
+	assert (RTUFramer::responseLength("\x01\x2B", 2) == RTUFramer::LENGTH_UNKNOWN);
+}
+
+
+void RTUFramerTest::testCRC()
+{
+	// example from the Modbus over serial line specification
+	assert (RTUFramer::crc16(0xFFFF, "\x02\x07", 2) == 0x1241);
+
+	std::string data;
+	for (int i = 0; i < 300; i++)
+	{
+		assert (RTUFramer::crc16(0xFFFF, data.data(), data.size()) == RTUSlaveSimulator::crc16(data));
+		data += static_cast<char>((i*37 + 11) & 0xFF);
+	}
+
+	// incremental computation gives the same result, regardless of alignment
+	for (std::size_t split = 0; split < 16; split++)
+	{
+		Poco::UInt16 crc = RTUFramer::crc16(0xFFFF, data.data(), split);
+		crc = RTUFramer::crc16(crc, data.data() + split, data.size() - split);
+		assert (crc == RTUSlaveSimulator::crc16(data));
+	}
+}
+
+
+void RTUFramerTest::testIncremental()
+{
+	std::string response = readRegistersResponse(MODBUS_READ_HOLDING_REGISTERS, 125);
+	assert (response.size() == 255);
+
+	RTUFramer framer;
+	assert (framer.needed() == 3);
+	assert (framer.update(response.data(), 1) == RTUFramer::FRAME_INCOMPLETE);
+	assert (framer.needed() == 2);
+	assert (framer.update(response.data(), 3) == RTUFramer::FRAME_INCOMPLETE);
+	assert (framer.length() == 255);
+	assert (framer.needed() == 252);
+	for (std::size_t n = 4; n < response.size(); n++)
+	{
+		assert (framer.update(response.data(), n) == RTUFramer::FRAME_INCOMPLETE);
+		assert (framer.needed() == response.size() - n);
+	}
+	assert (framer.update(response.data(), response.size()) == RTUFramer::FRAME_COMPLETE);
+	assert (framer.needed() == 0);
+
+	// chunks of varying sizes
+	for (std::size_t chunk = 1; chunk < 20; chunk++)
+	{
+		framer.reset();
+		std::size_t n = 0;
+		RTUFramer::Status status = RTUFramer::FRAME_INCOMPLETE;
+		while (status == RTUFramer::FRAME_INCOMPLETE)
+		{
+			n += std::min(chunk, framer.needed());
+			status = framer.update(response.data(), n);
+		}
+		assert (status == RTUFramer::FRAME_COMPLETE);
+		assert (n == response.size());
+	}
+
+	std::string exception = frame(std::string("\x01\x83\x02", 3));
+	framer.reset();
+	assert (framer.update(exception.data(), 3) == RTUFramer::FRAME_INCOMPLETE);
+	assert (framer.length() == 5);
+	assert (framer.needed() == 2);
+	assert (framer.update(exception.data(), 5) == RTUFramer::FRAME_COMPLETE);
+}
+
+
+void RTUFramerTest::testInvalidCRC()
+{
+	std::string response = readRegistersResponse(MODBUS_READ_INPUT_REGISTERS, 10);
+	response[10] ^= 0x01;
+
+	RTUFramer framer;
+	assert (framer.update(response.data(), 3) == RTUFramer::FRAME_INCOMPLETE);
+	assert (framer.update(response.data(), response.size()) == RTUFramer::FRAME_INVALID);
+	assert (framer.needed() == 0);
+}
+
+
+void RTUFramerTest::testUnknownFunction()
+{
+	std::string response = frame(std::string("\x01\x2B\x0E\x01\x01\x00\x00\x01\x00\x03" "ABC", 13));
+
+	RTUFramer framer;
+	assert (framer.update(response.data(), 3) == RTUFramer::FRAME_INCOMPLETE);
+	assert (framer.length() == RTUFramer::LENGTH_UNKNOWN);
+	assert (framer.needed() == RTUFramer::RTU_MAX_ADU_SIZE - 3);
+	for (std::size_t n = 4; n < response.size(); n++)
+	{
+		assert (framer.update(response.data(), n) == RTUFramer::FRAME_INCOMPLETE);
+	}
+	assert (framer.update(response.data(), response.size()) == RTUFramer::FRAME_COMPLETE);
+	assert (framer.length() == response.size());
+}
+
+
+void RTUFramerTest::testInvalidLength()
+{
+	RTUFramer framer;
+	assert (framer.update("\x01\x18\x01\x00", 4) == RTUFramer::FRAME_INVALID);
+
+	framer.reset();
+	assert (framer.update("\x01\x03\xFC", 3) == RTUFramer::FRAME_INVALID);
+}
+
+
+void RTUFramerTest::setUp()
+{
+}
+
+
+void RTUFramerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* RTUFramerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("RTUFramerTest");
+
+	CppUnit_addTest(pSuite, RTUFramerTest, testResponseLength);
+	CppUnit_addTest(pSuite, RTUFramerTest, testCRC);
+	CppUnit_addTest(pSuite, RTUFramerTest, testIncremental);
+	CppUnit_addTest(pSuite, RTUFramerTest, testInvalidCRC);
+	CppUnit_addTest(pSuite, RTUFramerTest, testUnknownFunction);
+	CppUnit_addTest(pSuite, RTUFramerTest, testInvalidLength);
+
+	return pSuite;
+}
@@ -0,0 +1,43 @@
+//
+// RTUFramerTest.h
+//
+// $Id$
+//
+// Definition of the RTUFramerTest class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef RTUFramerTest_INCLUDED
+#define RTUFramerTest_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "CppUnit/TestCase.h"
+
+
+class RTUFramerTest: public CppUnit::TestCase
+{
+public:
+	RTUFramerTest(const std::string& name);
+	~RTUFramerTest();
+
+	void testResponseLength();
+	void testCRC();
+	void testIncremental();
+	void testInvalidCRC();
+	void testUnknownFunction();
+	void testInvalidLength();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // RTUFramerTest_INCLUDED
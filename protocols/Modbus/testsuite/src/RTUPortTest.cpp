@@ -0,0 +1,205 @@
+//
+// RTUPortTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "RTUPortTest.h"
+#include "RTUSlaveSimulator.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Modbus/RTUPort.h"
+#include "IoT/Modbus/ModbusMasterImpl.h"
+#include "IoT/Serial/SerialPort.h"
+#include "Poco/Thread.h"
+#include "Poco/SharedPtr.h"
+
+
+using namespace IoT::Modbus;
+
+
+namespace
+{
+	typedef ModbusMasterImpl<RTUPort> RTUMaster;
+
+	// A pseudo terminal has no transmission delays, but the slave
+	// simulator is subject to scheduling delays, so the timeouts
+	// are much longer than on a real serial line.
+	const Poco::Timespan INTER_CHAR_TIMEOUT(0, 20000);
+	const Poco::Timespan RESPONSE_TIMEOUT(2, 0);
+
+	Poco::SharedPtr<RTUMaster> createMaster(const RTUSlaveSimulator& slave)
+	{
+		Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort = new IoT::Serial::SerialPort(slave.device(), 115200, "8N1");
+		return new RTUMaster(new RTUPort(pSerialPort, INTER_CHAR_TIMEOUT), RESPONSE_TIMEOUT);
+	}
+
+	bool checkRegisters(const std::vector<Poco::UInt16>& values, Poco::UInt16 first, std::size_t count)
+	{
+		if (values.size() != count) return false;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			if (values[i] != first + i) return false;
+		}
+		return true;
+	}
+}
+
+
+RTUPortTest::RTUPortTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+RTUPortTest::~RTUPortTest()
+{
+}
+
+
+void RTUPortTest::testReadHoldingRegisters()
+{
+	RTUSlaveSimulator slave;
+	Poco::SharedPtr<RTUMaster> pMaster = createMaster(slave);
+
+	assert (checkRegisters(pMaster->readHoldingRegisters(1, 100, 125), 100, 125));
+	assert (checkRegisters(pMaster->readHoldingRegisters(1, 0, 1), 0, 1));
+	assert (slave.requests() == 2);
+}
+
+
+void RTUPortTest::testReadInputRegisters()
+{
+	RTUSlaveSimulator slave;
+	Poco::SharedPtr<RTUMaster> pMaster = createMaster(slave);
+
+	assert (checkRegisters(pMaster->readInputRegisters(1, 10, 2), 1010, 2));
+}
+
+
+void RTUPortTest::testException()
+{
+	RTUSlaveSimulator slave;
+	Poco::SharedPtr<RTUMaster> pMaster = createMaster(slave);
+
+	try
+	{
+		pMaster->readHoldingRegisters(1, 999, 2);
+		fail("illegal address - must throw");
+	}
+	catch (ModbusException& exc)
+	{
+		assert (exc.code() == MODBUS_EXC_ILLEGAL_DATA_ADDRESS);
+	}
+	assert (checkRegisters(pMaster->readHoldingRegisters(1, 5, 3), 5, 3));
+}
+
+
+void RTUPortTest::testChunkedResponse()
+{
+	RTUSlaveSimulator slave;
+	Poco::SharedPtr<RTUMaster> pMaster = createMaster(slave);
+
+	slave.setChunkSize(1);
+	assert (checkRegisters(pMaster->readHoldingRegisters(1, 0, 20), 0, 20));
+
+	slave.setChunkSize(7);
+	assert (checkRegisters(pMaster->readHoldingRegisters(1, 200, 125), 200, 125));
+}
+
+
+void RTUPortTest::testLeadingNull()
+{
+	RTUSlaveSimulator slave;
+	Poco::SharedPtr<RTUMaster> pMaster = createMaster(slave);
+
+	slave.setLeadingNull(true);
+	assert (checkRegisters(pMaster->readHoldingRegisters(1, 0, 10), 0, 10));
+}
+
+
+void RTUPortTest::testCRCError()
+{
+	RTUSlaveSimulator slave;
+	Poco::SharedPtr<RTUMaster> pMaster = createMaster(slave);
+
+	slave.setCorruptCRC(true);
+	try
+	{
+		pMaster->readHoldingRegisters(1, 0, 10);
+		fail("invalid CRC - must throw");
+	}
+	catch (Poco::ProtocolException&)
+	{
+	}
+	slave.setCorruptCRC(false);
+	assert (checkRegisters(pMaster->readHoldingRegisters(1, 0, 10), 0, 10));
+}
+
+
+void RTUPortTest::testGapInFrame()
+{
+	RTUSlaveSimulator slave;
+	Poco::SharedPtr<RTUMaster> pMaster = createMaster(slave);
+
+	slave.setGap(5, 100);
+	try
+	{
+		pMaster->readHoldingRegisters(1, 0, 10);
+		fail("silent interval within frame - must throw");
+	}
+	catch (Poco::ProtocolException&)
+	{
+	}
+
+	// the rest of the incomplete frame must not be mistaken for the next response
+	Poco::Thread::sleep(200);
+	assert (checkRegisters(pMaster->readHoldingRegisters(1, 50, 10), 50, 10));
+}
+
+
+void RTUPortTest::testFrameDelay()
+{
+	RTUSlaveSimulator slave;
+	Poco::SharedPtr<RTUMaster> pMaster = createMaster(slave);
+
+	for (int i = 0; i < 5; i++)
+	{
+		assert (checkRegisters(pMaster->readHoldingRegisters(1, 0, 1), 0, 1));
+	}
+	// t3.5 is 3.5/1.5 times the inter-character timeout
+	assert (slave.minIdleTime() >= INTER_CHAR_TIMEOUT.totalMicroseconds()*7/3);
+}
+
+
+void RTUPortTest::setUp()
+{
+}
+
+
+void RTUPortTest::tearDown()
+{
+}
+
+
+CppUnit::Test* RTUPortTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("RTUPortTest");
+
+	CppUnit_addTest(pSuite, RTUPortTest, testReadHoldingRegisters);
+	CppUnit_addTest(pSuite, RTUPortTest, testReadInputRegisters);
+	CppUnit_addTest(pSuite, RTUPortTest, testException);
+	CppUnit_addTest(pSuite, RTUPortTest, testChunkedResponse);
+	CppUnit_addTest(pSuite, RTUPortTest, testLeadingNull);
+	CppUnit_addTest(pSuite, RTUPortTest, testCRCError);
+	CppUnit_addTest(pSuite, RTUPortTest, testGapInFrame);
+	CppUnit_addTest(pSuite, RTUPortTest, testFrameDelay);
+
+	return pSuite;
+}
@@ -0,0 +1,45 @@
+//
+// RTUPortTest.h
+//
+// $Id$
+//
+// Definition of the RTUPortTest class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef RTUPortTest_INCLUDED
+#define RTUPortTest_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "CppUnit/TestCase.h"
+
+
+class RTUPortTest: public CppUnit::TestCase
+{
+public:
+	RTUPortTest(const std::string& name);
+	~RTUPortTest();
+
+	void testReadHoldingRegisters();
+	void testReadInputRegisters();
+	void testException();
+	void testChunkedResponse();
+	void testLeadingNull();
+	void testCRCError();
+	void testGapInFrame();
+	void testFrameDelay();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // RTUPortTest_INCLUDED
@@ -0,0 +1,291 @@
+//
+// RTUSlaveSimulator.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "RTUSlaveSimulator.h"
+#include "Poco/Exception.h"
+#include <sys/select.h>
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+
+namespace
+{
+	void appendUInt16(std::string& data, Poco::UInt16 value)
+	{
+		data += static_cast<char>(value >> 8);
+		data += static_cast<char>(value & 0xFF);
+	}
+}
+
+
+RTUSlaveSimulator::RTUSlaveSimulator(Poco::UInt8 slaveAddress):
+	_slaveAddress(slaveAddress),
+	_fd(-1),
+	_chunkSize(0),
+	_gapPosition(0),
+	_gap(0),
+	_corruptCRC(false),
+	_leadingNull(false),
+	_responded(false),
+	_minIdle(-1),
+	_stopped(false)
+{
+	_fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if (_fd == -1) throw Poco::IOException("cannot open pseudo terminal", strerror(errno));
+	if (grantpt(_fd) != 0 || unlockpt(_fd) != 0)
+	{
+		close(_fd);
+		throw Poco::IOException("cannot unlock pseudo terminal", strerror(errno));
+	}
+	_device = ptsname(_fd);
+
+	struct termios term;
+	if (tcgetattr(_fd, &term) == 0)
+	{
+		cfmakeraw(&term);
+		tcsetattr(_fd, TCSANOW, &term);
+	}
+
+	_thread.start(*this);
+}
+
+
+RTUSlaveSimulator::~RTUSlaveSimulator()
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_stopped = true;
+	}
+	_thread.join();
+	close(_fd);
+}
+
+
+const std::string& RTUSlaveSimulator::device() const
+{
+	return _device;
+}
+
+
+void RTUSlaveSimulator::setChunkSize(std::size_t size)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_chunkSize = size;
+}
+
+
+void RTUSlaveSimulator::setGap(std::size_t position, long milliseconds)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_gapPosition = position;
+	_gap = milliseconds;
+}
+
+
+void RTUSlaveSimulator::setCorruptCRC(bool corrupt)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_corruptCRC = corrupt;
+}
+
+
+void RTUSlaveSimulator::setLeadingNull(bool leadingNull)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_leadingNull = leadingNull;
+}
+
+
+int RTUSlaveSimulator::requests() const
+{
+	return _requests.value();
+}
+
+
+long RTUSlaveSimulator::minIdleTime() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _minIdle;
+}
+
+
+void RTUSlaveSimulator::run()
+{
+	unsigned char request[8];
+	while (readRequest(request, sizeof(request)))
+	{
+		std::string frame(reinterpret_cast<const char*>(request), 6);
+		Poco::UInt16 crc = request[6] | (request[7] << 8);
+		if (request[0] != _slaveAddress || crc != crc16(frame)) continue;
+
+		++_requests;
+		sendResponse(handleRequest(request));
+	}
+}
+
+
+bool RTUSlaveSimulator::readRequest(unsigned char* request, std::size_t size)
+{
+	std::size_t n = 0;
+	while (n < size)
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_stopped) return false;
+		}
+		fd_set fdRead;
+		FD_ZERO(&fdRead);
+		FD_SET(_fd, &fdRead);
+		struct timeval tv;
+		tv.tv_sec  = 0;
+		tv.tv_usec = 100000;
+		int rc = select(_fd + 1, &fdRead, 0, 0, &tv);
+		if (rc <= 0) continue;
+
+		if (n == 0)
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_responded)
+			{
+				long idle = static_cast<long>(_lastResponse.elapsed());
+				if (_minIdle < 0 || idle < _minIdle) _minIdle = idle;
+				_responded = false;
+			}
+		}
+
+		ssize_t rd = read(_fd, request + n, size - n);
+		if (rd > 0)
+			n += rd;
+		else
+			Poco::Thread::sleep(10); // slave side of pseudo terminal not open
+	}
+	return true;
+}
+
+
+std::string RTUSlaveSimulator::handleRequest(const unsigned char* request)
+{
+	Poco::UInt8 functionCode = request[1];
+	std::string response;
+	response += static_cast<char>(_slaveAddress);
+	if (functionCode == 0x03 || functionCode == 0x04)
+	{
+		Poco::UInt16 address = (request[2] << 8) | request[3];
+		Poco::UInt16 count = (request[4] << 8) | request[5];
+		if (count == 0 || count > 125 || address + count > 1000)
+		{
+			response += static_cast<char>(functionCode | 0x80);
+			response += static_cast<char>(0x02); // illegal data address
+		}
+		else
+		{
+			response += static_cast<char>(functionCode);
+			response += static_cast<char>(2*count);
+			for (Poco::UInt16 i = 0; i < count; i++)
+			{
+				appendUInt16(response, functionCode == 0x03 ? address + i : address + i + 1000);
+			}
+		}
+	}
+	else
+	{
+		response += static_cast<char>(functionCode | 0x80);
+		response += static_cast<char>(0x01); // illegal function
+	}
+	Poco::UInt16 crc = crc16(response);
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (_corruptCRC) crc ^= 0x5555;
+	}
+	response += static_cast<char>(crc & 0xFF);
+	response += static_cast<char>(crc >> 8);
+	return response;
+}
+
+
+void RTUSlaveSimulator::sendResponse(const std::string& response)
+{
+	std::size_t chunkSize;
+	std::size_t gapPosition;
+	long gap;
+	bool leadingNull;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		chunkSize = _chunkSize > 0 ? _chunkSize : response.size();
+		gapPosition = _gapPosition;
+		gap = _gap;
+		leadingNull = _leadingNull;
+		_gap = 0;
+	}
+
+	if (leadingNull) writeBytes("", 1);
+	std::size_t n = 0;
+	while (n < response.size())
+	{
+		std::size_t size = response.size() - n;
+		if (size > chunkSize) size = chunkSize;
+		if (gap > 0 && n < gapPosition && n + size > gapPosition) size = gapPosition - n;
+		writeBytes(response.data() + n, size);
+		n += size;
+		if (gap > 0 && n == gapPosition)
+			Poco::Thread::sleep(gap);
+		else if (n < response.size())
+			Poco::Thread::sleep(1);
+	}
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_lastResponse.update();
+	_responded = true;
+}
+
+
+void RTUSlaveSimulator::writeBytes(const char* data, std::size_t size)
+{
+	while (size > 0)
+	{
+		ssize_t n = write(_fd, data, size);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			throw Poco::IOException("cannot write to pseudo terminal", strerror(errno));
+		}
+		data += n;
+		size -= n;
+	}
+}
+
+
+Poco::UInt16 RTUSlaveSimulator::crc16(const std::string& data)
+{
+	Poco::UInt16 crc = 0xFFFF;
+	for (std::string::const_iterator it = data.begin(); it != data.end(); ++it)
+	{
+		crc ^= static_cast<Poco::UInt8>(*it);
+		for (int i = 0; i < 8; i++)
+		{
+			if (crc & 1)
+				crc = (crc >> 1) ^ 0xA001;
+			else
+				crc >>= 1;
+		}
+	}
+	return crc;
+}
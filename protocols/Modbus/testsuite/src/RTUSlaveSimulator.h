@@ -0,0 +1,105 @@
+//
+// RTUSlaveSimulator.h
+//
+// $Id$
+//
+// Definition of the RTUSlaveSimulator class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef RTUSlaveSimulator_INCLUDED
+#define RTUSlaveSimulator_INCLUDED
+
+
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include "Poco/Clock.h"
+#include "Poco/AtomicCounter.h"
+#include <string>
+
+
+class RTUSlaveSimulator: public Poco::Runnable
+	/// A Modbus RTU slave for testing, connected to the master
+	/// through a pseudo terminal. The master opens the device
+	/// returned by device() with a SerialPort.
+	///
+	/// Supports Read Holding Registers and Read Input Registers.
+	/// Holding register n has the value n, input register n has
+	/// the value n + 1000. Reading from address 1000 or above
+	/// results in an illegal data address exception.
+	///
+	/// Responses can be sent in chunks, with a gap in the middle
+	/// of the frame, preceded by a null byte, or with a corrupted
+	/// CRC, to test the master's frame detection.
+{
+public:
+	RTUSlaveSimulator(Poco::UInt8 slaveAddress = 1);
+		/// Creates and starts the RTUSlaveSimulator.
+
+	~RTUSlaveSimulator();
+		/// Stops and destroys the RTUSlaveSimulator.
+
+	const std::string& device() const;
+		/// Returns the path of the pseudo terminal's slave device.
+
+	void setChunkSize(std::size_t size);
+		/// Sends responses in chunks of the given size,
+		/// with a short pause between chunks. 0 sends
+		/// every response at once (default).
+
+	void setGap(std::size_t position, long milliseconds);
+		/// Pauses for the given time after sending the given
+		/// number of bytes of the next response.
+
+	void setCorruptCRC(bool corrupt);
+		/// If true, the CRC of responses is corrupted.
+
+	void setLeadingNull(bool leadingNull);
+		/// If true, a null byte is sent before every response.
+
+	int requests() const;
+		/// Returns the number of valid requests received.
+
+	long minIdleTime() const;
+		/// Returns the shortest silent interval, in microseconds,
+		/// between the end of a response and the next request,
+		/// or -1 if no request followed a response yet.
+
+	// Runnable
+	void run();
+
+	static Poco::UInt16 crc16(const std::string& data);
+		/// Computes the Modbus CRC of the given data, bit by bit.
+
+protected:
+	bool readRequest(unsigned char* request, std::size_t size);
+	std::string handleRequest(const unsigned char* request);
+	void sendResponse(const std::string& response);
+	void writeBytes(const char* data, std::size_t size);
+
+private:
+	Poco::UInt8 _slaveAddress;
+	int _fd;
+	std::string _device;
+	std::size_t _chunkSize;
+	std::size_t _gapPosition;
+	long _gap;
+	bool _corruptCRC;
+	bool _leadingNull;
+	bool _responded;
+	Poco::Clock _lastResponse;
+	long _minIdle;
+	Poco::AtomicCounter _requests;
+	bool _stopped;
+	Poco::Thread _thread;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+#endif // RTUSlaveSimulator_INCLUDED
@@ -0,0 +1,334 @@
+//
+// TCPPortTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "TCPPortTest.h"
+#include "TCPSlaveSimulator.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Modbus/TCPPort.h"
+#include "IoT/Modbus/ModbusMasterImpl.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/SharedPtr.h"
+
+
+using namespace IoT::Modbus;
+
+
+namespace
+{
+	typedef ModbusMasterImpl<TCPPort> TCPMaster;
+
+	class ReadRunnable: public Poco::Runnable
+	{
+	public:
+		ReadRunnable(TCPMaster& master, Poco::UInt8 unitId, Poco::UInt16 address, Poco::UInt16 count):
+			_master(master),
+			_unitId(unitId),
+			_address(address),
+			_count(count),
+			_failed(false)
+		{
+		}
+
+		void run()
+		{
+			try
+			{
+				_values = _master.readHoldingRegisters(_unitId, _address, _count);
+			}
+			catch (Poco::Exception&)
+			{
+				_failed = true;
+			}
+		}
+
+		bool ok() const
+		{
+			if (_failed || _values.size() != _count) return false;
+			for (Poco::UInt16 i = 0; i < _count; i++)
+			{
+				if (_values[i] != _address + i) return false;
+			}
+			return true;
+		}
+
+	private:
+		TCPMaster& _master;
+		Poco::UInt8 _unitId;
+		Poco::UInt16 _address;
+		Poco::UInt16 _count;
+		std::vector<Poco::UInt16> _values;
+		bool _failed;
+	};
+
+	Poco::SharedPtr<TCPPort> createPort(const TCPSlaveSimulator& slave, int maxPending = TCPPort::DEFAULT_MAX_PENDING)
+	{
+		return new TCPPort(Poco::Net::SocketAddress("127.0.0.1", slave.port()), Poco::Timespan(2, 0), maxPending);
+	}
+}
+
+
+TCPPortTest::TCPPortTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+TCPPortTest::~TCPPortTest()
+{
+}
+
+
+void TCPPortTest::testReadHoldingRegisters()
+{
+	TCPSlaveSimulator slave;
+	TCPMaster master(createPort(slave));
+
+	std::vector<Poco::UInt16> values = master.readHoldingRegisters(1, 100, 125);
+	assert (values.size() == 125);
+	for (int i = 0; i < 125; i++)
+	{
+		assert (values[i] == 100 + i);
+	}
+}
+
+
+void TCPPortTest::testReadInputRegisters()
+{
+	TCPSlaveSimulator slave;
+	TCPMaster master(createPort(slave));
+
+	std::vector<Poco::UInt16> values = master.readInputRegisters(1, 10, 2);
+	assert (values.size() == 2);
+	assert (values[0] == 1010);
+	assert (values[1] == 1011);
+}
+
+
+void TCPPortTest::testException()
+{
+	TCPSlaveSimulator slave;
+	TCPMaster master(createPort(slave));
+
+	try
+	{
+		master.readHoldingRegisters(1, 999, 2);
+		fail("illegal address - must throw");
+	}
+	catch (ModbusException& exc)
+	{
+		assert (exc.exceptionCode() == MODBUS_EXC_ILLEGAL_DATA_ADDRESS);
+	}
+
+	// the connection is still usable
+	assert (master.readHoldingRegisters(1, 0, 1)[0] == 0);
+}
+
+
+void TCPPortTest::testPipelining()
+{
+	const int REQUESTS = 8;
+	TCPSlaveSimulator slave;
+	slave.setDelay(1, 200);
+	TCPMaster master(createPort(slave));
+
+	std::vector<Poco::SharedPtr<ReadRunnable> > runnables;
+	std::vector<Poco::SharedPtr<Poco::Thread> > threads;
+	Poco::Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < REQUESTS; i++)
+	{
+		runnables.push_back(new ReadRunnable(master, 1, static_cast<Poco::UInt16>(10*i), 10));
+		threads.push_back(new Poco::Thread);
+		threads.back()->start(*runnables.back());
+	}
+	for (int i = 0; i < REQUESTS; i++)
+	{
+		threads[i]->join();
+		assert (runnables[i]->ok());
+	}
+	sw.stop();
+
+	// sequential requests would take REQUESTS*200 ms
+	assert (sw.elapsed() < 4*200000);
+	assert (slave.maxConcurrentRequests() > 1);
+	assert (slave.connections() == 1);
+}
+
+
+void TCPPortTest::testMaxPending()
+{
+	const int REQUESTS = 4;
+	TCPSlaveSimulator slave;
+	slave.setDelay(1, 20);
+	TCPMaster master(createPort(slave, 1));
+
+	std::vector<Poco::SharedPtr<ReadRunnable> > runnables;
+	std::vector<Poco::SharedPtr<Poco::Thread> > threads;
+	for (int i = 0; i < REQUESTS; i++)
+	{
+		runnables.push_back(new ReadRunnable(master, 1, static_cast<Poco::UInt16>(10*i), 10));
+		threads.push_back(new Poco::Thread);
+		threads.back()->start(*runnables.back());
+	}
+	for (int i = 0; i < REQUESTS; i++)
+	{
+		threads[i]->join();
+		assert (runnables[i]->ok());
+	}
+	assert (slave.maxConcurrentRequests() == 1);
+}
+
+
+void TCPPortTest::testOutOfOrderResponses()
+{
+	TCPSlaveSimulator slave;
+	slave.setDelay(2, 500);
+	TCPMaster master(createPort(slave));
+
+	ReadRunnable slowRead(master, 2, 0, 10);
+	Poco::Thread thread;
+	thread.start(slowRead);
+	Poco::Thread::sleep(50);
+
+	// the response from unit 1 overtakes the response from unit 2
+	Poco::Stopwatch sw;
+	sw.start();
+	assert (master.readHoldingRegisters(1, 20, 1)[0] == 20);
+	sw.stop();
+	assert (sw.elapsed() < 250000);
+
+	thread.join();
+	assert (slowRead.ok());
+}
+
+
+void TCPPortTest::testUnitTimeout()
+{
+	TCPSlaveSimulator slave;
+	slave.setDelay(3, -1);
+	Poco::SharedPtr<TCPPort> pPort = createPort(slave);
+	pPort->setUnitTimeout(3, Poco::Timespan(0, 200000));
+	TCPMaster master(pPort, Poco::Timespan(5, 0));
+
+	Poco::Stopwatch sw;
+	sw.start();
+	try
+	{
+		master.readHoldingRegisters(3, 0, 1);
+		fail("unit does not respond - must throw");
+	}
+	catch (Poco::TimeoutException&)
+	{
+	}
+	sw.stop();
+	assert (sw.elapsed() < 1000000);
+
+	assert (master.readHoldingRegisters(1, 5, 1)[0] == 5);
+}
+
+
+void TCPPortTest::testUnansweredFrames()
+{
+	TCPSlaveSimulator slave;
+	slave.setDelay(3, -1);
+	Poco::SharedPtr<TCPPort> pPort = createPort(slave, 2);
+	pPort->setFrameTimeout(Poco::Timespan(0, 200000));
+	TCPMaster master(pPort);
+
+	ReadHoldingRegistersRequest request;
+	request.slaveOrUnitAddress = 3;
+	request.startingAddress = 0;
+	request.nOfRegisters = 1;
+	master.sendReadHoldingRegistersRequest(request);
+	master.sendReadHoldingRegistersRequest(request);
+	try
+	{
+		master.sendReadHoldingRegistersRequest(request);
+		fail("too many outstanding requests - must throw");
+	}
+	catch (Poco::TimeoutException&)
+	{
+	}
+
+	// a synchronous request waits until the unanswered requests expire
+	Poco::Stopwatch sw;
+	sw.start();
+	assert (master.readHoldingRegisters(1, 7, 1)[0] == 7);
+	sw.stop();
+	assert (sw.elapsed() >= 100000);
+	assert (sw.elapsed() < 1000000);
+
+	// and so do further asynchronous requests
+	master.sendReadHoldingRegistersRequest(request);
+	master.sendReadHoldingRegistersRequest(request);
+	Poco::Thread::sleep(300);
+	assert (!pPort->poll(Poco::Timespan(0)));
+	master.sendReadHoldingRegistersRequest(request);
+	assert (pPort->connected());
+	assert (slave.connections() == 1);
+}
+
+
+void TCPPortTest::testReconnect()
+{
+	TCPSlaveSimulator slave;
+	slave.setDisconnectAfter(2);
+	Poco::SharedPtr<TCPPort> pPort = createPort(slave);
+	TCPMaster master(pPort);
+
+	assert (master.readHoldingRegisters(1, 1, 1)[0] == 1);
+	try
+	{
+		master.readHoldingRegisters(1, 2, 1);
+		fail("connection closed - must throw");
+	}
+	catch (Poco::IOException&)
+	{
+	}
+	Poco::Thread::sleep(50);
+	assert (!pPort->connected());
+
+	assert (master.readHoldingRegisters(1, 3, 1)[0] == 3);
+	assert (slave.connections() == 2);
+}
+
+
+void TCPPortTest::setUp()
+{
+}
+
+
+void TCPPortTest::tearDown()
+{
+}
+
+
+CppUnit::Test* TCPPortTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TCPPortTest");
+
+	CppUnit_addTest(pSuite, TCPPortTest, testReadHoldingRegisters);
+	CppUnit_addTest(pSuite, TCPPortTest, testReadInputRegisters);
+	CppUnit_addTest(pSuite, TCPPortTest, testException);
+	CppUnit_addTest(pSuite, TCPPortTest, testPipelining);
+	CppUnit_addTest(pSuite, TCPPortTest, testMaxPending);
+	CppUnit_addTest(pSuite, TCPPortTest, testOutOfOrderResponses);
+	CppUnit_addTest(pSuite, TCPPortTest, testUnitTimeout);
+	CppUnit_addTest(pSuite, TCPPortTest, testUnansweredFrames);
+	CppUnit_addTest(pSuite, TCPPortTest, testReconnect);
+
+	return pSuite;
+}
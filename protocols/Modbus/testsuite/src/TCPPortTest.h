@@ -0,0 +1,46 @@
+//
+// TCPPortTest.h
+//
+// $Id$
+//
+// Definition of the TCPPortTest class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TCPPortTest_INCLUDED
+#define TCPPortTest_INCLUDED
+
+
+#include "IoT/Modbus/Modbus.h"
+#include "CppUnit/TestCase.h"
+
+
+class TCPPortTest: public CppUnit::TestCase
+{
+public:
+	TCPPortTest(const std::string& name);
+	~TCPPortTest();
+
+	void testReadHoldingRegisters();
+	void testReadInputRegisters();
+	void testException();
+	void testPipelining();
+	void testMaxPending();
+	void testOutOfOrderResponses();
+	void testUnitTimeout();
+	void testUnansweredFrames();
+	void testReconnect();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // TCPPortTest_INCLUDED
@@ -0,0 +1,328 @@
+//
+// TCPSlaveSimulator.cpp
+//
+// $Id$
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "TCPSlaveSimulator.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Util/TimerTask.h"
+#include "Poco/Clock.h"
+#include "Poco/Exception.h"
+
+
+class TCPSlaveSimulator::ResponseTask: public Poco::Util::TimerTask
+{
+public:
+	ResponseTask(TCPSlaveSimulator& simulator, const Poco::Net::StreamSocket& socket, const std::string& response):
+		_simulator(simulator),
+		_socket(socket),
+		_response(response)
+	{
+	}
+
+	void run()
+	{
+		_simulator.sendResponse(_socket, _response);
+	}
+
+private:
+	TCPSlaveSimulator& _simulator;
+	Poco::Net::StreamSocket _socket;
+	std::string _response;
+};
+
+
+namespace
+{
+	bool receiveBytes(Poco::Net::StreamSocket& socket, unsigned char* buffer, std::size_t size)
+	{
+		std::size_t received = 0;
+		while (received < size)
+		{
+			int n = socket.receiveBytes(buffer + received, static_cast<int>(size - received));
+			if (n <= 0) return false;
+			received += n;
+		}
+		return true;
+	}
+
+	void appendUInt16(std::string& data, Poco::UInt16 value)
+	{
+		data += static_cast<char>(value >> 8);
+		data += static_cast<char>(value & 0xFF);
+	}
+}
+
+
+TCPSlaveSimulator::TCPSlaveSimulator():
+	_serverSocket(Poco::Net::SocketAddress("127.0.0.1", 0)),
+	_disconnectAfter(0),
+	_concurrent(0),
+	_maxConcurrent(0),
+	_stopped(false)
+{
+	_thread.start(*this);
+}
+
+
+TCPSlaveSimulator::~TCPSlaveSimulator()
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_stopped = true;
+		try
+		{
+			_socket.shutdown();
+		}
+		catch (Poco::Exception&)
+		{
+		}
+	}
+	_thread.join();
+	_timer.cancel(true);
+}
+
+
+Poco::UInt16 TCPSlaveSimulator::port() const
+{
+	return _serverSocket.address().port();
+}
+
+
+void TCPSlaveSimulator::setDelay(Poco::UInt8 unitId, long milliseconds)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_delays[unitId] = milliseconds;
+}
+
+
+void TCPSlaveSimulator::setHoldingRegister(Poco::UInt16 address, Poco::UInt16 value)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_holdingRegisters[address] = value;
+}
+
+
+bool TCPSlaveSimulator::coil(Poco::UInt16 address) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	std::map<Poco::UInt16, bool>::const_iterator it = _coils.find(address);
+	if (it != _coils.end())
+		return it->second;
+	else
+		return address % 2 == 1;
+}
+
+
+void TCPSlaveSimulator::setDisconnectAfter(int requests)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_disconnectAfter = requests;
+}
+
+
+int TCPSlaveSimulator::requests() const
+{
+	return _requests.value();
+}
+
+
+int TCPSlaveSimulator::maxConcurrentRequests() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _maxConcurrent;
+}
+
+
+int TCPSlaveSimulator::connections() const
+{
+	return _connections.value();
+}
+
+
+void TCPSlaveSimulator::run()
+{
+	while (true)
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_stopped) break;
+		}
+		if (!_serverSocket.poll(Poco::Timespan(0, 100000), Poco::Net::Socket::SELECT_READ)) continue;
+
+		Poco::Net::StreamSocket socket = _serverSocket.acceptConnection();
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_stopped) break;
+			_socket = socket;
+		}
+		++_connections;
+		try
+		{
+			handleConnection(socket);
+		}
+		catch (Poco::Exception&)
+		{
+		}
+		socket.close();
+	}
+}
+
+
+void TCPSlaveSimulator::handleConnection(Poco::Net::StreamSocket& socket)
+{
+	unsigned char frame[260];
+	while (receiveBytes(socket, frame, 7))
+	{
+		std::size_t length = (frame[4] << 8) | frame[5];
+		if (length < 2 || length > 254) return;
+		if (!receiveBytes(socket, frame + 7, length - 1)) return;
+
+		int requests = ++_requests;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_disconnectAfter > 0 && requests >= _disconnectAfter)
+			{
+				_disconnectAfter = 0;
+				return;
+			}
+		}
+		handleRequest(socket, frame, length + 6);
+	}
+}
+
+
+void TCPSlaveSimulator::handleRequest(Poco::Net::StreamSocket& socket, const unsigned char* request, std::size_t size)
+{
+	Poco::UInt8 unitId = request[6];
+	Poco::UInt8 functionCode = request[7];
+	std::string pdu;
+	if ((functionCode == 0x01 || functionCode == 0x02) && size == 12)
+	{
+		Poco::UInt16 address = (request[8] << 8) | request[9];
+		Poco::UInt16 count = (request[10] << 8) | request[11];
+		if (count == 0 || count > 2000 || address + count > 1000)
+		{
+			pdu += static_cast<char>(functionCode | 0x80);
+			pdu += static_cast<char>(0x02); // illegal data address
+		}
+		else
+		{
+			pdu += static_cast<char>(functionCode);
+			pdu += static_cast<char>((count + 7)/8);
+			unsigned char bits = 0;
+			for (Poco::UInt16 i = 0; i < count; i++)
+			{
+				bool on = functionCode == 0x01 ? coil(address + i) : (address + i) % 3 == 0;
+				if (on) bits |= 1 << (i % 8);
+				if (i % 8 == 7 || i == count - 1)
+				{
+					pdu += static_cast<char>(bits);
+					bits = 0;
+				}
+			}
+		}
+	}
+	else if (functionCode == 0x05 && size == 12)
+	{
+		Poco::UInt16 address = (request[8] << 8) | request[9];
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_coils[address] = request[10] == 0xFF;
+		}
+		pdu.assign(reinterpret_cast<const char*>(request + 7), 5);
+	}
+	else if ((functionCode == 0x03 || functionCode == 0x04) && size == 12)
+	{
+		Poco::UInt16 address = (request[8] << 8) | request[9];
+		Poco::UInt16 count = (request[10] << 8) | request[11];
+		if (count == 0 || count > 125 || address + count > 1000)
+		{
+			pdu += static_cast<char>(functionCode | 0x80);
+			pdu += static_cast<char>(0x02); // illegal data address
+		}
+		else
+		{
+			pdu += static_cast<char>(functionCode);
+			pdu += static_cast<char>(2*count);
+			for (Poco::UInt16 i = 0; i < count; i++)
+			{
+				appendUInt16(pdu, functionCode == 0x03 ? holdingRegister(address + i) : address + i + 1000);
+			}
+		}
+	}
+	else
+	{
+		pdu += static_cast<char>(functionCode | 0x80);
+		pdu += static_cast<char>(0x01); // illegal function
+	}
+
+	std::string response(reinterpret_cast<const char*>(request), 4); // transaction and protocol identifier
+	appendUInt16(response, static_cast<Poco::UInt16>(pdu.size() + 1));
+	response += static_cast<char>(unitId);
+	response += pdu;
+
+	long ms = delay(unitId);
+	if (ms < 0) return;
+
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		if (++_concurrent > _maxConcurrent) _maxConcurrent = _concurrent;
+	}
+	Poco::Clock clock;
+	clock += 1000*ms;
+	_timer.schedule(new ResponseTask(*this, socket, response), clock);
+}
+
+
+void TCPSlaveSimulator::sendResponse(Poco::Net::StreamSocket& socket, const std::string& response)
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_concurrent--;
+	}
+	try
+	{
+		Poco::FastMutex::ScopedLock lock(_sendMutex);
+		socket.sendBytes(response.data(), static_cast<int>(response.size()));
+	}
+	catch (Poco::Exception&)
+	{
+	}
+}
+
+
+long TCPSlaveSimulator::delay(Poco::UInt8 unitId) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	std::map<Poco::UInt8, long>::const_iterator it = _delays.find(unitId);
+	if (it != _delays.end())
+		return it->second;
+	else
+		return 0;
+}
+
+
+Poco::UInt16 TCPSlaveSimulator::holdingRegister(Poco::UInt16 address) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	std::map<Poco::UInt16, Poco::UInt16>::const_iterator it = _holdingRegisters.find(address);
+	if (it != _holdingRegisters.end())
+		return it->second;
+	else
+		return address;
+}
@@ -0,0 +1,108 @@
+//
+// TCPSlaveSimulator.h
+//
+// $Id$
+//
+// Definition of the TCPSlaveSimulator class.
+//
+// Copyright (c) 2015-2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TCPSlaveSimulator_INCLUDED
+#define TCPSlaveSimulator_INCLUDED
+
+
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Util/Timer.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include "Poco/AtomicCounter.h"
+#include <map>
+
+
+class TCPSlaveSimulator: public Poco::Runnable
+	/// A Modbus TCP slave for testing, serving one connection at a time.
+	///
+	/// Supports Read Coils, Read Discrete Inputs, Read Holding Registers,
+	/// Read Input Registers and Write Single Coil. Holding register n has
+	/// the value n (unless changed with setHoldingRegister()), input register
+	/// n has the value n + 1000. Coil n is initially on if n is odd, discrete
+	/// input n is on if n is divisible by 3. Reading from address 1000 or
+	/// above results in an illegal data address exception.
+	///
+	/// Responses are sent after a configurable per-unit delay, so
+	/// multiple requests can be processed at the same time and
+	/// responses may be sent in a different order than the requests.
+{
+public:
+	TCPSlaveSimulator();
+		/// Creates and starts the TCPSlaveSimulator.
+
+	~TCPSlaveSimulator();
+		/// Stops and destroys the TCPSlaveSimulator.
+
+	Poco::UInt16 port() const;
+		/// Returns the port number the simulator is listening on.
+
+	void setDelay(Poco::UInt8 unitId, long milliseconds);
+		/// Sets the response delay for the given unit.
+		/// A negative delay means that the unit never responds.
+
+	void setHoldingRegister(Poco::UInt16 address, Poco::UInt16 value);
+		/// Sets the value of the given holding register.
+
+	bool coil(Poco::UInt16 address) const;
+		/// Returns the state of the given coil.
+
+	void setDisconnectAfter(int requests);
+		/// Closes the connection, without responding, when the
+		/// given number of requests has been received.
+
+	int requests() const;
+		/// Returns the number of requests received.
+
+	int maxConcurrentRequests() const;
+		/// Returns the maximum number of requests waiting
+		/// for their response at the same time.
+
+	int connections() const;
+		/// Returns the number of accepted connections.
+
+	// Runnable
+	void run();
+
+protected:
+	class ResponseTask;
+
+	void handleConnection(Poco::Net::StreamSocket& socket);
+	void handleRequest(Poco::Net::StreamSocket& socket, const unsigned char* request, std::size_t size);
+	void sendResponse(Poco::Net::StreamSocket& socket, const std::string& response);
+	long delay(Poco::UInt8 unitId) const;
+	Poco::UInt16 holdingRegister(Poco::UInt16 address) const;
+
+private:
+	Poco::Net::ServerSocket _serverSocket;
+	Poco::Net::StreamSocket _socket;
+	Poco::Thread _thread;
+	Poco::Util::Timer _timer;
+	std::map<Poco::UInt8, long> _delays;
+	std::map<Poco::UInt16, Poco::UInt16> _holdingRegisters;
+	std::map<Poco::UInt16, bool> _coils;
+	int _disconnectAfter;
+	Poco::AtomicCounter _requests;
+	Poco::AtomicCounter _connections;
+	int _concurrent;
+	int _maxConcurrent;
+	bool _stopped;
+	mutable Poco::FastMutex _mutex;
+	Poco::FastMutex _sendMutex;
+};
+
+
+#endif // TCPSlaveSimulator_INCLUDED
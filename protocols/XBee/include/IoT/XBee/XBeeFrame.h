@@ -117,6 +117,10 @@ public:
 	static ReadStatus read(XBeeFrame& frame, const char* buffer, std::size_t size);
 		/// Attempts to read a frame from the given buffer.
 		///
+		/// Only the first frame in the buffer is read, and escaped
+		/// frames are not supported. Use XBeeFrameParser to
+		/// extract frames from a stream of received data.
+		///
 		/// Returns:
 		///   - XBEE_FRAME_OK if a valid frame was found.
 		///   - XBEE_FRAME_NOT_ENOUGH_DATA if the buffer does not contain enough data
@@ -148,6 +152,8 @@ protected:
 
 private:
 	std::vector<char> _frame;
+
+	friend class XBeeFrameParser;
 };
 
 
@@ -0,0 +1,185 @@
+//
+// XBeeFrameParser.h
+//
+// $Id$
+//
+// Library: IoT/XBee
+// Package: XBee
+// Module:  XBeeFrameParser
+//
+// Definition of the XBeeFrameParser class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_XBee_XBeeFrameParser_INCLUDED
+#define IoT_XBee_XBeeFrameParser_INCLUDED
+
+
+#include "IoT/XBee/XBee.h"
+#include "IoT/XBee/XBeeFrame.h"
+#include "Poco/Buffer.h"
+
+
+namespace IoT {
+namespace XBee {
+
+
+class IoTXBee_API XBeeFrameParser
+	/// XBeeFrameParser extracts API frames from the stream
+	/// of bytes received from a Digi XBee module.
+	///
+	/// Received data is kept in a ring buffer. Data is appended
+	/// either by copying it with write(), or by reading it directly
+	/// into the ring buffer, using writeBegin() and commit().
+	/// nextFrame() extracts all complete frames, one after another.
+	/// Data that does not belong to a frame with a valid
+	/// checksum is skipped.
+	///
+	/// If escaping is enabled (API mode 2, AP=2), escaped bytes
+	/// are unescaped during extraction, and a start delimiter
+	/// within a frame is recognized as the start of a new frame.
+{
+public:
+	enum
+	{
+		DEFAULT_BUFFER_SIZE = 4*XBeeFrame::XBEE_MAX_FRAME_LENGTH
+			/// Default size of the ring buffer. Must be able to hold
+			/// at least one escaped frame of maximum size.
+	};
+
+	explicit XBeeFrameParser(std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates a XBeeFrameParser with the given ring buffer size,
+		/// which must be at least 2*XBeeFrame::XBEE_MAX_FRAME_LENGTH.
+
+	~XBeeFrameParser();
+		/// Destroys the XBeeFrameParser.
+
+	void setEscapeFrames(bool escape);
+		/// Enables or disables unescaping of received frames (AP=2).
+
+	bool getEscapeFrames() const;
+		/// Returns true if received frames are unescaped.
+
+	std::size_t write(const char* data, std::size_t size);
+		/// Appends the given data to the ring buffer.
+		///
+		/// Returns the number of bytes appended, which is less than
+		/// size if the ring buffer becomes full. In this case,
+		/// call nextFrame() to make space.
+
+	char* writeBegin(std::size_t& size);
+		/// Returns a pointer to the free space at the end of
+		/// the ring buffer, and stores the number of bytes that
+		/// can be written there in size. This may be less than
+		/// space() if the free space wraps around.
+		///
+		/// After writing data, call commit() with the number of
+		/// bytes actually written.
+
+	void commit(std::size_t size);
+		/// Appends size bytes written to the pointer obtained
+		/// from writeBegin().
+
+	bool nextFrame(XBeeFrame& frame);
+		/// Extracts the next complete frame with a valid checksum
+		/// from the ring buffer and stores it, unescaped, in frame.
+		///
+		/// Returns true if a frame has been extracted, or false
+		/// if more data is needed. In the latter case, frame
+		/// is not modified.
+
+	bool frameAvailable() const;
+		/// Returns false if nextFrame() has returned false and
+		/// no data has been appended since, otherwise true.
+
+	std::size_t available() const;
+		/// Returns the number of bytes in the ring buffer.
+
+	std::size_t space() const;
+		/// Returns the number of bytes that can be appended
+		/// to the ring buffer.
+
+	Poco::UInt64 discarded() const;
+		/// Returns the total number of received bytes that
+		/// have been skipped, because they did not belong to
+		/// a valid frame.
+
+	void reset();
+		/// Discards all data in the ring buffer.
+
+protected:
+	enum ScanResult
+	{
+		SCAN_OK,
+		SCAN_NOT_ENOUGH_DATA,
+		SCAN_INVALID,
+		SCAN_RESYNC
+	};
+
+	ScanResult scan(char* pFrame, std::size_t& rawSize, std::size_t& resyncPos, std::size_t& length) const;
+	int at(std::size_t pos) const;
+	void consume(std::size_t size);
+
+private:
+	XBeeFrameParser(const XBeeFrameParser&);
+	XBeeFrameParser& operator = (const XBeeFrameParser&);
+
+	Poco::Buffer<char> _buffer;
+	std::size_t _begin;
+	std::size_t _size;
+	bool _escape;
+	bool _needData;
+	Poco::UInt64 _discarded;
+};
+
+
+//
+// inlines
+//
+inline bool XBeeFrameParser::getEscapeFrames() const
+{
+	return _escape;
+}
+
+
+inline bool XBeeFrameParser::frameAvailable() const
+{
+	return _size > 0 && !_needData;
+}
+
+
+inline std::size_t XBeeFrameParser::available() const
+{
+	return _size;
+}
+
+
+inline std::size_t XBeeFrameParser::space() const
+{
+	return _buffer.size() - _size;
+}
+
+
+inline Poco::UInt64 XBeeFrameParser::discarded() const
+{
+	return _discarded;
+}
+
+
+inline int XBeeFrameParser::at(std::size_t pos) const
+{
+	pos += _begin;
+	if (pos >= _buffer.size()) pos -= _buffer.size();
+	return static_cast<unsigned char>(_buffer[pos]);
+}
+
+
+} } // namespace IoT::XBee
+
+
+#endif // IoT_XBee_XBeeFrameParser_INCLUDED
@@ -22,22 +22,42 @@
 
 #include "IoT/XBee/XBeeNode.h"
 #include "IoT/XBee/XBeePort.h"
+#include "IoT/XBee/XBeeFrame.h"
+#include "IoT/Serial/SerialReactor.h"
 #include "Poco/Thread.h"
 #include "Poco/Runnable.h"
 #include "Poco/Mutex.h"
 #include "Poco/SharedPtr.h"
+#include "Poco/Clock.h"
+#include "Poco/Timespan.h"
 #include "Poco/Logger.h"
+#include <deque>
+#include <map>
 
 
 namespace IoT {
 namespace XBee {
 
 
-class XBeeFrame;
-
-
-class IoTXBee_API XBeeNodeImpl: public XBeeNode, public Poco::Runnable
+class IoTXBee_API XBeeNodeImpl: public XBeeNode, public Poco::Runnable, public IoT::Serial::SerialReactor::Handler
 	/// Implementation of the XBeeNode interface.
+	///
+	/// If supported on the current platform, the serial port
+	/// is served by the default IoT::Serial::SerialReactor. 
+	/// Otherwise, the XBeeNodeImpl starts its own thread for
+	/// receiving frames.
+	///
+	/// Transmit requests are subject to a transmit window.
+	/// Up to a configurable number of transmit requests are
+	/// sent to the XBee module without waiting for the respective
+	/// transmit status. Further transmit requests are queued until
+	/// a transmit status has been received or a transmit request
+	/// has timed out. To correlate transmit status frames with 
+	/// transmit requests, the XBeeNodeImpl assigns its own frame IDs
+	/// to transmit requests. The frame IDs given by the caller are
+	/// restored in the transmit status. As the XBee module does not
+	/// send a transmit status for a frame ID of 0, no transmit status
+	/// is reported for transmit requests with a frame ID of 0.
 {
 public:
 	enum Options
@@ -47,7 +67,16 @@ public:
 	
 	enum
 	{
-		XBEE_MAX_PAYLOAD_SIZE = 100
+		XBEE_MAX_PAYLOAD_SIZE = 100,
+		XBEE_MAX_TRANSMIT_WINDOW = 255
+	};
+	
+	enum
+	{
+		DEFAULT_TRANSMIT_WINDOW = 4,
+			/// Default number of transmit requests in flight.
+		DEFAULT_TRANSMIT_TIMEOUT = 10000
+			/// Default transmit timeout in milliseconds.
 	};
 	
 	XBeeNodeImpl(Poco::SharedPtr<XBeePort> pXBeePort, int options = 0);
@@ -57,6 +86,34 @@ public:
 	~XBeeNodeImpl();
 		/// Destroys the ZBPort.
 
+	void setTransmitWindow(int window);
+		/// Sets the maximum number of transmit requests that are
+		/// sent to the XBee module without having received the
+		/// respective transmit status. The maximum is 255.
+		///
+		/// A window of 0 disables the transmit window. Transmit
+		/// requests are then sent immediately and frame IDs are
+		/// passed through unchanged.
+
+	int getTransmitWindow() const;
+		/// Returns the size of the transmit window.
+
+	void setTransmitTimeout(const Poco::Timespan& timeout);
+		/// Sets the time after which a transmit request for which
+		/// no transmit status has been received is no longer
+		/// counted against the transmit window.
+
+	Poco::Timespan getTransmitTimeout() const;
+		/// Returns the transmit timeout.
+
+	std::size_t transmitsInFlight() const;
+		/// Returns the number of transmit requests waiting for
+		/// a transmit status.
+
+	std::size_t transmitsQueued() const;
+		/// Returns the number of transmit requests waiting to
+		/// be sent.
+
 	// XBeeNode
 	void sendFrame(const APIFrame& frame);
 	void sendCommand(const ATCommand& command);
@@ -67,14 +124,34 @@ public:
 	void sendExplicitAddressingZigBeeTransmitRequest(const ExplicitAddressingZigBeeTransmitRequest& request);
 	
 protected:
+	struct PendingTransmit
+	{
+		XBeeFrame::FrameType type;
+		std::string data;
+	};
+	
+	struct Transmit
+	{
+		Poco::UInt8 frameID;
+		Poco::Clock sent;
+	};
+	
+	typedef std::deque<PendingTransmit> PendingTransmits;
+	typedef std::map<Poco::UInt8, Transmit> Transmits;
+
+	enum
+	{
+		TIMER_INTERVAL = 200
+	};
+
 	void run();
 	void start();
 	void stop();
 	void handleFrame(const XBeeFrame& frame);
-	void handleTransmitStatusReceived(const XBeeFrame& frame);
+	void handleTransmitStatusReceived(const XBeeFrame& frame, Poco::UInt8 frameID);
 	void handlePacketReceived(const XBeeFrame& frame);
 	void handleIODataReceived(const XBeeFrame& frame);
-	void handleZigBeeTransmitStatusReceived(const XBeeFrame& frame);
+	void handleZigBeeTransmitStatusReceived(const XBeeFrame& frame, Poco::UInt8 frameID);
 	void handleZigBeePacketReceived(const XBeeFrame& frame);
 	void handleExplicitAddressingZigBeePacketReceived(const XBeeFrame& frame);
 	void handleModemStatus(const XBeeFrame& frame);
@@ -82,11 +159,30 @@ protected:
 	void handleRemoteCommandResponse(const XBeeFrame& frame);
 	void handleSampleRxIndicator(const XBeeFrame& frame);
 	void handleSensorRead(const XBeeFrame& frame);
-	void sendFrame(XBeeFrame& frame);
+	void sendFrame(const XBeeFrame& frame);
+	void writeFrame(const XBeeFrame& frame);
+	void submitTransmit(XBeeFrame::FrameType type, const char* data, std::size_t size);
+	void dispatchTransmits();
+	bool completeTransmit(const XBeeFrame& frame, Poco::UInt8& frameID);
+	void expireTransmits();
+	Poco::UInt8 allocateFrameID();
+	static bool isTransmitRequest(int frameType);
+	static bool isTransmitStatus(int frameType);
+
+	// SerialReactor::Handler
+	void onDataReceived(const char* data, std::size_t size);
+	void onTimer();
+	void onError(const Poco::Exception& exc);
 
 private:
 	Poco::SharedPtr<XBeePort> _pXBeePort;
 	int _options;
+	IoT::Serial::SerialReactor* _pReactor;
+	PendingTransmits _pendingTransmits;
+	Transmits _transmits;
+	Poco::UInt8 _nextFrameID;
+	int _transmitWindow;
+	Poco::Timespan _transmitTimeout;
 	Poco::Thread _thread;	
 	bool _stopped;
 	mutable Poco::FastMutex _mutex;
@@ -21,9 +21,9 @@
 
 
 #include "IoT/XBee/XBee.h"
+#include "IoT/XBee/XBeeFrameParser.h"
 #include "IoT/Serial/SerialPort.h"
 #include "Poco/Timespan.h"
-#include "Poco/Buffer.h"
 #include "Poco/SharedPtr.h"
 
 
@@ -37,6 +37,10 @@ class XBeeFrame;
 class IoTXBee_API XBeePort
 	/// This class provides an interface to a Digi XBee module
 	/// using the Digi XBee API frame-based protocol.
+	///
+	/// Received data is passed through a XBeeFrameParser, so
+	/// all frames contained in the data are delivered, even if
+	/// several frames have been received at once.
 {
 public:
 	XBeePort(Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort);
@@ -48,6 +52,13 @@ public:
 	~XBeePort();
 		/// Destroys the ZBPort.
 
+	void setEscapeFrames(bool escape);
+		/// Enables or disables escaping of sent and received
+		/// frames, as required for API mode 2 (AP=2).
+
+	bool getEscapeFrames() const;
+		/// Returns true if frames are escaped.
+
 	void sendFrame(const XBeeFrame& frame);
 		/// Sends an API frame to the XBee ZB module.
 
@@ -65,26 +76,66 @@ public:
 	bool poll(const Poco::Timespan& timeout);
 		/// Waits for data to arrive at the port.
 		///
-		/// Returns true immediately if data is already in 
-		/// the internal buffer, or if data arrives during the
-		/// specified time interval, otherwise false.
+		/// Returns true immediately if a frame is possibly
+		/// available in the internal buffer, or if data arrives 
+		/// during the specified time interval, otherwise false.
+
+	std::size_t dataReceived(const char* data, std::size_t size);
+		/// Passes data received from the serial port by other
+		/// means, e.g. a IoT::Serial::SerialReactor, to the
+		/// XBeePort. Frames contained in the data can be
+		/// obtained with nextFrame().
+		///
+		/// Returns the number of bytes taken, which is less than
+		/// size if the internal buffer is full. In this case, 
+		/// extract frames with nextFrame() and pass the rest
+		/// of the data again.
+
+	bool nextFrame(XBeeFrame& frame);
+		/// Extracts the next complete frame from the data
+		/// already received, without reading from the serial port.
+		///
+		/// Returns true if a frame has been extracted, otherwise false.
+
+	Poco::SharedPtr<IoT::Serial::SerialPort> serialPort() const;
+		/// Returns the underlying SerialPort.
 
 private:
 	XBeePort();
 	XBeePort(const XBeePort&);
 	XBeePort& operator = (const XBeePort&);
+
+	std::size_t readData(const Poco::Timespan& timeout);
 	
 	Poco::SharedPtr<IoT::Serial::SerialPort> _pSerialPort;
-	Poco::Buffer<char> _buffer;
+	XBeeFrameParser _parser;
 };
 
 
 //
 // inlines
 //
+inline bool XBeePort::getEscapeFrames() const
+{
+	return _parser.getEscapeFrames();
+}
+
+
 inline bool XBeePort::poll(const Poco::Timespan& timeout)
 {
-	return _pSerialPort->poll(timeout);
+	return _parser.frameAvailable() || _pSerialPort->poll(timeout);
+}
+
+
+inline bool XBeePort::nextFrame(XBeeFrame& frame)
+{
+	return _parser.nextFrame(frame);
+}
+
+
+inline Poco::SharedPtr<IoT::Serial::SerialPort> XBeePort::serialPort() const
+{
+	return _pSerialPort;
 }
 
 
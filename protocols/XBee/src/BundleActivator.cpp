@@ -50,11 +50,14 @@ public:
 	{
 	}
 	
-	void createXBeeNode(const std::string& uid, Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort, int options)
+	void createXBeeNode(const std::string& uid, Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort, int options, int transmitWindow, int transmitTimeout)
 	{
 		typedef Poco::RemotingNG::ServerHelper<IoT::XBee::XBeeNode> ServerHelper;
 		
-		Poco::SharedPtr<XBeeNode> pXBeeNode = new XBeeNodeImpl(new XBeePort(pSerialPort));
+		Poco::SharedPtr<XBeeNodeImpl> pXBeeNodeImpl = new XBeeNodeImpl(new XBeePort(pSerialPort), options);
+		pXBeeNodeImpl->setTransmitWindow(transmitWindow);
+		pXBeeNodeImpl->setTransmitTimeout(Poco::Timespan::TimeDiff(transmitTimeout)*Poco::Timespan::MILLISECONDS);
+		Poco::SharedPtr<XBeeNode> pXBeeNode = pXBeeNodeImpl;
 		std::string symbolicName = "io.macchina.xbee";
 		Poco::RemotingNG::Identifiable::ObjectId oid = symbolicName;
 		oid += '#';
@@ -85,6 +88,8 @@ public:
 			std::string device = _pPrefs->configuration()->getString(baseKey + ".device", "");
 			std::string params = _pPrefs->configuration()->getString(baseKey + ".params", "8N1");
 			int speed = _pPrefs->configuration()->getInt(baseKey + ".speed", 38400);
+			int transmitWindow = _pPrefs->configuration()->getInt(baseKey + ".transmitWindow", XBeeNodeImpl::DEFAULT_TRANSMIT_WINDOW);
+			int transmitTimeout = _pPrefs->configuration()->getInt(baseKey + ".transmitTimeout", XBeeNodeImpl::DEFAULT_TRANSMIT_TIMEOUT);
 			int options = 0;
 			if (_pPrefs->configuration()->getBool(baseKey + ".escape", false))
 			{
@@ -96,7 +101,7 @@ public:
 				pContext->logger().information(Poco::format("Creating serial port for XBee device '%s'.", device));
 
 				Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort = new IoT::Serial::SerialPort(device, speed, params);
-				createXBeeNode(Poco::NumberFormatter::format(index), pSerialPort, options);
+				createXBeeNode(Poco::NumberFormatter::format(index), pSerialPort, options, transmitWindow, transmitTimeout);
 			}
 			catch (Poco::Exception& exc)
 			{
@@ -97,11 +97,11 @@ XBeeFrame::ReadStatus XBeeFrame::read(XBeeFrame& frame, const char* buffer, std:
 			if (i + 2 + 1 < size) // 2 length bytes + checksum
 			{
 				std::size_t dataSize = static_cast<unsigned char>(buffer[i + 1])*256 + static_cast<unsigned char>(buffer[i + 2]);
-				if (dataSize <= XBEE_MAX_DATA_LENGTH)
+				if (dataSize > 0 && dataSize <= XBEE_MAX_DATA_LENGTH + 1)
 				{
 					if (i + 2 + dataSize + 1 < size) // 2 length bytes + data + checksum
 					{
-						XBeeFrame tempFrame(static_cast<FrameType>(buffer[i + 3]), buffer + 4, dataSize - 1);
+						XBeeFrame tempFrame(static_cast<FrameType>(static_cast<unsigned char>(buffer[i + 3])), buffer + i + 4, dataSize - 1);
 						if (tempFrame.checksum() == static_cast<unsigned char>(buffer[i + 2 + dataSize + 1]))
 						{
 							frame.swap(tempFrame);
@@ -0,0 +1,217 @@
+//
+// XBeeFrameParser.cpp
+//
+// $Id$
+//
+// Library: IoT/XBee
+// Package: XBee
+// Module:  XBeeFrameParser
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/XBee/XBeeFrameParser.h"
+#include "Poco/Bugcheck.h"
+#include <cstring>
+
+
+namespace IoT {
+namespace XBee {
+
+
+namespace
+{
+	enum
+	{
+		XBEE_ESCAPE = 0x7D,
+		XBEE_ESCAPE_MASK = 0x20
+	};
+}
+
+
+XBeeFrameParser::XBeeFrameParser(std::size_t bufferSize):
+	_buffer(bufferSize),
+	_begin(0),
+	_size(0),
+	_escape(false),
+	_needData(false),
+	_discarded(0)
+{
+	poco_assert (bufferSize >= 2*XBeeFrame::XBEE_MAX_FRAME_LENGTH);
+}
+
+
+XBeeFrameParser::~XBeeFrameParser()
+{
+}
+
+
+void XBeeFrameParser::setEscapeFrames(bool escape)
+{
+	_escape = escape;
+	_needData = false;
+}
+
+
+std::size_t XBeeFrameParser::write(const char* data, std::size_t size)
+{
+	std::size_t written = 0;
+	while (written < size && space() > 0)
+	{
+		std::size_t n;
+		char* p = writeBegin(n);
+		if (n > size - written) n = size - written;
+		std::memcpy(p, data + written, n);
+		commit(n);
+		written += n;
+	}
+	return written;
+}
+
+
+char* XBeeFrameParser::writeBegin(std::size_t& size)
+{
+	std::size_t end = _begin + _size;
+	if (end >= _buffer.size())
+	{
+		end -= _buffer.size();
+		size = _begin - end;
+	}
+	else
+	{
+		size = _buffer.size() - end;
+	}
+	return _buffer.begin() + end;
+}
+
+
+void XBeeFrameParser::commit(std::size_t size)
+{
+	poco_assert (size <= space());
+
+	_size += size;
+	if (size > 0) _needData = false;
+}
+
+
+bool XBeeFrameParser::nextFrame(XBeeFrame& frame)
+{
+	while (_size > 0)
+	{
+		if (at(0) != XBeeFrame::XBEE_FRAME_START_DELIM)
+		{
+			std::size_t skip = 1;
+			while (skip < _size && at(skip) != XBeeFrame::XBEE_FRAME_START_DELIM) skip++;
+			_discarded += skip;
+			consume(skip);
+			continue;
+		}
+
+		std::size_t rawSize = 0;
+		std::size_t resyncPos = 0;
+		std::size_t length = 0;
+		switch (scan(0, rawSize, resyncPos, length))
+		{
+		case SCAN_OK:
+			frame._frame.resize(length + 4);
+			scan(&frame._frame[0], rawSize, resyncPos, length);
+			consume(rawSize);
+			return true;
+
+		case SCAN_NOT_ENOUGH_DATA:
+			_needData = true;
+			return false;
+
+		case SCAN_INVALID:
+			_discarded++;
+			consume(1);
+			break;
+
+		case SCAN_RESYNC:
+			_discarded += resyncPos;
+			consume(resyncPos);
+			break;
+		}
+	}
+	_needData = true;
+	return false;
+}
+
+
+XBeeFrameParser::ScanResult XBeeFrameParser::scan(char* pFrame, std::size_t& rawSize, std::size_t& resyncPos, std::size_t& length) const
+{
+	// The frame starts with a start delimiter at position 0,
+	// followed by the 16-bit length, the frame type and data
+	// (length bytes) and the checksum. If escaping is enabled,
+	// everything following the start delimiter may be escaped.
+	std::size_t pos = 1;
+	std::size_t decoded = 0;
+	std::size_t total = 3;
+	unsigned checksum = 0;
+	length = 0;
+	if (pFrame) *pFrame = static_cast<char>(XBeeFrame::XBEE_FRAME_START_DELIM);
+	while (decoded < total)
+	{
+		if (pos >= _size) return SCAN_NOT_ENOUGH_DATA;
+		int c = at(pos);
+		if (_escape)
+		{
+			if (c == XBeeFrame::XBEE_FRAME_START_DELIM)
+			{
+				resyncPos = pos;
+				return SCAN_RESYNC;
+			}
+			else if (c == XBEE_ESCAPE)
+			{
+				if (++pos >= _size) return SCAN_NOT_ENOUGH_DATA;
+				c = at(pos) ^ XBEE_ESCAPE_MASK;
+			}
+		}
+		pos++;
+		if (pFrame) pFrame[decoded + 1] = static_cast<char>(c);
+
+		if (decoded == 0)
+		{
+			length = c << 8;
+		}
+		else if (decoded == 1)
+		{
+			length |= c;
+			if (length == 0 || length > XBeeFrame::XBEE_MAX_DATA_LENGTH + 1) return SCAN_INVALID;
+			total = length + 3;
+		}
+		else
+		{
+			checksum += c;
+		}
+		decoded++;
+	}
+	rawSize = pos;
+	return (checksum & 0xFF) == 0xFF ? SCAN_OK : SCAN_INVALID;
+}
+
+
+void XBeeFrameParser::consume(std::size_t size)
+{
+	poco_assert (size <= _size);
+
+	_begin += size;
+	if (_begin >= _buffer.size()) _begin -= _buffer.size();
+	_size -= size;
+	if (_size == 0) _begin = 0;
+}
+
+
+void XBeeFrameParser::reset()
+{
+	_begin = 0;
+	_size = 0;
+	_needData = false;
+}
+
+
+} } // namespace IoT::XBee
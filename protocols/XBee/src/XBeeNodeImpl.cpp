@@ -91,9 +91,14 @@ namespace XBee {
 XBeeNodeImpl::XBeeNodeImpl(Poco::SharedPtr<XBeePort> pXBeePort, int options):
 	_pXBeePort(pXBeePort),
 	_options(options),
+	_pReactor(0),
+	_nextFrameID(1),
+	_transmitWindow(DEFAULT_TRANSMIT_WINDOW),
+	_transmitTimeout(DEFAULT_TRANSMIT_TIMEOUT*Poco::Timespan::MILLISECONDS),
 	_stopped(false),
 	_logger(Poco::Logger::get("IoT.XBeeNode"))
 {
+	_pXBeePort->setEscapeFrames((options & XBEE_OPTION_ESCAPE_FRAMES) != 0);
 	start();
 }
 
@@ -104,13 +109,69 @@ XBeeNodeImpl::~XBeeNodeImpl()
 }
 
 
+void XBeeNodeImpl::setTransmitWindow(int window)
+{
+	poco_assert (window >= 0 && window <= XBEE_MAX_TRANSMIT_WINDOW);
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	
+	_transmitWindow = window;
+	dispatchTransmits();
+}
+
+
+int XBeeNodeImpl::getTransmitWindow() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _transmitWindow;
+}
+
+
+void XBeeNodeImpl::setTransmitTimeout(const Poco::Timespan& timeout)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_transmitTimeout = timeout;
+}
+
+
+Poco::Timespan XBeeNodeImpl::getTransmitTimeout() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _transmitTimeout;
+}
+
+
+std::size_t XBeeNodeImpl::transmitsInFlight() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _transmits.size();
+}
+
+
+std::size_t XBeeNodeImpl::transmitsQueued() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _pendingTransmits.size();
+}
+
+
 void XBeeNodeImpl::sendFrame(const APIFrame& frame)
 {
-	XBeeFrame xbeeFrame(
-		static_cast<XBeeFrame::FrameType>(frame.type),
-		reinterpret_cast<const char*>(&frame.data[0]), frame.data.size());
-		
-	sendFrame(xbeeFrame);
+	const char* data = frame.data.empty() ? 0 : reinterpret_cast<const char*>(&frame.data[0]);
+	if (isTransmitRequest(frame.type) && !frame.data.empty())
+	{
+		submitTransmit(static_cast<XBeeFrame::FrameType>(frame.type), data, frame.data.size());
+	}
+	else
+	{
+		XBeeFrame xbeeFrame(static_cast<XBeeFrame::FrameType>(frame.type), data, frame.data.size());
+		sendFrame(xbeeFrame);
+	}
 }
 
 
@@ -198,8 +259,7 @@ void XBeeNodeImpl::sendTransmitRequest(const TransmitRequest& request)
 	writer << request.options;
 	serializeData(writer, request.payload);
 
-	XBeeFrame frame(frameType, buffer, mostr.charsWritten());
-	sendFrame(frame);	
+	submitTransmit(frameType, buffer, mostr.charsWritten());
 }
 
 
@@ -218,8 +278,7 @@ void XBeeNodeImpl::sendZigBeeTransmitRequest(const ZigBeeTransmitRequest& reques
 	writer << request.options;
 	serializeData(writer, request.payload);
 
-	XBeeFrame frame(XBeeFrame::XBEE_FRAME_ZIGBEE_TRANSMIT_REQUEST, buffer, mostr.charsWritten());
-	sendFrame(frame);	
+	submitTransmit(XBeeFrame::XBEE_FRAME_ZIGBEE_TRANSMIT_REQUEST, buffer, mostr.charsWritten());
 }
 
 
@@ -242,34 +301,25 @@ void XBeeNodeImpl::sendExplicitAddressingZigBeeTransmitRequest(const ExplicitAdd
 	writer << request.options;
 	serializeData(writer, request.payload);
 
-	XBeeFrame frame(XBeeFrame::XBEE_FRAME_ZIGBEE_TRANSMIT_REQUEST, buffer, mostr.charsWritten());
-	sendFrame(frame);	
+	submitTransmit(XBeeFrame::XBEE_FRAME_ZIGBEE_TRANSMIT_REQUEST, buffer, mostr.charsWritten());
 }
 
 
 void XBeeNodeImpl::run()
 {
+	XBeeFrame frame;
 	while (!_stopped)
 	{
 		try
 		{
-			if (_pXBeePort->poll(200000))
+			if (_pXBeePort->poll(TIMER_INTERVAL*Poco::Timespan::MILLISECONDS))
 			{
-				XBeeFrame frame;
-				if (_pXBeePort->receiveFrame(frame, Poco::Timespan(200000)))
+				if (_pXBeePort->receiveFrame(frame, TIMER_INTERVAL*Poco::Timespan::MILLISECONDS))
 				{
-					if (_options & XBEE_OPTION_ESCAPE_FRAMES)
-					{
-						frame.unescape();
-					}
-					if (_logger.debug())
-					{
-						_logger.debug(Poco::format("XBee frame received (type=0x%x, length=%z)", 
-							static_cast<unsigned>(frame.type()), frame.frameSize()));
-					}
 					handleFrame(frame);
 				}
 			}
+			expireTransmits();
 		}
 		catch (Poco::Exception& exc)
 		{
@@ -279,10 +329,61 @@ void XBeeNodeImpl::run()
 }
 
 
+void XBeeNodeImpl::onDataReceived(const char* data, std::size_t size)
+{
+	try
+	{
+		XBeeFrame frame;
+		do
+		{
+			std::size_t n = _pXBeePort->dataReceived(data, size);
+			data += n;
+			size -= n;
+			while (_pXBeePort->nextFrame(frame))
+			{
+				handleFrame(frame);
+			}
+		}
+		while (size > 0);
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.log(exc);
+	}
+}
+
+
+void XBeeNodeImpl::onTimer()
+{
+	try
+	{
+		expireTransmits();
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.log(exc);
+	}
+}
+
+
+void XBeeNodeImpl::onError(const Poco::Exception& exc)
+{
+	_logger.error(Poco::format("Serial port %s failed, no more frames will be received: %s", _pXBeePort->serialPort()->device(), exc.displayText()));
+}
+
+
 void XBeeNodeImpl::start()
 {
 	_stopped = false;
-	_thread.start(*this);
+	if (IoT::Serial::SerialReactor::isSupported())
+	{
+		_pReactor = &IoT::Serial::SerialReactor::defaultReactor();
+		_pReactor->addPort(_pXBeePort->serialPort(), *this, TIMER_INTERVAL*Poco::Timespan::MILLISECONDS);
+	}
+	else
+	{
+		_thread.start(*this);
+	}
 }
 
 
@@ -291,18 +392,37 @@ void XBeeNodeImpl::stop()
 	if (!_stopped)
 	{
 		_stopped = true;
-		_thread.join();
+		if (_pReactor)
+			_pReactor->removePort(_pXBeePort->serialPort());
+		else
+			_thread.join();
 	}
 }
 
 
 void XBeeNodeImpl::handleFrame(const XBeeFrame& frame)
 {	
+	if (_logger.debug())
+	{
+		_logger.debug(Poco::format("XBee frame received (type=0x%x, length=%z)", 
+			static_cast<unsigned>(frame.type()), frame.frameSize()));
+	}
+
+	Poco::UInt8 frameID = 0;
+	if (isTransmitStatus(frame.type()))
+	{
+		if (!completeTransmit(frame, frameID)) return;
+	}
+
 	APIFrame apiFrame;
 	apiFrame.type = frame.type();
 	apiFrame.data.assign(
 		reinterpret_cast<const Poco::UInt8*>(frame.data()), 
 		reinterpret_cast<const Poco::UInt8*>(frame.data()) + frame.dataSize());
+	if (isTransmitStatus(frame.type()))
+	{
+		apiFrame.data[0] = frameID;
+	}
 	
 	try
 	{
@@ -316,7 +436,7 @@ void XBeeNodeImpl::handleFrame(const XBeeFrame& frame)
 	switch (frame.type())
 	{
 	case XBeeFrame::XBEE_FRAME_TRANSMIT_STATUS:
-		handleTransmitStatusReceived(frame);
+		handleTransmitStatusReceived(frame, frameID);
 		break;
 	case XBeeFrame::XBEE_FRAME_RECEIVE_PACKET_64BIT_ADDRESS:
 	case XBeeFrame::XBEE_FRAME_RECEIVE_PACKET_16BIT_ADDRESS:
@@ -327,7 +447,7 @@ void XBeeNodeImpl::handleFrame(const XBeeFrame& frame)
 		handleIODataReceived(frame);
 		break;
 	case XBeeFrame::XBEE_FRAME_ZIGBEE_TRANSMIT_STATUS:
-		handleZigBeeTransmitStatusReceived(frame);
+		handleZigBeeTransmitStatusReceived(frame, frameID);
 		break;
 	case XBeeFrame::XBEE_FRAME_ZIGBEE_RECEIVE_PACKET:
 		handleZigBeePacketReceived(frame);
@@ -353,7 +473,7 @@ void XBeeNodeImpl::handleFrame(const XBeeFrame& frame)
 }
 
 
-void XBeeNodeImpl::handleTransmitStatusReceived(const XBeeFrame& frame)
+void XBeeNodeImpl::handleTransmitStatusReceived(const XBeeFrame& frame, Poco::UInt8 frameID)
 {
 	TransmitStatus transmitStatus;
 	Poco::MemoryInputStream mistr(frame.data(), frame.dataSize());
@@ -362,6 +482,7 @@ void XBeeNodeImpl::handleTransmitStatusReceived(const XBeeFrame& frame)
 	reader 
 		>> transmitStatus.frameID 
 		>> transmitStatus.status;
+	transmitStatus.frameID = frameID;
 	transmitStatusReceived(transmitStatus);
 }
 
@@ -414,13 +535,14 @@ void XBeeNodeImpl::handleIODataReceived(const XBeeFrame& frame)
 }
 
 
-void XBeeNodeImpl::handleZigBeeTransmitStatusReceived(const XBeeFrame& frame)
+void XBeeNodeImpl::handleZigBeeTransmitStatusReceived(const XBeeFrame& frame, Poco::UInt8 frameID)
 {
 	ZigBeeTransmitStatus transmitStatus;
 	Poco::MemoryInputStream mistr(frame.data(), frame.dataSize());
 	Poco::BinaryReader reader(mistr, Poco::BinaryReader::NETWORK_BYTE_ORDER);
 	
 	reader >> transmitStatus.frameID;
+	transmitStatus.frameID = frameID;
 	deserializeNetworkAddress(reader, transmitStatus.networkAddress);
 	reader 
 		>> transmitStatus.deliveryStatus 
@@ -575,7 +697,15 @@ void XBeeNodeImpl::handleModemStatus(const XBeeFrame& frame)
 }
 
 
-void XBeeNodeImpl::sendFrame(XBeeFrame& frame)
+void XBeeNodeImpl::sendFrame(const XBeeFrame& frame)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	writeFrame(frame);
+}
+
+
+void XBeeNodeImpl::writeFrame(const XBeeFrame& frame)
 {
 	if (_logger.debug())
 	{
@@ -583,14 +713,141 @@ void XBeeNodeImpl::sendFrame(XBeeFrame& frame)
 			static_cast<unsigned>(frame.type()), frame.frameSize()));
 	}
 
-	if (_options & XBEE_OPTION_ESCAPE_FRAMES)
+	if (_pReactor)
 	{
-		frame.escape();
+		if (_pXBeePort->getEscapeFrames())
+		{
+			XBeeFrame escapedFrame(frame);
+			escapedFrame.escape();
+			_pReactor->write(_pXBeePort->serialPort(), escapedFrame.frame(), escapedFrame.frameSize());
+		}
+		else
+		{
+			_pReactor->write(_pXBeePort->serialPort(), frame.frame(), frame.frameSize());
+		}
 	}
+	else
+	{
+		_pXBeePort->sendFrame(frame);
+	}
+}
+
+
+void XBeeNodeImpl::submitTransmit(XBeeFrame::FrameType type, const char* data, std::size_t size)
+{
+	poco_assert (size > 0);
 
 	Poco::FastMutex::ScopedLock lock(_mutex);
 
-	_pXBeePort->sendFrame(frame);
+	if (_transmitWindow == 0)
+	{
+		XBeeFrame frame(type, data, size);
+		writeFrame(frame);
+	}
+	else
+	{
+		PendingTransmit transmit;
+		transmit.type = type;
+		transmit.data.assign(data, size);
+		_pendingTransmits.push_back(transmit);
+		dispatchTransmits();
+	}
+}
+
+
+void XBeeNodeImpl::dispatchTransmits()
+{
+	while (!_pendingTransmits.empty() && _transmits.size() < static_cast<std::size_t>(_transmitWindow))
+	{
+		PendingTransmit& pending = _pendingTransmits.front();
+		Poco::UInt8 frameID = allocateFrameID();
+		Transmit& transmit = _transmits[frameID];
+		transmit.frameID = static_cast<Poco::UInt8>(pending.data[0]);
+		transmit.sent.update();
+		pending.data[0] = static_cast<char>(frameID);
+		XBeeFrame frame(pending.type, pending.data);
+		_pendingTransmits.pop_front();
+		writeFrame(frame);
+	}
+}
+
+
+bool XBeeNodeImpl::completeTransmit(const XBeeFrame& frame, Poco::UInt8& frameID)
+{
+	if (frame.dataSize() == 0) return false;
+
+	frameID = static_cast<Poco::UInt8>(*frame.data());
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	Transmits::iterator it = _transmits.find(frameID);
+	if (it == _transmits.end()) 
+	{
+		// not sent through the transmit window
+		return true;
+	}
+	frameID = it->second.frameID;
+	_transmits.erase(it);
+	dispatchTransmits();
+	return frameID != 0;
+}
+
+
+void XBeeNodeImpl::expireTransmits()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_transmits.empty()) return;
+
+	Transmits::iterator it = _transmits.begin();
+	while (it != _transmits.end())
+	{
+		if (it->second.sent.isElapsed(_transmitTimeout.totalMicroseconds()))
+		{
+			_logger.warning(Poco::format("No transmit status received for frame %u within %d ms.", 
+				static_cast<unsigned>(it->first), 
+				static_cast<int>(_transmitTimeout.totalMilliseconds())));
+			_transmits.erase(it++);
+		}
+		else ++it;
+	}
+	dispatchTransmits();
+}
+
+
+Poco::UInt8 XBeeNodeImpl::allocateFrameID()
+{
+	poco_assert (_transmits.size() < XBEE_MAX_TRANSMIT_WINDOW);
+
+	while (_transmits.find(_nextFrameID) != _transmits.end())
+	{
+		if (++_nextFrameID == 0) _nextFrameID = 1;
+	}
+	Poco::UInt8 frameID = _nextFrameID;
+	if (++_nextFrameID == 0) _nextFrameID = 1;
+	return frameID;
+}
+
+
+bool XBeeNodeImpl::isTransmitRequest(int frameType)
+{
+	switch (frameType)
+	{
+	case XBeeFrame::XBEE_FRAME_TRANSMIT_REQUEST_64BIT_ADDRESS:
+	case XBeeFrame::XBEE_FRAME_TRANSMIT_REQUEST_16BIT_ADDRESS:
+	case XBeeFrame::XBEE_FRAME_ZIGBEE_TRANSMIT_REQUEST:
+	case XBeeFrame::XBEE_FRAME_EXPL_ADDR_ZIGBEE_COMMAND_FRAME:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+bool XBeeNodeImpl::isTransmitStatus(int frameType)
+{
+	return frameType == XBeeFrame::XBEE_FRAME_TRANSMIT_STATUS
+	    || frameType == XBeeFrame::XBEE_FRAME_ZIGBEE_TRANSMIT_STATUS;
 }
 
 
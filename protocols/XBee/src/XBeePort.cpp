@@ -23,8 +23,7 @@ namespace XBee {
 
 
 XBeePort::XBeePort(Poco::SharedPtr<IoT::Serial::SerialPort> pSerialPort):
-	_pSerialPort(pSerialPort),
-	_buffer(XBeeFrame::XBEE_MAX_FRAME_LENGTH)
+	_pSerialPort(pSerialPort)
 {
 }
 
@@ -34,41 +33,62 @@ XBeePort::~XBeePort()
 }
 
 
+void XBeePort::setEscapeFrames(bool escape)
+{
+	_parser.setEscapeFrames(escape);
+}
+
+
 void XBeePort::sendFrame(const XBeeFrame& frame)
 {
-	_pSerialPort->write(frame.frame(), frame.frameSize());
+	if (_parser.getEscapeFrames())
+	{
+		XBeeFrame escapedFrame(frame);
+		escapedFrame.escape();
+		_pSerialPort->write(escapedFrame.frame(), escapedFrame.frameSize());
+	}
+	else
+	{
+		_pSerialPort->write(frame.frame(), frame.frameSize());
+	}
 }
 
 
 std::size_t XBeePort::receiveFrame(XBeeFrame& frame)
 {
-	std::size_t n = 0;
-	XBeeFrame::ReadStatus rs = XBeeFrame::XBEE_FRAME_NOT_FOUND;
-	do
+	while (!_parser.nextFrame(frame))
 	{
-		n += _pSerialPort->read(_buffer.begin() + n, _buffer.size() - n);
-		rs = XBeeFrame::read(frame, _buffer.begin(), n);
+		readData(0);
 	}
-	while (rs == XBeeFrame::XBEE_FRAME_NOT_ENOUGH_DATA && n < _buffer.size());
-	
-	return rs == XBeeFrame::XBEE_FRAME_OK ? n : 0;
+	return frame.frameSize();
 }
 
 	
 std::size_t XBeePort::receiveFrame(XBeeFrame& frame, const Poco::Timespan& timeout)
 {
-	std::size_t n = 0;
-	XBeeFrame::ReadStatus rs = XBeeFrame::XBEE_FRAME_NOT_FOUND;
-	do
+	while (!_parser.nextFrame(frame))
 	{
-		std::size_t rd = _pSerialPort->read(_buffer.begin() + n, _buffer.size() - n, timeout);
-		if (rd == 0) return 0;
-		n += rd;
-		rs = XBeeFrame::read(frame, _buffer.begin(), n);
+		if (readData(timeout) == 0) return 0;
 	}
-	while (rs == XBeeFrame::XBEE_FRAME_NOT_ENOUGH_DATA && n < _buffer.size());
-	
-	return rs == XBeeFrame::XBEE_FRAME_OK ? n : 0;
+	return frame.frameSize();
+}
+
+
+std::size_t XBeePort::dataReceived(const char* data, std::size_t size)
+{
+	return _parser.write(data, size);
+}
+
+
+std::size_t XBeePort::readData(const Poco::Timespan& timeout)
+{
+	if (timeout != 0 && !_pSerialPort->poll(timeout)) return 0;
+
+	std::size_t size;
+	char* p = _parser.writeBegin(size);
+	std::size_t n = _pSerialPort->read(p, size);
+	_parser.commit(n);
+	return n;
 }
 
 
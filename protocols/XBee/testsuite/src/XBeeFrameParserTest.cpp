@@ -0,0 +1,288 @@
+//
+// XBeeFrameParserTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "XBeeFrameParserTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/XBee/XBeeFrameParser.h"
+#include "IoT/XBee/XBeeFrame.h"
+#include <cstring>
+
+
+using IoT::XBee::XBeeFrameParser;
+using IoT::XBee::XBeeFrame;
+
+
+namespace
+{
+	std::string raw(const XBeeFrame& frame)
+	{
+		return std::string(frame.frame(), frame.frameSize());
+	}
+
+	std::string escaped(const XBeeFrame& frame)
+	{
+		XBeeFrame escapedFrame(frame);
+		escapedFrame.escape();
+		return raw(escapedFrame);
+	}
+
+	XBeeFrame makeFrame(int n)
+	{
+		std::string data;
+		data += static_cast<char>(n & 0xFF);
+		for (int i = 0; i < n % 50; i++)
+		{
+			data += static_cast<char>((n + i) & 0xFF);
+		}
+		return XBeeFrame(XBeeFrame::XBEE_FRAME_ZIGBEE_RECEIVE_PACKET, data);
+	}
+}
+
+
+XBeeFrameParserTest::XBeeFrameParserTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+XBeeFrameParserTest::~XBeeFrameParserTest()
+{
+}
+
+
+void XBeeFrameParserTest::testSingleFrame()
+{
+	XBeeFrameParser parser;
+	XBeeFrame frame;
+	assert (!parser.nextFrame(frame));
+
+	XBeeFrame sent(XBeeFrame::XBEE_FRAME_AT_COMMAND, std::string("\x01NJ", 3));
+	std::string data = raw(sent);
+	assert (parser.write(data.data(), data.size()) == data.size());
+	assert (parser.frameAvailable());
+	assert (parser.nextFrame(frame));
+	assert (frame.type() == XBeeFrame::XBEE_FRAME_AT_COMMAND);
+	assert (raw(frame) == data);
+	assert (parser.available() == 0);
+	assert (!parser.nextFrame(frame));
+	assert (!parser.frameAvailable());
+	assert (parser.discarded() == 0);
+}
+
+
+void XBeeFrameParserTest::testMultipleFrames()
+{
+	XBeeFrameParser parser;
+	std::string data;
+	for (int i = 0; i < 10; i++)
+	{
+		data += raw(makeFrame(i));
+	}
+	assert (parser.write(data.data(), data.size()) == data.size());
+
+	XBeeFrame frame;
+	for (int i = 0; i < 10; i++)
+	{
+		assert (parser.nextFrame(frame));
+		assert (raw(frame) == raw(makeFrame(i)));
+	}
+	assert (!parser.nextFrame(frame));
+	assert (parser.discarded() == 0);
+}
+
+
+void XBeeFrameParserTest::testPartialFrame()
+{
+	XBeeFrameParser parser;
+	std::string data = raw(makeFrame(42)) + raw(makeFrame(43));
+
+	XBeeFrame frame;
+	int frames = 0;
+	for (std::size_t i = 0; i < data.size(); i++)
+	{
+		parser.write(data.data() + i, 1);
+		if (parser.nextFrame(frame))
+		{
+			assert (raw(frame) == raw(makeFrame(42 + frames)));
+			frames++;
+		}
+		else assert (!parser.frameAvailable());
+	}
+	assert (frames == 2);
+	assert (parser.available() == 0);
+}
+
+
+void XBeeFrameParserTest::testInvalidData()
+{
+	XBeeFrameParser parser;
+	std::string good = raw(makeFrame(7));
+	std::string bad = raw(makeFrame(8));
+	bad[bad.size() - 1] ^= 0x01;
+	std::string tooLong("\x7E\xFF\xFF\x90", 4);
+	std::string data = std::string("garbage") + bad + tooLong + good;
+	parser.write(data.data(), data.size());
+
+	XBeeFrame frame;
+	assert (parser.nextFrame(frame));
+	assert (raw(frame) == good);
+	assert (parser.discarded() == data.size() - good.size());
+	assert (!parser.nextFrame(frame));
+}
+
+
+void XBeeFrameParserTest::testEscapedFrames()
+{
+	XBeeFrameParser parser;
+	parser.setEscapeFrames(true);
+
+	std::string payload("\x01\x7E\x7D\x11\x13\x7E\x00\x7D", 8);
+	XBeeFrame sent(XBeeFrame::XBEE_FRAME_ZIGBEE_TRANSMIT_REQUEST, payload);
+	std::string data = escaped(sent) + escaped(makeFrame(19)) + escaped(sent);
+	assert (data.size() > raw(sent).size()*2 + raw(makeFrame(19)).size());
+
+	XBeeFrame frame;
+	int frames = 0;
+	for (std::size_t i = 0; i < data.size(); i += 3)
+	{
+		parser.write(data.data() + i, std::min<std::size_t>(3, data.size() - i));
+		while (parser.nextFrame(frame))
+		{
+			if (frames == 1)
+				assert (raw(frame) == raw(makeFrame(19)));
+			else
+				assert (raw(frame) == raw(sent));
+			frames++;
+		}
+	}
+	assert (frames == 3);
+	assert (std::string(frame.data(), frame.dataSize()) == payload);
+	assert (parser.discarded() == 0);
+}
+
+
+void XBeeFrameParserTest::testEscapedResync()
+{
+	XBeeFrameParser parser;
+	parser.setEscapeFrames(true);
+
+	std::string truncated = escaped(makeFrame(30));
+	truncated.resize(truncated.size() - 5);
+	std::string good = escaped(makeFrame(31));
+	std::string data = truncated + good;
+	parser.write(data.data(), data.size());
+
+	XBeeFrame frame;
+	assert (parser.nextFrame(frame));
+	assert (raw(frame) == raw(makeFrame(31)));
+	assert (parser.discarded() == truncated.size());
+}
+
+
+void XBeeFrameParserTest::testWrapAround()
+{
+	XBeeFrameParser parser(2*XBeeFrame::XBEE_MAX_FRAME_LENGTH);
+	std::string data;
+	for (int i = 0; i < 500; i++)
+	{
+		data += raw(makeFrame(i));
+	}
+
+	XBeeFrame frame;
+	int frames = 0;
+	std::size_t pos = 0;
+	while (pos < data.size())
+	{
+		std::size_t size;
+		char* p = parser.writeBegin(size);
+		assert (size > 0);
+		if (size > 333) size = 333;
+		if (size > data.size() - pos) size = data.size() - pos;
+		std::memcpy(p, data.data() + pos, size);
+		parser.commit(size);
+		pos += size;
+		while (parser.nextFrame(frame))
+		{
+			assert (raw(frame) == raw(makeFrame(frames)));
+			frames++;
+		}
+	}
+	assert (frames == 500);
+	assert (parser.discarded() == 0);
+}
+
+
+void XBeeFrameParserTest::testBufferFull()
+{
+	XBeeFrameParser parser(2*XBeeFrame::XBEE_MAX_FRAME_LENGTH);
+	std::string data;
+	for (int i = 0; i < 100; i++)
+	{
+		data += raw(makeFrame(49));
+	}
+	std::size_t n = parser.write(data.data(), data.size());
+	assert (n == 2*XBeeFrame::XBEE_MAX_FRAME_LENGTH);
+	assert (parser.space() == 0);
+
+	XBeeFrame frame;
+	int frames = 0;
+	const char* p = data.data() + n;
+	std::size_t rest = data.size() - n;
+	while (parser.nextFrame(frame))
+	{
+		frames++;
+		std::size_t written = parser.write(p, rest);
+		p += written;
+		rest -= written;
+	}
+	assert (frames == 100);
+	assert (rest == 0);
+}
+
+
+void XBeeFrameParserTest::testReadFrame()
+{
+	std::string data = std::string("xy") + raw(makeFrame(12));
+
+	XBeeFrame frame;
+	assert (XBeeFrame::read(frame, data.data(), data.size()) == XBeeFrame::XBEE_FRAME_OK);
+	assert (raw(frame) == raw(makeFrame(12)));
+	assert (XBeeFrame::read(frame, data.data(), data.size() - 1) == XBeeFrame::XBEE_FRAME_NOT_ENOUGH_DATA);
+}
+
+
+void XBeeFrameParserTest::setUp()
+{
+}
+
+
+void XBeeFrameParserTest::tearDown()
+{
+}
+
+
+CppUnit::Test* XBeeFrameParserTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("XBeeFrameParserTest");
+
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testSingleFrame);
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testMultipleFrames);
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testPartialFrame);
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testInvalidData);
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testEscapedFrames);
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testEscapedResync);
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testWrapAround);
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testBufferFull);
+	CppUnit_addTest(pSuite, XBeeFrameParserTest, testReadFrame);
+
+	return pSuite;
+}
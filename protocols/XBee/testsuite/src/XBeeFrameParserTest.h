@@ -0,0 +1,46 @@
+//
+// XBeeFrameParserTest.h
+//
+// $Id$
+//
+// Definition of the XBeeFrameParserTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef XBeeFrameParserTest_INCLUDED
+#define XBeeFrameParserTest_INCLUDED
+
+
+#include "IoT/XBee/XBee.h"
+#include "CppUnit/TestCase.h"
+
+
+class XBeeFrameParserTest: public CppUnit::TestCase
+{
+public:
+	XBeeFrameParserTest(const std::string& name);
+	~XBeeFrameParserTest();
+
+	void testSingleFrame();
+	void testMultipleFrames();
+	void testPartialFrame();
+	void testInvalidData();
+	void testEscapedFrames();
+	void testEscapedResync();
+	void testWrapAround();
+	void testBufferFull();
+	void testReadFrame();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // XBeeFrameParserTest_INCLUDED
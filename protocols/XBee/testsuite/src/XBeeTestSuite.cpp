@@ -0,0 +1,24 @@
+//
+// XBeeTestSuite.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "XBeeTestSuite.h"
+#include "XBeeFrameParserTest.h"
+
+
+CppUnit::Test* XBeeTestSuite::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("XBeeTestSuite");
+
+	pSuite->addTest(XBeeFrameParserTest::suite());
+
+	return pSuite;
+}
@@ -0,0 +1,147 @@
+//
+// ChangeSet.h
+//
+// $Id$
+//
+// Library: IoT/DeviceStatus
+// Package: DeviceStatusServiceImpl
+// Module:  ChangeSet
+//
+// Definition of the ChangeSet class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_DeviceStatus_ChangeSet_INCLUDED
+#define IoT_DeviceStatus_ChangeSet_INCLUDED
+
+
+#include "IoT/DeviceStatus/DeviceStatus.h"
+#include "IoT/DeviceStatus/DeviceStatusService.h"
+#include <map>
+
+
+namespace IoT {
+namespace DeviceStatus {
+
+
+class IoTDeviceStatus_API ChangeSet
+	/// A ChangeSet holds the changes to stored status messages
+	/// that have not been written to the database yet.
+	///
+	/// All changes to the same message are combined into a single
+	/// change. A message that is inserted and deleted again before
+	/// the ChangeSet has been written is removed from the ChangeSet.
+{
+public:
+	struct Change
+	{
+		enum Operation
+		{
+			CHANGE_INSERT,
+			CHANGE_ACKNOWLEDGE,
+			CHANGE_DELETE
+		};
+
+		Operation operation;
+		StatusMessage message;
+	};
+
+	typedef std::map<int, Change> ChangeMap;
+	typedef ChangeMap::const_iterator ConstIterator;
+
+	ChangeSet();
+		/// Creates an empty ChangeSet.
+
+	~ChangeSet();
+		/// Destroys the ChangeSet.
+
+	void add(Change::Operation operation, const StatusMessage& message);
+		/// Adds the given change to the given message, combining
+		/// it with a pending change to the same message.
+
+	void merge(const ChangeSet& newer);
+		/// Adds all changes from the given ChangeSet, which must have
+		/// been made after the changes in this ChangeSet.
+
+	void swap(ChangeSet& other);
+		/// Swaps the contents of this ChangeSet with other.
+
+	void clear();
+		/// Removes all changes.
+
+	bool empty() const;
+		/// Returns true if there are no pending changes.
+
+	std::size_t size() const;
+		/// Returns the number of pending changes.
+
+	ConstIterator find(int id) const;
+		/// Returns an iterator to the change to the message
+		/// with the given ID, or end().
+
+	ConstIterator begin() const;
+		/// Returns an iterator to the first change,
+		/// ordered by message ID.
+
+	ConstIterator end() const;
+		/// Returns the end iterator.
+
+private:
+	ChangeMap _changes;
+};
+
+
+//
+// inlines
+//
+inline void ChangeSet::swap(ChangeSet& other)
+{
+	_changes.swap(other._changes);
+}
+
+
+inline void ChangeSet::clear()
+{
+	_changes.clear();
+}
+
+
+inline bool ChangeSet::empty() const
+{
+	return _changes.empty();
+}
+
+
+inline std::size_t ChangeSet::size() const
+{
+	return _changes.size();
+}
+
+
+inline ChangeSet::ConstIterator ChangeSet::find(int id) const
+{
+	return _changes.find(id);
+}
+
+
+inline ChangeSet::ConstIterator ChangeSet::begin() const
+{
+	return _changes.begin();
+}
+
+
+inline ChangeSet::ConstIterator ChangeSet::end() const
+{
+	return _changes.end();
+}
+
+
+} } // namespace IoT::DeviceStatus
+
+
+#endif // IoT_DeviceStatus_ChangeSet_INCLUDED
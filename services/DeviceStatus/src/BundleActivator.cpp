@@ -50,8 +50,12 @@ public:
 		Poco::OSP::PreferencesService::Ptr pPrefs = Poco::OSP::ServiceFinder::find<Poco::OSP::PreferencesService>(pContext);
 		
 		int maxAgeHours = pPrefs->configuration()->getInt("deviceStatus.messages.maxAge", 30*24);
+		long flushInterval = pPrefs->configuration()->getInt("deviceStatus.persistence.flushInterval", DeviceStatusServiceImpl::DEFAULT_FLUSH_INTERVAL);
+		int maxPendingChanges = pPrefs->configuration()->getInt("deviceStatus.persistence.maxPendingChanges", DeviceStatusServiceImpl::DEFAULT_MAX_PENDING_CHANGES);
+		if (flushInterval < 1) flushInterval = 1;
+		if (maxPendingChanges < 1) maxPendingChanges = 1;
 		
-		Poco::SharedPtr<IoT::DeviceStatus::DeviceStatusService> pDeviceStatusService = new DeviceStatusServiceImpl(pContext, maxAgeHours);
+		Poco::SharedPtr<IoT::DeviceStatus::DeviceStatusService> pDeviceStatusService = new DeviceStatusServiceImpl(pContext, maxAgeHours, flushInterval, maxPendingChanges);
 		std::string oid("io.macchina.services.devicestatus");
 		ServerHelper::RemoteObjectPtr pDeviceStatusServiceRemoteObject = ServerHelper::createRemoteObject(pDeviceStatusService, oid);		
 		_pServiceRef = pContext->registry().registerService(oid, pDeviceStatusServiceRemoteObject, Properties());
@@ -0,0 +1,68 @@
+//
+// ChangeSet.cpp
+//
+// $Id$
+//
+// Library: IoT/DeviceStatus
+// Package: DeviceStatusServiceImpl
+// Module:  ChangeSet
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/DeviceStatus/ChangeSet.h"
+
+
+namespace IoT {
+namespace DeviceStatus {
+
+
+ChangeSet::ChangeSet()
+{
+}
+
+
+ChangeSet::~ChangeSet()
+{
+}
+
+
+void ChangeSet::add(Change::Operation operation, const StatusMessage& message)
+{
+	ChangeMap::iterator it = _changes.find(message.id);
+	if (it == _changes.end())
+	{
+		Change& change = _changes[message.id];
+		change.operation = operation;
+		change.message = message;
+	}
+	else if (it->second.operation == Change::CHANGE_INSERT)
+	{
+		// the message has not been written yet
+		if (operation == Change::CHANGE_DELETE)
+			_changes.erase(it);
+		else
+			it->second.message = message;
+	}
+	else
+	{
+		it->second.operation = operation;
+		it->second.message = message;
+	}
+}
+
+
+void ChangeSet::merge(const ChangeSet& newer)
+{
+	for (ConstIterator it = newer.begin(); it != newer.end(); ++it)
+	{
+		add(it->second.operation, it->second.message);
+	}
+}
+
+
+} } // namespace IoT::DeviceStatus
@@ -15,7 +15,6 @@
 
 
 #include "DeviceStatusServiceImpl.h"
-#include "Poco/Data/Statement.h"
 #include "Poco/Data/Transaction.h"
 #include "Poco/Timespan.h"
 #include "Poco/Path.h"
@@ -28,17 +27,48 @@ namespace IoT {
 namespace DeviceStatus {
 
 
-DeviceStatusServiceImpl::DeviceStatusServiceImpl(Poco::OSP::BundleContext::Ptr pContext, int maxAge):
+namespace
+{
+	DeviceStatus validStatus(int status)
+	{
+		if (status < DEVICE_STATUS_OK) return DEVICE_STATUS_OK;
+		if (status > DEVICE_STATUS_FATAL) return DEVICE_STATUS_FATAL;
+		return static_cast<DeviceStatus>(status);
+	}
+}
+
+
+DeviceStatusServiceImpl::DeviceStatusServiceImpl(Poco::OSP::BundleContext::Ptr pContext, int maxAge, long flushInterval, std::size_t maxPendingChanges):
 	_pContext(pContext),
 	_maxAge(maxAge),
+	_flushInterval(flushInterval),
+	_maxPendingChanges(maxPendingChanges),
+	_nextId(1),
+	_deleteAll(false),
+	_rowStatus(DEVICE_STATUS_OK),
+	_activity(this, &DeviceStatusServiceImpl::runActivity),
 	_logger(Poco::Logger::get("IoT.DeviceStatus"))
 {
+	for (int i = 0; i < STATUS_LEVELS; i++)
+	{
+		_unacknowledged[i] = 0;
+	}
+
 	Poco::Path path(pContext->persistentDirectory());
 	path.makeDirectory();
 	path.setFileName("devicestatus.sqlite");
 	_pSession = new Poco::Data::Session("SQLite", path.toString());
-	
-	(*_pSession) << 
+	try
+	{
+		_pSession->setProperty("journalMode", std::string("WAL"));
+		_pSession->setProperty("synchronous", std::string("NORMAL"));
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.warning("Cannot enable write-ahead logging for device status database: " + exc.displayText());
+	}
+
+	(*_pSession) <<
 		"CREATE TABLE IF NOT EXISTS messages ("
 		"    id INTEGER PRIMARY KEY AUTOINCREMENT,"
 		"    messageClass VARCHAR(64),"
@@ -47,24 +77,49 @@ DeviceStatusServiceImpl::DeviceStatusServiceImpl(Poco::OSP::BundleContext::Ptr p
 		"    timestamp DATETIME,"
 		"    acknowledged BOOLEAN"
 		")", now;
-		
+
+	_pInsert = new Poco::Data::Statement(((*_pSession) << "INSERT INTO messages VALUES (?, ?, ?, ?, ?, ?)",
+		use(_row.id),
+		use(_row.messageClass),
+		use(_rowStatus),
+		use(_row.text),
+		use(_row.timestamp),
+		use(_row.acknowledged)));
+	_pAcknowledge = new Poco::Data::Statement(((*_pSession) << "UPDATE messages SET acknowledged = 1 WHERE id = ?",
+		use(_row.id)));
+	_pDelete = new Poco::Data::Statement(((*_pSession) << "DELETE FROM messages WHERE id = ?",
+		use(_row.id)));
+
+	load();
 	cleanup(true);
+	flush();
+
+	_activity.start();
 }
 
-	
+
 DeviceStatusServiceImpl::~DeviceStatusServiceImpl()
 {
+	_activity.stop();
+	_flushEvent.set();
+	_activity.wait();
+
+	try
+	{
+		flush();
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.log(exc);
+	}
 }
 
 
 DeviceStatus DeviceStatusServiceImpl::status() const
 {
 	Poco::FastMutex::ScopedLock lock(_mutex);
-	
-	int status(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(status) FROM messages WHERE NOT acknowledged", into(status), now;
-	
-	return static_cast<DeviceStatus>(status);
+
+	return currentStatus();
 }
 
 
@@ -73,53 +128,41 @@ DeviceStatusChange DeviceStatusServiceImpl::postStatus(const StatusUpdate& statu
 	Poco::ScopedLockWithUnlock<Poco::FastMutex> lock(_mutex);
 
 	StatusMessage message;
+	message.id           = _nextId++;
 	message.messageClass = statusUpdate.messageClass;
-	message.status       = statusUpdate.status;
+	message.status       = validStatus(statusUpdate.status);
 	message.text         = statusUpdate.text;
 	message.acknowledged = false;
-	
-	Poco::Data::Transaction xa(*_pSession, &_logger);
 
-	int previousStatus(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(status) FROM messages WHERE NOT acknowledged", 
-		into(previousStatus), 
-		now;
-		
+	DeviceStatus previousStatus = currentStatus();
+
 	if (!message.messageClass.empty())
 	{
-		(*_pSession) << "DELETE FROM messages WHERE messageClass = ?", use(message.messageClass), now;
+		ClassIndex::iterator it = _classIndex.find(message.messageClass);
+		if (it != _classIndex.end())
+		{
+			removeMessage(_messages.find(it->second));
+		}
 	}
-	
-	(*_pSession) << "INSERT INTO messages VALUES (NULL, ?, ?, ?, ?, ?)",
-		use(message.messageClass), 
-		use(message.status), 
-		use(message.text), 
-		use(message.timestamp),
-		use(message.acknowledged),
-		now;
 
-	int currentStatus(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(id), MAX(status) FROM messages WHERE NOT acknowledged", 
-		into(message.id),
-		into(currentStatus), 
-		now;
-		
+	addMessage(message);
+	recordChange(Change::CHANGE_INSERT, message);
+
 	cleanup();
-	
-	xa.commit();
-	lock.unlock();
-	
+
 	DeviceStatusChange change;
-	change.previousStatus = static_cast<DeviceStatus>(previousStatus);
-	change.currentStatus = static_cast<DeviceStatus>(currentStatus);
+	change.previousStatus = previousStatus;
+	change.currentStatus = currentStatus();
 	change.message = message;
-	
+
+	lock.unlock();
+
 	statusUpdated(this, change);
-	if (currentStatus != previousStatus)
+	if (change.currentStatus != change.previousStatus)
 	{
 		statusChanged(this, change);
 	}
-	
+
 	return change;
 }
 
@@ -128,34 +171,20 @@ DeviceStatus DeviceStatusServiceImpl::clearStatus(const std::string& id)
 {
 	Poco::ScopedLockWithUnlock<Poco::FastMutex> lock(_mutex);
 
-	Poco::Data::Transaction xa(*_pSession, &_logger);
+	DeviceStatus previousStatus = currentStatus();
 
-	int previousStatus(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(status) FROM messages WHERE NOT acknowledged", 
-		into(previousStatus), 
-		now;
-
-	(*_pSession) << "DELETE FROM messages WHERE messageClass = ?",
-		useRef(id),
-		now;
+	ClassIndex::iterator it = _classIndex.find(id);
+	if (it != _classIndex.end())
+	{
+		removeMessage(_messages.find(it->second));
+	}
 
-	int currentStatus(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(status) FROM messages WHERE NOT acknowledged", 
-		into(currentStatus), 
-		now;
-	
-	xa.commit();
+	DeviceStatus status = currentStatus();
 	lock.unlock();
 
-	if (currentStatus != previousStatus)
-	{
-		DeviceStatusChange change;
-		change.previousStatus = static_cast<DeviceStatus>(previousStatus);
-		change.currentStatus = static_cast<DeviceStatus>(currentStatus);
-		statusChanged(this, change);
-	}
-	
-	return static_cast<DeviceStatus>(currentStatus);
+	fireStatusChanged(previousStatus, status);
+
+	return status;
 }
 
 
@@ -163,34 +192,20 @@ DeviceStatus DeviceStatusServiceImpl::acknowledge(int id)
 {
 	Poco::ScopedLockWithUnlock<Poco::FastMutex> lock(_mutex);
 
-	Poco::Data::Transaction xa(*_pSession, &_logger);
-
-	int previousStatus(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(status) FROM messages WHERE NOT acknowledged", 
-		into(previousStatus), 
-		now;
+	DeviceStatus previousStatus = currentStatus();
 
-	(*_pSession) << "UPDATE messages SET acknowledged = 1 WHERE id = ?",
-		use(id),
-		now;
+	MessageMap::iterator it = _messages.find(id);
+	if (it != _messages.end())
+	{
+		acknowledgeMessage(it->second);
+	}
 
-	int currentStatus(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(status) FROM messages WHERE NOT acknowledged", 
-		into(currentStatus), 
-		now;
-	
-	xa.commit();
+	DeviceStatus status = currentStatus();
 	lock.unlock();
 
-	if (currentStatus != previousStatus)
-	{
-		DeviceStatusChange change;
-		change.previousStatus = static_cast<DeviceStatus>(previousStatus);
-		change.currentStatus = static_cast<DeviceStatus>(currentStatus);
-		statusChanged(this, change);
-	}
+	fireStatusChanged(previousStatus, status);
 
-	return static_cast<DeviceStatus>(currentStatus);
+	return status;
 }
 
 
@@ -198,47 +213,98 @@ DeviceStatus DeviceStatusServiceImpl::remove(int id)
 {
 	Poco::ScopedLockWithUnlock<Poco::FastMutex> lock(_mutex);
 
-	Poco::Data::Transaction xa(*_pSession, &_logger);
-
-	int previousStatus(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(status) FROM messages WHERE NOT acknowledged", 
-		into(previousStatus), 
-		now;
+	DeviceStatus previousStatus = currentStatus();
 
-	(*_pSession) << "DELETE FROM messages WHERE id = ?",
-		use(id),
-		now;
+	removeMessage(_messages.find(id));
 
-	int currentStatus(DEVICE_STATUS_OK);
-	(*_pSession) << "SELECT MAX(status) FROM messages WHERE NOT acknowledged", 
-		into(currentStatus), 
-		now;
-	
-	xa.commit();
+	DeviceStatus status = currentStatus();
 	lock.unlock();
 
-	if (currentStatus != previousStatus)
+	fireStatusChanged(previousStatus, status);
+
+	return status;
+}
+
+
+std::vector<StatusMessage> DeviceStatusServiceImpl::messages(int maxMessages) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	// ids are assigned in ascending order, so the most recent
+	// messages come last
+	std::vector<StatusMessage> result;
+	for (MessageMap::const_reverse_iterator it = _messages.rbegin(); it != _messages.rend() && (maxMessages <= 0 || result.size() < static_cast<std::size_t>(maxMessages)); ++it)
 	{
-		DeviceStatusChange change;
-		change.previousStatus = static_cast<DeviceStatus>(previousStatus);
-		change.currentStatus = static_cast<DeviceStatus>(currentStatus);
-		statusChanged(this, change);
+		result.push_back(it->second);
+	}
+	return result;
+}
+
+
+void DeviceStatusServiceImpl::reset()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_messages.clear();
+	_classIndex.clear();
+	for (int i = 0; i < STATUS_LEVELS; i++)
+	{
+		_unacknowledged[i] = 0;
+	}
+	_changes.clear();
+	_deleteAll = true;
+	_flushEvent.set();
+}
+
+
+void DeviceStatusServiceImpl::flush()
+{
+	Poco::FastMutex::ScopedLock sessionLock(_sessionMutex);
+
+	ChangeSet changes;
+	bool deleteAll;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		changes.swap(_changes);
+		deleteAll = _deleteAll;
+		_deleteAll = false;
+	}
+	if (changes.empty() && !deleteAll) return;
+
+	try
+	{
+		writeChanges(changes, deleteAll);
 	}
+	catch (Poco::Exception&)
+	{
+		// Keep the changes for the next attempt, unless
+		// reset() has been called in the meantime.
+		Poco::FastMutex::ScopedLock lock(_mutex);
 
-	return static_cast<DeviceStatus>(currentStatus);
+		if (!_deleteAll)
+		{
+			changes.merge(_changes);
+			_changes.swap(changes);
+			_deleteAll = deleteAll;
+		}
+		throw;
+	}
 }
 
 
-std::vector<StatusMessage> DeviceStatusServiceImpl::messages(int maxMessages) const
+void DeviceStatusServiceImpl::load()
 {
-	Poco::ScopedLockWithUnlock<Poco::FastMutex> lock(_mutex);
+	(*_pSession) << "SELECT COALESCE(MAX(seq), 0) + 1 FROM sqlite_sequence WHERE name = 'messages'",
+		into(_nextId),
+		now;
 
 	StatusMessage message;
 	int status;
 	Poco::Data::Statement select = ((*_pSession) <<
 		"SELECT id, messageClass, status, text, timestamp, acknowledged"
 		"  FROM messages"
-		"  ORDER BY timestamp DESC, id DESC",
+		"  ORDER BY id",
 		into(message.id),
 		into(message.messageClass),
 		into(status),
@@ -246,25 +312,134 @@ std::vector<StatusMessage> DeviceStatusServiceImpl::messages(int maxMessages) co
 		into(message.timestamp),
 		into(message.acknowledged),
 		limit(1));
-	
-	std::vector<StatusMessage> result;
-	while (!select.done() && (maxMessages == 0 || result.size() < maxMessages))
+
+	while (!select.done())
 	{
 		if (select.execute())
 		{
-			message.status = static_cast<DeviceStatus>(status);
-			result.push_back(message);
+			message.status = validStatus(status);
+			if (!message.messageClass.empty())
+			{
+				ClassIndex::iterator it = _classIndex.find(message.messageClass);
+				if (it != _classIndex.end())
+				{
+					removeMessage(_messages.find(it->second));
+				}
+			}
+			addMessage(message);
+			if (message.id >= _nextId) _nextId = message.id + 1;
 		}
 	}
-	return result;
 }
 
 
-void DeviceStatusServiceImpl::reset()
+void DeviceStatusServiceImpl::addMessage(const StatusMessage& message)
 {
-	Poco::ScopedLockWithUnlock<Poco::FastMutex> lock(_mutex);
+	_messages[message.id] = message;
+	if (!message.messageClass.empty())
+	{
+		_classIndex[message.messageClass] = message.id;
+	}
+	if (!message.acknowledged)
+	{
+		_unacknowledged[message.status]++;
+	}
+}
+
+
+void DeviceStatusServiceImpl::acknowledgeMessage(StatusMessage& message)
+{
+	if (!message.acknowledged)
+	{
+		message.acknowledged = true;
+		_unacknowledged[message.status]--;
+		recordChange(Change::CHANGE_ACKNOWLEDGE, message);
+	}
+}
+
+
+void DeviceStatusServiceImpl::removeMessage(MessageMap::iterator it)
+{
+	if (it == _messages.end()) return;
+
+	const StatusMessage& message = it->second;
+	if (!message.acknowledged)
+	{
+		_unacknowledged[message.status]--;
+	}
+	if (!message.messageClass.empty())
+	{
+		ClassIndex::iterator itClass = _classIndex.find(message.messageClass);
+		if (itClass != _classIndex.end() && itClass->second == message.id)
+		{
+			_classIndex.erase(itClass);
+		}
+	}
+	recordChange(Change::CHANGE_DELETE, message);
+	_messages.erase(it);
+}
+
+
+DeviceStatus DeviceStatusServiceImpl::currentStatus() const
+{
+	for (int status = DEVICE_STATUS_FATAL; status > DEVICE_STATUS_OK; status--)
+	{
+		if (_unacknowledged[status] > 0) return static_cast<DeviceStatus>(status);
+	}
+	return DEVICE_STATUS_OK;
+}
+
 
-	(*_pSession) << "DELETE FROM messages", now;	
+void DeviceStatusServiceImpl::recordChange(Change::Operation operation, const StatusMessage& message)
+{
+	_changes.add(operation, message);
+	if (_changes.size() >= _maxPendingChanges)
+	{
+		_flushEvent.set();
+	}
+}
+
+
+void DeviceStatusServiceImpl::writeChanges(const ChangeSet& changes, bool deleteAll)
+{
+	Poco::Data::Transaction xa(*_pSession, &_logger);
+
+	if (deleteAll)
+	{
+		(*_pSession) << "DELETE FROM messages", now;
+	}
+
+	for (ChangeSet::ConstIterator it = changes.begin(); it != changes.end(); ++it)
+	{
+		_row = it->second.message;
+		_rowStatus = _row.status;
+		switch (it->second.operation)
+		{
+		case Change::CHANGE_INSERT:
+			_pInsert->execute();
+			break;
+		case Change::CHANGE_ACKNOWLEDGE:
+			_pAcknowledge->execute();
+			break;
+		case Change::CHANGE_DELETE:
+			_pDelete->execute();
+			break;
+		}
+	}
+
+	xa.commit();
+}
+
+
+void DeviceStatusServiceImpl::fireStatusChanged(DeviceStatus previousStatus, DeviceStatus currentStatus)
+{
+	if (currentStatus != previousStatus)
+	{
+		DeviceStatusChange change;
+		change.previousStatus = previousStatus;
+		change.currentStatus = currentStatus;
+		statusChanged(this, change);
+	}
 }
 
 
@@ -274,12 +449,34 @@ void DeviceStatusServiceImpl::cleanup(bool force)
 	{
 		Poco::DateTime cutoffDate;
 		cutoffDate -= Poco::Timespan(0, _maxAge, 0, 0, 0);
-		(*_pSession) << "DELETE FROM messages WHERE acknowledged AND timestamp < ?",
-			use(cutoffDate),
-			now;
+		MessageMap::iterator it = _messages.begin();
+		while (it != _messages.end())
+		{
+			if (it->second.acknowledged && it->second.timestamp < cutoffDate)
+				removeMessage(it++);
+			else
+				++it;
+		}
 		_lastCleanup.update();
 	}
 }
 
 
+void DeviceStatusServiceImpl::runActivity()
+{
+	while (!_activity.isStopped())
+	{
+		_flushEvent.tryWait(_flushInterval);
+		try
+		{
+			flush();
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.error("Failed to write device status messages: " + exc.displayText());
+		}
+	}
+}
+
+
 } } // namespace IoT::DeviceStatus
@@ -21,12 +21,17 @@
 
 
 #include "IoT/DeviceStatus/DeviceStatusService.h"
+#include "IoT/DeviceStatus/ChangeSet.h"
 #include "Poco/OSP/BundleContext.h"
 #include "Poco/Data/Session.h"
+#include "Poco/Data/Statement.h"
+#include "Poco/Activity.h"
+#include "Poco/Event.h"
 #include "Poco/Clock.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/Logger.h"
 #include "Poco/Mutex.h"
+#include <map>
 
 
 namespace IoT {
@@ -35,13 +40,37 @@ namespace DeviceStatus {
 
 class DeviceStatusServiceImpl: public DeviceStatusService
 	/// Default implementation of the DeviceStatusService.
+	///
+	/// All messages are kept in memory, indexed by id and by
+	/// message class, together with the number of unacknowledged
+	/// messages for every status level. The current device status
+	/// can therefore be determined without accessing the database.
+	///
+	/// Changes are written behind to a SQLite database in the
+	/// bundle's persistent directory. A background activity writes
+	/// all pending changes in a single transaction, using prepared
+	/// statements, every flushInterval milliseconds, or as soon as
+	/// maxPendingChanges changes are pending. Changes to the same
+	/// message are combined, so a message that is posted and removed
+	/// again within a flush interval never reaches the database.
 {
 public:
-	DeviceStatusServiceImpl(Poco::OSP::BundleContext::Ptr pContext, int maxAge);
-		/// Creates the DeviceStatusServiceImpl.
+	enum
+	{
+		DEFAULT_FLUSH_INTERVAL = 1000,
+		DEFAULT_MAX_PENDING_CHANGES = 100
+	};
+
+	DeviceStatusServiceImpl(Poco::OSP::BundleContext::Ptr pContext, int maxAge, long flushInterval = DEFAULT_FLUSH_INTERVAL, std::size_t maxPendingChanges = DEFAULT_MAX_PENDING_CHANGES);
+		/// Creates the DeviceStatusServiceImpl and loads all
+		/// stored messages.
+		///
+		/// Acknowledged messages older than maxAge hours are removed.
+		/// The flushInterval is given in milliseconds and must be
+		/// greater than zero.
 		
 	~DeviceStatusServiceImpl();
-		/// Destroys the DeviceStatusService.
+		/// Writes all pending changes and destroys the DeviceStatusService.
 	
 	// DeviceStatusService
 	DeviceStatus status() const;
@@ -52,15 +81,52 @@ public:
 	std::vector<StatusMessage> messages(int maxMessages) const;
 	void reset();
 
+	void flush();
+		/// Writes all pending changes to the database.
+
 protected:
+	typedef ChangeSet::Change Change;
+	typedef std::map<int, StatusMessage> MessageMap;
+	typedef std::map<std::string, int> ClassIndex;
+
+	void load();
+	void addMessage(const StatusMessage& message);
+	void acknowledgeMessage(StatusMessage& message);
+	void removeMessage(MessageMap::iterator it);
+	DeviceStatus currentStatus() const;
+	void recordChange(Change::Operation operation, const StatusMessage& message);
+	void writeChanges(const ChangeSet& changes, bool deleteAll);
+	void fireStatusChanged(DeviceStatus previousStatus, DeviceStatus currentStatus);
 	void cleanup(bool force = false);
+	void runActivity();
 
 private:
+	enum
+	{
+		STATUS_LEVELS = DEVICE_STATUS_FATAL + 1
+	};
+
 	Poco::OSP::BundleContext::Ptr _pContext;
 	int _maxAge;
+	long _flushInterval;
+	std::size_t _maxPendingChanges;
 	Poco::Clock _lastCleanup;
-	mutable Poco::SharedPtr<Poco::Data::Session> _pSession;
+	MessageMap _messages;
+	ClassIndex _classIndex;
+	int _unacknowledged[STATUS_LEVELS];
+	int _nextId;
+	ChangeSet _changes;
+	bool _deleteAll;
+	Poco::SharedPtr<Poco::Data::Session> _pSession;
+	Poco::SharedPtr<Poco::Data::Statement> _pInsert;
+	Poco::SharedPtr<Poco::Data::Statement> _pAcknowledge;
+	Poco::SharedPtr<Poco::Data::Statement> _pDelete;
+	StatusMessage _row;
+	int _rowStatus;
+	Poco::Event _flushEvent;
+	Poco::Activity<DeviceStatusServiceImpl> _activity;
 	Poco::Logger& _logger;
+	Poco::FastMutex _sessionMutex;
 	mutable Poco::FastMutex _mutex;
 };
 
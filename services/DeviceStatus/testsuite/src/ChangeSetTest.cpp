@@ -0,0 +1,188 @@
+//
+// ChangeSetTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "ChangeSetTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/DeviceStatus/ChangeSet.h"
+
+
+using IoT::DeviceStatus::ChangeSet;
+using IoT::DeviceStatus::StatusMessage;
+
+
+namespace
+{
+	StatusMessage message(int id, bool acknowledged = false)
+	{
+		StatusMessage msg;
+		msg.id = id;
+		msg.messageClass = "class";
+		msg.status = IoT::DeviceStatus::DEVICE_STATUS_WARNING;
+		msg.text = "text";
+		msg.acknowledged = acknowledged;
+		return msg;
+	}
+}
+
+
+ChangeSetTest::ChangeSetTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+ChangeSetTest::~ChangeSetTest()
+{
+}
+
+
+void ChangeSetTest::testAdd()
+{
+	ChangeSet changes;
+	assert (changes.empty());
+
+	changes.add(ChangeSet::Change::CHANGE_INSERT, message(3));
+	changes.add(ChangeSet::Change::CHANGE_ACKNOWLEDGE, message(1, true));
+	changes.add(ChangeSet::Change::CHANGE_DELETE, message(2));
+	assert (changes.size() == 3);
+
+	ChangeSet::ConstIterator it = changes.begin();
+	assert (it->first == 1);
+	assert (it->second.operation == ChangeSet::Change::CHANGE_ACKNOWLEDGE);
+	++it;
+	assert (it->first == 2);
+	assert (it->second.operation == ChangeSet::Change::CHANGE_DELETE);
+	++it;
+	assert (it->first == 3);
+	assert (it->second.operation == ChangeSet::Change::CHANGE_INSERT);
+	assert (!it->second.message.acknowledged);
+	++it;
+	assert (it == changes.end());
+
+	ChangeSet other;
+	other.swap(changes);
+	assert (changes.empty());
+	assert (other.size() == 3);
+	other.clear();
+	assert (other.empty());
+}
+
+
+void ChangeSetTest::testInsertDelete()
+{
+	// a message deleted before it has been written never reaches the database
+	ChangeSet changes;
+	changes.add(ChangeSet::Change::CHANGE_INSERT, message(1));
+	changes.add(ChangeSet::Change::CHANGE_INSERT, message(2));
+	changes.add(ChangeSet::Change::CHANGE_DELETE, message(1));
+	assert (changes.size() == 1);
+	assert (changes.find(1) == changes.end());
+	assert (changes.find(2) != changes.end());
+
+	changes.add(ChangeSet::Change::CHANGE_INSERT, message(3));
+	changes.add(ChangeSet::Change::CHANGE_ACKNOWLEDGE, message(3, true));
+	changes.add(ChangeSet::Change::CHANGE_DELETE, message(3));
+	assert (changes.size() == 1);
+	assert (changes.find(3) == changes.end());
+}
+
+
+void ChangeSetTest::testInsertAcknowledge()
+{
+	// the acknowledged message is inserted
+	ChangeSet changes;
+	changes.add(ChangeSet::Change::CHANGE_INSERT, message(1));
+	changes.add(ChangeSet::Change::CHANGE_ACKNOWLEDGE, message(1, true));
+	assert (changes.size() == 1);
+	ChangeSet::ConstIterator it = changes.find(1);
+	assert (it != changes.end());
+	assert (it->second.operation == ChangeSet::Change::CHANGE_INSERT);
+	assert (it->second.message.acknowledged);
+}
+
+
+void ChangeSetTest::testAcknowledgeDelete()
+{
+	// a message that has already been written must be deleted
+	ChangeSet changes;
+	changes.add(ChangeSet::Change::CHANGE_ACKNOWLEDGE, message(1, true));
+	changes.add(ChangeSet::Change::CHANGE_DELETE, message(1, true));
+	assert (changes.size() == 1);
+	ChangeSet::ConstIterator it = changes.find(1);
+	assert (it != changes.end());
+	assert (it->second.operation == ChangeSet::Change::CHANGE_DELETE);
+}
+
+
+void ChangeSetTest::testMergeAfterFailedFlush()
+{
+	// changes taken for a flush that failed
+	ChangeSet failed;
+	failed.add(ChangeSet::Change::CHANGE_INSERT, message(1));
+	failed.add(ChangeSet::Change::CHANGE_ACKNOWLEDGE, message(2, true));
+	failed.add(ChangeSet::Change::CHANGE_INSERT, message(3));
+	failed.add(ChangeSet::Change::CHANGE_INSERT, message(4));
+
+	// changes made while the flush was in progress
+	ChangeSet newer;
+	newer.add(ChangeSet::Change::CHANGE_DELETE, message(1));
+	newer.add(ChangeSet::Change::CHANGE_DELETE, message(2, true));
+	newer.add(ChangeSet::Change::CHANGE_ACKNOWLEDGE, message(3, true));
+	newer.add(ChangeSet::Change::CHANGE_INSERT, message(5));
+
+	failed.merge(newer);
+	assert (failed.size() == 4);
+	assert (failed.find(1) == failed.end());
+
+	ChangeSet::ConstIterator it = failed.find(2);
+	assert (it != failed.end());
+	assert (it->second.operation == ChangeSet::Change::CHANGE_DELETE);
+
+	it = failed.find(3);
+	assert (it != failed.end());
+	assert (it->second.operation == ChangeSet::Change::CHANGE_INSERT);
+	assert (it->second.message.acknowledged);
+
+	it = failed.find(4);
+	assert (it != failed.end());
+	assert (it->second.operation == ChangeSet::Change::CHANGE_INSERT);
+	assert (!it->second.message.acknowledged);
+
+	it = failed.find(5);
+	assert (it != failed.end());
+	assert (it->second.operation == ChangeSet::Change::CHANGE_INSERT);
+}
+
+
+void ChangeSetTest::setUp()
+{
+}
+
+
+void ChangeSetTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ChangeSetTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ChangeSetTest");
+
+	CppUnit_addTest(pSuite, ChangeSetTest, testAdd);
+	CppUnit_addTest(pSuite, ChangeSetTest, testInsertDelete);
+	CppUnit_addTest(pSuite, ChangeSetTest, testInsertAcknowledge);
+	CppUnit_addTest(pSuite, ChangeSetTest, testAcknowledgeDelete);
+	CppUnit_addTest(pSuite, ChangeSetTest, testMergeAfterFailedFlush);
+
+	return pSuite;
+}
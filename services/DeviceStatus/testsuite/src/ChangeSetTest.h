@@ -0,0 +1,42 @@
+//
+// ChangeSetTest.h
+//
+// $Id$
+//
+// Definition of the ChangeSetTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef ChangeSetTest_INCLUDED
+#define ChangeSetTest_INCLUDED
+
+
+#include "IoT/DeviceStatus/DeviceStatus.h"
+#include "CppUnit/TestCase.h"
+
+
+class ChangeSetTest: public CppUnit::TestCase
+{
+public:
+	ChangeSetTest(const std::string& name);
+	~ChangeSetTest();
+
+	void testAdd();
+	void testInsertDelete();
+	void testInsertAcknowledge();
+	void testAcknowledgeDelete();
+	void testMergeAfterFailedFlush();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // ChangeSetTest_INCLUDED
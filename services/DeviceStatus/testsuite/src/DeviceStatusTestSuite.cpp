@@ -0,0 +1,24 @@
+//
+// DeviceStatusTestSuite.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "DeviceStatusTestSuite.h"
+#include "ChangeSetTest.h"
+
+
+CppUnit::Test* DeviceStatusTestSuite::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("DeviceStatusTestSuite");
+
+	pSuite->addTest(ChangeSetTest::suite());
+
+	return pSuite;
+}
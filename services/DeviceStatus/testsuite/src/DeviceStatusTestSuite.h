@@ -0,0 +1,29 @@
+//
+// DeviceStatusTestSuite.h
+//
+// $Id$
+//
+// Definition of the DeviceStatusTestSuite class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef DeviceStatusTestSuite_INCLUDED
+#define DeviceStatusTestSuite_INCLUDED
+
+
+#include "CppUnit/TestSuite.h"
+
+
+class DeviceStatusTestSuite
+{
+public:
+	static CppUnit::Test* suite();
+};
+
+
+#endif // DeviceStatusTestSuite_INCLUDED
@@ -0,0 +1,65 @@
+//
+// FenceDeserializer.h
+//
+// Package: Generated
+// Module:  TypeDeserializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeDeserializer_IoT_Geofence_Fence_INCLUDED
+#define TypeDeserializer_IoT_Geofence_Fence_INCLUDED
+
+
+#include "IoT/Devices/LatLonDeserializer.h"
+#include "IoT/Geofence/GeofenceService.h"
+#include "Poco/RemotingNG/TypeDeserializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeDeserializer<IoT::Geofence::Fence>
+{
+public:
+	static bool deserialize(const std::string& name, bool isMandatory, Deserializer& deser, IoT::Geofence::Fence& value)
+	{
+		bool ret = deser.deserializeStructBegin(name, isMandatory);
+		if (ret)
+		{
+			deserializeImpl(deser, value);
+			deser.deserializeStructEnd(name);
+		}
+		return ret;
+	}
+
+	static void deserializeImpl(Deserializer& deser, IoT::Geofence::Fence& value)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"center","dwellTime","id","polygon","radius"};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeDeserializer<IoT::Devices::LatLon >::deserialize(REMOTING__NAMES[0], false, deser, value.center);
+		TypeDeserializer<int >::deserialize(REMOTING__NAMES[1], false, deser, value.dwellTime);
+		TypeDeserializer<std::string >::deserialize(REMOTING__NAMES[2], true, deser, value.id);
+		TypeDeserializer<std::vector < IoT::Devices::LatLon > >::deserialize(REMOTING__NAMES[3], false, deser, value.polygon);
+		TypeDeserializer<double >::deserialize(REMOTING__NAMES[4], false, deser, value.radius);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeDeserializer_IoT_Geofence_Fence_INCLUDED
+
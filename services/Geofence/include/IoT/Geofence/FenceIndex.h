@@ -0,0 +1,197 @@
+//
+// FenceIndex.h
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: Geofence
+// Module:  FenceIndex
+//
+// Definition of the FenceIndex class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_FenceIndex_INCLUDED
+#define IoT_Geofence_FenceIndex_INCLUDED
+
+
+#include "IoT/Geofence/Geofence.h"
+#include <vector>
+#include <string>
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class IoTGeofence_API FenceIndex
+	/// A spatial index of fence bounding boxes, implemented as
+	/// an R-tree with quadratic node splitting.
+	///
+	/// Boxes are given in degrees and must not cross the
+	/// antimeridian. A fence whose extent crosses the antimeridian
+	/// must be inserted as two boxes, one on either side.
+	///
+	/// Finding the boxes that contain a point visits only the
+	/// subtrees whose bounding boxes contain the point, which
+	/// takes O(log n) for n reasonably distributed fences.
+	///
+	/// FenceIndex is not thread safe.
+{
+public:
+	struct Box
+		/// An axis-aligned bounding box in degrees.
+	{
+		Box();
+			/// Creates an empty Box.
+
+		Box(double minLat, double minLon, double maxLat, double maxLon);
+			/// Creates the Box with the given extent.
+
+		bool contains(double lat, double lon) const;
+			/// Returns true if the box contains the given point.
+
+		bool intersects(const Box& other) const;
+			/// Returns true if the box and the other box overlap.
+
+		void extend(const Box& other);
+			/// Extends the box to also cover the other box.
+
+		double area() const;
+			/// Returns the area of the box in square degrees.
+
+		double minLat;
+		double minLon;
+		double maxLat;
+		double maxLon;
+	};
+
+	enum
+	{
+		MAX_ENTRIES = 16,
+		MIN_ENTRIES = 6
+	};
+
+	FenceIndex();
+		/// Creates an empty FenceIndex.
+
+	~FenceIndex();
+		/// Destroys the FenceIndex.
+
+	void insert(const std::string& id, const Box& box);
+		/// Inserts the given box for the fence with the given ID.
+		/// The same ID can be inserted with multiple boxes.
+
+	bool remove(const std::string& id, const Box& box);
+		/// Removes the entry for the given ID and box. The box must
+		/// be the same as the one given to insert().
+		///
+		/// Returns true if the entry has been found and removed.
+
+	void find(double lat, double lon, std::vector<std::string>& ids) const;
+		/// Appends the IDs of all boxes containing the given point to ids.
+		/// An ID inserted with more than one box may be appended more than once.
+
+	void find(const Box& box, std::vector<std::string>& ids) const;
+		/// Appends the IDs of all boxes intersecting the given box to ids.
+
+	std::size_t size() const;
+		/// Returns the number of entries in the index.
+
+	int height() const;
+		/// Returns the height of the tree. An empty tree has height 1.
+
+	void clear();
+		/// Removes all entries.
+
+protected:
+	struct Node;
+
+	struct Entry
+	{
+		Entry();
+		Entry(const Box& box, Node* pChild);
+		Entry(const Box& box, const std::string& id);
+
+		Box box;
+		Node* pChild;
+		std::string id;
+	};
+
+	typedef std::vector<Entry> EntryVec;
+
+	struct Node
+	{
+		EntryVec entries;
+	};
+
+	struct Orphan
+	{
+		Entry entry;
+		int level;
+	};
+
+	typedef std::vector<Orphan> OrphanVec;
+
+	Node* insertImpl(Node* pNode, int nodeLevel, const Entry& entry, int level);
+	bool removeImpl(Node* pNode, int nodeLevel, const std::string& id, const Box& box, OrphanVec& orphans);
+	void findImpl(const Node* pNode, double lat, double lon, std::vector<std::string>& ids) const;
+	void findImpl(const Node* pNode, const Box& box, std::vector<std::string>& ids) const;
+	Node* split(Node* pNode);
+	void insertEntry(const Entry& entry, int level);
+	static Box bounds(const Node* pNode);
+	void reinsert(const Entry& entry, int level);
+	static void destroy(Node* pNode);
+
+private:
+	FenceIndex(const FenceIndex&);
+	FenceIndex& operator = (const FenceIndex&);
+
+	Node* _pRoot;
+	int _height;
+	std::size_t _size;
+};
+
+
+//
+// inlines
+//
+inline bool FenceIndex::Box::contains(double lat, double lon) const
+{
+	return lat >= minLat && lat <= maxLat && lon >= minLon && lon <= maxLon;
+}
+
+
+inline bool FenceIndex::Box::intersects(const Box& other) const
+{
+	return minLat <= other.maxLat && other.minLat <= maxLat && minLon <= other.maxLon && other.minLon <= maxLon;
+}
+
+
+inline double FenceIndex::Box::area() const
+{
+	return (maxLat - minLat)*(maxLon - minLon);
+}
+
+
+inline std::size_t FenceIndex::size() const
+{
+	return _size;
+}
+
+
+inline int FenceIndex::height() const
+{
+	return _height;
+}
+
+
+} } // namespace IoT::Geofence
+
+
+#endif // IoT_Geofence_FenceIndex_INCLUDED
@@ -0,0 +1,61 @@
+//
+// FenceSerializer.h
+//
+// Package: Generated
+// Module:  TypeSerializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeSerializer_IoT_Geofence_Fence_INCLUDED
+#define TypeSerializer_IoT_Geofence_Fence_INCLUDED
+
+
+#include "IoT/Devices/LatLonSerializer.h"
+#include "IoT/Geofence/GeofenceService.h"
+#include "Poco/RemotingNG/TypeSerializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeSerializer<IoT::Geofence::Fence>
+{
+public:
+	static void serialize(const std::string& name, const IoT::Geofence::Fence& value, Serializer& ser)
+	{
+		ser.serializeStructBegin(name);
+		serializeImpl(value, ser);
+		ser.serializeStructEnd(name);
+	}
+
+	static void serializeImpl(const IoT::Geofence::Fence& value, Serializer& ser)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"center","dwellTime","id","polygon","radius",""};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeSerializer<IoT::Devices::LatLon >::serialize(REMOTING__NAMES[0], value.center, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[1], value.dwellTime, ser);
+		TypeSerializer<std::string >::serialize(REMOTING__NAMES[2], value.id, ser);
+		TypeSerializer<std::vector < IoT::Devices::LatLon > >::serialize(REMOTING__NAMES[3], value.polygon, ser);
+		TypeSerializer<double >::serialize(REMOTING__NAMES[4], value.radius, ser);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeSerializer_IoT_Geofence_Fence_INCLUDED
+
@@ -0,0 +1,60 @@
+//
+// Geofence.h
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: Geofence
+// Module:  Geofence
+//
+// Basic definitions for the IoT Geofence library.
+// This file must be the first file included by every other Geofence
+// header file.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_Geofence_INCLUDED
+#define IoT_Geofence_Geofence_INCLUDED
+
+
+#include "Poco/Poco.h"
+
+
+//
+// The following block is the standard way of creating macros which make exporting
+// from a DLL simpler. All files within this DLL are compiled with the IoTGeofence_EXPORTS
+// symbol defined on the command line. this symbol should not be defined on any project
+// that uses this DLL. This way any other project whose source files include this file see
+// IoTGeofence_API functions as being imported from a DLL, wheras this DLL sees symbols
+// defined with this macro as being exported.
+//
+#if defined(_WIN32) && defined(POCO_DLL)
+	#if defined(IoTGeofence_EXPORTS)
+		#define IoTGeofence_API __declspec(dllexport)
+	#else
+		#define IoTGeofence_API __declspec(dllimport)
+	#endif
+#endif
+
+
+#if !defined(IoTGeofence_API)
+	#define IoTGeofence_API
+#endif
+
+
+//
+// Automatically link Geofence library.
+//
+#if defined(_MSC_VER)
+	#if !defined(POCO_NO_AUTOMATIC_LIBS) && !defined(IoTGeofence_EXPORTS)
+		#pragma comment(lib, "IoTGeofence" POCO_LIB_SUFFIX)
+	#endif
+#endif
+
+
+#endif // IoT_Geofence_Geofence_INCLUDED
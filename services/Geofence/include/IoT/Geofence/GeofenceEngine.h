@@ -0,0 +1,160 @@
+//
+// GeofenceEngine.h
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: Geofence
+// Module:  GeofenceEngine
+//
+// Definition of the GeofenceEngine class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_GeofenceEngine_INCLUDED
+#define IoT_Geofence_GeofenceEngine_INCLUDED
+
+
+#include "IoT/Geofence/GeofenceService.h"
+#include "IoT/Geofence/FenceIndex.h"
+#include "Poco/SharedPtr.h"
+#include <map>
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class IoTGeofence_API GeofenceEngine
+	/// GeofenceEngine keeps a set of fences in a FenceIndex and
+	/// evaluates position fixes against them.
+	///
+	/// For every fix, only the fences whose bounding boxes contain
+	/// the position are tested exactly, using a great-circle distance
+	/// for circular fences and a point-in-polygon test for polygonal
+	/// fences. The resulting set of fences is compared to the one of
+	/// the previous fix to find GEOFENCE_EXIT and GEOFENCE_ENTER
+	/// transitions. Thus, the cost of a fix depends on the number of
+	/// fences near the position, not on the total number of fences.
+	///
+	/// Polygon edges are straight lines in latitude/longitude space,
+	/// which is accurate enough for fences up to a few kilometers.
+	/// Polygons and circles crossing the antimeridian are supported.
+	///
+	/// GeofenceEngine is not thread safe.
+{
+public:
+	GeofenceEngine();
+		/// Creates an empty GeofenceEngine.
+
+	~GeofenceEngine();
+		/// Destroys the GeofenceEngine.
+
+	void add(const Fence& fence);
+		/// Adds the given fence, replacing an existing fence with the same ID.
+		/// If the position was inside the replaced fence, the next update()
+		/// reports a GEOFENCE_EXIT transition only if the position is not
+		/// inside the new fence.
+		///
+		/// Throws a Poco::InvalidArgumentException if the fence is invalid.
+
+	bool remove(const std::string& id);
+		/// Removes the fence with the given ID. Returns true if the fence
+		/// existed, otherwise false.
+
+	void clear();
+		/// Removes all fences.
+
+	bool has(const std::string& id) const;
+		/// Returns true if a fence with the given ID exists.
+
+	const Fence& get(const std::string& id) const;
+		/// Returns the fence with the given ID.
+		///
+		/// Throws a Poco::NotFoundException if no such fence exists.
+
+	void ids(std::vector<std::string>& ids) const;
+		/// Returns the IDs of all fences, in ascending order.
+
+	void inside(std::vector<std::string>& ids) const;
+		/// Returns the IDs of all fences containing the position
+		/// given to the most recent call to update(), in ascending order.
+
+	std::size_t size() const;
+		/// Returns the number of fences.
+
+	void update(const IoT::Devices::LatLon& position, Poco::Int64 timestamp, std::vector<GeofenceEvent>& events);
+		/// Evaluates the given position, with the given timestamp in
+		/// milliseconds, and appends all transitions to events.
+		///
+		/// GEOFENCE_EXIT transitions are reported before GEOFENCE_ENTER
+		/// and GEOFENCE_DWELL transitions.
+
+	const FenceIndex& index() const;
+		/// Returns the FenceIndex.
+
+protected:
+	struct CompiledFence
+	{
+		CompiledFence();
+
+		bool contains(double lat, double lon) const;
+
+		Fence fence;
+		std::vector<FenceIndex::Box> boxes;
+		std::vector<double> lats;
+		std::vector<double> lons;
+		bool shifted;
+			/// Vertex longitudes have been moved to [0, 360)
+			/// because the polygon crosses the antimeridian.
+	};
+
+	struct Presence
+	{
+		Poco::Int64 enterTime;
+		bool dwellReported;
+	};
+
+	typedef Poco::SharedPtr<CompiledFence> CompiledFencePtr;
+	typedef std::map<std::string, CompiledFencePtr> FenceMap;
+	typedef std::map<std::string, Presence> PresenceMap;
+
+	static CompiledFencePtr compile(const Fence& fence);
+	static void addBoxes(double minLat, double minLon, double maxLat, double maxLon, std::vector<FenceIndex::Box>& boxes);
+	void unindex(const CompiledFence& compiledFence);
+
+private:
+	GeofenceEngine(const GeofenceEngine&);
+	GeofenceEngine& operator = (const GeofenceEngine&);
+
+	FenceMap _fences;
+	PresenceMap _inside;
+	FenceIndex _index;
+	std::vector<std::string> _candidates;
+};
+
+
+//
+// inlines
+//
+inline std::size_t GeofenceEngine::size() const
+{
+	return _fences.size();
+}
+
+
+inline const FenceIndex& GeofenceEngine::index() const
+{
+	return _index;
+}
+
+
+} } // namespace IoT::Geofence
+
+
+#endif // IoT_Geofence_GeofenceEngine_INCLUDED
@@ -0,0 +1,60 @@
+//
+// GeofenceEventSerializer.h
+//
+// Package: Generated
+// Module:  TypeSerializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeSerializer_IoT_Geofence_GeofenceEvent_INCLUDED
+#define TypeSerializer_IoT_Geofence_GeofenceEvent_INCLUDED
+
+
+#include "IoT/Devices/LatLonSerializer.h"
+#include "IoT/Geofence/GeofenceService.h"
+#include "Poco/RemotingNG/TypeSerializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeSerializer<IoT::Geofence::GeofenceEvent>
+{
+public:
+	static void serialize(const std::string& name, const IoT::Geofence::GeofenceEvent& value, Serializer& ser)
+	{
+		ser.serializeStructBegin(name);
+		serializeImpl(value, ser);
+		ser.serializeStructEnd(name);
+	}
+
+	static void serializeImpl(const IoT::Geofence::GeofenceEvent& value, Serializer& ser)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"fenceId","position","timestamp","transition",""};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeSerializer<std::string >::serialize(REMOTING__NAMES[0], value.fenceId, ser);
+		TypeSerializer<IoT::Devices::LatLon >::serialize(REMOTING__NAMES[1], value.position, ser);
+		TypeSerializer<Poco::Int64 >::serialize(REMOTING__NAMES[2], value.timestamp, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[3], value.transition, ser);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeSerializer_IoT_Geofence_GeofenceEvent_INCLUDED
+
@@ -0,0 +1,205 @@
+//
+// GeofenceService.h
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: GeofenceService
+// Module:  GeofenceService
+//
+// Definition of the GeofenceService interface.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_GeofenceService_INCLUDED
+#define IoT_Geofence_GeofenceService_INCLUDED
+
+
+#include "IoT/Geofence/Geofence.h"
+#include "IoT/Devices/GNSSSensor.h"
+#include "Poco/BasicEvent.h"
+#include "Poco/SharedPtr.h"
+#include <vector>
+
+
+namespace IoT {
+namespace Geofence {
+
+
+enum GeofenceTransition
+{
+	GEOFENCE_ENTER = 1,
+		/// The position has moved into the fence.
+
+	GEOFENCE_EXIT  = 2,
+		/// The position has moved out of the fence.
+
+	GEOFENCE_DWELL = 3
+		/// The position has been inside the fence for at least
+		/// the fence's dwell time.
+};
+
+
+//@ serialize
+struct Fence
+	/// A geofence, which is either a circle given by its
+	/// center and radius, or a polygon given by its vertices.
+{
+	Fence():
+		radius(0.0),
+		dwellTime(0)
+	{
+	}
+
+	std::string id;
+		/// The unique ID of the fence.
+
+	//@ mandatory=false
+	std::vector<IoT::Devices::LatLon> polygon;
+		/// The vertices of a polygonal fence, in order.
+		/// The polygon is closed implicitly. Must be empty for
+		/// a circular fence.
+
+	//@ mandatory=false
+	IoT::Devices::LatLon center;
+		/// The center of a circular fence.
+
+	//@ mandatory=false
+	double radius;
+		/// The radius of a circular fence in meters.
+		/// Must be 0 for a polygonal fence.
+
+	//@ mandatory=false
+	int dwellTime;
+		/// If > 0, a GEOFENCE_DWELL transition is reported
+		/// once the position has been inside the fence for
+		/// the given number of milliseconds.
+};
+
+
+//@ serialize
+struct GeofenceEvent
+	/// Reports a transition of the position with respect to a fence.
+{
+	GeofenceEvent():
+		transition(GEOFENCE_ENTER),
+		timestamp(0)
+	{
+	}
+
+	std::string fenceId;
+		/// The ID of the fence.
+
+	GeofenceTransition transition;
+		/// The kind of transition.
+
+	IoT::Devices::LatLon position;
+		/// The position that caused the transition.
+
+	Poco::Int64 timestamp;
+		/// The time of the position fix, in milliseconds since the Epoch.
+};
+
+
+//@ serialize
+struct TrackPoint
+	/// A single point of the recorded track.
+{
+	TrackPoint():
+		timestamp(0)
+	{
+	}
+
+	IoT::Devices::LatLon position;
+		/// The position.
+
+	Poco::Int64 timestamp;
+		/// The time of the position fix, in milliseconds since the Epoch.
+};
+
+
+//@ remote
+class IoTGeofence_API GeofenceService
+	/// The GeofenceService checks positions against a set
+	/// of circular and polygonal geofences and reports
+	/// entering, leaving and dwelling in a fence.
+	///
+	/// All positions passed to the service are also recorded
+	/// in a compact, delta-encoded track buffer of limited
+	/// capacity, from which a simplified track can be obtained.
+	///
+	/// The service implementation subscribes to the
+	/// positionUpdate event of a GNSSSensor, but positions can
+	/// also be fed by calling updatePosition().
+{
+public:
+	typedef Poco::SharedPtr<GeofenceService> Ptr;
+
+	Poco::BasicEvent<const GeofenceEvent> geofenceTransition;
+		/// Fired for every transition detected by a position update.
+
+	GeofenceService();
+		/// Creates the GeofenceService.
+
+	virtual ~GeofenceService();
+		/// Destroys the GeofenceService.
+
+	virtual void addFence(const Fence& fence) = 0;
+		/// Adds the given fence, replacing an existing fence
+		/// with the same ID.
+		///
+		/// Throws a Poco::InvalidArgumentException if the fence
+		/// is neither a valid circle nor a valid polygon.
+
+	virtual bool removeFence(const std::string& id) = 0;
+		/// Removes the fence with the given ID.
+		/// Returns true if the fence existed, otherwise false.
+		/// No GEOFENCE_EXIT transition is reported.
+
+	virtual std::vector<std::string> fenceIds() const = 0;
+		/// Returns the IDs of all fences.
+
+	virtual Fence fence(const std::string& id) const = 0;
+		/// Returns the fence with the given ID.
+		///
+		/// Throws a Poco::NotFoundException if no such fence exists.
+
+	virtual std::vector<std::string> insideFences() const = 0;
+		/// Returns the IDs of all fences containing the
+		/// most recent position.
+
+	virtual std::vector<GeofenceEvent> updatePosition(const IoT::Devices::LatLon& position, Poco::Int64 timestamp) = 0;
+		/// Evaluates the given position against all fences, records
+		/// it in the track and returns the resulting transitions, which
+		/// are also reported via the geofenceTransition event.
+
+	//@ $tolerance={mandatory=false}
+	virtual std::vector<TrackPoint> track(double tolerance = 0.0) const = 0;
+		/// Returns the recorded track, oldest point first.
+		///
+		/// If tolerance is > 0, the track is simplified with the
+		/// Douglas-Peucker algorithm, removing points that are closer
+		/// than tolerance meters to the simplified track.
+
+	//@ $tolerance={mandatory=false}
+	virtual std::string encodedTrack(double tolerance = 0.0) const = 0;
+		/// Returns the recorded track, simplified as for track(),
+		/// in the compact text format produced by TrackBuffer::encode().
+
+	virtual int trackSize() const = 0;
+		/// Returns the number of points in the recorded track.
+
+	virtual void clearTrack() = 0;
+		/// Removes all points from the recorded track.
+};
+
+
+} } // namespace IoT::Geofence
+
+
+#endif // IoT_Geofence_GeofenceService_INCLUDED
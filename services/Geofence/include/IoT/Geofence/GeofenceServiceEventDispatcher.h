@@ -0,0 +1,73 @@
+//
+// GeofenceServiceEventDispatcher.h
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  GeofenceServiceEventDispatcher
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_GeofenceServiceEventDispatcher_INCLUDED
+#define IoT_Geofence_GeofenceServiceEventDispatcher_INCLUDED
+
+
+#include "IoT/Geofence/GeofenceServiceRemoteObject.h"
+#include "Poco/RemotingNG/EventDispatcher.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class GeofenceServiceEventDispatcher: public Poco::RemotingNG::EventDispatcher
+	/// The GeofenceService checks positions against a set
+	/// of circular and polygonal geofences and reports
+	/// entering, leaving and dwelling in a fence.
+	///
+	/// All positions passed to the service are also recorded
+	/// in a compact, delta-encoded track buffer of limited
+	/// capacity, from which a simplified track can be obtained.
+	///
+	/// The service implementation subscribes to the
+	/// positionUpdate event of a GNSSSensor, but positions can
+	/// also be fed by calling updatePosition().
+{
+public:
+	GeofenceServiceEventDispatcher(GeofenceServiceRemoteObject* pRemoteObject, const std::string& protocol);
+		/// Creates a GeofenceServiceEventDispatcher.
+
+	virtual ~GeofenceServiceEventDispatcher();
+		/// Destroys the GeofenceServiceEventDispatcher.
+
+	void event__geofenceTransition(const void* pSender, const IoT::Geofence::GeofenceEvent& data);
+
+	virtual const Poco::RemotingNG::Identifiable::TypeId& remoting__typeId() const;
+
+private:
+	void event__geofenceTransitionImpl(const std::string& subscriberURI, const IoT::Geofence::GeofenceEvent& data);
+
+	static const std::string DEFAULT_NS;
+	GeofenceServiceRemoteObject* _pRemoteObject;
+};
+
+
+inline const Poco::RemotingNG::Identifiable::TypeId& GeofenceServiceEventDispatcher::remoting__typeId() const
+{
+	return IGeofenceService::remoting__typeId();
+}
+
+
+} // namespace Geofence
+} // namespace IoT
+
+
+#endif // IoT_Geofence_GeofenceServiceEventDispatcher_INCLUDED
+
@@ -0,0 +1,187 @@
+//
+// GeofenceServiceRemoteObject.h
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  GeofenceServiceRemoteObject
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_GeofenceServiceRemoteObject_INCLUDED
+#define IoT_Geofence_GeofenceServiceRemoteObject_INCLUDED
+
+
+#include "IoT/Geofence/IGeofenceService.h"
+#include "Poco/RemotingNG/Identifiable.h"
+#include "Poco/RemotingNG/RemoteObject.h"
+#include "Poco/SharedPtr.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class GeofenceServiceRemoteObject: public IoT::Geofence::IGeofenceService, public Poco::RemotingNG::RemoteObject
+	/// The GeofenceService checks positions against a set
+	/// of circular and polygonal geofences and reports
+	/// entering, leaving and dwelling in a fence.
+	///
+	/// All positions passed to the service are also recorded
+	/// in a compact, delta-encoded track buffer of limited
+	/// capacity, from which a simplified track can be obtained.
+	///
+	/// The service implementation subscribes to the
+	/// positionUpdate event of a GNSSSensor, but positions can
+	/// also be fed by calling updatePosition().
+{
+public:
+	typedef Poco::AutoPtr<GeofenceServiceRemoteObject> Ptr;
+
+	GeofenceServiceRemoteObject(const Poco::RemotingNG::Identifiable::ObjectId& oid, Poco::SharedPtr<IoT::Geofence::GeofenceService> pServiceObject);
+		/// Creates a GeofenceServiceRemoteObject.
+
+	virtual ~GeofenceServiceRemoteObject();
+		/// Destroys the GeofenceServiceRemoteObject.
+
+	virtual void addFence(const IoT::Geofence::Fence& fence);
+		/// Adds the given fence, replacing an existing fence
+		/// with the same ID.
+		///
+		/// Throws a Poco::InvalidArgumentException if the fence
+		/// is neither a valid circle nor a valid polygon.
+
+	virtual void clearTrack();
+		/// Removes all points from the recorded track.
+
+	std::string encodedTrack(double tolerance = double(0.0)) const;
+		/// Returns the recorded track, simplified as for track(),
+		/// in the compact text format produced by TrackBuffer::encode().
+
+	IoT::Geofence::Fence fence(const std::string& id) const;
+		/// Returns the fence with the given ID.
+		///
+		/// Throws a Poco::NotFoundException if no such fence exists.
+
+	std::vector < std::string > fenceIds() const;
+		/// Returns the IDs of all fences.
+
+	std::vector < std::string > insideFences() const;
+		/// Returns the IDs of all fences containing the
+		/// most recent position.
+
+	virtual std::string remoting__enableEvents(Poco::RemotingNG::Listener::Ptr pListener, bool enable = bool(true));
+
+	virtual void remoting__enableRemoteEvents(const std::string& protocol);
+
+	virtual bool remoting__hasEvents() const;
+
+	virtual const Poco::RemotingNG::Identifiable::TypeId& remoting__typeId() const;
+
+	bool removeFence(const std::string& id);
+		/// Removes the fence with the given ID.
+		/// Returns true if the fence existed, otherwise false.
+		/// No GEOFENCE_EXIT transition is reported.
+
+	std::vector < IoT::Geofence::TrackPoint > track(double tolerance = double(0.0)) const;
+		/// Returns the recorded track, oldest point first.
+		///
+		/// If tolerance is > 0, the track is simplified with the
+		/// Douglas-Peucker algorithm, removing points that are closer
+		/// than tolerance meters to the simplified track.
+
+	int trackSize() const;
+		/// Returns the number of points in the recorded track.
+
+	std::vector < IoT::Geofence::GeofenceEvent > updatePosition(const IoT::Devices::LatLon& position, Poco::Int64 timestamp);
+		/// Evaluates the given position against all fences, records
+		/// it in the track and returns the resulting transitions, which
+		/// are also reported via the geofenceTransition event.
+
+protected:
+	void event__geofenceTransition(const IoT::Geofence::GeofenceEvent& data);
+
+private:
+	Poco::SharedPtr<IoT::Geofence::GeofenceService> _pServiceObject;
+};
+
+
+inline void GeofenceServiceRemoteObject::addFence(const IoT::Geofence::Fence& fence)
+{
+	_pServiceObject->addFence(fence);
+}
+
+
+inline void GeofenceServiceRemoteObject::clearTrack()
+{
+	_pServiceObject->clearTrack();
+}
+
+
+inline std::string GeofenceServiceRemoteObject::encodedTrack(double tolerance) const
+{
+	return _pServiceObject->encodedTrack(tolerance);
+}
+
+
+inline IoT::Geofence::Fence GeofenceServiceRemoteObject::fence(const std::string& id) const
+{
+	return _pServiceObject->fence(id);
+}
+
+
+inline std::vector < std::string > GeofenceServiceRemoteObject::fenceIds() const
+{
+	return _pServiceObject->fenceIds();
+}
+
+
+inline std::vector < std::string > GeofenceServiceRemoteObject::insideFences() const
+{
+	return _pServiceObject->insideFences();
+}
+
+
+inline const Poco::RemotingNG::Identifiable::TypeId& GeofenceServiceRemoteObject::remoting__typeId() const
+{
+	return IGeofenceService::remoting__typeId();
+}
+
+
+inline bool GeofenceServiceRemoteObject::removeFence(const std::string& id)
+{
+	return _pServiceObject->removeFence(id);
+}
+
+
+inline std::vector < IoT::Geofence::TrackPoint > GeofenceServiceRemoteObject::track(double tolerance) const
+{
+	return _pServiceObject->track(tolerance);
+}
+
+
+inline int GeofenceServiceRemoteObject::trackSize() const
+{
+	return _pServiceObject->trackSize();
+}
+
+
+inline std::vector < IoT::Geofence::GeofenceEvent > GeofenceServiceRemoteObject::updatePosition(const IoT::Devices::LatLon& position, Poco::Int64 timestamp)
+{
+	return _pServiceObject->updatePosition(position, timestamp);
+}
+
+
+} // namespace Geofence
+} // namespace IoT
+
+
+#endif // IoT_Geofence_GeofenceServiceRemoteObject_INCLUDED
+
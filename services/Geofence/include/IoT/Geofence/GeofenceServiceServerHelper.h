@@ -0,0 +1,129 @@
+//
+// GeofenceServiceServerHelper.h
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  GeofenceServiceServerHelper
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_GeofenceServiceServerHelper_INCLUDED
+#define IoT_Geofence_GeofenceServiceServerHelper_INCLUDED
+
+
+#include "IoT/Geofence/GeofenceService.h"
+#include "IoT/Geofence/GeofenceServiceRemoteObject.h"
+#include "IoT/Geofence/IGeofenceService.h"
+#include "Poco/RemotingNG/Identifiable.h"
+#include "Poco/RemotingNG/ORB.h"
+#include "Poco/RemotingNG/ServerHelper.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class GeofenceServiceServerHelper
+	/// The GeofenceService checks positions against a set
+	/// of circular and polygonal geofences and reports
+	/// entering, leaving and dwelling in a fence.
+	///
+	/// All positions passed to the service are also recorded
+	/// in a compact, delta-encoded track buffer of limited
+	/// capacity, from which a simplified track can be obtained.
+	///
+	/// The service implementation subscribes to the
+	/// positionUpdate event of a GNSSSensor, but positions can
+	/// also be fed by calling updatePosition().
+{
+public:
+	typedef IoT::Geofence::GeofenceService Service;
+
+	GeofenceServiceServerHelper();
+		/// Creates a GeofenceServiceServerHelper.
+
+	~GeofenceServiceServerHelper();
+		/// Destroys the GeofenceServiceServerHelper.
+
+	static Poco::AutoPtr<IoT::Geofence::GeofenceServiceRemoteObject> createRemoteObject(Poco::SharedPtr<IoT::Geofence::GeofenceService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid);
+		/// Creates and returns a RemoteObject wrapper for the given IoT::Geofence::GeofenceService instance.
+
+	static void enableEvents(const std::string& uri, const std::string& protocol);
+		/// Enables remote events for the RemoteObject identified by the given URI.
+		///
+		/// Events will be delivered using the Transport for the given protocol.
+		/// Can be called multiple times for the same URI with different protocols.
+
+	static std::string registerObject(Poco::SharedPtr<IoT::Geofence::GeofenceService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid, const std::string& listenerId);
+		/// Creates a RemoteObject wrapper for the given IoT::Geofence::GeofenceService instance
+		/// and registers it with the ORB and the Listener instance
+		/// uniquely identified by the Listener's ID.
+		/// 
+		///	Returns the URI created for the object.
+
+	static std::string registerRemoteObject(Poco::AutoPtr<IoT::Geofence::GeofenceServiceRemoteObject> pRemoteObject, const std::string& listenerId);
+		/// Registers the given RemoteObject with the ORB and the Listener instance
+		/// uniquely identified by the Listener's ID.
+		/// 
+		///	Returns the URI created for the object.
+
+	static void unregisterObject(const std::string& uri);
+		/// Unregisters a service object identified by URI from the ORB.
+
+private:
+	static Poco::AutoPtr<IoT::Geofence::GeofenceServiceRemoteObject> createRemoteObjectImpl(Poco::SharedPtr<IoT::Geofence::GeofenceService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid);
+
+	void enableEventsImpl(const std::string& uri, const std::string& protocol);
+
+	static GeofenceServiceServerHelper& instance();
+		/// Returns a static instance of the helper class.
+
+	std::string registerObjectImpl(Poco::AutoPtr<IoT::Geofence::GeofenceServiceRemoteObject> pRemoteObject, const std::string& listenerId);
+
+	void unregisterObjectImpl(const std::string& uri);
+
+	Poco::RemotingNG::ORB* _pORB;
+};
+
+
+inline Poco::AutoPtr<IoT::Geofence::GeofenceServiceRemoteObject> GeofenceServiceServerHelper::createRemoteObject(Poco::SharedPtr<IoT::Geofence::GeofenceService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid)
+{
+	return GeofenceServiceServerHelper::instance().createRemoteObjectImpl(pServiceObject, oid);
+}
+
+
+inline void GeofenceServiceServerHelper::enableEvents(const std::string& uri, const std::string& protocol)
+{
+	GeofenceServiceServerHelper::instance().enableEventsImpl(uri, protocol);
+}
+
+
+inline std::string GeofenceServiceServerHelper::registerObject(Poco::SharedPtr<IoT::Geofence::GeofenceService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid, const std::string& listenerId)
+{
+	return GeofenceServiceServerHelper::instance().registerObjectImpl(createRemoteObject(pServiceObject, oid), listenerId);
+}
+
+
+inline void GeofenceServiceServerHelper::unregisterObject(const std::string& uri)
+{
+	GeofenceServiceServerHelper::instance().unregisterObjectImpl(uri);
+}
+
+
+} // namespace Geofence
+} // namespace IoT
+
+
+REMOTING_SPECIALIZE_SERVER_HELPER(IoT::Geofence, GeofenceService)
+
+
+#endif // IoT_Geofence_GeofenceServiceServerHelper_INCLUDED
+
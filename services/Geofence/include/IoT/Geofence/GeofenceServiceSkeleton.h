@@ -0,0 +1,67 @@
+//
+// GeofenceServiceSkeleton.h
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  GeofenceServiceSkeleton
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_GeofenceServiceSkeleton_INCLUDED
+#define IoT_Geofence_GeofenceServiceSkeleton_INCLUDED
+
+
+#include "IoT/Geofence/GeofenceServiceRemoteObject.h"
+#include "Poco/RemotingNG/Skeleton.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class GeofenceServiceSkeleton: public Poco::RemotingNG::Skeleton
+	/// The GeofenceService checks positions against a set
+	/// of circular and polygonal geofences and reports
+	/// entering, leaving and dwelling in a fence.
+	///
+	/// All positions passed to the service are also recorded
+	/// in a compact, delta-encoded track buffer of limited
+	/// capacity, from which a simplified track can be obtained.
+	///
+	/// The service implementation subscribes to the
+	/// positionUpdate event of a GNSSSensor, but positions can
+	/// also be fed by calling updatePosition().
+{
+public:
+	GeofenceServiceSkeleton();
+		/// Creates a GeofenceServiceSkeleton.
+
+	virtual ~GeofenceServiceSkeleton();
+		/// Destroys a GeofenceServiceSkeleton.
+
+	virtual const Poco::RemotingNG::Identifiable::TypeId& remoting__typeId() const;
+
+	static const std::string DEFAULT_NS;
+};
+
+
+inline const Poco::RemotingNG::Identifiable::TypeId& GeofenceServiceSkeleton::remoting__typeId() const
+{
+	return IGeofenceService::remoting__typeId();
+}
+
+
+} // namespace Geofence
+} // namespace IoT
+
+
+#endif // IoT_Geofence_GeofenceServiceSkeleton_INCLUDED
+
@@ -0,0 +1,128 @@
+//
+// IGeofenceService.h
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  IGeofenceService
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_IGeofenceService_INCLUDED
+#define IoT_Geofence_IGeofenceService_INCLUDED
+
+
+#include "IoT/Geofence/GeofenceService.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/OSP/Service.h"
+#include "Poco/RemotingNG/Identifiable.h"
+#include "Poco/RemotingNG/Listener.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class IGeofenceService: public Poco::OSP::Service
+	/// The GeofenceService checks positions against a set
+	/// of circular and polygonal geofences and reports
+	/// entering, leaving and dwelling in a fence.
+	///
+	/// All positions passed to the service are also recorded
+	/// in a compact, delta-encoded track buffer of limited
+	/// capacity, from which a simplified track can be obtained.
+	///
+	/// The service implementation subscribes to the
+	/// positionUpdate event of a GNSSSensor, but positions can
+	/// also be fed by calling updatePosition().
+{
+public:
+	typedef Poco::AutoPtr<IGeofenceService> Ptr;
+
+	IGeofenceService();
+		/// Creates a IGeofenceService.
+
+	virtual ~IGeofenceService();
+		/// Destroys the IGeofenceService.
+
+	virtual void addFence(const IoT::Geofence::Fence& fence) = 0;
+		/// Adds the given fence, replacing an existing fence
+		/// with the same ID.
+		///
+		/// Throws a Poco::InvalidArgumentException if the fence
+		/// is neither a valid circle nor a valid polygon.
+
+	virtual void clearTrack() = 0;
+		/// Removes all points from the recorded track.
+
+	virtual std::string encodedTrack(double tolerance = double(0.0)) const = 0;
+		/// Returns the recorded track, simplified as for track(),
+		/// in the compact text format produced by TrackBuffer::encode().
+
+	virtual IoT::Geofence::Fence fence(const std::string& id) const = 0;
+		/// Returns the fence with the given ID.
+		///
+		/// Throws a Poco::NotFoundException if no such fence exists.
+
+	virtual std::vector < std::string > fenceIds() const = 0;
+		/// Returns the IDs of all fences.
+
+	virtual std::vector < std::string > insideFences() const = 0;
+		/// Returns the IDs of all fences containing the
+		/// most recent position.
+
+	bool isA(const std::type_info& otherType) const;
+		/// Returns true if the class is a subclass of the class given by otherType.
+
+	virtual std::string remoting__enableEvents(Poco::RemotingNG::Listener::Ptr pListener, bool enable = bool(true)) = 0;
+		/// Enable or disable delivery of remote events.
+		///
+		/// The given Listener instance must implement the Poco::RemotingNG::EventListener
+		/// interface, otherwise this method will fail with a RemotingException.
+		///
+		/// This method is only used with Proxy objects; calling this method on a
+		/// RemoteObject will do nothing.
+
+	static const Poco::RemotingNG::Identifiable::TypeId& remoting__typeId();
+		/// Returns the TypeId of the class.
+
+	virtual bool removeFence(const std::string& id) = 0;
+		/// Removes the fence with the given ID.
+		/// Returns true if the fence existed, otherwise false.
+		/// No GEOFENCE_EXIT transition is reported.
+
+	virtual std::vector < IoT::Geofence::TrackPoint > track(double tolerance = double(0.0)) const = 0;
+		/// Returns the recorded track, oldest point first.
+		///
+		/// If tolerance is > 0, the track is simplified with the
+		/// Douglas-Peucker algorithm, removing points that are closer
+		/// than tolerance meters to the simplified track.
+
+	virtual int trackSize() const = 0;
+		/// Returns the number of points in the recorded track.
+
+	const std::type_info& type() const;
+		/// Returns the type information for the object's class.
+
+	virtual std::vector < IoT::Geofence::GeofenceEvent > updatePosition(const IoT::Devices::LatLon& position, Poco::Int64 timestamp) = 0;
+		/// Evaluates the given position against all fences, records
+		/// it in the track and returns the resulting transitions, which
+		/// are also reported via the geofenceTransition event.
+
+	Poco::BasicEvent < const GeofenceEvent > geofenceTransition;
+};
+
+
+} // namespace Geofence
+} // namespace IoT
+
+
+#endif // IoT_Geofence_IGeofenceService_INCLUDED
+
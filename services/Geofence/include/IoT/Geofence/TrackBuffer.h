@@ -0,0 +1,162 @@
+//
+// TrackBuffer.h
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: Geofence
+// Module:  TrackBuffer
+//
+// Definition of the TrackBuffer class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_TrackBuffer_INCLUDED
+#define IoT_Geofence_TrackBuffer_INCLUDED
+
+
+#include "IoT/Geofence/Geofence.h"
+#include <vector>
+#include <deque>
+#include <string>
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class IoTGeofence_API TrackBuffer
+	/// TrackBuffer stores the most recent points of a track
+	/// in a compact, delta-encoded form.
+	///
+	/// Coordinates are quantized to 1e-6 degrees (about 0.1 m)
+	/// and timestamps to milliseconds. Points are stored in blocks
+	/// of up to POINTS_PER_BLOCK points. The first point of a block
+	/// is stored with absolute values, all following points as
+	/// differences to their predecessor. All values are written as
+	/// zig-zag encoded variable length integers, so that a point
+	/// recorded at 1 Hz while moving at road speeds typically takes
+	/// 5 to 7 bytes instead of 24.
+	///
+	/// When the capacity is exceeded, the oldest block is discarded
+	/// as a whole, so the buffer holds between capacity and
+	/// capacity + POINTS_PER_BLOCK - 1 points. points() returns only
+	/// the most recent capacity points.
+	///
+	/// TrackBuffer is not thread safe.
+{
+public:
+	struct Point
+	{
+		Point();
+		Point(double latitude, double longitude, Poco::Int64 timestamp);
+
+		double latitude;
+		double longitude;
+		Poco::Int64 timestamp;
+	};
+
+	typedef std::vector<Point> PointVec;
+
+	enum
+	{
+		POINTS_PER_BLOCK = 256
+	};
+
+	explicit TrackBuffer(std::size_t capacity);
+		/// Creates a TrackBuffer holding at least the given number of points.
+
+	~TrackBuffer();
+		/// Destroys the TrackBuffer.
+
+	void append(double latitude, double longitude, Poco::Int64 timestamp);
+		/// Appends a point to the track.
+
+	void points(PointVec& points) const;
+		/// Decodes the most recent capacity points, oldest first.
+
+	std::size_t size() const;
+		/// Returns the number of points returned by points().
+
+	std::size_t capacity() const;
+		/// Returns the capacity of the buffer.
+
+	std::size_t encodedSize() const;
+		/// Returns the number of bytes used by the encoded points.
+
+	void clear();
+		/// Removes all points.
+
+	static void simplify(const PointVec& points, double tolerance, PointVec& result);
+		/// Simplifies the given track using the Douglas-Peucker algorithm.
+		///
+		/// Points closer than tolerance meters to the simplified track
+		/// are removed. The first and last point are always kept.
+
+	static std::string encode(const PointVec& points);
+		/// Encodes the given points into a compact ASCII string suitable
+		/// for uploading, using the encoding of the Google Encoded
+		/// Polyline Algorithm Format.
+		///
+		/// Every point is encoded as a triple of latitude and longitude,
+		/// in units of 1e-5 degrees, and timestamp in milliseconds. The first
+		/// point is encoded with absolute values, all following points as
+		/// differences to their predecessor.
+
+	static void decode(const std::string& encoded, PointVec& points);
+		/// Decodes a string created by encode().
+		///
+		/// Throws a Poco::DataFormatException if the string is malformed.
+
+protected:
+	struct Block
+	{
+		Block();
+
+		std::vector<unsigned char> data;
+		std::size_t count;
+		Poco::Int32 lastLat;
+		Poco::Int32 lastLon;
+		Poco::Int64 lastTime;
+	};
+
+	typedef std::deque<Block> BlockDeque;
+
+	static void writeVarInt(std::vector<unsigned char>& data, Poco::Int64 value);
+	static Poco::Int64 readVarInt(const std::vector<unsigned char>& data, std::size_t& pos);
+
+private:
+	TrackBuffer();
+	TrackBuffer(const TrackBuffer&);
+	TrackBuffer& operator = (const TrackBuffer&);
+
+	std::size_t _capacity;
+	std::size_t _count;
+	BlockDeque _blocks;
+};
+
+
+//
+// inlines
+//
+inline std::size_t TrackBuffer::size() const
+{
+	return _count < _capacity ? _count : _capacity;
+}
+
+
+inline std::size_t TrackBuffer::capacity() const
+{
+	return _capacity;
+}
+
+
+} } // namespace IoT::Geofence
+
+
+#endif // IoT_Geofence_TrackBuffer_INCLUDED
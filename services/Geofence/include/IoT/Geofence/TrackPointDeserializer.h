@@ -0,0 +1,62 @@
+//
+// TrackPointDeserializer.h
+//
+// Package: Generated
+// Module:  TypeDeserializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeDeserializer_IoT_Geofence_TrackPoint_INCLUDED
+#define TypeDeserializer_IoT_Geofence_TrackPoint_INCLUDED
+
+
+#include "IoT/Devices/LatLonDeserializer.h"
+#include "IoT/Geofence/GeofenceService.h"
+#include "Poco/RemotingNG/TypeDeserializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeDeserializer<IoT::Geofence::TrackPoint>
+{
+public:
+	static bool deserialize(const std::string& name, bool isMandatory, Deserializer& deser, IoT::Geofence::TrackPoint& value)
+	{
+		bool ret = deser.deserializeStructBegin(name, isMandatory);
+		if (ret)
+		{
+			deserializeImpl(deser, value);
+			deser.deserializeStructEnd(name);
+		}
+		return ret;
+	}
+
+	static void deserializeImpl(Deserializer& deser, IoT::Geofence::TrackPoint& value)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"position","timestamp"};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeDeserializer<IoT::Devices::LatLon >::deserialize(REMOTING__NAMES[0], true, deser, value.position);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[1], true, deser, value.timestamp);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeDeserializer_IoT_Geofence_TrackPoint_INCLUDED
+
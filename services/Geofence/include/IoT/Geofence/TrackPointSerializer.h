@@ -0,0 +1,58 @@
+//
+// TrackPointSerializer.h
+//
+// Package: Generated
+// Module:  TypeSerializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeSerializer_IoT_Geofence_TrackPoint_INCLUDED
+#define TypeSerializer_IoT_Geofence_TrackPoint_INCLUDED
+
+
+#include "IoT/Devices/LatLonSerializer.h"
+#include "IoT/Geofence/GeofenceService.h"
+#include "Poco/RemotingNG/TypeSerializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeSerializer<IoT::Geofence::TrackPoint>
+{
+public:
+	static void serialize(const std::string& name, const IoT::Geofence::TrackPoint& value, Serializer& ser)
+	{
+		ser.serializeStructBegin(name);
+		serializeImpl(value, ser);
+		ser.serializeStructEnd(name);
+	}
+
+	static void serializeImpl(const IoT::Geofence::TrackPoint& value, Serializer& ser)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"position","timestamp",""};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeSerializer<IoT::Devices::LatLon >::serialize(REMOTING__NAMES[0], value.position, ser);
+		TypeSerializer<Poco::Int64 >::serialize(REMOTING__NAMES[1], value.timestamp, ser);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeSerializer_IoT_Geofence_TrackPoint_INCLUDED
+
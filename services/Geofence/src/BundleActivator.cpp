@@ -0,0 +1,74 @@
+//
+// BundleActivator.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "GeofenceServiceImpl.h"
+#include "IoT/Geofence/GeofenceServiceServerHelper.h"
+#include "Poco/OSP/BundleActivator.h"
+#include "Poco/OSP/BundleContext.h"
+#include "Poco/OSP/Bundle.h"
+#include "Poco/OSP/ServiceRegistry.h"
+#include "Poco/OSP/ServiceRef.h"
+#include "Poco/ClassLibrary.h"
+
+
+using Poco::OSP::BundleContext;
+using Poco::OSP::ServiceRegistry;
+using Poco::OSP::ServiceRef;
+using Poco::OSP::Properties;
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class BundleActivator: public Poco::OSP::BundleActivator
+{
+public:
+	BundleActivator()
+	{
+	}
+	
+	~BundleActivator()
+	{
+	}
+
+	void start(BundleContext::Ptr pContext)
+	{
+		typedef Poco::RemotingNG::ServerHelper<IoT::Geofence::GeofenceService> ServerHelper;
+
+		_pGeofenceService = new GeofenceServiceImpl(pContext);
+		_pGeofenceService->start();
+		std::string oid("io.macchina.services.geofence");
+		ServerHelper::RemoteObjectPtr pGeofenceServiceRemoteObject = ServerHelper::createRemoteObject(_pGeofenceService, oid);
+		_pServiceRef = pContext->registry().registerService(oid, pGeofenceServiceRemoteObject, Properties());
+	}
+		
+	void stop(BundleContext::Ptr pContext)
+	{
+		pContext->registry().unregisterService(_pServiceRef);
+		_pServiceRef = 0;
+		_pGeofenceService->stop();
+		_pGeofenceService = 0;
+	}
+
+private:
+	Poco::SharedPtr<GeofenceServiceImpl> _pGeofenceService;
+	Poco::OSP::ServiceRef::Ptr _pServiceRef;
+};
+
+
+} } // namespace IoT::Geofence
+
+
+POCO_BEGIN_MANIFEST(Poco::OSP::BundleActivator)
+	POCO_EXPORT_CLASS(IoT::Geofence::BundleActivator)
+POCO_END_MANIFEST
@@ -0,0 +1,427 @@
+//
+// FenceIndex.cpp
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: Geofence
+// Module:  FenceIndex
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Geofence/FenceIndex.h"
+#include <cmath>
+
+
+namespace IoT {
+namespace Geofence {
+
+
+//
+// FenceIndex::Box
+//
+
+
+FenceIndex::Box::Box():
+	minLat(0.0),
+	minLon(0.0),
+	maxLat(0.0),
+	maxLon(0.0)
+{
+}
+
+
+FenceIndex::Box::Box(double minLat_, double minLon_, double maxLat_, double maxLon_):
+	minLat(minLat_),
+	minLon(minLon_),
+	maxLat(maxLat_),
+	maxLon(maxLon_)
+{
+}
+
+
+void FenceIndex::Box::extend(const Box& other)
+{
+	if (other.minLat < minLat) minLat = other.minLat;
+	if (other.minLon < minLon) minLon = other.minLon;
+	if (other.maxLat > maxLat) maxLat = other.maxLat;
+	if (other.maxLon > maxLon) maxLon = other.maxLon;
+}
+
+
+//
+// FenceIndex::Entry
+//
+
+
+FenceIndex::Entry::Entry():
+	pChild(0)
+{
+}
+
+
+FenceIndex::Entry::Entry(const Box& box_, Node* pChild_):
+	box(box_),
+	pChild(pChild_)
+{
+}
+
+
+FenceIndex::Entry::Entry(const Box& box_, const std::string& id_):
+	box(box_),
+	pChild(0),
+	id(id_)
+{
+}
+
+
+//
+// FenceIndex
+//
+
+
+FenceIndex::FenceIndex():
+	_pRoot(new Node),
+	_height(1),
+	_size(0)
+{
+}
+
+
+FenceIndex::~FenceIndex()
+{
+	destroy(_pRoot);
+}
+
+
+void FenceIndex::insert(const std::string& id, const Box& box)
+{
+	insertEntry(Entry(box, id), 0);
+	_size++;
+}
+
+
+bool FenceIndex::remove(const std::string& id, const Box& box)
+{
+	OrphanVec orphans;
+	if (!removeImpl(_pRoot, _height - 1, id, box, orphans)) return false;
+	_size--;
+
+	if (_height > 1 && _pRoot->entries.empty())
+	{
+		delete _pRoot;
+		_pRoot = new Node;
+		_height = 1;
+	}
+	for (OrphanVec::const_iterator it = orphans.begin(); it != orphans.end(); ++it)
+	{
+		reinsert(it->entry, it->level);
+	}
+	while (_height > 1 && _pRoot->entries.size() == 1)
+	{
+		Node* pOldRoot = _pRoot;
+		_pRoot = pOldRoot->entries[0].pChild;
+		delete pOldRoot;
+		_height--;
+	}
+	return true;
+}
+
+
+void FenceIndex::find(double lat, double lon, std::vector<std::string>& ids) const
+{
+	findImpl(_pRoot, lat, lon, ids);
+}
+
+
+void FenceIndex::find(const Box& box, std::vector<std::string>& ids) const
+{
+	findImpl(_pRoot, box, ids);
+}
+
+
+void FenceIndex::clear()
+{
+	destroy(_pRoot);
+	_pRoot = new Node;
+	_height = 1;
+	_size = 0;
+}
+
+
+FenceIndex::Node* FenceIndex::insertImpl(Node* pNode, int nodeLevel, const Entry& entry, int level)
+{
+	if (nodeLevel == level)
+	{
+		pNode->entries.push_back(entry);
+	}
+	else
+	{
+		// choose the subtree needing the least enlargement,
+		// resolving ties by choosing the smallest one
+		std::size_t best = 0;
+		double bestEnlargement = 0;
+		double bestArea = 0;
+		for (std::size_t i = 0; i < pNode->entries.size(); i++)
+		{
+			Box extended = pNode->entries[i].box;
+			extended.extend(entry.box);
+			double area = pNode->entries[i].box.area();
+			double enlargement = extended.area() - area;
+			if (i == 0 || enlargement < bestEnlargement || (enlargement == bestEnlargement && area < bestArea))
+			{
+				best = i;
+				bestEnlargement = enlargement;
+				bestArea = area;
+			}
+		}
+		Node* pChild = pNode->entries[best].pChild;
+		Node* pSplit = insertImpl(pChild, nodeLevel - 1, entry, level);
+		pNode->entries[best].box = bounds(pChild);
+		if (pSplit)
+		{
+			pNode->entries.push_back(Entry(bounds(pSplit), pSplit));
+		}
+	}
+	if (pNode->entries.size() > MAX_ENTRIES)
+		return split(pNode);
+	else
+		return 0;
+}
+
+
+bool FenceIndex::removeImpl(Node* pNode, int nodeLevel, const std::string& id, const Box& box, OrphanVec& orphans)
+{
+	for (EntryVec::iterator it = pNode->entries.begin(); it != pNode->entries.end(); ++it)
+	{
+		if (nodeLevel == 0)
+		{
+			if (it->id == id && it->box.minLat == box.minLat && it->box.minLon == box.minLon && it->box.maxLat == box.maxLat && it->box.maxLon == box.maxLon)
+			{
+				pNode->entries.erase(it);
+				return true;
+			}
+		}
+		else if (it->box.intersects(box) && removeImpl(it->pChild, nodeLevel - 1, id, box, orphans))
+		{
+			Node* pChild = it->pChild;
+			if (pChild->entries.size() < MIN_ENTRIES)
+			{
+				// dissolve the underfull child and reinsert its entries later
+				for (EntryVec::const_iterator itChild = pChild->entries.begin(); itChild != pChild->entries.end(); ++itChild)
+				{
+					Orphan orphan;
+					orphan.entry = *itChild;
+					orphan.level = nodeLevel - 1;
+					orphans.push_back(orphan);
+				}
+				delete pChild;
+				pNode->entries.erase(it);
+			}
+			else
+			{
+				it->box = bounds(pChild);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void FenceIndex::findImpl(const Node* pNode, double lat, double lon, std::vector<std::string>& ids) const
+{
+	for (EntryVec::const_iterator it = pNode->entries.begin(); it != pNode->entries.end(); ++it)
+	{
+		if (it->box.contains(lat, lon))
+		{
+			if (it->pChild)
+				findImpl(it->pChild, lat, lon, ids);
+			else
+				ids.push_back(it->id);
+		}
+	}
+}
+
+
+void FenceIndex::findImpl(const Node* pNode, const Box& box, std::vector<std::string>& ids) const
+{
+	for (EntryVec::const_iterator it = pNode->entries.begin(); it != pNode->entries.end(); ++it)
+	{
+		if (it->box.intersects(box))
+		{
+			if (it->pChild)
+				findImpl(it->pChild, box, ids);
+			else
+				ids.push_back(it->id);
+		}
+	}
+}
+
+
+FenceIndex::Node* FenceIndex::split(Node* pNode)
+{
+	EntryVec entries;
+	entries.swap(pNode->entries);
+	const std::size_t n = entries.size();
+
+	// pick the two entries that would waste the most area if put together
+	std::size_t seed1 = 0;
+	std::size_t seed2 = 1;
+	double worstWaste = -1;
+	for (std::size_t i = 0; i < n; i++)
+	{
+		for (std::size_t j = i + 1; j < n; j++)
+		{
+			Box combined = entries[i].box;
+			combined.extend(entries[j].box);
+			double waste = combined.area() - entries[i].box.area() - entries[j].box.area();
+			if (waste > worstWaste)
+			{
+				worstWaste = waste;
+				seed1 = i;
+				seed2 = j;
+			}
+		}
+	}
+
+	Node* pNew = new Node;
+	Box box1 = entries[seed1].box;
+	Box box2 = entries[seed2].box;
+	pNode->entries.push_back(entries[seed1]);
+	pNew->entries.push_back(entries[seed2]);
+	std::vector<bool> assigned(n, false);
+	assigned[seed1] = true;
+	assigned[seed2] = true;
+	std::size_t remaining = n - 2;
+
+	while (remaining > 0)
+	{
+		Node* pFill = 0;
+		if (pNode->entries.size() + remaining <= MIN_ENTRIES)
+			pFill = pNode;
+		else if (pNew->entries.size() + remaining <= MIN_ENTRIES)
+			pFill = pNew;
+		if (pFill)
+		{
+			for (std::size_t i = 0; i < n; i++)
+			{
+				if (!assigned[i]) pFill->entries.push_back(entries[i]);
+			}
+			break;
+		}
+
+		// pick the entry with the strongest preference for one group
+		std::size_t next = 0;
+		double maxDiff = -1;
+		double nextEnl1 = 0;
+		double nextEnl2 = 0;
+		for (std::size_t i = 0; i < n; i++)
+		{
+			if (assigned[i]) continue;
+			Box ext1 = box1;
+			ext1.extend(entries[i].box);
+			Box ext2 = box2;
+			ext2.extend(entries[i].box);
+			double enl1 = ext1.area() - box1.area();
+			double enl2 = ext2.area() - box2.area();
+			double diff = std::fabs(enl1 - enl2);
+			if (diff > maxDiff)
+			{
+				maxDiff = diff;
+				next = i;
+				nextEnl1 = enl1;
+				nextEnl2 = enl2;
+			}
+		}
+
+		bool toFirst;
+		if (nextEnl1 != nextEnl2)
+			toFirst = nextEnl1 < nextEnl2;
+		else if (box1.area() != box2.area())
+			toFirst = box1.area() < box2.area();
+		else
+			toFirst = pNode->entries.size() <= pNew->entries.size();
+
+		if (toFirst)
+		{
+			pNode->entries.push_back(entries[next]);
+			box1.extend(entries[next].box);
+		}
+		else
+		{
+			pNew->entries.push_back(entries[next]);
+			box2.extend(entries[next].box);
+		}
+		assigned[next] = true;
+		remaining--;
+	}
+	return pNew;
+}
+
+
+void FenceIndex::insertEntry(const Entry& entry, int level)
+{
+	Node* pSplit = insertImpl(_pRoot, _height - 1, entry, level);
+	if (pSplit)
+	{
+		Node* pNewRoot = new Node;
+		pNewRoot->entries.push_back(Entry(bounds(_pRoot), _pRoot));
+		pNewRoot->entries.push_back(Entry(bounds(pSplit), pSplit));
+		_pRoot = pNewRoot;
+		_height++;
+	}
+}
+
+
+void FenceIndex::reinsert(const Entry& entry, int level)
+{
+	if (level <= _height - 1)
+	{
+		insertEntry(entry, level);
+	}
+	else
+	{
+		// the tree has become too low to take the subtree as a whole
+		for (EntryVec::const_iterator it = entry.pChild->entries.begin(); it != entry.pChild->entries.end(); ++it)
+		{
+			reinsert(*it, level - 1);
+		}
+		delete entry.pChild;
+	}
+}
+
+
+FenceIndex::Box FenceIndex::bounds(const Node* pNode)
+{
+	Box box;
+	EntryVec::const_iterator it = pNode->entries.begin();
+	if (it != pNode->entries.end())
+	{
+		box = it->box;
+		++it;
+	}
+	for (; it != pNode->entries.end(); ++it)
+	{
+		box.extend(it->box);
+	}
+	return box;
+}
+
+
+void FenceIndex::destroy(Node* pNode)
+{
+	for (EntryVec::iterator it = pNode->entries.begin(); it != pNode->entries.end(); ++it)
+	{
+		if (it->pChild) destroy(it->pChild);
+	}
+	delete pNode;
+}
+
+
+} } // namespace IoT::Geofence
@@ -0,0 +1,323 @@
+//
+// GeofenceEngine.cpp
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: Geofence
+// Module:  GeofenceEngine
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Geofence/GeofenceEngine.h"
+#include "Poco/Geo/LatLon.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace IoT {
+namespace Geofence {
+
+
+namespace
+{
+	const double PI = 3.14159265358979323846;
+}
+
+
+//
+// GeofenceEngine::CompiledFence
+//
+
+
+GeofenceEngine::CompiledFence::CompiledFence():
+	shifted(false)
+{
+}
+
+
+bool GeofenceEngine::CompiledFence::contains(double lat, double lon) const
+{
+	if (fence.radius > 0)
+	{
+		Poco::Geo::LatLon center = Poco::Geo::LatLon::fromDegrees(fence.center.latitude, fence.center.longitude);
+		Poco::Geo::LatLon pos = Poco::Geo::LatLon::fromDegrees(lat, lon);
+		return center.greatCircleDistanceTo(pos).radians()*Poco::Geo::LatLon::EARTH_MEAN_RADIUS <= fence.radius;
+	}
+	else
+	{
+		if (shifted && lon < 0) lon += 360;
+		bool inside = false;
+		const std::size_t n = lats.size();
+		for (std::size_t i = 0, j = n - 1; i < n; j = i++)
+		{
+			if ((lats[i] > lat) != (lats[j] > lat) && lon < (lons[j] - lons[i])*(lat - lats[i])/(lats[j] - lats[i]) + lons[i])
+			{
+				inside = !inside;
+			}
+		}
+		return inside;
+	}
+}
+
+
+//
+// GeofenceEngine
+//
+
+
+GeofenceEngine::GeofenceEngine()
+{
+}
+
+
+GeofenceEngine::~GeofenceEngine()
+{
+}
+
+
+void GeofenceEngine::add(const Fence& fence)
+{
+	CompiledFencePtr pCompiled = compile(fence);
+	FenceMap::iterator it = _fences.find(fence.id);
+	if (it != _fences.end())
+	{
+		unindex(*it->second);
+		it->second = pCompiled;
+	}
+	else
+	{
+		_fences[fence.id] = pCompiled;
+	}
+	for (std::vector<FenceIndex::Box>::const_iterator itBox = pCompiled->boxes.begin(); itBox != pCompiled->boxes.end(); ++itBox)
+	{
+		_index.insert(fence.id, *itBox);
+	}
+}
+
+
+bool GeofenceEngine::remove(const std::string& id)
+{
+	FenceMap::iterator it = _fences.find(id);
+	if (it != _fences.end())
+	{
+		unindex(*it->second);
+		_fences.erase(it);
+		_inside.erase(id);
+		return true;
+	}
+	return false;
+}
+
+
+void GeofenceEngine::clear()
+{
+	_fences.clear();
+	_inside.clear();
+	_index.clear();
+}
+
+
+bool GeofenceEngine::has(const std::string& id) const
+{
+	return _fences.find(id) != _fences.end();
+}
+
+
+const Fence& GeofenceEngine::get(const std::string& id) const
+{
+	FenceMap::const_iterator it = _fences.find(id);
+	if (it != _fences.end())
+		return it->second->fence;
+	else
+		throw Poco::NotFoundException("fence", id);
+}
+
+
+void GeofenceEngine::ids(std::vector<std::string>& ids) const
+{
+	ids.clear();
+	ids.reserve(_fences.size());
+	for (FenceMap::const_iterator it = _fences.begin(); it != _fences.end(); ++it)
+	{
+		ids.push_back(it->first);
+	}
+}
+
+
+void GeofenceEngine::inside(std::vector<std::string>& ids) const
+{
+	ids.clear();
+	for (PresenceMap::const_iterator it = _inside.begin(); it != _inside.end(); ++it)
+	{
+		ids.push_back(it->first);
+	}
+}
+
+
+void GeofenceEngine::update(const IoT::Devices::LatLon& position, Poco::Int64 timestamp, std::vector<GeofenceEvent>& events)
+{
+	_candidates.clear();
+	_index.find(position.latitude, position.longitude, _candidates);
+	std::sort(_candidates.begin(), _candidates.end());
+	_candidates.erase(std::unique(_candidates.begin(), _candidates.end()), _candidates.end());
+
+	std::vector<std::string>::iterator itEnd = _candidates.begin();
+	for (std::vector<std::string>::iterator it = _candidates.begin(); it != _candidates.end(); ++it)
+	{
+		FenceMap::const_iterator itFence = _fences.find(*it);
+		if (itFence != _fences.end() && itFence->second->contains(position.latitude, position.longitude))
+		{
+			if (itEnd != it) itEnd->swap(*it);
+			++itEnd;
+		}
+	}
+	_candidates.erase(itEnd, _candidates.end());
+
+	GeofenceEvent event;
+	event.position = position;
+	event.timestamp = timestamp;
+
+	PresenceMap::iterator itPresence = _inside.begin();
+	while (itPresence != _inside.end())
+	{
+		if (!std::binary_search(_candidates.begin(), _candidates.end(), itPresence->first))
+		{
+			event.fenceId = itPresence->first;
+			event.transition = GEOFENCE_EXIT;
+			events.push_back(event);
+			_inside.erase(itPresence++);
+		}
+		else ++itPresence;
+	}
+
+	for (std::vector<std::string>::const_iterator it = _candidates.begin(); it != _candidates.end(); ++it)
+	{
+		itPresence = _inside.find(*it);
+		if (itPresence == _inside.end())
+		{
+			Presence presence;
+			presence.enterTime = timestamp;
+			presence.dwellReported = false;
+			_inside[*it] = presence;
+			event.fenceId = *it;
+			event.transition = GEOFENCE_ENTER;
+			events.push_back(event);
+		}
+		else if (!itPresence->second.dwellReported)
+		{
+			int dwellTime = _fences[*it]->fence.dwellTime;
+			if (dwellTime > 0 && timestamp - itPresence->second.enterTime >= dwellTime)
+			{
+				itPresence->second.dwellReported = true;
+				event.fenceId = *it;
+				event.transition = GEOFENCE_DWELL;
+				events.push_back(event);
+			}
+		}
+	}
+}
+
+
+GeofenceEngine::CompiledFencePtr GeofenceEngine::compile(const Fence& fence)
+{
+	if (fence.id.empty()) throw Poco::InvalidArgumentException("fence ID must not be empty");
+
+	CompiledFencePtr pCompiled = new CompiledFence;
+	pCompiled->fence = fence;
+	if (fence.radius > 0)
+	{
+		if (!fence.polygon.empty()) throw Poco::InvalidArgumentException("fence must either be a circle or a polygon", fence.id);
+		double lat = fence.center.latitude;
+		double lon = fence.center.longitude;
+		if (lat < -90 || lat > 90 || lon < -180 || lon > 180) throw Poco::InvalidArgumentException("invalid fence center", fence.id);
+
+		double dLat = fence.radius/Poco::Geo::LatLon::EARTH_MEAN_RADIUS*180/PI;
+		double minLat = lat - dLat;
+		double maxLat = lat + dLat;
+		if (minLat <= -90 || maxLat >= 90)
+		{
+			addBoxes(std::max(minLat, -90.0), -180, std::min(maxLat, 90.0), 180, pCompiled->boxes);
+		}
+		else
+		{
+			double dLon = dLat/std::cos(lat*PI/180);
+			if (dLon >= 180)
+				addBoxes(minLat, -180, maxLat, 180, pCompiled->boxes);
+			else
+				addBoxes(minLat, lon - dLon, maxLat, lon + dLon, pCompiled->boxes);
+		}
+	}
+	else
+	{
+		if (fence.radius < 0) throw Poco::InvalidArgumentException("fence radius must not be negative", fence.id);
+		if (fence.polygon.size() < 3) throw Poco::InvalidArgumentException("polygon fence must have at least 3 vertices", fence.id);
+
+		double minLon = 180;
+		double maxLon = -180;
+		for (std::vector<IoT::Devices::LatLon>::const_iterator it = fence.polygon.begin(); it != fence.polygon.end(); ++it)
+		{
+			if (it->latitude < -90 || it->latitude > 90 || it->longitude < -180 || it->longitude > 180) throw Poco::InvalidArgumentException("invalid polygon vertex", fence.id);
+			minLon = std::min(minLon, it->longitude);
+			maxLon = std::max(maxLon, it->longitude);
+		}
+		pCompiled->shifted = maxLon - minLon > 180;
+
+		double minLat = 90;
+		double maxLat = -90;
+		minLon = 360;
+		maxLon = -180;
+		pCompiled->lats.reserve(fence.polygon.size());
+		pCompiled->lons.reserve(fence.polygon.size());
+		for (std::vector<IoT::Devices::LatLon>::const_iterator it = fence.polygon.begin(); it != fence.polygon.end(); ++it)
+		{
+			double lon = it->longitude;
+			if (pCompiled->shifted && lon < 0) lon += 360;
+			pCompiled->lats.push_back(it->latitude);
+			pCompiled->lons.push_back(lon);
+			minLat = std::min(minLat, it->latitude);
+			maxLat = std::max(maxLat, it->latitude);
+			minLon = std::min(minLon, lon);
+			maxLon = std::max(maxLon, lon);
+		}
+		addBoxes(minLat, minLon, maxLat, maxLon, pCompiled->boxes);
+	}
+	return pCompiled;
+}
+
+
+void GeofenceEngine::addBoxes(double minLat, double minLon, double maxLat, double maxLon, std::vector<FenceIndex::Box>& boxes)
+{
+	if (minLon < -180)
+	{
+		boxes.push_back(FenceIndex::Box(minLat, minLon + 360, maxLat, 180));
+		boxes.push_back(FenceIndex::Box(minLat, -180, maxLat, maxLon));
+	}
+	else if (maxLon > 180)
+	{
+		boxes.push_back(FenceIndex::Box(minLat, minLon, maxLat, 180));
+		boxes.push_back(FenceIndex::Box(minLat, -180, maxLat, maxLon - 360));
+	}
+	else
+	{
+		boxes.push_back(FenceIndex::Box(minLat, minLon, maxLat, maxLon));
+	}
+}
+
+
+void GeofenceEngine::unindex(const CompiledFence& compiledFence)
+{
+	for (std::vector<FenceIndex::Box>::const_iterator it = compiledFence.boxes.begin(); it != compiledFence.boxes.end(); ++it)
+	{
+		_index.remove(compiledFence.fence.id, *it);
+	}
+}
+
+
+} } // namespace IoT::Geofence
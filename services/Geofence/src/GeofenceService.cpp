@@ -0,0 +1,34 @@
+//
+// GeofenceService.cpp
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: GeofenceService
+// Module:  GeofenceService
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Geofence/GeofenceService.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+GeofenceService::GeofenceService()
+{
+}
+
+	
+GeofenceService::~GeofenceService()
+{
+}
+
+
+} } // namespace IoT::Geofence
@@ -0,0 +1,109 @@
+//
+// GeofenceServiceEventDispatcher.cpp
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  GeofenceServiceEventDispatcher
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Geofence/GeofenceServiceEventDispatcher.h"
+#include "IoT/Devices/LatLonDeserializer.h"
+#include "IoT/Devices/LatLonSerializer.h"
+#include "IoT/Geofence/GeofenceEventDeserializer.h"
+#include "IoT/Geofence/GeofenceEventSerializer.h"
+#include "Poco/Delegate.h"
+#include "Poco/RemotingNG/Deserializer.h"
+#include "Poco/RemotingNG/RemotingException.h"
+#include "Poco/RemotingNG/Serializer.h"
+#include "Poco/RemotingNG/TypeDeserializer.h"
+#include "Poco/RemotingNG/TypeSerializer.h"
+#include "Poco/RemotingNG/URIUtility.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+GeofenceServiceEventDispatcher::GeofenceServiceEventDispatcher(GeofenceServiceRemoteObject* pRemoteObject, const std::string& protocol):
+	Poco::RemotingNG::EventDispatcher(protocol),
+	_pRemoteObject(pRemoteObject)
+{
+	_pRemoteObject->geofenceTransition += Poco::delegate(this, &GeofenceServiceEventDispatcher::event__geofenceTransition);
+}
+
+
+GeofenceServiceEventDispatcher::~GeofenceServiceEventDispatcher()
+{
+	try
+	{
+		_pRemoteObject->geofenceTransition -= Poco::delegate(this, &GeofenceServiceEventDispatcher::event__geofenceTransition);
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void GeofenceServiceEventDispatcher::event__geofenceTransition(const void* pSender, const IoT::Geofence::GeofenceEvent& data)
+{
+	if (pSender)
+	{
+		Poco::Timestamp now;
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		SubscriberMap::iterator it = _subscribers.begin();
+		while (it != _subscribers.end())
+		{
+			if (it->second->expireTime != 0 && it->second->expireTime < now)
+			{
+				SubscriberMap::iterator itDel(it++);
+				_subscribers.erase(itDel);
+			}
+			else
+			{
+				try
+				{
+					event__geofenceTransitionImpl(it->first, data);
+				}
+				catch (Poco::RemotingNG::RemoteException&)
+				{
+					throw;
+				}
+				catch (Poco::Exception&)
+				{
+				}
+				++it;
+			}
+		}
+	}
+}
+
+
+void GeofenceServiceEventDispatcher::event__geofenceTransitionImpl(const std::string& subscriberURI, const IoT::Geofence::GeofenceEvent& data)
+{
+	remoting__staticInitBegin(REMOTING__NAMES);
+	static const std::string REMOTING__NAMES[] = {"geofenceTransition","subscriberURI","data"};
+	remoting__staticInitEnd(REMOTING__NAMES);
+	Poco::RemotingNG::Transport& remoting__trans = transportForSubscriber(subscriberURI);
+	Poco::ScopedLock<Poco::RemotingNG::Transport> remoting__lock(remoting__trans);
+	Poco::RemotingNG::Serializer& remoting__ser = remoting__trans.beginMessage(_pRemoteObject->remoting__objectId(), _pRemoteObject->remoting__typeId(), REMOTING__NAMES[0], Poco::RemotingNG::SerializerBase::MESSAGE_EVENT);
+	remoting__ser.serializeMessageBegin(REMOTING__NAMES[0], Poco::RemotingNG::SerializerBase::MESSAGE_EVENT);
+	Poco::RemotingNG::TypeSerializer<IoT::Geofence::GeofenceEvent >::serialize(REMOTING__NAMES[2], data, remoting__ser);
+	remoting__ser.serializeMessageEnd(REMOTING__NAMES[0], Poco::RemotingNG::SerializerBase::MESSAGE_EVENT);
+	remoting__trans.sendMessage(_pRemoteObject->remoting__objectId(), _pRemoteObject->remoting__typeId(), REMOTING__NAMES[0], Poco::RemotingNG::SerializerBase::MESSAGE_EVENT);
+}
+
+
+const std::string GeofenceServiceEventDispatcher::DEFAULT_NS("");
+} // namespace Geofence
+} // namespace IoT
+
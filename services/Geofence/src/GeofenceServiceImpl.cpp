@@ -0,0 +1,326 @@
+//
+// GeofenceServiceImpl.cpp
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: GeofenceServiceImpl
+// Module:  GeofenceServiceImpl
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "GeofenceServiceImpl.h"
+#include "Poco/OSP/ServiceRegistry.h"
+#include "Poco/OSP/ServiceFinder.h"
+#include "Poco/OSP/PreferencesService.h"
+#include "Poco/Util/AbstractConfiguration.h"
+#include "Poco/JSON/Parser.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/JSON/Array.h"
+#include "Poco/FileStream.h"
+#include "Poco/Delegate.h"
+#include "Poco/Exception.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+namespace
+{
+	IoT::Devices::LatLon latLonFromJSON(Poco::JSON::Object::Ptr pObject)
+	{
+		IoT::Devices::LatLon latLon;
+		latLon.latitude = pObject->getValue<double>("latitude");
+		latLon.longitude = pObject->getValue<double>("longitude");
+		return latLon;
+	}
+}
+
+
+GeofenceServiceImpl::GeofenceServiceImpl(Poco::OSP::BundleContext::Ptr pContext):
+	_pContext(pContext),
+	_logger(Poco::Logger::get("IoT.Geofence"))
+{
+	Poco::OSP::PreferencesService::Ptr pPrefs = Poco::OSP::ServiceFinder::find<Poco::OSP::PreferencesService>(pContext);
+	Poco::AutoPtr<Poco::Util::AbstractConfiguration> pConfig = pPrefs->configuration();
+
+	_gnssName = pConfig->getString("geofence.gnss", "io.macchina.gnss.nmea#0");
+	std::size_t capacity = pConfig->getUInt("geofence.track.capacity", DEFAULT_TRACK_CAPACITY);
+	_pTrack = new TrackBuffer(capacity > 0 ? capacity : DEFAULT_TRACK_CAPACITY);
+
+	std::string fencesPath = pConfig->getString("geofence.fences", "");
+	if (!fencesPath.empty())
+	{
+		try
+		{
+			loadFences(fencesPath);
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.error("Cannot load fences from %s: %s", fencesPath, exc.displayText());
+		}
+	}
+}
+
+
+GeofenceServiceImpl::~GeofenceServiceImpl()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void GeofenceServiceImpl::start()
+{
+	Poco::OSP::ServiceRef::ConstPtr pServiceRef = _pContext->registry().findByName(_gnssName);
+	if (pServiceRef)
+	{
+		try
+		{
+			attach(pServiceRef->instance());
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.error("Cannot track position: %s", exc.displayText());
+		}
+	}
+	_pContext->registry().serviceRegistered   += Poco::delegate(this, &GeofenceServiceImpl::onServiceRegistered);
+	_pContext->registry().serviceUnregistered += Poco::delegate(this, &GeofenceServiceImpl::onServiceUnregistered);
+}
+
+
+void GeofenceServiceImpl::stop()
+{
+	_pContext->registry().serviceRegistered   -= Poco::delegate(this, &GeofenceServiceImpl::onServiceRegistered);
+	_pContext->registry().serviceUnregistered -= Poco::delegate(this, &GeofenceServiceImpl::onServiceUnregistered);
+	detach();
+}
+
+
+void GeofenceServiceImpl::loadFences(const std::string& path)
+{
+	Poco::FileInputStream istr(path);
+	Poco::JSON::Parser parser;
+	Poco::JSON::Array::Ptr pFences = parser.parse(istr).extract<Poco::JSON::Array::Ptr>();
+	for (unsigned i = 0; i < pFences->size(); i++)
+	{
+		Poco::JSON::Object::Ptr pFence = pFences->getObject(i);
+		if (!pFence) throw Poco::DataFormatException("fence must be an object");
+
+		Fence fence;
+		fence.id = pFence->getValue<std::string>("id");
+		if (pFence->has("center"))
+		{
+			fence.center = latLonFromJSON(pFence->getObject("center"));
+		}
+		if (pFence->has("radius"))
+		{
+			fence.radius = pFence->getValue<double>("radius");
+		}
+		if (pFence->has("polygon"))
+		{
+			Poco::JSON::Array::Ptr pPolygon = pFence->getArray("polygon");
+			for (unsigned k = 0; k < pPolygon->size(); k++)
+			{
+				fence.polygon.push_back(latLonFromJSON(pPolygon->getObject(k)));
+			}
+		}
+		if (pFence->has("dwellTime"))
+		{
+			fence.dwellTime = pFence->getValue<int>("dwellTime");
+		}
+		addFence(fence);
+	}
+	_logger.information("Loaded %z fences from %s.", pFences->size(), path);
+}
+
+
+void GeofenceServiceImpl::addFence(const Fence& fence)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_engine.add(fence);
+}
+
+
+bool GeofenceServiceImpl::removeFence(const std::string& id)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _engine.remove(id);
+}
+
+
+std::vector<std::string> GeofenceServiceImpl::fenceIds() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	std::vector<std::string> ids;
+	_engine.ids(ids);
+	return ids;
+}
+
+
+Fence GeofenceServiceImpl::fence(const std::string& id) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _engine.get(id);
+}
+
+
+std::vector<std::string> GeofenceServiceImpl::insideFences() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	std::vector<std::string> ids;
+	_engine.inside(ids);
+	return ids;
+}
+
+
+std::vector<GeofenceEvent> GeofenceServiceImpl::updatePosition(const IoT::Devices::LatLon& position, Poco::Int64 timestamp)
+{
+	std::vector<GeofenceEvent> events;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_engine.update(position, timestamp, events);
+		_pTrack->append(position.latitude, position.longitude, timestamp);
+	}
+	for (std::vector<GeofenceEvent>::const_iterator it = events.begin(); it != events.end(); ++it)
+	{
+		geofenceTransition(this, *it);
+	}
+	return events;
+}
+
+
+std::vector<TrackPoint> GeofenceServiceImpl::track(double tolerance) const
+{
+	TrackBuffer::PointVec points;
+	simplifiedTrack(tolerance, points);
+	std::vector<TrackPoint> result;
+	result.reserve(points.size());
+	for (TrackBuffer::PointVec::const_iterator it = points.begin(); it != points.end(); ++it)
+	{
+		TrackPoint point;
+		point.position.latitude = it->latitude;
+		point.position.longitude = it->longitude;
+		point.timestamp = it->timestamp;
+		result.push_back(point);
+	}
+	return result;
+}
+
+
+std::string GeofenceServiceImpl::encodedTrack(double tolerance) const
+{
+	TrackBuffer::PointVec points;
+	simplifiedTrack(tolerance, points);
+	return TrackBuffer::encode(points);
+}
+
+
+int GeofenceServiceImpl::trackSize() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return static_cast<int>(_pTrack->size());
+}
+
+
+void GeofenceServiceImpl::clearTrack()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_pTrack->clear();
+}
+
+
+void GeofenceServiceImpl::attach(Poco::OSP::Service::Ptr pService)
+{
+	Poco::FastMutex::ScopedLock lock(_gnssMutex);
+
+	if (_pGNSSSensor) return;
+	if (!pService->isA(typeid(IoT::Devices::IGNSSSensor))) throw Poco::InvalidArgumentException("Device is not a GNSSSensor", _gnssName);
+	_pGNSSSensor = pService.cast<IoT::Devices::IGNSSSensor>();
+	_pGNSSSensor->positionUpdate += Poco::delegate(this, &GeofenceServiceImpl::onPositionUpdate);
+}
+
+
+void GeofenceServiceImpl::detach()
+{
+	Poco::FastMutex::ScopedLock lock(_gnssMutex);
+
+	if (_pGNSSSensor)
+	{
+		_pGNSSSensor->positionUpdate -= Poco::delegate(this, &GeofenceServiceImpl::onPositionUpdate);
+		_pGNSSSensor = 0;
+	}
+}
+
+
+void GeofenceServiceImpl::simplifiedTrack(double tolerance, TrackBuffer::PointVec& points) const
+{
+	TrackBuffer::PointVec allPoints;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_pTrack->points(allPoints);
+	}
+	TrackBuffer::simplify(allPoints, tolerance, points);
+}
+
+
+void GeofenceServiceImpl::onPositionUpdate(const IoT::Devices::PositionUpdate& update)
+{
+	try
+	{
+		updatePosition(update.position, update.timestamp.epochMicroseconds()/1000);
+	}
+	catch (Poco::Exception& exc)
+	{
+		_logger.error("Cannot evaluate position: %s", exc.displayText());
+	}
+}
+
+
+void GeofenceServiceImpl::onServiceRegistered(const void* pSender, Poco::OSP::ServiceEvent& event)
+{
+	if (event.service()->name() == _gnssName)
+	{
+		try
+		{
+			attach(event.service()->instance());
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.error("Cannot track position: %s", exc.displayText());
+		}
+	}
+}
+
+
+void GeofenceServiceImpl::onServiceUnregistered(const void* pSender, Poco::OSP::ServiceEvent& event)
+{
+	if (event.service()->name() == _gnssName)
+	{
+		detach();
+	}
+}
+
+
+} } // namespace IoT::Geofence
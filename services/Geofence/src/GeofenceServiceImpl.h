@@ -0,0 +1,115 @@
+//
+// GeofenceServiceImpl.h
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: GeofenceServiceImpl
+// Module:  GeofenceServiceImpl
+//
+// Definition of the GeofenceServiceImpl class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Geofence_GeofenceServiceImpl_INCLUDED
+#define IoT_Geofence_GeofenceServiceImpl_INCLUDED
+
+
+#include "IoT/Geofence/GeofenceService.h"
+#include "IoT/Geofence/GeofenceEngine.h"
+#include "IoT/Geofence/TrackBuffer.h"
+#include "IoT/Devices/IGNSSSensor.h"
+#include "Poco/OSP/BundleContext.h"
+#include "Poco/OSP/ServiceEvent.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Logger.h"
+#include "Poco/Mutex.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+class GeofenceServiceImpl: public GeofenceService
+	/// Default implementation of the GeofenceService.
+	///
+	/// The service is configured in the application configuration,
+	/// using the following properties:
+	///
+	///   geofence.gnss           = <GNSSSensor service name> (default io.macchina.gnss.nmea#0)
+	///   geofence.fences         = <path of a JSON file with fences> (optional)
+	///   geofence.track.capacity = <number of track points> (default 86400)
+	///
+	/// The fences file contains an array of objects with the same
+	/// members as the Fence struct, e.g.:
+	///
+	///   [
+	///     {"id": "depot", "center": {"latitude": 47.07, "longitude": 15.44}, "radius": 150, "dwellTime": 60000},
+	///     {"id": "yard", "polygon": [{"latitude": 47.1, "longitude": 15.4}, ...]}
+	///   ]
+	///
+	/// The GNSSSensor may be registered after the service has been started.
+{
+public:
+	GeofenceServiceImpl(Poco::OSP::BundleContext::Ptr pContext);
+		/// Creates the GeofenceServiceImpl and loads the configured fences.
+
+	~GeofenceServiceImpl();
+		/// Destroys the GeofenceServiceImpl.
+
+	void start();
+		/// Subscribes to the positionUpdate events of the configured
+		/// GNSSSensor and starts watching for the sensor being registered.
+
+	void stop();
+		/// Unsubscribes from the GNSSSensor.
+
+	void loadFences(const std::string& path);
+		/// Adds all fences from the given JSON file.
+
+	// GeofenceService
+	void addFence(const Fence& fence);
+	bool removeFence(const std::string& id);
+	std::vector<std::string> fenceIds() const;
+	Fence fence(const std::string& id) const;
+	std::vector<std::string> insideFences() const;
+	std::vector<GeofenceEvent> updatePosition(const IoT::Devices::LatLon& position, Poco::Int64 timestamp);
+	std::vector<TrackPoint> track(double tolerance) const;
+	std::string encodedTrack(double tolerance) const;
+	int trackSize() const;
+	void clearTrack();
+
+	enum
+	{
+		DEFAULT_TRACK_CAPACITY = 86400
+	};
+
+protected:
+	void attach(Poco::OSP::Service::Ptr pService);
+	void detach();
+	void simplifiedTrack(double tolerance, TrackBuffer::PointVec& points) const;
+	void onPositionUpdate(const IoT::Devices::PositionUpdate& update);
+	void onServiceRegistered(const void* pSender, Poco::OSP::ServiceEvent& event);
+	void onServiceUnregistered(const void* pSender, Poco::OSP::ServiceEvent& event);
+
+private:
+	Poco::OSP::BundleContext::Ptr _pContext;
+	std::string _gnssName;
+	IoT::Devices::IGNSSSensor::Ptr _pGNSSSensor;
+	GeofenceEngine _engine;
+	Poco::SharedPtr<TrackBuffer> _pTrack;
+	Poco::Logger& _logger;
+	mutable Poco::FastMutex _mutex;
+	Poco::FastMutex _gnssMutex;
+};
+
+
+} } // namespace IoT::Geofence
+
+
+#endif // IoT_Geofence_GeofenceServiceImpl_INCLUDED
@@ -0,0 +1,77 @@
+//
+// GeofenceServiceRemoteObject.cpp
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  GeofenceServiceRemoteObject
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Geofence/GeofenceServiceRemoteObject.h"
+#include "IoT/Geofence/GeofenceServiceEventDispatcher.h"
+#include "Poco/Delegate.h"
+#include "Poco/RemotingNG/ORB.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+GeofenceServiceRemoteObject::GeofenceServiceRemoteObject(const Poco::RemotingNG::Identifiable::ObjectId& oid, Poco::SharedPtr<IoT::Geofence::GeofenceService> pServiceObject):
+	IoT::Geofence::IGeofenceService(),
+	Poco::RemotingNG::RemoteObject(oid),
+	_pServiceObject(pServiceObject)
+{
+	_pServiceObject->geofenceTransition += Poco::delegate(this, &GeofenceServiceRemoteObject::event__geofenceTransition);
+}
+
+
+GeofenceServiceRemoteObject::~GeofenceServiceRemoteObject()
+{
+	try
+	{
+		_pServiceObject->geofenceTransition -= Poco::delegate(this, &GeofenceServiceRemoteObject::event__geofenceTransition);
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+std::string GeofenceServiceRemoteObject::remoting__enableEvents(Poco::RemotingNG::Listener::Ptr pListener, bool enable)
+{
+	return std::string();
+}
+
+
+void GeofenceServiceRemoteObject::remoting__enableRemoteEvents(const std::string& protocol)
+{
+	Poco::RemotingNG::EventDispatcher::Ptr pEventDispatcher = new GeofenceServiceEventDispatcher(this, protocol);
+	Poco::RemotingNG::ORB::instance().registerEventDispatcher(remoting__getURI().toString(), pEventDispatcher);
+}
+
+
+bool GeofenceServiceRemoteObject::remoting__hasEvents() const
+{
+	return true;
+}
+
+
+void GeofenceServiceRemoteObject::event__geofenceTransition(const IoT::Geofence::GeofenceEvent& data)
+{
+	geofenceTransition(this, data);
+}
+
+
+} // namespace Geofence
+} // namespace IoT
+
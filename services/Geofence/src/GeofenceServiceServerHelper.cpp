@@ -0,0 +1,100 @@
+//
+// GeofenceServiceServerHelper.cpp
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  GeofenceServiceServerHelper
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Geofence/GeofenceServiceServerHelper.h"
+#include "IoT/Geofence/GeofenceServiceEventDispatcher.h"
+#include "IoT/Geofence/GeofenceServiceSkeleton.h"
+#include "Poco/RemotingNG/URIUtility.h"
+#include "Poco/SingletonHolder.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+namespace
+{
+	static Poco::SingletonHolder<GeofenceServiceServerHelper> shGeofenceServiceServerHelper;
+}
+
+
+GeofenceServiceServerHelper::GeofenceServiceServerHelper():
+	_pORB(0)
+{
+	_pORB = &Poco::RemotingNG::ORB::instance();
+	_pORB->registerSkeleton("IoT.Geofence.GeofenceService", new GeofenceServiceSkeleton);
+}
+
+
+GeofenceServiceServerHelper::~GeofenceServiceServerHelper()
+{
+	try
+	{
+		_pORB->unregisterSkeleton("IoT.Geofence.GeofenceService", true);
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+std::string GeofenceServiceServerHelper::registerRemoteObject(Poco::AutoPtr<IoT::Geofence::GeofenceServiceRemoteObject> pRemoteObject, const std::string& listenerId)
+{
+	return GeofenceServiceServerHelper::instance().registerObjectImpl(pRemoteObject, listenerId);
+}
+
+
+Poco::AutoPtr<IoT::Geofence::GeofenceServiceRemoteObject> GeofenceServiceServerHelper::createRemoteObjectImpl(Poco::SharedPtr<IoT::Geofence::GeofenceService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid)
+{
+	return new GeofenceServiceRemoteObject(oid, pServiceObject);
+}
+
+
+void GeofenceServiceServerHelper::enableEventsImpl(const std::string& uri, const std::string& protocol)
+{
+	Poco::RemotingNG::Identifiable::Ptr pIdentifiable = _pORB->findObject(uri);
+	Poco::AutoPtr<GeofenceServiceRemoteObject> pRemoteObject = pIdentifiable.cast<GeofenceServiceRemoteObject>();
+	if (pRemoteObject)
+	{
+		pRemoteObject->remoting__enableRemoteEvents(protocol);
+	}
+	else throw Poco::NotFoundException("remote object", uri);
+}
+
+
+GeofenceServiceServerHelper& GeofenceServiceServerHelper::instance()
+{
+	return *shGeofenceServiceServerHelper.get();
+}
+
+
+std::string GeofenceServiceServerHelper::registerObjectImpl(Poco::AutoPtr<IoT::Geofence::GeofenceServiceRemoteObject> pRemoteObject, const std::string& listenerId)
+{
+	return _pORB->registerObject(pRemoteObject, listenerId);
+}
+
+
+void GeofenceServiceServerHelper::unregisterObjectImpl(const std::string& uri)
+{
+	_pORB->unregisterObject(uri);
+}
+
+
+} // namespace Geofence
+} // namespace IoT
+
@@ -0,0 +1,61 @@
+//
+// IGeofenceService.cpp
+//
+// Library: IoT/Geofence
+// Package: Generated
+// Module:  IGeofenceService
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Geofence/IGeofenceService.h"
+
+
+namespace IoT {
+namespace Geofence {
+
+
+IGeofenceService::IGeofenceService():
+	Poco::OSP::Service(),
+	geofenceTransition()
+{
+}
+
+
+IGeofenceService::~IGeofenceService()
+{
+}
+
+
+bool IGeofenceService::isA(const std::type_info& otherType) const
+{
+	std::string name(type().name());
+	return name == otherType.name();
+}
+
+
+const Poco::RemotingNG::Identifiable::TypeId& IGeofenceService::remoting__typeId()
+{
+	remoting__staticInitBegin(REMOTING__TYPE_ID);
+	static const std::string REMOTING__TYPE_ID("IoT.Geofence.GeofenceService");
+	remoting__staticInitEnd(REMOTING__TYPE_ID);
+	return REMOTING__TYPE_ID;
+}
+
+
+const std::type_info& IGeofenceService::type() const
+{
+	return typeid(IGeofenceService);
+}
+
+
+} // namespace Geofence
+} // namespace IoT
+
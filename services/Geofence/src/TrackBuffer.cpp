@@ -0,0 +1,352 @@
+//
+// TrackBuffer.cpp
+//
+// $Id$
+//
+// Library: IoT/Geofence
+// Package: Geofence
+// Module:  TrackBuffer
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Geofence/TrackBuffer.h"
+#include "Poco/Exception.h"
+#include "Poco/Bugcheck.h"
+#include <cmath>
+
+
+namespace IoT {
+namespace Geofence {
+
+
+namespace
+{
+	const double PI = 3.14159265358979323846;
+	const double EARTH_MEAN_RADIUS = 6371009.0;
+	const double METERS_PER_DEGREE = EARTH_MEAN_RADIUS*PI/180;
+
+	Poco::Int64 quantize(double value, double scale)
+	{
+		return static_cast<Poco::Int64>(std::floor(value*scale + 0.5));
+	}
+
+	Poco::UInt64 zigzag(Poco::Int64 value)
+	{
+		return value < 0 ? ~(static_cast<Poco::UInt64>(value) << 1) : static_cast<Poco::UInt64>(value) << 1;
+	}
+
+	Poco::Int64 unzigzag(Poco::UInt64 value)
+	{
+		return (value & 1) ? ~static_cast<Poco::Int64>(value >> 1) : static_cast<Poco::Int64>(value >> 1);
+	}
+
+	double segmentDistance(const TrackBuffer::Point& p, const TrackBuffer::Point& a, const TrackBuffer::Point& b)
+		/// Returns the distance in meters of p from the segment a-b,
+		/// using an equirectangular projection centered at a.
+	{
+		double scaleLon = std::cos(a.latitude*PI/180)*METERS_PER_DEGREE;
+		double dLonB = b.longitude - a.longitude;
+		double dLonP = p.longitude - a.longitude;
+		if (dLonB > 180) dLonB -= 360; else if (dLonB < -180) dLonB += 360;
+		if (dLonP > 180) dLonP -= 360; else if (dLonP < -180) dLonP += 360;
+		double bx = dLonB*scaleLon;
+		double by = (b.latitude - a.latitude)*METERS_PER_DEGREE;
+		double px = dLonP*scaleLon;
+		double py = (p.latitude - a.latitude)*METERS_PER_DEGREE;
+		double len2 = bx*bx + by*by;
+		double t = len2 > 0 ? (px*bx + py*by)/len2 : 0;
+		if (t < 0) t = 0; else if (t > 1) t = 1;
+		double dx = px - t*bx;
+		double dy = py - t*by;
+		return std::sqrt(dx*dx + dy*dy);
+	}
+
+	void encodeValue(std::string& encoded, Poco::Int64 value)
+	{
+		Poco::UInt64 u = zigzag(value);
+		while (u >= 0x20)
+		{
+			encoded += static_cast<char>((0x20 | (u & 0x1F)) + 63);
+			u >>= 5;
+		}
+		encoded += static_cast<char>(u + 63);
+	}
+}
+
+
+//
+// TrackBuffer::Point
+//
+
+
+TrackBuffer::Point::Point():
+	latitude(0.0),
+	longitude(0.0),
+	timestamp(0)
+{
+}
+
+
+TrackBuffer::Point::Point(double latitude_, double longitude_, Poco::Int64 timestamp_):
+	latitude(latitude_),
+	longitude(longitude_),
+	timestamp(timestamp_)
+{
+}
+
+
+//
+// TrackBuffer::Block
+//
+
+
+TrackBuffer::Block::Block():
+	count(0),
+	lastLat(0),
+	lastLon(0),
+	lastTime(0)
+{
+}
+
+
+//
+// TrackBuffer
+//
+
+
+TrackBuffer::TrackBuffer(std::size_t capacity):
+	_capacity(capacity),
+	_count(0)
+{
+	poco_assert (capacity > 0);
+}
+
+
+TrackBuffer::~TrackBuffer()
+{
+}
+
+
+void TrackBuffer::append(double latitude, double longitude, Poco::Int64 timestamp)
+{
+	Poco::Int32 lat = static_cast<Poco::Int32>(quantize(latitude, 1e6));
+	Poco::Int32 lon = static_cast<Poco::Int32>(quantize(longitude, 1e6));
+
+	if (_blocks.empty() || _blocks.back().count == POINTS_PER_BLOCK)
+	{
+		if (!_blocks.empty())
+		{
+			// release the spare capacity of the completed block
+			std::vector<unsigned char>(_blocks.back().data).swap(_blocks.back().data);
+		}
+		_blocks.push_back(Block());
+		Block& block = _blocks.back();
+		writeVarInt(block.data, lat);
+		writeVarInt(block.data, lon);
+		writeVarInt(block.data, timestamp);
+	}
+	else
+	{
+		Block& block = _blocks.back();
+		writeVarInt(block.data, static_cast<Poco::Int64>(lat) - block.lastLat);
+		writeVarInt(block.data, static_cast<Poco::Int64>(lon) - block.lastLon);
+		writeVarInt(block.data, timestamp - block.lastTime);
+	}
+	Block& block = _blocks.back();
+	block.lastLat = lat;
+	block.lastLon = lon;
+	block.lastTime = timestamp;
+	block.count++;
+	_count++;
+
+	while (_count - _blocks.front().count >= _capacity)
+	{
+		_count -= _blocks.front().count;
+		_blocks.pop_front();
+	}
+}
+
+
+void TrackBuffer::points(PointVec& points) const
+{
+	points.clear();
+	points.reserve(size());
+	std::size_t skip = _count > _capacity ? _count - _capacity : 0;
+	for (BlockDeque::const_iterator it = _blocks.begin(); it != _blocks.end(); ++it)
+	{
+		if (skip >= it->count)
+		{
+			skip -= it->count;
+			continue;
+		}
+		std::size_t pos = 0;
+		Poco::Int64 lat = 0;
+		Poco::Int64 lon = 0;
+		Poco::Int64 time = 0;
+		for (std::size_t i = 0; i < it->count; i++)
+		{
+			lat += readVarInt(it->data, pos);
+			lon += readVarInt(it->data, pos);
+			time += readVarInt(it->data, pos);
+			if (skip > 0)
+				skip--;
+			else
+				points.push_back(Point(lat/1e6, lon/1e6, time));
+		}
+	}
+}
+
+
+std::size_t TrackBuffer::encodedSize() const
+{
+	std::size_t bytes = 0;
+	for (BlockDeque::const_iterator it = _blocks.begin(); it != _blocks.end(); ++it)
+	{
+		bytes += it->data.size();
+	}
+	return bytes;
+}
+
+
+void TrackBuffer::clear()
+{
+	_blocks.clear();
+	_count = 0;
+}
+
+
+void TrackBuffer::simplify(const PointVec& points, double tolerance, PointVec& result)
+{
+	result.clear();
+	const std::size_t n = points.size();
+	if (n < 3 || tolerance <= 0)
+	{
+		result = points;
+		return;
+	}
+
+	std::vector<bool> keep(n, false);
+	keep[0] = true;
+	keep[n - 1] = true;
+	std::vector<std::pair<std::size_t, std::size_t> > ranges;
+	ranges.push_back(std::make_pair(std::size_t(0), n - 1));
+	while (!ranges.empty())
+	{
+		std::size_t first = ranges.back().first;
+		std::size_t last = ranges.back().second;
+		ranges.pop_back();
+
+		double maxDistance = 0;
+		std::size_t farthest = first;
+		for (std::size_t i = first + 1; i < last; i++)
+		{
+			double distance = segmentDistance(points[i], points[first], points[last]);
+			if (distance > maxDistance)
+			{
+				maxDistance = distance;
+				farthest = i;
+			}
+		}
+		if (maxDistance > tolerance)
+		{
+			keep[farthest] = true;
+			if (farthest - first > 1) ranges.push_back(std::make_pair(first, farthest));
+			if (last - farthest > 1) ranges.push_back(std::make_pair(farthest, last));
+		}
+	}
+
+	for (std::size_t i = 0; i < n; i++)
+	{
+		if (keep[i]) result.push_back(points[i]);
+	}
+}
+
+
+std::string TrackBuffer::encode(const PointVec& points)
+{
+	std::string encoded;
+	encoded.reserve(points.size()*8);
+	Poco::Int64 lastLat = 0;
+	Poco::Int64 lastLon = 0;
+	Poco::Int64 lastTime = 0;
+	for (PointVec::const_iterator it = points.begin(); it != points.end(); ++it)
+	{
+		Poco::Int64 lat = quantize(it->latitude, 1e5);
+		Poco::Int64 lon = quantize(it->longitude, 1e5);
+		encodeValue(encoded, lat - lastLat);
+		encodeValue(encoded, lon - lastLon);
+		encodeValue(encoded, it->timestamp - lastTime);
+		lastLat = lat;
+		lastLon = lon;
+		lastTime = it->timestamp;
+	}
+	return encoded;
+}
+
+
+void TrackBuffer::decode(const std::string& encoded, PointVec& points)
+{
+	points.clear();
+	Poco::Int64 values[3] = {0, 0, 0};
+	int index = 0;
+	Poco::UInt64 u = 0;
+	int shift = 0;
+	for (std::string::const_iterator it = encoded.begin(); it != encoded.end(); ++it)
+	{
+		int c = static_cast<unsigned char>(*it) - 63;
+		if (c < 0 || c > 63 || shift > 60) throw Poco::DataFormatException("invalid encoded track");
+		u |= static_cast<Poco::UInt64>(c & 0x1F) << shift;
+		if (c & 0x20)
+		{
+			shift += 5;
+		}
+		else
+		{
+			values[index] += unzigzag(u);
+			u = 0;
+			shift = 0;
+			if (++index == 3)
+			{
+				points.push_back(Point(values[0]/1e5, values[1]/1e5, values[2]));
+				index = 0;
+			}
+		}
+	}
+	if (index != 0 || shift != 0) throw Poco::DataFormatException("truncated encoded track");
+}
+
+
+void TrackBuffer::writeVarInt(std::vector<unsigned char>& data, Poco::Int64 value)
+{
+	Poco::UInt64 u = zigzag(value);
+	while (u >= 0x80)
+	{
+		data.push_back(static_cast<unsigned char>((u & 0x7F) | 0x80));
+		u >>= 7;
+	}
+	data.push_back(static_cast<unsigned char>(u));
+}
+
+
+Poco::Int64 TrackBuffer::readVarInt(const std::vector<unsigned char>& data, std::size_t& pos)
+{
+	Poco::UInt64 u = 0;
+	int shift = 0;
+	unsigned char b;
+	do
+	{
+		b = data[pos++];
+		u |= static_cast<Poco::UInt64>(b & 0x7F) << shift;
+		shift += 7;
+	}
+	while (b & 0x80);
+	return unzigzag(u);
+}
+
+
+} } // namespace IoT::Geofence
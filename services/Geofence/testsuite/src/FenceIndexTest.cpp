@@ -0,0 +1,218 @@
+//
+// FenceIndexTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "FenceIndexTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Geofence/FenceIndex.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Random.h"
+#include <algorithm>
+#include <map>
+
+
+using IoT::Geofence::FenceIndex;
+
+
+namespace
+{
+	typedef std::map<std::string, FenceIndex::Box> BoxMap;
+
+	void createBoxes(int n, BoxMap& boxes)
+	{
+		Poco::Random rnd;
+		rnd.seed(4711);
+		for (int i = 0; i < n; i++)
+		{
+			double lat = 46.0 + 2.0*rnd.nextDouble();
+			double lon = 14.0 + 3.0*rnd.nextDouble();
+			double size = 0.001 + 0.02*rnd.nextDouble();
+			boxes["fence" + Poco::NumberFormatter::format(i)] = FenceIndex::Box(lat, lon, lat + size, lon + size);
+		}
+	}
+
+	std::vector<std::string> bruteForce(const BoxMap& boxes, double lat, double lon)
+	{
+		std::vector<std::string> ids;
+		for (BoxMap::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+		{
+			if (it->second.contains(lat, lon)) ids.push_back(it->first);
+		}
+		return ids;
+	}
+
+	std::vector<std::string> indexed(const FenceIndex& index, double lat, double lon)
+	{
+		std::vector<std::string> ids;
+		index.find(lat, lon, ids);
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+
+	bool matches(const FenceIndex& index, const BoxMap& boxes)
+		/// Compares the results of the index with a linear search.
+	{
+		Poco::Random rnd;
+		rnd.seed(815);
+		for (int i = 0; i < 2000; i++)
+		{
+			double lat = 46.0 + 2.0*rnd.nextDouble();
+			double lon = 14.0 + 3.0*rnd.nextDouble();
+			if (indexed(index, lat, lon) != bruteForce(boxes, lat, lon)) return false;
+		}
+		for (BoxMap::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+		{
+			std::vector<std::string> ids = indexed(index, it->second.minLat, it->second.minLon);
+			if (std::find(ids.begin(), ids.end(), it->first) == ids.end()) return false;
+		}
+		return true;
+	}
+}
+
+
+FenceIndexTest::FenceIndexTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+FenceIndexTest::~FenceIndexTest()
+{
+}
+
+
+void FenceIndexTest::testInsertFind()
+{
+	FenceIndex index;
+	assert (index.size() == 0);
+	assert (index.height() == 1);
+	assert (indexed(index, 47.0, 15.0).empty());
+
+	BoxMap boxes;
+	createBoxes(5000, boxes);
+	for (BoxMap::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+	{
+		index.insert(it->first, it->second);
+	}
+	assert (index.size() == 5000);
+	assert (index.height() > 2);
+	assert (index.height() < 8);
+
+	assert (matches(index, boxes));
+}
+
+
+void FenceIndexTest::testFindBox()
+{
+	FenceIndex index;
+	index.insert("a", FenceIndex::Box(0, 0, 1, 1));
+	index.insert("b", FenceIndex::Box(2, 2, 3, 3));
+	index.insert("c", FenceIndex::Box(0.5, 0.5, 2.5, 2.5));
+
+	std::vector<std::string> ids;
+	index.find(FenceIndex::Box(0.9, 0.9, 1.1, 1.1), ids);
+	std::sort(ids.begin(), ids.end());
+	assert (ids.size() == 2);
+	assert (ids[0] == "a");
+	assert (ids[1] == "c");
+
+	ids.clear();
+	index.find(FenceIndex::Box(5, 5, 6, 6), ids);
+	assert (ids.empty());
+}
+
+
+void FenceIndexTest::testRemove()
+{
+	FenceIndex index;
+	BoxMap boxes;
+	createBoxes(3000, boxes);
+	for (BoxMap::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+	{
+		index.insert(it->first, it->second);
+	}
+
+	int i = 0;
+	BoxMap::iterator it = boxes.begin();
+	while (it != boxes.end())
+	{
+		if (i++ % 3 != 0)
+		{
+			assert (index.remove(it->first, it->second));
+			boxes.erase(it++);
+		}
+		else ++it;
+	}
+	assert (index.size() == boxes.size());
+	assert (matches(index, boxes));
+
+	for (it = boxes.begin(); it != boxes.end(); ++it)
+	{
+		assert (index.remove(it->first, it->second));
+	}
+	assert (index.size() == 0);
+	assert (index.height() == 1);
+	assert (indexed(index, 47.0, 15.0).empty());
+}
+
+
+void FenceIndexTest::testRemoveMissing()
+{
+	FenceIndex index;
+	index.insert("a", FenceIndex::Box(0, 0, 1, 1));
+	assert (!index.remove("b", FenceIndex::Box(0, 0, 1, 1)));
+	assert (!index.remove("a", FenceIndex::Box(0, 0, 1, 2)));
+	assert (index.size() == 1);
+	assert (index.remove("a", FenceIndex::Box(0, 0, 1, 1)));
+	assert (!index.remove("a", FenceIndex::Box(0, 0, 1, 1)));
+	assert (index.size() == 0);
+}
+
+
+void FenceIndexTest::testClear()
+{
+	FenceIndex index;
+	BoxMap boxes;
+	createBoxes(500, boxes);
+	for (BoxMap::const_iterator it = boxes.begin(); it != boxes.end(); ++it)
+	{
+		index.insert(it->first, it->second);
+	}
+	index.clear();
+	assert (index.size() == 0);
+	assert (index.height() == 1);
+	assert (indexed(index, boxes.begin()->second.minLat, boxes.begin()->second.minLon).empty());
+}
+
+
+void FenceIndexTest::setUp()
+{
+}
+
+
+void FenceIndexTest::tearDown()
+{
+}
+
+
+CppUnit::Test* FenceIndexTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("FenceIndexTest");
+
+	CppUnit_addTest(pSuite, FenceIndexTest, testInsertFind);
+	CppUnit_addTest(pSuite, FenceIndexTest, testFindBox);
+	CppUnit_addTest(pSuite, FenceIndexTest, testRemove);
+	CppUnit_addTest(pSuite, FenceIndexTest, testRemoveMissing);
+	CppUnit_addTest(pSuite, FenceIndexTest, testClear);
+
+	return pSuite;
+}
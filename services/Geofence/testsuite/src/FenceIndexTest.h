@@ -0,0 +1,42 @@
+//
+// FenceIndexTest.h
+//
+// $Id$
+//
+// Definition of the FenceIndexTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef FenceIndexTest_INCLUDED
+#define FenceIndexTest_INCLUDED
+
+
+#include "IoT/Geofence/Geofence.h"
+#include "CppUnit/TestCase.h"
+
+
+class FenceIndexTest: public CppUnit::TestCase
+{
+public:
+	FenceIndexTest(const std::string& name);
+	~FenceIndexTest();
+
+	void testInsertFind();
+	void testFindBox();
+	void testRemove();
+	void testRemoveMissing();
+	void testClear();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // FenceIndexTest_INCLUDED
@@ -0,0 +1,391 @@
+//
+// GeofenceEngineTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "GeofenceEngineTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Geofence/GeofenceEngine.h"
+#include "Poco/Geo/LatLon.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Random.h"
+#include "Poco/Exception.h"
+#include <algorithm>
+#include <cmath>
+
+
+using IoT::Geofence::GeofenceEngine;
+using IoT::Geofence::GeofenceEvent;
+using IoT::Geofence::Fence;
+using IoT::Devices::LatLon;
+
+
+namespace
+{
+	const double METERS_PER_DEGREE = 6371009.0*3.14159265358979323846/180;
+
+	LatLon latLon(double lat, double lon)
+	{
+		LatLon pos;
+		pos.latitude = lat;
+		pos.longitude = lon;
+		return pos;
+	}
+
+	Fence circle(const std::string& id, double lat, double lon, double radius, int dwellTime = 0)
+	{
+		Fence fence;
+		fence.id = id;
+		fence.center = latLon(lat, lon);
+		fence.radius = radius;
+		fence.dwellTime = dwellTime;
+		return fence;
+	}
+
+	Fence polygon(const std::string& id, const double* coords, int n)
+	{
+		Fence fence;
+		fence.id = id;
+		for (int i = 0; i < n; i++)
+		{
+			fence.polygon.push_back(latLon(coords[2*i], coords[2*i + 1]));
+		}
+		return fence;
+	}
+
+	std::vector<GeofenceEvent> update(GeofenceEngine& engine, double lat, double lon, Poco::Int64 timestamp = 0)
+	{
+		std::vector<GeofenceEvent> events;
+		engine.update(latLon(lat, lon), timestamp, events);
+		return events;
+	}
+
+	std::vector<std::string> inside(const GeofenceEngine& engine)
+	{
+		std::vector<std::string> ids;
+		engine.inside(ids);
+		return ids;
+	}
+}
+
+
+GeofenceEngineTest::GeofenceEngineTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+GeofenceEngineTest::~GeofenceEngineTest()
+{
+}
+
+
+void GeofenceEngineTest::testCircle()
+{
+	GeofenceEngine engine;
+	engine.add(circle("depot", 47.0, 15.0, 100));
+	assert (engine.size() == 1);
+	assert (engine.has("depot"));
+	assert (engine.get("depot").radius == 100);
+
+	std::vector<GeofenceEvent> events = update(engine, 47.0 + 150/METERS_PER_DEGREE, 15.0, 1000);
+	assert (events.empty());
+	assert (inside(engine).empty());
+
+	events = update(engine, 47.0 + 90/METERS_PER_DEGREE, 15.0, 2000);
+	assert (events.size() == 1);
+	assert (events[0].fenceId == "depot");
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_ENTER);
+	assert (events[0].timestamp == 2000);
+	assert (inside(engine).size() == 1);
+
+	events = update(engine, 47.0, 15.0 + 90/METERS_PER_DEGREE, 3000);
+	assert (events.empty());
+
+	// inside the bounding box, but outside the circle
+	events = update(engine, 47.0 + 80/METERS_PER_DEGREE, 15.0 + 80/METERS_PER_DEGREE/std::cos(47.0*3.14159265358979323846/180), 4000);
+	assert (events.size() == 1);
+	assert (events[0].fenceId == "depot");
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_EXIT);
+	assert (events[0].timestamp == 4000);
+	assert (inside(engine).empty());
+}
+
+
+void GeofenceEngineTest::testPolygon()
+{
+	static const double square[] = {47.0, 15.0, 47.0, 15.01, 47.01, 15.01, 47.01, 15.0};
+
+	GeofenceEngine engine;
+	engine.add(polygon("yard", square, 4));
+
+	assert (update(engine, 46.999, 15.005).empty());
+	std::vector<GeofenceEvent> events = update(engine, 47.005, 15.005);
+	assert (events.size() == 1);
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_ENTER);
+	assert (update(engine, 47.009, 15.001).empty());
+	events = update(engine, 47.005, 15.011);
+	assert (events.size() == 1);
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_EXIT);
+}
+
+
+void GeofenceEngineTest::testConcavePolygon()
+{
+	// an L-shaped fence
+	static const double ell[] = {47.0, 15.0, 47.0, 15.02, 47.01, 15.02, 47.01, 15.01, 47.02, 15.01, 47.02, 15.0};
+
+	GeofenceEngine engine;
+	engine.add(polygon("ell", ell, 6));
+
+	assert (update(engine, 47.015, 15.015).empty());
+	assert (inside(engine).empty());
+	assert (update(engine, 47.015, 15.005).size() == 1);
+	assert (update(engine, 47.005, 15.015).empty());
+	assert (update(engine, 47.015, 15.015).size() == 1);
+	assert (inside(engine).empty());
+}
+
+
+void GeofenceEngineTest::testDwell()
+{
+	GeofenceEngine engine;
+	engine.add(circle("depot", 47.0, 15.0, 100, 60000));
+	engine.add(circle("gate", 47.0, 15.0, 50));
+
+	std::vector<GeofenceEvent> events = update(engine, 47.0, 15.0, 1000);
+	assert (events.size() == 2);
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_ENTER);
+	assert (events[1].transition == IoT::Geofence::GEOFENCE_ENTER);
+
+	assert (update(engine, 47.0, 15.0, 31000).empty());
+
+	events = update(engine, 47.0, 15.0, 61000);
+	assert (events.size() == 1);
+	assert (events[0].fenceId == "depot");
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_DWELL);
+
+	assert (update(engine, 47.0, 15.0, 120000).empty());
+
+	events = update(engine, 47.0 + 75/METERS_PER_DEGREE, 15.0, 121000);
+	assert (events.size() == 1);
+	assert (events[0].fenceId == "gate");
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_EXIT);
+
+	events = update(engine, 48.0, 15.0, 122000);
+	assert (events.size() == 1);
+	assert (events[0].fenceId == "depot");
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_EXIT);
+
+	// dwell time restarts with the next enter
+	assert (update(engine, 47.0, 15.0, 130000).size() == 2);
+	assert (update(engine, 47.0, 15.0, 180000).empty());
+	assert (update(engine, 47.0, 15.0, 190000).size() == 1);
+}
+
+
+void GeofenceEngineTest::testAntimeridian()
+{
+	static const double pacific[] = {-17.0, 179.9, -17.0, -179.9, -16.9, -179.9, -16.9, 179.9};
+
+	GeofenceEngine engine;
+	engine.add(polygon("pacific", pacific, 4));
+	engine.add(circle("dateline", 10.0, 179.9995, 1000));
+
+	assert (update(engine, -16.95, 179.95).size() == 1);
+	assert (update(engine, -16.95, -179.95).empty());
+	assert (update(engine, -16.95, 179.0).size() == 1);
+	assert (update(engine, -16.95, -179.0).empty());
+	assert (update(engine, -16.95, -179.95).size() == 1);
+
+	std::vector<GeofenceEvent> events = update(engine, 10.0, -179.9995);
+	assert (events.size() == 2);
+	assert (events[0].fenceId == "pacific");
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_EXIT);
+	assert (events[1].fenceId == "dateline");
+	assert (events[1].transition == IoT::Geofence::GEOFENCE_ENTER);
+	assert (update(engine, 10.0, 179.9995).empty());
+	assert (update(engine, 10.0, -179.98).size() == 1);
+}
+
+
+void GeofenceEngineTest::testReplaceRemove()
+{
+	GeofenceEngine engine;
+	engine.add(circle("depot", 47.0, 15.0, 100));
+	assert (update(engine, 47.0, 15.0).size() == 1);
+
+	// the position is still inside the replacement, so no transition
+	engine.add(circle("depot", 47.0, 15.0, 200));
+	assert (engine.size() == 1);
+	assert (engine.get("depot").radius == 200);
+	assert (update(engine, 47.0, 15.0).empty());
+	assert (inside(engine).size() == 1);
+
+	// the position is outside the replacement
+	engine.add(circle("depot", 48.0, 15.0, 200));
+	std::vector<GeofenceEvent> events = update(engine, 47.0, 15.0);
+	assert (events.size() == 1);
+	assert (events[0].transition == IoT::Geofence::GEOFENCE_EXIT);
+
+	assert (update(engine, 48.0, 15.0).size() == 1);
+	assert (engine.remove("depot"));
+	assert (!engine.remove("depot"));
+	assert (!engine.has("depot"));
+	assert (inside(engine).empty());
+	assert (update(engine, 48.0, 15.0).empty());
+	assert (engine.index().size() == 0);
+
+	try
+	{
+		engine.get("depot");
+		fail("no such fence - must throw");
+	}
+	catch (Poco::NotFoundException&)
+	{
+	}
+}
+
+
+void GeofenceEngineTest::testInvalidFence()
+{
+	static const double line[] = {47.0, 15.0, 47.01, 15.01};
+
+	GeofenceEngine engine;
+	try
+	{
+		engine.add(circle("", 47.0, 15.0, 100));
+		fail("empty ID - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+	try
+	{
+		engine.add(circle("bad", 47.0, 15.0, 0));
+		fail("neither circle nor polygon - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+	try
+	{
+		engine.add(polygon("bad", line, 2));
+		fail("too few vertices - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+	try
+	{
+		Fence fence = polygon("bad", line, 2);
+		fence.radius = 100;
+		engine.add(fence);
+		fail("both circle and polygon - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+	try
+	{
+		engine.add(circle("bad", 95.0, 15.0, 100));
+		fail("invalid center - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+	assert (engine.size() == 0);
+}
+
+
+void GeofenceEngineTest::testManyFences()
+{
+	Poco::Random rnd;
+	rnd.seed(1234);
+	std::vector<Fence> fences;
+	GeofenceEngine engine;
+	for (int i = 0; i < 5000; i++)
+	{
+		Fence fence = circle("depot" + Poco::NumberFormatter::format(i), 46.0 + 2*rnd.nextDouble(), 14.0 + 3*rnd.nextDouble(), 200 + 2000*rnd.nextDouble());
+		fences.push_back(fence);
+		engine.add(fence);
+	}
+	assert (engine.size() == 5000);
+
+	double lat = 47.0;
+	double lon = 15.5;
+	std::vector<std::string> expectedInside;
+	for (int step = 0; step < 2000; step++)
+	{
+		lat += (rnd.nextDouble() - 0.5)*0.005;
+		lon += (rnd.nextDouble() - 0.5)*0.005;
+		std::vector<GeofenceEvent> events = update(engine, lat, lon, step*1000);
+
+		std::vector<std::string> expected;
+		Poco::Geo::LatLon pos = Poco::Geo::LatLon::fromDegrees(lat, lon);
+		for (std::vector<Fence>::const_iterator it = fences.begin(); it != fences.end(); ++it)
+		{
+			Poco::Geo::LatLon center = Poco::Geo::LatLon::fromDegrees(it->center.latitude, it->center.longitude);
+			if (center.greatCircleDistanceTo(pos).radians()*Poco::Geo::LatLon::EARTH_MEAN_RADIUS <= it->radius)
+			{
+				expected.push_back(it->id);
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+		assert (inside(engine) == expected);
+
+		std::size_t enters = 0;
+		std::size_t exits = 0;
+		for (std::vector<GeofenceEvent>::const_iterator it = events.begin(); it != events.end(); ++it)
+		{
+			if (it->transition == IoT::Geofence::GEOFENCE_ENTER)
+			{
+				assert (!std::binary_search(expectedInside.begin(), expectedInside.end(), it->fenceId));
+				enters++;
+			}
+			else
+			{
+				assert (it->transition == IoT::Geofence::GEOFENCE_EXIT);
+				assert (std::binary_search(expectedInside.begin(), expectedInside.end(), it->fenceId));
+				exits++;
+			}
+		}
+		assert (expectedInside.size() + enters - exits == expected.size());
+		expectedInside = expected;
+	}
+}
+
+
+void GeofenceEngineTest::setUp()
+{
+}
+
+
+void GeofenceEngineTest::tearDown()
+{
+}
+
+
+CppUnit::Test* GeofenceEngineTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("GeofenceEngineTest");
+
+	CppUnit_addTest(pSuite, GeofenceEngineTest, testCircle);
+	CppUnit_addTest(pSuite, GeofenceEngineTest, testPolygon);
+	CppUnit_addTest(pSuite, GeofenceEngineTest, testConcavePolygon);
+	CppUnit_addTest(pSuite, GeofenceEngineTest, testDwell);
+	CppUnit_addTest(pSuite, GeofenceEngineTest, testAntimeridian);
+	CppUnit_addTest(pSuite, GeofenceEngineTest, testReplaceRemove);
+	CppUnit_addTest(pSuite, GeofenceEngineTest, testInvalidFence);
+	CppUnit_addTest(pSuite, GeofenceEngineTest, testManyFences);
+
+	return pSuite;
+}
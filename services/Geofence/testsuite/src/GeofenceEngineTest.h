@@ -0,0 +1,45 @@
+//
+// GeofenceEngineTest.h
+//
+// $Id$
+//
+// Definition of the GeofenceEngineTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef GeofenceEngineTest_INCLUDED
+#define GeofenceEngineTest_INCLUDED
+
+
+#include "IoT/Geofence/Geofence.h"
+#include "CppUnit/TestCase.h"
+
+
+class GeofenceEngineTest: public CppUnit::TestCase
+{
+public:
+	GeofenceEngineTest(const std::string& name);
+	~GeofenceEngineTest();
+
+	void testCircle();
+	void testPolygon();
+	void testConcavePolygon();
+	void testDwell();
+	void testAntimeridian();
+	void testReplaceRemove();
+	void testInvalidFence();
+	void testManyFences();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // GeofenceEngineTest_INCLUDED
@@ -0,0 +1,28 @@
+//
+// GeofenceTestSuite.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "GeofenceTestSuite.h"
+#include "FenceIndexTest.h"
+#include "GeofenceEngineTest.h"
+#include "TrackBufferTest.h"
+
+
+CppUnit::Test* GeofenceTestSuite::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("GeofenceTestSuite");
+
+	pSuite->addTest(FenceIndexTest::suite());
+	pSuite->addTest(GeofenceEngineTest::suite());
+	pSuite->addTest(TrackBufferTest::suite());
+
+	return pSuite;
+}
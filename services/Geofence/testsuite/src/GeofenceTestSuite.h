@@ -0,0 +1,29 @@
+//
+// GeofenceTestSuite.h
+//
+// $Id$
+//
+// Definition of the GeofenceTestSuite class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef GeofenceTestSuite_INCLUDED
+#define GeofenceTestSuite_INCLUDED
+
+
+#include "CppUnit/TestSuite.h"
+
+
+class GeofenceTestSuite
+{
+public:
+	static CppUnit::Test* suite();
+};
+
+
+#endif // GeofenceTestSuite_INCLUDED
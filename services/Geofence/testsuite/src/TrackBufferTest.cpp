@@ -0,0 +1,256 @@
+//
+// TrackBufferTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "TrackBufferTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Geofence/TrackBuffer.h"
+#include "Poco/Random.h"
+#include "Poco/Exception.h"
+#include <cmath>
+
+
+using IoT::Geofence::TrackBuffer;
+
+
+namespace
+{
+	const double METERS_PER_DEGREE = 6371009.0*3.14159265358979323846/180;
+
+	void drive(TrackBuffer& track, int n, Poco::Int64 startTime = 1476000000000LL)
+		/// Appends n points of a vehicle moving at about 20 m/s,
+		/// with a fix every second.
+	{
+		Poco::Random rnd;
+		rnd.seed(42);
+		double lat = 47.07;
+		double lon = 15.44;
+		for (int i = 0; i < n; i++)
+		{
+			track.append(lat, lon, startTime + i*1000);
+			lat += (12 + 4*rnd.nextDouble())/METERS_PER_DEGREE;
+			lon += (12 + 4*rnd.nextDouble())/METERS_PER_DEGREE/0.68;
+		}
+	}
+}
+
+
+TrackBufferTest::TrackBufferTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+TrackBufferTest::~TrackBufferTest()
+{
+}
+
+
+void TrackBufferTest::testAppend()
+{
+	TrackBuffer track(1000);
+	assert (track.size() == 0);
+	assert (track.capacity() == 1000);
+
+	track.append(47.0712345, 15.4398765, 1476000000000LL);
+	track.append(47.0712000, 15.4399000, 1476000001000LL);
+	track.append(-33.8688197, 151.2092955, 1476000000500LL);
+	track.append(-33.8688197, -179.9999999, 0);
+	assert (track.size() == 4);
+
+	TrackBuffer::PointVec points;
+	track.points(points);
+	assert (points.size() == 4);
+	assertEqualDelta (47.0712345, points[0].latitude, 0.6e-6);
+	assertEqualDelta (15.4398765, points[0].longitude, 0.6e-6);
+	assert (points[0].timestamp == 1476000000000LL);
+	assertEqualDelta (47.0712, points[1].latitude, 0.6e-6);
+	assertEqualDelta (15.4399, points[1].longitude, 0.6e-6);
+	assert (points[1].timestamp == 1476000001000LL);
+	assertEqualDelta (-33.8688197, points[2].latitude, 1e-6);
+	assertEqualDelta (151.2092955, points[2].longitude, 1e-6);
+	assert (points[2].timestamp == 1476000000500LL);
+	assertEqualDelta (-180.0, points[3].longitude, 1e-6);
+	assert (points[3].timestamp == 0);
+
+	track.clear();
+	assert (track.size() == 0);
+	track.points(points);
+	assert (points.empty());
+}
+
+
+void TrackBufferTest::testCapacity()
+{
+	TrackBuffer track(1000);
+	drive(track, 3000);
+	assert (track.size() == 1000);
+
+	TrackBuffer::PointVec points;
+	track.points(points);
+	assert (points.size() == 1000);
+	assert (points.front().timestamp == 1476000000000LL + 2000*1000);
+	assert (points.back().timestamp == 1476000000000LL + 2999*1000);
+	for (std::size_t i = 1; i < points.size(); i++)
+	{
+		assert (points[i].timestamp - points[i - 1].timestamp == 1000);
+	}
+
+	TrackBuffer reference(3000);
+	drive(reference, 3000);
+	TrackBuffer::PointVec allPoints;
+	reference.points(allPoints);
+	assert (allPoints.size() == 3000);
+	for (std::size_t i = 0; i < points.size(); i++)
+	{
+		assertEqualDelta (allPoints[2000 + i].latitude, points[i].latitude, 1e-9);
+		assertEqualDelta (allPoints[2000 + i].longitude, points[i].longitude, 1e-9);
+	}
+
+	// at most one partial block is kept beyond the capacity
+	assert (track.encodedSize() < reference.encodedSize()/2);
+}
+
+
+void TrackBufferTest::testCompactness()
+{
+	TrackBuffer track(10000);
+	drive(track, 10000);
+	assert (track.size() == 10000);
+	assert (track.encodedSize() <= 7*track.size());
+}
+
+
+void TrackBufferTest::testSimplify()
+{
+	TrackBuffer::PointVec points;
+	TrackBuffer::PointVec result;
+
+	TrackBuffer::simplify(points, 10, result);
+	assert (result.empty());
+
+	// a straight line with up to 2 meters of jitter
+	Poco::Random rnd;
+	rnd.seed(7);
+	for (int i = 0; i < 100; i++)
+	{
+		points.push_back(TrackBuffer::Point(47.0 + (i*10 + 4*(rnd.nextDouble() - 0.5))/METERS_PER_DEGREE, 15.0, i*1000));
+	}
+	TrackBuffer::simplify(points, 5, result);
+	assert (result.size() == 2);
+	assert (result.front().timestamp == 0);
+	assert (result.back().timestamp == 99000);
+
+	TrackBuffer::simplify(points, 0, result);
+	assert (result.size() == 100);
+
+	// a right-angle turn
+	points.clear();
+	for (int i = 0; i <= 50; i++)
+	{
+		points.push_back(TrackBuffer::Point(47.0 + i*10/METERS_PER_DEGREE, 15.0, i*1000));
+	}
+	for (int i = 1; i <= 50; i++)
+	{
+		points.push_back(TrackBuffer::Point(47.0 + 500/METERS_PER_DEGREE, 15.0 + i*10/METERS_PER_DEGREE/std::cos(47.0*3.14159265358979323846/180), (50 + i)*1000));
+	}
+	TrackBuffer::simplify(points, 5, result);
+	assert (result.size() == 3);
+	assert (result[1].timestamp == 50000);
+}
+
+
+void TrackBufferTest::testEncode()
+{
+	TrackBuffer::PointVec points;
+	assert (TrackBuffer::encode(points).empty());
+
+	// the values of the polyline format specification
+	points.push_back(TrackBuffer::Point(-179.9832104, 0, 0));
+	assert (TrackBuffer::encode(points) == "`~oia@??");
+
+	points.clear();
+	TrackBuffer track(1000);
+	drive(track, 1000);
+	track.points(points);
+	std::string encoded = TrackBuffer::encode(points);
+	assert (encoded.size() < 10*points.size());
+	for (std::string::const_iterator it = encoded.begin(); it != encoded.end(); ++it)
+	{
+		assert (*it >= 63 && *it <= 126);
+	}
+
+	TrackBuffer::PointVec decoded;
+	TrackBuffer::decode(encoded, decoded);
+	assert (decoded.size() == points.size());
+	for (std::size_t i = 0; i < points.size(); i++)
+	{
+		assertEqualDelta (points[i].latitude, decoded[i].latitude, 0.6e-5);
+		assertEqualDelta (points[i].longitude, decoded[i].longitude, 0.6e-5);
+		assert (points[i].timestamp == decoded[i].timestamp);
+	}
+}
+
+
+void TrackBufferTest::testDecodeInvalid()
+{
+	TrackBuffer::PointVec points;
+	try
+	{
+		TrackBuffer::decode("`~oia@?", points);
+		fail("incomplete point - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+	try
+	{
+		TrackBuffer::decode("`~oia", points);
+		fail("incomplete value - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+	try
+	{
+		TrackBuffer::decode("?\?!", points);
+		fail("invalid character - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+}
+
+
+void TrackBufferTest::setUp()
+{
+}
+
+
+void TrackBufferTest::tearDown()
+{
+}
+
+
+CppUnit::Test* TrackBufferTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TrackBufferTest");
+
+	CppUnit_addTest(pSuite, TrackBufferTest, testAppend);
+	CppUnit_addTest(pSuite, TrackBufferTest, testCapacity);
+	CppUnit_addTest(pSuite, TrackBufferTest, testCompactness);
+	CppUnit_addTest(pSuite, TrackBufferTest, testSimplify);
+	CppUnit_addTest(pSuite, TrackBufferTest, testEncode);
+	CppUnit_addTest(pSuite, TrackBufferTest, testDecodeInvalid);
+
+	return pSuite;
+}
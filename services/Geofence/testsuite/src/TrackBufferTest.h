@@ -0,0 +1,43 @@
+//
+// TrackBufferTest.h
+//
+// $Id$
+//
+// Definition of the TrackBufferTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TrackBufferTest_INCLUDED
+#define TrackBufferTest_INCLUDED
+
+
+#include "IoT/Geofence/Geofence.h"
+#include "CppUnit/TestCase.h"
+
+
+class TrackBufferTest: public CppUnit::TestCase
+{
+public:
+	TrackBufferTest(const std::string& name);
+	~TrackBufferTest();
+
+	void testAppend();
+	void testCapacity();
+	void testCompactness();
+	void testSimplify();
+	void testEncode();
+	void testDecodeInvalid();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+};
+
+
+#endif // TrackBufferTest_INCLUDED
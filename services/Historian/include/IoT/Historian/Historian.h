@@ -0,0 +1,60 @@
+//
+// Historian.h
+//
+// $Id$
+//
+// Library: IoT/Historian
+// Package: Historian
+// Module:  Historian
+//
+// Basic definitions for the IoT Historian library.
+// This file must be the first file included by every other Historian
+// header file.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Historian_Historian_INCLUDED
+#define IoT_Historian_Historian_INCLUDED
+
+
+#include "Poco/Poco.h"
+
+
+//
+// The following block is the standard way of creating macros which make exporting
+// from a DLL simpler. All files within this DLL are compiled with the IoTHistorian_EXPORTS
+// symbol defined on the command line. this symbol should not be defined on any project
+// that uses this DLL. This way any other project whose source files include this file see
+// IoTHistorian_API functions as being imported from a DLL, wheras this DLL sees symbols
+// defined with this macro as being exported.
+//
+#if defined(_WIN32) && defined(POCO_DLL)
+	#if defined(IoTHistorian_EXPORTS)
+		#define IoTHistorian_API __declspec(dllexport)
+	#else
+		#define IoTHistorian_API __declspec(dllimport)
+	#endif
+#endif
+
+
+#if !defined(IoTHistorian_API)
+	#define IoTHistorian_API
+#endif
+
+
+//
+// Automatically link Historian library.
+//
+#if defined(_MSC_VER)
+	#if !defined(POCO_NO_AUTOMATIC_LIBS) && !defined(IoTHistorian_EXPORTS)
+		#pragma comment(lib, "IoTHistorian" POCO_LIB_SUFFIX)
+	#endif
+#endif
+
+
+#endif // IoT_Historian_Historian_INCLUDED
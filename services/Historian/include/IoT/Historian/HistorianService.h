@@ -0,0 +1,174 @@
+//
+// HistorianService.h
+//
+// $Id$
+//
+// Library: IoT/Historian
+// Package: HistorianService
+// Module:  HistorianService
+//
+// Definition of the HistorianService interface.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Historian_HistorianService_INCLUDED
+#define IoT_Historian_HistorianService_INCLUDED
+
+
+#include "IoT/Historian/Historian.h"
+#include "Poco/SharedPtr.h"
+#include <vector>
+
+
+namespace IoT {
+namespace Historian {
+
+
+//@ serialize
+struct Sample
+	/// A single sample of a time series.
+{
+	Sample():
+		timestamp(0),
+		value(0.0)
+	{
+	}
+
+	Sample(Poco::Int64 ts, double v):
+		timestamp(ts),
+		value(v)
+	{
+	}
+
+	Poco::Int64 timestamp;
+		/// Time of the sample, in milliseconds since the Unix epoch.
+
+	double value;
+		/// The sample value.
+};
+
+
+//@ serialize
+struct SampleBucket
+	/// Aggregated samples over a time interval,
+	/// as returned by HistorianService::downsample().
+{
+	SampleBucket():
+		start(0),
+		min(0.0),
+		max(0.0),
+		avg(0.0),
+		count(0)
+	{
+	}
+
+	Poco::Int64 start;
+		/// Start of the bucket's time interval, in milliseconds
+		/// since the Unix epoch.
+
+	double min;
+		/// Minimum sample value in the bucket.
+
+	double max;
+		/// Maximum sample value in the bucket.
+
+	double avg;
+		/// Average sample value in the bucket.
+
+	int count;
+		/// Number of samples in the bucket.
+		/// Empty buckets are not returned.
+};
+
+
+//@ serialize
+struct SeriesInfo
+	/// Information about a time series.
+{
+	SeriesInfo():
+		firstTimestamp(0),
+		lastTimestamp(0),
+		sampleCount(0),
+		capacity(0)
+	{
+	}
+
+	std::string name;
+		/// The name of the series.
+
+	std::string device;
+		/// The service name of the device the series is
+		/// recorded from. Empty if samples are appended
+		/// with HistorianService::append() only.
+
+	Poco::Int64 firstTimestamp;
+		/// Timestamp of the oldest sample stored.
+
+	Poco::Int64 lastTimestamp;
+		/// Timestamp of the newest sample stored.
+
+	Poco::Int64 sampleCount;
+		/// Number of samples currently stored.
+
+	Poco::Int64 capacity;
+		/// Size of the series' storage in bytes.
+};
+
+
+//@ remote
+class IoTHistorian_API HistorianService
+	/// The HistorianService records the values of sensors and
+	/// other data sources into time series and makes the history
+	/// available for querying.
+	///
+	/// Each series is stored in a memory-mapped ring of fixed-size blocks.
+	/// Within a block, timestamps and values are kept in separate
+	/// columns, compressed using delta-of-delta encoding for timestamps and
+	/// XOR encoding for values. When the ring is full, the oldest
+	/// block is overwritten.
+{
+public:
+	typedef Poco::SharedPtr<HistorianService> Ptr;
+
+	HistorianService();
+		/// Creates the HistorianService.
+
+	virtual ~HistorianService();
+		/// Destroys the HistorianService.
+
+	virtual std::vector<SeriesInfo> series() const = 0;
+		/// Returns information about all configured series.
+
+	virtual void append(const std::string& series, Poco::Int64 timestamp, double value) = 0;
+		/// Appends a sample to the given series. The timestamp must
+		/// not be older than the newest sample in the series.
+		///
+		/// If timestamp is 0, the current time is used.
+		///
+		/// Throws a Poco::NotFoundException if the series does not exist.
+
+	//@ $maxSamples={mandatory=false}
+	virtual std::vector<Sample> samples(const std::string& series, Poco::Int64 from, Poco::Int64 to, int maxSamples = 0) const = 0;
+		/// Returns all samples of the given series with timestamps
+		/// in the interval [from, to]. If maxSamples is > 0, at most
+		/// maxSamples samples (the oldest ones) are returned.
+
+	virtual std::vector<SampleBucket> downsample(const std::string& series, Poco::Int64 from, Poco::Int64 to, Poco::Int64 interval) const = 0;
+		/// Aggregates the samples of the given series in the interval
+		/// [from, to] into buckets of the given interval (in milliseconds),
+		/// computing minimum, maximum and average value for each bucket.
+		///
+		/// Aggregation is done within the service, so only one bucket
+		/// per interval must be transferred to the caller.
+};
+
+
+} } // namespace IoT::Historian
+
+
+#endif // IoT_Historian_HistorianService_INCLUDED
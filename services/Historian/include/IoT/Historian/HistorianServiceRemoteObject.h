@@ -0,0 +1,118 @@
+//
+// HistorianServiceRemoteObject.h
+//
+// Library: IoT/Historian
+// Package: Generated
+// Module:  HistorianServiceRemoteObject
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Historian_HistorianServiceRemoteObject_INCLUDED
+#define IoT_Historian_HistorianServiceRemoteObject_INCLUDED
+
+
+#include "IoT/Historian/IHistorianService.h"
+#include "Poco/RemotingNG/Identifiable.h"
+#include "Poco/RemotingNG/RemoteObject.h"
+#include "Poco/SharedPtr.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+class HistorianServiceRemoteObject: public IoT::Historian::IHistorianService, public Poco::RemotingNG::RemoteObject
+	/// The HistorianService records the values of sensors and
+	/// other data sources into time series and makes the history
+	/// available for querying.
+	///
+	/// Each series is stored in a memory-mapped ring of fixed-size blocks.
+	/// Within a block, timestamps and values are kept in separate
+	/// columns, compressed using delta-of-delta encoding for timestamps and
+	/// XOR encoding for values. When the ring is full, the oldest
+	/// block is overwritten.
+{
+public:
+	typedef Poco::AutoPtr<HistorianServiceRemoteObject> Ptr;
+
+	HistorianServiceRemoteObject(const Poco::RemotingNG::Identifiable::ObjectId& oid, Poco::SharedPtr<IoT::Historian::HistorianService> pServiceObject);
+		/// Creates a HistorianServiceRemoteObject.
+
+	virtual ~HistorianServiceRemoteObject();
+		/// Destroys the HistorianServiceRemoteObject.
+
+	virtual void append(const std::string& series, Poco::Int64 timestamp, double value);
+		/// Appends a sample to the given series. The timestamp must
+		/// not be older than the newest sample in the series.
+		///
+		/// If timestamp is 0, the current time is used.
+		///
+		/// Throws a Poco::NotFoundException if the series does not exist.
+
+	std::vector < IoT::Historian::SampleBucket > downsample(const std::string& series, Poco::Int64 from, Poco::Int64 to, Poco::Int64 interval) const;
+		/// Aggregates the samples of the given series in the interval
+		/// [from, to] into buckets of the given interval (in milliseconds),
+		/// computing minimum, maximum and average value for each bucket.
+		///
+		/// Aggregation is done within the service, so only one bucket
+		/// per interval must be transferred to the caller.
+
+	virtual const Poco::RemotingNG::Identifiable::TypeId& remoting__typeId() const;
+
+	std::vector < IoT::Historian::Sample > samples(const std::string& series, Poco::Int64 from, Poco::Int64 to, int maxSamples = int(0)) const;
+		/// Returns all samples of the given series with timestamps
+		/// in the interval [from, to]. If maxSamples is > 0, at most
+		/// maxSamples samples (the oldest ones) are returned.
+
+	std::vector < IoT::Historian::SeriesInfo > series() const;
+		/// Returns information about all configured series.
+
+private:
+	Poco::SharedPtr<IoT::Historian::HistorianService> _pServiceObject;
+};
+
+
+inline void HistorianServiceRemoteObject::append(const std::string& series, Poco::Int64 timestamp, double value)
+{
+	_pServiceObject->append(series, timestamp, value);
+}
+
+
+inline std::vector < IoT::Historian::SampleBucket > HistorianServiceRemoteObject::downsample(const std::string& series, Poco::Int64 from, Poco::Int64 to, Poco::Int64 interval) const
+{
+	return _pServiceObject->downsample(series, from, to, interval);
+}
+
+
+inline const Poco::RemotingNG::Identifiable::TypeId& HistorianServiceRemoteObject::remoting__typeId() const
+{
+	return IHistorianService::remoting__typeId();
+}
+
+
+inline std::vector < IoT::Historian::Sample > HistorianServiceRemoteObject::samples(const std::string& series, Poco::Int64 from, Poco::Int64 to, int maxSamples) const
+{
+	return _pServiceObject->samples(series, from, to, maxSamples);
+}
+
+
+inline std::vector < IoT::Historian::SeriesInfo > HistorianServiceRemoteObject::series() const
+{
+	return _pServiceObject->series();
+}
+
+
+} // namespace Historian
+} // namespace IoT
+
+
+#endif // IoT_Historian_HistorianServiceRemoteObject_INCLUDED
+
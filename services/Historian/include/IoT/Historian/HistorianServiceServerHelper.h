@@ -0,0 +1,113 @@
+//
+// HistorianServiceServerHelper.h
+//
+// Library: IoT/Historian
+// Package: Generated
+// Module:  HistorianServiceServerHelper
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Historian_HistorianServiceServerHelper_INCLUDED
+#define IoT_Historian_HistorianServiceServerHelper_INCLUDED
+
+
+#include "IoT/Historian/HistorianService.h"
+#include "IoT/Historian/HistorianServiceRemoteObject.h"
+#include "IoT/Historian/IHistorianService.h"
+#include "Poco/RemotingNG/Identifiable.h"
+#include "Poco/RemotingNG/ORB.h"
+#include "Poco/RemotingNG/ServerHelper.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+class HistorianServiceServerHelper
+	/// The HistorianService records the values of sensors and
+	/// other data sources into time series and makes the history
+	/// available for querying.
+	///
+	/// Each series is stored in a memory-mapped ring of fixed-size blocks.
+	/// Within a block, timestamps and values are kept in separate
+	/// columns, compressed using delta-of-delta encoding for timestamps and
+	/// XOR encoding for values. When the ring is full, the oldest
+	/// block is overwritten.
+{
+public:
+	typedef IoT::Historian::HistorianService Service;
+
+	HistorianServiceServerHelper();
+		/// Creates a HistorianServiceServerHelper.
+
+	~HistorianServiceServerHelper();
+		/// Destroys the HistorianServiceServerHelper.
+
+	static Poco::AutoPtr<IoT::Historian::HistorianServiceRemoteObject> createRemoteObject(Poco::SharedPtr<IoT::Historian::HistorianService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid);
+		/// Creates and returns a RemoteObject wrapper for the given IoT::Historian::HistorianService instance.
+
+	static std::string registerObject(Poco::SharedPtr<IoT::Historian::HistorianService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid, const std::string& listenerId);
+		/// Creates a RemoteObject wrapper for the given IoT::Historian::HistorianService instance
+		/// and registers it with the ORB and the Listener instance
+		/// uniquely identified by the Listener's ID.
+		/// 
+		///	Returns the URI created for the object.
+
+	static std::string registerRemoteObject(Poco::AutoPtr<IoT::Historian::HistorianServiceRemoteObject> pRemoteObject, const std::string& listenerId);
+		/// Registers the given RemoteObject with the ORB and the Listener instance
+		/// uniquely identified by the Listener's ID.
+		/// 
+		///	Returns the URI created for the object.
+
+	static void unregisterObject(const std::string& uri);
+		/// Unregisters a service object identified by URI from the ORB.
+
+private:
+	static Poco::AutoPtr<IoT::Historian::HistorianServiceRemoteObject> createRemoteObjectImpl(Poco::SharedPtr<IoT::Historian::HistorianService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid);
+
+	static HistorianServiceServerHelper& instance();
+		/// Returns a static instance of the helper class.
+
+	std::string registerObjectImpl(Poco::AutoPtr<IoT::Historian::HistorianServiceRemoteObject> pRemoteObject, const std::string& listenerId);
+
+	void unregisterObjectImpl(const std::string& uri);
+
+	Poco::RemotingNG::ORB* _pORB;
+};
+
+
+inline Poco::AutoPtr<IoT::Historian::HistorianServiceRemoteObject> HistorianServiceServerHelper::createRemoteObject(Poco::SharedPtr<IoT::Historian::HistorianService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid)
+{
+	return HistorianServiceServerHelper::instance().createRemoteObjectImpl(pServiceObject, oid);
+}
+
+
+inline std::string HistorianServiceServerHelper::registerObject(Poco::SharedPtr<IoT::Historian::HistorianService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid, const std::string& listenerId)
+{
+	return HistorianServiceServerHelper::instance().registerObjectImpl(createRemoteObject(pServiceObject, oid), listenerId);
+}
+
+
+inline void HistorianServiceServerHelper::unregisterObject(const std::string& uri)
+{
+	HistorianServiceServerHelper::instance().unregisterObjectImpl(uri);
+}
+
+
+} // namespace Historian
+} // namespace IoT
+
+
+REMOTING_SPECIALIZE_SERVER_HELPER(IoT::Historian, HistorianService)
+
+
+#endif // IoT_Historian_HistorianServiceServerHelper_INCLUDED
+
@@ -0,0 +1,65 @@
+//
+// HistorianServiceSkeleton.h
+//
+// Library: IoT/Historian
+// Package: Generated
+// Module:  HistorianServiceSkeleton
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Historian_HistorianServiceSkeleton_INCLUDED
+#define IoT_Historian_HistorianServiceSkeleton_INCLUDED
+
+
+#include "IoT/Historian/HistorianServiceRemoteObject.h"
+#include "Poco/RemotingNG/Skeleton.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+class HistorianServiceSkeleton: public Poco::RemotingNG::Skeleton
+	/// The HistorianService records the values of sensors and
+	/// other data sources into time series and makes the history
+	/// available for querying.
+	///
+	/// Each series is stored in a memory-mapped ring of fixed-size blocks.
+	/// Within a block, timestamps and values are kept in separate
+	/// columns, compressed using delta-of-delta encoding for timestamps and
+	/// XOR encoding for values. When the ring is full, the oldest
+	/// block is overwritten.
+{
+public:
+	HistorianServiceSkeleton();
+		/// Creates a HistorianServiceSkeleton.
+
+	virtual ~HistorianServiceSkeleton();
+		/// Destroys a HistorianServiceSkeleton.
+
+	virtual const Poco::RemotingNG::Identifiable::TypeId& remoting__typeId() const;
+
+	static const std::string DEFAULT_NS;
+};
+
+
+inline const Poco::RemotingNG::Identifiable::TypeId& HistorianServiceSkeleton::remoting__typeId() const
+{
+	return IHistorianService::remoting__typeId();
+}
+
+
+} // namespace Historian
+} // namespace IoT
+
+
+#endif // IoT_Historian_HistorianServiceSkeleton_INCLUDED
+
@@ -0,0 +1,93 @@
+//
+// IHistorianService.h
+//
+// Library: IoT/Historian
+// Package: Generated
+// Module:  IHistorianService
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Historian_IHistorianService_INCLUDED
+#define IoT_Historian_IHistorianService_INCLUDED
+
+
+#include "IoT/Historian/HistorianService.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/OSP/Service.h"
+#include "Poco/RemotingNG/Identifiable.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+class IHistorianService: public Poco::OSP::Service
+	/// The HistorianService records the values of sensors and
+	/// other data sources into time series and makes the history
+	/// available for querying.
+	///
+	/// Each series is stored in a memory-mapped ring of fixed-size blocks.
+	/// Within a block, timestamps and values are kept in separate
+	/// columns, compressed using delta-of-delta encoding for timestamps and
+	/// XOR encoding for values. When the ring is full, the oldest
+	/// block is overwritten.
+{
+public:
+	typedef Poco::AutoPtr<IHistorianService> Ptr;
+
+	IHistorianService();
+		/// Creates a IHistorianService.
+
+	virtual ~IHistorianService();
+		/// Destroys the IHistorianService.
+
+	virtual void append(const std::string& series, Poco::Int64 timestamp, double value) = 0;
+		/// Appends a sample to the given series. The timestamp must
+		/// not be older than the newest sample in the series.
+		///
+		/// If timestamp is 0, the current time is used.
+		///
+		/// Throws a Poco::NotFoundException if the series does not exist.
+
+	virtual std::vector < IoT::Historian::SampleBucket > downsample(const std::string& series, Poco::Int64 from, Poco::Int64 to, Poco::Int64 interval) const = 0;
+		/// Aggregates the samples of the given series in the interval
+		/// [from, to] into buckets of the given interval (in milliseconds),
+		/// computing minimum, maximum and average value for each bucket.
+		///
+		/// Aggregation is done within the service, so only one bucket
+		/// per interval must be transferred to the caller.
+
+	bool isA(const std::type_info& otherType) const;
+		/// Returns true if the class is a subclass of the class given by otherType.
+
+	static const Poco::RemotingNG::Identifiable::TypeId& remoting__typeId();
+		/// Returns the TypeId of the class.
+
+	virtual std::vector < IoT::Historian::Sample > samples(const std::string& series, Poco::Int64 from, Poco::Int64 to, int maxSamples = int(0)) const = 0;
+		/// Returns all samples of the given series with timestamps
+		/// in the interval [from, to]. If maxSamples is > 0, at most
+		/// maxSamples samples (the oldest ones) are returned.
+
+	virtual std::vector < IoT::Historian::SeriesInfo > series() const = 0;
+		/// Returns information about all configured series.
+
+	const std::type_info& type() const;
+		/// Returns the type information for the object's class.
+
+};
+
+
+} // namespace Historian
+} // namespace IoT
+
+
+#endif // IoT_Historian_IHistorianService_INCLUDED
+
@@ -0,0 +1,64 @@
+//
+// SampleBucketDeserializer.h
+//
+// Package: Generated
+// Module:  TypeDeserializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeDeserializer_IoT_Historian_SampleBucket_INCLUDED
+#define TypeDeserializer_IoT_Historian_SampleBucket_INCLUDED
+
+
+#include "IoT/Historian/HistorianService.h"
+#include "Poco/RemotingNG/TypeDeserializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeDeserializer<IoT::Historian::SampleBucket>
+{
+public:
+	static bool deserialize(const std::string& name, bool isMandatory, Deserializer& deser, IoT::Historian::SampleBucket& value)
+	{
+		bool ret = deser.deserializeStructBegin(name, isMandatory);
+		if (ret)
+		{
+			deserializeImpl(deser, value);
+			deser.deserializeStructEnd(name);
+		}
+		return ret;
+	}
+
+	static void deserializeImpl(Deserializer& deser, IoT::Historian::SampleBucket& value)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"avg","count","max","min","start"};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeDeserializer<double >::deserialize(REMOTING__NAMES[0], true, deser, value.avg);
+		TypeDeserializer<int >::deserialize(REMOTING__NAMES[1], true, deser, value.count);
+		TypeDeserializer<double >::deserialize(REMOTING__NAMES[2], true, deser, value.max);
+		TypeDeserializer<double >::deserialize(REMOTING__NAMES[3], true, deser, value.min);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[4], true, deser, value.start);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeDeserializer_IoT_Historian_SampleBucket_INCLUDED
+
@@ -0,0 +1,60 @@
+//
+// SampleBucketSerializer.h
+//
+// Package: Generated
+// Module:  TypeSerializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeSerializer_IoT_Historian_SampleBucket_INCLUDED
+#define TypeSerializer_IoT_Historian_SampleBucket_INCLUDED
+
+
+#include "IoT/Historian/HistorianService.h"
+#include "Poco/RemotingNG/TypeSerializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeSerializer<IoT::Historian::SampleBucket>
+{
+public:
+	static void serialize(const std::string& name, const IoT::Historian::SampleBucket& value, Serializer& ser)
+	{
+		ser.serializeStructBegin(name);
+		serializeImpl(value, ser);
+		ser.serializeStructEnd(name);
+	}
+
+	static void serializeImpl(const IoT::Historian::SampleBucket& value, Serializer& ser)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"avg","count","max","min","start",""};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeSerializer<double >::serialize(REMOTING__NAMES[0], value.avg, ser);
+		TypeSerializer<int >::serialize(REMOTING__NAMES[1], value.count, ser);
+		TypeSerializer<double >::serialize(REMOTING__NAMES[2], value.max, ser);
+		TypeSerializer<double >::serialize(REMOTING__NAMES[3], value.min, ser);
+		TypeSerializer<Poco::Int64 >::serialize(REMOTING__NAMES[4], value.start, ser);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeSerializer_IoT_Historian_SampleBucket_INCLUDED
+
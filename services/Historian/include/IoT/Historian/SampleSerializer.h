@@ -0,0 +1,57 @@
+//
+// SampleSerializer.h
+//
+// Package: Generated
+// Module:  TypeSerializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeSerializer_IoT_Historian_Sample_INCLUDED
+#define TypeSerializer_IoT_Historian_Sample_INCLUDED
+
+
+#include "IoT/Historian/HistorianService.h"
+#include "Poco/RemotingNG/TypeSerializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeSerializer<IoT::Historian::Sample>
+{
+public:
+	static void serialize(const std::string& name, const IoT::Historian::Sample& value, Serializer& ser)
+	{
+		ser.serializeStructBegin(name);
+		serializeImpl(value, ser);
+		ser.serializeStructEnd(name);
+	}
+
+	static void serializeImpl(const IoT::Historian::Sample& value, Serializer& ser)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"timestamp","value",""};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeSerializer<Poco::Int64 >::serialize(REMOTING__NAMES[0], value.timestamp, ser);
+		TypeSerializer<double >::serialize(REMOTING__NAMES[1], value.value, ser);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeSerializer_IoT_Historian_Sample_INCLUDED
+
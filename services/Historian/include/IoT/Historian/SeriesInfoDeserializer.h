@@ -0,0 +1,65 @@
+//
+// SeriesInfoDeserializer.h
+//
+// Package: Generated
+// Module:  TypeDeserializer
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef TypeDeserializer_IoT_Historian_SeriesInfo_INCLUDED
+#define TypeDeserializer_IoT_Historian_SeriesInfo_INCLUDED
+
+
+#include "IoT/Historian/HistorianService.h"
+#include "Poco/RemotingNG/TypeDeserializer.h"
+
+
+namespace Poco {
+namespace RemotingNG {
+
+
+template <>
+class TypeDeserializer<IoT::Historian::SeriesInfo>
+{
+public:
+	static bool deserialize(const std::string& name, bool isMandatory, Deserializer& deser, IoT::Historian::SeriesInfo& value)
+	{
+		bool ret = deser.deserializeStructBegin(name, isMandatory);
+		if (ret)
+		{
+			deserializeImpl(deser, value);
+			deser.deserializeStructEnd(name);
+		}
+		return ret;
+	}
+
+	static void deserializeImpl(Deserializer& deser, IoT::Historian::SeriesInfo& value)
+	{
+		remoting__staticInitBegin(REMOTING__NAMES);
+		static const std::string REMOTING__NAMES[] = {"capacity","device","firstTimestamp","lastTimestamp","name","sampleCount"};
+		remoting__staticInitEnd(REMOTING__NAMES);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[0], true, deser, value.capacity);
+		TypeDeserializer<std::string >::deserialize(REMOTING__NAMES[1], true, deser, value.device);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[2], true, deser, value.firstTimestamp);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[3], true, deser, value.lastTimestamp);
+		TypeDeserializer<std::string >::deserialize(REMOTING__NAMES[4], true, deser, value.name);
+		TypeDeserializer<Poco::Int64 >::deserialize(REMOTING__NAMES[5], true, deser, value.sampleCount);
+	}
+
+};
+
+
+} // namespace RemotingNG
+} // namespace Poco
+
+
+#endif // TypeDeserializer_IoT_Historian_SeriesInfo_INCLUDED
+
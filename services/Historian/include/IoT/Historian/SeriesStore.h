@@ -0,0 +1,136 @@
+//
+// SeriesStore.h
+//
+// $Id$
+//
+// Library: IoT/Historian
+// Package: Historian
+// Module:  SeriesStore
+//
+// Definition of the SeriesStore class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Historian_SeriesStore_INCLUDED
+#define IoT_Historian_SeriesStore_INCLUDED
+
+
+#include "IoT/Historian/HistorianService.h"
+#include "Poco/SharedMemory.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Mutex.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+class IoTHistorian_API SeriesStore
+	/// SeriesStore keeps the samples of a single time series in a
+	/// memory-mapped file.
+	///
+	/// The file consists of a header, followed by a ring of fixed-size
+	/// blocks. Each block holds a compressed run of samples, with
+	/// timestamps and values stored in separate columns within the block.
+	/// Timestamps are encoded as delta-of-delta, values are XORed
+	/// with their predecessor, and only the meaningful bits are stored
+	/// (Gorilla-style encoding). Regularly sampled, slowly changing
+	/// sensor values typically need only a few bits per sample.
+	///
+	/// When the current block is full, the next block in the ring
+	/// is reset and used, discarding the oldest samples.
+{
+public:
+	typedef Poco::SharedPtr<SeriesStore> Ptr;
+
+	enum
+	{
+		DEFAULT_BLOCK_SIZE  = 4096,
+		DEFAULT_BLOCK_COUNT = 256
+	};
+
+	SeriesStore(const std::string& path, Poco::UInt32 blockSize = DEFAULT_BLOCK_SIZE, Poco::UInt32 blockCount = DEFAULT_BLOCK_COUNT);
+		/// Creates or opens the SeriesStore backed by the file with the given path.
+		///
+		/// If the file already exists, it is opened and blockSize and
+		/// blockCount are taken from the file. Otherwise, a new file
+		/// is created.
+
+	~SeriesStore();
+		/// Destroys the SeriesStore and unmaps the file.
+
+	bool append(Poco::Int64 timestamp, double value);
+		/// Appends a sample and returns true. If the timestamp is older
+		/// than the newest sample, the sample is discarded and false
+		/// is returned.
+
+	void samples(Poco::Int64 from, Poco::Int64 to, std::size_t maxSamples, std::vector<Sample>& result) const;
+		/// Appends all samples in the interval [from, to] to result,
+		/// but at most maxSamples (if maxSamples > 0).
+
+	void downsample(Poco::Int64 from, Poco::Int64 to, Poco::Int64 interval, std::vector<SampleBucket>& result) const;
+		/// Aggregates all samples in the interval [from, to] into buckets
+		/// of the given interval and appends non-empty buckets to result.
+
+	void info(SeriesInfo& info) const;
+		/// Fills in the statistics fields of info.
+
+	const std::string& path() const;
+		/// Returns the path of the backing file.
+
+protected:
+	struct FileHeader;
+	struct BlockHeader;
+	class BitWriter;
+	class BitReader;
+	class BlockDecoder;
+
+	BlockHeader* block(Poco::UInt32 index) const;
+	char* timeColumn(BlockHeader* pBlock) const;
+	char* valueColumn(BlockHeader* pBlock) const;
+	Poco::UInt32 columnBits() const;
+	void resetBlock(BlockHeader* pBlock, Poco::UInt32 sequence);
+	void restoreState();
+	bool appendToBlock(BlockHeader* pBlock, Poco::Int64 timestamp, double value);
+
+	template <class Visitor>
+	void visit(Poco::Int64 from, Poco::Int64 to, Visitor& visitor) const;
+
+private:
+	SeriesStore();
+	SeriesStore(const SeriesStore&);
+	SeriesStore& operator = (const SeriesStore&);
+
+	std::string _path;
+	Poco::SharedMemory _memory;
+	FileHeader* _pHeader;
+
+	// encoder state for the current block
+	Poco::Int64 _prevTimestamp;
+	Poco::Int64 _prevDelta;
+	Poco::UInt64 _prevValue;
+	int _prevLeading;
+	int _prevTrailing;
+
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline const std::string& SeriesStore::path() const
+{
+	return _path;
+}
+
+
+} } // namespace IoT::Historian
+
+
+#endif // IoT_Historian_SeriesStore_INCLUDED
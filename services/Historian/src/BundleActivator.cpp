@@ -0,0 +1,74 @@
+//
+// BundleActivator.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "HistorianServiceImpl.h"
+#include "IoT/Historian/HistorianServiceServerHelper.h"
+#include "Poco/OSP/BundleActivator.h"
+#include "Poco/OSP/BundleContext.h"
+#include "Poco/OSP/Bundle.h"
+#include "Poco/OSP/ServiceRegistry.h"
+#include "Poco/OSP/ServiceRef.h"
+#include "Poco/ClassLibrary.h"
+
+
+using Poco::OSP::BundleContext;
+using Poco::OSP::ServiceRegistry;
+using Poco::OSP::ServiceRef;
+using Poco::OSP::Properties;
+
+
+namespace IoT {
+namespace Historian {
+
+
+class BundleActivator: public Poco::OSP::BundleActivator
+{
+public:
+	BundleActivator()
+	{
+	}
+	
+	~BundleActivator()
+	{
+	}
+
+	void start(BundleContext::Ptr pContext)
+	{
+		typedef Poco::RemotingNG::ServerHelper<IoT::Historian::HistorianService> ServerHelper;
+
+		_pHistorianService = new HistorianServiceImpl(pContext);
+		_pHistorianService->start();
+		std::string oid("io.macchina.services.historian");
+		ServerHelper::RemoteObjectPtr pHistorianServiceRemoteObject = ServerHelper::createRemoteObject(_pHistorianService, oid);
+		_pServiceRef = pContext->registry().registerService(oid, pHistorianServiceRemoteObject, Properties());
+	}
+		
+	void stop(BundleContext::Ptr pContext)
+	{
+		pContext->registry().unregisterService(_pServiceRef);
+		_pServiceRef = 0;
+		_pHistorianService->stop();
+		_pHistorianService = 0;
+	}
+
+private:
+	Poco::SharedPtr<HistorianServiceImpl> _pHistorianService;
+	Poco::OSP::ServiceRef::Ptr _pServiceRef;
+};
+
+
+} } // namespace IoT::Historian
+
+
+POCO_BEGIN_MANIFEST(Poco::OSP::BundleActivator)
+	POCO_EXPORT_CLASS(IoT::Historian::BundleActivator)
+POCO_END_MANIFEST
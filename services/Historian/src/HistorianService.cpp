@@ -0,0 +1,34 @@
+//
+// HistorianService.cpp
+//
+// $Id$
+//
+// Library: IoT/Historian
+// Package: HistorianService
+// Module:  HistorianService
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Historian/HistorianService.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+HistorianService::HistorianService()
+{
+}
+
+	
+HistorianService::~HistorianService()
+{
+}
+
+
+} } // namespace IoT::Historian
@@ -0,0 +1,306 @@
+//
+// HistorianServiceImpl.cpp
+//
+// $Id$
+//
+// Library: IoT/Historian
+// Package: HistorianServiceImpl
+// Module:  HistorianServiceImpl
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "HistorianServiceImpl.h"
+#include "Poco/OSP/ServiceRegistry.h"
+#include "Poco/OSP/ServiceFinder.h"
+#include "Poco/OSP/PreferencesService.h"
+#include "Poco/Util/AbstractConfiguration.h"
+#include "Poco/Delegate.h"
+#include "Poco/Timestamp.h"
+#include "Poco/File.h"
+#include "Poco/Path.h"
+#include "Poco/Exception.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+//
+// HistorianServiceImpl::Recorder
+//
+
+
+HistorianServiceImpl::Recorder::Recorder(const std::string& name, const std::string& device, SeriesStore::Ptr pStore):
+	_name(name),
+	_device(device),
+	_pStore(pStore)
+{
+}
+
+
+HistorianServiceImpl::Recorder::~Recorder()
+{
+	try
+	{
+		detach();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void HistorianServiceImpl::Recorder::attach(Poco::OSP::Service::Ptr pService)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_pSensor || _pIO) return;
+
+	if (pService->isA(typeid(IoT::Devices::ISensor)))
+	{
+		_pSensor = pService.cast<IoT::Devices::ISensor>();
+		_pSensor->valueChanged += Poco::delegate(this, &Recorder::onValueChanged);
+	}
+	else if (pService->isA(typeid(IoT::Devices::IIO)))
+	{
+		_pIO = pService.cast<IoT::Devices::IIO>();
+		_pIO->stateChanged += Poco::delegate(this, &Recorder::onStateChanged);
+	}
+	else throw Poco::InvalidArgumentException("Device is neither a Sensor nor an IO", _device);
+}
+
+
+void HistorianServiceImpl::Recorder::detach()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_pSensor)
+	{
+		_pSensor->valueChanged -= Poco::delegate(this, &Recorder::onValueChanged);
+		_pSensor = 0;
+	}
+	if (_pIO)
+	{
+		_pIO->stateChanged -= Poco::delegate(this, &Recorder::onStateChanged);
+		_pIO = 0;
+	}
+}
+
+
+const std::string& HistorianServiceImpl::Recorder::name() const
+{
+	return _name;
+}
+
+
+const std::string& HistorianServiceImpl::Recorder::device() const
+{
+	return _device;
+}
+
+
+SeriesStore::Ptr HistorianServiceImpl::Recorder::store() const
+{
+	return _pStore;
+}
+
+
+void HistorianServiceImpl::Recorder::onValueChanged(const double& value)
+{
+	_pStore->append(HistorianServiceImpl::now(), value);
+}
+
+
+void HistorianServiceImpl::Recorder::onStateChanged(const bool& state)
+{
+	_pStore->append(HistorianServiceImpl::now(), state ? 1.0 : 0.0);
+}
+
+
+//
+// HistorianServiceImpl
+//
+
+
+HistorianServiceImpl::HistorianServiceImpl(Poco::OSP::BundleContext::Ptr pContext):
+	_pContext(pContext),
+	_logger(Poco::Logger::get("IoT.Historian"))
+{
+	Poco::OSP::PreferencesService::Ptr pPrefs = Poco::OSP::ServiceFinder::find<Poco::OSP::PreferencesService>(pContext);
+	Poco::AutoPtr<Poco::Util::AbstractConfiguration> pConfig = pPrefs->configuration();
+
+	Poco::Path dataDir(pContext->persistentDirectory());
+	dataDir.makeDirectory();
+	Poco::File(dataDir).createDirectories();
+
+	Poco::Util::AbstractConfiguration::Keys keys;
+	pConfig->keys("historian.series", keys);
+	for (Poco::Util::AbstractConfiguration::Keys::const_iterator it = keys.begin(); it != keys.end(); ++it)
+	{
+		std::string baseKey = "historian.series.";
+		baseKey += *it;
+
+		std::string device = pConfig->getString(baseKey + ".device", "");
+		Poco::UInt32 blockSize = pConfig->getUInt(baseKey + ".blockSize", SeriesStore::DEFAULT_BLOCK_SIZE);
+		Poco::UInt32 blockCount = pConfig->getUInt(baseKey + ".blockCount", SeriesStore::DEFAULT_BLOCK_COUNT);
+
+		Poco::Path path(dataDir);
+		path.setFileName(*it + ".series");
+		try
+		{
+			SeriesStore::Ptr pStore = new SeriesStore(path.toString(), blockSize, blockCount);
+			_recorders[*it] = new Recorder(*it, device, pStore);
+		}
+		catch (Poco::Exception& exc)
+		{
+			_logger.error("Cannot open series %s: %s", *it, exc.displayText());
+		}
+	}
+}
+
+
+HistorianServiceImpl::~HistorianServiceImpl()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void HistorianServiceImpl::start()
+{
+	for (RecorderMap::iterator it = _recorders.begin(); it != _recorders.end(); ++it)
+	{
+		const std::string& device = it->second->device();
+		if (device.empty()) continue;
+
+		Poco::OSP::ServiceRef::ConstPtr pServiceRef = _pContext->registry().findByName(device);
+		if (pServiceRef)
+		{
+			try
+			{
+				it->second->attach(pServiceRef->instance());
+			}
+			catch (Poco::Exception& exc)
+			{
+				_logger.error("Cannot record series %s: %s", it->first, exc.displayText());
+			}
+		}
+	}
+	_pContext->registry().serviceRegistered   += Poco::delegate(this, &HistorianServiceImpl::onServiceRegistered);
+	_pContext->registry().serviceUnregistered += Poco::delegate(this, &HistorianServiceImpl::onServiceUnregistered);
+}
+
+
+void HistorianServiceImpl::stop()
+{
+	_pContext->registry().serviceRegistered   -= Poco::delegate(this, &HistorianServiceImpl::onServiceRegistered);
+	_pContext->registry().serviceUnregistered -= Poco::delegate(this, &HistorianServiceImpl::onServiceUnregistered);
+
+	for (RecorderMap::iterator it = _recorders.begin(); it != _recorders.end(); ++it)
+	{
+		it->second->detach();
+	}
+}
+
+
+std::vector<SeriesInfo> HistorianServiceImpl::series() const
+{
+	std::vector<SeriesInfo> result;
+	for (RecorderMap::const_iterator it = _recorders.begin(); it != _recorders.end(); ++it)
+	{
+		SeriesInfo info;
+		info.name   = it->second->name();
+		info.device = it->second->device();
+		it->second->store()->info(info);
+		result.push_back(info);
+	}
+	return result;
+}
+
+
+void HistorianServiceImpl::append(const std::string& series, Poco::Int64 timestamp, double value)
+{
+	if (timestamp == 0) timestamp = now();
+	if (!findRecorder(series)->store()->append(timestamp, value))
+		throw Poco::InvalidArgumentException("Sample is older than newest sample in series", series);
+}
+
+
+std::vector<Sample> HistorianServiceImpl::samples(const std::string& series, Poco::Int64 from, Poco::Int64 to, int maxSamples) const
+{
+	std::vector<Sample> result;
+	findRecorder(series)->store()->samples(from, to, maxSamples > 0 ? maxSamples : 0, result);
+	return result;
+}
+
+
+std::vector<SampleBucket> HistorianServiceImpl::downsample(const std::string& series, Poco::Int64 from, Poco::Int64 to, Poco::Int64 interval) const
+{
+	std::vector<SampleBucket> result;
+	findRecorder(series)->store()->downsample(from, to, interval, result);
+	return result;
+}
+
+
+HistorianServiceImpl::Recorder::Ptr HistorianServiceImpl::findRecorder(const std::string& series) const
+{
+	RecorderMap::const_iterator it = _recorders.find(series);
+	if (it != _recorders.end())
+		return it->second;
+	else
+		throw Poco::NotFoundException("series", series);
+}
+
+
+void HistorianServiceImpl::onServiceRegistered(const void* pSender, Poco::OSP::ServiceEvent& event)
+{
+	const std::string& name = event.service()->name();
+	for (RecorderMap::iterator it = _recorders.begin(); it != _recorders.end(); ++it)
+	{
+		if (it->second->device() == name)
+		{
+			try
+			{
+				it->second->attach(event.service()->instance());
+			}
+			catch (Poco::Exception& exc)
+			{
+				_logger.error("Cannot record series %s: %s", it->first, exc.displayText());
+			}
+		}
+	}
+}
+
+
+void HistorianServiceImpl::onServiceUnregistered(const void* pSender, Poco::OSP::ServiceEvent& event)
+{
+	const std::string& name = event.service()->name();
+	for (RecorderMap::iterator it = _recorders.begin(); it != _recorders.end(); ++it)
+	{
+		if (it->second->device() == name)
+		{
+			it->second->detach();
+		}
+	}
+}
+
+
+Poco::Int64 HistorianServiceImpl::now()
+{
+	return Poco::Timestamp().epochMicroseconds()/1000;
+}
+
+
+} } // namespace IoT::Historian
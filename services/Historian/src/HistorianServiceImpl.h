@@ -0,0 +1,124 @@
+//
+// HistorianServiceImpl.h
+//
+// $Id$
+//
+// Library: IoT/Historian
+// Package: HistorianServiceImpl
+// Module:  HistorianServiceImpl
+//
+// Definition of the HistorianServiceImpl class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef IoT_Historian_HistorianServiceImpl_INCLUDED
+#define IoT_Historian_HistorianServiceImpl_INCLUDED
+
+
+#include "IoT/Historian/HistorianService.h"
+#include "IoT/Historian/SeriesStore.h"
+#include "IoT/Devices/ISensor.h"
+#include "IoT/Devices/IIO.h"
+#include "Poco/OSP/BundleContext.h"
+#include "Poco/OSP/ServiceEvent.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Logger.h"
+#include "Poco/Mutex.h"
+#include <map>
+
+
+namespace IoT {
+namespace Historian {
+
+
+class HistorianServiceImpl: public HistorianService
+	/// Default implementation of the HistorianService.
+	///
+	/// Series are configured in the application configuration,
+	/// using the following properties:
+	///
+	///   historian.series.<name>.device     = <device service name>
+	///   historian.series.<name>.blockSize  = <bytes per block> (default 4096)
+	///   historian.series.<name>.blockCount = <number of blocks> (default 256)
+	///
+	/// The device property is optional. If given, the series records
+	/// the valueChanged events of the given Sensor, or the stateChanged
+	/// events of the given IO (as 0 or 1). Devices may be registered
+	/// after the historian has been started.
+	///
+	/// Series files are kept in the bundle's persistent directory.
+{
+public:
+	HistorianServiceImpl(Poco::OSP::BundleContext::Ptr pContext);
+		/// Creates the HistorianServiceImpl and opens all configured series.
+
+	~HistorianServiceImpl();
+		/// Destroys the HistorianServiceImpl.
+
+	void start();
+		/// Subscribes to the events of all configured devices
+		/// and starts watching for newly registered devices.
+
+	void stop();
+		/// Unsubscribes from all device events.
+
+	// HistorianService
+	std::vector<SeriesInfo> series() const;
+	void append(const std::string& series, Poco::Int64 timestamp, double value);
+	std::vector<Sample> samples(const std::string& series, Poco::Int64 from, Poco::Int64 to, int maxSamples) const;
+	std::vector<SampleBucket> downsample(const std::string& series, Poco::Int64 from, Poco::Int64 to, Poco::Int64 interval) const;
+
+protected:
+	class Recorder
+		/// Records the events of a single device into a SeriesStore.
+	{
+	public:
+		typedef Poco::SharedPtr<Recorder> Ptr;
+
+		Recorder(const std::string& name, const std::string& device, SeriesStore::Ptr pStore);
+		~Recorder();
+
+		void attach(Poco::OSP::Service::Ptr pService);
+		void detach();
+
+		const std::string& name() const;
+		const std::string& device() const;
+		SeriesStore::Ptr store() const;
+
+	protected:
+		void onValueChanged(const double& value);
+		void onStateChanged(const bool& state);
+
+	private:
+		std::string _name;
+		std::string _device;
+		SeriesStore::Ptr _pStore;
+		IoT::Devices::ISensor::Ptr _pSensor;
+		IoT::Devices::IIO::Ptr _pIO;
+		Poco::FastMutex _mutex;
+	};
+
+	typedef std::map<std::string, Recorder::Ptr> RecorderMap;
+
+	Recorder::Ptr findRecorder(const std::string& series) const;
+	void onServiceRegistered(const void* pSender, Poco::OSP::ServiceEvent& event);
+	void onServiceUnregistered(const void* pSender, Poco::OSP::ServiceEvent& event);
+
+	static Poco::Int64 now();
+
+private:
+	Poco::OSP::BundleContext::Ptr _pContext;
+	RecorderMap _recorders;
+	Poco::Logger& _logger;
+};
+
+
+} } // namespace IoT::Historian
+
+
+#endif // IoT_Historian_HistorianServiceImpl_INCLUDED
@@ -0,0 +1,47 @@
+//
+// HistorianServiceRemoteObject.cpp
+//
+// Library: IoT/Historian
+// Package: Generated
+// Module:  HistorianServiceRemoteObject
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Historian/HistorianServiceRemoteObject.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+HistorianServiceRemoteObject::HistorianServiceRemoteObject(const Poco::RemotingNG::Identifiable::ObjectId& oid, Poco::SharedPtr<IoT::Historian::HistorianService> pServiceObject):
+	IoT::Historian::IHistorianService(),
+	Poco::RemotingNG::RemoteObject(oid),
+	_pServiceObject(pServiceObject)
+{
+}
+
+
+HistorianServiceRemoteObject::~HistorianServiceRemoteObject()
+{
+	try
+	{
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+} // namespace Historian
+} // namespace IoT
+
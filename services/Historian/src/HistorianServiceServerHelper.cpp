@@ -0,0 +1,87 @@
+//
+// HistorianServiceServerHelper.cpp
+//
+// Library: IoT/Historian
+// Package: Generated
+// Module:  HistorianServiceServerHelper
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Historian/HistorianServiceServerHelper.h"
+#include "IoT/Historian/HistorianServiceSkeleton.h"
+#include "Poco/RemotingNG/URIUtility.h"
+#include "Poco/SingletonHolder.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+namespace
+{
+	static Poco::SingletonHolder<HistorianServiceServerHelper> shHistorianServiceServerHelper;
+}
+
+
+HistorianServiceServerHelper::HistorianServiceServerHelper():
+	_pORB(0)
+{
+	_pORB = &Poco::RemotingNG::ORB::instance();
+	_pORB->registerSkeleton("IoT.Historian.HistorianService", new HistorianServiceSkeleton);
+}
+
+
+HistorianServiceServerHelper::~HistorianServiceServerHelper()
+{
+	try
+	{
+		_pORB->unregisterSkeleton("IoT.Historian.HistorianService", true);
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+std::string HistorianServiceServerHelper::registerRemoteObject(Poco::AutoPtr<IoT::Historian::HistorianServiceRemoteObject> pRemoteObject, const std::string& listenerId)
+{
+	return HistorianServiceServerHelper::instance().registerObjectImpl(pRemoteObject, listenerId);
+}
+
+
+Poco::AutoPtr<IoT::Historian::HistorianServiceRemoteObject> HistorianServiceServerHelper::createRemoteObjectImpl(Poco::SharedPtr<IoT::Historian::HistorianService> pServiceObject, const Poco::RemotingNG::Identifiable::ObjectId& oid)
+{
+	return new HistorianServiceRemoteObject(oid, pServiceObject);
+}
+
+
+HistorianServiceServerHelper& HistorianServiceServerHelper::instance()
+{
+	return *shHistorianServiceServerHelper.get();
+}
+
+
+std::string HistorianServiceServerHelper::registerObjectImpl(Poco::AutoPtr<IoT::Historian::HistorianServiceRemoteObject> pRemoteObject, const std::string& listenerId)
+{
+	return _pORB->registerObject(pRemoteObject, listenerId);
+}
+
+
+void HistorianServiceServerHelper::unregisterObjectImpl(const std::string& uri)
+{
+	_pORB->unregisterObject(uri);
+}
+
+
+} // namespace Historian
+} // namespace IoT
+
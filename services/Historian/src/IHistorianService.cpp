@@ -0,0 +1,61 @@
+//
+// IHistorianService.cpp
+//
+// Library: IoT/Historian
+// Package: Generated
+// Module:  IHistorianService
+//
+// This file has been generated.
+// Warning: All changes to this will be lost when the file is re-generated.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+// 
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Historian/IHistorianService.h"
+
+
+namespace IoT {
+namespace Historian {
+
+
+IHistorianService::IHistorianService():
+	Poco::OSP::Service()
+
+{
+}
+
+
+IHistorianService::~IHistorianService()
+{
+}
+
+
+bool IHistorianService::isA(const std::type_info& otherType) const
+{
+	std::string name(type().name());
+	return name == otherType.name();
+}
+
+
+const Poco::RemotingNG::Identifiable::TypeId& IHistorianService::remoting__typeId()
+{
+	remoting__staticInitBegin(REMOTING__TYPE_ID);
+	static const std::string REMOTING__TYPE_ID("IoT.Historian.HistorianService");
+	remoting__staticInitEnd(REMOTING__TYPE_ID);
+	return REMOTING__TYPE_ID;
+}
+
+
+const std::type_info& IHistorianService::type() const
+{
+	return typeid(IHistorianService);
+}
+
+
+} // namespace Historian
+} // namespace IoT
+
@@ -0,0 +1,617 @@
+//
+// SeriesStore.cpp
+//
+// $Id$
+//
+// Library: IoT/Historian
+// Package: Historian
+// Module:  SeriesStore
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "IoT/Historian/SeriesStore.h"
+#include "Poco/File.h"
+#include "Poco/Exception.h"
+#include <cstring>
+
+
+namespace IoT {
+namespace Historian {
+
+
+namespace
+{
+	const char MAGIC[8] = {'M', 'I', 'O', 'H', 'I', 'S', 'T', '1'};
+	const Poco::UInt32 VERSION = 1;
+	const std::size_t HEADER_SIZE = 64;
+	const std::size_t BLOCK_HEADER_SIZE = 32;
+	const Poco::UInt32 MIN_BLOCK_SIZE = 256;
+	const Poco::UInt32 MAX_TIME_BITS = 68;
+	const Poco::UInt32 MAX_VALUE_BITS = 77;
+
+	inline Poco::UInt64 doubleBits(double value)
+	{
+		Poco::UInt64 bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	inline double bitsDouble(Poco::UInt64 bits)
+	{
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	inline int leadingZeros(Poco::UInt64 v)
+	{
+		int n = 0;
+		for (Poco::UInt64 mask = Poco::UInt64(1) << 63; mask && !(v & mask); mask >>= 1) n++;
+		return n;
+	}
+
+	inline int trailingZeros(Poco::UInt64 v)
+	{
+		int n = 0;
+		for (Poco::UInt64 mask = 1; mask && !(v & mask); mask <<= 1) n++;
+		return n;
+	}
+}
+
+
+struct SeriesStore::FileHeader
+{
+	char magic[8];
+	Poco::UInt32 version;
+	Poco::UInt32 blockSize;
+	Poco::UInt32 blockCount;
+	Poco::UInt32 currentBlock;
+	Poco::UInt32 sequence;
+	Poco::UInt32 reserved[9];
+};
+
+
+struct SeriesStore::BlockHeader
+{
+	Poco::Int64 firstTimestamp;
+	Poco::Int64 lastTimestamp;
+	Poco::UInt32 sequence;
+	Poco::UInt32 count;
+	Poco::UInt32 timeBits;
+	Poco::UInt32 valueBits;
+};
+
+
+class SeriesStore::BitWriter
+	/// Appends bits (MSB first) to a column, starting at a given bit position.
+{
+public:
+	BitWriter(char* pColumn, Poco::UInt32& bits):
+		_pColumn(reinterpret_cast<unsigned char*>(pColumn)),
+		_bits(bits)
+	{
+	}
+
+	void write(Poco::UInt64 value, int nBits)
+	{
+		while (nBits > 0)
+		{
+			Poco::UInt32 byteIndex = _bits >> 3;
+			int bitOffset = _bits & 7;
+			int free = 8 - bitOffset;
+			int n = nBits < free ? nBits : free;
+			unsigned char chunk = static_cast<unsigned char>((value >> (nBits - n)) & ((1u << n) - 1));
+			if (bitOffset == 0) _pColumn[byteIndex] = 0;
+			_pColumn[byteIndex] |= static_cast<unsigned char>(chunk << (free - n));
+			nBits -= n;
+			_bits += n;
+		}
+	}
+
+	void writeBit(bool bit)
+	{
+		write(bit ? 1 : 0, 1);
+	}
+
+private:
+	unsigned char* _pColumn;
+	Poco::UInt32& _bits;
+};
+
+
+class SeriesStore::BitReader
+	/// Reads bits (MSB first) from a column.
+{
+public:
+	BitReader(const char* pColumn):
+		_pColumn(reinterpret_cast<const unsigned char*>(pColumn)),
+		_pos(0)
+	{
+	}
+
+	Poco::UInt64 read(int nBits)
+	{
+		Poco::UInt64 value = 0;
+		while (nBits > 0)
+		{
+			int bitOffset = _pos & 7;
+			int avail = 8 - bitOffset;
+			int n = nBits < avail ? nBits : avail;
+			unsigned char byte = _pColumn[_pos >> 3];
+			value = (value << n) | ((byte >> (avail - n)) & ((1u << n) - 1));
+			nBits -= n;
+			_pos += n;
+		}
+		return value;
+	}
+
+	bool readBit()
+	{
+		return read(1) != 0;
+	}
+
+private:
+	const unsigned char* _pColumn;
+	Poco::UInt32 _pos;
+};
+
+
+class SeriesStore::BlockDecoder
+	/// Decodes the samples stored in a block, and keeps
+	/// track of the encoder state.
+{
+public:
+	BlockDecoder(const BlockHeader* pBlock, const char* pTimeColumn, const char* pValueColumn):
+		_pBlock(pBlock),
+		_timeReader(pTimeColumn),
+		_valueReader(pValueColumn),
+		_index(0),
+		_timestamp(0),
+		_delta(0),
+		_value(0),
+		_leading(-1),
+		_trailing(0)
+	{
+	}
+
+	bool next(Poco::Int64& timestamp, double& value)
+	{
+		if (_index >= _pBlock->count) return false;
+
+		if (_index == 0)
+		{
+			_timestamp = _pBlock->firstTimestamp;
+			_value = _valueReader.read(64);
+		}
+		else
+		{
+			Poco::Int64 dod;
+			if (!_timeReader.readBit())
+				dod = 0;
+			else if (!_timeReader.readBit())
+				dod = static_cast<Poco::Int64>(_timeReader.read(7)) - 63;
+			else if (!_timeReader.readBit())
+				dod = static_cast<Poco::Int64>(_timeReader.read(9)) - 255;
+			else if (!_timeReader.readBit())
+				dod = static_cast<Poco::Int64>(_timeReader.read(12)) - 2047;
+			else
+				dod = static_cast<Poco::Int64>(_timeReader.read(64));
+			_delta += dod;
+			_timestamp += _delta;
+
+			if (_valueReader.readBit())
+			{
+				if (_valueReader.readBit())
+				{
+					_leading = static_cast<int>(_valueReader.read(5));
+					int meaningful = static_cast<int>(_valueReader.read(6)) + 1;
+					_trailing = 64 - _leading - meaningful;
+				}
+				int meaningful = 64 - _leading - _trailing;
+				_value ^= _valueReader.read(meaningful) << _trailing;
+			}
+		}
+		_index++;
+		timestamp = _timestamp;
+		value = bitsDouble(_value);
+		return true;
+	}
+
+	Poco::Int64 timestamp() const
+	{
+		return _timestamp;
+	}
+
+	Poco::Int64 delta() const
+	{
+		return _delta;
+	}
+
+	Poco::UInt64 valueBits() const
+	{
+		return _value;
+	}
+
+	int leading() const
+	{
+		return _leading;
+	}
+
+	int trailing() const
+	{
+		return _trailing;
+	}
+
+private:
+	const BlockHeader* _pBlock;
+	BitReader _timeReader;
+	BitReader _valueReader;
+	Poco::UInt32 _index;
+	Poco::Int64 _timestamp;
+	Poco::Int64 _delta;
+	Poco::UInt64 _value;
+	int _leading;
+	int _trailing;
+};
+
+
+SeriesStore::SeriesStore(const std::string& path, Poco::UInt32 blockSize, Poco::UInt32 blockCount):
+	_path(path),
+	_pHeader(0),
+	_prevTimestamp(0),
+	_prevDelta(0),
+	_prevValue(0),
+	_prevLeading(-1),
+	_prevTrailing(0)
+{
+	poco_assert (sizeof(FileHeader) == HEADER_SIZE);
+	poco_assert (sizeof(BlockHeader) == BLOCK_HEADER_SIZE);
+
+	Poco::File file(path);
+	bool created = false;
+	if (!file.exists())
+	{
+		if (blockSize < MIN_BLOCK_SIZE) blockSize = MIN_BLOCK_SIZE;
+		blockSize = (blockSize + 7) & ~7u;
+		if (blockCount < 2) blockCount = 2;
+		file.createFile();
+		file.setSize(HEADER_SIZE + static_cast<Poco::UInt64>(blockSize)*blockCount);
+		created = true;
+	}
+	Poco::SharedMemory memory(file, Poco::SharedMemory::AM_WRITE);
+	_memory.swap(memory);
+	if (static_cast<std::size_t>(_memory.end() - _memory.begin()) < HEADER_SIZE)
+		throw Poco::DataFormatException("Not a valid historian series file", path);
+	_pHeader = reinterpret_cast<FileHeader*>(_memory.begin());
+	if (created)
+	{
+		std::memset(_memory.begin(), 0, _memory.end() - _memory.begin());
+		std::memcpy(_pHeader->magic, MAGIC, sizeof(MAGIC));
+		_pHeader->version      = VERSION;
+		_pHeader->blockSize    = blockSize;
+		_pHeader->blockCount   = blockCount;
+		_pHeader->currentBlock = 0;
+		_pHeader->sequence     = 1;
+		block(0)->sequence     = 1;
+	}
+	else
+	{
+		if (std::memcmp(_pHeader->magic, MAGIC, sizeof(MAGIC)) != 0 || _pHeader->version != VERSION)
+			throw Poco::DataFormatException("Not a valid historian series file", path);
+		if (_pHeader->blockSize < MIN_BLOCK_SIZE || _pHeader->blockCount < 2 || _pHeader->currentBlock >= _pHeader->blockCount
+			|| static_cast<Poco::UInt64>(_memory.end() - _memory.begin()) < HEADER_SIZE + static_cast<Poco::UInt64>(_pHeader->blockSize)*_pHeader->blockCount)
+			throw Poco::DataFormatException("Corrupt historian series file", path);
+		restoreState();
+	}
+}
+
+
+SeriesStore::~SeriesStore()
+{
+}
+
+
+bool SeriesStore::append(Poco::Int64 timestamp, double value)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	BlockHeader* pBlock = block(_pHeader->currentBlock);
+	if (pBlock->count > 0 && timestamp < pBlock->lastTimestamp) return false;
+
+	if (!appendToBlock(pBlock, timestamp, value))
+	{
+		Poco::UInt32 next = (_pHeader->currentBlock + 1) % _pHeader->blockCount;
+		pBlock = block(next);
+		resetBlock(pBlock, _pHeader->sequence + 1);
+		_pHeader->sequence++;
+		_pHeader->currentBlock = next;
+		appendToBlock(pBlock, timestamp, value);
+	}
+	return true;
+}
+
+
+bool SeriesStore::appendToBlock(BlockHeader* pBlock, Poco::Int64 timestamp, double value)
+{
+	Poco::UInt64 bits = doubleBits(value);
+	if (pBlock->count == 0)
+	{
+		BitWriter valueWriter(valueColumn(pBlock), pBlock->valueBits);
+		valueWriter.write(bits, 64);
+		pBlock->firstTimestamp = timestamp;
+		_prevDelta    = 0;
+		_prevLeading  = -1;
+		_prevTrailing = 0;
+	}
+	else
+	{
+		Poco::UInt32 capacity = columnBits();
+		if (pBlock->timeBits + MAX_TIME_BITS > capacity || pBlock->valueBits + MAX_VALUE_BITS > capacity)
+			return false;
+
+		BitWriter timeWriter(timeColumn(pBlock), pBlock->timeBits);
+		Poco::Int64 delta = timestamp - _prevTimestamp;
+		Poco::Int64 dod = delta - _prevDelta;
+		if (dod == 0)
+		{
+			timeWriter.writeBit(false);
+		}
+		else if (dod >= -63 && dod <= 64)
+		{
+			timeWriter.write(2, 2);
+			timeWriter.write(static_cast<Poco::UInt64>(dod + 63), 7);
+		}
+		else if (dod >= -255 && dod <= 256)
+		{
+			timeWriter.write(6, 3);
+			timeWriter.write(static_cast<Poco::UInt64>(dod + 255), 9);
+		}
+		else if (dod >= -2047 && dod <= 2048)
+		{
+			timeWriter.write(14, 4);
+			timeWriter.write(static_cast<Poco::UInt64>(dod + 2047), 12);
+		}
+		else
+		{
+			timeWriter.write(15, 4);
+			timeWriter.write(static_cast<Poco::UInt64>(dod), 64);
+		}
+		_prevDelta = delta;
+
+		BitWriter valueWriter(valueColumn(pBlock), pBlock->valueBits);
+		Poco::UInt64 x = bits ^ _prevValue;
+		if (x == 0)
+		{
+			valueWriter.writeBit(false);
+		}
+		else
+		{
+			valueWriter.writeBit(true);
+			int leading = leadingZeros(x);
+			int trailing = trailingZeros(x);
+			if (leading > 31) leading = 31;
+			if (_prevLeading >= 0 && leading >= _prevLeading && trailing >= _prevTrailing)
+			{
+				valueWriter.writeBit(false);
+				valueWriter.write(x >> _prevTrailing, 64 - _prevLeading - _prevTrailing);
+			}
+			else
+			{
+				int meaningful = 64 - leading - trailing;
+				valueWriter.writeBit(true);
+				valueWriter.write(static_cast<Poco::UInt64>(leading), 5);
+				valueWriter.write(static_cast<Poco::UInt64>(meaningful - 1), 6);
+				valueWriter.write(x >> trailing, meaningful);
+				_prevLeading  = leading;
+				_prevTrailing = trailing;
+			}
+		}
+	}
+	_prevTimestamp = timestamp;
+	_prevValue = bits;
+	pBlock->lastTimestamp = timestamp;
+	pBlock->count++;
+	return true;
+}
+
+
+template <class Visitor>
+void SeriesStore::visit(Poco::Int64 from, Poco::Int64 to, Visitor& visitor) const
+{
+	Poco::UInt32 blockCount = _pHeader->blockCount;
+	for (Poco::UInt32 i = 1; i <= blockCount; i++)
+	{
+		BlockHeader* pBlock = block((_pHeader->currentBlock + i) % blockCount);
+		if (pBlock->sequence == 0 || pBlock->count == 0) continue;
+		if (pBlock->lastTimestamp < from || pBlock->firstTimestamp > to) continue;
+
+		BlockDecoder decoder(pBlock, timeColumn(pBlock), valueColumn(pBlock));
+		Poco::Int64 timestamp;
+		double value;
+		while (decoder.next(timestamp, value))
+		{
+			if (timestamp > to) return;
+			if (timestamp >= from && !visitor(timestamp, value)) return;
+		}
+	}
+}
+
+
+namespace
+{
+	class SampleCollector
+	{
+	public:
+		SampleCollector(std::vector<Sample>& samples, std::size_t maxSamples):
+			_samples(samples),
+			_maxSamples(maxSamples)
+		{
+		}
+
+		bool operator () (Poco::Int64 timestamp, double value)
+		{
+			_samples.push_back(Sample(timestamp, value));
+			return _maxSamples == 0 || _samples.size() < _maxSamples;
+		}
+
+	private:
+		std::vector<Sample>& _samples;
+		std::size_t _maxSamples;
+	};
+
+	class BucketAggregator
+	{
+	public:
+		BucketAggregator(std::vector<SampleBucket>& buckets, Poco::Int64 from, Poco::Int64 interval):
+			_buckets(buckets),
+			_from(from),
+			_interval(interval),
+			_sum(0.0)
+		{
+		}
+
+		~BucketAggregator()
+		{
+			flush();
+		}
+
+		bool operator () (Poco::Int64 timestamp, double value)
+		{
+			Poco::Int64 start = _from + ((timestamp - _from)/_interval)*_interval;
+			if (_current.count > 0 && start != _current.start) flush();
+			if (_current.count == 0)
+			{
+				_current.start = start;
+				_current.min = value;
+				_current.max = value;
+				_sum = 0.0;
+			}
+			else
+			{
+				if (value < _current.min) _current.min = value;
+				if (value > _current.max) _current.max = value;
+			}
+			_sum += value;
+			_current.count++;
+			return true;
+		}
+
+	private:
+		void flush()
+		{
+			if (_current.count > 0)
+			{
+				_current.avg = _sum/_current.count;
+				_buckets.push_back(_current);
+				_current = SampleBucket();
+			}
+		}
+
+		std::vector<SampleBucket>& _buckets;
+		Poco::Int64 _from;
+		Poco::Int64 _interval;
+		SampleBucket _current;
+		double _sum;
+	};
+}
+
+
+void SeriesStore::samples(Poco::Int64 from, Poco::Int64 to, std::size_t maxSamples, std::vector<Sample>& result) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	SampleCollector collector(result, maxSamples);
+	visit(from, to, collector);
+}
+
+
+void SeriesStore::downsample(Poco::Int64 from, Poco::Int64 to, Poco::Int64 interval, std::vector<SampleBucket>& result) const
+{
+	if (interval <= 0) throw Poco::InvalidArgumentException("downsampling interval must be greater than zero");
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	BucketAggregator aggregator(result, from, interval);
+	visit(from, to, aggregator);
+}
+
+
+void SeriesStore::info(SeriesInfo& info) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	info.firstTimestamp = 0;
+	info.lastTimestamp  = 0;
+	info.sampleCount    = 0;
+	info.capacity       = static_cast<Poco::Int64>(_memory.end() - _memory.begin());
+
+	Poco::UInt32 blockCount = _pHeader->blockCount;
+	for (Poco::UInt32 i = 1; i <= blockCount; i++)
+	{
+		BlockHeader* pBlock = block((_pHeader->currentBlock + i) % blockCount);
+		if (pBlock->sequence == 0 || pBlock->count == 0) continue;
+		if (info.sampleCount == 0) info.firstTimestamp = pBlock->firstTimestamp;
+		info.lastTimestamp = pBlock->lastTimestamp;
+		info.sampleCount += pBlock->count;
+	}
+}
+
+
+SeriesStore::BlockHeader* SeriesStore::block(Poco::UInt32 index) const
+{
+	return reinterpret_cast<BlockHeader*>(_memory.begin() + HEADER_SIZE + static_cast<std::size_t>(index)*_pHeader->blockSize);
+}
+
+
+Poco::UInt32 SeriesStore::columnBits() const
+{
+	return static_cast<Poco::UInt32>(((_pHeader->blockSize - BLOCK_HEADER_SIZE)/2)*8);
+}
+
+
+char* SeriesStore::timeColumn(BlockHeader* pBlock) const
+{
+	return reinterpret_cast<char*>(pBlock) + BLOCK_HEADER_SIZE;
+}
+
+
+char* SeriesStore::valueColumn(BlockHeader* pBlock) const
+{
+	return reinterpret_cast<char*>(pBlock) + BLOCK_HEADER_SIZE + (_pHeader->blockSize - BLOCK_HEADER_SIZE)/2;
+}
+
+
+void SeriesStore::resetBlock(BlockHeader* pBlock, Poco::UInt32 sequence)
+{
+	pBlock->sequence       = sequence;
+	pBlock->count          = 0;
+	pBlock->timeBits       = 0;
+	pBlock->valueBits      = 0;
+	pBlock->firstTimestamp = 0;
+	pBlock->lastTimestamp  = 0;
+}
+
+
+void SeriesStore::restoreState()
+{
+	BlockHeader* pBlock = block(_pHeader->currentBlock);
+	BlockDecoder decoder(pBlock, timeColumn(pBlock), valueColumn(pBlock));
+	Poco::Int64 timestamp;
+	double value;
+	while (decoder.next(timestamp, value))
+	{
+	}
+	_prevTimestamp = decoder.timestamp();
+	_prevDelta     = decoder.delta();
+	_prevValue     = decoder.valueBits();
+	_prevLeading   = decoder.leading();
+	_prevTrailing  = decoder.trailing();
+}
+
+
+} } // namespace IoT::Historian
@@ -0,0 +1,24 @@
+//
+// HistorianTestSuite.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "HistorianTestSuite.h"
+#include "SeriesStoreTest.h"
+
+
+CppUnit::Test* HistorianTestSuite::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HistorianTestSuite");
+
+	pSuite->addTest(SeriesStoreTest::suite());
+
+	return pSuite;
+}
@@ -0,0 +1,29 @@
+//
+// HistorianTestSuite.h
+//
+// $Id$
+//
+// Definition of the HistorianTestSuite class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef HistorianTestSuite_INCLUDED
+#define HistorianTestSuite_INCLUDED
+
+
+#include "CppUnit/TestSuite.h"
+
+
+class HistorianTestSuite
+{
+public:
+	static CppUnit::Test* suite();
+};
+
+
+#endif // HistorianTestSuite_INCLUDED
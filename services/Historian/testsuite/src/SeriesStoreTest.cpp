@@ -0,0 +1,331 @@
+//
+// SeriesStoreTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#include "SeriesStoreTest.h"
+#include "CppUnit/TestCaller.h"
+#include "CppUnit/TestSuite.h"
+#include "IoT/Historian/SeriesStore.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/File.h"
+#include "Poco/Random.h"
+#include "Poco/Exception.h"
+#include <limits>
+#include <cstring>
+
+
+using IoT::Historian::SeriesStore;
+using IoT::Historian::Sample;
+using IoT::Historian::SampleBucket;
+using IoT::Historian::SeriesInfo;
+
+
+namespace
+{
+	bool sameValue(double a, double b)
+		/// Compares the bit patterns of a and b, so that
+		/// NaN == NaN and 0.0 != -0.0.
+	{
+		return std::memcmp(&a, &b, sizeof(double)) == 0;
+	}
+
+	bool sameSamples(const std::vector<Sample>& expected, const std::vector<Sample>& actual)
+	{
+		if (expected.size() != actual.size()) return false;
+		for (std::size_t i = 0; i < expected.size(); i++)
+		{
+			if (expected[i].timestamp != actual[i].timestamp) return false;
+			if (!sameValue(expected[i].value, actual[i].value)) return false;
+		}
+		return true;
+	}
+
+	void appendAll(SeriesStore& store, const std::vector<Sample>& samples)
+	{
+		for (std::vector<Sample>::const_iterator it = samples.begin(); it != samples.end(); ++it)
+		{
+			store.append(it->timestamp, it->value);
+		}
+	}
+
+	const Poco::Int64 MIN_TS = std::numeric_limits<Poco::Int64>::min();
+	const Poco::Int64 MAX_TS = std::numeric_limits<Poco::Int64>::max();
+}
+
+
+SeriesStoreTest::SeriesStoreTest(const std::string& name):
+	CppUnit::TestCase(name)
+{
+}
+
+
+SeriesStoreTest::~SeriesStoreTest()
+{
+}
+
+
+void SeriesStoreTest::testRoundTrip()
+{
+	// Irregular intervals, chosen to exercise all delta-of-delta
+	// ranges, including their boundaries.
+	static const Poco::Int64 deltas[] =
+	{
+		1000, 1000, 1000, 1001, 999, 1064, 1001, 1257, 1002, 3050, 1003, 3051,
+		0, 0, 1, 5000000, 1, 1000, 1000, 123456789012LL, 7, 1000
+	};
+	std::vector<Sample> expected;
+	Poco::Int64 ts = 1476000000000LL;
+	double value = 20.0;
+	for (std::size_t i = 0; i < sizeof(deltas)/sizeof(deltas[0]); i++)
+	{
+		ts += deltas[i];
+		value += (i % 3 == 0) ? 0.0 : 0.1*static_cast<double>(i);
+		expected.push_back(Sample(ts, value));
+	}
+
+	SeriesStore store(_path);
+	appendAll(store, expected);
+
+	std::vector<Sample> actual;
+	store.samples(MIN_TS, MAX_TS, 0, actual);
+	assert (sameSamples(expected, actual));
+
+	SeriesInfo info;
+	store.info(info);
+	assert (info.sampleCount == static_cast<Poco::Int64>(expected.size()));
+	assert (info.firstTimestamp == expected.front().timestamp);
+	assert (info.lastTimestamp == expected.back().timestamp);
+
+	// range queries are inclusive at both ends
+	actual.clear();
+	store.samples(expected[3].timestamp, expected[6].timestamp, 0, actual);
+	assert (actual.size() == 4);
+	assert (actual.front().timestamp == expected[3].timestamp);
+	assert (actual.back().timestamp == expected[6].timestamp);
+
+	actual.clear();
+	store.samples(MIN_TS, MAX_TS, 5, actual);
+	assert (actual.size() == 5);
+
+	assert (!store.append(expected.back().timestamp - 1, 1.0));
+	assert (store.append(expected.back().timestamp, 1.0));
+}
+
+
+void SeriesStoreTest::testSpecialValues()
+{
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	const double inf = std::numeric_limits<double>::infinity();
+	static const double values[] =
+	{
+		1.0, 1.0, 1.0, nan, nan, 1.0, 0.0, -0.0, -0.0, 0.0,
+		inf, -inf, inf, std::numeric_limits<double>::max(), std::numeric_limits<double>::min(),
+		std::numeric_limits<double>::denorm_min(), -1.5, 1e300, 1e-300, 42.0, 42.0
+	};
+	std::vector<Sample> expected;
+	for (std::size_t i = 0; i < sizeof(values)/sizeof(values[0]); i++)
+	{
+		expected.push_back(Sample(1000*static_cast<Poco::Int64>(i), values[i]));
+	}
+
+	SeriesStore store(_path);
+	appendAll(store, expected);
+
+	std::vector<Sample> actual;
+	store.samples(MIN_TS, MAX_TS, 0, actual);
+	assert (sameSamples(expected, actual));
+}
+
+
+void SeriesStoreTest::testWrap()
+{
+	Poco::Random rnd;
+	rnd.seed(42);
+	std::vector<Sample> expected;
+	Poco::Int64 ts = 0;
+	for (int i = 0; i < 2000; i++)
+	{
+		ts += 900 + rnd.next(200);
+		expected.push_back(Sample(ts, rnd.nextDouble()));
+	}
+
+	SeriesStore store(_path, 256, 4);
+	appendAll(store, expected);
+
+	// Random values need many bits per sample, so only the
+	// most recent samples fit into the four blocks.
+	SeriesInfo info;
+	store.info(info);
+	assert (info.sampleCount > 0);
+	assert (info.sampleCount < static_cast<Poco::Int64>(expected.size()));
+	assert (info.lastTimestamp == expected.back().timestamp);
+
+	std::vector<Sample> actual;
+	store.samples(MIN_TS, MAX_TS, 0, actual);
+	assert (actual.size() == static_cast<std::size_t>(info.sampleCount));
+	assert (actual.front().timestamp == info.firstTimestamp);
+	std::vector<Sample> tail(expected.end() - actual.size(), expected.end());
+	assert (sameSamples(tail, actual));
+}
+
+
+void SeriesStoreTest::testReopen()
+{
+	Poco::Random rnd;
+	rnd.seed(7);
+	std::vector<Sample> expected;
+	Poco::Int64 ts = 1476000000000LL;
+	double value = 20.0;
+	for (int i = 0; i < 3000; i++)
+	{
+		ts += 1000 + rnd.next(3);
+		value += (rnd.next(4) - 1.5)/16;
+		expected.push_back(Sample(ts, value));
+	}
+
+	// Reopen the store several times, also in the middle
+	// of a block, and continue appending.
+	std::size_t pos = 0;
+	const std::size_t chunks[] = {1, 10, 500, 1234, 1255};
+	for (std::size_t i = 0; i < sizeof(chunks)/sizeof(chunks[0]); i++)
+	{
+		SeriesStore store(_path, 256, 64);
+		if (pos > 0)
+		{
+			assert (!store.append(expected[pos - 1].timestamp - 1, 0.0));
+		}
+		std::vector<Sample> chunk(expected.begin() + pos, expected.begin() + pos + chunks[i]);
+		appendAll(store, chunk);
+		pos += chunks[i];
+	}
+	assert (pos == expected.size());
+
+	// Block size and count are taken from the existing file.
+	SeriesStore store(_path, 4096, 2);
+	SeriesInfo info;
+	store.info(info);
+	assert (info.capacity == static_cast<Poco::Int64>(64 + 256*64));
+
+	std::vector<Sample> actual;
+	store.samples(MIN_TS, MAX_TS, 0, actual);
+	std::vector<Sample> tail(expected.end() - actual.size(), expected.end());
+	assert (sameSamples(tail, actual));
+	assert (actual.size() > 1000);
+}
+
+
+void SeriesStoreTest::testReopenInvalid()
+{
+	{
+		Poco::FileOutputStream ostr(_path);
+		for (int i = 0; i < 100; i++) ostr << "not a series file ";
+	}
+	try
+	{
+		SeriesStore store(_path);
+		fail("not a series file - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+}
+
+
+void SeriesStoreTest::testDownsample()
+{
+	SeriesStore store(_path);
+	for (Poco::Int64 ts = 0; ts < 100; ts++)
+	{
+		store.append(ts, static_cast<double>(ts));
+	}
+
+	// buckets aligned to from; samples at a bucket start belong to that
+	// bucket, and the sample at to is included
+	std::vector<SampleBucket> buckets;
+	store.downsample(10, 40, 10, buckets);
+	assert (buckets.size() == 4);
+	assert (buckets[0].start == 10);
+	assert (buckets[0].count == 10);
+	assert (buckets[0].min == 10);
+	assert (buckets[0].max == 19);
+	assert (buckets[0].avg == 14.5);
+	assert (buckets[2].start == 30);
+	assert (buckets[2].max == 39);
+	assert (buckets[3].start == 40);
+	assert (buckets[3].count == 1);
+	assert (buckets[3].min == 40);
+	assert (buckets[3].max == 40);
+
+	// unaligned start
+	buckets.clear();
+	store.downsample(5, 99, 50, buckets);
+	assert (buckets.size() == 2);
+	assert (buckets[0].start == 5);
+	assert (buckets[0].count == 50);
+	assert (buckets[0].min == 5);
+	assert (buckets[0].max == 54);
+	assert (buckets[1].start == 55);
+	assert (buckets[1].count == 45);
+	assert (buckets[1].max == 99);
+
+	// empty buckets are omitted
+	store.append(1000, 1.0);
+	buckets.clear();
+	store.downsample(90, 1000, 100, buckets);
+	assert (buckets.size() == 2);
+	assert (buckets[0].start == 90);
+	assert (buckets[0].count == 10);
+	assert (buckets[1].start == 990);
+	assert (buckets[1].count == 1);
+
+	try
+	{
+		store.downsample(0, 100, 0, buckets);
+		fail("invalid interval - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void SeriesStoreTest::setUp()
+{
+	_path = Poco::TemporaryFile::tempName();
+}
+
+
+void SeriesStoreTest::tearDown()
+{
+	try
+	{
+		Poco::File(_path).remove();
+	}
+	catch (...)
+	{
+	}
+}
+
+
+CppUnit::Test* SeriesStoreTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SeriesStoreTest");
+
+	CppUnit_addTest(pSuite, SeriesStoreTest, testRoundTrip);
+	CppUnit_addTest(pSuite, SeriesStoreTest, testSpecialValues);
+	CppUnit_addTest(pSuite, SeriesStoreTest, testWrap);
+	CppUnit_addTest(pSuite, SeriesStoreTest, testReopen);
+	CppUnit_addTest(pSuite, SeriesStoreTest, testReopenInvalid);
+	CppUnit_addTest(pSuite, SeriesStoreTest, testDownsample);
+
+	return pSuite;
+}
@@ -0,0 +1,46 @@
+//
+// SeriesStoreTest.h
+//
+// $Id$
+//
+// Definition of the SeriesStoreTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+
+#ifndef SeriesStoreTest_INCLUDED
+#define SeriesStoreTest_INCLUDED
+
+
+#include "IoT/Historian/Historian.h"
+#include "CppUnit/TestCase.h"
+
+
+class SeriesStoreTest: public CppUnit::TestCase
+{
+public:
+	SeriesStoreTest(const std::string& name);
+	~SeriesStoreTest();
+
+	void testRoundTrip();
+	void testSpecialValues();
+	void testWrap();
+	void testReopen();
+	void testReopenInvalid();
+	void testDownsample();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	std::string _path;
+};
+
+
+#endif // SeriesStoreTest_INCLUDED